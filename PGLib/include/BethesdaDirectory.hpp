@@ -1,6 +1,8 @@
 #pragma once
 #include "BethesdaGame.hpp"
 #include "ModManagerDirectory.hpp"
+#include "PGFileCache.hpp"
+#include "PGPathFilter.hpp"
 #include "ParallaxGenUtil.hpp"
 
 #include <nlohmann/json.hpp>
@@ -84,10 +86,10 @@ private:
     std::map<std::filesystem::path, BethesdaFile> m_fileMap; /** < Stores the file map for every file found in the load
                                                               order. Key is a lowercase path, value is a BethesdaFile*/
     std::mutex m_fileMapMutex; /** < Mutex for the file map */
+    PGPathFilter m_fileFilter; /** < Lock free existence filter over the file map keys, built after populateFileMap */
     std::vector<ModFile> m_modFiles; /** < Stores files in mod staging directory */
 
-    std::unordered_map<std::filesystem::path, std::vector<std::byte>> m_fileCache; /** < Stores a cache of file bytes */
-    std::mutex m_fileCacheMutex; /** < Mutex for the file cache map */
+    PGFileCache m_fileCache; /** < Budgeted LRU cache of file bytes, keyed by lowercase path */
 
     bool m_logging; /** < Bool for whether logging is enabled or not */
     BethesdaGame* m_bg; /** < BethesdaGame which stores a BethesdaGame object
@@ -167,6 +169,28 @@ public:
     [[nodiscard]] auto getFile(const std::filesystem::path& relPath, const bool& cacheFile = false)
         -> std::vector<std::byte>;
 
+    /**
+     * @brief Get bytes from a file in the load order as a shared immutable buffer. Cache hits are returned without a
+     * copy. Throws runtime_error if file does not exist.
+     *
+     * @param relPath path to the file relative to the data directory
+     * @param cacheFile whether to admit the file to the cache (subject to the memory budget)
+     * @return PGFileCache::Buffer shared buffer of the file bytes, never nullptr
+     */
+    [[nodiscard]] auto getFileShared(const std::filesystem::path& relPath, const bool& cacheFile = false)
+        -> PGFileCache::Buffer;
+
+    /**
+     * @brief Get the number of bytes of a buffer from getFileShared() that the file cache does not already charge to
+     * PGMemoryBudget. Use this to size a Reservation for the buffer.
+     *
+     * @param relPath path the buffer was read from
+     * @param buffer buffer returned by getFileShared()
+     * @return size_t 0 if the cache holds the buffer, its size otherwise
+     */
+    [[nodiscard]] auto getUnchargedBytes(const std::filesystem::path& relPath, const PGFileCache::Buffer& buffer)
+        -> size_t;
+
     /**
      * @brief Get the Mod that has the winning version of the file
      *
@@ -241,6 +265,13 @@ public:
      */
     [[nodiscard]] auto getLooseFileFullPath(const std::filesystem::path& relPath) -> std::filesystem::path;
 
+    /**
+     * @brief Add files in a BSA to the file map, overriding files already in the map
+     *
+     * @param bsaName BSA name relative to the data directory to read files from
+     */
+    void addBSAToFileMap(const std::wstring& bsaName);
+
     /**
      * @brief Get the load order of BSAs
      *
@@ -321,13 +352,6 @@ private:
      */
     void addLooseFilesToMap();
 
-    /**
-     * @brief Add files in a BSA to the file map
-     *
-     * @param bsaName BSA name to read files from
-     */
-    void addBSAToFileMap(const std::wstring& bsaName);
-
     /**
      * @brief Check if a file being added to the file map should be added
      *
@@ -379,26 +403,6 @@ private:
     void updateFileMap(const std::filesystem::path& filePath, std::shared_ptr<BSAFile> bsaFile,
         const std::wstring& mod = L"", const bool& generated = false);
 
-    /**
-     * @brief Convert a list of wstrings to a LPCWSTRs
-     *
-     * @param original original list of wstrings to convert
-     * @return std::vector<LPCWSTR> list of LPCWSTRs
-     */
-    [[nodiscard]] static auto convertWStringToLPCWSTRVector(const std::vector<std::wstring>& original)
-        -> std::vector<LPCWSTR>;
-
-    /**
-     * @brief Checks whether a glob matches a provided list of globs
-     *
-     * @param str String to check
-     * @param winningGlob Last glob that one (for performance)
-     * @param globList List of globs to check
-     * @return true Any glob is the list mated
-     * @return false No globs in the list matched
-     */
-    static auto checkGlob(const LPCWSTR& str, LPCWSTR& winningGlob, const std::vector<LPCWSTR>& globList) -> bool;
-
     static auto readINIValue(const std::filesystem::path& iniPath, const std::wstring& section, const std::wstring& key,
         const bool& logging, const bool& firstINIRead) -> std::wstring;
 };
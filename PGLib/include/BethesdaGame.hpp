@@ -1,8 +1,8 @@
 #pragma once
 
-#include <windows.h>
-
 #include <filesystem>
+#include <string>
+#include <vector>
 
 // Steam game ID definitions
 enum {
@@ -13,8 +13,6 @@ enum {
     STEAMGAMEID_ENDERAL_SE = 976620
 };
 
-constexpr unsigned REG_BUFFER_SIZE = 1024;
-
 class BethesdaGame {
 public:
     // GameType enum
@@ -79,8 +77,5 @@ private:
     [[nodiscard]] auto getGameDocumentSystemPath() const -> std::filesystem::path;
     [[nodiscard]] auto getGameAppdataSystemPath() const -> std::filesystem::path;
 
-    // gets the system path for a folder (from windows.h)
-    static auto getSystemPath(const GUID& folderID) -> std::filesystem::path;
-
     [[nodiscard]] static auto getGameRegistryPath(const GameType& type) -> std::string;
 };
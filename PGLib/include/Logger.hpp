@@ -4,42 +4,40 @@
 #include <spdlog/spdlog.h>
 
 #include <fmt/format.h>
+#include <fmt/xchar.h>
 #include <string>
 #include <unordered_set>
 #include <vector>
 
+/**
+ * @class Logger
+ * @brief Logging front end used by PGLib
+ *
+ * The level is checked before any prefix building or formatting happens, so disabled levels cost a single comparison.
+ * Enabled messages are formatted once on the calling thread and handed to a lock-free ring buffer that a single
+ * background thread drains into spdlog (see startAsync). error and warn messages are deduplicated on that thread.
+ * Without startAsync messages are dispatched synchronously.
+ *
+ * PGLib logs only through this class, so the messages of one thread are written in the order they were logged.
+ */
 class Logger {
 private:
-    inline static std::unordered_set<std::wstring> s_existingMessages;
-    inline static std::mutex s_existingMessagesMutex;
-
     thread_local static std::vector<std::wstring> s_prefixStack;
     static auto buildPrefixWString() -> std::wstring;
     static auto buildPrefixString() -> std::string;
 
-    template <typename... Args> static auto shouldLogString(const std::wstring& fmt, Args&&... moreArgs) -> bool
-    {
-        const std::lock_guard<std::mutex> lock(s_existingMessagesMutex);
-        const auto resultLog = fmt::format(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
-        if (s_existingMessages.find(resultLog) != s_existingMessages.end()) {
-            // don't log anything if already logged
-            return false;
-        }
-        s_existingMessages.insert(resultLog);
-        return true;
-    }
+    static void submit(const spdlog::level::level_enum& level, std::wstring message, const bool& dedup);
+    static void submit(const spdlog::level::level_enum& level, std::string message, const bool& dedup);
 
-    template <typename... Args> static auto shouldLogString(const std::string& fmt, Args&&... moreArgs) -> bool
+    /// @brief Format a message. Like spdlog, a message without arguments is taken literally.
+    template <typename Char, typename... Args>
+    static auto formatMessage(const std::basic_string<Char>& fmt, Args&&... moreArgs) -> std::basic_string<Char>
     {
-        const std::lock_guard<std::mutex> lock(s_existingMessagesMutex);
-        const std::string resolvedNarrow = fmt::format(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
-        const std::wstring resolvedWide(resolvedNarrow.begin(), resolvedNarrow.end());
-        if (s_existingMessages.find(resolvedWide) != s_existingMessages.end()) {
-            // don't log anything if already logged
-            return false;
+        if constexpr (sizeof...(Args) == 0) {
+            return fmt;
+        } else {
+            return fmt::format(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
         }
-        s_existingMessages.insert(resolvedWide);
-        return true;
     }
 
 public:
@@ -55,75 +53,129 @@ public:
         auto operator=(Prefix&&) -> Prefix& = delete;
     };
 
+    /**
+     * @brief Start the background thread that writes log messages. Call from the main thread after spdlog is set up.
+     */
+    static void startAsync();
+
+    /**
+     * @brief Stop queueing new messages, write all pending ones and stop the background thread. Messages logged during
+     * or after the call are written synchronously. Safe to call if it was never started.
+     */
+    static void stopAsync();
+
+    /**
+     * @brief Block until every message submitted before this call has been written
+     */
+    static void flush();
+
     // WString Log functions
-    template <typename... Args> static void critical(const std::wstring& fmt, Args&&... moreArgs)
+    template <typename... Args> [[noreturn]] static void critical(const std::wstring& fmt, Args&&... moreArgs)
     {
+        flush();
         spdlog::critical(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
         exit(1);
     }
 
     template <typename... Args> static void error(const std::wstring& fmt, Args&&... moreArgs)
     {
-        if (shouldLogString(fmt, std::forward<Args>(moreArgs)...)) {
-            spdlog::error(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
+        if (!spdlog::should_log(spdlog::level::err)) {
+            return;
         }
+
+        submit(spdlog::level::err, formatMessage(fmt, std::forward<Args>(moreArgs)...), true);
     }
 
     template <typename... Args> static void warn(const std::wstring& fmt, Args&&... moreArgs)
     {
-        if (shouldLogString(fmt, std::forward<Args>(moreArgs)...)) {
-            spdlog::warn(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
+        if (!spdlog::should_log(spdlog::level::warn)) {
+            return;
         }
+
+        submit(spdlog::level::warn, formatMessage(fmt, std::forward<Args>(moreArgs)...), true);
     }
 
     template <typename... Args> static void info(const std::wstring& fmt, Args&&... moreArgs)
     {
-        spdlog::info(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
+        if (!spdlog::should_log(spdlog::level::info)) {
+            return;
+        }
+
+        submit(spdlog::level::info, formatMessage(fmt, std::forward<Args>(moreArgs)...), false);
     }
 
     template <typename... Args> static void debug(const std::wstring& fmt, Args&&... moreArgs)
     {
-        spdlog::debug(fmt::runtime(buildPrefixWString() + fmt), std::forward<Args>(moreArgs)...);
+        if (!spdlog::should_log(spdlog::level::debug)) {
+            return;
+        }
+
+        submit(spdlog::level::debug,
+            buildPrefixWString() + formatMessage(fmt, std::forward<Args>(moreArgs)...), false);
     }
 
     template <typename... Args> static void trace(const std::wstring& fmt, Args&&... moreArgs)
     {
-        spdlog::trace(fmt::runtime(buildPrefixWString() + fmt), std::forward<Args>(moreArgs)...);
+        if (!spdlog::should_log(spdlog::level::trace)) {
+            return;
+        }
+
+        submit(spdlog::level::trace,
+            buildPrefixWString() + formatMessage(fmt, std::forward<Args>(moreArgs)...), false);
     }
 
     // String Log functions
-    template <typename... Args> static void critical(const std::string& fmt, Args&&... moreArgs)
+    template <typename... Args> [[noreturn]] static void critical(const std::string& fmt, Args&&... moreArgs)
     {
+        flush();
         spdlog::critical(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
         exit(1);
     }
 
     template <typename... Args> static void error(const std::string& fmt, Args&&... moreArgs)
     {
-        if (shouldLogString(fmt, std::forward<Args>(moreArgs)...)) {
-            spdlog::error(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
+        if (!spdlog::should_log(spdlog::level::err)) {
+            return;
         }
+
+        submit(spdlog::level::err, formatMessage(fmt, std::forward<Args>(moreArgs)...), true);
     }
 
     template <typename... Args> static void warn(const std::string& fmt, Args&&... moreArgs)
     {
-        if (shouldLogString(fmt, std::forward<Args>(moreArgs)...)) {
-            spdlog::warn(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
+        if (!spdlog::should_log(spdlog::level::warn)) {
+            return;
         }
+
+        submit(spdlog::level::warn, formatMessage(fmt, std::forward<Args>(moreArgs)...), true);
     }
 
     template <typename... Args> static void info(const std::string& fmt, Args&&... moreArgs)
     {
-        spdlog::info(fmt::runtime(fmt), std::forward<Args>(moreArgs)...);
+        if (!spdlog::should_log(spdlog::level::info)) {
+            return;
+        }
+
+        submit(spdlog::level::info, formatMessage(fmt, std::forward<Args>(moreArgs)...), false);
     }
 
     template <typename... Args> static void debug(const std::string& fmt, Args&&... moreArgs)
     {
-        spdlog::debug(fmt::runtime(buildPrefixString() + fmt), std::forward<Args>(moreArgs)...);
+        if (!spdlog::should_log(spdlog::level::debug)) {
+            return;
+        }
+
+        submit(spdlog::level::debug,
+            buildPrefixString() + formatMessage(fmt, std::forward<Args>(moreArgs)...), false);
     }
 
     template <typename... Args> static void trace(const std::string& fmt, Args&&... moreArgs)
     {
-        spdlog::trace(fmt::runtime(buildPrefixString() + fmt), std::forward<Args>(moreArgs)...);
+        if (!spdlog::should_log(spdlog::level::trace)) {
+            return;
+        }
+
+        submit(spdlog::level::trace,
+            buildPrefixString() + formatMessage(fmt, std::forward<Args>(moreArgs)...), false);
     }
 };
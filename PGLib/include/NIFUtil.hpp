@@ -108,9 +108,15 @@ auto getDefaultTextureType(const TextureSlots& slot) -> TextureType;
 /// @return the nif
 auto loadNIFFromBytes(const std::vector<std::byte>& nifBytes) -> nifly::NifFile;
 
-/// @brief get a map containing the known texture suffixes
+/// @brief save a Nif to memory
+/// @param[in] nif the nif to save
+/// @param[in] options nifly save options
+/// @return the serialized NIF, empty if saving failed
+auto saveNIFToBytes(nifly::NifFile& nif, const nifly::NifSaveOptions& options) -> std::vector<std::byte>;
+
+/// @brief get a map containing the known texture suffixes, matching is done by PGTextureName
 /// @return the map containing the suffixes and the slot/type pairs
-auto getTexSuffixMap() -> std::map<std::wstring, std::tuple<TextureSlots, TextureType>>;
+auto getTexSuffixMap() -> const std::map<std::wstring, std::tuple<TextureSlots, TextureType>>&;
 
 /// @brief Deduct the texture type and slot usually used from the suffix of a texture
 /// @param[in] path texture to check
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "BethesdaGame.hpp"
+
+#include <bsa/tes4.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/**
+ * @class PGArchiveWriter
+ * @brief Packs the meshes and textures in an output directory into BSAs with matching dummy plugins
+ *
+ * Files are split into mesh and texture archives, and each kind is split again whenever an archive would exceed the
+ * size limit. Archive N is loaded by an empty plugin of the same name, with meshes in "<name>.bsa" and textures in
+ * "<name> - Textures.bsa" so that the game picks both up from the one plugin. The archive version and plugin header
+ * follow the game type, and the plugins are only flagged as light where the game supports it.
+ */
+class PGArchiveWriter {
+public:
+    /// @brief Uncompressed bytes per archive, kept well below the 4 GiB offset limit of the format
+    static constexpr uint64_t DEFAULT_ARCHIVE_SIZE_LIMIT = 2000ULL * 1024ULL * 1024ULL;
+
+    enum class ArchiveContent : uint8_t { MESHES, TEXTURES };
+
+    /**
+     * @struct ArchiveInfo
+     * @brief Describes one written archive
+     */
+    struct ArchiveInfo {
+        std::filesystem::path bsaPath;
+        std::filesystem::path pluginPath;
+        ArchiveContent content;
+        size_t numFiles;
+        uint64_t dataSize; /** < Uncompressed size of all files in the archive */
+    };
+
+private:
+    struct LooseFile {
+        std::filesystem::path relPath;
+        uint64_t size;
+    };
+
+    std::filesystem::path m_outputDir;
+    BethesdaGame::GameType m_gameType;
+    std::wstring m_baseName;
+    uint64_t m_sizeLimit;
+
+public:
+    /**
+     * @brief Construct a new PGArchiveWriter
+     *
+     * @param outputDir directory holding the loose output files
+     * @param gameType game the archives and plugins are written for
+     * @param baseName name of the first archive and plugin, later ones get a number appended
+     * @param sizeLimit uncompressed bytes per archive before a new one is started
+     */
+    PGArchiveWriter(std::filesystem::path outputDir, const BethesdaGame::GameType& gameType,
+        std::wstring baseName = getDefaultBaseName(), const uint64_t& sizeLimit = DEFAULT_ARCHIVE_SIZE_LIMIT);
+
+    /**
+     * @brief Pack all loose meshes and textures in the output directory into archives
+     *
+     * @param multiThread compress files in parallel
+     * @param removeLoose delete the packed loose files and their empty folders afterwards
+     * @return std::vector<ArchiveInfo> archives that were written, in plugin order
+     */
+    auto writeArchives(const bool& multiThread = true, const bool& removeLoose = true) -> std::vector<ArchiveInfo>;
+
+    /**
+     * @brief Write an empty plugin that only exists to load archives of the same name. It is flagged as light if the
+     * game supports light plugins.
+     *
+     * @param pluginPath path of the plugin to write
+     * @param gameType game the plugin is written for
+     */
+    static void writeDummyPlugin(const std::filesystem::path& pluginPath, const BethesdaGame::GameType& gameType);
+
+    /**
+     * @brief Name used for archives and dummy plugins when none is given
+     */
+    [[nodiscard]] static auto getDefaultBaseName() -> std::wstring;
+
+    /**
+     * @brief Get the archive name for a given index and content type
+     *
+     * @param baseName base name of the archives
+     * @param index archive index, 0 is the first archive
+     * @param content content type of the archive
+     * @return std::wstring archive file name
+     */
+    [[nodiscard]] static auto getArchiveName(
+        const std::wstring& baseName, const size_t& index, const ArchiveContent& content) -> std::wstring;
+
+    /**
+     * @brief Get the dummy plugin name for a given archive index
+     *
+     * @param baseName base name of the archives
+     * @param index archive index, 0 is the first archive
+     * @return std::wstring plugin file name
+     */
+    [[nodiscard]] static auto getPluginName(const std::wstring& baseName, const size_t& index) -> std::wstring;
+
+private:
+    /**
+     * @brief Find loose files of a content type and split them into size limited chunks, sorted by path
+     */
+    [[nodiscard]] auto getChunks(const ArchiveContent& content) const -> std::vector<std::vector<LooseFile>>;
+
+    /**
+     * @brief Read, compress and write one archive. Compressed files are charged to PGMemoryBudget until the archive is
+     * written.
+     */
+    void writeArchive(const std::filesystem::path& bsaPath, const ArchiveContent& content,
+        const std::vector<LooseFile>& files, const bool& multiThread) const;
+
+    /**
+     * @brief Remove packed loose files and any folders left empty
+     */
+    void removeLooseFiles(const std::vector<LooseFile>& files) const;
+};
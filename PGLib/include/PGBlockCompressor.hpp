@@ -0,0 +1,76 @@
+#pragma once
+
+#include <DirectXTex.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class PGBlockCompressor
+ * @brief Block compression of whole textures split into tiles that compress in parallel
+ *
+ * BC blocks do not depend on each other, so every mip is cut into bands of block rows that DirectXTex compresses
+ * independently on the shared worker pool. The result is byte identical to compressing the image in one call.
+ */
+class PGBlockCompressor {
+public:
+    enum class Quality : uint8_t {
+        FAST, /** < Quick BC7 mode search */
+        NORMAL, /** < DirectXTex defaults */
+        HIGH /** < Dithered BC1-3, BC7 also searches 3 subset modes */
+    };
+
+    /**
+     * @struct Options
+     * @brief Controls how a texture is compressed
+     */
+    struct Options {
+        DXGI_FORMAT format = DXGI_FORMAT_BC3_UNORM;
+        Quality quality = Quality::NORMAL;
+        float alphaThreshold = DirectX::TEX_THRESHOLD_DEFAULT; /** < Alpha cutoff for BC1 */
+        bool multiThread = true;
+    };
+
+private:
+    static constexpr size_t TILE_ROWS = 64; /** < Texel rows per tile, must be a multiple of the 4 row block height */
+    static constexpr size_t BLOCK_ROWS = 4;
+
+    /**
+     * @struct Tile
+     * @brief Band of block rows of one image of the texture
+     */
+    struct Tile {
+        size_t imageIndex = 0;
+        size_t rowStart = 0;
+        size_t numRows = 0;
+    };
+
+public:
+    /**
+     * @brief Whether a format is a BC format this compressor can write
+     */
+    [[nodiscard]] static auto isFormatSupported(const DXGI_FORMAT& format) -> bool;
+
+    /**
+     * @brief DirectXTex compress flags for a format and preset
+     */
+    [[nodiscard]] static auto getCompressFlags(const DXGI_FORMAT& format, const Quality& quality)
+        -> DirectX::TEX_COMPRESS_FLAGS;
+
+    /**
+     * @brief Compress every mip and array item of a texture
+     *
+     * @param input uncompressed texture
+     * @param options target format and preset
+     * @param[out] output compressed texture with the input layout
+     * @return true on success, output is untouched on failure
+     */
+    static auto compress(const DirectX::ScratchImage& input, const Options& options, DirectX::ScratchImage& output)
+        -> bool;
+
+private:
+    static auto getTiles(const DirectX::ScratchImage& input) -> std::vector<Tile>;
+    static auto compressTile(const DirectX::Image& src, const DirectX::Image& dst, const Tile& tile,
+        const Options& options, const DirectX::TEX_COMPRESS_FLAGS& flags) -> bool;
+};
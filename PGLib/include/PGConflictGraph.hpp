@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "NIFUtil.hpp"
+
+/**
+ * @class PGConflictGraph
+ * @brief Graph of mods that compete for the same shapes, built by findModConflicts and used by the mod sort dialog
+ *
+ * Mods are numbered in the order they are first seen. Each mod keeps an adjacency bitset for O(1) pair tests and a
+ * neighbor list for O(degree) iteration, edges carry the number of shapes both mods matched and the shaders involved.
+ * The graph also tracks the row of every mod in the current sort order so a reorder only renumbers the moved range.
+ */
+class PGConflictGraph {
+public:
+    static constexpr size_t NPOS = static_cast<size_t>(-1);
+
+    /**
+     * @struct Edge
+     * @brief Conflict between two mods
+     */
+    struct Edge {
+        uint32_t numShapes = 0; /** < Number of shapes both mods matched */
+        uint8_t shaderMask = 0; /** < Bit per NIFUtil::ShapeShader that either mod matched on those shapes */
+    };
+
+private:
+    static constexpr size_t BITS_PER_WORD = 64;
+
+    struct Node {
+        std::wstring name;
+        uint8_t shaderMask = 0;
+        std::vector<uint64_t> adjacency;
+        std::vector<size_t> neighbors;
+        size_t row = NPOS;
+    };
+
+    std::vector<Node> m_nodes;
+    std::unordered_map<std::wstring, size_t> m_ids;
+    std::unordered_map<uint64_t, Edge> m_edges;
+    std::vector<size_t> m_order;
+
+public:
+    /**
+     * @brief Get the ID of a mod, adding it if it is not in the graph yet
+     *
+     * @param mod mod name
+     * @return size_t mod ID
+     */
+    auto addMod(const std::wstring& mod) -> size_t;
+
+    /**
+     * @brief Record one shape that several mods matched. Every pair of distinct mods gets an edge.
+     *
+     * @param matches mod and shader of each match, a mod may appear more than once
+     */
+    void addConflict(const std::vector<std::pair<std::wstring, NIFUtil::ShapeShader>>& matches);
+
+    [[nodiscard]] auto size() const -> size_t;
+    [[nodiscard]] auto empty() const -> bool;
+
+    /**
+     * @brief Get the ID of a mod
+     *
+     * @return size_t mod ID or NPOS if the mod is not in the graph
+     */
+    [[nodiscard]] auto getID(const std::wstring& mod) const -> size_t;
+    [[nodiscard]] auto getName(const size_t& id) const -> const std::wstring&;
+
+    /**
+     * @brief Get the shaders a mod matched, from worst to best
+     */
+    [[nodiscard]] auto getShaders(const size_t& id) const -> std::vector<NIFUtil::ShapeShader>;
+    [[nodiscard]] auto getHighestShader(const size_t& id) const -> NIFUtil::ShapeShader;
+
+    /**
+     * @brief Get the mods that conflict with a mod, in the order the conflicts were found
+     */
+    [[nodiscard]] auto getConflicts(const size_t& id) const -> const std::vector<size_t>&;
+    [[nodiscard]] auto hasConflict(const size_t& idA, const size_t& idB) const -> bool;
+
+    /**
+     * @brief Get the edge between two mods
+     *
+     * @return const Edge* edge or nullptr if the mods do not conflict
+     */
+    [[nodiscard]] auto getEdge(const size_t& idA, const size_t& idB) const -> const Edge*;
+
+    /**
+     * @brief Suggest an order for the sort dialog, new mods sorted by their best shader and name and then the mods of
+     * the existing order that are in the graph. Higher rows win.
+     *
+     * @param existingOrder saved mod order
+     * @return std::vector<std::wstring> suggested order, without the unmanaged (empty) mod
+     */
+    [[nodiscard]] auto suggestOrder(const std::vector<std::wstring>& existingOrder) const -> std::vector<std::wstring>;
+
+    //
+    // Row tracking
+    //
+
+    /**
+     * @brief Set the rows of the sort order, mods that are not listed have no row
+     *
+     * @param order mods in row order, all must be in the graph
+     */
+    void setOrder(const std::vector<std::wstring>& order);
+    [[nodiscard]] auto getOrder() const -> const std::vector<size_t>&;
+    [[nodiscard]] auto getRow(const size_t& id) const -> size_t;
+
+    /**
+     * @brief Get the rows of the mods that conflict with the mod in a row
+     *
+     * @param row selected row
+     * @return std::vector<size_t> rows of the conflicting mods that are in the order
+     */
+    [[nodiscard]] auto getConflictRows(const size_t& row) const -> std::vector<size_t>;
+
+    /**
+     * @brief Move rows to a target like a drag and drop, keeping their relative order
+     *
+     * @param rows rows to move
+     * @param target row to insert before, as seen before the move. The row count moves them to the end.
+     * @return std::pair<size_t, size_t> first and one past the last row whose mod changed
+     */
+    auto moveRows(std::vector<size_t> rows, size_t target) -> std::pair<size_t, size_t>;
+
+    /**
+     * @brief Reverse the sort order
+     */
+    void reverseOrder();
+
+private:
+    [[nodiscard]] static auto getEdgeKey(const size_t& idA, const size_t& idB) -> uint64_t;
+    void addEdge(const size_t& idA, const size_t& idB, const uint8_t& shaderMask);
+    void updateRows(const size_t& first, const size_t& last);
+};
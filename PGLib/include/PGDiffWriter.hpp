@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "PGThreadBuffers.hpp"
+
+/**
+ * @class PGDiffWriter
+ * @brief Collects the CRC32 of every patched NIF and writes the diff JSON
+ *
+ * Each worker thread appends compact records to its own log, so adding a record takes no lock. A log that grows past
+ * the run size is sorted and spilled to a binary run file. finish merges all runs and the remaining logs by path and
+ * streams out the same JSON that dumping a sorted nlohmann::json object would, without ever holding all of it.
+ */
+class PGDiffWriter {
+public:
+    /**
+     * @struct Record
+     * @brief Diff entry of one NIF
+     */
+    struct Record {
+        std::string path; /** < UTF-8 path of the NIF, the JSON key */
+        uint32_t crcOriginal = 0;
+        uint32_t crcPatched = 0;
+    };
+
+    static constexpr size_t DEFAULT_RUN_BYTES = 4ULL * 1024 * 1024;
+
+private:
+    /**
+     * @struct ThreadLog
+     * @brief Records added by one thread since its last spill
+     */
+    struct ThreadLog {
+        std::vector<Record> records;
+        size_t numBytes = 0;
+    };
+
+    std::filesystem::path m_runDir;
+    size_t m_runBytes;
+
+    PGThreadBuffers<ThreadLog> m_logs;
+    std::mutex m_mutex; /** < Guards m_runs */
+    std::vector<std::filesystem::path> m_runs;
+    size_t m_nextRun = 0;
+
+    std::atomic<size_t> m_numRecords = 0;
+    std::atomic<bool> m_spillFailed = false;
+
+public:
+    /**
+     * @brief Construct a new PGDiffWriter
+     *
+     * @param runDir directory for spilled runs, created when the first run is written and removed by finish
+     * @param runBytes approximate size of the records a thread keeps in memory before spilling them
+     */
+    explicit PGDiffWriter(std::filesystem::path runDir, const size_t& runBytes = DEFAULT_RUN_BYTES);
+    ~PGDiffWriter();
+    PGDiffWriter(const PGDiffWriter&) = delete;
+    auto operator=(const PGDiffWriter&) -> PGDiffWriter& = delete;
+    PGDiffWriter(PGDiffWriter&&) = delete;
+    auto operator=(PGDiffWriter&&) -> PGDiffWriter& = delete;
+
+    /**
+     * @brief Add the entry of one NIF. Thread safe, a later entry for the same path from the same thread replaces
+     * the earlier one.
+     *
+     * @param path UTF-8 path of the NIF
+     * @param crcOriginal CRC32 of the original NIF
+     * @param crcPatched CRC32 of the patched NIF
+     */
+    void add(std::string path, const uint32_t& crcOriginal, const uint32_t& crcPatched);
+
+    /**
+     * @brief Merge all records and write the diff JSON. Must not run concurrently with add.
+     *
+     * @param jsonPath file to write
+     * @return true on success
+     */
+    [[nodiscard]] auto finish(const std::filesystem::path& jsonPath) -> bool;
+
+    [[nodiscard]] auto getNumRecords() const -> size_t;
+    [[nodiscard]] auto getNumRuns() -> size_t;
+
+private:
+    auto spill(ThreadLog& log) -> bool;
+    void removeRuns();
+
+    static void sortRecords(std::vector<Record>& records);
+    static auto writeRecord(std::ofstream& stream, const Record& record) -> bool;
+    static auto readRecord(std::ifstream& stream, Record& record) -> bool;
+    static void writeJSONEntry(std::ofstream& stream, const Record& record, const bool& first);
+};
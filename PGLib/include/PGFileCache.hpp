@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class PGFileCache
+ * @brief LRU cache of immutable file buffers that charges its size against PGMemoryBudget
+ *
+ * Buffers are handed out as shared pointers so hits do not copy and evicted entries stay alive for as long as a caller
+ * still holds them. Entries larger than a fraction of the budget are not admitted at all, since caching them would
+ * flush most of the cache for a single file.
+ */
+class PGFileCache {
+public:
+    using Buffer = std::shared_ptr<const std::vector<std::byte>>;
+
+private:
+    struct Entry {
+        std::filesystem::path key;
+        Buffer buffer;
+    };
+
+    std::list<Entry> m_lru; /** < Most recently used entries are at the front */
+    std::unordered_map<std::filesystem::path, std::list<Entry>::iterator> m_index; /** < Key lookup into m_lru */
+    size_t m_bytes = 0; /** < Bytes held by this cache */
+    std::mutex m_mutex; /** < Mutex for all members */
+
+    int m_evictorID; /** < ID registered with PGMemoryBudget */
+
+    static constexpr size_t MAX_ENTRY_FRACTION = 4; /** < Entries above budget / this are not cached */
+
+public:
+    PGFileCache();
+    ~PGFileCache();
+    PGFileCache(const PGFileCache&) = delete;
+    auto operator=(const PGFileCache&) -> PGFileCache& = delete;
+    PGFileCache(PGFileCache&&) = delete;
+    auto operator=(PGFileCache&&) -> PGFileCache& = delete;
+
+    /**
+     * @brief Get a cached buffer and mark it as recently used
+     *
+     * @param key cache key
+     * @return Buffer cached buffer, nullptr on miss
+     */
+    [[nodiscard]] auto get(const std::filesystem::path& key) -> Buffer;
+
+    /**
+     * @brief Insert a buffer, evicting least recently used entries if the budget requires it
+     *
+     * @param key cache key
+     * @param buffer buffer to cache
+     * @return true if the buffer was admitted to the cache
+     */
+    auto put(const std::filesystem::path& key, const Buffer& buffer) -> bool;
+
+    /**
+     * @brief Check whether a buffer is currently held (and charged) by the cache
+     *
+     * @param key cache key
+     * @param buffer buffer returned for that key
+     * @return true if the cache holds this exact buffer under key
+     */
+    [[nodiscard]] auto holds(const std::filesystem::path& key, const Buffer& buffer) -> bool;
+
+    /**
+     * @brief Evict least recently used entries
+     *
+     * @param bytes number of bytes to free
+     * @return size_t number of bytes freed
+     */
+    auto evict(const size_t& bytes) -> size_t;
+
+    /**
+     * @brief Remove all entries
+     */
+    void clear();
+
+    [[nodiscard]] auto size() -> size_t;
+    [[nodiscard]] auto getBytes() -> size_t;
+
+private:
+    // Assumes m_mutex is held
+    auto evictLocked(const size_t& bytes) -> size_t;
+    void eraseLocked(const std::list<Entry>::iterator& it);
+};
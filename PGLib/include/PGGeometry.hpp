@@ -0,0 +1,78 @@
+#pragma once
+
+#include <Geometry.hpp>
+#include <NifFile.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <unordered_map>
+
+/**
+ * @class PGGeometry
+ * @brief Analysis of shape geometry
+ *
+ * Kernels gather triangles into structure-of-arrays batches so the arithmetic runs over contiguous floats the compiler
+ * can vectorize. Results are cached by a hash of the geometry because the same mesh is often patched once per variant
+ * and mod.
+ */
+class PGGeometry {
+private:
+    static constexpr size_t BATCH_SIZE = 256; /** < Triangles gathered per batch */
+    static constexpr size_t NUM_LANES = 8; /** < Independent partial sums, one SIMD register of floats */
+
+    static constexpr size_t MAX_CACHE_ENTRIES = 65536; /** < Oldest results are dropped past this many */
+
+    static std::mutex s_uvScaleCacheMutex;
+    static std::unordered_map<uint64_t, nifly::Vector2> s_uvScaleCache;
+    static std::deque<uint64_t> s_uvScaleCacheOrder; /** < Cached hashes, oldest first */
+
+public:
+    /**
+     * @brief Texel density based UV scale that makes textures cover a shape at a uniform world size, the scale the
+     * TruePBR "auto_uv" attribute divides by its value
+     *
+     * @param uvs UVs of shape
+     * @param verts Vertices of shape
+     * @param tris Triangles of shape, triangles with out of range indices are ignored
+     * @return std::optional<nifly::Vector2> scale, u and v are the same. Empty if no triangle is in range.
+     */
+    [[nodiscard]] static auto getAutoUVScale(std::span<const nifly::Vector2> uvs,
+        std::span<const nifly::Vector3> verts, std::span<const nifly::Triangle> tris) -> std::optional<nifly::Vector2>;
+
+    /**
+     * @brief getAutoUVScale, looked up by geometry hash first. Thread safe. The cache keeps the most recent
+     * MAX_CACHE_ENTRIES results.
+     */
+    [[nodiscard]] static auto getAutoUVScaleCached(std::span<const nifly::Vector2> uvs,
+        std::span<const nifly::Vector3> verts, std::span<const nifly::Triangle> tris) -> std::optional<nifly::Vector2>;
+
+    /**
+     * @brief Auto UV scale of a shape. NiTriShape/NiTriStrips data blocks and the packed BSTriShape vertex layout are
+     * both read through nifly.
+     *
+     * @param nif NIF that contains the shape
+     * @param nifShape shape to measure
+     * @return std::optional<nifly::Vector2> scale, empty if the shape has no UVs or no valid triangles
+     */
+    [[nodiscard]] static auto getShapeAutoUVScale(nifly::NifFile& nif, nifly::NiShape* nifShape)
+        -> std::optional<nifly::Vector2>;
+
+    /**
+     * @brief 64-bit hash of vertex positions, UVs and triangles
+     */
+    [[nodiscard]] static auto getGeometryHash(std::span<const nifly::Vector2> uvs,
+        std::span<const nifly::Vector3> verts, std::span<const nifly::Triangle> tris) -> uint64_t;
+
+    /**
+     * @brief Continue a 64-bit hash over raw bytes, used for geometry fingerprints
+     */
+    [[nodiscard]] static auto hashBytes(const void* data, const size_t& size, uint64_t hash) -> uint64_t;
+
+    [[nodiscard]] static auto getCacheSize() -> size_t;
+    [[nodiscard]] static auto getMaxCacheSize() -> size_t;
+    static void clearCache();
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "PGThreadBuffers.hpp"
+
+/**
+ * @class PGLightPlacerCollector
+ * @brief Collects Light Placer light entries from worker threads and merges them into the output JSON at the end of a
+ * run
+ *
+ * Each thread appends entries to its own buffer, so adding a light takes no shared lock after the thread's first call.
+ * merge() groups entries by model and light data and sorts groups and points, so the output does not depend on which
+ * thread found which light or in what order.
+ */
+class PGLightPlacerCollector {
+public:
+    using Point = std::array<double, 3>;
+
+private:
+    struct Entry {
+        std::string model;
+        std::string data; /** < Light data serialized, keys are sorted so equal data serializes the same */
+        Point point;
+    };
+
+    struct ThreadBuffer {
+        std::vector<Entry> entries;
+    };
+
+    PGThreadBuffers<ThreadBuffer> m_buffers; /** < Lights of each adding thread */
+
+public:
+    /**
+     * @brief Record a light from the calling thread
+     *
+     * @param model model path the light is placed on, relative to meshes
+     * @param data Light Placer "data" object of the light
+     * @param point position of the light in model space
+     */
+    void add(const std::string& model, const nlohmann::json& data, const Point& point);
+
+    /**
+     * @brief Merge all thread buffers into Light Placer JSON. Must not run concurrently with add().
+     *
+     * @return nlohmann::json array with one object per model, sorted by model. Lights within a model are sorted by
+     * data and hold all points with that data, sorted.
+     */
+    [[nodiscard]] auto merge() -> nlohmann::json;
+
+    /**
+     * @brief Number of lights held
+     */
+    [[nodiscard]] auto size() -> size_t;
+
+    /**
+     * @brief Drop all lights. Must not run concurrently with add().
+     */
+    void clear();
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <spdlog/common.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ * @class PGLogTransport
+ * @brief Bulk transport of log messages from the managed plugin library
+ *
+ * The managed side drops messages below the published level before formatting them and queues the rest as UTF-16
+ * records of [level, length low, length high, text...]. drain copies as many whole records as fit into one buffer per
+ * call instead of crossing the boundary once per message.
+ */
+class PGLogTransport {
+public:
+    static constexpr int TRACE_LOG = 0;
+    static constexpr int DEBUG_LOG = 1;
+    static constexpr int INFO_LOG = 2;
+    static constexpr int WARN_LOG = 3;
+    static constexpr int ERROR_LOG = 4;
+    static constexpr int CRITICAL_LOG = 5;
+    static constexpr int OFF_LOG = 6;
+
+    static constexpr size_t HEADER_SIZE = 3;
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 64ULL * 1024;
+
+    /// @brief Copies pending records into the buffer and returns the number of units written, 0 when none are left
+    using Source = std::function<size_t(uint16_t* buffer, const size_t& bufferSize)>;
+    using Sink = std::function<void(const int& level, const std::wstring& message)>;
+
+private:
+    Source m_source;
+    std::vector<uint16_t> m_buffer;
+
+public:
+    /**
+     * @brief Construct a new PGLogTransport
+     *
+     * @param source function that fills a buffer with records
+     * @param bufferSize units per call, longer messages are cut off by the source
+     */
+    explicit PGLogTransport(Source source, const size_t& bufferSize = DEFAULT_BUFFER_SIZE);
+
+    /**
+     * @brief Pass all pending messages to the sink in the order they were logged
+     *
+     * @param sink receives each message
+     * @return size_t number of messages
+     */
+    auto drain(const Sink& sink) -> size_t;
+
+    /**
+     * @brief Decode records from one buffer. Stops at a record that runs past the end.
+     *
+     * @param records buffer filled by the source
+     * @param sink receives each message
+     * @return size_t number of messages
+     */
+    static auto decode(std::span<const uint16_t> records, const Sink& sink) -> size_t;
+
+    /**
+     * @brief Get the managed level that matches an spdlog level, messages below it are dropped on the managed side
+     */
+    [[nodiscard]] static auto toManagedLevel(const spdlog::level::level_enum& level) -> int;
+};
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+/**
+ * @class PGMemoryBudget
+ * @brief Global byte budget shared by caches and in-flight buffers
+ *
+ * Caches charge the bytes they hold and register an evictor that can be asked to give memory back. Large transient
+ * buffers (NIF bytes, scratch images) are charged through a scoped Reservation. ParallaxGenRunner calls
+ * waitForHeadroom() before starting a task so that new work is throttled while the budget is close to exhausted.
+ */
+class PGMemoryBudget {
+public:
+    /// @brief Callback that tries to free the requested number of bytes, returns the number actually freed
+    using Evictor = std::function<size_t(const size_t&)>;
+
+private:
+    static std::atomic<size_t> s_budget; /** < Budget in bytes, 0 means unlimited */
+    static std::atomic<size_t> s_used; /** < Bytes currently charged (caches + reservations) */
+    static std::atomic<size_t> s_inFlight; /** < Bytes currently charged by reservations only */
+
+    static std::unordered_map<int, Evictor> s_evictors; /** < Registered cache evictors */
+    static int s_nextEvictorID; /** < ID handed out to the next evictor */
+    static std::mutex s_evictorsMutex; /** < Mutex for evictors */
+
+    static std::mutex s_headroomMutex; /** < Mutex for s_headroomCV */
+    static std::condition_variable s_headroomCV; /** < Notified whenever charged bytes are released */
+
+    static constexpr double HIGH_WATERMARK = 0.9; /** < Fraction of budget at which new work is throttled */
+    static constexpr size_t DEFAULT_BUDGET_DIVISOR = 2; /** < Default budget is physical memory / this */
+
+public:
+    /**
+     * @brief Scoped charge for a transient buffer, released on destruction
+     */
+    class Reservation {
+    private:
+        size_t m_bytes;
+
+    public:
+        explicit Reservation(const size_t& bytes);
+        ~Reservation();
+        Reservation(const Reservation&) = delete;
+        auto operator=(const Reservation&) -> Reservation& = delete;
+        Reservation(Reservation&&) = delete;
+        auto operator=(Reservation&&) -> Reservation& = delete;
+    };
+
+    /**
+     * @brief Set the global budget in bytes. 0 disables the budget.
+     *
+     * @param bytes budget in bytes
+     */
+    static void setBudget(const size_t& bytes);
+
+    /**
+     * @brief Get a sensible default budget based on installed physical memory
+     *
+     * @return size_t budget in bytes, 0 if physical memory could not be determined
+     */
+    [[nodiscard]] static auto getDefaultBudget() -> size_t;
+
+    [[nodiscard]] static auto getBudget() -> size_t;
+    [[nodiscard]] static auto getUsed() -> size_t;
+    [[nodiscard]] static auto getInFlight() -> size_t;
+
+    /**
+     * @brief Check whether a further allocation of the given size fits below the budget
+     *
+     * @param bytes number of bytes that would be added
+     * @return true if the bytes fit or no budget is set
+     */
+    [[nodiscard]] static auto fits(const size_t& bytes) -> bool;
+
+    /**
+     * @brief Check whether usage is above the high watermark
+     *
+     * @return true if new work should be throttled
+     */
+    [[nodiscard]] static auto isNearLimit() -> bool;
+
+    /**
+     * @brief Charge bytes held by a cache against the budget
+     *
+     * @param bytes number of bytes
+     */
+    static void charge(const size_t& bytes);
+
+    /**
+     * @brief Release bytes previously charged with charge()
+     *
+     * @param bytes number of bytes
+     */
+    static void release(const size_t& bytes);
+
+    /**
+     * @brief Register a cache evictor
+     *
+     * @param evictor callback used to free memory
+     * @return int id to pass to removeEvictor()
+     */
+    static auto addEvictor(const Evictor& evictor) -> int;
+
+    /**
+     * @brief Unregister a cache evictor
+     *
+     * @param id id returned from addEvictor()
+     */
+    static void removeEvictor(const int& id);
+
+    /**
+     * @brief Ask registered caches to free memory
+     *
+     * @param bytes number of bytes to free
+     * @return size_t number of bytes freed
+     */
+    static auto reclaim(const size_t& bytes) -> size_t;
+
+    /**
+     * @brief Block until usage is below the high watermark. Caches are asked to shrink first, after that this waits
+     * for in-flight reservations to be released. Returns immediately if there is nothing in flight that could free
+     * memory, so it can never deadlock.
+     *
+     * @param stop checked along with usage, returns true to stop waiting early, e.g. once the caller's work was
+     * aborted and the reservations it waits on may never be released. Call notifyHeadroom() after it turns true.
+     */
+    static void waitForHeadroom(const std::function<bool()>& stop = nullptr);
+
+    /// @brief Wake threads blocked in waitForHeadroom() so they re-check usage and their stop condition
+    static void notifyHeadroom();
+
+private:
+    [[nodiscard]] static auto getHighWatermark() -> size_t;
+};
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <DirectXTex.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class PGMipGenerator
+ * @brief CPU mip chain generation for uncompressed textures
+ *
+ * Each level is filtered from the previous one in linear light as float RGBA, rows of a level are split across
+ * threads. Box filtering matches a plain 2x2 average, Kaiser filtering is a windowed sinc that keeps small mips sharp.
+ * sRGB data is linearized before filtering and alpha-tested textures can keep their alpha coverage on every level.
+ */
+class PGMipGenerator {
+public:
+    enum class Filter : uint8_t { BOX, KAISER };
+
+    /**
+     * @struct Options
+     * @brief Controls how a mip chain is built
+     */
+    struct Options {
+        Filter filter = Filter::KAISER;
+        size_t mipLevels = 0; /** < Levels including the top one, 0 for a full chain */
+        bool forceSRGB = false; /** < Treat UNORM color as sRGB, _SRGB formats always are */
+        float alphaCoverageRef = -1.0F; /** < Alpha test reference to preserve coverage for, negative to disable */
+        bool wrap = false; /** < Wrap instead of clamp at the edges, for tiling textures */
+        bool multiThread = true;
+    };
+
+    /// @brief Float RGBA texel used for filtering
+    using Texel = std::array<float, 4>;
+
+private:
+    static constexpr float KAISER_ALPHA = 4.0F;
+    static constexpr float KAISER_WIDTH = 3.0F; /** < Filter radius in destination texels */
+    static constexpr size_t MIN_ROWS_PER_TASK = 16; /** < Levels smaller than this run on one thread */
+
+    /**
+     * @struct Level
+     * @brief One mip level as linear float texels
+     */
+    struct Level {
+        size_t width = 0;
+        size_t height = 0;
+        std::vector<Texel> texels;
+    };
+
+public:
+    /**
+     * @brief Whether a format can be read and written by the generator
+     */
+    [[nodiscard]] static auto isFormatSupported(const DXGI_FORMAT& format) -> bool;
+
+    /**
+     * @brief Number of levels in a full chain down to 1x1
+     */
+    [[nodiscard]] static auto countMipLevels(const size_t& width, const size_t& height) -> size_t;
+
+    /**
+     * @brief Build a mip chain from a single image. The top level of the output is a copy of the input.
+     *
+     * @param base top level
+     * @param options generation options
+     * @param[out] output texture with the base format and the requested levels
+     * @return true on success, false for unsupported formats or allocation failures
+     */
+    static auto generate(const DirectX::Image& base, const Options& options, DirectX::ScratchImage& output) -> bool;
+
+    /**
+     * @brief Rebuild the mips of a 2D texture in place if it has fewer levels than requested
+     *
+     * Texture patchers call this on shader output before saving it, because a source texture without mips would
+     * otherwise produce a generated map without mips.
+     *
+     * @param image texture to complete, left untouched on failure
+     * @param options generation options, a mipLevels of 0 asks for a full chain
+     * @return true if the texture has the requested levels afterwards
+     */
+    static auto ensureMipChain(DirectX::ScratchImage& image, const Options& options) -> bool;
+
+private:
+    static auto isSRGB(const DXGI_FORMAT& format, const Options& options) -> bool;
+
+    static void readImage(const DirectX::Image& image, const bool& srgb, const bool& multiThread, Level& level);
+    static void writeImage(const Level& level, const bool& srgb, const bool& multiThread, const DirectX::Image& image);
+
+    static void downsample(const Level& src, Level& dst, const Options& options);
+    static void downsampleBox(const Level& src, Level& dst, const size_t& rowStart, const size_t& rowEnd);
+
+    /**
+     * @brief Separable Kaiser filter weights of one axis
+     *
+     * @param srcSize source size on the axis
+     * @param dstSize destination size on the axis
+     * @param wrap wrap instead of clamp at the edges
+     * @param[out] taps source indices per destination texel
+     * @param[out] weights normalized weights per destination texel
+     */
+    static void buildKaiserTaps(const size_t& srcSize, const size_t& dstSize, const bool& wrap,
+        std::vector<std::vector<size_t>>& taps, std::vector<std::vector<float>>& weights);
+
+    /**
+     * @brief Fraction of texels with scaled alpha above the reference
+     */
+    static auto getAlphaCoverage(const Level& level, const float& ref, const float& scale) -> float;
+
+    /**
+     * @brief Scale the alpha of a level so its coverage matches the target
+     */
+    static void scaleAlphaToCoverage(Level& level, const float& ref, const float& targetCoverage);
+
+    /**
+     * @brief Run func(rowStart, rowEnd) over chunks of rows, in parallel if enabled and worth it
+     */
+    template <typename Func> static void forEachRows(const size_t& numRows, const bool& multiThread, Func&& func);
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <NifFile.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ * @class PGNIFSplicer
+ * @brief Writes a patched NIF by splicing the changed blocks into a copy of the original bytes
+ *
+ * Most mesh patches only change texture paths, shader flags, shader types or a few floats. capture records the block
+ * layout of the original bytes and a fingerprint of every shape's geometry. If the patched NIF still has the same
+ * blocks in the same order and no geometry changed, save reserializes only the small non geometry blocks, keeps the
+ * original bytes of the ones that did not change and appends new strings to the string table. Shapes, geometry data
+ * and skin partitions are copied as they are. Anything else needs a full save.
+ */
+class PGNIFSplicer {
+public:
+    static constexpr uint32_t SUPPORTED_VERSION = 0x14020007; /** < 20.2.0.7 */
+    static constexpr uint32_t SUPPORTED_USER_VERSION = 12;
+    static constexpr uint32_t MAX_STREAM_VERSION = 100; /** < Skyrim LE and SE, newer headers have more fields */
+
+    /**
+     * @struct Layout
+     * @brief Offsets of the header sections and blocks in a NIF
+     */
+    struct Layout {
+        size_t blockSizesOffset = 0; /** < Block size array in the header */
+        size_t stringsOffset = 0; /** < String count, followed by max length and the strings */
+        size_t groupsOffset = 0; /** < Group count, first byte after the string table */
+        std::vector<size_t> blockOffsets; /** < Start of each block, the last entry is the footer */
+        std::vector<std::string> blockTypes; /** < Type name of each block */
+        std::vector<std::string> strings; /** < Header string table */
+    };
+
+private:
+    std::span<const std::byte> m_original;
+    std::optional<Layout> m_layout;
+    std::vector<nifly::NiObject*> m_blocks;
+    std::vector<uint64_t> m_shapeFingerprints;
+
+public:
+    /**
+     * @brief Parse the layout of a NIF. Only the little endian Skyrim header layout is supported.
+     *
+     * @param nifBytes NIF file bytes
+     * @return std::optional<Layout> layout, empty if the version is not supported or the sizes do not add up
+     */
+    [[nodiscard]] static auto parseLayout(std::span<const std::byte> nifBytes) -> std::optional<Layout>;
+
+    /**
+     * @brief Record the original state, must be called before any patcher runs
+     *
+     * @param nif NIF loaded from nifBytes
+     * @param nifBytes original bytes, must stay valid until save
+     */
+    void capture(nifly::NifFile& nif, std::span<const std::byte> nifBytes);
+
+    /**
+     * @brief Check if the patched NIF can be spliced. Call before anything that deletes or sorts blocks.
+     *
+     * @param nif patched NIF
+     * @return true if the blocks and geometry are unchanged and the layout of the original was understood
+     */
+    [[nodiscard]] auto canSplice(nifly::NifFile& nif) const -> bool;
+
+    /**
+     * @brief Write the patched NIF. Requires canSplice, the NIF may be a copy of the checked one. String references
+     * of changed blocks are updated.
+     *
+     * @param nif patched NIF
+     * @return std::vector<std::byte> NIF file bytes, empty if the blocks no longer match the original
+     */
+    [[nodiscard]] auto save(nifly::NifFile& nif) const -> std::vector<std::byte>;
+
+    /**
+     * @brief Forget the captured state, save needs a new capture
+     */
+    void reset();
+
+    [[nodiscard]] auto isCaptured() const -> bool;
+
+private:
+    [[nodiscard]] static auto isGeometryBlock(nifly::NiObject* block) -> bool;
+    [[nodiscard]] static auto getShapeFingerprint(nifly::NifFile& nif, nifly::NiShape* shape) -> uint64_t;
+    [[nodiscard]] static auto getShapeFingerprints(nifly::NifFile& nif) -> std::vector<uint64_t>;
+};
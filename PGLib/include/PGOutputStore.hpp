@@ -0,0 +1,139 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class PGOutputStore
+ * @brief Content-addressed writer for output files
+ *
+ * Every buffer is hashed before it is written. The first file with some content is written normally, later files with
+ * the same bytes become hardlinks to it, or plain copies where the filesystem cannot link. A manifest maps every
+ * logical output path to its content and the path that holds it. Files written through the store may share storage,
+ * so they must be replaced rather than modified in place.
+ *
+ * Texture patchers write every generated map through the store. Many meshes point at copies of the same source
+ * texture, and identical sources produce identical maps, so most duplicates only cost a link.
+ */
+class PGOutputStore {
+public:
+    enum class WriteResult : uint8_t {
+        FAILED,
+        WRITTEN, /** < First file with this content */
+        LINKED, /** < Hardlinked to an earlier identical file */
+        COPIED /** < Identical to an earlier file, but linking was not possible */
+    };
+
+    /**
+     * @struct ManifestEntry
+     * @brief Content of one logical output path
+     */
+    struct ManifestEntry {
+        uint64_t hash = 0;
+        uint64_t size = 0;
+        std::filesystem::path contentPath; /** < Output path that first received this content */
+    };
+
+private:
+    static constexpr size_t NUM_SHARDS = 64;
+
+    struct ContentKey {
+        uint64_t hash;
+        uint64_t size;
+
+        auto operator==(const ContentKey& other) const -> bool = default;
+    };
+
+    struct ContentKeyHasher {
+        auto operator()(const ContentKey& key) const -> size_t { return static_cast<size_t>(key.hash ^ key.size); }
+    };
+
+    /**
+     * @struct Shard
+     * @brief Known contents of one hash range. Writes of the same content serialize on the shard mutex.
+     */
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<ContentKey, std::vector<std::filesystem::path>, ContentKeyHasher> contents;
+    };
+
+    std::filesystem::path m_outputDir;
+    std::atomic<bool> m_useHardLinks;
+
+    std::array<Shard, NUM_SHARDS> m_shards;
+
+    mutable std::mutex m_manifestMutex;
+    std::map<std::filesystem::path, ManifestEntry> m_manifest;
+
+    std::atomic<size_t> m_numDeduplicated = 0;
+    std::atomic<uint64_t> m_bytesDeduplicated = 0;
+
+public:
+    /**
+     * @brief Construct a new PGOutputStore
+     *
+     * @param outputDir directory that relative output paths are resolved against
+     * @param useHardLinks link duplicates, copies them if false
+     */
+    explicit PGOutputStore(std::filesystem::path outputDir, const bool& useHardLinks = true);
+    virtual ~PGOutputStore() = default;
+    PGOutputStore(const PGOutputStore&) = delete;
+    auto operator=(const PGOutputStore&) -> PGOutputStore& = delete;
+    PGOutputStore(PGOutputStore&&) = delete;
+    auto operator=(PGOutputStore&&) -> PGOutputStore& = delete;
+
+    /**
+     * @brief Write a buffer to an output path, sharing storage with an earlier identical file if there is one.
+     * Thread safe.
+     *
+     * @param relPath output path relative to the output directory
+     * @param data file contents
+     * @return WriteResult how the file was stored
+     */
+    auto write(const std::filesystem::path& relPath, std::span<const std::byte> data) -> WriteResult;
+
+    /**
+     * @brief Write the manifest of all paths written so far as JSON, sorted by path
+     *
+     * @param manifestPath file to write
+     * @return true on success
+     */
+    [[nodiscard]] auto writeManifest(const std::filesystem::path& manifestPath) const -> bool;
+
+    [[nodiscard]] auto getManifest() const -> std::map<std::filesystem::path, ManifestEntry>;
+    [[nodiscard]] auto getNumDeduplicated() const -> size_t;
+    [[nodiscard]] auto getBytesDeduplicated() const -> uint64_t;
+
+    /**
+     * @brief Stable 64-bit FNV-1a hash of a buffer
+     */
+    [[nodiscard]] static auto getContentHash(std::span<const std::byte> data) -> uint64_t;
+
+    /**
+     * @brief File name of the manifest in the output directory
+     */
+    [[nodiscard]] static auto getManifestName() -> std::filesystem::path;
+
+protected:
+    /**
+     * @brief Create a hardlink, virtual so tests can simulate filesystems without link support
+     *
+     * @return true if the link was created
+     */
+    virtual auto createHardLink(const std::filesystem::path& target, const std::filesystem::path& link) -> bool;
+
+private:
+    static auto writeFile(const std::filesystem::path& filePath, std::span<const std::byte> data) -> bool;
+    static auto isSameContent(const std::filesystem::path& filePath, std::span<const std::byte> data) -> bool;
+
+    void addManifestEntry(const std::filesystem::path& relPath, const ManifestEntry& entry);
+};
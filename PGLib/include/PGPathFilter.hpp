@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+/**
+ * @class PGPathFilter
+ * @brief Lock free existence queries for the file map
+ *
+ * Built once from the keys of the file map after it is populated. A blocked bloom filter answers most misses without
+ * touching the map, a frozen open addressing table of the map keys answers hits. Paths are compared ignoring ASCII
+ * case and with repeated separators collapsed, like the lowercase map keys. Paths added after the build only go into
+ * the bloom filter, queries for them return UNKNOWN and have to be answered by the map.
+ */
+class PGPathFilter {
+public:
+    enum class Result : uint8_t {
+        ABSENT, /** < Path is definitely not in the set */
+        PRESENT, /** < Path is in the set */
+        UNKNOWN /** < Filter was not built, the path was added after the build, or a false positive */
+    };
+
+private:
+    // all probes of a key land in one cache line sized block of the bloom filter
+    static constexpr size_t WORDS_PER_BLOCK = 8;
+    static constexpr size_t BITS_PER_BLOCK = WORDS_PER_BLOCK * 64;
+    static constexpr size_t BITS_PER_KEY = 12;
+    static constexpr unsigned NUM_PROBES = 6;
+    static constexpr unsigned PROBE_BITS = 9;
+    static constexpr uint64_t PROBE_MASK = (1ULL << PROBE_BITS) - 1;
+    static constexpr unsigned WORD_SHIFT = 6;
+    static constexpr uint64_t BIT_MASK = 63;
+
+    struct Slot {
+        uint64_t hash = 0;
+        const std::filesystem::path* key = nullptr;
+    };
+
+    std::unique_ptr<std::atomic<uint64_t>[]> m_bloom; // NOLINT(cppcoreguidelines-avoid-c-arrays)
+    size_t m_blockMask = 0;
+    std::vector<Slot> m_slots;
+    size_t m_slotMask = 0;
+    std::atomic<bool> m_built = false;
+
+public:
+    /**
+     * @brief Build the filter, replacing the previous one. Must not run concurrently with queries.
+     *
+     * @param paths keys of the set, must stay valid until the filter is cleared or rebuilt
+     */
+    void build(const std::vector<const std::filesystem::path*>& paths);
+
+    /**
+     * @brief Add a path after the build, safe to call concurrently with queries. Does nothing before the build.
+     *
+     * @param path path that was added to the set
+     */
+    void add(const std::filesystem::path& path);
+
+    /**
+     * @brief Check if a path is in the set
+     *
+     * @param path path to check, any case
+     * @return Result ABSENT and PRESENT are exact, UNKNOWN needs a lookup in the set
+     */
+    [[nodiscard]] auto query(const std::filesystem::path& path) const -> Result;
+
+    /**
+     * @brief Drop the filter, queries return UNKNOWN until the next build
+     */
+    void clear();
+
+    [[nodiscard]] auto isBuilt() const -> bool;
+
+    /**
+     * @brief Hash of a path ignoring ASCII case and repeated separators
+     *
+     * @param path path to hash
+     * @param hash receives the hash
+     * @return false if the path has non ASCII characters, those are not lowercased the same way as the map keys
+     */
+    [[nodiscard]] static auto getHash(const std::filesystem::path& path, uint64_t& hash) -> bool;
+
+private:
+    [[nodiscard]] static auto isEqual(const std::filesystem::path& lhs, const std::filesystem::path& rhs) -> bool;
+    void setBits(const uint64_t& hash);
+    [[nodiscard]] auto testBits(const uint64_t& hash) const -> bool;
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @class PGPipeline
+ * @brief Runs items through a chain of stages, each with its own threads, connected by bounded queues
+ *
+ * Items are indices into caller owned state, like ParallaxGenRunner::parallelFor. The first stage takes indices in
+ * order, every later stage pops them from a queue in front of it. A stage that finds its output queue full waits, so
+ * at most the queue capacities plus one item per worker are between the first and last stage at any time. This keeps
+ * a slow stage from piling up buffers that earlier stages produced, and lets stages that wait on disk run on more
+ * threads than there are cores without starving the stages that need the CPU.
+ */
+class PGPipeline {
+public:
+    /**
+     * @struct Stage
+     * @brief One step of the pipeline
+     */
+    struct Stage {
+        std::string name;
+        size_t numThreads = 1;
+        size_t queueCapacity = 1; /** < Items that may wait in front of this stage, unused for the first stage */
+        std::function<bool(size_t)> func; /** < Processes an item, returns false to drop it from later stages */
+    };
+
+    /// @brief Called for an item that an exception kept from finishing, by the thread that held it last
+    using DropFunc = std::function<void(size_t)>;
+
+private:
+    std::vector<Stage> m_stages;
+    bool m_multithread;
+    DropFunc m_onDrop;
+
+public:
+    /**
+     * @brief Construct a pipeline
+     *
+     * @param stages stages in order, at least one. Thread counts and capacities of 0 are raised to 1.
+     * @param multithread if false, run every item through all stages on the calling thread
+     * @param onDrop called for every item that was read but never finished because a stage threw, including the item
+     * that threw. Lets the caller release what the item holds, like memory budget reservations, while the pipeline
+     * winds down. May be empty.
+     */
+    explicit PGPipeline(std::vector<Stage> stages, const bool& multithread = true, DropFunc onDrop = nullptr);
+
+    /**
+     * @brief Blocking function that runs indices [0, count) through all stages. Intended to be run from the main
+     * thread.
+     *
+     * An exception in any stage stops all stages, including a first stage waiting for memory budget headroom. It is
+     * logged like ParallaxGenRunner does and rethrown on the calling thread.
+     *
+     * @param count number of items
+     */
+    void run(const size_t& count);
+};
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+
+/**
+ * @class PGPlatform
+ * @brief Operating system services used by PGLib, with a Windows and a POSIX implementation
+ *
+ * Everything that would otherwise need windows.h (known folders, registry, shell globbing, native frees, GPU probing,
+ * memory-mapped files) goes through here so that the directory, NIF and patcher code builds and runs headless on
+ * Linux. The POSIX side returns "not found" for things that only exist on Windows (registry, D3D11).
+ */
+class PGPlatform {
+public:
+    enum class KnownFolder : uint8_t { DOCUMENTS, LOCAL_APPDATA };
+
+    enum class RegistryRoot : uint8_t { CURRENT_USER, LOCAL_MACHINE };
+
+    /**
+     * @brief Read-only view of a whole file mapped into memory, unmapped on destruction
+     */
+    class MappedFile {
+    private:
+        const std::byte* m_data = nullptr;
+        size_t m_size = 0;
+        void* m_mapping = nullptr; /** < Mapping handle on Windows, unused on POSIX */
+        bool m_open = false;
+
+    public:
+        MappedFile() = default;
+        explicit MappedFile(const std::filesystem::path& filePath);
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        auto operator=(const MappedFile&) -> MappedFile& = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        auto operator=(MappedFile&& other) noexcept -> MappedFile&;
+
+        /**
+         * @brief Whether the file was opened. Empty files are open but have no data.
+         */
+        [[nodiscard]] auto isOpen() const -> bool;
+
+        [[nodiscard]] auto getData() const -> std::span<const std::byte>;
+
+    private:
+        void close();
+    };
+
+    /**
+     * @brief Get the path of a user folder
+     *
+     * @param folder folder to get
+     * @return std::filesystem::path path or empty if it could not be determined
+     */
+    [[nodiscard]] static auto getKnownFolder(const KnownFolder& folder) -> std::filesystem::path;
+
+    /**
+     * @brief Get the path of the running executable
+     *
+     * @return std::filesystem::path path or empty if it could not be determined
+     */
+    [[nodiscard]] static auto getExecutablePath() -> std::filesystem::path;
+
+    /**
+     * @brief Read a string value from the registry
+     *
+     * @param root registry hive
+     * @param subKey key path below the hive
+     * @param valueName name of the value
+     * @return std::string value or empty if it does not exist (always empty on POSIX)
+     */
+    [[nodiscard]] static auto getRegistryString(
+        const RegistryRoot& root, const std::string& subKey, const std::string& valueName) -> std::string;
+
+    /**
+     * @brief Case-insensitive shell wildcard match, "*" matches any run of characters including separators and "?"
+     * matches one character
+     *
+     * @param str string to check
+     * @param glob pattern
+     * @return true str matches the pattern
+     */
+    [[nodiscard]] static auto globMatch(const std::wstring& str, const std::wstring& glob) -> bool;
+
+    /**
+     * @brief Free a string that was allocated by the native side of the plugin bridge
+     *
+     * @param ptr pointer to free, nullptr is ignored
+     */
+    static void freeNativeString(void* ptr);
+
+    /**
+     * @brief Get installed physical memory
+     *
+     * @return uint64_t bytes or 0 if unknown
+     */
+    [[nodiscard]] static auto getTotalPhysicalMemory() -> uint64_t;
+
+    /**
+     * @brief Check whether a hardware D3D11 device can be created. Always false on POSIX.
+     */
+    [[nodiscard]] static auto isGPUAvailable() -> bool;
+
+    /**
+     * @brief Get a readable message for an HRESULT returned by DirectXTex or D3D
+     *
+     * @param hr HRESULT value
+     * @return std::string system message on Windows, the hex code on POSIX
+     */
+    [[nodiscard]] static auto getHRESULTMessage(const int32_t& hr) -> std::string;
+};
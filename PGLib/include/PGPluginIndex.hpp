@@ -0,0 +1,94 @@
+#pragma once
+
+#include <nlohmann/json_fwd.hpp>
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class PGPluginIndex
+ * @brief Index of which TXST and alternate texture handles reference each (NIF, 3D index)
+ *
+ * Built from the plugin library after PopulateObjs and persisted to cache/pluginIndex.json together with a fingerprint
+ * of the load order. As long as the plugin list and the size and modification time of every plugin are unchanged, the
+ * next run loads it instead of walking every record again. Matches are answered here without calling into the plugin
+ * library.
+ */
+class PGPluginIndex {
+public:
+    static constexpr int CACHE_VERSION = 1;
+
+    /**
+     * @struct Match
+     * @brief Alternate texture that uses a texture set on a shape
+     */
+    struct Match {
+        int txstHandle = -1;
+        int altTexHandle = -1;
+        std::string type; /** < Model element type, "MODL", "MALE", "FEMALE", ... */
+    };
+
+private:
+    std::unordered_map<std::wstring, std::unordered_map<int, std::vector<Match>>> m_matches;
+    size_t m_numMatches = 0;
+
+public:
+    /**
+     * @brief Get the fingerprint of a load order, stored with the index and compared on load
+     *
+     * @param dataPath game data folder
+     * @param plugins active plugins in load order
+     * @return nlohmann::json fingerprint
+     */
+    [[nodiscard]] static auto getFingerprint(
+        const std::filesystem::path& dataPath, const std::vector<std::wstring>& plugins) -> nlohmann::json;
+
+    /**
+     * @brief Add a match. Matches of the same key are returned in the order they were added.
+     *
+     * @param nifName lowercase NIF path starting with "meshes\"
+     * @param index3D 3D index of the shape
+     * @param match handles of the match
+     */
+    void add(const std::wstring& nifName, const int& index3D, Match match);
+
+    /**
+     * @brief Get the matches of a shape, including matches of the paired _0/_1 NIF for non MODL elements
+     *
+     * @param nifName NIF path starting with "meshes\"
+     * @param index3D 3D index of the shape
+     * @return tuples of (TXST handle, alternate texture handle, matched NIF, type)
+     */
+    [[nodiscard]] auto getMatches(const std::wstring& nifName, const int& index3D) const
+        -> std::vector<std::tuple<int, int, std::wstring, std::string>>;
+
+    [[nodiscard]] auto size() const -> size_t;
+
+    void clear();
+
+    /**
+     * @brief Write the index
+     *
+     * @param file file to write
+     * @param fingerprint load order fingerprint from getFingerprint
+     * @return true on success
+     */
+    [[nodiscard]] auto save(const std::filesystem::path& file, const nlohmann::json& fingerprint) const -> bool;
+
+    /**
+     * @brief Replace the index with a persisted one
+     *
+     * @param file file to read
+     * @param fingerprint fingerprint of the current load order
+     * @return true if the file exists, parses and was written for the same fingerprint. The index is left empty
+     * otherwise.
+     */
+    auto load(const std::filesystem::path& file, const nlohmann::json& fingerprint) -> bool;
+
+private:
+    [[nodiscard]] auto find(const std::wstring& nifName, const int& index3D) const -> const std::vector<Match>*;
+};
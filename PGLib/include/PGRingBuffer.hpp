@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+/**
+ * @class PGRingBuffer
+ * @brief Bounded lock-free multi-producer multi-consumer queue
+ *
+ * Each cell carries a sequence number that tells producers and consumers whether it is free or filled for the current
+ * lap, so push and pop only need one compare-exchange on the shared position. Capacity must be a power of two.
+ *
+ * @tparam T element type, must be default constructible and move assignable
+ */
+template <typename T> class PGRingBuffer {
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    // keep producer and consumer positions on separate cache lines
+    static constexpr size_t CACHE_LINE = 64;
+
+    std::unique_ptr<Cell[]> m_cells; // NOLINT(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+    size_t m_mask;
+    alignas(CACHE_LINE) std::atomic<size_t> m_enqueuePos { 0 };
+    alignas(CACHE_LINE) std::atomic<size_t> m_dequeuePos { 0 };
+
+public:
+    explicit PGRingBuffer(const size_t& capacity)
+        : m_cells(std::make_unique<Cell[]>(capacity)) // NOLINT(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+        , m_mask(capacity - 1)
+    {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+            throw std::invalid_argument("PGRingBuffer capacity must be a power of two");
+        }
+
+        for (size_t i = 0; i < capacity; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Try to push an element
+     *
+     * @param value element to push, moved from on success only
+     * @return true if pushed, false if the buffer is full
+     */
+    auto tryPush(T& value) -> bool
+    {
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        while (true) {
+            cell = &m_cells[pos & m_mask];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // full
+                return false;
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Try to pop an element
+     *
+     * @param value set to the popped element
+     * @return true if popped, false if the buffer is empty
+     */
+    auto tryPop(T& value) -> bool
+    {
+        size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        while (true) {
+            cell = &m_cells[pos & m_mask];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // empty
+                return false;
+            } else {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        value = std::move(cell->data);
+        cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    [[nodiscard]] auto capacity() const -> size_t { return m_mask + 1; }
+};
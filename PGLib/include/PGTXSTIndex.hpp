@@ -0,0 +1,144 @@
+#pragma once
+
+#include <nlohmann/json_fwd.hpp>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "NIFUtil.hpp"
+
+/**
+ * @class PGTXSTIndex
+ * @brief Deduplication index for generated TXST records and the form IDs assigned to them
+ *
+ * Slot tuples are canonicalized once (lowercase, backslash separators) and carry a precomputed 64-bit hash, so lookups
+ * never re-lowercase the nine slot strings. The index is split into shards that are locked independently. Form IDs are
+ * allocated against the persisted txstFormIDs.json cache so that records keep their form ID and EDID between runs.
+ */
+class PGTXSTIndex {
+public:
+    /**
+     * @struct SlotKey
+     * @brief Canonicalized texture slots with a stored hash
+     */
+    struct SlotKey {
+        NIFUtil::TextureSet slots;
+        uint64_t hash = 0;
+
+        /**
+         * @brief Build a key from raw slots, canonicalizing and hashing them
+         *
+         * @param rawSlots slots as read from a NIF or plugin
+         * @return SlotKey canonical key
+         */
+        static auto fromSlots(const NIFUtil::TextureSet& rawSlots) -> SlotKey;
+
+        /**
+         * @brief Stable 64-bit FNV-1a hash of canonical slots. Does not depend on the standard library implementation
+         * so it is the same across runs and builds.
+         *
+         * @param canonicalSlots slots that are already canonical
+         * @return uint64_t hash
+         */
+        static auto hashSlots(const NIFUtil::TextureSet& canonicalSlots) -> uint64_t;
+
+        auto operator==(const SlotKey& other) const -> bool { return hash == other.hash && slots == other.slots; }
+    };
+
+    struct SlotKeyHash {
+        auto operator()(const SlotKey& key) const -> size_t { return static_cast<size_t>(key.hash); }
+    };
+
+    /**
+     * @struct Entry
+     * @brief A TXST record created by the plugin patcher
+     */
+    struct Entry {
+        int txstIndex = -1;
+        std::string edid;
+    };
+
+private:
+    static constexpr size_t NUM_SHARDS = 16;
+
+    struct Shard {
+        std::unordered_map<SlotKey, Entry, SlotKeyHash> entries;
+        std::mutex mutex;
+    };
+
+    std::array<Shard, NUM_SHARDS> m_shards;
+
+    std::unordered_map<std::string, unsigned int> m_cachedFormIDs; /** < Form IDs loaded from the cache */
+    std::unordered_map<std::string, unsigned int> m_newFormIDs; /** < Form IDs assigned during this run */
+    std::unordered_set<unsigned int> m_reservedFormIDs; /** < Form IDs held by the cache */
+    std::unordered_set<unsigned int> m_usedFormIDs; /** < Form IDs assigned during this run */
+    unsigned int m_curFormID = 0; /** < Last sequentially allocated form ID */
+    std::mutex m_formIDMutex; /** < Mutex for form ID members */
+
+public:
+    /**
+     * @brief Find an existing entry or create one. The creator runs under the shard lock so concurrent callers with
+     * the same slots create exactly one record.
+     *
+     * @param key canonical slot key
+     * @param creator called to create the record if it does not exist yet
+     * @return std::pair<Entry, bool> entry and whether it was created by this call
+     */
+    auto getOrCreate(const SlotKey& key, const std::function<Entry()>& creator) -> std::pair<Entry, bool>;
+
+    /**
+     * @brief Find an existing entry
+     *
+     * @param key canonical slot key
+     * @param entry set to the found entry
+     * @return true if found
+     */
+    auto find(const SlotKey& key, Entry& entry) -> bool;
+
+    [[nodiscard]] auto size() -> size_t;
+
+    /**
+     * @brief Load the persisted form ID cache, replacing any previously loaded cache
+     *
+     * @param formIDCache JSON object of cache key -> form ID
+     */
+    void loadFormIDCache(const nlohmann::json& formIDCache);
+
+    /**
+     * @brief Get the form ID cache to persist, containing only form IDs used during this run
+     *
+     * @return nlohmann::json JSON object of cache key -> form ID
+     */
+    [[nodiscard]] auto getFormIDCache() -> nlohmann::json;
+
+    /**
+     * @brief Allocate a form ID for a new record. Reuses the cached form ID for the cache key if it is still free,
+     * otherwise takes the next form ID that is not reserved by the cache.
+     *
+     * @param cacheKey stable key describing where the record is used
+     * @return unsigned int allocated form ID
+     */
+    auto allocateFormID(const std::string& cacheKey) -> unsigned int;
+
+    /**
+     * @brief Get the EDID for a generated TXST form ID
+     *
+     * @param formID form ID
+     * @return std::string EDID
+     */
+    [[nodiscard]] static auto getEDID(const unsigned int& formID) -> std::string;
+
+    /**
+     * @brief Remove all entries and form ID state
+     */
+    void clear();
+
+private:
+    auto getShard(const SlotKey& key) -> Shard&;
+};
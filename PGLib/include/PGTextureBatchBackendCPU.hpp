@@ -0,0 +1,48 @@
+#pragma once
+
+#include <DirectXTex.h>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <span>
+#include <unordered_map>
+
+#include "PGTextureBatcher.hpp"
+
+/**
+ * @class PGTextureBatchBackendCPU
+ * @brief Texture batch backend that runs registered C++ kernels instead of compute shaders
+ *
+ * Used where no GPU is available (tests, headless Linux runs). Kernels are registered under the same shader handle
+ * that callers pass to PGTextureBatcher::process().
+ */
+class PGTextureBatchBackendCPU : public PGTextureBatcher::Backend {
+public:
+    /**
+     * @brief Fills the top mip of the output (already initialized to the output format and size) from the input
+     */
+    using Kernel = std::function<bool(
+        const DirectX::ScratchImage& input, DirectX::ScratchImage& output, std::span<const std::byte> params)>;
+
+private:
+    class CPUSlot : public Slot {
+    public:
+        DirectX::ScratchImage top; /** < Top mip written by the kernel, reused across jobs */
+        DirectX::ScratchImage result;
+    };
+
+    std::unordered_map<PGTextureBatcher::ShaderHandle, Kernel> m_kernels;
+
+public:
+    /**
+     * @brief Register the kernel run for a shader handle
+     */
+    void registerKernel(PGTextureBatcher::ShaderHandle shader, Kernel kernel);
+
+    auto createSlot(const PGTextureBatcher::BatchKey& key) -> std::unique_ptr<Slot> override;
+    auto upload(Slot& slot, const PGTextureBatcher::Job& job) -> bool override;
+    auto dispatch(Slot& slot, const PGTextureBatcher::Job& job) -> bool override;
+    void flush() override;
+    auto readBack(Slot& slot, const PGTextureBatcher::Job& job) -> bool override;
+};
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <DirectXTex.h>
+
+#include <atomic>
+#include <compare>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @class PGTextureBatcher
+ * @brief Runs texture shader jobs from concurrent callers in pipelined batches
+ *
+ * Callers block in process() just like a direct dispatch. The first caller that finds no batch running drains the
+ * queue, groups jobs with the same shader, formats and dimensions, and runs each group stage by stage (upload all,
+ * dispatch all, one flush, read back all) on pooled backend resources. This replaces one GPU sync per texture with
+ * one per group. The backend does the actual work, so the same batching runs against D3D11 or the CPU.
+ */
+class PGTextureBatcher {
+public:
+    /// @brief Opaque shader identity, the backend knows what it points to
+    using ShaderHandle = const void*;
+
+    /**
+     * @struct BatchKey
+     * @brief Jobs with equal keys share pooled resources and run in the same group
+     */
+    struct BatchKey {
+        ShaderHandle shader = nullptr;
+        DXGI_FORMAT inFormat = DXGI_FORMAT_UNKNOWN;
+        DXGI_FORMAT outFormat = DXGI_FORMAT_UNKNOWN;
+        size_t width = 0;
+        size_t height = 0;
+        size_t mipLevels = 0;
+        size_t paramsSize = 0;
+
+        auto operator<=>(const BatchKey& other) const = default;
+    };
+
+    /**
+     * @struct Job
+     * @brief One texture to run through a shader. The output has the input's mip count, regenerated from the top mip.
+     */
+    struct Job {
+        BatchKey key;
+        const DirectX::ScratchImage* input = nullptr;
+        std::vector<std::byte> params;
+        DirectX::ScratchImage* output = nullptr;
+
+        bool success = false;
+        bool done = false;
+        std::exception_ptr error;
+    };
+
+    /**
+     * @class Backend
+     * @brief Executes the stages of a batch. Stages of one group are called in order for every job before the next
+     * stage starts, and only ever from one thread at a time.
+     */
+    class Backend {
+    public:
+        /**
+         * @brief Resources for one job of a key, reused across batches
+         */
+        class Slot {
+        public:
+            Slot() = default;
+            virtual ~Slot() = default;
+            Slot(const Slot&) = delete;
+            auto operator=(const Slot&) -> Slot& = delete;
+            Slot(Slot&&) = delete;
+            auto operator=(Slot&&) -> Slot& = delete;
+        };
+
+        Backend() = default;
+        virtual ~Backend() = default;
+        Backend(const Backend&) = delete;
+        auto operator=(const Backend&) -> Backend& = delete;
+        Backend(Backend&&) = delete;
+        auto operator=(Backend&&) -> Backend& = delete;
+
+        /**
+         * @brief Create resources for a key
+         *
+         * @return std::unique_ptr<Slot> slot or nullptr if resources could not be created
+         */
+        virtual auto createSlot(const BatchKey& key) -> std::unique_ptr<Slot> = 0;
+
+        /// @brief Copy the input and parameters of a job into a slot
+        virtual auto upload(Slot& slot, const Job& job) -> bool = 0;
+
+        /// @brief Queue the shader and mip generation of a job, should not wait for completion
+        virtual auto dispatch(Slot& slot, const Job& job) -> bool = 0;
+
+        /// @brief Submit all queued work of the group
+        virtual void flush() = 0;
+
+        /// @brief Copy the finished result of a slot into the job output
+        virtual auto readBack(Slot& slot, const Job& job) -> bool = 0;
+    };
+
+private:
+    static constexpr size_t DEFAULT_MAX_BATCH_SIZE = 16;
+    static constexpr size_t MAX_BATCH_PIXELS = size_t { 16 } * 1024 * 1024; /** < Caps slots of large textures */
+    static constexpr size_t POOL_IDLE_BATCHES = 64; /** < Pooled slots unused for this many batches are dropped */
+
+    Backend* m_backend;
+    size_t m_maxBatchSize;
+
+    std::mutex m_queueMutex;
+    std::condition_variable m_queueCV;
+    std::deque<Job*> m_queue;
+    bool m_draining = false; /** < Whether a caller is currently running a batch */
+
+    /**
+     * @struct PoolEntry
+     * @brief Pooled slots of one key, only touched by the draining caller
+     */
+    struct PoolEntry {
+        std::vector<std::unique_ptr<Backend::Slot>> slots;
+        size_t lastUsedBatch = 0;
+    };
+    std::map<BatchKey, PoolEntry> m_pool;
+
+    std::atomic<size_t> m_numBatches = 0;
+    std::atomic<size_t> m_numSlotsCreated = 0;
+
+public:
+    /**
+     * @brief Construct a new batcher
+     *
+     * @param backend backend that runs the stages, must outlive the batcher
+     * @param maxBatchSize max jobs taken from the queue per batch
+     */
+    explicit PGTextureBatcher(Backend* backend, const size_t& maxBatchSize = DEFAULT_MAX_BATCH_SIZE);
+
+    /**
+     * @brief Run a shader on a texture, blocking until the batch containing it is done. Thread safe.
+     *
+     * @param input input texture
+     * @param[out] output output texture
+     * @param shader shader to run
+     * @param outFormat format of the output texture
+     * @param params shader parameters or nullptr
+     * @param paramsSize size of the shader parameters
+     * @return true on success
+     */
+    auto process(const DirectX::ScratchImage& input, DirectX::ScratchImage& output, ShaderHandle shader,
+        const DXGI_FORMAT& outFormat, const void* params = nullptr, const size_t& paramsSize = 0) -> bool;
+
+    /**
+     * @brief Release all pooled slots. Must not be called while process() is running.
+     */
+    void clearPool();
+
+    [[nodiscard]] auto getNumBatches() const -> size_t;
+    [[nodiscard]] auto getNumSlotsCreated() const -> size_t;
+
+    /**
+     * @brief Max jobs of a key that run at the same time, smaller for large textures
+     */
+    [[nodiscard]] auto getWaveSize(const BatchKey& key) const -> size_t;
+
+private:
+    void runBatch(const std::vector<Job*>& jobs);
+    void runGroup(const BatchKey& key, const std::vector<Job*>& jobs);
+    void trimPool();
+};
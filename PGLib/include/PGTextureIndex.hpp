@@ -0,0 +1,213 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "NIFUtil.hpp"
+#include "PGThreadBuffers.hpp"
+
+/**
+ * @class PGTextureIndex
+ * @brief Reverse dependency index from textures to the mesh shapes that use them, plus the winning shader patcher of
+ * every patched shape
+ *
+ * Filled while patching, then saved to disk so that "who uses this texture", "what does this mod affect" and "why did
+ * this shape get this shader" can be answered without a full run. Recording is off until setEnabled(true), so runs
+ * that never query the index pay nothing for it. Worker threads record into their own buffers, which merge() folds
+ * into the index once patching is done.
+ */
+class PGTextureIndex {
+public:
+    static constexpr int INDEX_VERSION = 1;
+
+    /// @brief Resolves a path to the mod that provides it, empty if unknown
+    using ModResolver = std::function<std::wstring(const std::wstring&)>;
+
+    /// @brief (texture path, shape index, slot) for every non-empty slot of every shape of a mesh
+    using MeshRefs = std::vector<std::tuple<std::wstring, int, NIFUtil::TextureSlots>>;
+
+    /**
+     * @struct TextureRef
+     * @brief One texture slot of one shape that references a texture
+     */
+    struct TextureRef {
+        std::wstring mesh;
+        int shapeIndex = -1;
+        NIFUtil::TextureSlots slot = NIFUtil::TextureSlots::UNKNOWN;
+
+        auto operator==(const TextureRef& other) const -> bool = default;
+    };
+
+    /**
+     * @struct ShaderCandidate
+     * @brief A shader patcher that could have been applied to a shape
+     */
+    struct ShaderCandidate {
+        NIFUtil::ShapeShader shader = NIFUtil::ShapeShader::UNKNOWN;
+        std::wstring mod;
+        std::wstring matchedPath;
+    };
+
+    /**
+     * @struct ShapeResult
+     * @brief Winning shader of a shape and all candidates it was chosen from
+     */
+    struct ShapeResult {
+        ShaderCandidate winner;
+        std::vector<ShaderCandidate> candidates;
+    };
+
+    /**
+     * @struct ModImpact
+     * @brief Everything a mod affects according to the index
+     */
+    struct ModImpact {
+        std::vector<std::wstring> textures; /** < Textures the mod provides that are used by any mesh */
+        std::vector<std::wstring> meshes; /** < Meshes that use those textures or that the mod provides */
+        std::vector<std::pair<std::wstring, int>> wonShapes; /** < Shapes where the mod won the shader match */
+    };
+
+private:
+    struct Ref {
+        uint32_t mesh;
+        int shapeIndex;
+        NIFUtil::TextureSlots slot;
+    };
+
+    struct ThreadBuffer {
+        std::vector<std::pair<std::wstring, MeshRefs>> meshRefs;
+        std::vector<std::tuple<std::wstring, int, ShapeResult>> shapeResults;
+    };
+
+    std::vector<std::wstring> m_paths; /** < Interned lowercase paths */
+    std::unordered_map<std::wstring, uint32_t> m_pathIDs;
+    std::vector<std::wstring> m_pathMods; /** < Mod of each interned path, only set after resolveMods or load */
+
+    std::unordered_map<uint32_t, std::vector<Ref>> m_textureRefs; /** < Texture path id to referencing shapes */
+    std::unordered_map<uint32_t, std::vector<uint32_t>> m_meshTextures; /** < Mesh path id to referenced textures */
+    std::map<std::pair<uint32_t, int>, ShapeResult> m_shapeResults; /** < (mesh path id, shape index) to result */
+
+    mutable std::mutex m_mutex;
+
+    bool m_enabled = false;
+    PGThreadBuffers<ThreadBuffer> m_buffers; /** < Records not merged yet */
+
+public:
+    /**
+     * @brief Turn recording on or off. Must be set before any thread records.
+     */
+    void setEnabled(const bool& enabled);
+
+    /**
+     * @brief Whether setMeshRefs() and setShapeResult() record anything
+     */
+    [[nodiscard]] auto isEnabled() const -> bool;
+
+    /**
+     * @brief Record all texture references of one mesh, replacing any earlier ones for that mesh once merged. Does
+     * nothing unless enabled.
+     *
+     * @param mesh mesh path
+     * @param refs references of the mesh
+     */
+    void setMeshRefs(const std::wstring& mesh, const MeshRefs& refs);
+
+    /**
+     * @brief Record the shader result of one shape once merged. Does nothing unless enabled.
+     *
+     * @param mesh mesh path
+     * @param shapeIndex index of the shape in the mesh
+     * @param result winning shader and candidates
+     */
+    void setShapeResult(const std::wstring& mesh, const int& shapeIndex, ShapeResult result);
+
+    /**
+     * @brief Fold the records of all threads into the index. Records are applied sorted by mesh and shape so the
+     * result does not depend on which thread recorded what. Must not run concurrently with recording.
+     */
+    void merge();
+
+    /**
+     * @brief Merge, then resolve and store the mod of every indexed path
+     *
+     * @param resolver path to mod resolver
+     */
+    void resolveMods(const ModResolver& resolver);
+
+    /**
+     * @brief Get every shape slot that references a texture
+     *
+     * @param texture texture path, the "textures\" prefix may be omitted
+     * @return std::vector<TextureRef> references sorted by mesh, shape and slot
+     */
+    [[nodiscard]] auto getUsers(const std::wstring& texture) const -> std::vector<TextureRef>;
+
+    /**
+     * @brief Get the shader result of a shape
+     *
+     * @param mesh mesh path
+     * @param shapeIndex index of the shape in the mesh
+     * @return std::optional<ShapeResult> result or nullopt if the shape was never matched
+     */
+    [[nodiscard]] auto getShapeResult(const std::wstring& mesh, const int& shapeIndex) const
+        -> std::optional<ShapeResult>;
+
+    /**
+     * @brief Get everything a mod affects. Requires resolveMods() or load() first.
+     *
+     * @param mod mod name
+     * @return ModImpact sorted textures, meshes and shapes
+     */
+    [[nodiscard]] auto getModImpact(const std::wstring& mod) const -> ModImpact;
+
+    /**
+     * @brief Number of textures with at least one reference
+     */
+    [[nodiscard]] auto getNumTextures() const -> size_t;
+
+    /**
+     * @brief Number of shapes with a shader result
+     */
+    [[nodiscard]] auto getNumShapeResults() const -> size_t;
+
+    [[nodiscard]] auto toJSON() const -> nlohmann::json;
+
+    /**
+     * @brief Replace the index with the contents of a JSON object created by toJSON(). Throws runtime_error if the
+     * version does not match.
+     */
+    void loadJSON(const nlohmann::json& json);
+
+    /**
+     * @brief Save the index to a file
+     */
+    void save(const std::filesystem::path& indexFile) const;
+
+    /**
+     * @brief Load the index from a file
+     */
+    void load(const std::filesystem::path& indexFile);
+
+    void clear();
+
+    /**
+     * @brief Lowercase a path and use backslash separators, as paths are stored in the index
+     */
+    [[nodiscard]] static auto normalizePath(const std::wstring& path) -> std::wstring;
+
+private:
+    void applyMeshRefs(const std::wstring& mesh, const MeshRefs& refs);
+    auto intern(const std::wstring& path) -> uint32_t;
+    [[nodiscard]] auto findPathID(const std::wstring& path) const -> std::optional<uint32_t>;
+};
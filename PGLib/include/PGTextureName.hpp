@@ -0,0 +1,87 @@
+#pragma once
+
+#include "NIFUtil.hpp"
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+/**
+ * @class PGTextureName
+ * @brief Texture base, slot and type from the suffix of a texture path
+ *
+ * The known suffixes are compiled into a trie of their reversed characters at build time. A path is matched by
+ * walking back from its end, at most as many characters as the longest suffix, and nothing is allocated. Suffixes
+ * match ignoring ASCII case. The longest matching suffix wins, for this table that is the same suffix the search in
+ * getTexSuffixMap order found.
+ */
+class PGTextureName {
+public:
+    struct Suffix {
+        std::wstring_view suffix;
+        NIFUtil::TextureSlots slot;
+        NIFUtil::TextureType type;
+    };
+
+    // NOLINTBEGIN(readability-magic-numbers)
+    static constexpr std::array<Suffix, 18> SUFFIXES = { {
+        { .suffix = L"_bl", .slot = NIFUtil::TextureSlots::BACKLIGHT, .type = NIFUtil::TextureType::BACKLIGHT },
+        { .suffix = L"_b", .slot = NIFUtil::TextureSlots::BACKLIGHT, .type = NIFUtil::TextureType::BACKLIGHT },
+        { .suffix = L"_cnr",
+            .slot = NIFUtil::TextureSlots::MULTILAYER,
+            .type = NIFUtil::TextureType::COATNORMALROUGHNESS },
+        { .suffix = L"_s", .slot = NIFUtil::TextureSlots::MULTILAYER, .type = NIFUtil::TextureType::SUBSURFACETINT },
+        { .suffix = L"_i", .slot = NIFUtil::TextureSlots::MULTILAYER, .type = NIFUtil::TextureType::INNERLAYER },
+        { .suffix = L"_f", .slot = NIFUtil::TextureSlots::MULTILAYER, .type = NIFUtil::TextureType::FUZZPBR },
+        { .suffix = L"_rmaos", .slot = NIFUtil::TextureSlots::ENVMASK, .type = NIFUtil::TextureType::RMAOS },
+        { .suffix = L"_envmask",
+            .slot = NIFUtil::TextureSlots::ENVMASK,
+            .type = NIFUtil::TextureType::ENVIRONMENTMASK },
+        { .suffix = L"_em", .slot = NIFUtil::TextureSlots::ENVMASK, .type = NIFUtil::TextureType::ENVIRONMENTMASK },
+        { .suffix = L"_m", .slot = NIFUtil::TextureSlots::ENVMASK, .type = NIFUtil::TextureType::ENVIRONMENTMASK },
+        { .suffix = L"_e", .slot = NIFUtil::TextureSlots::CUBEMAP, .type = NIFUtil::TextureType::CUBEMAP },
+        { .suffix = L"_p", .slot = NIFUtil::TextureSlots::PARALLAX, .type = NIFUtil::TextureType::HEIGHT },
+        { .suffix = L"_sk", .slot = NIFUtil::TextureSlots::GLOW, .type = NIFUtil::TextureType::SKINTINT },
+        { .suffix = L"_g", .slot = NIFUtil::TextureSlots::GLOW, .type = NIFUtil::TextureType::EMISSIVE },
+        { .suffix = L"_msn", .slot = NIFUtil::TextureSlots::NORMAL, .type = NIFUtil::TextureType::NORMAL },
+        { .suffix = L"_n", .slot = NIFUtil::TextureSlots::NORMAL, .type = NIFUtil::TextureType::NORMAL },
+        { .suffix = L"_d", .slot = NIFUtil::TextureSlots::DIFFUSE, .type = NIFUtil::TextureType::DIFFUSE },
+        { .suffix = L"mask", .slot = NIFUtil::TextureSlots::DIFFUSE, .type = NIFUtil::TextureType::DIFFUSE },
+    } };
+    // NOLINTEND(readability-magic-numbers)
+
+    struct Result {
+        std::wstring_view base; /** < Path without the suffix, points into the parsed string */
+        NIFUtil::TextureSlots slot = NIFUtil::TextureSlots::UNKNOWN;
+        NIFUtil::TextureType type = NIFUtil::TextureType::UNKNOWN;
+    };
+
+    /**
+     * @brief Match the suffix of a path without extension
+     *
+     * @param pathWithoutExtension path like parent_path() / stem() writes it
+     * @return Result base and the slot and type of the suffix, UNKNOWN and the whole path if no suffix matches
+     */
+    [[nodiscard]] static auto parse(std::wstring_view pathWithoutExtension) -> Result;
+
+    /**
+     * @brief Remove the extension without going through std::filesystem::path
+     *
+     * @param path texture path
+     * @return std::optional<std::wstring_view> path without extension, the same as parent_path() / stem() would write
+     * it. Empty for paths that std::filesystem rewrites, like mixed or repeated separators.
+     */
+    [[nodiscard]] static auto stripExtension(std::wstring_view path) -> std::optional<std::wstring_view>;
+
+    /**
+     * @brief Path without extension, through the std::filesystem::path fallback if needed
+     *
+     * @param path texture path
+     * @param storage holds the path if it had to be rewritten, the result points into it or into path
+     * @return std::wstring_view path without extension
+     */
+    [[nodiscard]] static auto stripExtension(std::wstring_view path, std::wstring& storage) -> std::wstring_view;
+
+    [[nodiscard]] static auto getMaxSuffixLength() -> size_t;
+};
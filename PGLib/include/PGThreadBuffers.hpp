@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+/**
+ * @class PGThreadBuffers
+ * @brief One buffer of type T per thread, owned by this object and looked up without a lock after a thread's first call
+ *
+ * Each thread caches a pointer to the buffer it used last together with the ID of the owning object. Buffers are only
+ * destroyed by reset() or the destructor, both of which must not run concurrently with local(). IDs are never reused and
+ * reset() takes a new one, so a cache entry of a destroyed buffer never matches again.
+ *
+ * @tparam T buffer type, default constructible
+ */
+template <typename T> class PGThreadBuffers {
+private:
+    /**
+     * @struct Cache
+     * @brief Buffer of the calling thread in the most recently used owner
+     */
+    struct Cache {
+        uint64_t ownerID = 0;
+        T* buffer = nullptr;
+    };
+
+    static inline std::atomic<uint64_t> s_nextID = 1;
+    static inline thread_local Cache s_cache;
+
+    std::unordered_map<std::thread::id, std::unique_ptr<T>> m_buffers;
+    std::mutex m_mutex; /** < Only taken the first time a thread uses this object, and by forEach and reset */
+    uint64_t m_id;
+
+public:
+    PGThreadBuffers()
+        : m_id(s_nextID.fetch_add(1))
+    {
+    }
+
+    ~PGThreadBuffers() = default;
+    PGThreadBuffers(const PGThreadBuffers&) = delete;
+    auto operator=(const PGThreadBuffers&) -> PGThreadBuffers& = delete;
+    PGThreadBuffers(PGThreadBuffers&&) = delete;
+    auto operator=(PGThreadBuffers&&) -> PGThreadBuffers& = delete;
+
+    /**
+     * @brief Buffer of the calling thread, created on first use
+     *
+     * @return T& buffer, stays valid until reset() or destruction
+     */
+    auto local() -> T&
+    {
+        if (s_cache.ownerID == m_id) {
+            return *s_cache.buffer;
+        }
+
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        auto& buffer = m_buffers[std::this_thread::get_id()];
+        if (buffer == nullptr) {
+            buffer = std::make_unique<T>();
+        }
+
+        s_cache = { .ownerID = m_id, .buffer = buffer.get() };
+        return *buffer;
+    }
+
+    /**
+     * @brief Visit the buffer of every thread that called local(). Must not run concurrently with local() when the
+     * visitor touches buffer contents.
+     *
+     * @param func called with each buffer while the lock is held
+     */
+    template <typename Func> void forEach(Func&& func)
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& [threadID, buffer] : m_buffers) {
+            func(*buffer);
+        }
+    }
+
+    /**
+     * @brief Destroy all buffers, the next local() on every thread creates a new one. Must not run concurrently with
+     * local().
+     */
+    void reset()
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        m_buffers.clear();
+        m_id = s_nextID.fetch_add(1);
+    }
+
+    /**
+     * @brief Changes on every reset(), so holders of a buffer can tell whether it still exists
+     */
+    [[nodiscard]] auto getID() const -> uint64_t { return m_id; }
+};
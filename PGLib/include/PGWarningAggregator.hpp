@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "PGThreadBuffers.hpp"
+
+/**
+ * @class PGWarningAggregator
+ * @brief Collects warning records from worker threads and merges them into a grouped report at the end of a run
+ *
+ * Each thread appends compact records (interned path id, interned path id, kind) to its own buffer, so adding a
+ * warning takes no shared lock after the thread's first call. Mod lookups, deduplication across threads, grouping and
+ * sorting all happen once in merge().
+ */
+class PGWarningAggregator {
+public:
+    enum class Kind : uint8_t { TEXTURE_MISMATCH, MESH_MISMATCH };
+    static constexpr size_t NUM_KINDS = 2;
+
+    /// @brief Resolves a path to the mod that provides it, empty if unknown
+    using ModResolver = std::function<std::wstring(const std::wstring&)>;
+
+    /**
+     * @struct Group
+     * @brief All deduplicated path pairs of one kind between two mods
+     */
+    struct Group {
+        std::wstring sourceMod;
+        std::wstring targetMod;
+        std::vector<std::pair<std::wstring, std::wstring>> paths; /** < Sorted (source path, target path) pairs */
+    };
+
+private:
+    struct Record {
+        uint32_t source;
+        uint32_t target;
+        Kind kind;
+    };
+
+    struct ThreadBuffer {
+        std::vector<Record> records;
+        std::unordered_map<std::wstring, uint32_t> pathIDs;
+        std::vector<std::wstring> paths;
+        std::array<std::unordered_set<uint64_t>, NUM_KINDS> seen; /** < Drops repeats before they reach records */
+
+        auto intern(const std::wstring& path) -> uint32_t;
+    };
+
+    PGThreadBuffers<ThreadBuffer> m_buffers; /** < Records of each adding thread */
+
+public:
+    /**
+     * @brief Record a warning from the calling thread
+     *
+     * @param kind warning kind
+     * @param sourcePath path that was matched
+     * @param targetPath path it was used with
+     */
+    void add(const Kind& kind, const std::wstring& sourcePath, const std::wstring& targetPath);
+
+    /**
+     * @brief Merge all thread buffers into groups. Must not run concurrently with add().
+     *
+     * Pairs whose mods cannot be resolved or resolve to the same mod are dropped.
+     *
+     * @param kind kind of warnings to merge
+     * @param sourceResolver resolves source paths to mods
+     * @param targetResolver resolves target paths to mods
+     * @return std::vector<Group> groups sorted by source mod, then target mod
+     */
+    [[nodiscard]] auto merge(const Kind& kind, const ModResolver& sourceResolver,
+        const ModResolver& targetResolver) -> std::vector<Group>;
+
+    /**
+     * @brief Number of records held, after per-thread dedup
+     */
+    [[nodiscard]] auto size() -> size_t;
+
+    /**
+     * @brief Drop all records. Must not run concurrently with add().
+     */
+    void clear();
+};
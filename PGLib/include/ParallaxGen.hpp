@@ -12,25 +12,45 @@
 #include <boost/functional/hash.hpp>
 
 #include "NIFUtil.hpp"
-#include "ParallaxGenD3D.hpp"
+#include "PGDiffWriter.hpp"
+#include "PGFileCache.hpp"
+#include "PGMemoryBudget.hpp"
+#include "PGNIFSplicer.hpp"
 #include "ParallaxGenDirectory.hpp"
 #include "ParallaxGenTask.hpp"
+#include "patchers/base/PatcherMeshPool.hpp"
 #include "patchers/base/PatcherUtil.hpp"
 
 class ParallaxGen {
+public:
+    /**
+     * @struct MeshPipelineSizes
+     * @brief Threads of each mesh pipeline stage and the queue in front of the patch and write stages, 0 for default
+     */
+    struct MeshPipelineSizes {
+        size_t readThreads = 0;
+        size_t patchThreads = 0;
+        size_t writeThreads = 0;
+        size_t queueCapacity = 0;
+    };
+
 private:
     static constexpr int MESHES_LENGTH = 7;
     static constexpr int PROGRESS_INTERVAL_CONFLICTS = 10;
+    static constexpr size_t DEFAULT_READ_THREADS = 4;
+    static constexpr size_t DEFAULT_WRITE_THREADS = 2;
+    static constexpr size_t DEFAULT_QUEUE_ITEMS_PER_PATCH_THREAD = 2;
 
     std::filesystem::path m_outputDir; // ParallaxGen output directory
 
     // Dependency objects
     ParallaxGenDirectory* m_pgd;
-    ParallaxGenD3D* m_pgd3D;
 
     // sort blocks enabled, optimize disabled (for now)
     nifly::NifSaveOptions m_nifSaveOptions = { .optimize = false, .sortBlocks = false };
 
+    MeshPipelineSizes m_meshPipelineSizes;
+
     struct ShapeKey {
         std::wstring nifPath;
         int shapeIndex;
@@ -44,7 +64,7 @@ private:
 
     // Runner vars
     PatcherUtil::PatcherTextureSet m_texPatchers;
-    PatcherUtil::PatcherMeshSet m_meshPatchers;
+    PatcherMeshPool m_meshPatchers; /** < Mesh patcher objects are reused across NIFs per worker thread */
     std::unordered_map<std::wstring, int>* m_modPriority;
 
     // Define a hash function for ShapeKey
@@ -68,17 +88,17 @@ public:
     //
 
     // constructor
-    ParallaxGen(std::filesystem::path outputDir, ParallaxGenDirectory* pgd, ParallaxGenD3D* pgd3D,
-        const bool& optimizeMeshes = false);
+    ParallaxGen(std::filesystem::path outputDir, ParallaxGenDirectory* pgd, const bool& optimizeMeshes = false);
     void loadPatchers(
         const PatcherUtil::PatcherMeshSet& meshPatchers, const PatcherUtil::PatcherTextureSet& texPatchers);
     void loadModPriorityMap(std::unordered_map<std::wstring, int>* modPriority);
+    // sets the thread counts and queue size of the mesh pipeline used by patch
+    void setMeshPipelineSizes(const MeshPipelineSizes& sizes);
     // enables parallax on relevant meshes
     void patch(const bool& multiThread = true, const bool& patchPlugin = true);
     // Dry run for finding potential matches (used with mod manager integration)
     [[nodiscard]] auto findModConflicts(const bool& multiThread = true, const bool& patchPlugin = true)
-        -> std::unordered_map<std::wstring,
-            std::tuple<std::set<NIFUtil::ShapeShader>, std::unordered_set<std::wstring>>>;
+        -> PGConflictGraph;
     // zips all meshes and removes originals
     void zipMeshes() const;
     // deletes entire output folder
@@ -101,20 +121,41 @@ private:
         }
     };
 
-    // thread safe JSON update
-    static void threadSafeJSONUpdate(
-        const std::function<void(nlohmann::json&)>& operation, nlohmann::json& j, std::mutex& mutex);
+    /**
+     * @struct MeshJob
+     * @brief State of one NIF between the read, patch and write stages
+     */
+    struct MeshJob {
+        ParallaxGenTask::PGResult result = ParallaxGenTask::PGResult::SUCCESS;
+        PGFileCache::Buffer nifBytes; /** < Released once patched */
+        std::unique_ptr<PGMemoryBudget::Reservation> reservation; /** < Held until the NIF is written */
+        uint32_t crcBefore = 0;
+        std::vector<std::byte> outputBytes; /** < Empty if the NIF was not modified */
+        std::vector<std::pair<std::filesystem::path, std::vector<std::byte>>> dupOutputs;
+    };
+
+    // get name of the folder that diff entries spill to while patching
+    [[nodiscard]] static auto getDiffRunsDirName() -> std::filesystem::path;
+
+    // get mesh pipeline sizes with defaults filled in
+    [[nodiscard]] auto getMeshPipelineSizes() const -> MeshPipelineSizes;
 
     // processes a NIF file (enable parallax if needed)
-    auto processNIF(const std::filesystem::path& nifFile, nlohmann::json* diffJSON, std::mutex* diffJSONMutex,
-        const bool& patchPlugin = true, PatcherUtil::ConflictModResults* conflictMods = nullptr)
-        -> ParallaxGenTask::PGResult;
+    auto processNIF(const std::filesystem::path& nifFile, PGDiffWriter* diffWriter, const bool& patchPlugin = true,
+        PatcherUtil::ConflictModResults* conflictMods = nullptr) -> ParallaxGenTask::PGResult;
+
+    // the stages of processNIF, each returns false if the NIF needs no further stages
+    auto readNIF(const std::filesystem::path& nifFile, MeshJob& job) -> bool;
+    auto patchNIF(const std::filesystem::path& nifFile, MeshJob& job, const bool& patchPlugin,
+        PatcherUtil::ConflictModResults* conflictMods) -> bool;
+    auto writeNIF(const std::filesystem::path& nifFile, MeshJob& job, PGDiffWriter* diffWriter) -> bool;
 
     // TODO this should return bool
     auto processNIF(const std::filesystem::path& nifFile, const std::vector<std::byte>& nifBytes, bool& nifModified,
         const std::vector<NIFUtil::ShapeShader>* forceShaders = nullptr,
         std::vector<std::pair<std::filesystem::path, nifly::NifFile>>* dupNIFs = nullptr,
-        const bool& patchPlugin = true, PatcherUtil::ConflictModResults* conflictMods = nullptr) -> nifly::NifFile;
+        const bool& patchPlugin = true, PatcherUtil::ConflictModResults* conflictMods = nullptr,
+        PGNIFSplicer* splicer = nullptr) -> nifly::NifFile;
 
     // processes a shape within a NIF file
     auto processShape(const std::filesystem::path& nifPath, nifly::NifFile& nif, nifly::NiShape* nifShape,
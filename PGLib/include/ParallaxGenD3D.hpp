@@ -7,11 +7,13 @@
 
 #include <cstddef>
 #include <filesystem>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "PGTextureBatcher.hpp"
 #include "ParallaxGenDirectory.hpp"
 
 class ParallaxGenD3D {
@@ -30,27 +32,49 @@ private:
 
     static inline const D3D_FEATURE_LEVEL s_featureLevel = D3D_FEATURE_LEVEL_11_0; // DX11
 
-    std::unordered_map<std::filesystem::path, DirectX::TexMetadata> m_ddsMetaDataCache;
-    std::mutex m_ddsMetaDataMutex;
-
     std::mutex m_gpuOperationMutex;
 
     // Global shader storage
     Microsoft::WRL::ComPtr<ID3D11ComputeShader> m_shaderCountAlphaValues;
 
+    /**
+     * @class BatchBackend
+     * @brief Runs texture batches on the device of the owning ParallaxGenD3D
+     */
+    class BatchBackend : public PGTextureBatcher::Backend {
+    private:
+        class D3DSlot : public Slot {
+        public:
+            Microsoft::WRL::ComPtr<ID3D11Texture2D> input;
+            Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> inputSRV;
+            Microsoft::WRL::ComPtr<ID3D11Buffer> params;
+            Microsoft::WRL::ComPtr<ID3D11Texture2D> output;
+            Microsoft::WRL::ComPtr<ID3D11UnorderedAccessView> outputUAV;
+            Microsoft::WRL::ComPtr<ID3D11Texture2D> mips;
+            Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> mipsSRV;
+            Microsoft::WRL::ComPtr<ID3D11Texture2D> staging;
+        };
+
+        ParallaxGenD3D* m_pgd3d;
+
+    public:
+        explicit BatchBackend(ParallaxGenD3D* pgd3d);
+
+        auto createSlot(const PGTextureBatcher::BatchKey& key) -> std::unique_ptr<Slot> override;
+        auto upload(Slot& slot, const PGTextureBatcher::Job& job) -> bool override;
+        auto dispatch(Slot& slot, const PGTextureBatcher::Job& job) -> bool override;
+        void flush() override;
+        auto readBack(Slot& slot, const PGTextureBatcher::Job& job) -> bool override;
+    };
+
+    std::unique_ptr<BatchBackend> m_batchBackend;
+    std::unique_ptr<PGTextureBatcher> m_textureBatcher; /** < Batches applyShaderToTexture calls, set by initGPU */
+
 public:
     //
     // Static Helpers
     //
 
-    /**
-     * @brief Get the error message from a HRESULT
-     *
-     * @param hr HRESULT
-     * @return std::string error message
-     */
-    static auto getHRESULTErrorMessage(HRESULT hr) -> std::string;
-
     /**
      * @brief Get the DXGI_FORMAT from a string
      *
@@ -92,7 +116,7 @@ public:
     //
 
     /**
-     * @brief Apply a shader to a texture
+     * @brief Apply a shader to a texture. Concurrent calls are batched, see PGTextureBatcher.
      *
      * @param inTexture input texture
      * @param shader shader to apply
@@ -295,41 +319,6 @@ public:
      */
     void flushGPU();
 
-    //
-    // Texture helpers
-    //
-
-    /**
-     * @brief Get the DDS image from a path
-     *
-     * @param ddsPath path of DDS file (relative to data)
-     * @param dds output DDS image
-     * @return true on success
-     * @return false on failure
-     */
-    auto getDDS(const std::filesystem::path& ddsPath, DirectX::ScratchImage& dds) const -> bool;
-
-    /**
-     * @brief Get the DDS metadata from a path
-     *
-     * @param ddsPath path of DDS file (relative to data)
-     * @param ddsMeta output DDS metadata
-     * @return true on success
-     * @return false on failure
-     */
-    auto getDDSMetadata(const std::filesystem::path& ddsPath, DirectX::TexMetadata& ddsMeta) -> bool;
-
-    /**
-     * @brief Check if aspect ratio between two textures matches
-     *
-     * @param ddsPath1 path of dds file 1
-     * @param ddsPath2 path of dds file 2
-     * @return true on success
-     * @return false on failure
-     */
-    auto checkIfAspectRatioMatches(const std::filesystem::path& ddsPath1, const std::filesystem::path& ddsPath2)
-        -> bool;
-
 private:
     auto checkIfCM(const std::filesystem::path& ddsPath, bool& result, bool& hasEnvMask, bool& hasGlosiness,
         bool& hasMetalness) -> bool;
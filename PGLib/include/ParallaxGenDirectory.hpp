@@ -11,11 +11,12 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
-#include <winnt.h>
 
 #include "BethesdaDirectory.hpp"
 #include "ModManagerDirectory.hpp"
 #include "NIFUtil.hpp"
+#include "PGOutputStore.hpp"
+#include "PGTextureIndex.hpp"
 #include "ParallaxGenTask.hpp"
 
 class ModManagerDirectory;
@@ -48,11 +49,17 @@ private:
     std::unordered_set<std::filesystem::path> m_textures;
     std::vector<std::filesystem::path> m_pbrJSONs;
 
+    std::unordered_map<std::filesystem::path, DirectX::TexMetadata> m_ddsMetaDataCache;
+
+    PGTextureIndex m_textureIndex; /** < Texture to shape references and shader results, for queries */
+    PGOutputStore m_outputStore; /** < Deduplicating writer for files in the generated directory */
+
     // Mutexes
     std::mutex m_textureMapsMutex;
     std::mutex m_textureTypesMutex;
     std::mutex m_meshesMutex;
     std::mutex m_texturesMutex;
+    std::mutex m_ddsMetaDataMutex;
 
 public:
     // constructor - calls the BethesdaDirectory constructor
@@ -125,6 +132,12 @@ public:
 
     [[nodiscard]] auto getPBRJSONs() const -> const std::vector<std::filesystem::path>&;
 
+    /// @brief Get the texture reverse index, filled while patching once enabled
+    [[nodiscard]] auto getTextureIndex() -> PGTextureIndex&;
+
+    /// @brief Get the writer for output files, identical outputs share storage
+    [[nodiscard]] auto getOutputStore() -> PGOutputStore&;
+
     auto addTextureAttribute(const std::filesystem::path& path, const NIFUtil::TextureAttribute& attribute) -> bool;
 
     auto removeTextureAttribute(const std::filesystem::path& path, const NIFUtil::TextureAttribute& attribute) -> bool;
@@ -138,4 +151,26 @@ public:
     void setTextureType(const std::filesystem::path& path, const NIFUtil::TextureType& type);
 
     auto getTextureType(const std::filesystem::path& path) -> NIFUtil::TextureType;
+
+    /// @brief Load a DDS file from a loose file or BSA, no GPU needed
+    ///
+    /// @param ddsPath path of DDS file (relative to data)
+    /// @param[out] dds output DDS image
+    /// @return true on success
+    auto getDDS(const std::filesystem::path& ddsPath, DirectX::ScratchImage& dds) -> bool;
+
+    /// @brief Get the metadata of a DDS file, cached after the first read
+    ///
+    /// @param ddsPath path of DDS file (relative to data)
+    /// @param[out] ddsMeta output DDS metadata
+    /// @return true on success
+    auto getDDSMetadata(const std::filesystem::path& ddsPath, DirectX::TexMetadata& ddsMeta) -> bool;
+
+    /// @brief Check if the aspect ratio of two DDS files matches
+    ///
+    /// @param ddsPath1 path of dds file 1
+    /// @param ddsPath2 path of dds file 2
+    /// @return true if both could be read and their aspect ratios match
+    auto checkIfAspectRatioMatches(const std::filesystem::path& ddsPath1, const std::filesystem::path& ddsPath2)
+        -> bool;
 };
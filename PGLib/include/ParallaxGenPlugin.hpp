@@ -7,12 +7,12 @@
 #include <nlohmann/json_fwd.hpp>
 #include <unordered_map>
 #include <vector>
-#include <windows.h>
-
-#include <boost/functional/hash.hpp>
 
 #include "BethesdaGame.hpp"
 #include "NIFUtil.hpp"
+#include "PGLogTransport.hpp"
+#include "PGPluginIndex.hpp"
+#include "PGTXSTIndex.hpp"
 #include "ParallaxGenDirectory.hpp"
 #include "patchers/base/PatcherUtil.hpp"
 
@@ -21,6 +21,7 @@ private:
     static constexpr int LOG_POLL_INTERVAL = 1000;
 
     static std::mutex s_libMutex;
+    static PGLogTransport s_logTransport; /** < Drains managed log messages in bulk, guarded by s_libMutex */
     static void libLogMessageIfExists();
     static void libThrowExceptionIfExists();
     static void libInitialize(const int& gameType, const std::wstring& exePath, const std::wstring& dataPath,
@@ -28,13 +29,14 @@ private:
     static void libPopulateObjs();
     static void libFinalize(const std::filesystem::path& outputPath, const bool& esmify);
 
-    /// @brief get the TXST objects that are used by a shape
-    /// @param[in] nifName filename of the nif
-    /// @param[in] name3D "3D name" - name of the shape
-    /// @param[in] index3D "3D index" - index of the shape in the nif
-    /// @return TXST objects, pairs of (texture set index,alternate textures ids)
-    static auto libGetMatchingTXSTObjs(const std::wstring& nifName, const int& index3D)
-        -> std::vector<std::tuple<int, int, std::wstring, std::string>>;
+    /// @brief get every (NIF, 3D index) -> (texture set, alternate texture) reference of the populated load order
+    static auto libGetTXSTRefs() -> PGPluginIndex;
+
+    static void libSaveRecordIndex(const std::filesystem::path& file);
+
+    /// @brief restore the handles of an earlier PopulateObjs, records are resolved when first used
+    /// @return false if the file is missing or invalid
+    static auto libLoadRecordIndex(const std::filesystem::path& file) -> bool;
 
     /// @brief get the assigned textures of all slots in a texture set
     /// @param[in] txstIndex index of the texture set
@@ -77,44 +79,9 @@ private:
 
     static ParallaxGenDirectory* s_pgd;
 
-    static std::mutex s_processShapeMutex;
-
-    // Custom hash function for std::array<std::string, 9>
-    struct ArrayHash {
-        auto operator()(const std::array<std::wstring, NUM_TEXTURE_SLOTS>& arr) const -> std::size_t
-        {
-            std::size_t hash = 0;
-            for (const auto& str : arr) {
-                // Convert string to lowercase and hash
-                const std::wstring lowerStr = boost::to_lower_copy(str);
-                boost::hash_combine(hash, boost::hash<std::wstring>()(lowerStr));
-            }
-            return hash;
-        }
-    };
-
-    struct ArrayEqual {
-        auto operator()(const std::array<std::wstring, NUM_TEXTURE_SLOTS>& lhs,
-            const std::array<std::wstring, NUM_TEXTURE_SLOTS>& rhs) const -> bool
-        {
-            for (size_t i = 0; i < NUM_TEXTURE_SLOTS; ++i) {
-                if (!boost::iequals(lhs.at(i), rhs.at(i))) {
-                    return false;
-                }
-            }
-            return true;
-        }
-    };
-
-    static std::unordered_map<std::string, unsigned int> s_txstFormIDs;
-    static std::unordered_map<std::string, unsigned int> s_newTXSTFormIDs;
-    static std::unordered_set<unsigned int> s_txstResrvedFormIDs;
-    static std::unordered_set<unsigned int> s_txstUsedFormIDs;
-    static unsigned int s_curTXSTFormID;
-    static std::unordered_map<std::array<std::wstring, NUM_TEXTURE_SLOTS>, std::pair<int, std::string>, ArrayHash,
-        ArrayEqual>
-        s_createdTXSTs;
-    static std::mutex s_createdTXSTMutex;
+    static PGTXSTIndex s_txstIndex; /** < Dedup index of created TXST records and their form IDs */
+    static PGPluginIndex s_pluginIndex; /** < TXST references of every shape, read only after populateObjs */
+    static nlohmann::json s_pluginFingerprint; /** < Load order fingerprint the plugin index is valid for */
 
     // Runner vars
     static std::unordered_map<std::wstring, int>* s_modPriority;
@@ -125,7 +92,13 @@ public:
 
     static void initialize(const BethesdaGame& game, const std::filesystem::path& exePath);
 
-    static void populateObjs();
+    /**
+     * @brief Index the alternate textures of the load order. Uses the cache in cacheDir if the load order is unchanged
+     * since it was written, and writes it otherwise.
+     *
+     * @param cacheDir cache folder, empty to not use a cache
+     */
+    static void populateObjs(const std::filesystem::path& cacheDir = {});
 
     static void loadTXSTCache(const nlohmann::json& txstCache);
     static auto getTXSTCache() -> nlohmann::json;
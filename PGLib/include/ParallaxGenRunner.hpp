@@ -2,6 +2,7 @@
 
 #include <boost/asio.hpp>
 #include <exception>
+#include <functional>
 
 class ParallaxGenRunner {
 private:
@@ -43,7 +44,26 @@ public:
      */
     static void processException(const std::exception& e, const std::string& stacktrace);
 
+    /**
+     * @brief Blocking function that runs func for every index in [0, count). Can be called from inside tasks.
+     *
+     * The calling thread works through the indices itself. Helpers run on a pool of their own, so they start right
+     * away instead of queueing behind runner tasks, and take indices only once one of its workers is free. Nested
+     * calls never start threads of their own or wait on a busy pool. Exceptions are rethrown on the calling thread.
+     *
+     * @param count number of indices
+     * @param func function called with each index
+     * @param multithread if false, run all indices on the calling thread
+     */
+    static void parallelFor(
+        const size_t& count, const std::function<void(size_t)>& func, const bool& multithread = true);
+
 private:
+    /**
+     * @brief Pool the parallelFor helpers run on, separate from the task pools
+     */
+    static auto getHelperPool() -> boost::asio::thread_pool&;
+
     /**
      * @brief Process an exception - prints stack trace and exception message, and throws a main thread exception
      *
@@ -1,12 +1,85 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
 #include <mutex>
+#include <optional>
 #include <string>
-#include <unordered_map>
+#include <thread>
+#include <utility>
 
+/**
+ * @class ParallaxGenTask
+ * @brief Counts completed jobs of one phase and reports progress, throughput and ETA
+ *
+ * completeJob() only increments atomic counters. A single observer thread per task reads them at most every
+ * REPORT_INTERVAL, logs progress on percentage steps and passes a snapshot to the progress callback, if one is set.
+ * The thread that completes the last job writes the final report and summary itself, so they are logged before the
+ * runner returns.
+ */
 class ParallaxGenTask {
 public:
     enum class PGResult : uint8_t { SUCCESS, SUCCESS_WITH_WARNINGS, FAILURE };
+    static constexpr size_t NUM_RESULTS = 3;
+
+    /**
+     * @struct Progress
+     * @brief Snapshot of a task handed to the progress callback
+     */
+    struct Progress {
+        std::string taskName;
+        size_t totalJobs = 0;
+        size_t completedJobs = 0;
+        std::array<size_t, NUM_RESULTS> completedByResult {}; /** < Indexed by PGResult */
+        double jobsPerSecond = 0.0; /** < Over the last RATE_WINDOW */
+        std::optional<std::chrono::seconds> eta; /** < Empty until a rate is known */
+        bool finished = false;
+    };
+
+    /// @brief Called from the observer thread, or from the worker that completes the last job
+    using ProgressCallback = std::function<void(const Progress&)>;
+
+    /**
+     * @class RateWindow
+     * @brief Throughput over a moving time window of (time, completed jobs) samples
+     */
+    class RateWindow {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+    private:
+        std::chrono::milliseconds m_window;
+        std::deque<std::pair<Clock::time_point, size_t>> m_samples;
+
+    public:
+        explicit RateWindow(const std::chrono::milliseconds& window);
+
+        /**
+         * @brief Add a sample and drop samples that fell out of the window, keeping one just outside it
+         *
+         * @param time time of the sample, not before the previous sample
+         * @param completedJobs jobs completed at that time
+         */
+        void addSample(const Clock::time_point& time, const size_t& completedJobs);
+
+        /**
+         * @brief Jobs per second between the oldest and newest sample, 0 if they are less than a millisecond apart
+         */
+        [[nodiscard]] auto getRate() const -> double;
+
+        /**
+         * @brief Time left for remainingJobs at the current rate, empty without a rate
+         */
+        [[nodiscard]] auto getETA(const size_t& remainingJobs) const -> std::optional<std::chrono::seconds>;
+    };
+
+    static constexpr std::chrono::milliseconds REPORT_INTERVAL { 250 };
+    static constexpr std::chrono::milliseconds RATE_WINDOW { 10000 };
 
 private:
     static constexpr int FULL_PERCENTAGE = 100;
@@ -15,26 +88,59 @@ private:
 
     std::string m_taskName;
     size_t m_totalJobs;
-    size_t m_lastPerc = 0;
-    std::mutex m_numJobsCompletedMutex;
 
-    std::unordered_map<PGResult, size_t> m_numJobsCompleted;
+    std::array<std::atomic<size_t>, NUM_RESULTS> m_numJobsCompleted {}; /** < Indexed by PGResult */
+    std::atomic<size_t> m_numJobsCompletedTotal = 0; /** < Lets the worker of the last job know it was last */
+
+    std::mutex m_reportMutex; /** < Taken by the observer each interval and once for the final report */
+    std::condition_variable m_reportCV;
+    bool m_stopObserver = false;
+    bool m_finished = false; /** < Final report was written */
+    size_t m_lastPrintStep = 0;
+    RateWindow m_rateWindow;
+    std::thread m_observer;
 
-    std::unordered_map<PGResult, std::string> m_pgResultStr = { { PGResult::SUCCESS, "COMPLETED" },
-        { PGResult::SUCCESS_WITH_WARNINGS, "COMPLETED WITH WARNINGS" }, { PGResult::FAILURE, "FAILED" } };
+    static inline std::mutex s_progressCallbackMutex;
+    static inline ProgressCallback s_progressCallback;
+
+    static constexpr std::array<const char*, NUM_RESULTS> PG_RESULT_STR
+        = { "COMPLETED", "COMPLETED WITH WARNINGS", "FAILED" };
 
 public:
     ParallaxGenTask(std::string taskName, const size_t& totalJobs, const int& progressPrintModulo = 1);
+    ~ParallaxGenTask();
+    ParallaxGenTask(const ParallaxGenTask& other) = delete;
+    auto operator=(const ParallaxGenTask& other) -> ParallaxGenTask& = delete;
+    ParallaxGenTask(ParallaxGenTask&& other) = delete;
+    auto operator=(ParallaxGenTask&& other) -> ParallaxGenTask& = delete;
 
     void completeJob(const PGResult& result);
     [[nodiscard]] auto isCompleted() -> bool;
 
+    /**
+     * @brief Counts as of now, without rate or ETA
+     */
+    [[nodiscard]] auto getProgress() const -> Progress;
+
+    /**
+     * @brief Set the callback that receives the progress of every task, for UIs. Pass nullptr to remove it.
+     *
+     * @param callback called at most every REPORT_INTERVAL per task and once when a task finishes
+     */
+    static void setProgressCallback(ProgressCallback callback);
+
     static void updatePGResult(
         PGResult& result, const PGResult& currentResult, const PGResult& threshold = PGResult::FAILURE);
 
 private:
-    void initJobStatus();
-    void printJobStatus(bool force = false);
-    void printJobSummary();
-    [[nodiscard]] auto getCompletedJobs() -> size_t;
+    void observerMain();
+
+    /**
+     * @brief Sample the counters, log progress if a print step was reached and call the callback. Needs m_reportMutex.
+     *
+     * @param finished if true, this is the final report
+     */
+    void report(const bool& finished);
+
+    void printJobSummary(const Progress& progress) const;
 };
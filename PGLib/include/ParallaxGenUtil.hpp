@@ -1,7 +1,5 @@
 #pragma once
 
-#include <windows.h>
-
 #include <algorithm>
 #include <filesystem>
 #include <unordered_set>
@@ -1,8 +1,9 @@
 #pragma once
 
-#include <mutex>
-#include <unordered_set>
+#include <string>
+#include <unordered_map>
 
+#include "PGWarningAggregator.hpp"
 #include "ParallaxGenDirectory.hpp"
 
 class ParallaxGenWarnings {
@@ -11,31 +12,7 @@ private:
     static ParallaxGenDirectory* s_pgd; /** Pointer to initialized ParallaxGenDirectory object */
     static const std::unordered_map<std::wstring, int>* s_modPriority; /** Pointer to initialized ModPriority object */
 
-    /**
-     * @brief Struct that stores hash function for pair of wstrings (used for trackers)
-     */
-    struct PairHash {
-        auto operator()(const std::pair<std::wstring, std::wstring>& p) const -> size_t
-        {
-            std::hash<std::wstring> hashWstr;
-            return hashWstr(p.first) ^ (hashWstr(p.second) << 1);
-        }
-    };
-
-    // Trackers for warnings
-    static std::unordered_map<std::wstring, std::unordered_set<std::wstring>>
-        s_mismatchWarnTracker; // matched mod to set of base mods
-    static std::mutex s_mismatchWarnTrackerMutex; /** Mutex for MismatchWarnTracker */
-    static std::unordered_map<std::wstring, std::unordered_set<std::pair<std::wstring, std::wstring>, PairHash>>
-        s_mismatchWarnDebugTracker;
-    static std::mutex s_mismatchWarnDebugTrackerMutex; /** Mutex for MismatchWarnDebugTracker */
-
-    static std::unordered_set<std::pair<std::wstring, std::wstring>, PairHash>
-        s_meshWarnTracker; /** Keeps tabs on WARN mesh mismatch messages to avoid duplicates */
-    static std::mutex s_meshWarnTrackerMutex; /** Mutex for MeshWarnTracker */
-    static std::unordered_set<std::pair<std::wstring, std::wstring>, PairHash>
-        s_meshWarnDebugTracker; /** Keeps tabs on DEBUG mesh mismatch messages to avoid duplicates */
-    static std::mutex s_meshWarnDebugTrackerMutex; /** Mutex for MeshWarnDebugTracker */
+    static PGWarningAggregator s_aggregator; /** Per-thread warning records, merged in printWarnings */
 
 public:
     static void init(ParallaxGenDirectory* pgd, const std::unordered_map<std::wstring, int>* modPriority);
@@ -46,4 +23,7 @@ public:
 
     /// @brief print a summary of the already gathered warnings
     static void printWarnings();
+
+private:
+    [[nodiscard]] static auto getModPriority(const std::wstring& mod) -> int;
 };
@@ -4,8 +4,8 @@
 #include <BasicTypes.hpp>
 #include <Geometry.hpp>
 #include <Nodes.hpp>
-#include <mutex>
 
+#include "PGLightPlacerCollector.hpp"
 #include "patchers/base/PatcherMeshGlobal.hpp"
 #include <Shaders.hpp>
 
@@ -15,8 +15,7 @@
  */
 class PatcherMeshGlobalParticleLightsToLP : public PatcherMeshGlobal {
 private:
-    static nlohmann::json s_lpJsonData; /** < LP JSON data */
-    static std::mutex s_lpJsonDataMutex; /** < Mutex for LP JSON data */
+    static PGLightPlacerCollector s_lpCollector; /** < LP lights found by all threads */
 
     static constexpr int PARTICLE_LIGHT_FLAGS = 4109; /** < Particle light flags */
     static constexpr int WHITE_COLOR = 255; /** < White color */
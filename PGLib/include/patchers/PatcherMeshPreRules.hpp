@@ -0,0 +1,146 @@
+#pragma once
+
+#include <NifFile.hpp>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+#include "NIFUtil.hpp"
+#include "patchers/base/PatcherMeshPre.hpp"
+
+/**
+ * @class PatcherMeshPreRules
+ * @brief Prepatcher that applies declarative field fixes from JSON rules
+ *
+ * Rules are compiled once in loadStatics into flat arrays. applyPatch looks up the shader once per shape and runs every
+ * active rule against it, nothing is allocated per rule.
+ *
+ * Rule format:
+ * @code
+ * {
+ *   "name": "FixMeshLighting",
+ *   "save": true,                         // optional, changes from this rule make the NIF save
+ *   "match": {                            // optional, all given conditions must hold
+ *     "shader_types": [0, 1],             // BSLightingShaderPropertyShaderType values
+ *     "flags1_set": 0, "flags1_unset": 0, // SkyrimShaderPropertyFlags1 masks
+ *     "flags2_set": 0, "flags2_unset": 0, // SkyrimShaderPropertyFlags2 masks
+ *     "slots": { "1": "*_n.dds" }         // case insensitive wildcard per texture slot, * and ?
+ *   },
+ *   "actions": [ { "field": "softlighting", "max": 0.6 } ] // "set", or "min" and/or "max" to clamp
+ * }
+ * @endcode
+ */
+class PatcherMeshPreRules : public PatcherMeshPre {
+private:
+    /**
+     * @enum Field
+     * @brief Shape fields a rule can change
+     */
+    enum class Field : uint8_t {
+        SOFTLIGHTING,
+        RIMLIGHT_POWER,
+        GLOSSINESS,
+        SPECULAR_STRENGTH,
+        ENV_MAP_SCALE,
+        ALPHA,
+        TEXTURE_SLOT_COUNT
+    };
+
+    /**
+     * @struct Action
+     * @brief Compiled field change, set is applied before the clamp
+     */
+    struct Action {
+        Field field = Field::SOFTLIGHTING;
+        bool hasSet = false;
+        float setValue = 0.0F;
+        float minValue = std::numeric_limits<float>::lowest();
+        float maxValue = std::numeric_limits<float>::max();
+    };
+
+    /**
+     * @struct Rule
+     * @brief Compiled rule, actions are s_actions[firstAction, firstAction + numActions)
+     */
+    struct Rule {
+        std::string name;
+        bool triggerSave = true;
+
+        uint32_t shaderTypeMask = 0; /** < Bit per allowed shader type, 0 allows all */
+        uint32_t flags1Set = 0;
+        uint32_t flags1Unset = 0;
+        uint32_t flags2Set = 0;
+        uint32_t flags2Unset = 0;
+        uint16_t slotMask = 0; /** < Bit per slot with a pattern */
+        std::array<std::string, NUM_TEXTURE_SLOTS> slotPatterns; /** < Lowercase wildcard patterns */
+
+        size_t firstAction = 0;
+        size_t numActions = 0;
+    };
+
+    static std::vector<Rule> s_rules; /** < Active rules in evaluation order */
+    static std::vector<Action> s_actions; /** < Actions of all rules */
+
+public:
+    /**
+     * @brief Get the Factory object
+     *
+     * @return PatcherMeshPre::PatcherMeshPreFactory factory object for this patcher
+     */
+    static auto getFactory() -> PatcherMeshPre::PatcherMeshPreFactory;
+
+    /**
+     * @brief Compile the rules that applyPatch runs, invalid rules are logged and skipped
+     *
+     * @param rules JSON array of rules
+     */
+    static void loadStatics(const nlohmann::json& rules);
+
+    /**
+     * @brief Get the number of compiled rules
+     *
+     * @return size_t number of rules loaded by loadStatics
+     */
+    static auto getNumRules() -> size_t;
+
+    /**
+     * @brief Get one of the rules that ship with ParallaxGen ("FixMeshLighting", "FixTextureSlotCount")
+     *
+     * @param name name of the rule
+     * @return nlohmann::json rule, null if there is no rule with this name
+     */
+    static auto getBuiltinRule(const std::string& name) -> nlohmann::json;
+
+    /**
+     * @brief Construct a new PrePatcher Rules patcher
+     *
+     * @param nifPath NIF path to be patched
+     * @param nif NIF object to be patched
+     */
+    PatcherMeshPreRules(std::filesystem::path nifPath, nifly::NifFile* nif);
+
+    /**
+     * @brief Apply all rules to shape. Every rule that changed the shape is recorded in PGDiag under its name.
+     *
+     * @param nifShape Shape to patch
+     * @return true A rule that triggers a save changed the shape
+     * @return false Shape was not changed, or only by rules that don't trigger a save
+     */
+    auto applyPatch(nifly::NiShape& nifShape) -> bool override;
+
+private:
+    static auto compileRule(const nlohmann::json& rule, Rule& compiled, std::vector<Action>& actions) -> bool;
+    static auto getFieldFromStr(const std::string& field, Field& out) -> bool;
+    static auto getFieldStr(const Field& field) -> std::string;
+
+    static auto matchesRule(const Rule& rule, nifly::BSLightingShaderProperty& nifShader,
+        const nifly::BSShaderTextureSet* txstRec) -> bool;
+    static auto matchesWildcard(const std::string& pattern, const std::string& str) -> bool;
+
+    static auto applyAction(
+        const Action& action, nifly::BSLightingShaderProperty& nifShader, nifly::BSShaderTextureSet* txstRec) -> bool;
+};
@@ -2,9 +2,7 @@
 
 #include <NifFile.hpp>
 #include <filesystem>
-#include <shlwapi.h>
 #include <string>
-#include <winnt.h>
 
 #include "NIFUtil.hpp"
 #include "patchers/base/PatcherMeshShader.hpp"
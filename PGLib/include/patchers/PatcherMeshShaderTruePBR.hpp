@@ -222,25 +222,6 @@ private:
 
     // TruePBR Helpers
 
-    /**
-     * @brief Calculate ABS of 2-element vector
-     *
-     * @param v vector to calculate abs of
-     * @return nifly::Vector2 ABS of vector
-     */
-    static auto abs2(nifly::Vector2 v) -> nifly::Vector2;
-
-    /**
-     * @brief Math that calculates auto UV scale for a shape
-     *
-     * @param uvs UVs of shape
-     * @param verts Vertices of shape
-     * @param tris Triangles of shape
-     * @return nifly::Vector2
-     */
-    static auto autoUVScale(const std::vector<nifly::Vector2>* uvs, const std::vector<nifly::Vector3>* verts,
-        std::vector<nifly::Triangle>& tris) -> nifly::Vector2;
-
     /**
      * @brief Checks if a JSON field has a key and that key is true
      *
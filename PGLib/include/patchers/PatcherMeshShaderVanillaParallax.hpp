@@ -12,10 +12,6 @@
  * @brief Patcher for vanilla parallax
  */
 class PatcherMeshShaderVanillaParallax : public PatcherMeshShader {
-private:
-    bool m_hasAttachedHavok
-        = false; /** Stores at the NIF level whether the NIF has attached havok (incompatible with parallax) */
-
 public:
     /**
      * @brief Get the Factory object for parallax patcher
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "ParallaxGenD3D.hpp"
 #include "patchers/base/PatcherTextureGlobal.hpp"
 #include <DirectXTex.h>
 #include <dxgiformat.h>
@@ -2,6 +2,7 @@
 
 #include <filesystem>
 
+#include "ParallaxGenD3D.hpp"
 #include "patchers/base/PatcherTextureHook.hpp"
 
 class PatcherTextureHookFixSSS : PatcherTextureHook {
@@ -1,8 +1,9 @@
 #pragma once
 
-#include "ParallaxGenD3D.hpp"
 #include "ParallaxGenDirectory.hpp"
 
+class ParallaxGenD3D;
+
 /**
  * @class Patcher
  * @brief Base class for all patchers
@@ -40,9 +41,9 @@ public:
      * @brief Load the statics for all patchers
      *
      * @param pgd initialized PGD object
-     * @param pgd3d initialized PGD3D object
+     * @param pgd3d initialized PGD3D object, nullptr when running without a GPU
      */
-    static void loadStatics(ParallaxGenDirectory& pgd, ParallaxGenD3D& pgd3d);
+    static void loadStatics(ParallaxGenDirectory& pgd, ParallaxGenD3D* pgd3d);
 
     /**
      * @brief Construct a new Patcher object
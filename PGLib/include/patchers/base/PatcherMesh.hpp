@@ -1,6 +1,11 @@
 #pragma once
 
 #include <filesystem>
+#include <memory>
+#include <optional>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
 
 #include "NifFile.hpp"
 
@@ -11,10 +16,44 @@
  * @brief Base class for all patchers
  */
 class PatcherMesh : public Patcher {
+public:
+    /**
+     * @class NIFAnalysis
+     * @brief Whole-NIF facts that patchers need, computed on first use and shared by all patchers bound to the NIF
+     */
+    class NIFAnalysis {
+    private:
+        nifly::NifFile* m_nif;
+        std::optional<std::unordered_map<std::type_index, std::vector<nifly::NiObject*>>>
+            m_blocksByType; /** < Blocks of the block tree by their exact type, in tree order */
+
+    public:
+        explicit NIFAnalysis(nifly::NifFile* nif);
+
+        /**
+         * @brief Whether the NIF has a BSBehaviorGraphExtraData block (attached havok animations)
+         */
+        [[nodiscard]] auto hasAttachedHavok() -> bool;
+
+        /**
+         * @brief Blocks in the block tree of exactly the given type, the tree is walked once for all types
+         *
+         * @param type block type, like typeid(nifly::NiBillboardNode)
+         * @return const std::vector<nifly::NiObject*>& blocks in tree order, valid until invalidateBlocks()
+         */
+        [[nodiscard]] auto getBlocks(const std::type_index& type) -> const std::vector<nifly::NiObject*>&;
+
+        /**
+         * @brief Forget the block index, must be called after adding or deleting blocks
+         */
+        void invalidateBlocks();
+    };
+
 private:
     // Instance vars
     std::filesystem::path m_nifPath; /** Stores the path to the NIF file currently being patched */
     nifly::NifFile* m_nif; /** Stores the NIF object itself */
+    std::shared_ptr<NIFAnalysis> m_nifAnalysis; /** Created on first use unless shared through rebind */
 
 protected:
     /**
@@ -31,6 +70,13 @@ protected:
      */
     [[nodiscard]] auto getNIF() const -> nifly::NifFile*;
 
+    /**
+     * @brief Get the analysis of the current NIF (used only within child patchers)
+     *
+     * @return NIFAnalysis& analysis, shared with the other patchers bound to the NIF
+     */
+    [[nodiscard]] auto getNIFAnalysis() -> NIFAnalysis&;
+
 public:
     /**
      * @brief Construct a new Patcher object
@@ -41,4 +87,14 @@ public:
      */
     PatcherMesh(
         std::filesystem::path nifPath, nifly::NifFile* nif, std::string patcherName, const bool& triggerSave = true);
+
+    /**
+     * @brief Point the patcher at another NIF so the object can be reused. Patchers must not keep other per-NIF state.
+     *
+     * @param nifPath Path to NIF being patched
+     * @param nif NIF object
+     * @param nifAnalysis analysis shared with other patchers of the NIF, created on first use if null
+     */
+    void rebind(const std::filesystem::path& nifPath, nifly::NifFile* nif,
+        std::shared_ptr<NIFAnalysis> nifAnalysis = nullptr);
 };
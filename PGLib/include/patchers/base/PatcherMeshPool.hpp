@@ -0,0 +1,87 @@
+#pragma once
+
+#include <NifFile.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "PGThreadBuffers.hpp"
+#include "patchers/base/PatcherUtil.hpp"
+
+/**
+ * @class PatcherMeshPool
+ * @brief Reusable mesh patcher objects
+ *
+ * Building patcher objects from the factories for every NIF repeats allocations and constructor work per mesh. The pool
+ * keeps the object sets of each worker thread and rebinds them to the next NIF instead. Nested NIF processing on one
+ * thread (duplicate NIFs) leases a second set, so a set is never rebound while it is in use.
+ */
+class PatcherMeshPool {
+private:
+    using ObjectSetPtr = std::unique_ptr<PatcherUtil::PatcherMeshObjectSet>;
+
+    PatcherUtil::PatcherMeshSet m_factories;
+    mutable PGThreadBuffers<std::vector<ObjectSetPtr>> m_idleSets; /** < Idle object sets of each worker thread */
+
+public:
+    /**
+     * @class Lease
+     * @brief Object set bound to one NIF, returned to the idle sets of the destroying thread. Must not outlive the pool.
+     */
+    class Lease {
+    private:
+        const PatcherMeshPool* m_pool;
+        uint64_t m_idleSetsID; /** < Sets leased before the factories changed are dropped instead of returned */
+        ObjectSetPtr m_objects;
+
+    public:
+        Lease(const PatcherMeshPool* pool, ObjectSetPtr objects);
+        ~Lease();
+        Lease(const Lease&) = delete;
+        auto operator=(const Lease&) -> Lease& = delete;
+        Lease(Lease&& other) noexcept = default;
+        auto operator=(Lease&& other) noexcept -> Lease& = delete;
+
+        auto operator*() const -> PatcherUtil::PatcherMeshObjectSet&;
+        auto operator->() const -> PatcherUtil::PatcherMeshObjectSet*;
+    };
+
+    /**
+     * @brief Replace the factories, object sets built from the previous factories are dropped
+     *
+     * @param factories patcher factories for the next run
+     */
+    void setFactories(const PatcherUtil::PatcherMeshSet& factories);
+
+    /**
+     * @brief Get an object set of the calling thread bound to a NIF
+     *
+     * @param nifPath path of the NIF
+     * @param nif NIF object, must outlive the lease
+     * @return Lease object set, reused by the next acquire on this thread once the lease is destroyed
+     */
+    auto acquire(const std::filesystem::path& nifPath, nifly::NifFile* nif) const -> Lease;
+
+    /**
+     * @brief Build a new object set from factories, bound to a NIF
+     *
+     * @param factories patcher factories
+     * @param nifPath path of the NIF
+     * @param nif NIF object
+     * @return PatcherUtil::PatcherMeshObjectSet new object set
+     */
+    static auto create(const PatcherUtil::PatcherMeshSet& factories, const std::filesystem::path& nifPath,
+        nifly::NifFile* nif) -> PatcherUtil::PatcherMeshObjectSet;
+
+    /**
+     * @brief Bind every patcher of an object set to a NIF, all share one lazily computed NIF analysis
+     *
+     * @param objects object set to rebind
+     * @param nifPath path of the NIF
+     * @param nif NIF object, null to release the previous NIF
+     */
+    static void rebind(
+        PatcherUtil::PatcherMeshObjectSet& objects, const std::filesystem::path& nifPath, nifly::NifFile* nif);
+};
@@ -11,6 +11,7 @@
 #include "patchers/base/PatcherTextureGlobal.hpp"
 
 #include "NIFUtil.hpp"
+#include "PGConflictGraph.hpp"
 #include "ParallaxGenUtil.hpp"
 
 /**
@@ -82,8 +83,7 @@ public:
     };
 
     struct ConflictModResults {
-        std::unordered_map<std::wstring, std::tuple<std::set<NIFUtil::ShapeShader>, std::unordered_set<std::wstring>>>
-            mods;
+        PGConflictGraph graph;
         std::mutex mutex;
     };
 
@@ -1,14 +1,14 @@
 #include "BethesdaDirectory.hpp"
 
 #include "BethesdaGame.hpp"
+#include "Logger.hpp"
 #include "ModManagerDirectory.hpp"
 #include "PGDiag.hpp"
+#include "PGPlatform.hpp"
 #include "ParallaxGenUtil.hpp"
 
 #include <bsa/tes4.hpp>
 
-#include <spdlog/spdlog.h>
-
 #include <binary_io/any_stream.hpp>
 #include <binary_io/memory_stream.hpp>
 
@@ -20,9 +20,6 @@
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/crc.hpp>
 
-#include <shlwapi.h>
-#include <winnt.h>
-
 #include <algorithm>
 #include <exception>
 #include <filesystem>
@@ -56,7 +53,7 @@ BethesdaDirectory::BethesdaDirectory(
 
     if (this->m_logging) {
         // Log starting message
-        spdlog::info(L"Opening Data Folder \"{}\"", m_dataDir.wstring());
+        Logger::info(L"Opening Data Folder \"{}\"", m_dataDir.wstring());
     }
 }
 
@@ -70,7 +67,7 @@ BethesdaDirectory::BethesdaDirectory(
 {
     if (this->m_logging) {
         // Log starting message
-        spdlog::info(L"Opening Data Folder \"{}\"", m_dataDir.wstring());
+        Logger::info(L"Opening Data Folder \"{}\"", m_dataDir.wstring());
     }
 }
 
@@ -100,14 +97,8 @@ auto BethesdaDirectory::getExtensionBlocklist() -> vector<wstring>
 
 auto BethesdaDirectory::checkGlob(const wstring& str, const vector<wstring>& globList) -> bool
 {
-    // convert wstring vector to LPCWSTR vector
-    vector<LPCWSTR> globListCstr = convertWStringToLPCWSTRVector(globList);
-
-    // convert wstring to LPCWSTR
-    LPCWSTR strCstr = str.c_str();
-
     // check if string matches any glob
-    return std::ranges::any_of(globListCstr, [&](LPCWSTR glob) { return PathMatchSpecW(strCstr, glob); });
+    return std::ranges::any_of(globList, [&](const wstring& glob) { return PGPlatform::globMatch(str, glob); });
 }
 
 void BethesdaDirectory::populateFileMap(bool includeBSAs)
@@ -117,6 +108,7 @@ void BethesdaDirectory::populateFileMap(bool includeBSAs)
     // clear map before populating
     {
         const lock_guard<mutex> lock(m_fileMapMutex);
+        m_fileFilter.clear();
         m_fileMap.clear();
     }
 
@@ -127,6 +119,17 @@ void BethesdaDirectory::populateFileMap(bool includeBSAs)
 
     // add loose files to file map
     addLooseFilesToMap();
+
+    // freeze the existence filter, files added later are only added to its bloom filter
+    {
+        const lock_guard<mutex> lock(m_fileMapMutex);
+        vector<const filesystem::path*> keys;
+        keys.reserve(m_fileMap.size());
+        for (const auto& [key, file] : m_fileMap) {
+            keys.push_back(&key);
+        }
+        m_fileFilter.build(keys);
+    }
 }
 
 auto BethesdaDirectory::getFileMap() const -> const map<filesystem::path, BethesdaDirectory::BethesdaFile>&
@@ -135,34 +138,37 @@ auto BethesdaDirectory::getFileMap() const -> const map<filesystem::path, Bethes
 }
 
 auto BethesdaDirectory::getFile(const filesystem::path& relPath, const bool& cacheFile) -> vector<std::byte>
+{
+    const auto fileBytes = getFileShared(relPath, cacheFile);
+    return *fileBytes;
+}
+
+auto BethesdaDirectory::getFileShared(const filesystem::path& relPath, const bool& cacheFile) -> PGFileCache::Buffer
 {
     // find bsa/loose file to open
     const BethesdaFile file = getFileFromMap(relPath);
     if (file.path.empty()) {
         if (m_logging) {
-            spdlog::error(L"File not found in file map: {}", relPath.wstring());
+            Logger::error(L"File not found in file map: {}", relPath.wstring());
         }
         throw runtime_error("File not found in file map");
     }
 
     auto lowerRelPath = getAsciiPathLower(relPath);
-    if (!cacheFile) {
-        const lock_guard<mutex> lock(m_fileCacheMutex);
-
-        if (m_fileCache.find(lowerRelPath) != m_fileCache.end()) {
-            if (m_logging) {
-                spdlog::trace(L"Reading file from cache: {}", relPath.wstring());
-            }
-
-            return m_fileCache[lowerRelPath];
+    auto cachedBytes = m_fileCache.get(lowerRelPath);
+    if (cachedBytes != nullptr) {
+        if (m_logging) {
+            Logger::trace(L"Reading file from cache: {}", relPath.wstring());
         }
+
+        return cachedBytes;
     }
 
     vector<std::byte> outFileBytes;
     const shared_ptr<BSAFile> bsaStruct = file.bsaFile;
     if (bsaStruct == nullptr) {
         if (m_logging) {
-            spdlog::trace(L"Reading loose file from BethesdaDirectory: {}", relPath.wstring());
+            Logger::trace(L"Reading loose file from BethesdaDirectory: {}", relPath.wstring());
         }
 
         filesystem::path filePath;
@@ -177,7 +183,7 @@ auto BethesdaDirectory::getFile(const filesystem::path& relPath, const bool& cac
         const filesystem::path bsaPath = bsaStruct->path;
 
         if (m_logging) {
-            spdlog::trace(L"Reading BSA file from {}: {}", bsaPath.wstring(), relPath.wstring());
+            Logger::trace(L"Reading BSA file from {}: {}", bsaPath.wstring(), relPath.wstring());
         }
 
         // this is a bsa archive file
@@ -195,7 +201,7 @@ auto BethesdaDirectory::getFile(const filesystem::path& relPath, const bool& cac
                 file->write(aos, bsaVersion);
             } catch (const std::exception& e) {
                 if (m_logging) {
-                    spdlog::error(L"Failed to read file {}: {}", relPath.wstring(), asciitoUTF16(e.what()));
+                    Logger::error(L"Failed to read file {}: {}", relPath.wstring(), asciitoUTF16(e.what()));
                 }
             }
 
@@ -206,17 +212,27 @@ auto BethesdaDirectory::getFile(const filesystem::path& relPath, const bool& cac
         }
     }
 
-    if (outFileBytes.empty()) {
-        return {};
+    auto outBuffer = make_shared<const vector<std::byte>>(std::move(outFileBytes));
+    if (outBuffer->empty()) {
+        return outBuffer;
     }
 
-    // cache file if flag is set
+    // cache file if flag is set, the cache may decline if the budget does not allow it
     if (cacheFile) {
-        const lock_guard<mutex> lock(m_fileCacheMutex);
-        m_fileCache[lowerRelPath] = outFileBytes;
+        m_fileCache.put(lowerRelPath, outBuffer);
+    }
+
+    return outBuffer;
+}
+
+auto BethesdaDirectory::getUnchargedBytes(const filesystem::path& relPath, const PGFileCache::Buffer& buffer)
+    -> size_t
+{
+    if (buffer == nullptr || m_fileCache.holds(getAsciiPathLower(relPath), buffer)) {
+        return 0;
     }
 
-    return outFileBytes;
+    return buffer->size();
 }
 
 auto BethesdaDirectory::getMod(const filesystem::path& relPath) -> wstring
@@ -234,17 +250,18 @@ void BethesdaDirectory::addGeneratedFile(const filesystem::path& relPath, const
     updateFileMap(relPath, nullptr, mod, true);
 }
 
-auto BethesdaDirectory::clearCache() -> void
-{
-    const lock_guard<mutex> lock(m_fileCacheMutex);
-    m_fileCache.clear();
-}
+auto BethesdaDirectory::clearCache() -> void { m_fileCache.clear(); }
 
 auto BethesdaDirectory::isLooseFile(const filesystem::path& relPath) -> bool
 {
     if (m_fileMap.empty()) {
         throw runtime_error("File map was not populated");
     }
+
+    if (m_fileFilter.query(relPath) == PGPathFilter::Result::ABSENT) {
+        return false;
+    }
+
     const BethesdaFile file = getFileFromMap(relPath);
     return !file.path.empty() && file.bsaFile == nullptr;
 }
@@ -255,6 +272,10 @@ auto BethesdaDirectory::isBSAFile(const filesystem::path& relPath) -> bool
         throw runtime_error("File map was not populated");
     }
 
+    if (m_fileFilter.query(relPath) == PGPathFilter::Result::ABSENT) {
+        return false;
+    }
+
     const BethesdaFile file = getFileFromMap(relPath);
     return !file.path.empty() && file.bsaFile != nullptr;
 }
@@ -265,6 +286,16 @@ auto BethesdaDirectory::isFile(const filesystem::path& relPath) -> bool
         throw runtime_error("File map was not populated");
     }
 
+    // most probes for candidate textures miss, the filter answers those and hits without locking the map
+    switch (m_fileFilter.query(relPath)) {
+    case PGPathFilter::Result::ABSENT:
+        return false;
+    case PGPathFilter::Result::PRESENT:
+        return true;
+    default:
+        break;
+    }
+
     const BethesdaFile file = getFileFromMap(relPath);
     return !file.path.empty();
 }
@@ -275,6 +306,10 @@ auto BethesdaDirectory::isGenerated(const filesystem::path& relPath) -> bool
         throw runtime_error("File map was not populated");
     }
 
+    if (m_fileFilter.query(relPath) == PGPathFilter::Result::ABSENT) {
+        return false;
+    }
+
     const BethesdaFile file = getFileFromMap(relPath);
     return !file.path.empty() && file.generated;
 }
@@ -320,7 +355,7 @@ void BethesdaDirectory::addBSAFilesToMap()
     }
 
     if (m_logging) {
-        spdlog::info("Adding BSA files to file map.");
+        Logger::info("Adding BSA files to file map.");
     }
 
     // Get list of BSA files
@@ -333,7 +368,7 @@ void BethesdaDirectory::addBSAFilesToMap()
             addBSAToFileMap(bsaName);
         } catch (const std::exception& e) {
             if (m_logging) {
-                spdlog::error(L"Failed to add BSA file {} to map (Skipping): {}", bsaName, asciitoUTF16(e.what()));
+                Logger::error(L"Failed to add BSA file {} to map (Skipping): {}", bsaName, asciitoUTF16(e.what()));
             }
             continue;
         }
@@ -343,7 +378,7 @@ void BethesdaDirectory::addBSAFilesToMap()
 void BethesdaDirectory::addLooseFilesToMap()
 {
     if (m_logging) {
-        spdlog::info("Adding loose files to file map.");
+        Logger::info("Adding loose files to file map.");
     }
 
     for (const auto& entry :
@@ -359,7 +394,7 @@ void BethesdaDirectory::addLooseFilesToMap()
                 }
 
                 if (m_logging) {
-                    spdlog::trace(L"Adding loose file to map: {}", relativePath.wstring());
+                    Logger::trace(L"Adding loose file to map: {}", relativePath.wstring());
                 }
 
                 wstring curMod;
@@ -370,7 +405,7 @@ void BethesdaDirectory::addLooseFilesToMap()
             }
         } catch (const std::exception& e) {
             if (m_logging) {
-                spdlog::error(L"Failed to load file from iterator (Skipping): {}", asciitoUTF16(e.what()));
+                Logger::error(L"Failed to load file from iterator (Skipping): {}", asciitoUTF16(e.what()));
             }
             continue;
         }
@@ -381,7 +416,7 @@ void BethesdaDirectory::addBSAToFileMap(const wstring& bsaName)
 {
     if (m_logging) {
         // log message
-        spdlog::debug(L"Adding files from {} to file map.", bsaName);
+        Logger::debug(L"Adding files from {} to file map.", bsaName);
     }
 
     bsa::tes4::archive bsaObj;
@@ -391,7 +426,7 @@ void BethesdaDirectory::addBSAToFileMap(const wstring& bsaName)
     // data folder)
     if (!filesystem::exists(bsaPath)) {
         if (m_logging) {
-            spdlog::warn(L"Skipping BSA {} because it doesn't exist", bsaPath.wstring());
+            Logger::warn(L"Skipping BSA {} because it doesn't exist", bsaPath.wstring());
         }
         return;
     }
@@ -413,7 +448,7 @@ void BethesdaDirectory::addBSAToFileMap(const wstring& bsaName)
 
                 if (!containsOnlyAscii(string(fileEntry.first.name()))
                     || !containsOnlyAscii(string(entry.first.name()))) {
-                    spdlog::warn(L"File {}\\{} in BSA {} contains non-ascii characters which is not handled correctly "
+                    Logger::warn(L"File {}\\{} in BSA {} contains non-ascii characters which is not handled correctly "
                                  L"by Skyrim - skipping",
                         windows1252toUTF16(string(fileEntry.first.name())),
                         windows1252toUTF16(string(entry.first.name())), bsaName);
@@ -434,7 +469,7 @@ void BethesdaDirectory::addBSAToFileMap(const wstring& bsaName)
                 }
 
                 if (m_logging) {
-                    spdlog::trace(L"Adding file from BSA {} to file map: {}", bsaName, curPath.wstring());
+                    Logger::trace(L"Adding file from BSA {} to file map: {}", bsaName, curPath.wstring());
                 }
 
                 // add to filemap
@@ -446,7 +481,7 @@ void BethesdaDirectory::addBSAToFileMap(const wstring& bsaName)
             }
         } catch (const std::exception& e) {
             if (m_logging) {
-                spdlog::error(L"Failed to get file pointer from BSA, skipping {}: {}", bsaName, asciitoUTF16(e.what()));
+                Logger::error(L"Failed to get file pointer from BSA, skipping {}: {}", bsaName, asciitoUTF16(e.what()));
             }
             continue;
         }
@@ -474,11 +509,11 @@ auto BethesdaDirectory::getBSALoadOrder() const -> vector<wstring>
     if (m_logging) {
         // log output
         wstring bsaListStr = boost::algorithm::join(outBSAOrder, ",");
-        spdlog::trace(L"BSA Load Order: {}", bsaListStr);
+        Logger::trace(L"BSA Load Order: {}", bsaListStr);
 
         for (const auto& bsa : allBSAFiles) {
             if (!isInVector(outBSAOrder, bsa)) {
-                spdlog::warn(L"BSA file {} not loaded by any active plugin or INI.", bsa);
+                Logger::warn(L"BSA file {} not loaded by any active plugin or INI.", bsa);
             }
         }
     }
@@ -489,7 +524,7 @@ auto BethesdaDirectory::getBSALoadOrder() const -> vector<wstring>
 auto BethesdaDirectory::getAsciiPathLower(const filesystem::path& path) -> filesystem::path
 {
     if (!isPathAscii(path)) {
-        spdlog::debug(
+        Logger::debug(
             L"Trying to convert unicode path {} to lower case but only ASCII characters are converted", path.wstring());
     }
     return { boost::to_lower_copy(path.wstring(), std::locale::classic()) };
@@ -506,7 +541,7 @@ auto BethesdaDirectory::getBSAFilesFromINIs() const -> vector<wstring>
     vector<wstring> bsaFiles;
 
     if (m_logging) {
-        spdlog::debug("Reading manually loaded BSAs from INI files.");
+        Logger::debug("Reading manually loaded BSAs from INI files.");
     }
 
     // find ini paths
@@ -531,7 +566,7 @@ auto BethesdaDirectory::getBSAFilesFromINIs() const -> vector<wstring>
             wstring curVal = readINIValue(iniPath, L"Archive", asciitoUTF16(field), m_logging, firstINIRead);
 
             if (m_logging) {
-                spdlog::trace(
+                Logger::trace(
                     L"Found ini key pair from INI {}: {}: {}", iniPath.wstring(), asciitoUTF16(field), curVal);
             }
 
@@ -549,7 +584,7 @@ auto BethesdaDirectory::getBSAFilesFromINIs() const -> vector<wstring>
         }
 
         if (m_logging) {
-            spdlog::trace(L"Found BSA files from INI field {}: {}", asciitoUTF16(field), iniVal);
+            Logger::trace(L"Found BSA files from INI field {}: {}", asciitoUTF16(field), iniVal);
         }
 
         // split into components
@@ -570,7 +605,7 @@ auto BethesdaDirectory::getBSAFilesFromINIs() const -> vector<wstring>
 auto BethesdaDirectory::getBSAFilesInDirectory() const -> vector<wstring>
 {
     if (m_logging) {
-        spdlog::debug("Finding existing BSA files in data directory.");
+        Logger::debug("Finding existing BSA files in data directory.");
     }
 
     vector<wstring> bsaFiles;
@@ -595,7 +630,7 @@ auto BethesdaDirectory::findBSAFilesFromPluginName(
     const vector<wstring>& bsaFileList, const wstring& pluginPrefix) const -> vector<wstring>
 {
     if (m_logging) {
-        spdlog::trace(L"Finding BSA files that correspond to plugin {}", pluginPrefix);
+        Logger::trace(L"Finding BSA files that correspond to plugin {}", pluginPrefix);
     }
 
     vector<wstring> bsaFilesFound;
@@ -626,7 +661,7 @@ auto BethesdaDirectory::findBSAFilesFromPluginName(
             }
 
             if (m_logging) {
-                spdlog::trace(L"Found BSA file that corresponds to plugin {}: {}", pluginPrefix, bsa);
+                Logger::trace(L"Found BSA file that corresponds to plugin {}: {}", pluginPrefix, bsa);
             }
 
             bsaFilesFound.push_back(bsa);
@@ -675,6 +710,7 @@ void BethesdaDirectory::updateFileMap(const filesystem::path& filePath, shared_p
         = { .path = filePath, .bsaFile = std::move(bsaFile), .mod = mod, .generated = generated };
 
     m_fileMap[lowerPath] = newBFile;
+    m_fileFilter.add(lowerPath);
 
     PGDiag::insert(lowerPath.wstring(), newBFile.getDiagJSON());
 }
@@ -707,39 +743,12 @@ auto BethesdaDirectory::checkIfAnyComponentIs(const filesystem::path& path, cons
     return false;
 }
 
-auto BethesdaDirectory::convertWStringToLPCWSTRVector(const vector<wstring>& original) -> vector<LPCWSTR>
-{
-    vector<LPCWSTR> output(original.size());
-    for (size_t i = 0; i < original.size(); i++) {
-        output[i] = original[i].c_str();
-    }
-
-    return output;
-}
-
-auto BethesdaDirectory::checkGlob(const LPCWSTR& str, LPCWSTR& winningGlob, const vector<LPCWSTR>& globList) -> bool
-{
-    if (!boost::equals(winningGlob, L"") && (PathMatchSpecW(str, winningGlob) != 0)) {
-        // no winning glob, check all globs
-        return true;
-    }
-
-    for (const auto& glob : globList) {
-        if (glob != winningGlob && (PathMatchSpecW(str, glob) != 0)) {
-            winningGlob = glob;
-            return true;
-        }
-    }
-
-    return false;
-}
-
 auto BethesdaDirectory::readINIValue(const filesystem::path& iniPath, const wstring& section, const wstring& key,
     const bool& logging, const bool& firstINIRead) -> wstring
 {
     if (!filesystem::exists(iniPath)) {
         if (logging && firstINIRead) {
-            spdlog::warn(L"INI file does not exist (ignoring): {}", iniPath.wstring());
+            Logger::warn(L"INI file does not exist (ignoring): {}", iniPath.wstring());
         }
         return L"";
     }
@@ -747,7 +756,7 @@ auto BethesdaDirectory::readINIValue(const filesystem::path& iniPath, const wstr
     ifstream f(iniPath);
     if (!f.is_open()) {
         if (logging && firstINIRead) {
-            spdlog::warn(L"Unable to open INI (ignoring): {}", iniPath.wstring());
+            Logger::warn(L"Unable to open INI (ignoring): {}", iniPath.wstring());
         }
         return L"";
     }
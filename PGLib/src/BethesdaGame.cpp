@@ -1,14 +1,8 @@
 #include "BethesdaGame.hpp"
+#include "Logger.hpp"
+#include "PGPlatform.hpp"
 #include "ParallaxGenUtil.hpp"
 
-#include <spdlog/spdlog.h>
-
-#include <guiddef.h>
-#include <shlobj.h>
-
-#include <objbase.h>
-#include <windows.h>
-
 #include <algorithm>
 #include <filesystem>
 #include <fstream>
@@ -39,9 +33,8 @@ BethesdaGame::BethesdaGame(GameType gameType, const bool& logging, const filesys
     if (this->m_gamePath.empty()) {
         // If the game path is still empty, throw an exception
         if (this->m_logging) {
-            spdlog::critical("Unable to locate game data path. Please specify the game data path "
+            Logger::critical("Unable to locate game data path. Please specify the game data path "
                              "manually using the -d argument.");
-            exit(1);
         } else {
             throw runtime_error("Game path not found");
         }
@@ -51,8 +44,7 @@ BethesdaGame::BethesdaGame(GameType gameType, const bool& logging, const filesys
     if (!filesystem::exists(this->m_gamePath)) {
         // If the game path does not exist, throw an exception
         if (this->m_logging) {
-            spdlog::critical(L"Game path does not exist: {}", this->m_gamePath.wstring());
-            exit(1);
+            Logger::critical(L"Game path does not exist: {}", this->m_gamePath.wstring());
         } else {
             throw runtime_error("Game path does not exist");
         }
@@ -63,9 +55,8 @@ BethesdaGame::BethesdaGame(GameType gameType, const bool& logging, const filesys
     if (!isGamePathValid(this->m_gamePath, gameType)) {
         // If the game path does not contain Skyrim.esm, throw an exception
         if (this->m_logging) {
-            spdlog::critical(
+            Logger::critical(
                 L"Game data location is invalid: {} does not contain Skyrim.esm", this->m_gameDataPath.wstring());
-            exit(1);
         } else {
             throw runtime_error("Game data path does not contain Skyrim.esm");
         }
@@ -271,20 +262,11 @@ auto BethesdaGame::findGamePathFromSteam(const GameType& type) -> filesystem::pa
     // Find the game path from the registry
     // If the game is not found, return an empty string
 
-    HKEY baseHKey
-        = (type == GameType::ENDERAL || type == GameType::ENDERAL_SE) ? HKEY_CURRENT_USER : HKEY_LOCAL_MACHINE;
-    const string regPath = getGameRegistryPath(type);
-
-    std::vector<char> data(REG_BUFFER_SIZE, '\0');
-    DWORD dataSize = REG_BUFFER_SIZE;
+    const auto registryRoot = (type == GameType::ENDERAL || type == GameType::ENDERAL_SE)
+        ? PGPlatform::RegistryRoot::CURRENT_USER
+        : PGPlatform::RegistryRoot::LOCAL_MACHINE;
 
-    const LONG result
-        = RegGetValueA(baseHKey, regPath.c_str(), "Installed Path", RRF_RT_REG_SZ, nullptr, data.data(), &dataSize);
-    if (result == ERROR_SUCCESS) {
-        return { data.data() };
-    }
-
-    return {};
+    return PGPlatform::getRegistryString(registryRoot, getGameRegistryPath(type), "Installed Path");
 }
 
 auto BethesdaGame::getINIPaths() const -> BethesdaGame::ININame
@@ -360,8 +342,7 @@ auto BethesdaGame::getActivePlugins(const bool& trimExtension, const bool& lower
     ifstream pluginsFileHandle(pluginsFile, 1);
     if (!pluginsFileHandle.is_open()) {
         if (m_logging) {
-            spdlog::critical("Unable to open plugins.txt");
-            exit(1);
+            Logger::critical("Unable to open plugins.txt");
         } else {
             throw runtime_error("Unable to open plugins.txt");
         }
@@ -408,7 +389,7 @@ auto BethesdaGame::getActivePlugins(const bool& trimExtension, const bool& lower
 
     if (m_logging) {
         wstring loadOrderStr = boost::algorithm::join(outputLO, L",");
-        spdlog::debug(L"Active Plugin Load Order: {}", loadOrderStr);
+        Logger::debug(L"Active Plugin Load Order: {}", loadOrderStr);
     }
 
     return outputLO;
@@ -416,7 +397,7 @@ auto BethesdaGame::getActivePlugins(const bool& trimExtension, const bool& lower
 
 auto BethesdaGame::getGameDocumentSystemPath() const -> filesystem::path
 {
-    filesystem::path docPath = getSystemPath(FOLDERID_Documents);
+    filesystem::path docPath = PGPlatform::getKnownFolder(PGPlatform::KnownFolder::DOCUMENTS);
     if (docPath.empty()) {
         return {};
     }
@@ -427,7 +408,7 @@ auto BethesdaGame::getGameDocumentSystemPath() const -> filesystem::path
 
 auto BethesdaGame::getGameAppdataSystemPath() const -> filesystem::path
 {
-    filesystem::path appDataPath = getSystemPath(FOLDERID_LocalAppData);
+    filesystem::path appDataPath = PGPlatform::getKnownFolder(PGPlatform::KnownFolder::LOCAL_APPDATA);
     if (appDataPath.empty()) {
         return {};
     }
@@ -436,21 +417,6 @@ auto BethesdaGame::getGameAppdataSystemPath() const -> filesystem::path
     return appDataPath;
 }
 
-auto BethesdaGame::getSystemPath(const GUID& folderID) -> filesystem::path
-{
-    PWSTR path = nullptr;
-    const HRESULT result = SHGetKnownFolderPath(folderID, 0, nullptr, &path);
-    if (SUCCEEDED(result)) {
-        wstring outPath(path);
-        CoTaskMemFree(path); // Free the memory allocated for the path
-
-        return outPath;
-    }
-
-    // Handle error
-    return {};
-}
-
 auto BethesdaGame::getGameTypes() -> vector<GameType>
 {
     const static auto gameTypes = vector<GameType> { GameType::SKYRIM_SE, GameType::SKYRIM_GOG, GameType::SKYRIM,
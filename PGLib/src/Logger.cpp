@@ -2,10 +2,137 @@
 
 #include <spdlog/spdlog.h>
 
+#include "PGRingBuffer.hpp"
 #include "ParallaxGenUtil.hpp"
 
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
+
 using namespace std;
 
+namespace {
+/**
+ * @struct LogRecord
+ * @brief Formatted message waiting to be written by the log thread
+ */
+struct LogRecord {
+    spdlog::level::level_enum level = spdlog::level::off;
+    std::wstring wideMessage;
+    std::string message;
+    bool isWide = false;
+    bool dedup = false;
+};
+
+constexpr size_t LOG_QUEUE_CAPACITY = 8192;
+
+PGRingBuffer<LogRecord> s_logQueue(LOG_QUEUE_CAPACITY); // NOLINT(cert-err58-cpp)
+std::atomic<bool> s_asyncEnabled = false;
+std::atomic<bool> s_asyncStopRequested = false;
+std::atomic<bool> s_asyncRunning = false;
+std::atomic<uint32_t> s_logSignal = 0;
+std::atomic<uint64_t> s_submittedRecords = 0;
+std::atomic<uint64_t> s_writtenRecords = 0;
+std::atomic<uint32_t> s_activeProducers = 0;
+
+// Guarded by s_writeMutex, which is uncontended while the log thread is the only writer. Full messages are kept so
+// that two different messages with the same hash are never mistaken for a duplicate.
+std::unordered_set<std::string> s_loggedMessages;
+std::mutex s_writeMutex;
+
+void writeRecord(const LogRecord& record)
+{
+    // compare and write as UTF-8 so narrow and wide calls share one set
+    const std::string wideMessageUTF8 = record.isWide ? ParallaxGenUtil::utf16toUTF8(record.wideMessage) : "";
+    const std::string& message = record.isWide ? wideMessageUTF8 : record.message;
+
+    if (record.dedup && !s_loggedMessages.insert(message).second) {
+        // don't log anything if already logged
+        return;
+    }
+
+    spdlog::default_logger_raw()->log(spdlog::source_loc {}, record.level, spdlog::string_view_t(message));
+}
+
+/// @brief Block until every record submitted so far has been written, or the log thread is gone
+void waitForWritten()
+{
+    const auto target = s_submittedRecords.load();
+    auto written = s_writtenRecords.load(std::memory_order_acquire);
+    while (written < target && s_asyncRunning.load()) {
+        s_writtenRecords.wait(written);
+        written = s_writtenRecords.load(std::memory_order_acquire);
+    }
+}
+
+void enqueueRecord(LogRecord& record)
+{
+    // stopAsync waits for every producer that saw async enabled, so a record can never be pushed after the drain
+    s_activeProducers.fetch_add(1);
+    if (!s_asyncEnabled.load()) {
+        s_activeProducers.fetch_sub(1);
+        s_activeProducers.notify_all();
+
+        // while stopping, earlier records of this thread may still be queued and must be written first
+        waitForWritten();
+
+        const lock_guard<mutex> lock(s_writeMutex);
+        writeRecord(record);
+        return;
+    }
+
+    s_submittedRecords.fetch_add(1, std::memory_order_relaxed);
+
+    // Spin instead of falling back to a synchronous write, which would reorder this thread's messages
+    while (!s_logQueue.tryPush(record)) {
+        std::this_thread::yield();
+    }
+
+    s_logSignal.fetch_add(1, std::memory_order_release);
+    s_logSignal.notify_one();
+
+    s_activeProducers.fetch_sub(1);
+    s_activeProducers.notify_all();
+}
+
+void logThreadMain()
+{
+    LogRecord record;
+    while (true) {
+        const auto seenSignal = s_logSignal.load(std::memory_order_acquire);
+
+        bool wroteAny = false;
+        while (s_logQueue.tryPop(record)) {
+            {
+                const lock_guard<mutex> lock(s_writeMutex);
+                writeRecord(record);
+            }
+
+            s_writtenRecords.fetch_add(1, std::memory_order_release);
+            wroteAny = true;
+        }
+
+        if (wroteAny) {
+            s_writtenRecords.notify_all();
+            continue;
+        }
+
+        if (s_asyncStopRequested.load(std::memory_order_acquire)
+            && s_writtenRecords.load() >= s_submittedRecords.load()) {
+            break;
+        }
+
+        s_logSignal.wait(seenSignal, std::memory_order_acquire);
+    }
+
+    s_asyncRunning.store(false);
+    s_asyncRunning.notify_all();
+}
+} // namespace
+
 // Static thread-local variable
 thread_local vector<wstring> Logger::s_prefixStack;
 
@@ -21,6 +148,68 @@ auto Logger::buildPrefixWString() -> wstring
 
 auto Logger::buildPrefixString() -> string { return ParallaxGenUtil::utf16toUTF8(buildPrefixWString()); }
 
+void Logger::submit(const spdlog::level::level_enum& level, wstring message, const bool& dedup)
+{
+    LogRecord record { .level = level, .wideMessage = std::move(message), .isWide = true, .dedup = dedup };
+    enqueueRecord(record);
+}
+
+void Logger::submit(const spdlog::level::level_enum& level, string message, const bool& dedup)
+{
+    LogRecord record { .level = level, .message = std::move(message), .isWide = false, .dedup = dedup };
+    enqueueRecord(record);
+}
+
+void Logger::startAsync()
+{
+    if (s_asyncRunning.exchange(true)) {
+        // already running
+        return;
+    }
+
+    s_asyncStopRequested.store(false);
+
+    // The thread is detached so a missing stopAsync() never terminates the process from a std::thread destructor
+    thread(logThreadMain).detach();
+    s_asyncEnabled.store(true, std::memory_order_release);
+}
+
+void Logger::stopAsync()
+{
+    // stop accepting records, new ones are written synchronously from here on
+    if (!s_asyncEnabled.exchange(false)) {
+        return;
+    }
+
+    // wait for producers that were already pushing
+    auto activeProducers = s_activeProducers.load();
+    while (activeProducers > 0) {
+        s_activeProducers.wait(activeProducers);
+        activeProducers = s_activeProducers.load();
+    }
+
+    // drain what is queued, then let the log thread exit
+    flush();
+
+    s_asyncStopRequested.store(true);
+    s_logSignal.fetch_add(1, std::memory_order_release);
+    s_logSignal.notify_one();
+
+    // wait for log thread to exit
+    while (s_asyncRunning.load()) {
+        s_asyncRunning.wait(true);
+    }
+}
+
+void Logger::flush()
+{
+    waitForWritten();
+
+    if (auto* const logger = spdlog::default_logger_raw(); logger != nullptr) {
+        logger->flush();
+    }
+}
+
 // ScopedPrefix class implementation
 Logger::Prefix::Prefix(const wstring& prefix)
 {
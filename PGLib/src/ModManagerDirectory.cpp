@@ -8,8 +8,7 @@
 
 #include <nlohmann/json.hpp>
 
-#include <spdlog/spdlog.h>
-
+#include "Logger.hpp"
 #include "ParallaxGenUtil.hpp"
 
 using namespace std;
@@ -37,7 +36,7 @@ auto ModManagerDirectory::getMod(const filesystem::path& relPath) const -> wstri
 void ModManagerDirectory::populateModFileMapVortex(const filesystem::path& deploymentDir)
 {
     // required file is vortex.deployment.json in the data folder
-    spdlog::info("Populating mods from Vortex");
+    Logger::info("Populating mods from Vortex");
 
     const auto deploymentFile = deploymentDir / "vortex.deployment.json";
 
@@ -68,10 +67,10 @@ void ModManagerDirectory::populateModFileMapVortex(const filesystem::path& deplo
         m_allMods.insert(modName);
 
         // Update file map
-        spdlog::trace(L"ModManagerDirectory | Adding Files to Map : {} -> {}", relPath.wstring(), modName);
+        Logger::trace(L"ModManagerDirectory | Adding Files to Map : {} -> {}", relPath.wstring(), modName);
 
         if (!ParallaxGenUtil::containsOnlyAscii(relPath.wstring())) {
-            spdlog::debug(L"Path {} from {} contains non-ASCII characters", relPath.wstring(), deploymentDir.wstring());
+            Logger::debug(L"Path {} from {} contains non-ASCII characters", relPath.wstring(), deploymentDir.wstring());
         }
 
         m_modFileMap[ParallaxGenUtil::toLowerASCII(relPath.wstring())] = modName;
@@ -83,7 +82,7 @@ void ModManagerDirectory::populateModFileMapMO2(
 {
     // required file is modlist.txt in the profile folder
 
-    spdlog::info("Populating mods from Mod Organizer 2");
+    Logger::info("Populating mods from Mod Organizer 2");
 
     // First read modorganizer.ini in the instance folder to get the profiles and mods folders
     const filesystem::path mo2IniFile = instanceDir / L"modorganizer.ini";
@@ -136,15 +135,14 @@ void ModManagerDirectory::populateModFileMapMO2(
 
         // Check if mod folder exists
         if (!filesystem::exists(curModDir)) {
-            spdlog::warn(L"Mod directory from modlist.txt does not exist: {}", curModDir.wstring());
+            Logger::warn(L"Mod directory from modlist.txt does not exist: {}", curModDir.wstring());
             continue;
         }
 
         // check if mod dir is output dir
         if (filesystem::equivalent(curModDir, outputDir)) {
-            spdlog::critical(
+            Logger::critical(
                 L"If outputting to MO2 you must disable the mod {} first to prevent issues with MO2 VFS", mod);
-            exit(1);
         }
 
         foundOneMod = true;
@@ -165,10 +163,10 @@ void ModManagerDirectory::populateModFileMapMO2(
                 }
 
                 auto relPath = filesystem::relative(file, curModDir);
-                spdlog::trace(L"ModManagerDirectory | Adding Files to Map : {} -> {}", relPath.wstring(), mod);
+                Logger::trace(L"ModManagerDirectory | Adding Files to Map : {} -> {}", relPath.wstring(), mod);
 
                 if (!ParallaxGenUtil::containsOnlyAscii(relPath.wstring())) {
-                    spdlog::debug(
+                    Logger::debug(
                         L"Path {} in directory {} contains non-ASCII characters", relPath.wstring(), modDir.wstring());
                 }
 
@@ -181,14 +179,13 @@ void ModManagerDirectory::populateModFileMapMO2(
                 m_modFileMap[relPathLower] = mod;
             }
         } catch (const filesystem::filesystem_error& e) {
-            spdlog::error(
+            Logger::error(
                 L"Error reading mod directory {} (skipping): {}", mod, ParallaxGenUtil::asciitoUTF16(e.what()));
         }
     }
 
     if (!foundOneMod) {
-        spdlog::critical(L"MO2 modlist.txt was empty, no mods found");
-        exit(1);
+        Logger::critical(L"MO2 modlist.txt was empty, no mods found");
     }
 
     modListFileF.close();
@@ -1,4 +1,5 @@
 #include "NIFUtil.hpp"
+#include "PGTextureName.hpp"
 #include "ParallaxGenUtil.hpp"
 
 #include <nifly/Geometry.hpp>
@@ -12,10 +13,13 @@
 #include <boost/iostreams/stream.hpp>
 
 #include <array>
+#include <cstring>
 #include <filesystem>
 #include <map>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <unordered_map>
 #include <vector>
@@ -25,6 +29,20 @@
 
 using namespace std;
 
+namespace {
+/// @brief path like parent_path() / stem() writes it, only copied if std::filesystem would rewrite it
+auto getPathWithoutExtension(const filesystem::path& path, wstring& storage) -> wstring_view
+{
+#ifdef _WIN32
+    return PGTextureName::stripExtension(path.native(), storage);
+#else
+    // narrow paths are converted anyway
+    storage = (path.parent_path() / path.stem()).wstring();
+    return storage;
+#endif
+}
+} // namespace
+
 auto NIFUtil::getStrFromShader(const ShapeShader& shader) -> string
 {
     const static unordered_map<NIFUtil::ShapeShader, string> strFromShaderMap
@@ -85,27 +103,15 @@ auto NIFUtil::getDefaultTextureType(const TextureSlots& slot) -> TextureType
     }
 }
 
-auto NIFUtil::getTexSuffixMap() -> map<wstring, tuple<NIFUtil::TextureSlots, NIFUtil::TextureType>>
-{
-    static const map<wstring, tuple<NIFUtil::TextureSlots, NIFUtil::TextureType>> textureSuffixMap
-        = { { L"_bl", { NIFUtil::TextureSlots::BACKLIGHT, NIFUtil::TextureType::BACKLIGHT } },
-              { L"_b", { NIFUtil::TextureSlots::BACKLIGHT, NIFUtil::TextureType::BACKLIGHT } },
-              { L"_cnr", { NIFUtil::TextureSlots::MULTILAYER, NIFUtil::TextureType::COATNORMALROUGHNESS } },
-              { L"_s", { NIFUtil::TextureSlots::MULTILAYER, NIFUtil::TextureType::SUBSURFACETINT } },
-              { L"_i", { NIFUtil::TextureSlots::MULTILAYER, NIFUtil::TextureType::INNERLAYER } },
-              { L"_f", { NIFUtil::TextureSlots::MULTILAYER, NIFUtil::TextureType::FUZZPBR } },
-              { L"_rmaos", { NIFUtil::TextureSlots::ENVMASK, NIFUtil::TextureType::RMAOS } },
-              { L"_envmask", { NIFUtil::TextureSlots::ENVMASK, NIFUtil::TextureType::ENVIRONMENTMASK } },
-              { L"_em", { NIFUtil::TextureSlots::ENVMASK, NIFUtil::TextureType::ENVIRONMENTMASK } },
-              { L"_m", { NIFUtil::TextureSlots::ENVMASK, NIFUtil::TextureType::ENVIRONMENTMASK } },
-              { L"_e", { NIFUtil::TextureSlots::CUBEMAP, NIFUtil::TextureType::CUBEMAP } },
-              { L"_p", { NIFUtil::TextureSlots::PARALLAX, NIFUtil::TextureType::HEIGHT } },
-              { L"_sk", { NIFUtil::TextureSlots::GLOW, NIFUtil::TextureType::SKINTINT } },
-              { L"_g", { NIFUtil::TextureSlots::GLOW, NIFUtil::TextureType::EMISSIVE } },
-              { L"_msn", { NIFUtil::TextureSlots::NORMAL, NIFUtil::TextureType::NORMAL } },
-              { L"_n", { NIFUtil::TextureSlots::NORMAL, NIFUtil::TextureType::NORMAL } },
-              { L"_d", { NIFUtil::TextureSlots::DIFFUSE, NIFUtil::TextureType::DIFFUSE } },
-              { L"mask", { NIFUtil::TextureSlots::DIFFUSE, NIFUtil::TextureType::DIFFUSE } } };
+auto NIFUtil::getTexSuffixMap() -> const map<wstring, tuple<NIFUtil::TextureSlots, NIFUtil::TextureType>>&
+{
+    static const auto textureSuffixMap = [] {
+        map<wstring, tuple<NIFUtil::TextureSlots, NIFUtil::TextureType>> suffixMap;
+        for (const auto& suffix : PGTextureName::SUFFIXES) {
+            suffixMap.emplace(suffix.suffix, make_tuple(suffix.slot, suffix.type));
+        }
+        return suffixMap;
+    }();
 
     return textureSuffixMap;
 }
@@ -179,26 +185,19 @@ auto NIFUtil::getSlotFromTexType(const TextureType& type) -> TextureSlots
 auto NIFUtil::getDefaultsFromSuffix(const std::filesystem::path& path)
     -> tuple<NIFUtil::TextureSlots, NIFUtil::TextureType>
 {
-    const auto& suffixMap = getTexSuffixMap();
-
     // Get the texture suffix
-    const auto pathWithoutExtension = path.parent_path() / path.stem();
-    const auto& pathStr = pathWithoutExtension.wstring();
-
-    for (const auto& [suffix, slot] : suffixMap) {
-        if (boost::iends_with(pathStr, suffix)) {
-            // check if PBR in prefix
-            if (get<1>(slot) == TextureType::HEIGHT && boost::istarts_with(pathStr, L"textures\\pbr")) {
-                // This is a PBR heightmap so it gets a different texture type
-                return { TextureSlots::PARALLAX, TextureType::HEIGHTPBR };
-            }
-
-            return slot;
-        }
+    wstring pathStorage;
+    const auto pathStr = getPathWithoutExtension(path, pathStorage);
+    const auto texName = PGTextureName::parse(pathStr);
+
+    // check if PBR in prefix
+    if (texName.type == TextureType::HEIGHT && boost::istarts_with(pathStr, L"textures\\pbr")) {
+        // This is a PBR heightmap so it gets a different texture type
+        return { TextureSlots::PARALLAX, TextureType::HEIGHTPBR };
     }
 
-    // Default return diffuse
-    return { TextureSlots::UNKNOWN, TextureType::UNKNOWN };
+    // UNKNOWN if no suffix matched
+    return { texName.slot, texName.type };
 }
 
 auto NIFUtil::getTexTypesStr() -> vector<string>
@@ -236,6 +235,19 @@ auto NIFUtil::loadNIFFromBytes(const std::vector<std::byte>& nifBytes) -> nifly:
     return nif;
 }
 
+auto NIFUtil::saveNIFToBytes(NifFile& nif, const NifSaveOptions& options) -> vector<std::byte>
+{
+    ostringstream nifStream(ios::binary);
+    if (nif.Save(nifStream, options) != 0) {
+        return {};
+    }
+
+    const auto nifString = std::move(nifStream).str();
+    vector<std::byte> nifBytes(nifString.size());
+    memcpy(nifBytes.data(), nifString.data(), nifString.size());
+    return nifBytes;
+}
+
 auto NIFUtil::setShaderType(nifly::NiShader* nifShader, const nifly::BSLightingShaderPropertyShaderType& type) -> bool
 {
     if (nifShader->GetShaderType() != type) {
@@ -421,19 +433,8 @@ auto NIFUtil::textureSetToStr(const TextureSet& set) -> TextureSetStr
 
 auto NIFUtil::getTexBase(const std::filesystem::path& path) -> std::wstring
 {
-    const auto& suffixMap = getTexSuffixMap();
-
-    // Get the texture suffix
-    const auto pathWithoutExtension = path.parent_path() / path.stem();
-    const auto& pathStr = pathWithoutExtension.wstring();
-
-    for (const auto& [suffix, slot] : suffixMap) {
-        if (boost::iends_with(pathStr, suffix)) {
-            return pathStr.substr(0, pathStr.size() - suffix.size());
-        }
-    }
-
-    return pathStr;
+    wstring pathStorage;
+    return wstring(PGTextureName::parse(getPathWithoutExtension(path, pathStorage)).base);
 }
 
 auto NIFUtil::getTexMatch(const wstring& base, const TextureType& desiredType,
@@ -501,8 +502,8 @@ auto NIFUtil::getSearchPrefixes(const array<wstring, NUM_TEXTURE_SLOTS>& oldSlot
             continue;
         }
 
-        const auto texBase = getTexBase(oldSlots.at(i));
-        outSlots.at(i) = texBase;
+        wstring pathStorage;
+        outSlots.at(i) = PGTextureName::parse(PGTextureName::stripExtension(oldSlots.at(i), pathStorage)).base;
     }
 
     return outSlots;
@@ -0,0 +1,337 @@
+#include "PGArchiveWriter.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <fstream>
+#include <ranges>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include "Logger.hpp"
+#include "PGMemoryBudget.hpp"
+#include "ParallaxGenRunner.hpp"
+#include "ParallaxGenTask.hpp"
+#include "ParallaxGenUtil.hpp"
+
+using namespace std;
+using namespace ParallaxGenUtil;
+
+namespace {
+// TES4 record header of an empty plugin
+constexpr uint32_t PLUGIN_FLAG_LIGHT = 0x200;
+constexpr uint32_t PLUGIN_NEXT_OBJECT_ID = 0x800;
+constexpr uint16_t PLUGIN_HEDR_SIZE = 12;
+
+/**
+ * @struct GameFormat
+ * @brief Archive and plugin header values a game accepts
+ */
+struct GameFormat {
+    bsa::tes4::version archiveVersion;
+    bool lightPlugins;
+    float hedrVersion;
+    uint16_t formVersion;
+};
+
+auto getGameFormat(const BethesdaGame::GameType& gameType) -> GameFormat
+{
+    static constexpr GameFormat LEGACY_FORMAT
+        = { .archiveVersion = bsa::tes4::version::tes5, .lightPlugins = false, .hedrVersion = 0.94F, .formVersion = 43 };
+    static constexpr GameFormat SE_FORMAT
+        = { .archiveVersion = bsa::tes4::version::sse, .lightPlugins = true, .hedrVersion = 1.7F, .formVersion = 44 };
+
+    switch (gameType) {
+    case BethesdaGame::GameType::SKYRIM:
+    case BethesdaGame::GameType::ENDERAL:
+        return LEGACY_FORMAT;
+    case BethesdaGame::GameType::SKYRIM_SE:
+    case BethesdaGame::GameType::SKYRIM_GOG:
+    case BethesdaGame::GameType::ENDERAL_SE:
+        return SE_FORMAT;
+    case BethesdaGame::GameType::SKYRIM_VR: {
+        // SE archives, but light plugins are not supported
+        auto vrFormat = SE_FORMAT;
+        vrFormat.lightPlugins = false;
+        return vrFormat;
+    }
+    }
+
+    throw invalid_argument("Unknown game type");
+}
+
+/**
+ * @class BudgetCharge
+ * @brief Bytes charged to PGMemoryBudget by several threads, released together on destruction
+ */
+class BudgetCharge {
+private:
+    atomic<size_t> m_bytes = 0;
+
+public:
+    BudgetCharge() = default;
+    ~BudgetCharge() { PGMemoryBudget::release(m_bytes.load()); }
+    BudgetCharge(const BudgetCharge&) = delete;
+    auto operator=(const BudgetCharge&) -> BudgetCharge& = delete;
+    BudgetCharge(BudgetCharge&&) = delete;
+    auto operator=(BudgetCharge&&) -> BudgetCharge& = delete;
+
+    void add(const size_t& bytes)
+    {
+        PGMemoryBudget::charge(bytes);
+        m_bytes.fetch_add(bytes);
+    }
+};
+
+void writeLE(ofstream& stream, const uint32_t& value)
+{
+    const array<char, sizeof(uint32_t)> bytes = { static_cast<char>(value & 0xFFU),
+        static_cast<char>((value >> 8U) & 0xFFU), static_cast<char>((value >> 16U) & 0xFFU),
+        static_cast<char>((value >> 24U) & 0xFFU) };
+    stream.write(bytes.data(), bytes.size());
+}
+
+void writeLE(ofstream& stream, const uint16_t& value)
+{
+    const array<char, sizeof(uint16_t)> bytes
+        = { static_cast<char>(value & 0xFFU), static_cast<char>((value >> 8U) & 0xFFU) };
+    stream.write(bytes.data(), bytes.size());
+}
+
+auto getContentFolder(const PGArchiveWriter::ArchiveContent& content) -> filesystem::path
+{
+    return content == PGArchiveWriter::ArchiveContent::MESHES ? "meshes" : "textures";
+}
+} // namespace
+
+PGArchiveWriter::PGArchiveWriter(
+    filesystem::path outputDir, const BethesdaGame::GameType& gameType, wstring baseName, const uint64_t& sizeLimit)
+    : m_outputDir(std::move(outputDir))
+    , m_gameType(gameType)
+    , m_baseName(std::move(baseName))
+    , m_sizeLimit(sizeLimit)
+{
+    if (m_sizeLimit == 0) {
+        throw invalid_argument("Archive size limit must be greater than 0");
+    }
+}
+
+auto PGArchiveWriter::writeArchives(const bool& multiThread, const bool& removeLoose) -> vector<ArchiveInfo>
+{
+    vector<ArchiveInfo> archives;
+
+    size_t numPlugins = 0;
+    for (const auto& content : { ArchiveContent::MESHES, ArchiveContent::TEXTURES }) {
+        const auto chunks = getChunks(content);
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            const auto bsaPath = m_outputDir / getArchiveName(m_baseName, i, content);
+            Logger::info(L"Packing {} files into {}", chunks[i].size(), bsaPath.filename().wstring());
+
+            writeArchive(bsaPath, content, chunks[i], multiThread);
+
+            uint64_t dataSize = 0;
+            for (const auto& file : chunks[i]) {
+                dataSize += file.size;
+            }
+
+            archives.push_back({ .bsaPath = bsaPath,
+                .pluginPath = m_outputDir / getPluginName(m_baseName, i),
+                .content = content,
+                .numFiles = chunks[i].size(),
+                .dataSize = dataSize });
+
+            if (removeLoose) {
+                removeLooseFiles(chunks[i]);
+            }
+        }
+
+        numPlugins = max(numPlugins, chunks.size());
+    }
+
+    // one plugin per archive index loads both the meshes and the textures archive of that index
+    for (size_t i = 0; i < numPlugins; ++i) {
+        writeDummyPlugin(m_outputDir / getPluginName(m_baseName, i), m_gameType);
+    }
+
+    return archives;
+}
+
+void PGArchiveWriter::writeDummyPlugin(const filesystem::path& pluginPath, const BethesdaGame::GameType& gameType)
+{
+    const auto format = getGameFormat(gameType);
+
+    ofstream pluginFile(pluginPath, ios::binary | ios::trunc);
+    if (!pluginFile.is_open()) {
+        throw runtime_error("Unable to open plugin for writing: " + utf16toUTF8(pluginPath.wstring()));
+    }
+
+    static constexpr string_view AUTHOR = "ParallaxGen";
+    static constexpr uint16_t SUBRECORD_HEADER_SIZE = 6;
+    const auto authorSize = static_cast<uint16_t>(AUTHOR.size() + 1);
+    const uint32_t dataSize = SUBRECORD_HEADER_SIZE + PLUGIN_HEDR_SIZE + SUBRECORD_HEADER_SIZE + authorSize;
+
+    // record header
+    pluginFile.write("TES4", 4);
+    writeLE(pluginFile, dataSize);
+    writeLE(pluginFile, format.lightPlugins ? PLUGIN_FLAG_LIGHT : uint32_t { 0 });
+    writeLE(pluginFile, uint32_t { 0 }); // form ID
+    writeLE(pluginFile, uint32_t { 0 }); // version control
+    writeLE(pluginFile, format.formVersion);
+    writeLE(pluginFile, uint16_t { 0 });
+
+    // HEDR
+    pluginFile.write("HEDR", 4);
+    writeLE(pluginFile, PLUGIN_HEDR_SIZE);
+    writeLE(pluginFile, bit_cast<uint32_t>(format.hedrVersion));
+    writeLE(pluginFile, uint32_t { 0 }); // number of records
+    writeLE(pluginFile, PLUGIN_NEXT_OBJECT_ID);
+
+    // CNAM
+    pluginFile.write("CNAM", 4);
+    writeLE(pluginFile, authorSize);
+    pluginFile.write(AUTHOR.data(), static_cast<streamsize>(AUTHOR.size()));
+    pluginFile.put('\0');
+
+    pluginFile.close();
+}
+
+auto PGArchiveWriter::getDefaultBaseName() -> wstring { return L"ParallaxGen_Archive"; }
+
+auto PGArchiveWriter::getArchiveName(const wstring& baseName, const size_t& index, const ArchiveContent& content)
+    -> wstring
+{
+    const auto pluginStem = filesystem::path(getPluginName(baseName, index)).stem().wstring();
+    return content == ArchiveContent::MESHES ? pluginStem + L".bsa" : pluginStem + L" - Textures.bsa";
+}
+
+auto PGArchiveWriter::getPluginName(const wstring& baseName, const size_t& index) -> wstring
+{
+    if (index == 0) {
+        return baseName + L".esp";
+    }
+
+    return baseName + to_wstring(index + 1) + L".esp";
+}
+
+auto PGArchiveWriter::getChunks(const ArchiveContent& content) const -> vector<vector<LooseFile>>
+{
+    const auto contentDir = m_outputDir / getContentFolder(content);
+    if (!filesystem::is_directory(contentDir)) {
+        return {};
+    }
+
+    vector<LooseFile> files;
+    for (const auto& entry :
+        filesystem::recursive_directory_iterator(contentDir, filesystem::directory_options::skip_permission_denied)) {
+        if (!entry.is_regular_file()) {
+            continue;
+        }
+
+        auto relPath = entry.path().lexically_relative(m_outputDir);
+        if (!containsOnlyAscii(relPath.wstring())) {
+            Logger::warn(L"File {} has non-ascii characters and cannot be stored in a BSA - leaving it loose",
+                relPath.wstring());
+            continue;
+        }
+
+        files.push_back({ .relPath = std::move(relPath), .size = entry.file_size() });
+    }
+
+    // sorted so that the same output always packs into the same archives
+    ranges::sort(files, {}, &LooseFile::relPath);
+
+    vector<vector<LooseFile>> chunks;
+    uint64_t chunkSize = 0;
+    for (auto& file : files) {
+        if (chunks.empty() || (!chunks.back().empty() && chunkSize + file.size > m_sizeLimit)) {
+            chunks.emplace_back();
+            chunkSize = 0;
+        }
+
+        chunkSize += file.size;
+        chunks.back().push_back(std::move(file));
+    }
+
+    return chunks;
+}
+
+void PGArchiveWriter::writeArchive(const filesystem::path& bsaPath, const ArchiveContent& content,
+    const vector<LooseFile>& files, const bool& multiThread) const
+{
+    const auto archiveVersion = getGameFormat(m_gameType).archiveVersion;
+
+    // compress in parallel, each task owns one slot
+    vector<bsa::tes4::file> packedFiles(files.size());
+
+    // compressed files stay in memory until the archive is written, charging them lets the budget evict caches
+    BudgetCharge packedCharge;
+
+    ParallaxGenTask taskTracker("Archive Packer", files.size());
+    ParallaxGenRunner runner(multiThread);
+    for (size_t i = 0; i < files.size(); ++i) {
+        runner.addTask([this, &files, &packedFiles, &packedCharge, &taskTracker, archiveVersion, i] {
+            auto& packedFile = packedFiles[i];
+            {
+                const PGMemoryBudget::Reservation readReservation(files[i].size);
+                packedFile.set_data(getFileBytes(m_outputDir / files[i].relPath));
+                packedFile.compress(archiveVersion);
+            }
+
+            packedCharge.add(packedFile.size());
+            taskTracker.completeJob(ParallaxGenTask::PGResult::SUCCESS);
+        });
+    }
+
+    runner.runTasks();
+
+    bsa::tes4::archive archive;
+    for (size_t i = 0; i < files.size(); ++i) {
+        const auto& relPath = files[i].relPath;
+        const auto dirKey = utf16toASCII(toLowerASCII(relPath.parent_path().wstring()));
+        const auto fileKey = utf16toASCII(toLowerASCII(relPath.filename().wstring()));
+
+        auto [dirIt, inserted] = archive.insert(dirKey, bsa::tes4::directory {});
+        dirIt->second.insert(fileKey, std::move(packedFiles[i]));
+    }
+
+    archive.archive_flags(bsa::tes4::archive_flag::directory_strings | bsa::tes4::archive_flag::file_strings
+        | bsa::tes4::archive_flag::compressed);
+    archive.archive_types(
+        content == ArchiveContent::MESHES ? bsa::tes4::archive_type::meshes : bsa::tes4::archive_type::textures);
+
+    if (filesystem::exists(bsaPath)) {
+        filesystem::remove(bsaPath);
+    }
+
+    archive.write(bsaPath, archiveVersion);
+}
+
+void PGArchiveWriter::removeLooseFiles(const vector<LooseFile>& files) const
+{
+    for (const auto& file : files) {
+        filesystem::remove(m_outputDir / file.relPath);
+    }
+
+    // remove folders left empty, deepest first
+    for (const auto& content : { ArchiveContent::MESHES, ArchiveContent::TEXTURES }) {
+        const auto contentDir = m_outputDir / getContentFolder(content);
+        if (!filesystem::is_directory(contentDir)) {
+            continue;
+        }
+
+        vector<filesystem::path> dirs = { contentDir };
+        for (const auto& entry : filesystem::recursive_directory_iterator(contentDir)) {
+            if (entry.is_directory()) {
+                dirs.push_back(entry.path());
+            }
+        }
+
+        for (const auto& dir : ranges::reverse_view(dirs)) {
+            if (filesystem::is_empty(dir)) {
+                filesystem::remove(dir);
+            }
+        }
+    }
+}
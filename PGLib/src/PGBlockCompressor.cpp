@@ -0,0 +1,141 @@
+#include "PGBlockCompressor.hpp"
+#include "ParallaxGenRunner.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+using namespace std;
+
+auto PGBlockCompressor::isFormatSupported(const DXGI_FORMAT& format) -> bool
+{
+    switch (format) {
+    case DXGI_FORMAT_BC1_UNORM:
+    case DXGI_FORMAT_BC1_UNORM_SRGB:
+    case DXGI_FORMAT_BC3_UNORM:
+    case DXGI_FORMAT_BC3_UNORM_SRGB:
+    case DXGI_FORMAT_BC5_UNORM:
+    case DXGI_FORMAT_BC5_SNORM:
+    case DXGI_FORMAT_BC7_UNORM:
+    case DXGI_FORMAT_BC7_UNORM_SRGB:
+        return true;
+    default:
+        return false;
+    }
+}
+
+auto PGBlockCompressor::getCompressFlags(const DXGI_FORMAT& format, const Quality& quality)
+    -> DirectX::TEX_COMPRESS_FLAGS
+{
+    // never TEX_COMPRESS_PARALLEL, tiles already run in parallel
+    const bool isBC7 = format == DXGI_FORMAT_BC7_UNORM || format == DXGI_FORMAT_BC7_UNORM_SRGB;
+    const bool isBC5 = format == DXGI_FORMAT_BC5_UNORM || format == DXGI_FORMAT_BC5_SNORM;
+
+    switch (quality) {
+    case Quality::FAST:
+        return isBC7 ? DirectX::TEX_COMPRESS_BC7_QUICK : DirectX::TEX_COMPRESS_DEFAULT;
+    case Quality::HIGH:
+        if (isBC7) {
+            return DirectX::TEX_COMPRESS_BC7_USE_3SUBSETS;
+        }
+        // BC5 channels are fit independently, dithering only helps the color endpoints of BC1-3
+        return isBC5 ? DirectX::TEX_COMPRESS_DEFAULT : DirectX::TEX_COMPRESS_DITHER;
+    case Quality::NORMAL:
+    default:
+        return DirectX::TEX_COMPRESS_DEFAULT;
+    }
+}
+
+auto PGBlockCompressor::compress(const DirectX::ScratchImage& input, const Options& options,
+    DirectX::ScratchImage& output) -> bool
+{
+    if (input.GetImageCount() < 1 || !isFormatSupported(options.format)
+        || DirectX::IsCompressed(input.GetMetadata().format)) {
+        return false;
+    }
+
+    auto meta = input.GetMetadata();
+    meta.format = options.format;
+
+    DirectX::ScratchImage result;
+    if (FAILED(result.Initialize(meta))) {
+        return false;
+    }
+
+    if (result.GetImageCount() != input.GetImageCount()) {
+        return false;
+    }
+
+    const auto flags = getCompressFlags(options.format, options.quality);
+    const auto tiles = getTiles(input);
+
+    atomic<bool> failed = false;
+    ParallaxGenRunner::parallelFor(
+        tiles.size(),
+        [&](const size_t& index) {
+            if (failed.load()) {
+                return;
+            }
+
+            const auto& tile = tiles[index];
+            // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            const auto& src = input.GetImages()[tile.imageIndex];
+            const auto& dst = result.GetImages()[tile.imageIndex];
+            // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            if (!compressTile(src, dst, tile, options, flags)) {
+                failed.store(true);
+            }
+        },
+        options.multiThread);
+
+    if (failed.load()) {
+        return false;
+    }
+
+    output = std::move(result);
+    return true;
+}
+
+auto PGBlockCompressor::getTiles(const DirectX::ScratchImage& input) -> vector<Tile>
+{
+    vector<Tile> tiles;
+
+    const auto* images = input.GetImages();
+    for (size_t i = 0; i < input.GetImageCount(); ++i) {
+        const auto height = images[i].height; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        for (size_t rowStart = 0; rowStart < height; rowStart += TILE_ROWS) {
+            tiles.push_back({ .imageIndex = i, .rowStart = rowStart, .numRows = min(TILE_ROWS, height - rowStart) });
+        }
+    }
+
+    return tiles;
+}
+
+auto PGBlockCompressor::compressTile(const DirectX::Image& src, const DirectX::Image& dst, const Tile& tile,
+    const Options& options, const DirectX::TEX_COMPRESS_FLAGS& flags) -> bool
+{
+    // a view of the source rows, DirectXTex pads partial blocks of the last tile like it does for the whole image
+    DirectX::Image srcTile = src;
+    srcTile.height = tile.numRows;
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    srcTile.pixels = src.pixels + (tile.rowStart * src.rowPitch);
+    srcTile.slicePitch = src.rowPitch * tile.numRows;
+
+    DirectX::ScratchImage compressed;
+    if (FAILED(DirectX::Compress(srcTile, options.format, flags, options.alphaThreshold, compressed))) {
+        return false;
+    }
+
+    const auto* tileImage = compressed.GetImage(0, 0, 0);
+    if (tileImage == nullptr || tileImage->rowPitch != dst.rowPitch) {
+        return false;
+    }
+
+    // one row pitch of a BC image covers a row of 4x4 blocks
+    const auto blockRowStart = tile.rowStart / BLOCK_ROWS;
+    const auto numBlockRows = (tile.numRows + BLOCK_ROWS - 1) / BLOCK_ROWS;
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    memcpy(dst.pixels + (blockRowStart * dst.rowPitch), tileImage->pixels, numBlockRows * dst.rowPitch);
+
+    return true;
+}
@@ -0,0 +1,237 @@
+#include "PGConflictGraph.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <tuple>
+#include <unordered_set>
+
+using namespace std;
+
+auto PGConflictGraph::addMod(const wstring& mod) -> size_t
+{
+    const auto [it, inserted] = m_ids.try_emplace(mod, m_nodes.size());
+    if (inserted) {
+        m_nodes.emplace_back();
+        m_nodes.back().name = mod;
+    }
+
+    return it->second;
+}
+
+void PGConflictGraph::addConflict(const vector<pair<wstring, NIFUtil::ShapeShader>>& matches)
+{
+    // combine the shaders of each mod first, the same mod often matches with more than one shader
+    vector<pair<size_t, uint8_t>> mods;
+    for (const auto& [mod, shader] : matches) {
+        const auto id = addMod(mod);
+        const auto shaderBit = static_cast<uint8_t>(1U << static_cast<unsigned>(shader));
+        m_nodes[id].shaderMask |= shaderBit;
+
+        const auto it = ranges::find(mods, id, &pair<size_t, uint8_t>::first);
+        if (it == mods.end()) {
+            mods.emplace_back(id, shaderBit);
+        } else {
+            it->second |= shaderBit;
+        }
+    }
+
+    for (size_t i = 0; i < mods.size(); ++i) {
+        for (size_t j = i + 1; j < mods.size(); ++j) {
+            addEdge(mods[i].first, mods[j].first, mods[i].second | mods[j].second);
+        }
+    }
+}
+
+auto PGConflictGraph::size() const -> size_t { return m_nodes.size(); }
+
+auto PGConflictGraph::empty() const -> bool { return m_nodes.empty(); }
+
+auto PGConflictGraph::getID(const wstring& mod) const -> size_t
+{
+    const auto it = m_ids.find(mod);
+    return it == m_ids.end() ? NPOS : it->second;
+}
+
+auto PGConflictGraph::getName(const size_t& id) const -> const wstring& { return m_nodes.at(id).name; }
+
+auto PGConflictGraph::getShaders(const size_t& id) const -> vector<NIFUtil::ShapeShader>
+{
+    vector<NIFUtil::ShapeShader> shaders;
+    const auto shaderMask = m_nodes.at(id).shaderMask;
+    for (unsigned bit = 0; bit < numeric_limits<uint8_t>::digits; ++bit) {
+        if ((shaderMask & (1U << bit)) != 0) {
+            shaders.push_back(static_cast<NIFUtil::ShapeShader>(bit));
+        }
+    }
+
+    return shaders;
+}
+
+auto PGConflictGraph::getHighestShader(const size_t& id) const -> NIFUtil::ShapeShader
+{
+    const auto shaderMask = m_nodes.at(id).shaderMask;
+    if (shaderMask == 0) {
+        return NIFUtil::ShapeShader::UNKNOWN;
+    }
+
+    return static_cast<NIFUtil::ShapeShader>(bit_width(shaderMask) - 1);
+}
+
+auto PGConflictGraph::getConflicts(const size_t& id) const -> const vector<size_t>& { return m_nodes.at(id).neighbors; }
+
+auto PGConflictGraph::hasConflict(const size_t& idA, const size_t& idB) const -> bool
+{
+    const auto& adjacency = m_nodes.at(idA).adjacency;
+    const auto word = idB / BITS_PER_WORD;
+    return word < adjacency.size() && (adjacency[word] & (1ULL << (idB % BITS_PER_WORD))) != 0;
+}
+
+auto PGConflictGraph::getEdge(const size_t& idA, const size_t& idB) const -> const Edge*
+{
+    if (!hasConflict(idA, idB)) {
+        return nullptr;
+    }
+
+    return &m_edges.at(getEdgeKey(idA, idB));
+}
+
+auto PGConflictGraph::suggestOrder(const vector<wstring>& existingOrder) const -> vector<wstring>
+{
+    const unordered_set<wstring> existingMods(existingOrder.begin(), existingOrder.end());
+
+    // new mods go first, worst shader first so mods with better shaders win by default
+    vector<tuple<NIFUtil::ShapeShader, const wstring*>> newMods;
+    for (size_t id = 0; id < m_nodes.size(); ++id) {
+        const auto& name = m_nodes[id].name;
+        if (!name.empty() && !existingMods.contains(name)) {
+            newMods.emplace_back(getHighestShader(id), &name);
+        }
+    }
+    ranges::sort(newMods, [](const auto& lhs, const auto& rhs) {
+        if (get<0>(lhs) == get<0>(rhs)) {
+            return *get<1>(lhs) < *get<1>(rhs);
+        }
+        return get<0>(lhs) < get<0>(rhs);
+    });
+
+    vector<wstring> order;
+    order.reserve(newMods.size() + existingOrder.size());
+    for (const auto& [shader, name] : newMods) {
+        order.push_back(*name);
+    }
+
+    // existing mods keep their saved order
+    for (const auto& mod : existingOrder) {
+        if (!mod.empty() && m_ids.contains(mod)) {
+            order.push_back(mod);
+        }
+    }
+
+    return order;
+}
+
+void PGConflictGraph::setOrder(const vector<wstring>& order)
+{
+    for (const auto& id : m_order) {
+        m_nodes[id].row = NPOS;
+    }
+
+    m_order.clear();
+    m_order.reserve(order.size());
+    for (const auto& mod : order) {
+        m_order.push_back(m_ids.at(mod));
+    }
+
+    updateRows(0, m_order.size());
+}
+
+auto PGConflictGraph::getOrder() const -> const vector<size_t>& { return m_order; }
+
+auto PGConflictGraph::getRow(const size_t& id) const -> size_t { return m_nodes.at(id).row; }
+
+auto PGConflictGraph::getConflictRows(const size_t& row) const -> vector<size_t>
+{
+    vector<size_t> rows;
+    for (const auto& neighbor : m_nodes[m_order.at(row)].neighbors) {
+        if (m_nodes[neighbor].row != NPOS) {
+            rows.push_back(m_nodes[neighbor].row);
+        }
+    }
+
+    return rows;
+}
+
+auto PGConflictGraph::moveRows(vector<size_t> rows, size_t target) -> pair<size_t, size_t>
+{
+    ranges::sort(rows);
+    const auto [dupFirst, dupLast] = ranges::unique(rows);
+    rows.erase(dupFirst, dupLast);
+    std::erase_if(rows, [this](const size_t& row) { return row >= m_order.size(); });
+    if (rows.empty()) {
+        return { 0, 0 };
+    }
+
+    // only rows between the moved rows and the target change
+    target = min(target, m_order.size());
+    const auto first = min(rows.front(), target);
+    const auto last = max(rows.back() + 1, target);
+
+    vector<size_t> kept;
+    vector<size_t> moved;
+    size_t insertPos = 0;
+    for (size_t row = first; row < last; ++row) {
+        if (ranges::binary_search(rows, row)) {
+            moved.push_back(m_order[row]);
+        } else {
+            kept.push_back(m_order[row]);
+            if (row < target) {
+                insertPos++;
+            }
+        }
+    }
+
+    kept.insert(kept.begin() + static_cast<ptrdiff_t>(insertPos), moved.begin(), moved.end());
+    ranges::copy(kept, m_order.begin() + static_cast<ptrdiff_t>(first));
+    updateRows(first, last);
+
+    return { first, last };
+}
+
+void PGConflictGraph::reverseOrder()
+{
+    ranges::reverse(m_order);
+    updateRows(0, m_order.size());
+}
+
+auto PGConflictGraph::getEdgeKey(const size_t& idA, const size_t& idB) -> uint64_t
+{
+    static constexpr unsigned ID_BITS = 32;
+    return (static_cast<uint64_t>(min(idA, idB)) << ID_BITS) | static_cast<uint64_t>(max(idA, idB));
+}
+
+void PGConflictGraph::addEdge(const size_t& idA, const size_t& idB, const uint8_t& shaderMask)
+{
+    auto& edge = m_edges[getEdgeKey(idA, idB)];
+    if (edge.numShapes == 0) {
+        for (const auto& [from, to] : { pair { idA, idB }, pair { idB, idA } }) {
+            auto& node = m_nodes[from];
+            const auto word = to / BITS_PER_WORD;
+            if (word >= node.adjacency.size()) {
+                node.adjacency.resize(word + 1, 0);
+            }
+            node.adjacency[word] |= 1ULL << (to % BITS_PER_WORD);
+            node.neighbors.push_back(to);
+        }
+    }
+
+    edge.numShapes++;
+    edge.shaderMask |= shaderMask;
+}
+
+void PGConflictGraph::updateRows(const size_t& first, const size_t& last)
+{
+    for (size_t row = first; row < last; ++row) {
+        m_nodes[m_order[row]].row = row;
+    }
+}
@@ -0,0 +1,243 @@
+#include "PGDiffWriter.hpp"
+#include "Logger.hpp"
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <system_error>
+
+using namespace std;
+
+PGDiffWriter::PGDiffWriter(filesystem::path runDir, const size_t& runBytes)
+    : m_runDir(std::move(runDir))
+    , m_runBytes(runBytes)
+{
+}
+
+PGDiffWriter::~PGDiffWriter() { removeRuns(); }
+
+void PGDiffWriter::add(string path, const uint32_t& crcOriginal, const uint32_t& crcPatched)
+{
+    auto& log = m_logs.local();
+    log.numBytes += sizeof(Record) + path.size();
+    log.records.push_back({ .path = std::move(path), .crcOriginal = crcOriginal, .crcPatched = crcPatched });
+    m_numRecords++;
+
+    if (log.numBytes >= m_runBytes && !m_spillFailed.load()) {
+        spill(log);
+    }
+}
+
+auto PGDiffWriter::finish(const filesystem::path& jsonPath) -> bool
+{
+    const lock_guard<mutex> lock(m_mutex);
+
+    // one cursor per run file, then one per in-memory log, so equal paths come out in the order they were added
+    struct Cursor {
+        unique_ptr<ifstream> file;
+        uint64_t remaining = 0;
+        vector<Record>* records = nullptr;
+        size_t index = 0;
+        Record current;
+    };
+
+    bool readFailed = false;
+    const auto advance = [&readFailed](Cursor& cursor) -> bool {
+        if (cursor.file != nullptr) {
+            if (cursor.remaining == 0) {
+                return false;
+            }
+            cursor.remaining--;
+            if (!readRecord(*cursor.file, cursor.current)) {
+                readFailed = true;
+                return false;
+            }
+            return true;
+        }
+
+        if (cursor.index >= cursor.records->size()) {
+            return false;
+        }
+        cursor.current = std::move((*cursor.records)[cursor.index++]);
+        return true;
+    };
+
+    vector<Cursor> cursors;
+    cursors.reserve(m_runs.size());
+    for (const auto& run : m_runs) {
+        Cursor cursor;
+        cursor.file = make_unique<ifstream>(run, ios::binary);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        if (!cursor.file->read(reinterpret_cast<char*>(&cursor.remaining), sizeof(cursor.remaining))) {
+            Logger::error(L"Unable to read diff run {}", run.wstring());
+            readFailed = true;
+            continue;
+        }
+        cursors.push_back(std::move(cursor));
+    }
+    m_logs.forEach([&cursors](ThreadLog& log) {
+        sortRecords(log.records);
+        Cursor cursor;
+        cursor.records = &log.records;
+        cursors.push_back(std::move(cursor));
+    });
+
+    const auto cursorGreater = [&cursors](const size_t& a, const size_t& b) -> bool {
+        const auto order = cursors[a].current.path.compare(cursors[b].current.path);
+        return order != 0 ? order > 0 : a > b;
+    };
+    priority_queue<size_t, vector<size_t>, decltype(cursorGreater)> heap(cursorGreater);
+    for (size_t i = 0; i < cursors.size(); ++i) {
+        if (advance(cursors[i])) {
+            heap.push(i);
+        }
+    }
+
+    // text mode like the nlohmann::json dump this replaces
+    ofstream jsonFile(jsonPath);
+    jsonFile << '{';
+
+    // holds back each entry until the next path differs, a later record for the same path replaces it
+    bool first = true;
+    bool hasPending = false;
+    Record pending;
+    while (!heap.empty()) {
+        const auto cursorIdx = heap.top();
+        heap.pop();
+
+        auto& cursor = cursors[cursorIdx];
+        if (hasPending && pending.path != cursor.current.path) {
+            writeJSONEntry(jsonFile, pending, first);
+            first = false;
+        }
+        pending = std::move(cursor.current);
+        hasPending = true;
+
+        if (advance(cursor)) {
+            heap.push(cursorIdx);
+        }
+    }
+    if (hasPending) {
+        writeJSONEntry(jsonFile, pending, first);
+    }
+
+    jsonFile << "}\n";
+    jsonFile.close();
+
+    cursors.clear();
+    m_logs.reset();
+    removeRuns();
+
+    if (readFailed) {
+        Logger::error(L"Diff JSON {} is incomplete, a spilled run could not be read", jsonPath.wstring());
+        return false;
+    }
+
+    return !jsonFile.fail();
+}
+
+auto PGDiffWriter::getNumRecords() const -> size_t { return m_numRecords.load(); }
+
+auto PGDiffWriter::getNumRuns() -> size_t
+{
+    const lock_guard<mutex> lock(m_mutex);
+    return m_runs.size();
+}
+
+auto PGDiffWriter::spill(ThreadLog& log) -> bool
+{
+    sortRecords(log.records);
+
+    filesystem::path runPath;
+    {
+        const lock_guard<mutex> lock(m_mutex);
+        runPath = m_runDir / fmt::format("{}.run", m_nextRun++);
+        // reserve the name before writing outside of the lock
+        m_runs.push_back(runPath);
+    }
+
+    error_code ec;
+    filesystem::create_directories(m_runDir, ec);
+
+    ofstream runFile(runPath, ios::binary);
+    const uint64_t numRecords = log.records.size();
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    runFile.write(reinterpret_cast<const char*>(&numRecords), sizeof(numRecords));
+    for (const auto& record : log.records) {
+        if (!writeRecord(runFile, record)) {
+            break;
+        }
+    }
+    runFile.close();
+
+    if (runFile.fail()) {
+        // keep everything in memory from here on, the diff is still complete
+        Logger::warn(L"Unable to write diff run {}, keeping diff entries in memory", runPath.wstring());
+        m_spillFailed.store(true);
+
+        const lock_guard<mutex> lock(m_mutex);
+        erase(m_runs, runPath);
+        filesystem::remove(runPath, ec);
+        return false;
+    }
+
+    log.records.clear();
+    log.numBytes = 0;
+    return true;
+}
+
+void PGDiffWriter::removeRuns()
+{
+    m_runs.clear();
+
+    error_code ec;
+    filesystem::remove_all(m_runDir, ec);
+}
+
+void PGDiffWriter::sortRecords(vector<Record>& records)
+{
+    // stable, so the last record of a path from this thread still comes last
+    ranges::stable_sort(records, less<> {}, &Record::path);
+}
+
+// NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+auto PGDiffWriter::writeRecord(ofstream& stream, const Record& record) -> bool
+{
+    const auto pathSize = static_cast<uint32_t>(record.path.size());
+    stream.write(reinterpret_cast<const char*>(&pathSize), sizeof(pathSize));
+    stream.write(record.path.data(), static_cast<streamsize>(pathSize));
+    stream.write(reinterpret_cast<const char*>(&record.crcOriginal), sizeof(record.crcOriginal));
+    stream.write(reinterpret_cast<const char*>(&record.crcPatched), sizeof(record.crcPatched));
+    return stream.good();
+}
+
+auto PGDiffWriter::readRecord(ifstream& stream, Record& record) -> bool
+{
+    uint32_t pathSize = 0;
+    if (!stream.read(reinterpret_cast<char*>(&pathSize), sizeof(pathSize))) {
+        return false;
+    }
+
+    record.path.resize(pathSize);
+    stream.read(record.path.data(), static_cast<streamsize>(pathSize));
+    stream.read(reinterpret_cast<char*>(&record.crcOriginal), sizeof(record.crcOriginal));
+    stream.read(reinterpret_cast<char*>(&record.crcPatched), sizeof(record.crcPatched));
+    return stream.good();
+}
+
+// NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+
+void PGDiffWriter::writeJSONEntry(ofstream& stream, const Record& record, const bool& first)
+{
+    if (!first) {
+        stream << ',';
+    }
+
+    // nlohmann escapes the key exactly as it would inside a dumped object
+    stream << nlohmann::json(record.path).dump() << R"(:{"crc32original":)" << record.crcOriginal
+           << R"(,"crc32patched":)" << record.crcPatched << '}';
+}
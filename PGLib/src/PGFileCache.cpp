@@ -0,0 +1,124 @@
+#include "PGFileCache.hpp"
+
+#include "PGMemoryBudget.hpp"
+
+using namespace std;
+
+PGFileCache::PGFileCache()
+    : m_evictorID(PGMemoryBudget::addEvictor([this](const size_t& bytes) -> size_t { return evict(bytes); }))
+{
+}
+
+PGFileCache::~PGFileCache()
+{
+    PGMemoryBudget::removeEvictor(m_evictorID);
+    clear();
+}
+
+auto PGFileCache::get(const filesystem::path& key) -> Buffer
+{
+    const lock_guard<mutex> lock(m_mutex);
+
+    const auto it = m_index.find(key);
+    if (it == m_index.end()) {
+        return nullptr;
+    }
+
+    // move to front
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    return it->second->buffer;
+}
+
+auto PGFileCache::put(const filesystem::path& key, const Buffer& buffer) -> bool
+{
+    if (buffer == nullptr) {
+        return false;
+    }
+
+    const auto bufferSize = buffer->size();
+    const auto budget = PGMemoryBudget::getBudget();
+    if (budget > 0 && bufferSize > budget / MAX_ENTRY_FRACTION) {
+        // too large to be worth caching
+        return false;
+    }
+
+    const lock_guard<mutex> lock(m_mutex);
+
+    const auto existing = m_index.find(key);
+    if (existing != m_index.end()) {
+        eraseLocked(existing->second);
+    }
+
+    if (!PGMemoryBudget::fits(bufferSize)) {
+        evictLocked(bufferSize);
+        if (!PGMemoryBudget::fits(bufferSize)) {
+            // remaining memory is held by in-flight buffers or other caches
+            return false;
+        }
+    }
+
+    m_lru.push_front({ .key = key, .buffer = buffer });
+    m_index[key] = m_lru.begin();
+    m_bytes += bufferSize;
+    PGMemoryBudget::charge(bufferSize);
+
+    return true;
+}
+
+auto PGFileCache::holds(const filesystem::path& key, const Buffer& buffer) -> bool
+{
+    const lock_guard<mutex> lock(m_mutex);
+
+    const auto it = m_index.find(key);
+    return it != m_index.end() && it->second->buffer == buffer;
+}
+
+auto PGFileCache::evict(const size_t& bytes) -> size_t
+{
+    const lock_guard<mutex> lock(m_mutex);
+    return evictLocked(bytes);
+}
+
+void PGFileCache::clear()
+{
+    const lock_guard<mutex> lock(m_mutex);
+
+    PGMemoryBudget::release(m_bytes);
+    m_bytes = 0;
+    m_index.clear();
+    m_lru.clear();
+}
+
+auto PGFileCache::size() -> size_t
+{
+    const lock_guard<mutex> lock(m_mutex);
+    return m_lru.size();
+}
+
+auto PGFileCache::getBytes() -> size_t
+{
+    const lock_guard<mutex> lock(m_mutex);
+    return m_bytes;
+}
+
+auto PGFileCache::evictLocked(const size_t& bytes) -> size_t
+{
+    size_t freed = 0;
+    while (freed < bytes && !m_lru.empty()) {
+        const auto last = prev(m_lru.end());
+        freed += last->buffer->size();
+        eraseLocked(last);
+    }
+
+    return freed;
+}
+
+void PGFileCache::eraseLocked(const list<Entry>::iterator& it)
+{
+    const auto bufferSize = it->buffer->size();
+    m_bytes -= bufferSize;
+    PGMemoryBudget::release(bufferSize);
+
+    m_index.erase(it->key);
+    m_lru.erase(it);
+}
@@ -0,0 +1,223 @@
+#include "PGGeometry.hpp"
+
+#include <Geometry.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+using namespace nifly;
+
+mutex PGGeometry::s_uvScaleCacheMutex;
+unordered_map<uint64_t, Vector2> PGGeometry::s_uvScaleCache;
+deque<uint64_t> PGGeometry::s_uvScaleCacheOrder;
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-pro-bounds-constant-array-index)
+auto PGGeometry::getAutoUVScale(span<const Vector2> uvs, span<const Vector3> verts, span<const Triangle> tris)
+    -> optional<Vector2>
+{
+    // structure of arrays for one batch, UV edges and position edges from the first corner
+    array<float, BATCH_SIZE> du1 {};
+    array<float, BATCH_SIZE> dv1 {};
+    array<float, BATCH_SIZE> du2 {};
+    array<float, BATCH_SIZE> dv2 {};
+    array<float, BATCH_SIZE> ex1 {};
+    array<float, BATCH_SIZE> ey1 {};
+    array<float, BATCH_SIZE> ez1 {};
+    array<float, BATCH_SIZE> ex2 {};
+    array<float, BATCH_SIZE> ey2 {};
+    array<float, BATCH_SIZE> ez2 {};
+
+    array<float, NUM_LANES> sumU {};
+    array<float, NUM_LANES> sumV {};
+    size_t numTris = 0;
+
+    const auto numVerts = min(uvs.size(), verts.size());
+    for (size_t batchStart = 0; batchStart < tris.size(); batchStart += BATCH_SIZE) {
+        const auto batchEnd = min(batchStart + BATCH_SIZE, tris.size());
+
+        // gather, the only part with indexed loads
+        size_t n = 0;
+        for (size_t i = batchStart; i < batchEnd; ++i) {
+            const auto& t = tris[i];
+            if (t.p1 >= numVerts || t.p2 >= numVerts || t.p3 >= numVerts) {
+                continue;
+            }
+
+            du1[n] = uvs[t.p2].u - uvs[t.p1].u;
+            dv1[n] = uvs[t.p2].v - uvs[t.p1].v;
+            du2[n] = uvs[t.p3].u - uvs[t.p1].u;
+            dv2[n] = uvs[t.p3].v - uvs[t.p1].v;
+            ex1[n] = verts[t.p2].x - verts[t.p1].x;
+            ey1[n] = verts[t.p2].y - verts[t.p1].y;
+            ez1[n] = verts[t.p2].z - verts[t.p1].z;
+            ex2[n] = verts[t.p3].x - verts[t.p1].x;
+            ey2[n] = verts[t.p3].y - verts[t.p1].y;
+            ez2[n] = verts[t.p3].z - verts[t.p1].z;
+            n++;
+        }
+
+        // per triangle ratio of world edge length to UV edge length, same operations as the scalar formula
+        for (size_t i = 0; i < n; ++i) {
+            const float len = sqrt((ex1[i] * ex1[i]) + (ey1[i] * ey1[i]) + (ez1[i] * ez1[i]))
+                + sqrt((ex2[i] * ex2[i]) + (ey2[i] * ey2[i]) + (ez2[i] * ez2[i]));
+            du1[i] = 1.0F / ((abs(du1[i]) + abs(du2[i])) / len);
+            dv1[i] = 1.0F / ((abs(dv1[i]) + abs(dv2[i])) / len);
+        }
+
+        // lane sums keep the reduction vectorizable without reassociating float math
+        size_t i = 0;
+        for (; i + NUM_LANES <= n; i += NUM_LANES) {
+            for (size_t lane = 0; lane < NUM_LANES; ++lane) {
+                sumU[lane] += du1[i + lane];
+                sumV[lane] += dv1[i + lane];
+            }
+        }
+        for (size_t lane = 0; i < n; ++i, ++lane) {
+            sumU[lane] += du1[i];
+            sumV[lane] += dv1[i];
+        }
+
+        numTris += n;
+    }
+
+    if (numTris == 0) {
+        // every triangle was out of range, there is nothing to average
+        return nullopt;
+    }
+
+    Vector2 scale;
+    for (size_t lane = 0; lane < NUM_LANES; ++lane) {
+        scale.u += sumU[lane];
+        scale.v += sumV[lane];
+    }
+
+    scale *= 10.0F / 4.0F;
+    scale /= static_cast<float>(numTris);
+    scale.u = min(scale.u, scale.v);
+    scale.v = min(scale.u, scale.v);
+
+    return scale;
+}
+
+auto PGGeometry::getAutoUVScaleCached(span<const Vector2> uvs, span<const Vector3> verts, span<const Triangle> tris)
+    -> optional<Vector2>
+{
+    const auto hash = getGeometryHash(uvs, verts, tris);
+    {
+        const lock_guard<mutex> lock(s_uvScaleCacheMutex);
+        const auto it = s_uvScaleCache.find(hash);
+        if (it != s_uvScaleCache.end()) {
+            return it->second;
+        }
+    }
+
+    // computed outside of the lock, a concurrent miss on the same geometry computes the same value
+    const auto scale = getAutoUVScale(uvs, verts, tris);
+    if (!scale.has_value()) {
+        return nullopt;
+    }
+
+    const lock_guard<mutex> lock(s_uvScaleCacheMutex);
+    if (s_uvScaleCache.emplace(hash, *scale).second) {
+        s_uvScaleCacheOrder.push_back(hash);
+        if (s_uvScaleCacheOrder.size() > MAX_CACHE_ENTRIES) {
+            s_uvScaleCache.erase(s_uvScaleCacheOrder.front());
+            s_uvScaleCacheOrder.pop_front();
+        }
+    }
+    return scale;
+}
+
+auto PGGeometry::getShapeAutoUVScale(NifFile& nif, NiShape* nifShape) -> optional<Vector2>
+{
+    if (nifShape == nullptr) {
+        return nullopt;
+    }
+
+    // nifly unpacks BSTriShape vertex data and reads NiTriShapeData / NiTriStripsData behind the same calls
+    const auto* uvs = nif.GetUvsForShape(nifShape);
+    const auto* verts = nif.GetVertsForShape(nifShape);
+    if (uvs == nullptr || verts == nullptr || uvs->empty() || verts->empty()) {
+        return nullopt;
+    }
+
+    vector<Triangle> tris;
+    nifShape->GetTriangles(tris);
+    if (tris.empty()) {
+        return nullopt;
+    }
+
+    return getAutoUVScaleCached(*uvs, *verts, tris);
+}
+
+auto PGGeometry::getGeometryHash(span<const Vector2> uvs, span<const Vector3> verts, span<const Triangle> tris)
+    -> uint64_t
+{
+    static constexpr uint64_t HASH_SEED = 14695981039346656037ULL;
+
+    auto hash = HASH_SEED;
+    // sizes separate the arrays, so moving data from one to the next changes the hash
+    for (const auto& size : { uvs.size(), verts.size(), tris.size() }) {
+        hash = hashBytes(&size, sizeof(size), hash);
+    }
+
+    hash = hashBytes(uvs.data(), uvs.size_bytes(), hash);
+    hash = hashBytes(verts.data(), verts.size_bytes(), hash);
+    return hashBytes(tris.data(), tris.size_bytes(), hash);
+}
+
+auto PGGeometry::getCacheSize() -> size_t
+{
+    const lock_guard<mutex> lock(s_uvScaleCacheMutex);
+    return s_uvScaleCache.size();
+}
+
+auto PGGeometry::getMaxCacheSize() -> size_t { return MAX_CACHE_ENTRIES; }
+
+void PGGeometry::clearCache()
+{
+    const lock_guard<mutex> lock(s_uvScaleCacheMutex);
+    s_uvScaleCache.clear();
+    s_uvScaleCacheOrder.clear();
+}
+
+auto PGGeometry::hashBytes(const void* data, const size_t& size, uint64_t hash) -> uint64_t
+{
+    // FNV-1a style over 8 byte words with a final avalanche, hashing has to stay cheaper than the kernels it skips
+    static constexpr uint64_t HASH_PRIME = 1099511628211ULL;
+    static constexpr uint64_t MIX_1 = 0xff51afd7ed558ccdULL;
+    static constexpr uint64_t MIX_2 = 0xc4ceb9fe1a85ec53ULL;
+
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    size_t offset = 0;
+
+    // four independent chains so the multiplies overlap, geometry runs to megabytes
+    static constexpr size_t NUM_CHAINS = 4;
+    array<uint64_t, NUM_CHAINS> chains = { hash, hash + 1, hash + 2, hash + 3 };
+    for (; offset + (NUM_CHAINS * sizeof(uint64_t)) <= size; offset += NUM_CHAINS * sizeof(uint64_t)) {
+        for (size_t chain = 0; chain < NUM_CHAINS; ++chain) {
+            uint64_t word = 0;
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            memcpy(&word, bytes + offset + (chain * sizeof(uint64_t)), sizeof(word));
+            chains[chain] = (chains[chain] ^ word) * HASH_PRIME;
+        }
+    }
+    for (const auto& chainHash : chains) {
+        hash = (hash ^ chainHash) * HASH_PRIME;
+    }
+
+    for (; offset < size; ++offset) {
+        hash = (hash ^ bytes[offset]) * HASH_PRIME; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+
+    hash ^= hash >> 33U;
+    hash *= MIX_1;
+    hash ^= hash >> 33U;
+    hash *= MIX_2;
+    hash ^= hash >> 33U;
+    return hash;
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-pro-bounds-constant-array-index)
@@ -0,0 +1,51 @@
+#include "PGLightPlacerCollector.hpp"
+
+#include <algorithm>
+#include <map>
+
+using namespace std;
+
+void PGLightPlacerCollector::add(const string& model, const nlohmann::json& data, const Point& point)
+{
+    m_buffers.local().entries.push_back({ .model = model, .data = data.dump(), .point = point });
+}
+
+auto PGLightPlacerCollector::merge() -> nlohmann::json
+{
+    // model -> data -> points, ordered maps give the output order
+    map<string, map<string, vector<Point>>> grouped;
+    m_buffers.forEach([&grouped](const ThreadBuffer& buffer) {
+        for (const auto& entry : buffer.entries) {
+            grouped[entry.model][entry.data].push_back(entry.point);
+        }
+    });
+
+    nlohmann::json output = nlohmann::json::array();
+    for (auto& [model, dataGroups] : grouped) {
+        nlohmann::json lights = nlohmann::json::array();
+        for (auto& [data, points] : dataGroups) {
+            ranges::sort(points);
+
+            nlohmann::json pointsJson = nlohmann::json::array();
+            for (const auto& point : points) {
+                pointsJson.push_back(nlohmann::json::array({ point[0], point[1], point[2] }));
+            }
+
+            lights.push_back({ { "data", nlohmann::json::parse(data) }, { "points", std::move(pointsJson) } });
+        }
+
+        output.push_back({ { "models", nlohmann::json::array({ model }) }, { "lights", std::move(lights) } });
+    }
+
+    return output;
+}
+
+auto PGLightPlacerCollector::size() -> size_t
+{
+    size_t total = 0;
+    m_buffers.forEach([&total](const ThreadBuffer& buffer) { total += buffer.entries.size(); });
+
+    return total;
+}
+
+void PGLightPlacerCollector::clear() { m_buffers.reset(); }
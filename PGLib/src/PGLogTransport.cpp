@@ -0,0 +1,70 @@
+#include "PGLogTransport.hpp"
+
+#include <algorithm>
+#include <utility>
+
+using namespace std;
+
+PGLogTransport::PGLogTransport(Source source, const size_t& bufferSize)
+    : m_source(std::move(source))
+    , m_buffer(max(bufferSize, HEADER_SIZE + 1))
+{
+}
+
+auto PGLogTransport::drain(const Sink& sink) -> size_t
+{
+    size_t numMessages = 0;
+    while (true) {
+        const auto numWritten = min(m_source(m_buffer.data(), m_buffer.size()), m_buffer.size());
+        if (numWritten == 0) {
+            return numMessages;
+        }
+
+        numMessages += decode({ m_buffer.data(), numWritten }, sink);
+    }
+}
+
+auto PGLogTransport::decode(span<const uint16_t> records, const Sink& sink) -> size_t
+{
+    size_t numMessages = 0;
+    size_t pos = 0;
+    while (pos + HEADER_SIZE <= records.size()) {
+        const int level = records[pos];
+        const size_t length = static_cast<size_t>(records[pos + 1]) | (static_cast<size_t>(records[pos + 2]) << 16U);
+        pos += HEADER_SIZE;
+        if (length > records.size() - pos) {
+            return numMessages;
+        }
+
+        wstring message(length, L'\0');
+        for (size_t i = 0; i < length; ++i) {
+            message[i] = static_cast<wchar_t>(records[pos + i]);
+        }
+        pos += length;
+
+        sink(level, message);
+        numMessages++;
+    }
+
+    return numMessages;
+}
+
+auto PGLogTransport::toManagedLevel(const spdlog::level::level_enum& level) -> int
+{
+    switch (level) {
+    case spdlog::level::trace:
+        return TRACE_LOG;
+    case spdlog::level::debug:
+        return DEBUG_LOG;
+    case spdlog::level::info:
+        return INFO_LOG;
+    case spdlog::level::warn:
+        return WARN_LOG;
+    case spdlog::level::err:
+        return ERROR_LOG;
+    case spdlog::level::critical:
+        return CRITICAL_LOG;
+    default:
+        return OFF_LOG;
+    }
+}
@@ -0,0 +1,151 @@
+#include "PGMemoryBudget.hpp"
+#include "PGPlatform.hpp"
+
+#include <vector>
+
+using namespace std;
+
+// Statics
+atomic<size_t> PGMemoryBudget::s_budget = 0;
+atomic<size_t> PGMemoryBudget::s_used = 0;
+atomic<size_t> PGMemoryBudget::s_inFlight = 0;
+unordered_map<int, PGMemoryBudget::Evictor> PGMemoryBudget::s_evictors;
+int PGMemoryBudget::s_nextEvictorID = 0;
+mutex PGMemoryBudget::s_evictorsMutex;
+mutex PGMemoryBudget::s_headroomMutex;
+condition_variable PGMemoryBudget::s_headroomCV;
+
+PGMemoryBudget::Reservation::Reservation(const size_t& bytes)
+    : m_bytes(bytes)
+{
+    if (!fits(m_bytes)) {
+        // make room by shrinking caches before taking on the new buffer
+        reclaim(m_bytes);
+    }
+
+    s_used.fetch_add(m_bytes);
+    s_inFlight.fetch_add(m_bytes);
+}
+
+PGMemoryBudget::Reservation::~Reservation()
+{
+    s_inFlight.fetch_sub(m_bytes);
+    s_used.fetch_sub(m_bytes);
+    notifyHeadroom();
+}
+
+void PGMemoryBudget::setBudget(const size_t& bytes)
+{
+    s_budget.store(bytes);
+
+    if (bytes > 0 && s_used.load() > bytes) {
+        reclaim(s_used.load() - bytes);
+    }
+
+    notifyHeadroom();
+}
+
+auto PGMemoryBudget::getDefaultBudget() -> size_t
+{
+    return static_cast<size_t>(PGPlatform::getTotalPhysicalMemory() / DEFAULT_BUDGET_DIVISOR);
+}
+
+auto PGMemoryBudget::getBudget() -> size_t { return s_budget.load(); }
+
+auto PGMemoryBudget::getUsed() -> size_t { return s_used.load(); }
+
+auto PGMemoryBudget::getInFlight() -> size_t { return s_inFlight.load(); }
+
+auto PGMemoryBudget::fits(const size_t& bytes) -> bool
+{
+    const auto budget = s_budget.load();
+    if (budget == 0) {
+        return true;
+    }
+
+    return s_used.load() + bytes <= budget;
+}
+
+auto PGMemoryBudget::isNearLimit() -> bool
+{
+    if (s_budget.load() == 0) {
+        return false;
+    }
+
+    return s_used.load() >= getHighWatermark();
+}
+
+void PGMemoryBudget::charge(const size_t& bytes) { s_used.fetch_add(bytes); }
+
+void PGMemoryBudget::release(const size_t& bytes)
+{
+    s_used.fetch_sub(bytes);
+    notifyHeadroom();
+}
+
+auto PGMemoryBudget::addEvictor(const Evictor& evictor) -> int
+{
+    const lock_guard<mutex> lock(s_evictorsMutex);
+    const int id = s_nextEvictorID++;
+    s_evictors[id] = evictor;
+    return id;
+}
+
+void PGMemoryBudget::removeEvictor(const int& id)
+{
+    const lock_guard<mutex> lock(s_evictorsMutex);
+    s_evictors.erase(id);
+}
+
+auto PGMemoryBudget::reclaim(const size_t& bytes) -> size_t
+{
+    // copy evictors so caches are not called with the registry locked
+    vector<Evictor> evictors;
+    {
+        const lock_guard<mutex> lock(s_evictorsMutex);
+        evictors.reserve(s_evictors.size());
+        for (const auto& [id, evictor] : s_evictors) {
+            evictors.push_back(evictor);
+        }
+    }
+
+    size_t freed = 0;
+    for (const auto& evictor : evictors) {
+        if (freed >= bytes) {
+            break;
+        }
+
+        freed += evictor(bytes - freed);
+    }
+
+    return freed;
+}
+
+void PGMemoryBudget::waitForHeadroom(const function<bool()>& stop)
+{
+    const auto isStopped = [&stop] { return stop != nullptr && stop(); };
+    if (!isNearLimit() || isStopped()) {
+        return;
+    }
+
+    const auto highWatermark = getHighWatermark();
+    reclaim(s_used.load() - min(s_used.load(), highWatermark));
+
+    // Nothing in flight can free memory once s_inFlight is 0, waiting would never finish
+    unique_lock<mutex> lock(s_headroomMutex);
+    s_headroomCV.wait(lock, [&isStopped] { return !isNearLimit() || s_inFlight.load() == 0 || isStopped(); });
+}
+
+auto PGMemoryBudget::getHighWatermark() -> size_t
+{
+    return static_cast<size_t>(static_cast<double>(s_budget.load()) * HIGH_WATERMARK);
+}
+
+void PGMemoryBudget::notifyHeadroom()
+{
+    // taking the mutex orders this with a waiter that checked usage but is not waiting yet, so no wakeup is lost
+    {
+        const lock_guard<mutex> lock(s_headroomMutex);
+    }
+    s_headroomCV.notify_all();
+}
@@ -0,0 +1,593 @@
+#include "PGMipGenerator.hpp"
+#include "ParallaxGenRunner.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+#include <thread>
+
+using namespace std;
+
+namespace {
+
+constexpr float SRGB_LINEAR_CUTOFF = 0.04045F;
+constexpr float SRGB_ENCODE_CUTOFF = 0.0031308F;
+constexpr float SRGB_LINEAR_SCALE = 12.92F;
+constexpr float SRGB_GAMMA = 2.4F;
+constexpr float SRGB_OFFSET = 0.055F;
+constexpr float SRGB_SLOPE = 1.055F;
+
+constexpr float UNORM8_MAX = 255.0F;
+constexpr float BOX_WEIGHT = 0.25F;
+constexpr size_t COVERAGE_SEARCH_STEPS = 12;
+constexpr float COVERAGE_MAX_SCALE = 8.0F;
+
+auto srgbToLinear(const float& value) -> float
+{
+    if (value <= SRGB_LINEAR_CUTOFF) {
+        return value / SRGB_LINEAR_SCALE;
+    }
+    return pow((value + SRGB_OFFSET) / SRGB_SLOPE, SRGB_GAMMA);
+}
+
+auto linearToSRGB(const float& value) -> float
+{
+    if (value <= SRGB_ENCODE_CUTOFF) {
+        return value * SRGB_LINEAR_SCALE;
+    }
+    return (SRGB_SLOPE * pow(value, 1.0F / SRGB_GAMMA)) - SRGB_OFFSET;
+}
+
+/// @brief 8 bit value to linear float, sRGB decoding is a table lookup
+auto getUNorm8Table(const bool& srgb) -> const array<float, 256>&
+{
+    static const auto s_tables = [] {
+        array<array<float, 256>, 2> tables {};
+        for (size_t i = 0; i < 256; ++i) {
+            const auto value = static_cast<float>(i) / UNORM8_MAX;
+            tables[0][i] = value;
+            tables[1][i] = srgbToLinear(value);
+        }
+        return tables;
+    }();
+
+    return s_tables[srgb ? 1 : 0];
+}
+
+auto toUNorm8(const float& value) -> uint8_t
+{
+    return static_cast<uint8_t>(lround(clamp(value, 0.0F, 1.0F) * UNORM8_MAX));
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+auto halfToFloat(const uint16_t& half) -> float
+{
+    const uint32_t sign = static_cast<uint32_t>(half & 0x8000U) << 16U;
+    uint32_t exponent = (half >> 10U) & 0x1FU;
+    uint32_t mantissa = half & 0x3FFU;
+
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            return bit_cast<float>(sign);
+        }
+
+        // subnormal, renormalize
+        exponent = 1;
+        while ((mantissa & 0x400U) == 0) {
+            mantissa <<= 1U;
+            exponent--;
+        }
+        mantissa &= 0x3FFU;
+        exponent += 127 - 15;
+        return bit_cast<float>(sign | (exponent << 23U) | (mantissa << 13U));
+    }
+
+    if (exponent == 0x1F) {
+        return bit_cast<float>(sign | 0x7F800000U | (mantissa << 13U));
+    }
+
+    return bit_cast<float>(sign | ((exponent + 127 - 15) << 23U) | (mantissa << 13U));
+}
+
+auto floatToHalf(const float& value) -> uint16_t
+{
+    const auto bits = bit_cast<uint32_t>(value);
+    const auto sign = static_cast<uint16_t>((bits >> 16U) & 0x8000U);
+    const auto exponent = static_cast<int32_t>((bits >> 23U) & 0xFFU) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFFU;
+
+    if (((bits >> 23U) & 0xFFU) == 0xFF) {
+        // inf or nan
+        return static_cast<uint16_t>(sign | 0x7C00U | (mantissa != 0 ? 0x200U : 0U));
+    }
+
+    if (exponent >= 0x1F) {
+        return static_cast<uint16_t>(sign | 0x7C00U);
+    }
+
+    if (exponent <= 0) {
+        if (exponent < -10) {
+            return sign;
+        }
+
+        // subnormal, round to nearest even
+        mantissa |= 0x800000U;
+        const auto shift = static_cast<uint32_t>(14 - exponent);
+        auto halfMantissa = mantissa >> shift;
+        const auto rem = mantissa & ((1U << shift) - 1U);
+        const auto halfway = 1U << (shift - 1U);
+        if (rem > halfway || (rem == halfway && (halfMantissa & 1U) != 0)) {
+            halfMantissa++;
+        }
+        return static_cast<uint16_t>(sign | halfMantissa);
+    }
+
+    auto result = static_cast<uint32_t>(sign) | (static_cast<uint32_t>(exponent) << 10U) | (mantissa >> 13U);
+    const auto rem = mantissa & 0x1FFFU;
+    if (rem > 0x1000U || (rem == 0x1000U && (result & 1U) != 0)) {
+        // carry may roll into the exponent, which is still correct rounding
+        result++;
+    }
+    return static_cast<uint16_t>(result);
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+auto besselI0(const float& x) -> float
+{
+    // power series, converges fast for the small arguments of the window
+    float sum = 1.0F;
+    float term = 1.0F;
+    const float halfX = x / 2.0F;
+    for (int k = 1; k < 32; ++k) { // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        term *= (halfX / static_cast<float>(k)) * (halfX / static_cast<float>(k));
+        sum += term;
+        if (term < sum * 1e-7F) { // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+            break;
+        }
+    }
+    return sum;
+}
+
+auto sinc(const float& x) -> float
+{
+    if (abs(x) < 1e-6F) { // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        return 1.0F;
+    }
+    const auto piX = numbers::pi_v<float> * x;
+    return sin(piX) / piX;
+}
+
+} // namespace
+
+template <typename Func> void PGMipGenerator::forEachRows(const size_t& numRows, const bool& multiThread, Func&& func)
+{
+    const auto numThreads = static_cast<size_t>(max(thread::hardware_concurrency(), 1U));
+    const auto numChunks = min(numThreads, numRows / MIN_ROWS_PER_TASK);
+    if (!multiThread || numChunks <= 1) {
+        func(size_t { 0 }, numRows);
+        return;
+    }
+
+    // shares the runner pool with the patcher tasks instead of starting threads per level
+    ParallaxGenRunner::parallelFor(numChunks, [&](const size_t& chunk) {
+        func(chunk * numRows / numChunks, (chunk + 1) * numRows / numChunks);
+    });
+}
+
+auto PGMipGenerator::isFormatSupported(const DXGI_FORMAT& format) -> bool
+{
+    switch (format) {
+    case DXGI_FORMAT_R8G8B8A8_UNORM:
+    case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+    case DXGI_FORMAT_B8G8R8A8_UNORM:
+    case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+    case DXGI_FORMAT_R16G16B16A16_FLOAT:
+    case DXGI_FORMAT_R32G32B32A32_FLOAT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+auto PGMipGenerator::countMipLevels(const size_t& width, const size_t& height) -> size_t
+{
+    auto size = max(width, height);
+    size_t levels = 1;
+    while (size > 1) {
+        size /= 2;
+        levels++;
+    }
+    return levels;
+}
+
+auto PGMipGenerator::generate(const DirectX::Image& base, const Options& options, DirectX::ScratchImage& output)
+    -> bool
+{
+    if (!isFormatSupported(base.format) || base.width == 0 || base.height == 0 || base.pixels == nullptr) {
+        return false;
+    }
+
+    const auto fullLevels = countMipLevels(base.width, base.height);
+    const auto numLevels = options.mipLevels == 0 ? fullLevels : min(options.mipLevels, fullLevels);
+
+    DirectX::ScratchImage result;
+    if (FAILED(result.Initialize2D(base.format, base.width, base.height, 1, numLevels))) {
+        return false;
+    }
+
+    // top level is kept bit exact
+    const auto* top = result.GetImage(0, 0, 0);
+    const auto rowBytes = min(base.rowPitch, top->rowPitch);
+    for (size_t y = 0; y < base.height; ++y) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        memcpy(top->pixels + (y * top->rowPitch), base.pixels + (y * base.rowPitch), rowBytes);
+    }
+
+    if (numLevels > 1) {
+        const auto srgb = isSRGB(base.format, options);
+        const auto preserveCoverage = options.alphaCoverageRef >= 0.0F;
+
+        Level cur;
+        readImage(base, srgb, options.multiThread, cur);
+
+        const auto targetCoverage = preserveCoverage ? getAlphaCoverage(cur, options.alphaCoverageRef, 1.0F) : 0.0F;
+
+        for (size_t mip = 1; mip < numLevels; ++mip) {
+            Level next;
+            downsample(cur, next, options);
+
+            if (preserveCoverage) {
+                // the chain keeps filtering the unscaled alpha so scaling does not compound
+                auto scaled = next;
+                scaleAlphaToCoverage(scaled, options.alphaCoverageRef, targetCoverage);
+                writeImage(scaled, srgb, options.multiThread, *result.GetImage(mip, 0, 0));
+            } else {
+                writeImage(next, srgb, options.multiThread, *result.GetImage(mip, 0, 0));
+            }
+
+            cur = std::move(next);
+        }
+    }
+
+    output = std::move(result);
+    return true;
+}
+
+auto PGMipGenerator::ensureMipChain(DirectX::ScratchImage& image, const Options& options) -> bool
+{
+    if (image.GetImageCount() < 1) {
+        return false;
+    }
+
+    const auto& meta = image.GetMetadata();
+    const auto fullLevels = countMipLevels(meta.width, meta.height);
+    const auto wantedLevels = options.mipLevels == 0 ? fullLevels : min(options.mipLevels, fullLevels);
+    if (meta.mipLevels >= wantedLevels) {
+        return true;
+    }
+
+    if (meta.dimension != DirectX::TEX_DIMENSION_TEXTURE2D || meta.arraySize != 1 || meta.depth != 1) {
+        // cubemaps and arrays keep what they have
+        return false;
+    }
+
+    DirectX::ScratchImage result;
+    auto genOptions = options;
+    genOptions.mipLevels = wantedLevels;
+    if (!generate(*image.GetImage(0, 0, 0), genOptions, result)) {
+        return false;
+    }
+
+    image = std::move(result);
+    return true;
+}
+
+auto PGMipGenerator::isSRGB(const DXGI_FORMAT& format, const Options& options) -> bool
+{
+    switch (format) {
+    case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+    case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+        return true;
+    case DXGI_FORMAT_R8G8B8A8_UNORM:
+    case DXGI_FORMAT_B8G8R8A8_UNORM:
+        return options.forceSRGB;
+    default:
+        // float formats are linear already
+        return false;
+    }
+}
+
+// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic,cppcoreguidelines-pro-type-reinterpret-cast)
+void PGMipGenerator::readImage(const DirectX::Image& image, const bool& srgb, const bool& multiThread, Level& level)
+{
+    level.width = image.width;
+    level.height = image.height;
+    level.texels.resize(image.width * image.height);
+
+    const auto& table8 = getUNorm8Table(srgb);
+    const auto& linear8 = getUNorm8Table(false);
+    const bool bgra = image.format == DXGI_FORMAT_B8G8R8A8_UNORM || image.format == DXGI_FORMAT_B8G8R8A8_UNORM_SRGB;
+
+    forEachRows(image.height, multiThread, [&](const size_t& rowStart, const size_t& rowEnd) {
+        for (size_t y = rowStart; y < rowEnd; ++y) {
+            const auto* row = image.pixels + (y * image.rowPitch);
+            auto* out = level.texels.data() + (y * image.width);
+
+            switch (image.format) {
+            case DXGI_FORMAT_R8G8B8A8_UNORM:
+            case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+            case DXGI_FORMAT_B8G8R8A8_UNORM:
+            case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+                for (size_t x = 0; x < image.width; ++x) {
+                    const auto* px = row + (x * 4);
+                    const auto r = px[bgra ? 2 : 0];
+                    const auto b = px[bgra ? 0 : 2];
+                    out[x] = { table8[r], table8[px[1]], table8[b], linear8[px[3]] };
+                }
+                break;
+            case DXGI_FORMAT_R16G16B16A16_FLOAT: {
+                const auto* halves = reinterpret_cast<const uint16_t*>(row);
+                for (size_t x = 0; x < image.width; ++x) {
+                    for (size_t c = 0; c < 4; ++c) {
+                        out[x][c] = halfToFloat(halves[(x * 4) + c]);
+                    }
+                }
+                break;
+            }
+            case DXGI_FORMAT_R32G32B32A32_FLOAT:
+                memcpy(out, row, image.width * sizeof(Texel));
+                break;
+            default:
+                break;
+            }
+        }
+    });
+}
+
+void PGMipGenerator::writeImage(
+    const Level& level, const bool& srgb, const bool& multiThread, const DirectX::Image& image)
+{
+    const bool bgra = image.format == DXGI_FORMAT_B8G8R8A8_UNORM || image.format == DXGI_FORMAT_B8G8R8A8_UNORM_SRGB;
+
+    forEachRows(image.height, multiThread, [&](const size_t& rowStart, const size_t& rowEnd) {
+        for (size_t y = rowStart; y < rowEnd; ++y) {
+            auto* row = image.pixels + (y * image.rowPitch);
+            const auto* in = level.texels.data() + (y * level.width);
+
+            switch (image.format) {
+            case DXGI_FORMAT_R8G8B8A8_UNORM:
+            case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+            case DXGI_FORMAT_B8G8R8A8_UNORM:
+            case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+                for (size_t x = 0; x < image.width; ++x) {
+                    auto* px = row + (x * 4);
+                    const auto& texel = in[x];
+                    const auto r = srgb ? linearToSRGB(clamp(texel[0], 0.0F, 1.0F)) : texel[0];
+                    const auto g = srgb ? linearToSRGB(clamp(texel[1], 0.0F, 1.0F)) : texel[1];
+                    const auto b = srgb ? linearToSRGB(clamp(texel[2], 0.0F, 1.0F)) : texel[2];
+                    px[bgra ? 2 : 0] = toUNorm8(r);
+                    px[1] = toUNorm8(g);
+                    px[bgra ? 0 : 2] = toUNorm8(b);
+                    px[3] = toUNorm8(texel[3]);
+                }
+                break;
+            case DXGI_FORMAT_R16G16B16A16_FLOAT: {
+                auto* halves = reinterpret_cast<uint16_t*>(row);
+                for (size_t x = 0; x < image.width; ++x) {
+                    for (size_t c = 0; c < 4; ++c) {
+                        // kaiser lobes ring below zero next to bright texels
+                        halves[(x * 4) + c] = floatToHalf(max(in[x][c], 0.0F));
+                    }
+                }
+                break;
+            }
+            case DXGI_FORMAT_R32G32B32A32_FLOAT: {
+                auto* floats = reinterpret_cast<float*>(row);
+                for (size_t x = 0; x < image.width; ++x) {
+                    for (size_t c = 0; c < 4; ++c) {
+                        floats[(x * 4) + c] = max(in[x][c], 0.0F);
+                    }
+                }
+                break;
+            }
+            default:
+                break;
+            }
+        }
+    });
+}
+// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic,cppcoreguidelines-pro-type-reinterpret-cast)
+
+void PGMipGenerator::downsample(const Level& src, Level& dst, const Options& options)
+{
+    dst.width = max<size_t>(src.width / 2, 1);
+    dst.height = max<size_t>(src.height / 2, 1);
+    dst.texels.assign(dst.width * dst.height, Texel {});
+
+    if (options.filter == Filter::BOX) {
+        forEachRows(dst.height, options.multiThread,
+            [&](const size_t& rowStart, const size_t& rowEnd) { downsampleBox(src, dst, rowStart, rowEnd); });
+        return;
+    }
+
+    vector<vector<size_t>> tapsX;
+    vector<vector<float>> weightsX;
+    buildKaiserTaps(src.width, dst.width, options.wrap, tapsX, weightsX);
+
+    vector<vector<size_t>> tapsY;
+    vector<vector<float>> weightsY;
+    buildKaiserTaps(src.height, dst.height, options.wrap, tapsY, weightsY);
+
+    // horizontal pass over every source row
+    vector<Texel> horizontal(dst.width * src.height);
+    forEachRows(src.height, options.multiThread, [&](const size_t& rowStart, const size_t& rowEnd) {
+        for (size_t y = rowStart; y < rowEnd; ++y) {
+            const auto* srcRow = &src.texels[y * src.width];
+            auto* outRow = &horizontal[y * dst.width];
+            for (size_t x = 0; x < dst.width; ++x) {
+                Texel acc {};
+                const auto& taps = tapsX[x];
+                const auto& weights = weightsX[x];
+                for (size_t t = 0; t < taps.size(); ++t) {
+                    const auto& texel = srcRow[taps[t]]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                    for (size_t c = 0; c < 4; ++c) {
+                        acc[c] += texel[c] * weights[t];
+                    }
+                }
+                outRow[x] = acc; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            }
+        }
+    });
+
+    // vertical pass accumulates whole rows so the inner loop runs over contiguous texels
+    forEachRows(dst.height, options.multiThread, [&](const size_t& rowStart, const size_t& rowEnd) {
+        for (size_t y = rowStart; y < rowEnd; ++y) {
+            auto* outRow = &dst.texels[y * dst.width];
+            const auto& taps = tapsY[y];
+            const auto& weights = weightsY[y];
+            for (size_t t = 0; t < taps.size(); ++t) {
+                const auto* inRow = &horizontal[taps[t] * dst.width];
+                const auto weight = weights[t];
+                for (size_t x = 0; x < dst.width; ++x) {
+                    for (size_t c = 0; c < 4; ++c) {
+                        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                        outRow[x][c] += inRow[x][c] * weight;
+                    }
+                }
+            }
+        }
+    });
+}
+
+void PGMipGenerator::downsampleBox(const Level& src, Level& dst, const size_t& rowStart, const size_t& rowEnd)
+{
+    // a source axis of 1 texel is sampled twice
+    const size_t stepX = src.width > 1 ? 1 : 0;
+    const size_t stepY = src.height > 1 ? 1 : 0;
+    const size_t scaleX = src.width > 1 ? 2 : 1;
+    const size_t scaleY = src.height > 1 ? 2 : 1;
+
+    for (size_t y = rowStart; y < rowEnd; ++y) {
+        const auto* row0 = &src.texels[y * scaleY * src.width];
+        const auto* row1 = &src.texels[((y * scaleY) + stepY) * src.width];
+        auto* outRow = &dst.texels[y * dst.width];
+
+        // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        for (size_t x = 0; x < dst.width; ++x) {
+            const auto x0 = x * scaleX;
+            const auto x1 = x0 + stepX;
+            for (size_t c = 0; c < 4; ++c) {
+                outRow[x][c] = (row0[x0][c] + row0[x1][c] + row1[x0][c] + row1[x1][c]) * BOX_WEIGHT;
+            }
+        }
+        // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+}
+
+void PGMipGenerator::buildKaiserTaps(const size_t& srcSize, const size_t& dstSize, const bool& wrap,
+    vector<vector<size_t>>& taps, vector<vector<float>>& weights)
+{
+    taps.assign(dstSize, {});
+    weights.assign(dstSize, {});
+
+    if (srcSize == dstSize) {
+        // axis already at 1 texel
+        for (size_t i = 0; i < dstSize; ++i) {
+            taps[i] = { i };
+            weights[i] = { 1.0F };
+        }
+        return;
+    }
+
+    const auto scale = static_cast<float>(srcSize) / static_cast<float>(dstSize);
+    const auto window = besselI0(KAISER_ALPHA);
+    const auto srcInt = static_cast<int64_t>(srcSize);
+
+    for (size_t d = 0; d < dstSize; ++d) {
+        // filter runs in destination units, centered on the destination texel
+        const auto center = (static_cast<float>(d) + 0.5F) * scale;
+        const auto first = static_cast<int64_t>(floor(center - (KAISER_WIDTH * scale)));
+        const auto last = static_cast<int64_t>(ceil(center + (KAISER_WIDTH * scale)));
+
+        float total = 0.0F;
+        for (auto s = first; s <= last; ++s) {
+            const auto t = ((static_cast<float>(s) + 0.5F) - center) / scale;
+            const auto x = t / KAISER_WIDTH;
+            if (abs(x) >= 1.0F) {
+                continue;
+            }
+
+            const auto weight = sinc(t) * besselI0(KAISER_ALPHA * sqrt(1.0F - (x * x))) / window;
+
+            int64_t index = s;
+            if (wrap) {
+                index = ((s % srcInt) + srcInt) % srcInt;
+            } else {
+                index = clamp<int64_t>(s, 0, srcInt - 1);
+            }
+
+            // clamped taps land on the same edge texel, merge them
+            auto& dstTaps = taps[d];
+            auto& dstWeights = weights[d];
+            const auto existing = find(dstTaps.begin(), dstTaps.end(), static_cast<size_t>(index));
+            if (existing != dstTaps.end()) {
+                dstWeights[static_cast<size_t>(existing - dstTaps.begin())] += weight;
+            } else {
+                dstTaps.push_back(static_cast<size_t>(index));
+                dstWeights.push_back(weight);
+            }
+            total += weight;
+        }
+
+        for (auto& weight : weights[d]) {
+            weight /= total;
+        }
+    }
+}
+
+auto PGMipGenerator::getAlphaCoverage(const Level& level, const float& ref, const float& scale) -> float
+{
+    if (level.texels.empty()) {
+        return 0.0F;
+    }
+
+    size_t covered = 0;
+    for (const auto& texel : level.texels) {
+        if (min(texel[3] * scale, 1.0F) > ref) {
+            covered++;
+        }
+    }
+
+    return static_cast<float>(covered) / static_cast<float>(level.texels.size());
+}
+
+void PGMipGenerator::scaleAlphaToCoverage(Level& level, const float& ref, const float& targetCoverage)
+{
+    // coverage only grows with the scale, binary search the closest one
+    float low = 0.0F;
+    float high = COVERAGE_MAX_SCALE;
+    float bestScale = 1.0F;
+    float bestError = abs(getAlphaCoverage(level, ref, 1.0F) - targetCoverage);
+
+    for (size_t i = 0; i < COVERAGE_SEARCH_STEPS; ++i) {
+        const auto mid = (low + high) / 2.0F;
+        const auto coverage = getAlphaCoverage(level, ref, mid);
+        const auto error = abs(coverage - targetCoverage);
+        if (error < bestError) {
+            bestError = error;
+            bestScale = mid;
+        }
+
+        if (coverage < targetCoverage) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+
+    for (auto& texel : level.texels) {
+        texel[3] = min(texel[3] * bestScale, 1.0F);
+    }
+}
@@ -0,0 +1,433 @@
+#include "PGNIFSplicer.hpp"
+
+#include "PGGeometry.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <ios>
+#include <sstream>
+#include <utility>
+
+using namespace std;
+using namespace nifly;
+
+namespace {
+/// @brief Bounds checked reader for the little endian NIF header, all targets are little endian
+class ByteReader {
+private:
+    span<const std::byte> m_bytes;
+    size_t m_pos = 0;
+
+public:
+    explicit ByteReader(span<const std::byte> bytes)
+        : m_bytes(bytes)
+    {
+    }
+
+    [[nodiscard]] auto getPos() const -> size_t { return m_pos; }
+
+    [[nodiscard]] auto getRemaining() const -> size_t { return m_bytes.size() - m_pos; }
+
+    template <typename T> auto read(T& value) -> bool
+    {
+        if (getRemaining() < sizeof(T)) {
+            return false;
+        }
+
+        memcpy(&value, m_bytes.subspan(m_pos).data(), sizeof(T));
+        m_pos += sizeof(T);
+        return true;
+    }
+
+    auto skip(const size_t& size) -> bool
+    {
+        if (getRemaining() < size) {
+            return false;
+        }
+
+        m_pos += size;
+        return true;
+    }
+
+    auto skipLine() -> bool
+    {
+        const auto remaining = m_bytes.subspan(m_pos);
+        const auto it = ranges::find(remaining, static_cast<std::byte>('\n'));
+        if (it == remaining.end()) {
+            return false;
+        }
+
+        m_pos += static_cast<size_t>(it - remaining.begin()) + 1;
+        return true;
+    }
+
+    /// @brief String with a 32 bit length
+    auto readString(string& str) -> bool
+    {
+        uint32_t length = 0;
+        if (!read(length) || getRemaining() < length) {
+            return false;
+        }
+
+        const auto chars = m_bytes.subspan(m_pos, length);
+        str.assign(reinterpret_cast<const char*>(chars.data()), // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+            chars.size());
+        m_pos += length;
+        return true;
+    }
+
+    /// @brief String with an 8 bit length, used by the export info
+    auto skipShortString() -> bool
+    {
+        uint8_t length = 0;
+        return read(length) && skip(length);
+    }
+};
+
+template <typename T> void appendValue(vector<std::byte>& out, const T& value)
+{
+    const auto offset = out.size();
+    out.resize(offset + sizeof(T));
+    memcpy(&out[offset], &value, sizeof(T));
+}
+
+void appendBytes(vector<std::byte>& out, span<const std::byte> bytes)
+{
+    out.insert(out.end(), bytes.begin(), bytes.end());
+}
+
+void appendString(vector<std::byte>& out, const string& str)
+{
+    appendValue(out, static_cast<uint32_t>(str.size()));
+    appendBytes(out, as_bytes(span(str)));
+}
+
+template <typename T> auto hashVector(const vector<T>* data, uint64_t hash) -> uint64_t
+{
+    // missing and empty arrays hash differently, so a shape that gains an empty array is caught
+    const size_t size = data == nullptr ? SIZE_MAX : data->size();
+    hash = PGGeometry::hashBytes(&size, sizeof(size), hash);
+    if (data == nullptr) {
+        return hash;
+    }
+
+    return PGGeometry::hashBytes(data->data(), data->size() * sizeof(T), hash);
+}
+
+template <typename T> auto getRefIndex(const NiBlockRef<T>* ref) -> uint32_t
+{
+    return ref == nullptr ? NIF_NPOS : ref->GetIndex();
+}
+} // namespace
+
+auto PGNIFSplicer::parseLayout(span<const std::byte> nifBytes) -> optional<Layout>
+{
+    ByteReader reader(nifBytes);
+    Layout layout;
+
+    uint32_t version = 0;
+    uint8_t endian = 0;
+    uint32_t userVersion = 0;
+    uint32_t numBlocks = 0;
+    uint32_t streamVersion = 0;
+    if (!reader.skipLine() || !reader.read(version) || version != SUPPORTED_VERSION || !reader.read(endian)
+        || endian != 1 || !reader.read(userVersion) || userVersion != SUPPORTED_USER_VERSION
+        || !reader.read(numBlocks) || !reader.read(streamVersion) || streamVersion > MAX_STREAM_VERSION) {
+        return nullopt;
+    }
+
+    // author, process script and export script
+    static constexpr size_t NUM_EXPORT_STRINGS = 3;
+    for (size_t i = 0; i < NUM_EXPORT_STRINGS; ++i) {
+        if (!reader.skipShortString()) {
+            return nullopt;
+        }
+    }
+
+    uint16_t numBlockTypes = 0;
+    if (!reader.read(numBlockTypes)) {
+        return nullopt;
+    }
+    vector<string> blockTypeNames(numBlockTypes);
+    for (auto& blockTypeName : blockTypeNames) {
+        if (!reader.readString(blockTypeName)) {
+            return nullopt;
+        }
+    }
+
+    // every block has a type index and a size, checked before anything is allocated per block
+    if (numBlocks > reader.getRemaining() / (sizeof(uint16_t) + sizeof(uint32_t))) {
+        return nullopt;
+    }
+
+    // the high bit marks PhysX blocks
+    static constexpr uint16_t BLOCK_TYPE_MASK = 0x7FFF;
+    layout.blockTypes.reserve(numBlocks);
+    for (uint32_t i = 0; i < numBlocks; ++i) {
+        uint16_t blockType = 0;
+        if (!reader.read(blockType) || (blockType & BLOCK_TYPE_MASK) >= numBlockTypes) {
+            return nullopt;
+        }
+        layout.blockTypes.push_back(blockTypeNames[blockType & BLOCK_TYPE_MASK]);
+    }
+
+    layout.blockSizesOffset = reader.getPos();
+    vector<uint32_t> blockSizes(numBlocks);
+    for (auto& blockSize : blockSizes) {
+        if (!reader.read(blockSize)) {
+            return nullopt;
+        }
+    }
+
+    layout.stringsOffset = reader.getPos();
+    uint32_t numStrings = 0;
+    uint32_t maxStringLength = 0;
+    if (!reader.read(numStrings) || !reader.read(maxStringLength)
+        || numStrings > reader.getRemaining() / sizeof(uint32_t)) {
+        return nullopt;
+    }
+    layout.strings.resize(numStrings);
+    for (auto& str : layout.strings) {
+        if (!reader.readString(str)) {
+            return nullopt;
+        }
+    }
+
+    layout.groupsOffset = reader.getPos();
+    uint32_t numGroups = 0;
+    if (!reader.read(numGroups) || !reader.skip(static_cast<size_t>(numGroups) * sizeof(uint32_t))) {
+        return nullopt;
+    }
+
+    // blocks follow the header back to back
+    layout.blockOffsets.reserve(static_cast<size_t>(numBlocks) + 1);
+    for (const auto& blockSize : blockSizes) {
+        layout.blockOffsets.push_back(reader.getPos());
+        if (!reader.skip(blockSize)) {
+            return nullopt;
+        }
+    }
+    layout.blockOffsets.push_back(reader.getPos());
+
+    // the footer has to end the file, otherwise the sizes do not describe this file
+    uint32_t numRoots = 0;
+    if (!reader.read(numRoots) || !reader.skip(static_cast<size_t>(numRoots) * sizeof(uint32_t))
+        || reader.getRemaining() != 0) {
+        return nullopt;
+    }
+
+    return layout;
+}
+
+void PGNIFSplicer::capture(NifFile& nif, span<const std::byte> nifBytes)
+{
+    reset();
+
+    auto layout = parseLayout(nifBytes);
+    if (!layout.has_value()) {
+        return;
+    }
+
+    // nifly has to see the same blocks as the layout, unknown blocks are not read by type
+    auto& hdr = nif.GetHeader();
+    if (hdr.GetNumBlocks() != layout->blockTypes.size()) {
+        return;
+    }
+
+    vector<NiObject*> blocks;
+    blocks.reserve(layout->blockTypes.size());
+    for (uint32_t i = 0; i < hdr.GetNumBlocks(); ++i) {
+        auto* block = hdr.GetBlock<NiObject>(i);
+        if (block == nullptr || layout->blockTypes[i] != block->GetBlockName()) {
+            return;
+        }
+        blocks.push_back(block);
+    }
+
+    m_original = nifBytes;
+    m_layout = std::move(layout);
+    m_blocks = std::move(blocks);
+    m_shapeFingerprints = getShapeFingerprints(nif);
+}
+
+auto PGNIFSplicer::canSplice(NifFile& nif) const -> bool
+{
+    if (!isCaptured()) {
+        return false;
+    }
+
+    auto& hdr = nif.GetHeader();
+    if (hdr.GetNumBlocks() != m_blocks.size()) {
+        return false;
+    }
+    for (uint32_t i = 0; i < hdr.GetNumBlocks(); ++i) {
+        if (hdr.GetBlock<NiObject>(i) != m_blocks[i]) {
+            return false;
+        }
+    }
+
+    // copied blocks keep their string indices, so the original table has to be unchanged
+    const auto& strings = m_layout->strings;
+    if (hdr.GetStringCount() < strings.size()) {
+        return false;
+    }
+    for (uint32_t i = 0; i < strings.size(); ++i) {
+        if (hdr.GetStringById(i) != strings[i]) {
+            return false;
+        }
+    }
+
+    return getShapeFingerprints(nif) == m_shapeFingerprints;
+}
+
+auto PGNIFSplicer::save(NifFile& nif) const -> vector<std::byte>
+{
+    if (!isCaptured()) {
+        return {};
+    }
+
+    // blocks are looked up again, the NIF may be a copy of the one that was checked
+    const auto& layout = *m_layout;
+    auto& hdr = nif.GetHeader();
+    const size_t numBlocks = hdr.GetNumBlocks();
+    if (numBlocks != layout.blockTypes.size()) {
+        return {};
+    }
+
+    const auto getOriginalBlock = [&](const size_t& blockID) {
+        return m_original.subspan(
+            layout.blockOffsets[blockID], layout.blockOffsets[blockID + 1] - layout.blockOffsets[blockID]);
+    };
+
+    // reserialize blocks that may have been patched, blocks that come out the same keep their original bytes
+    vector<optional<string>> newBlocks(numBlocks);
+    for (uint32_t i = 0; i < numBlocks; ++i) {
+        auto* block = hdr.GetBlock<NiObject>(i);
+        if (block == nullptr || layout.blockTypes[i] != block->GetBlockName()) {
+            return {};
+        }
+        if (isGeometryBlock(block)) {
+            continue;
+        }
+
+        // unchanged strings keep their index, changed ones are found or appended
+        vector<NiStringRef*> stringRefs;
+        block->GetStringRefs(stringRefs);
+        for (auto* stringRef : stringRefs) {
+            const auto& str = stringRef->get();
+            if (hdr.GetStringById(stringRef->GetIndex()) != str) {
+                stringRef->SetIndex(str.empty() ? NIF_NPOS : hdr.AddOrFindStringId(str));
+            }
+        }
+
+        ostringstream blockStream(ios::binary);
+        NiOStream stream(&blockStream, &hdr);
+        block->Put(stream);
+        auto blockData = std::move(blockStream).str();
+
+        const auto original = getOriginalBlock(i);
+        if (blockData.size() != original.size() || memcmp(blockData.data(), original.data(), original.size()) != 0) {
+            newBlocks[i] = std::move(blockData);
+        }
+    }
+
+    vector<std::byte> out;
+    out.reserve(m_original.size());
+
+    appendBytes(out, m_original.first(layout.blockSizesOffset));
+    for (size_t i = 0; i < numBlocks; ++i) {
+        const auto blockSize = newBlocks[i].has_value() ? newBlocks[i]->size() : getOriginalBlock(i).size();
+        appendValue(out, static_cast<uint32_t>(blockSize));
+    }
+    const auto blockSizesEnd = layout.blockSizesOffset + (numBlocks * sizeof(uint32_t));
+    appendBytes(out, m_original.subspan(blockSizesEnd, layout.stringsOffset - blockSizesEnd));
+
+    // string table is only rewritten if strings were appended
+    const auto numStrings = hdr.GetStringCount();
+    if (numStrings == layout.strings.size()) {
+        appendBytes(out, m_original.subspan(layout.stringsOffset, layout.groupsOffset - layout.stringsOffset));
+    } else {
+        vector<string> strings;
+        strings.reserve(numStrings);
+        size_t maxStringLength = 0;
+        for (uint32_t i = 0; i < numStrings; ++i) {
+            strings.push_back(hdr.GetStringById(i));
+            maxStringLength = max(maxStringLength, strings.back().size());
+        }
+
+        appendValue(out, static_cast<uint32_t>(numStrings));
+        appendValue(out, static_cast<uint32_t>(maxStringLength));
+        for (const auto& str : strings) {
+            appendString(out, str);
+        }
+    }
+
+    appendBytes(out, m_original.subspan(layout.groupsOffset, layout.blockOffsets.front() - layout.groupsOffset));
+    for (size_t i = 0; i < numBlocks; ++i) {
+        if (newBlocks[i].has_value()) {
+            appendBytes(out, as_bytes(span(*newBlocks[i])));
+        } else {
+            appendBytes(out, getOriginalBlock(i));
+        }
+    }
+    appendBytes(out, m_original.subspan(layout.blockOffsets.back()));
+
+    return out;
+}
+
+void PGNIFSplicer::reset()
+{
+    m_original = {};
+    m_layout.reset();
+    m_blocks.clear();
+    m_shapeFingerprints.clear();
+}
+
+auto PGNIFSplicer::isCaptured() const -> bool { return m_layout.has_value(); }
+
+auto PGNIFSplicer::isGeometryBlock(NiObject* block) -> bool
+{
+    // the large blocks, copied as they are once the fingerprints match
+    return dynamic_cast<NiShape*>(block) != nullptr || dynamic_cast<NiGeometryData*>(block) != nullptr
+        || dynamic_cast<NiSkinData*>(block) != nullptr || dynamic_cast<NiSkinPartition*>(block) != nullptr;
+}
+
+auto PGNIFSplicer::getShapeFingerprint(NifFile& nif, NiShape* shape) -> uint64_t
+{
+    static constexpr uint64_t HASH_SEED = 14695981039346656037ULL;
+
+    // everything a patcher can change on a copied shape block
+    const auto& name = shape->name.get();
+    auto hash = PGGeometry::hashBytes(name.data(), name.size(), HASH_SEED);
+    hash = PGGeometry::hashBytes(&shape->flags, sizeof(shape->flags), hash);
+    hash = PGGeometry::hashBytes(&shape->transform, sizeof(shape->transform), hash);
+
+    const array<uint32_t, 4> refs = { getRefIndex(shape->DataRef()), getRefIndex(shape->SkinInstanceRef()),
+        getRefIndex(shape->ShaderPropertyRef()), getRefIndex(shape->AlphaPropertyRef()) };
+    hash = PGGeometry::hashBytes(refs.data(), refs.size() * sizeof(uint32_t), hash);
+
+    const array<bool, 5> hasData
+        = { shape->HasVertexColors(), shape->HasNormals(), shape->HasTangents(), shape->HasUVs(), shape->IsSkinned() };
+    hash = PGGeometry::hashBytes(hasData.data(), hasData.size() * sizeof(bool), hash);
+
+    hash = hashVector(nif.GetVertsForShape(shape), hash);
+    hash = hashVector(nif.GetNormalsForShape(shape), hash);
+    hash = hashVector(nif.GetTangentsForShape(shape), hash);
+    hash = hashVector(nif.GetBitangentsForShape(shape), hash);
+    hash = hashVector(nif.GetUvsForShape(shape), hash);
+    hash = hashVector(nif.GetColorsForShape(shape), hash);
+
+    vector<Triangle> tris;
+    shape->GetTriangles(tris);
+    return hashVector(&tris, hash);
+}
+
+auto PGNIFSplicer::getShapeFingerprints(NifFile& nif) -> vector<uint64_t>
+{
+    vector<uint64_t> fingerprints;
+    for (auto* shape : nif.GetShapes()) {
+        fingerprints.push_back(shape == nullptr ? 0 : getShapeFingerprint(nif, shape));
+    }
+    return fingerprints;
+}
@@ -0,0 +1,156 @@
+#include "PGOutputStore.hpp"
+#include "Logger.hpp"
+#include "PGPlatform.hpp"
+#include "ParallaxGenUtil.hpp"
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+
+using namespace std;
+using namespace ParallaxGenUtil;
+
+PGOutputStore::PGOutputStore(filesystem::path outputDir, const bool& useHardLinks)
+    : m_outputDir(std::move(outputDir))
+    , m_useHardLinks(useHardLinks)
+{
+}
+
+auto PGOutputStore::write(const filesystem::path& relPath, span<const byte> data) -> WriteResult
+{
+    const ContentKey key = { .hash = getContentHash(data), .size = data.size() };
+    const auto outPath = m_outputDir / relPath;
+
+    error_code ec;
+    filesystem::create_directories(outPath.parent_path(), ec);
+
+    auto& shard = m_shards[key.hash % NUM_SHARDS];
+    const lock_guard<mutex> lock(shard.mutex);
+
+    auto& candidates = shard.contents[key];
+    for (const auto& contentPath : candidates) {
+        if (contentPath == relPath || !isSameContent(m_outputDir / contentPath, data)) {
+            // a hash collision or the same path written twice, neither can share storage
+            continue;
+        }
+
+        auto result = WriteResult::COPIED;
+        if (m_useHardLinks.load()) {
+            filesystem::remove(outPath, ec);
+            if (createHardLink(m_outputDir / contentPath, outPath)) {
+                result = WriteResult::LINKED;
+            } else {
+                // FAT32, exFAT and network shares commonly refuse links, stop trying after the first failure
+                Logger::debug(L"Unable to create hardlinks in {}, duplicate output files will be copied",
+                    m_outputDir.wstring());
+                m_useHardLinks.store(false);
+            }
+        }
+
+        if (result == WriteResult::COPIED && !writeFile(outPath, data)) {
+            return WriteResult::FAILED;
+        }
+
+        m_numDeduplicated++;
+        m_bytesDeduplicated += data.size();
+        addManifestEntry(relPath, { .hash = key.hash, .size = key.size, .contentPath = contentPath });
+        return result;
+    }
+
+    if (!writeFile(outPath, data)) {
+        return WriteResult::FAILED;
+    }
+
+    if (find(candidates.begin(), candidates.end(), relPath) == candidates.end()) {
+        candidates.push_back(relPath);
+    }
+    addManifestEntry(relPath, { .hash = key.hash, .size = key.size, .contentPath = relPath });
+    return WriteResult::WRITTEN;
+}
+
+auto PGOutputStore::writeManifest(const filesystem::path& manifestPath) const -> bool
+{
+    nlohmann::json json = nlohmann::json::object();
+    for (const auto& [relPath, entry] : getManifest()) {
+        json[utf16toUTF8(relPath.wstring())] = { { "content", fmt::format("{:016x}-{}", entry.hash, entry.size) },
+            { "path", utf16toUTF8(entry.contentPath.wstring()) } };
+    }
+
+    ofstream f(manifestPath);
+    if (!f.is_open()) {
+        return false;
+    }
+
+    f << json.dump(2, ' ', false, nlohmann::detail::error_handler_t::replace) << "\n";
+    return f.good();
+}
+
+auto PGOutputStore::getManifest() const -> map<filesystem::path, ManifestEntry>
+{
+    const lock_guard<mutex> lock(m_manifestMutex);
+    return m_manifest;
+}
+
+auto PGOutputStore::getNumDeduplicated() const -> size_t { return m_numDeduplicated.load(); }
+
+auto PGOutputStore::getBytesDeduplicated() const -> uint64_t { return m_bytesDeduplicated.load(); }
+
+auto PGOutputStore::getContentHash(span<const byte> data) -> uint64_t
+{
+    static constexpr uint64_t FNV_OFFSET = 14695981039346656037ULL;
+    static constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+
+    uint64_t hash = FNV_OFFSET;
+    for (const auto& b : data) {
+        hash = (hash ^ static_cast<uint64_t>(b)) * FNV_PRIME;
+    }
+
+    return hash;
+}
+
+auto PGOutputStore::getManifestName() -> filesystem::path { return "ParallaxGen_Content.json"; }
+
+auto PGOutputStore::createHardLink(const filesystem::path& target, const filesystem::path& link) -> bool
+{
+    error_code ec;
+    filesystem::create_hard_link(target, link, ec);
+    return !ec;
+}
+
+auto PGOutputStore::writeFile(const filesystem::path& filePath, span<const byte> data) -> bool
+{
+    // replace instead of truncating, the old file may be a link that other paths still share
+    error_code ec;
+    filesystem::remove(filePath, ec);
+
+    ofstream f(filePath, ios::binary);
+    if (!f.is_open()) {
+        return false;
+    }
+
+    f.write(reinterpret_cast<const char*>(data.data()), // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        static_cast<streamsize>(data.size()));
+    return f.good();
+}
+
+auto PGOutputStore::isSameContent(const filesystem::path& filePath, span<const byte> data) -> bool
+{
+    const PGPlatform::MappedFile file(filePath);
+    if (!file.isOpen()) {
+        return false;
+    }
+
+    const auto fileData = file.getData();
+    return fileData.size() == data.size()
+        && (data.empty() || memcmp(fileData.data(), data.data(), data.size()) == 0);
+}
+
+void PGOutputStore::addManifestEntry(const filesystem::path& relPath, const ManifestEntry& entry)
+{
+    const lock_guard<mutex> lock(m_manifestMutex);
+    m_manifest[relPath] = entry;
+}
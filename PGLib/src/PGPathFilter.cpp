@@ -0,0 +1,198 @@
+#include "PGPathFilter.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <type_traits>
+
+using namespace std;
+
+namespace {
+using CharType = filesystem::path::value_type;
+using StringType = filesystem::path::string_type;
+
+constexpr uint32_t END_OF_PATH = 0xFFFFFFFFU;
+constexpr uint32_t ASCII_MAX = 127;
+
+constexpr auto toCode(const CharType& c) -> uint32_t { return static_cast<make_unsigned_t<CharType>>(c); }
+
+constexpr auto isSeparator(const uint32_t& c) -> bool
+{
+    return c == static_cast<uint32_t>('/') || c == static_cast<uint32_t>(filesystem::path::preferred_separator);
+}
+
+/// @brief Next character of a path, lowercased and with runs of separators read as one preferred separator
+auto nextChar(const StringType& str, size_t& pos) -> uint32_t
+{
+    if (pos >= str.size()) {
+        return END_OF_PATH;
+    }
+
+    auto c = toCode(str[pos++]);
+    if (isSeparator(c)) {
+        while (pos < str.size() && isSeparator(toCode(str[pos]))) {
+            pos++;
+        }
+        return static_cast<uint32_t>(filesystem::path::preferred_separator);
+    }
+
+    if (c >= 'A' && c <= 'Z') {
+        c += 'a' - 'A';
+    }
+
+    return c;
+}
+
+auto mixHash(uint64_t hash) -> uint64_t
+{
+    // splitmix64 finalizer
+    static constexpr uint64_t MIX_1 = 0xBF58476D1CE4E5B9ULL;
+    static constexpr uint64_t MIX_2 = 0x94D049BB133111EBULL;
+    static constexpr unsigned SHIFT_1 = 30;
+    static constexpr unsigned SHIFT_2 = 27;
+    static constexpr unsigned SHIFT_3 = 31;
+
+    hash = (hash ^ (hash >> SHIFT_1)) * MIX_1;
+    hash = (hash ^ (hash >> SHIFT_2)) * MIX_2;
+    return hash ^ (hash >> SHIFT_3);
+}
+} // namespace
+
+void PGPathFilter::build(const vector<const filesystem::path*>& paths)
+{
+    clear();
+
+    const size_t numBlocks
+        = bit_ceil(max<size_t>(1, ((paths.size() * BITS_PER_KEY) + BITS_PER_BLOCK - 1) / BITS_PER_BLOCK));
+    m_bloom = make_unique<atomic<uint64_t>[]>(numBlocks * WORDS_PER_BLOCK); // NOLINT(cppcoreguidelines-avoid-c-arrays)
+    m_blockMask = numBlocks - 1;
+
+    // at most half full so probe sequences stay short
+    m_slots.assign(bit_ceil(max<size_t>(2, paths.size() * 2)), Slot {});
+    m_slotMask = m_slots.size() - 1;
+
+    for (const auto* path : paths) {
+        uint64_t hash = 0;
+        if (!getHash(*path, hash)) {
+            // never answered by the filter
+            continue;
+        }
+
+        setBits(hash);
+
+        size_t slot = hash & m_slotMask;
+        while (m_slots[slot].key != nullptr) {
+            if (m_slots[slot].hash == hash && isEqual(*m_slots[slot].key, *path)) {
+                break;
+            }
+            slot = (slot + 1) & m_slotMask;
+        }
+        m_slots[slot] = { .hash = hash, .key = path };
+    }
+
+    m_built.store(true, memory_order_release);
+}
+
+void PGPathFilter::add(const filesystem::path& path)
+{
+    uint64_t hash = 0;
+    if (!isBuilt() || !getHash(path, hash)) {
+        return;
+    }
+
+    setBits(hash);
+}
+
+auto PGPathFilter::query(const filesystem::path& path) const -> Result
+{
+    uint64_t hash = 0;
+    if (!isBuilt() || !getHash(path, hash)) {
+        return Result::UNKNOWN;
+    }
+
+    if (!testBits(hash)) {
+        return Result::ABSENT;
+    }
+
+    for (size_t slot = hash & m_slotMask; m_slots[slot].key != nullptr; slot = (slot + 1) & m_slotMask) {
+        if (m_slots[slot].hash == hash && isEqual(*m_slots[slot].key, path)) {
+            return Result::PRESENT;
+        }
+    }
+
+    // false positive or added after the build
+    return Result::UNKNOWN;
+}
+
+void PGPathFilter::clear()
+{
+    m_built.store(false, memory_order_release);
+    m_bloom.reset();
+    m_blockMask = 0;
+    m_slots.clear();
+    m_slotMask = 0;
+}
+
+auto PGPathFilter::isBuilt() const -> bool { return m_built.load(memory_order_acquire); }
+
+auto PGPathFilter::getHash(const filesystem::path& path, uint64_t& hash) -> bool
+{
+    // FNV-1a over the normalized characters
+    static constexpr uint64_t FNV_OFFSET = 0xCBF29CE484222325ULL;
+    static constexpr uint64_t FNV_PRIME = 0x100000001B3ULL;
+
+    const auto& str = path.native();
+    uint64_t curHash = FNV_OFFSET;
+    size_t pos = 0;
+    for (auto c = nextChar(str, pos); c != END_OF_PATH; c = nextChar(str, pos)) {
+        if (c > ASCII_MAX) {
+            return false;
+        }
+        curHash = (curHash ^ c) * FNV_PRIME;
+    }
+
+    hash = mixHash(curHash);
+    return true;
+}
+
+auto PGPathFilter::isEqual(const filesystem::path& lhs, const filesystem::path& rhs) -> bool
+{
+    const auto& lhsStr = lhs.native();
+    const auto& rhsStr = rhs.native();
+    size_t lhsPos = 0;
+    size_t rhsPos = 0;
+    while (true) {
+        const auto lhsChar = nextChar(lhsStr, lhsPos);
+        if (lhsChar != nextChar(rhsStr, rhsPos)) {
+            return false;
+        }
+        if (lhsChar == END_OF_PATH) {
+            return true;
+        }
+    }
+}
+
+void PGPathFilter::setBits(const uint64_t& hash)
+{
+    auto* block = &m_bloom[(hash & m_blockMask) * WORDS_PER_BLOCK];
+    const auto probes = mixHash(hash);
+    for (unsigned i = 0; i < NUM_PROBES; ++i) {
+        const auto bit = (probes >> (i * PROBE_BITS)) & PROBE_MASK;
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        block[bit >> WORD_SHIFT].fetch_or(1ULL << (bit & BIT_MASK), memory_order_relaxed);
+    }
+}
+
+auto PGPathFilter::testBits(const uint64_t& hash) const -> bool
+{
+    const auto* block = &m_bloom[(hash & m_blockMask) * WORDS_PER_BLOCK];
+    const auto probes = mixHash(hash);
+    for (unsigned i = 0; i < NUM_PROBES; ++i) {
+        const auto bit = (probes >> (i * PROBE_BITS)) & PROBE_MASK;
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        if ((block[bit >> WORD_SHIFT].load(memory_order_relaxed) & (1ULL << (bit & BIT_MASK))) == 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
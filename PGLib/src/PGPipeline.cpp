@@ -0,0 +1,250 @@
+#include "PGPipeline.hpp"
+#include "PGMemoryBudget.hpp"
+#include "ParallaxGenRunner.hpp"
+
+#include <cpptrace/from_current.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+
+namespace {
+/**
+ * @class BoundedQueue
+ * @brief Blocking queue of item indices. push waits while full, pop waits while empty and not closed.
+ */
+class BoundedQueue {
+private:
+    size_t m_capacity;
+    deque<size_t> m_items;
+    bool m_closed = false;
+    bool m_aborted = false;
+    mutex m_mutex;
+    condition_variable m_notFull;
+    condition_variable m_notEmpty;
+
+public:
+    explicit BoundedQueue(const size_t& capacity)
+        : m_capacity(capacity)
+    {
+    }
+
+    /// @brief Returns false if the queue was aborted
+    auto push(const size_t& item) -> bool
+    {
+        unique_lock<mutex> lock(m_mutex);
+        m_notFull.wait(lock, [this] { return m_aborted || m_items.size() < m_capacity; });
+        if (m_aborted) {
+            return false;
+        }
+
+        m_items.push_back(item);
+        m_notEmpty.notify_one();
+        return true;
+    }
+
+    /// @brief Empty once the queue is closed and drained, or aborted
+    auto pop() -> optional<size_t>
+    {
+        unique_lock<mutex> lock(m_mutex);
+        m_notEmpty.wait(lock, [this] { return m_aborted || m_closed || !m_items.empty(); });
+        if (m_aborted || m_items.empty()) {
+            return nullopt;
+        }
+
+        const auto item = m_items.front();
+        m_items.pop_front();
+        m_notFull.notify_one();
+        return item;
+    }
+
+    /// @brief No more items will be pushed
+    void close()
+    {
+        const lock_guard<mutex> lock(m_mutex);
+        m_closed = true;
+        m_notEmpty.notify_all();
+    }
+
+    /// @brief Wake everyone and drop pending items, returns the dropped items
+    auto abort() -> deque<size_t>
+    {
+        const lock_guard<mutex> lock(m_mutex);
+        m_aborted = true;
+        auto dropped = std::move(m_items);
+        m_items.clear();
+        m_notFull.notify_all();
+        m_notEmpty.notify_all();
+        return dropped;
+    }
+};
+} // namespace
+
+PGPipeline::PGPipeline(vector<Stage> stages, const bool& multithread, DropFunc onDrop)
+    : m_stages(std::move(stages))
+    , m_multithread(multithread)
+    , m_onDrop(std::move(onDrop))
+{
+    if (m_stages.empty()) {
+        throw invalid_argument("PGPipeline needs at least one stage");
+    }
+
+    for (auto& stage : m_stages) {
+        stage.numThreads = max<size_t>(stage.numThreads, 1);
+        stage.queueCapacity = max<size_t>(stage.queueCapacity, 1);
+    }
+}
+
+void PGPipeline::run(const size_t& count)
+{
+    const auto drop = [this](const size_t& item) {
+        if (m_onDrop) {
+            m_onDrop(item);
+        }
+    };
+
+    if (!m_multithread) {
+        size_t item = 0;
+        CPPTRACE_TRY
+        {
+            for (; item < count; ++item) {
+                for (const auto& stage : m_stages) {
+                    if (!stage.func(item)) {
+                        break;
+                    }
+                }
+            }
+        }
+        CPPTRACE_CATCH(const exception& e)
+        {
+            drop(item);
+            ParallaxGenRunner::processException(e, cpptrace::from_current_exception().to_string());
+            throw runtime_error("PGRUNNERINTERNAL");
+        }
+
+        return;
+    }
+
+    // queues[i] feeds stage i, the first stage reads indices from next
+    vector<unique_ptr<BoundedQueue>> queues(m_stages.size());
+    for (size_t i = 1; i < m_stages.size(); ++i) {
+        queues[i] = make_unique<BoundedQueue>(m_stages[i].queueCapacity);
+    }
+
+    atomic<size_t> next = 0;
+    vector<unique_ptr<atomic<size_t>>> activeWorkers;
+    activeWorkers.reserve(m_stages.size());
+    for (const auto& stage : m_stages) {
+        activeWorkers.push_back(make_unique<atomic<size_t>>(stage.numThreads));
+    }
+
+    atomic<bool> exceptionThrown = false;
+    exception_ptr error;
+    string errorStackTrace;
+    mutex errorMutex;
+
+    // wakes every stage, queued items are dropped and read threads stop waiting for headroom
+    const auto abortAll = [&queues, &drop] {
+        for (const auto& queue : queues) {
+            if (queue != nullptr) {
+                for (const auto& item : queue->abort()) {
+                    drop(item);
+                }
+            }
+        }
+        PGMemoryBudget::notifyHeadroom();
+    };
+    const auto isAborted = [&exceptionThrown] { return exceptionThrown.load(); };
+
+    const auto workerMain = [&](const size_t& stageIndex) {
+        const auto& stage = m_stages[stageIndex];
+        auto* const input = queues[stageIndex].get();
+        auto* const output = stageIndex + 1 < queues.size() ? queues[stageIndex + 1].get() : nullptr;
+
+        // item this worker holds, dropped if it never reaches the next stage
+        optional<size_t> held;
+
+        CPPTRACE_TRY
+        {
+            while (!exceptionThrown.load()) {
+                size_t item = 0;
+                if (input == nullptr) {
+                    // Admission control: hold off reading new items while the memory budget is nearly exhausted
+                    PGMemoryBudget::waitForHeadroom(isAborted);
+                    if (exceptionThrown.load()) {
+                        break;
+                    }
+
+                    item = next.fetch_add(1);
+                    if (item >= count) {
+                        break;
+                    }
+                } else {
+                    const auto popped = input->pop();
+                    if (!popped.has_value()) {
+                        break;
+                    }
+                    item = *popped;
+                }
+
+                held = item;
+                if (stage.func(item) && output != nullptr && !output->push(item)) {
+                    // aborted while passing it on
+                    break;
+                }
+                held.reset();
+            }
+        }
+        CPPTRACE_CATCH(const exception&)
+        {
+            {
+                const lock_guard<mutex> lock(errorMutex);
+                if (!exceptionThrown.load()) {
+                    error = current_exception();
+                    errorStackTrace = cpptrace::from_current_exception().to_string();
+                    exceptionThrown.store(true);
+                }
+            }
+            abortAll();
+        }
+
+        if (held.has_value()) {
+            drop(*held);
+        }
+
+        // the last worker of a stage tells the next stage that nothing more is coming
+        if (activeWorkers[stageIndex]->fetch_sub(1) == 1 && output != nullptr) {
+            output->close();
+        }
+    };
+
+    vector<thread> threads;
+    for (size_t stageIndex = 0; stageIndex < m_stages.size(); ++stageIndex) {
+        for (size_t i = 0; i < m_stages[stageIndex].numThreads; ++i) {
+            threads.emplace_back(workerMain, stageIndex);
+        }
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (error) {
+        try {
+            rethrow_exception(error);
+        } catch (const exception& e) {
+            ParallaxGenRunner::processException(e, errorStackTrace);
+        }
+
+        throw runtime_error("PGRUNNERINTERNAL");
+    }
+}
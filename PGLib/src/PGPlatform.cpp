@@ -0,0 +1,367 @@
+#include "PGPlatform.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+
+#include <comdef.h>
+#include <d3d11.h>
+#include <shlobj.h>
+#include <shlwapi.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cwctype>
+#include <ios>
+#include <sstream>
+#endif
+
+#include <array>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace {
+#ifndef _WIN32
+auto getEnvPath(const char* name) -> filesystem::path
+{
+    const char* value = getenv(name); // NOLINT(concurrency-mt-unsafe)
+    if (value == nullptr || *value == '\0') {
+        return {};
+    }
+
+    return value;
+}
+
+auto globCharEquals(const wchar_t& a, const wchar_t& b) -> bool
+{
+    return a == b || towlower(static_cast<wint_t>(a)) == towlower(static_cast<wint_t>(b));
+}
+
+/// @brief Same semantics as PathMatchSpecW for a single pattern
+auto globMatchPortable(const wstring& str, const wstring& glob) -> bool
+{
+    // "*.*" matches everything, also names without a dot
+    if (glob == L"*.*") {
+        return true;
+    }
+
+    size_t s = 0;
+    size_t g = 0;
+    size_t starG = wstring::npos;
+    size_t starS = 0;
+
+    while (s < str.size()) {
+        if (g < glob.size() && glob[g] == L'*') {
+            // remember the star and try to match nothing first
+            starG = g++;
+            starS = s;
+        } else if (g < glob.size() && (glob[g] == L'?' || globCharEquals(glob[g], str[s]))) {
+            ++g;
+            ++s;
+        } else if (starG != wstring::npos) {
+            // let the last star swallow one more character
+            g = starG + 1;
+            s = ++starS;
+        } else {
+            return false;
+        }
+    }
+
+    // only stars may be left in the pattern
+    while (g < glob.size() && glob[g] == L'*') {
+        ++g;
+    }
+
+    return g == glob.size();
+}
+#endif
+} // namespace
+
+//
+// MappedFile
+//
+
+PGPlatform::MappedFile::MappedFile(const filesystem::path& filePath)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+
+    LARGE_INTEGER fileSize {};
+    if (GetFileSizeEx(file, &fileSize) == 0) {
+        CloseHandle(file);
+        return;
+    }
+
+    m_open = true;
+    if (fileSize.QuadPart == 0) {
+        // empty files cannot be mapped
+        CloseHandle(file);
+        return;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) {
+        m_open = false;
+        return;
+    }
+
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        CloseHandle(mapping);
+        m_open = false;
+        return;
+    }
+
+    m_mapping = mapping;
+    m_data = static_cast<const byte*>(view);
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    const int fd = open(filePath.c_str(), O_RDONLY | O_CLOEXEC); // NOLINT(cppcoreguidelines-pro-type-vararg)
+    if (fd < 0) {
+        return;
+    }
+
+    struct stat fileStat {};
+    if (fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode)) {
+        ::close(fd);
+        return;
+    }
+
+    m_open = true;
+    if (fileStat.st_size == 0) {
+        // empty files cannot be mapped
+        ::close(fd);
+        return;
+    }
+
+    const auto size = static_cast<size_t>(fileStat.st_size);
+    void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        m_open = false;
+        return;
+    }
+
+    m_data = static_cast<const byte*>(view);
+    m_size = size;
+#endif
+}
+
+PGPlatform::MappedFile::~MappedFile() { close(); }
+
+PGPlatform::MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr))
+    , m_size(std::exchange(other.m_size, 0))
+    , m_mapping(std::exchange(other.m_mapping, nullptr))
+    , m_open(std::exchange(other.m_open, false))
+{
+}
+
+auto PGPlatform::MappedFile::operator=(MappedFile&& other) noexcept -> MappedFile&
+{
+    if (this != &other) {
+        close();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_mapping = std::exchange(other.m_mapping, nullptr);
+        m_open = std::exchange(other.m_open, false);
+    }
+
+    return *this;
+}
+
+auto PGPlatform::MappedFile::isOpen() const -> bool { return m_open; }
+
+auto PGPlatform::MappedFile::getData() const -> span<const byte> { return { m_data, m_size }; }
+
+void PGPlatform::MappedFile::close()
+{
+#ifdef _WIN32
+    if (m_data != nullptr) {
+        UnmapViewOfFile(m_data);
+    }
+
+    if (m_mapping != nullptr) {
+        CloseHandle(m_mapping);
+    }
+#else
+    if (m_data != nullptr) {
+        munmap(const_cast<byte*>(m_data), m_size); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+    }
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+    m_mapping = nullptr;
+    m_open = false;
+}
+
+//
+// Services
+//
+
+auto PGPlatform::getKnownFolder(const KnownFolder& folder) -> filesystem::path
+{
+#ifdef _WIN32
+    const GUID& folderID = folder == KnownFolder::DOCUMENTS ? FOLDERID_Documents : FOLDERID_LocalAppData;
+
+    PWSTR path = nullptr;
+    const HRESULT result = SHGetKnownFolderPath(folderID, 0, nullptr, &path);
+    if (SUCCEEDED(result)) {
+        wstring outPath(path);
+        CoTaskMemFree(path); // Free the memory allocated for the path
+
+        return outPath;
+    }
+
+    // Handle error
+    return {};
+#else
+    // follow the XDG base directories
+    const auto home = getEnvPath("HOME");
+    if (folder == KnownFolder::DOCUMENTS) {
+        auto docs = getEnvPath("XDG_DOCUMENTS_DIR");
+        if (docs.empty() && !home.empty()) {
+            docs = home / "Documents";
+        }
+        return docs;
+    }
+
+    auto data = getEnvPath("XDG_DATA_HOME");
+    if (data.empty() && !home.empty()) {
+        data = home / ".local" / "share";
+    }
+    return data;
+#endif
+}
+
+auto PGPlatform::getExecutablePath() -> filesystem::path
+{
+#ifdef _WIN32
+    array<wchar_t, MAX_PATH> buffer {};
+    if (GetModuleFileNameW(nullptr, buffer.data(), MAX_PATH) == 0) {
+        return {};
+    }
+
+    return { buffer.data() };
+#else
+    error_code ec;
+    auto exePath = filesystem::read_symlink("/proc/self/exe", ec);
+    if (ec) {
+        return {};
+    }
+
+    return exePath;
+#endif
+}
+
+auto PGPlatform::getRegistryString(const RegistryRoot& root, const string& subKey, const string& valueName) -> string
+{
+#ifdef _WIN32
+    static constexpr DWORD REG_BUFFER_SIZE = 1024;
+
+    HKEY baseHKey = root == RegistryRoot::CURRENT_USER ? HKEY_CURRENT_USER : HKEY_LOCAL_MACHINE;
+
+    vector<char> data(REG_BUFFER_SIZE, '\0');
+    DWORD dataSize = REG_BUFFER_SIZE;
+
+    const LONG result
+        = RegGetValueA(baseHKey, subKey.c_str(), valueName.c_str(), RRF_RT_REG_SZ, nullptr, data.data(), &dataSize);
+    if (result == ERROR_SUCCESS) {
+        return { data.data() };
+    }
+
+    return {};
+#else
+    // no registry
+    (void)root;
+    (void)subKey;
+    (void)valueName;
+    return {};
+#endif
+}
+
+auto PGPlatform::globMatch(const wstring& str, const wstring& glob) -> bool
+{
+#ifdef _WIN32
+    return PathMatchSpecW(str.c_str(), glob.c_str()) != 0;
+#else
+    return globMatchPortable(str, glob);
+#endif
+}
+
+void PGPlatform::freeNativeString(void* ptr)
+{
+    if (ptr == nullptr) {
+        return;
+    }
+
+    // the managed side allocates with Marshal.StringToHGlobalUni, which is LocalAlloc on Windows and malloc elsewhere
+#ifdef _WIN32
+    LocalFree(static_cast<HLOCAL>(ptr));
+#else
+    free(ptr); // NOLINT(cppcoreguidelines-no-malloc,cppcoreguidelines-owning-memory)
+#endif
+}
+
+auto PGPlatform::getTotalPhysicalMemory() -> uint64_t
+{
+#ifdef _WIN32
+    MEMORYSTATUSEX memStatus;
+    memStatus.dwLength = sizeof(memStatus);
+    if (GlobalMemoryStatusEx(&memStatus) == 0) {
+        return 0;
+    }
+
+    return memStatus.ullTotalPhys;
+#else
+    const long pages = sysconf(_SC_PHYS_PAGES);
+    const long pageSize = sysconf(_SC_PAGE_SIZE);
+    if (pages <= 0 || pageSize <= 0) {
+        return 0;
+    }
+
+    return static_cast<uint64_t>(pages) * static_cast<uint64_t>(pageSize);
+#endif
+}
+
+auto PGPlatform::isGPUAvailable() -> bool
+{
+#ifdef _WIN32
+    static const bool s_available = [] {
+        const D3D_FEATURE_LEVEL featureLevel = D3D_FEATURE_LEVEL_11_0;
+
+        // without output pointers this only checks whether the device could be created
+        const HRESULT hr = D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_HARDWARE, nullptr, 0, &featureLevel, 1,
+            D3D11_SDK_VERSION, nullptr, nullptr, nullptr);
+        return SUCCEEDED(hr);
+    }();
+
+    return s_available;
+#else
+    return false;
+#endif
+}
+
+auto PGPlatform::getHRESULTMessage(const int32_t& hr) -> string
+{
+#ifdef _WIN32
+    const _com_error err(static_cast<HRESULT>(hr));
+    return err.ErrorMessage();
+#else
+    ostringstream oss;
+    oss << "HRESULT 0x" << hex << uppercase << static_cast<uint32_t>(hr);
+    return oss.str();
+#endif
+}
@@ -0,0 +1,153 @@
+#include "PGPluginIndex.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <system_error>
+#include <utility>
+
+#include "Logger.hpp"
+#include "ParallaxGenUtil.hpp"
+
+using namespace std;
+
+auto PGPluginIndex::getFingerprint(const filesystem::path& dataPath, const vector<wstring>& plugins) -> nlohmann::json
+{
+    nlohmann::json fingerprint = { { "version", CACHE_VERSION },
+        { "dataPath", ParallaxGenUtil::utf16toUTF8(dataPath.wstring()) }, { "plugins", nlohmann::json::array() } };
+
+    for (const auto& plugin : plugins) {
+        // missing plugins are recorded as such, so the index is rebuilt once they appear
+        error_code ec;
+        const auto pluginPath = dataPath / plugin;
+        const auto size = filesystem::file_size(pluginPath, ec);
+        const int64_t sizeValue = ec ? -1 : static_cast<int64_t>(size);
+        const auto writeTime = filesystem::last_write_time(pluginPath, ec);
+        const int64_t writeTimeValue = ec ? -1 : static_cast<int64_t>(writeTime.time_since_epoch().count());
+
+        fingerprint["plugins"].push_back(
+            nlohmann::json::array({ ParallaxGenUtil::utf16toUTF8(ParallaxGenUtil::toLowerASCII(plugin)), sizeValue,
+                writeTimeValue }));
+    }
+
+    return fingerprint;
+}
+
+void PGPluginIndex::add(const wstring& nifName, const int& index3D, Match match)
+{
+    m_matches[nifName][index3D].push_back(std::move(match));
+    m_numMatches++;
+}
+
+auto PGPluginIndex::getMatches(const wstring& nifName, const int& index3D) const
+    -> vector<tuple<int, int, wstring, string>>
+{
+    const auto nifNameLower = ParallaxGenUtil::toLowerASCII(nifName);
+
+    vector<tuple<int, int, wstring, string>> results;
+    if (const auto* matches = find(nifNameLower, index3D); matches != nullptr) {
+        for (const auto& match : *matches) {
+            results.emplace_back(match.txstHandle, match.altTexHandle, nifNameLower, match.type);
+        }
+    }
+
+    // armor and armor addon models are often split into _0 and _1 NIFs that only one of them references
+    static constexpr size_t WEIGHT_SUFFIX_LENGTH = 6;
+    wstring altNIFName;
+    if (nifNameLower.ends_with(L"_1.nif")) {
+        altNIFName = nifNameLower.substr(0, nifNameLower.size() - WEIGHT_SUFFIX_LENGTH) + L"_0.nif";
+    } else if (nifNameLower.ends_with(L"_0.nif")) {
+        altNIFName = nifNameLower.substr(0, nifNameLower.size() - WEIGHT_SUFFIX_LENGTH) + L"_1.nif";
+    }
+
+    if (const auto* matches = find(altNIFName, index3D); matches != nullptr) {
+        for (const auto& match : *matches) {
+            if (match.type == "MODL") {
+                continue;
+            }
+            results.emplace_back(match.txstHandle, match.altTexHandle, altNIFName, match.type);
+        }
+    }
+
+    return results;
+}
+
+auto PGPluginIndex::size() const -> size_t { return m_numMatches; }
+
+void PGPluginIndex::clear()
+{
+    m_matches.clear();
+    m_numMatches = 0;
+}
+
+auto PGPluginIndex::save(const filesystem::path& file, const nlohmann::json& fingerprint) const -> bool
+{
+    nlohmann::json matchesJSON = nlohmann::json::array();
+    for (const auto& [nifName, shapes] : m_matches) {
+        const auto nifNameUTF8 = ParallaxGenUtil::utf16toUTF8(nifName);
+        for (const auto& [index3D, matches] : shapes) {
+            for (const auto& match : matches) {
+                matchesJSON.push_back(
+                    nlohmann::json::array({ nifNameUTF8, index3D, match.txstHandle, match.altTexHandle, match.type }));
+            }
+        }
+    }
+
+    const nlohmann::json indexJSON = { { "fingerprint", fingerprint }, { "matches", std::move(matchesJSON) } };
+
+    error_code ec;
+    filesystem::create_directories(file.parent_path(), ec);
+    ofstream f(file);
+    f << indexJSON.dump(-1, ' ', false, nlohmann::detail::error_handler_t::replace) << "\n";
+    f.close();
+
+    if (f.fail()) {
+        Logger::warn(L"Unable to write plugin index cache {}", file.wstring());
+        return false;
+    }
+
+    return true;
+}
+
+auto PGPluginIndex::load(const filesystem::path& file, const nlohmann::json& fingerprint) -> bool
+{
+    clear();
+
+    if (!filesystem::exists(file)) {
+        return false;
+    }
+
+    try {
+        ifstream f(file);
+        const auto indexJSON = nlohmann::json::parse(f);
+        if (!indexJSON.contains("fingerprint") || indexJSON["fingerprint"] != fingerprint) {
+            Logger::debug("Plugin index cache is outdated, the load order or a plugin changed");
+            return false;
+        }
+
+        for (const auto& matchJSON : indexJSON.at("matches")) {
+            add(ParallaxGenUtil::utf8toUTF16(matchJSON.at(0).get<string>()), matchJSON.at(1).get<int>(),
+                { .txstHandle = matchJSON.at(2).get<int>(),
+                    .altTexHandle = matchJSON.at(3).get<int>(),
+                    .type = matchJSON.at(4).get<string>() });
+        }
+    } catch (const nlohmann::json::exception& e) {
+        Logger::warn("Plugin index cache is invalid, rebuilding it: {}", e.what());
+        clear();
+        return false;
+    }
+
+    return true;
+}
+
+auto PGPluginIndex::find(const wstring& nifName, const int& index3D) const -> const vector<Match>*
+{
+    const auto nifIt = m_matches.find(nifName);
+    if (nifIt == m_matches.end()) {
+        return nullptr;
+    }
+
+    const auto shapeIt = nifIt->second.find(index3D);
+    return shapeIt == nifIt->second.end() ? nullptr : &shapeIt->second;
+}
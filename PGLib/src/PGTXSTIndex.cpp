@@ -0,0 +1,180 @@
+#include "PGTXSTIndex.hpp"
+#include "Logger.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <stdexcept>
+
+using namespace std;
+
+auto PGTXSTIndex::SlotKey::fromSlots(const NIFUtil::TextureSet& rawSlots) -> SlotKey
+{
+    SlotKey key;
+    for (size_t i = 0; i < NUM_TEXTURE_SLOTS; ++i) {
+        const auto& rawSlot = rawSlots.at(i);
+        auto& slot = key.slots.at(i);
+
+        slot.resize(rawSlot.size());
+        for (size_t c = 0; c < rawSlot.size(); ++c) {
+            wchar_t ch = rawSlot[c];
+            if (ch >= L'A' && ch <= L'Z') {
+                ch = static_cast<wchar_t>(ch - L'A' + L'a');
+            } else if (ch == L'/') {
+                ch = L'\\';
+            }
+            slot[c] = ch;
+        }
+    }
+
+    key.hash = hashSlots(key.slots);
+    return key;
+}
+
+auto PGTXSTIndex::SlotKey::hashSlots(const NIFUtil::TextureSet& canonicalSlots) -> uint64_t
+{
+    static constexpr uint64_t FNV_OFFSET = 14695981039346656037ULL;
+    static constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+    static constexpr uint64_t BYTE_MASK = 0xFF;
+    static constexpr unsigned BYTE_BITS = 8;
+    static constexpr uint64_t SLOT_SEPARATOR = 0x1F;
+
+    uint64_t hash = FNV_OFFSET;
+    for (const auto& slot : canonicalSlots) {
+        for (const wchar_t ch : slot) {
+            // hash as UTF-16 code units so the result does not depend on sizeof(wchar_t)
+            const auto unit = static_cast<uint16_t>(ch);
+            hash = (hash ^ (unit & BYTE_MASK)) * FNV_PRIME;
+            hash = (hash ^ (static_cast<uint64_t>(unit) >> BYTE_BITS)) * FNV_PRIME;
+        }
+
+        // separate slots so that moving characters between slots changes the hash
+        hash = (hash ^ SLOT_SEPARATOR) * FNV_PRIME;
+    }
+
+    return hash;
+}
+
+auto PGTXSTIndex::getOrCreate(const SlotKey& key, const function<Entry()>& creator) -> pair<Entry, bool>
+{
+    auto& shard = getShard(key);
+    const lock_guard<mutex> lock(shard.mutex);
+
+    const auto it = shard.entries.find(key);
+    if (it != shard.entries.end()) {
+        return { it->second, false };
+    }
+
+    auto entry = creator();
+    shard.entries.emplace(key, entry);
+    return { entry, true };
+}
+
+auto PGTXSTIndex::find(const SlotKey& key, Entry& entry) -> bool
+{
+    auto& shard = getShard(key);
+    const lock_guard<mutex> lock(shard.mutex);
+
+    const auto it = shard.entries.find(key);
+    if (it == shard.entries.end()) {
+        return false;
+    }
+
+    entry = it->second;
+    return true;
+}
+
+auto PGTXSTIndex::size() -> size_t
+{
+    size_t total = 0;
+    for (auto& shard : m_shards) {
+        const lock_guard<mutex> lock(shard.mutex);
+        total += shard.entries.size();
+    }
+
+    return total;
+}
+
+void PGTXSTIndex::loadFormIDCache(const nlohmann::json& formIDCache)
+{
+    const lock_guard<mutex> lock(m_formIDMutex);
+
+    m_cachedFormIDs.clear();
+    m_reservedFormIDs.clear();
+    m_newFormIDs.clear();
+
+    for (const auto& [key, value] : formIDCache.items()) {
+        if (!value.is_number_unsigned()) {
+            Logger::warn("Ignoring invalid TXST form ID cache entry: {}", key);
+            continue;
+        }
+
+        const auto formID = value.get<unsigned int>();
+        m_cachedFormIDs[key] = formID;
+        m_reservedFormIDs.insert(formID);
+    }
+}
+
+auto PGTXSTIndex::getFormIDCache() -> nlohmann::json
+{
+    const lock_guard<mutex> lock(m_formIDMutex);
+
+    nlohmann::json formIDCache = nlohmann::json::object();
+    for (const auto& [key, value] : m_newFormIDs) {
+        formIDCache[key] = value;
+    }
+
+    return formIDCache;
+}
+
+auto PGTXSTIndex::allocateFormID(const string& cacheKey) -> unsigned int
+{
+    const lock_guard<mutex> lock(m_formIDMutex);
+
+    unsigned int newFormID = 0;
+    const auto cached = m_cachedFormIDs.find(cacheKey);
+    if (cached != m_cachedFormIDs.end() && !m_usedFormIDs.contains(cached->second)) {
+        // use old formid for new record
+        newFormID = cached->second;
+    } else {
+        // find next available formid
+        while (m_reservedFormIDs.contains(++m_curFormID)) { }
+        newFormID = m_curFormID;
+    }
+
+    if (newFormID == 0) {
+        throw runtime_error("Failed to find a new form ID for TXST record");
+    }
+
+    if (m_usedFormIDs.contains(newFormID)) {
+        throw runtime_error("Form ID already in use");
+    }
+
+    m_usedFormIDs.insert(newFormID);
+    m_newFormIDs[cacheKey] = newFormID;
+
+    return newFormID;
+}
+
+auto PGTXSTIndex::getEDID(const unsigned int& formID) -> string { return fmt::format("PGTXST{:06X}", formID); }
+
+void PGTXSTIndex::clear()
+{
+    for (auto& shard : m_shards) {
+        const lock_guard<mutex> lock(shard.mutex);
+        shard.entries.clear();
+    }
+
+    const lock_guard<mutex> lock(m_formIDMutex);
+    m_cachedFormIDs.clear();
+    m_newFormIDs.clear();
+    m_reservedFormIDs.clear();
+    m_usedFormIDs.clear();
+    m_curFormID = 0;
+}
+
+auto PGTXSTIndex::getShard(const SlotKey& key) -> Shard&
+{
+    // low bits feed the bucket index inside the shard, use high bits to pick the shard
+    static constexpr unsigned SHARD_SHIFT = 60;
+    return m_shards.at(static_cast<size_t>(key.hash >> SHARD_SHIFT) % NUM_SHARDS);
+}
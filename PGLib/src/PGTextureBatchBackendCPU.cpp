@@ -0,0 +1,70 @@
+#include "PGTextureBatchBackendCPU.hpp"
+#include "Logger.hpp"
+#include "PGMipGenerator.hpp"
+
+#include <utility>
+
+using namespace std;
+
+void PGTextureBatchBackendCPU::registerKernel(PGTextureBatcher::ShaderHandle shader, Kernel kernel)
+{
+    m_kernels[shader] = std::move(kernel);
+}
+
+auto PGTextureBatchBackendCPU::createSlot(const PGTextureBatcher::BatchKey& key) -> unique_ptr<Slot>
+{
+    if (!m_kernels.contains(key.shader)) {
+        Logger::debug("No CPU kernel registered for texture shader");
+        return nullptr;
+    }
+
+    auto slot = make_unique<CPUSlot>();
+    if (FAILED(slot->top.Initialize2D(key.outFormat, key.width, key.height, 1, 1))) {
+        return nullptr;
+    }
+
+    return slot;
+}
+
+auto PGTextureBatchBackendCPU::upload(Slot& /*slot*/, const PGTextureBatcher::Job& job) -> bool
+{
+    // the kernel reads the caller's input directly
+    return job.input != nullptr && job.input->GetImageCount() > 0;
+}
+
+auto PGTextureBatchBackendCPU::dispatch(Slot& slot, const PGTextureBatcher::Job& job) -> bool
+{
+    auto& cpuSlot = static_cast<CPUSlot&>(slot); // NOLINT(cppcoreguidelines-pro-type-static-cast-downcast)
+
+    const auto& kernel = m_kernels.at(job.key.shader);
+    if (!kernel(*job.input, cpuSlot.top, job.params)) {
+        return false;
+    }
+
+    if (job.key.mipLevels <= 1) {
+        return SUCCEEDED(cpuSlot.result.InitializeFromImage(*cpuSlot.top.GetImage(0, 0, 0)));
+    }
+
+    // same mip count as the GPU path, which regenerates all mips from the top level
+    const auto* top = cpuSlot.top.GetImage(0, 0, 0);
+    if (PGMipGenerator::isFormatSupported(top->format)) {
+        PGMipGenerator::Options options;
+        options.mipLevels = job.key.mipLevels;
+        return PGMipGenerator::generate(*top, options, cpuSlot.result);
+    }
+
+    return SUCCEEDED(DirectX::GenerateMipMaps(*top,
+        DirectX::TEX_FILTER_LINEAR | DirectX::TEX_FILTER_FORCE_NON_WIC, job.key.mipLevels, cpuSlot.result));
+}
+
+void PGTextureBatchBackendCPU::flush()
+{
+    // work already finished in dispatch
+}
+
+auto PGTextureBatchBackendCPU::readBack(Slot& slot, const PGTextureBatcher::Job& job) -> bool
+{
+    auto& cpuSlot = static_cast<CPUSlot&>(slot); // NOLINT(cppcoreguidelines-pro-type-static-cast-downcast)
+    *job.output = std::move(cpuSlot.result);
+    return true;
+}
@@ -0,0 +1,203 @@
+#include "PGTextureBatcher.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+/// @brief Runs one stage of one job, an exception fails only that job
+template <typename Func> void runJobStage(PGTextureBatcher::Job& job, const Func& func)
+{
+    try {
+        job.success = func();
+    } catch (...) {
+        job.success = false;
+        job.error = current_exception();
+    }
+}
+
+/// @brief Fails jobs with the current exception, keeping an exception a job already has
+void failJobs(const vector<PGTextureBatcher::Job*>& jobs)
+{
+    const auto error = current_exception();
+    for (auto* job : jobs) {
+        if (job->error == nullptr) {
+            job->success = false;
+            job->error = error;
+        }
+    }
+}
+} // namespace
+
+PGTextureBatcher::PGTextureBatcher(Backend* backend, const size_t& maxBatchSize)
+    : m_backend(backend)
+    , m_maxBatchSize(max<size_t>(maxBatchSize, 1))
+{
+    if (m_backend == nullptr) {
+        throw invalid_argument("Texture batcher needs a backend");
+    }
+}
+
+auto PGTextureBatcher::process(const DirectX::ScratchImage& input, DirectX::ScratchImage& output, ShaderHandle shader,
+    const DXGI_FORMAT& outFormat, const void* params, const size_t& paramsSize) -> bool
+{
+    if (input.GetImageCount() < 1) {
+        return false;
+    }
+
+    const auto& meta = input.GetMetadata();
+
+    Job job;
+    job.key = { .shader = shader,
+        .inFormat = meta.format,
+        .outFormat = outFormat,
+        .width = meta.width,
+        .height = meta.height,
+        .mipLevels = meta.mipLevels,
+        .paramsSize = params != nullptr ? paramsSize : 0 };
+    job.input = &input;
+    job.output = &output;
+    if (params != nullptr && paramsSize > 0) {
+        job.params.resize(paramsSize);
+        memcpy(job.params.data(), params, paramsSize);
+    }
+
+    unique_lock<mutex> lock(m_queueMutex);
+    m_queue.push_back(&job);
+
+    while (!job.done) {
+        if (m_draining) {
+            // someone else runs the batch, our job may be in it
+            m_queueCV.wait(lock);
+            continue;
+        }
+
+        // become the drainer, everything queued so far joins this batch
+        m_draining = true;
+        const auto batchSize = min(m_queue.size(), m_maxBatchSize);
+        vector<Job*> batch(m_queue.begin(), m_queue.begin() + static_cast<ptrdiff_t>(batchSize));
+        m_queue.erase(m_queue.begin(), m_queue.begin() + static_cast<ptrdiff_t>(batchSize));
+        lock.unlock();
+
+        runBatch(batch);
+
+        lock.lock();
+        for (auto* batchJob : batch) {
+            batchJob->done = true;
+        }
+        m_draining = false;
+        m_queueCV.notify_all();
+    }
+
+    lock.unlock();
+
+    if (job.error) {
+        rethrow_exception(job.error);
+    }
+
+    return job.success;
+}
+
+void PGTextureBatcher::clearPool() { m_pool.clear(); }
+
+auto PGTextureBatcher::getNumBatches() const -> size_t { return m_numBatches.load(); }
+
+auto PGTextureBatcher::getNumSlotsCreated() const -> size_t { return m_numSlotsCreated.load(); }
+
+auto PGTextureBatcher::getWaveSize(const BatchKey& key) const -> size_t
+{
+    const auto pixels = max<size_t>(key.width * key.height, 1);
+    return clamp<size_t>(MAX_BATCH_PIXELS / pixels, 1, m_maxBatchSize);
+}
+
+void PGTextureBatcher::runBatch(const vector<Job*>& jobs)
+{
+    // stable grouping so jobs run in submission order within a key
+    map<BatchKey, vector<Job*>> groups;
+    for (auto* job : jobs) {
+        groups[job->key].push_back(job);
+    }
+
+    for (const auto& [key, groupJobs] : groups) {
+        try {
+            runGroup(key, groupJobs);
+        } catch (...) {
+            // resources of the group could not be created, jobs of other groups are unaffected
+            failJobs(groupJobs);
+        }
+    }
+
+    m_numBatches++;
+    trimPool();
+}
+
+void PGTextureBatcher::runGroup(const BatchKey& key, const vector<Job*>& jobs)
+{
+    auto& entry = m_pool[key];
+    entry.lastUsedBatch = m_numBatches.load();
+
+    const auto waveSize = min(getWaveSize(key), jobs.size());
+    while (entry.slots.size() < waveSize) {
+        auto slot = m_backend->createSlot(key);
+        if (slot == nullptr) {
+            // out of resources, run with what we have
+            break;
+        }
+
+        entry.slots.push_back(std::move(slot));
+        m_numSlotsCreated++;
+    }
+
+    if (entry.slots.empty()) {
+        for (auto* job : jobs) {
+            job->success = false;
+        }
+        return;
+    }
+
+    const auto numSlots = min(entry.slots.size(), waveSize);
+    for (size_t waveStart = 0; waveStart < jobs.size(); waveStart += numSlots) {
+        const auto waveEnd = min(waveStart + numSlots, jobs.size());
+
+        // each stage runs for the whole wave before the next one starts, a job that throws only fails itself
+        for (size_t i = waveStart; i < waveEnd; ++i) {
+            runJobStage(*jobs[i], [&] { return m_backend->upload(*entry.slots[i - waveStart], *jobs[i]); });
+        }
+
+        for (size_t i = waveStart; i < waveEnd; ++i) {
+            if (jobs[i]->success) {
+                runJobStage(
+                    *jobs[i], [&] { return m_backend->dispatch(*entry.slots[i - waveStart], *jobs[i]); });
+            }
+        }
+
+        try {
+            m_backend->flush();
+        } catch (...) {
+            // the wave was submitted together, every job that reached the flush failed with it
+            vector<Job*> flushedJobs;
+            for (size_t i = waveStart; i < waveEnd; ++i) {
+                if (jobs[i]->success) {
+                    flushedJobs.push_back(jobs[i]);
+                }
+            }
+            failJobs(flushedJobs);
+            continue;
+        }
+
+        for (size_t i = waveStart; i < waveEnd; ++i) {
+            if (jobs[i]->success) {
+                runJobStage(
+                    *jobs[i], [&] { return m_backend->readBack(*entry.slots[i - waveStart], *jobs[i]); });
+            }
+        }
+    }
+}
+
+void PGTextureBatcher::trimPool()
+{
+    const auto curBatch = m_numBatches.load();
+    erase_if(m_pool, [&curBatch](const auto& item) { return curBatch - item.second.lastUsedBatch > POOL_IDLE_BATCHES; });
+}
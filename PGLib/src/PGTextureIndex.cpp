@@ -0,0 +1,372 @@
+#include "PGTextureIndex.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <ranges>
+#include <set>
+#include <stdexcept>
+
+#include "ParallaxGenUtil.hpp"
+
+using namespace std;
+using namespace ParallaxGenUtil;
+
+namespace {
+auto candidateToJSON(const PGTextureIndex::ShaderCandidate& candidate) -> nlohmann::json
+{
+    return { { "shader", static_cast<int>(candidate.shader) }, { "mod", utf16toUTF8(candidate.mod) },
+        { "matchedPath", utf16toUTF8(candidate.matchedPath) } };
+}
+
+auto candidateFromJSON(const nlohmann::json& json) -> PGTextureIndex::ShaderCandidate
+{
+    return { .shader = static_cast<NIFUtil::ShapeShader>(json["shader"].get<int>()),
+        .mod = utf8toUTF16(json["mod"].get<string>()),
+        .matchedPath = utf8toUTF16(json["matchedPath"].get<string>()) };
+}
+} // namespace
+
+void PGTextureIndex::setEnabled(const bool& enabled) { m_enabled = enabled; }
+
+auto PGTextureIndex::isEnabled() const -> bool { return m_enabled; }
+
+void PGTextureIndex::setMeshRefs(const wstring& mesh, const MeshRefs& refs)
+{
+    if (!m_enabled) {
+        return;
+    }
+
+    m_buffers.local().meshRefs.emplace_back(mesh, refs);
+}
+
+void PGTextureIndex::setShapeResult(const wstring& mesh, const int& shapeIndex, ShapeResult result)
+{
+    if (!m_enabled) {
+        return;
+    }
+
+    m_buffers.local().shapeResults.emplace_back(mesh, shapeIndex, std::move(result));
+}
+
+void PGTextureIndex::merge()
+{
+    vector<pair<wstring, MeshRefs>> meshRefs;
+    vector<tuple<wstring, int, ShapeResult>> shapeResults;
+    m_buffers.forEach([&](ThreadBuffer& buffer) {
+        ranges::move(buffer.meshRefs, back_inserter(meshRefs));
+        ranges::move(buffer.shapeResults, back_inserter(shapeResults));
+        buffer.meshRefs.clear();
+        buffer.shapeResults.clear();
+    });
+
+    ranges::stable_sort(meshRefs, {}, [](const auto& entry) -> const wstring& { return entry.first; });
+    ranges::stable_sort(shapeResults, [](const auto& a, const auto& b) {
+        return tie(get<0>(a), get<1>(a)) < tie(get<0>(b), get<1>(b));
+    });
+
+    const lock_guard<mutex> lock(m_mutex);
+
+    for (const auto& [mesh, refs] : meshRefs) {
+        applyMeshRefs(mesh, refs);
+    }
+
+    for (auto& [mesh, shapeIndex, result] : shapeResults) {
+        const auto meshID = intern(normalizePath(mesh));
+        m_shapeResults[{ meshID, shapeIndex }] = std::move(result);
+    }
+}
+
+void PGTextureIndex::resolveMods(const ModResolver& resolver)
+{
+    merge();
+
+    const lock_guard<mutex> lock(m_mutex);
+
+    m_pathMods.resize(m_paths.size());
+    for (size_t i = 0; i < m_paths.size(); ++i) {
+        m_pathMods[i] = resolver(m_paths[i]);
+    }
+}
+
+auto PGTextureIndex::getUsers(const wstring& texture) const -> vector<TextureRef>
+{
+    const lock_guard<mutex> lock(m_mutex);
+
+    auto textureID = findPathID(texture);
+    if (!textureID.has_value()) {
+        // NIFs usually omit the textures folder
+        textureID = findPathID(L"textures\\" + texture);
+    }
+
+    if (!textureID.has_value()) {
+        return {};
+    }
+
+    const auto it = m_textureRefs.find(textureID.value());
+    if (it == m_textureRefs.end()) {
+        return {};
+    }
+
+    vector<TextureRef> users;
+    users.reserve(it->second.size());
+    for (const auto& ref : it->second) {
+        users.push_back({ .mesh = m_paths[ref.mesh], .shapeIndex = ref.shapeIndex, .slot = ref.slot });
+    }
+
+    ranges::sort(users, [](const TextureRef& a, const TextureRef& b) {
+        return tie(a.mesh, a.shapeIndex, a.slot) < tie(b.mesh, b.shapeIndex, b.slot);
+    });
+
+    return users;
+}
+
+auto PGTextureIndex::getShapeResult(const wstring& mesh, const int& shapeIndex) const -> optional<ShapeResult>
+{
+    const lock_guard<mutex> lock(m_mutex);
+
+    const auto meshID = findPathID(mesh);
+    if (!meshID.has_value()) {
+        return nullopt;
+    }
+
+    const auto it = m_shapeResults.find({ meshID.value(), shapeIndex });
+    if (it == m_shapeResults.end()) {
+        return nullopt;
+    }
+
+    return it->second;
+}
+
+auto PGTextureIndex::getModImpact(const wstring& mod) const -> ModImpact
+{
+    const lock_guard<mutex> lock(m_mutex);
+
+    set<wstring> textures;
+    set<wstring> meshes;
+    for (const auto& [textureID, refs] : m_textureRefs) {
+        if (textureID >= m_pathMods.size() || m_pathMods[textureID] != mod) {
+            continue;
+        }
+
+        textures.insert(m_paths[textureID]);
+        for (const auto& ref : refs) {
+            meshes.insert(m_paths[ref.mesh]);
+        }
+    }
+
+    // meshes the mod provides itself
+    for (const auto& meshID : views::keys(m_meshTextures)) {
+        if (meshID < m_pathMods.size() && m_pathMods[meshID] == mod) {
+            meshes.insert(m_paths[meshID]);
+        }
+    }
+
+    ModImpact impact;
+    impact.textures.assign(textures.begin(), textures.end());
+    impact.meshes.assign(meshes.begin(), meshes.end());
+
+    for (const auto& [key, result] : m_shapeResults) {
+        if (result.winner.mod == mod) {
+            impact.wonShapes.emplace_back(m_paths[key.first], key.second);
+        }
+    }
+    ranges::sort(impact.wonShapes);
+
+    return impact;
+}
+
+auto PGTextureIndex::getNumTextures() const -> size_t
+{
+    const lock_guard<mutex> lock(m_mutex);
+    return m_textureRefs.size();
+}
+
+auto PGTextureIndex::getNumShapeResults() const -> size_t
+{
+    const lock_guard<mutex> lock(m_mutex);
+    return m_shapeResults.size();
+}
+
+auto PGTextureIndex::toJSON() const -> nlohmann::json
+{
+    const lock_guard<mutex> lock(m_mutex);
+
+    nlohmann::json json = nlohmann::json::object();
+    json["version"] = INDEX_VERSION;
+
+    auto& paths = json["paths"] = nlohmann::json::array();
+    auto& mods = json["mods"] = nlohmann::json::array();
+    for (size_t i = 0; i < m_paths.size(); ++i) {
+        paths.push_back(utf16toUTF8(m_paths[i]));
+        mods.push_back(i < m_pathMods.size() ? utf16toUTF8(m_pathMods[i]) : string());
+    }
+
+    // flat [texture, mesh, shape, slot] rows keep the file small
+    auto& refs = json["refs"] = nlohmann::json::array();
+    for (const auto& [textureID, textureRefs] : m_textureRefs) {
+        for (const auto& ref : textureRefs) {
+            refs.push_back({ textureID, ref.mesh, ref.shapeIndex, static_cast<int>(ref.slot) });
+        }
+    }
+
+    auto& shapes = json["shapes"] = nlohmann::json::array();
+    for (const auto& [key, result] : m_shapeResults) {
+        nlohmann::json shape = nlohmann::json::object();
+        shape["mesh"] = key.first;
+        shape["shape"] = key.second;
+        shape["winner"] = candidateToJSON(result.winner);
+        shape["candidates"] = nlohmann::json::array();
+        for (const auto& candidate : result.candidates) {
+            shape["candidates"].push_back(candidateToJSON(candidate));
+        }
+
+        shapes.push_back(std::move(shape));
+    }
+
+    return json;
+}
+
+void PGTextureIndex::loadJSON(const nlohmann::json& json)
+{
+    if (!json.contains("version") || json["version"].get<int>() != INDEX_VERSION) {
+        throw runtime_error("Texture index version mismatch, re-run ParallaxGen to rebuild it");
+    }
+
+    const lock_guard<mutex> lock(m_mutex);
+
+    m_paths.clear();
+    m_pathIDs.clear();
+    m_pathMods.clear();
+    m_textureRefs.clear();
+    m_meshTextures.clear();
+    m_shapeResults.clear();
+
+    for (const auto& path : json["paths"]) {
+        intern(utf8toUTF16(path.get<string>()));
+    }
+
+    for (const auto& mod : json["mods"]) {
+        m_pathMods.push_back(utf8toUTF16(mod.get<string>()));
+    }
+    m_pathMods.resize(m_paths.size());
+
+    for (const auto& row : json["refs"]) {
+        const auto textureID = row[0].get<uint32_t>();
+        const auto meshID = row[1].get<uint32_t>();
+        if (textureID >= m_paths.size() || meshID >= m_paths.size()) {
+            throw runtime_error("Texture index references an unknown path");
+        }
+
+        m_textureRefs[textureID].push_back({ .mesh = meshID,
+            .shapeIndex = row[2].get<int>(),
+            .slot = static_cast<NIFUtil::TextureSlots>(row[3].get<int>()) });
+        m_meshTextures[meshID].push_back(textureID);
+    }
+
+    for (const auto& shape : json["shapes"]) {
+        const auto meshID = shape["mesh"].get<uint32_t>();
+        if (meshID >= m_paths.size()) {
+            throw runtime_error("Texture index references an unknown path");
+        }
+
+        ShapeResult result;
+        result.winner = candidateFromJSON(shape["winner"]);
+        for (const auto& candidate : shape["candidates"]) {
+            result.candidates.push_back(candidateFromJSON(candidate));
+        }
+
+        m_shapeResults[{ meshID, shape["shape"].get<int>() }] = std::move(result);
+    }
+}
+
+void PGTextureIndex::save(const filesystem::path& indexFile) const
+{
+    ofstream f(indexFile);
+    if (!f.is_open()) {
+        throw runtime_error("Unable to open texture index for writing: " + utf16toUTF8(indexFile.wstring()));
+    }
+
+    f << toJSON().dump(-1, ' ', false, nlohmann::detail::error_handler_t::replace) << "\n";
+    f.close();
+}
+
+void PGTextureIndex::load(const filesystem::path& indexFile)
+{
+    ifstream f(indexFile);
+    if (!f.is_open()) {
+        throw runtime_error("Unable to open texture index: " + utf16toUTF8(indexFile.wstring()));
+    }
+
+    loadJSON(nlohmann::json::parse(f));
+}
+
+void PGTextureIndex::clear()
+{
+    m_buffers.reset();
+
+    const lock_guard<mutex> lock(m_mutex);
+
+    m_paths.clear();
+    m_pathIDs.clear();
+    m_pathMods.clear();
+    m_textureRefs.clear();
+    m_meshTextures.clear();
+    m_shapeResults.clear();
+}
+
+auto PGTextureIndex::normalizePath(const wstring& path) -> wstring
+{
+    auto normalized = toLowerASCII(path);
+    ranges::replace(normalized, L'/', L'\\');
+    return normalized;
+}
+
+void PGTextureIndex::applyMeshRefs(const wstring& mesh, const MeshRefs& refs)
+{
+    const auto meshID = intern(normalizePath(mesh));
+
+    // drop references from an earlier record of this mesh
+    auto& meshTextures = m_meshTextures[meshID];
+    for (const auto& textureID : meshTextures) {
+        auto it = m_textureRefs.find(textureID);
+        if (it == m_textureRefs.end()) {
+            continue;
+        }
+
+        erase_if(it->second, [&meshID](const Ref& ref) { return ref.mesh == meshID; });
+        if (it->second.empty()) {
+            m_textureRefs.erase(it);
+        }
+    }
+    meshTextures.clear();
+
+    for (const auto& [texture, shapeIndex, slot] : refs) {
+        const auto textureID = intern(normalizePath(texture));
+        m_textureRefs[textureID].push_back({ .mesh = meshID, .shapeIndex = shapeIndex, .slot = slot });
+        meshTextures.push_back(textureID);
+    }
+}
+
+auto PGTextureIndex::intern(const wstring& path) -> uint32_t
+{
+    const auto it = m_pathIDs.find(path);
+    if (it != m_pathIDs.end()) {
+        return it->second;
+    }
+
+    const auto newID = static_cast<uint32_t>(m_paths.size());
+    m_paths.push_back(path);
+    m_pathIDs.emplace(path, newID);
+    return newID;
+}
+
+auto PGTextureIndex::findPathID(const wstring& path) const -> optional<uint32_t>
+{
+    const auto it = m_pathIDs.find(normalizePath(path));
+    if (it == m_pathIDs.end()) {
+        return nullopt;
+    }
+
+    return it->second;
+}
@@ -0,0 +1,161 @@
+#include "PGTextureName.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+constexpr size_t ALPHABET_SIZE = 27; // a to z and '_'
+constexpr size_t UNDERSCORE = 26;
+constexpr size_t NO_SYMBOL = ALPHABET_SIZE;
+constexpr uint8_t NO_NODE = 0; // the root is never a child
+constexpr uint8_t NO_SUFFIX = 0xFF;
+
+constexpr auto getSymbol(const wchar_t& c) -> size_t
+{
+    if (c >= L'a' && c <= L'z') {
+        return static_cast<size_t>(c - L'a');
+    }
+    if (c >= L'A' && c <= L'Z') {
+        return static_cast<size_t>(c - L'A');
+    }
+    if (c == L'_') {
+        return UNDERSCORE;
+    }
+
+    return NO_SYMBOL;
+}
+
+constexpr auto getMaxNodes() -> size_t
+{
+    size_t numNodes = 1;
+    for (const auto& suffix : PGTextureName::SUFFIXES) {
+        numNodes += suffix.suffix.size();
+    }
+    return numNodes;
+}
+
+constexpr size_t MAX_NODES = getMaxNodes();
+static_assert(MAX_NODES < NO_SUFFIX, "node and suffix IDs are stored in a byte");
+
+struct Trie {
+    array<array<uint8_t, ALPHABET_SIZE>, MAX_NODES> next {}; /** < Child for each symbol, read from the end */
+    array<uint8_t, MAX_NODES> suffix {}; /** < Suffix that ends at the node */
+    size_t maxDepth = 0;
+};
+
+consteval auto buildTrie() -> Trie
+{
+    Trie trie;
+    trie.suffix.fill(NO_SUFFIX);
+
+    size_t numNodes = 1;
+    for (size_t i = 0; i < PGTextureName::SUFFIXES.size(); ++i) {
+        const auto& suffix = PGTextureName::SUFFIXES[i].suffix;
+        size_t node = 0;
+        for (auto it = suffix.rbegin(); it != suffix.rend(); ++it) {
+            const auto symbol = getSymbol(*it);
+            if (symbol == NO_SYMBOL) {
+                throw logic_error("texture suffixes may only contain letters and underscores");
+            }
+
+            if (trie.next[node][symbol] == NO_NODE) {
+                trie.next[node][symbol] = static_cast<uint8_t>(numNodes++);
+            }
+            node = trie.next[node][symbol];
+        }
+
+        if (trie.suffix[node] != NO_SUFFIX) {
+            throw logic_error("texture suffixes must be unique ignoring case");
+        }
+        trie.suffix[node] = static_cast<uint8_t>(i);
+        trie.maxDepth = max(trie.maxDepth, suffix.size());
+    }
+
+    return trie;
+}
+
+constexpr Trie TRIE = buildTrie();
+
+constexpr auto PREFERRED_SEPARATOR = static_cast<wchar_t>(filesystem::path::preferred_separator);
+
+constexpr auto isSeparator(const wchar_t& c) -> bool { return c == L'/' || c == PREFERRED_SEPARATOR; }
+} // namespace
+
+auto PGTextureName::parse(wstring_view pathWithoutExtension) -> Result
+{
+    Result result = { .base = pathWithoutExtension };
+
+    // walk the trie from the last character, deeper matches are longer suffixes and replace shorter ones
+    const auto size = pathWithoutExtension.size();
+    size_t node = 0;
+    for (size_t depth = 1; depth <= size; ++depth) {
+        const auto symbol = getSymbol(pathWithoutExtension[size - depth]);
+        if (symbol == NO_SYMBOL) {
+            break;
+        }
+
+        node = TRIE.next[node][symbol];
+        if (node == NO_NODE) {
+            break;
+        }
+
+        const auto suffixID = TRIE.suffix[node];
+        if (suffixID != NO_SUFFIX) {
+            result = { .base = pathWithoutExtension.substr(0, size - depth),
+                .slot = SUFFIXES[suffixID].slot,
+                .type = SUFFIXES[suffixID].type };
+        }
+    }
+
+    return result;
+}
+
+auto PGTextureName::stripExtension(wstring_view path) -> optional<wstring_view>
+{
+    if (path.empty() || isSeparator(path.back())) {
+        return nullopt;
+    }
+
+    // std::filesystem rewrites other separators, separator runs and root names when joining parent and stem. The
+    // last character is not a separator, so the next one is always in range.
+    for (size_t i = 0; i < path.size(); ++i) {
+        if (path[i] == L':') {
+            return nullopt;
+        }
+        if (isSeparator(path[i]) && (path[i] != PREFERRED_SEPARATOR || isSeparator(path[i + 1]))) {
+            return nullopt;
+        }
+    }
+
+    const auto fileStart = path.find_last_of(PREFERRED_SEPARATOR) + 1;
+    const auto fileName = path.substr(fileStart);
+    if (fileName == L"." || fileName == L"..") {
+        return nullopt;
+    }
+
+    // a leading dot starts the name, not the extension
+    const auto extStart = fileName.rfind(L'.');
+    if (extStart == wstring_view::npos || extStart == 0) {
+        return path;
+    }
+
+    return path.substr(0, fileStart + extStart);
+}
+
+auto PGTextureName::stripExtension(wstring_view path, wstring& storage) -> wstring_view
+{
+    const auto stripped = stripExtension(path);
+    if (stripped.has_value()) {
+        return *stripped;
+    }
+
+    const filesystem::path fsPath(path);
+    storage = (fsPath.parent_path() / fsPath.stem()).wstring();
+    return storage;
+}
+
+auto PGTextureName::getMaxSuffixLength() -> size_t { return TRIE.maxDepth; }
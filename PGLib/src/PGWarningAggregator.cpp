@@ -0,0 +1,101 @@
+#include "PGWarningAggregator.hpp"
+
+#include <map>
+#include <set>
+
+using namespace std;
+
+namespace {
+constexpr unsigned ID_BITS = 32;
+} // namespace
+
+auto PGWarningAggregator::ThreadBuffer::intern(const wstring& path) -> uint32_t
+{
+    const auto it = pathIDs.find(path);
+    if (it != pathIDs.end()) {
+        return it->second;
+    }
+
+    const auto newID = static_cast<uint32_t>(paths.size());
+    paths.push_back(path);
+    pathIDs.emplace(path, newID);
+    return newID;
+}
+
+void PGWarningAggregator::add(const Kind& kind, const wstring& sourcePath, const wstring& targetPath)
+{
+    auto& buffer = m_buffers.local();
+
+    const auto sourceID = buffer.intern(sourcePath);
+    const auto targetID = buffer.intern(targetPath);
+
+    const uint64_t key = (static_cast<uint64_t>(sourceID) << ID_BITS) | targetID;
+    if (!buffer.seen.at(static_cast<size_t>(kind)).insert(key).second) {
+        // already recorded by this thread
+        return;
+    }
+
+    buffer.records.push_back({ .source = sourceID, .target = targetID, .kind = kind });
+}
+
+auto PGWarningAggregator::merge(const Kind& kind, const ModResolver& sourceResolver,
+    const ModResolver& targetResolver) -> vector<Group>
+{
+    // dedup across threads
+    set<pair<wstring, wstring>> uniquePairs;
+    m_buffers.forEach([&](const ThreadBuffer& buffer) {
+        for (const auto& record : buffer.records) {
+            if (record.kind != kind) {
+                continue;
+            }
+
+            uniquePairs.emplace(buffer.paths[record.source], buffer.paths[record.target]);
+        }
+    });
+
+    // resolve each path once
+    unordered_map<wstring, wstring> sourceMods;
+    unordered_map<wstring, wstring> targetMods;
+    const auto resolve
+        = [](unordered_map<wstring, wstring>& cache, const ModResolver& resolver, const wstring& path) -> wstring {
+        const auto it = cache.find(path);
+        if (it != cache.end()) {
+            return it->second;
+        }
+
+        auto mod = resolver(path);
+        cache.emplace(path, mod);
+        return mod;
+    };
+
+    // pairs are visited in sorted order, so paths within each group end up sorted too
+    map<pair<wstring, wstring>, vector<pair<wstring, wstring>>> grouped;
+    for (const auto& pathPair : uniquePairs) {
+        const auto sourceMod = resolve(sourceMods, sourceResolver, pathPair.first);
+        const auto targetMod = resolve(targetMods, targetResolver, pathPair.second);
+
+        if (sourceMod.empty() || targetMod.empty() || sourceMod == targetMod) {
+            continue;
+        }
+
+        grouped[{ sourceMod, targetMod }].push_back(pathPair);
+    }
+
+    vector<Group> groups;
+    groups.reserve(grouped.size());
+    for (auto& [mods, paths] : grouped) {
+        groups.push_back({ .sourceMod = mods.first, .targetMod = mods.second, .paths = std::move(paths) });
+    }
+
+    return groups;
+}
+
+auto PGWarningAggregator::size() -> size_t
+{
+    size_t total = 0;
+    m_buffers.forEach([&total](const ThreadBuffer& buffer) { total += buffer.records.size(); });
+
+    return total;
+}
+
+void PGWarningAggregator::clear() { m_buffers.reset(); }
@@ -18,18 +18,25 @@
 #include <mutex>
 #include <nlohmann/json_fwd.hpp>
 #include <ranges>
-#include <spdlog/spdlog.h>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
-#include <d3d11.h>
-
 #include "Logger.hpp"
 #include "NIFUtil.hpp"
+#include "PGArchiveWriter.hpp"
 #include "PGDiag.hpp"
+#include "PGFileCache.hpp"
+#include "PGMemoryBudget.hpp"
+#include "PGNIFSplicer.hpp"
+#include "PGOutputStore.hpp"
+#include "PGPipeline.hpp"
+#include "PGPlatform.hpp"
+#include "PGTextureIndex.hpp"
 #include "ParallaxGenDirectory.hpp"
 #include "ParallaxGenPlugin.hpp"
 #include "ParallaxGenRunner.hpp"
@@ -41,11 +48,9 @@ using namespace std;
 using namespace ParallaxGenUtil;
 using namespace nifly;
 
-ParallaxGen::ParallaxGen(
-    filesystem::path outputDir, ParallaxGenDirectory* pgd, ParallaxGenD3D* pgd3D, const bool& optimizeMeshes)
+ParallaxGen::ParallaxGen(filesystem::path outputDir, ParallaxGenDirectory* pgd, const bool& optimizeMeshes)
     : m_outputDir(std::move(outputDir))
     , m_pgd(pgd)
-    , m_pgd3D(pgd3D)
     , m_modPriority(nullptr)
 {
     // constructor
@@ -57,7 +62,7 @@ ParallaxGen::ParallaxGen(
 void ParallaxGen::loadPatchers(
     const PatcherUtil::PatcherMeshSet& meshPatchers, const PatcherUtil::PatcherTextureSet& texPatchers)
 {
-    this->m_meshPatchers = meshPatchers;
+    this->m_meshPatchers.setFactories(meshPatchers);
     this->m_texPatchers = texPatchers;
 }
 
@@ -69,27 +74,50 @@ void ParallaxGen::loadModPriorityMap(unordered_map<wstring, int>* modPriority)
 
 void ParallaxGen::patch(const bool& multiThread, const bool& patchPlugin)
 {
-    auto meshes = m_pgd->getMeshes();
+    const vector<filesystem::path> meshes(m_pgd->getMeshes().begin(), m_pgd->getMeshes().end());
 
-    // Define diff JSON
-    mutex diffJSONMutex;
-    nlohmann::json diffJSON = nlohmann::json::object();
+    // Define diff JSON, entries are merged and written once all meshes are done
+    PGDiffWriter diffWriter(m_outputDir / getDiffRunsDirName());
 
     // Create task tracker
     ParallaxGenTask taskTracker("Mesh Patcher", meshes.size());
 
-    // Create runner
-    ParallaxGenRunner meshRunner(multiThread);
-
-    // Add tasks
-    for (const auto& mesh : meshes) {
-        meshRunner.addTask([this, &taskTracker, &diffJSONMutex, &diffJSON, &mesh, &patchPlugin] {
-            taskTracker.completeJob(processNIF(mesh, &diffJSON, &diffJSONMutex, patchPlugin));
-        });
-    }
+    // Reading, patching and writing run on their own threads so that waiting on disk does not hold up patching
+    vector<MeshJob> jobs(meshes.size());
+    const auto finishJob = [&taskTracker, &jobs](const size_t& index) {
+        taskTracker.completeJob(jobs[index].result);
+        jobs[index] = {};
+        return false;
+    };
 
-    // Blocks until all tasks are done
-    meshRunner.runTasks();
+    const auto sizes = getMeshPipelineSizes();
+    PGPipeline meshPipeline(
+        {
+            { .name = "read",
+                .numThreads = sizes.readThreads,
+                .func = [&](size_t index) { return readNIF(meshes[index], jobs[index]) || finishJob(index); } },
+            { .name = "patch",
+                .numThreads = sizes.patchThreads,
+                .queueCapacity = sizes.queueCapacity,
+                .func =
+                    [&](size_t index) {
+                        return patchNIF(meshes[index], jobs[index], patchPlugin, nullptr) || finishJob(index);
+                    } },
+            { .name = "write",
+                .numThreads = sizes.writeThreads,
+                .queueCapacity = sizes.queueCapacity,
+                .func =
+                    [&](size_t index) {
+                        writeNIF(meshes[index], jobs[index], &diffWriter);
+                        return finishJob(index);
+                    } },
+        },
+        multiThread,
+        // after an exception, NIFs that will never be written give their memory budget reservation back right away
+        [&jobs](size_t index) { jobs[index] = {}; });
+
+    // Blocks until all meshes are done
+    meshPipeline.run(meshes.size());
 
     // Print any resulting warning
     ParallaxGenWarnings::printWarnings();
@@ -115,15 +143,24 @@ void ParallaxGen::patch(const bool& multiThread, const bool& patchPlugin)
     }
 
     // Write diffJSON file
-    spdlog::info("Saving diff JSON file...");
+    Logger::info("Saving diff JSON file...");
     const filesystem::path diffJSONPath = m_outputDir / getDiffJSONName();
-    ofstream diffJSONFile(diffJSONPath);
-    diffJSONFile << diffJSON << "\n";
-    diffJSONFile.close();
+    if (!diffWriter.finish(diffJSONPath)) {
+        Logger::error(L"Unable to save diff JSON file {}", diffJSONPath.wstring());
+    }
+
+    // Write content manifest, duplicate outputs were linked to the first copy while patching
+    auto& outputStore = m_pgd->getOutputStore();
+    const filesystem::path manifestPath = m_outputDir / PGOutputStore::getManifestName();
+    if (!outputStore.writeManifest(manifestPath)) {
+        Logger::error(L"Unable to save content manifest {}", manifestPath.wstring());
+    }
+    Logger::info("Deduplicated {} output files ({} bytes)", outputStore.getNumDeduplicated(),
+        outputStore.getBytesDeduplicated());
 }
 
 auto ParallaxGen::findModConflicts(const bool& multiThread, const bool& patchPlugin)
-    -> unordered_map<wstring, tuple<set<NIFUtil::ShapeShader>, unordered_set<wstring>>>
+    -> PGConflictGraph
 {
     auto meshes = m_pgd->getMeshes();
 
@@ -139,30 +176,31 @@ auto ParallaxGen::findModConflicts(const bool& multiThread, const bool& patchPlu
     // Add tasks
     for (const auto& mesh : meshes) {
         runner.addTask([this, &taskTracker, &mesh, &patchPlugin, &conflictMods] {
-            taskTracker.completeJob(processNIF(mesh, nullptr, nullptr, patchPlugin, &conflictMods));
+            taskTracker.completeJob(processNIF(mesh, nullptr, patchPlugin, &conflictMods));
         });
     }
 
     // Blocks until all tasks are done
     runner.runTasks();
 
-    return conflictMods.mods;
+    return std::move(conflictMods.graph);
 }
 
 void ParallaxGen::zipMeshes() const
 {
     // Zip meshes
-    spdlog::info("Zipping meshes...");
+    Logger::info("Zipping meshes...");
     zipDirectory(m_outputDir, m_outputDir / getOutputZipName());
 }
 
 void ParallaxGen::deleteOutputDir(const bool& preOutput) const
 {
     static const unordered_set<filesystem::path> foldersToDelete
-        = { "meshes", "textures", "LightPlacer", "PBRTextureSets", "Strings" };
+        = { "meshes", "textures", "LightPlacer", "PBRTextureSets", "Strings", getDiffRunsDirName() };
     static const unordered_set<filesystem::path> filesToDelete
-        = { "ParallaxGen.esp", getDiffJSONName(), "ParallaxGen_DIAG.json" };
-    static const vector<pair<wstring, wstring>> filesToDeleteParseRules = { { L"PG_", L".esp" } };
+        = { "ParallaxGen.esp", getDiffJSONName(), "ParallaxGen_DIAG.json", PGOutputStore::getManifestName() };
+    static const vector<pair<wstring, wstring>> filesToDeleteParseRules = { { L"PG_", L".esp" },
+        { PGArchiveWriter::getDefaultBaseName(), L".esp" }, { PGArchiveWriter::getDefaultBaseName(), L".bsa" } };
     static const unordered_set<filesystem::path> filesToIgnore = { "meta.ini" };
     static const unordered_set<filesystem::path> filesToDeletePreOutput = { getOutputZipName() };
 
@@ -196,12 +234,11 @@ void ParallaxGen::deleteOutputDir(const bool& preOutput) const
             continue;
         }
 
-        spdlog::critical("Output directory has non-ParallaxGen related files. The output directory should only contain "
+        Logger::critical("Output directory has non-ParallaxGen related files. The output directory should only contain "
                          "files generated by ParallaxGen or empty. Exiting.");
-        exit(1);
     }
 
-    spdlog::info("Deleting old output files from output directory...");
+    Logger::info("Deleting old output files from output directory...");
 
     // Delete old output
     filesToDeleteParsed.insert(filesToDeleteParsed.end(), filesToDelete.begin(), filesToDelete.end());
@@ -233,18 +270,42 @@ auto ParallaxGen::getOutputZipName() -> filesystem::path { return "ParallaxGen_O
 
 auto ParallaxGen::getDiffJSONName() -> filesystem::path { return "ParallaxGen_Diff.json"; }
 
-auto ParallaxGen::processNIF(const filesystem::path& nifFile, nlohmann::json* diffJSON, mutex* diffJSONMutex,
-    const bool& patchPlugin, PatcherUtil::ConflictModResults* conflictMods) -> ParallaxGenTask::PGResult
+auto ParallaxGen::getDiffRunsDirName() -> filesystem::path { return "ParallaxGen_DiffRuns"; }
+
+void ParallaxGen::setMeshPipelineSizes(const MeshPipelineSizes& sizes) { m_meshPipelineSizes = sizes; }
+
+auto ParallaxGen::getMeshPipelineSizes() const -> MeshPipelineSizes
 {
-    if (diffJSON != nullptr && diffJSONMutex == nullptr) {
-        throw runtime_error("Diff JSON mutex must be set if diff JSON is set");
+    auto sizes = m_meshPipelineSizes;
+    if (sizes.readThreads == 0) {
+        sizes.readThreads = DEFAULT_READ_THREADS;
+    }
+    if (sizes.patchThreads == 0) {
+        sizes.patchThreads = max(std::thread::hardware_concurrency(), 1U);
+    }
+    if (sizes.writeThreads == 0) {
+        sizes.writeThreads = DEFAULT_WRITE_THREADS;
+    }
+    if (sizes.queueCapacity == 0) {
+        sizes.queueCapacity = sizes.patchThreads * DEFAULT_QUEUE_ITEMS_PER_PATCH_THREAD;
     }
 
-    const PGDiag::Prefix nifPrefix("meshes", nlohmann::json::value_t::object);
-    const PGDiag::Prefix diagNIFFilePrefix(nifFile.wstring(), nlohmann::json::value_t::object);
+    return sizes;
+}
 
-    auto result = ParallaxGenTask::PGResult::SUCCESS;
+auto ParallaxGen::processNIF(const filesystem::path& nifFile, PGDiffWriter* diffWriter, const bool& patchPlugin,
+    PatcherUtil::ConflictModResults* conflictMods) -> ParallaxGenTask::PGResult
+{
+    MeshJob job;
+    if (readNIF(nifFile, job) && patchNIF(nifFile, job, patchPlugin, conflictMods)) {
+        writeNIF(nifFile, job, diffWriter);
+    }
+
+    return job.result;
+}
 
+auto ParallaxGen::readNIF(const filesystem::path& nifFile, MeshJob& job) -> bool
+{
     const Logger::Prefix prefixNIF(nifFile.wstring());
     Logger::trace(L"Starting processing");
 
@@ -252,84 +313,119 @@ auto ParallaxGen::processNIF(const filesystem::path& nifFile, nlohmann::json* di
     const filesystem::path outputFile = m_outputDir / nifFile;
     if (filesystem::exists(outputFile)) {
         Logger::error(L"NIF Rejected: File already exists");
-        result = ParallaxGenTask::PGResult::FAILURE;
-        return result;
+        job.result = ParallaxGenTask::PGResult::FAILURE;
+        return false;
     }
 
     // Load NIF file
-    vector<std::byte> nifFileData;
     try {
-        nifFileData = m_pgd->getFile(nifFile);
+        job.nifBytes = m_pgd->getFileShared(nifFile);
     } catch (const exception& e) {
         Logger::error(L"NIF Rejected: Unable to load NIF: {}", utf8toUTF16(e.what()));
-        result = ParallaxGenTask::PGResult::FAILURE;
-        return result;
+        job.result = ParallaxGenTask::PGResult::FAILURE;
+        return false;
     }
 
+    // Account for the NIF bytes while they are alive, unless the file cache already charges them
+    job.reservation = make_unique<PGMemoryBudget::Reservation>(m_pgd->getUnchargedBytes(nifFile, job.nifBytes));
+
+    return true;
+}
+
+auto ParallaxGen::patchNIF(const filesystem::path& nifFile, MeshJob& job, const bool& patchPlugin,
+    PatcherUtil::ConflictModResults* conflictMods) -> bool
+{
+    const PGDiag::Prefix nifPrefix("meshes", nlohmann::json::value_t::object);
+    const PGDiag::Prefix diagNIFFilePrefix(nifFile.wstring(), nlohmann::json::value_t::object);
+    const Logger::Prefix prefixNIF(nifFile.wstring());
+
+    // The input bytes are not needed once the output is serialized
+    const auto nifFileData = std::move(job.nifBytes);
+
     // Process NIF
     bool nifModified = false;
     vector<pair<filesystem::path, nifly::NifFile>> dupNIFs;
 
-    auto nif = processNIF(nifFile, nifFileData, nifModified, nullptr, &dupNIFs, patchPlugin, conflictMods);
+    // optimizing rewrites the geometry, so only plain saves can splice into the original bytes
+    PGNIFSplicer splicer;
+    auto nif = processNIF(nifFile, *nifFileData, nifModified, nullptr, &dupNIFs, patchPlugin, conflictMods,
+        m_nifSaveOptions.optimize ? nullptr : &splicer);
 
-    // Save patched NIF if it was modified
+    // Serialize patched NIF if it was modified
     if (nifModified && conflictMods == nullptr && nif.IsValid()) {
         // Calculate CRC32 hash before
         boost::crc_32_type crcBeforeResult {};
-        crcBeforeResult.process_bytes(nifFileData.data(), nifFileData.size());
-        const auto crcBefore = crcBeforeResult.checksum();
+        crcBeforeResult.process_bytes(nifFileData->data(), nifFileData->size());
+        job.crcBefore = crcBeforeResult.checksum();
+
+        job.outputBytes = splicer.isCaptured() ? splicer.save(nif) : vector<std::byte> {};
+        if (job.outputBytes.empty()) {
+            job.outputBytes = NIFUtil::saveNIFToBytes(nif, m_nifSaveOptions);
+        }
+        if (job.outputBytes.empty()) {
+            Logger::error(L"Unable to save NIF file");
+            job.result = ParallaxGenTask::PGResult::FAILURE;
+            return false;
+        }
+    }
+
+    // Clear NIF from memory (no longer needed)
+    nif.Clear();
+
+    // Serialize any duplicate NIFs
+    for (auto& [dupNIFFile, dupNIF] : dupNIFs) {
+        auto dupNIFBytes = NIFUtil::saveNIFToBytes(dupNIF, m_nifSaveOptions);
+        dupNIF.Clear();
+        job.dupOutputs.emplace_back(dupNIFFile, std::move(dupNIFBytes));
+    }
+
+    return !job.outputBytes.empty() || !job.dupOutputs.empty();
+}
 
-        // create directories if required
-        filesystem::create_directories(outputFile.parent_path());
+auto ParallaxGen::writeNIF(const filesystem::path& nifFile, MeshJob& job, PGDiffWriter* diffWriter) -> bool
+{
+    const Logger::Prefix prefixNIF(nifFile.wstring());
 
-        if (nif.Save(outputFile, m_nifSaveOptions) != 0) {
+    // Save patched NIF if it was modified
+    if (!job.outputBytes.empty()) {
+        if (m_pgd->getOutputStore().write(nifFile, job.outputBytes) == PGOutputStore::WriteResult::FAILED) {
             Logger::error(L"Unable to save NIF file");
-            result = ParallaxGenTask::PGResult::FAILURE;
-            return result;
+            job.result = ParallaxGenTask::PGResult::FAILURE;
+            return false;
         }
 
         Logger::debug(L"Saving patched NIF to output");
 
-        // Clear NIF from memory (no longer needed)
-        nif.Clear();
-
         // Calculate CRC32 hash after
-        const auto outputFileBytes = getFileBytes(outputFile);
         boost::crc_32_type crcResultAfter {};
-        crcResultAfter.process_bytes(outputFileBytes.data(), outputFileBytes.size());
+        crcResultAfter.process_bytes(job.outputBytes.data(), job.outputBytes.size());
         const auto crcAfter = crcResultAfter.checksum();
 
         // Add to diff JSON
-        if (diffJSON != nullptr) {
-            auto jsonKey = utf16toUTF8(nifFile.wstring());
-            threadSafeJSONUpdate(
-                [&](nlohmann::json& json) {
-                    json[jsonKey]["crc32original"] = crcBefore;
-                    json[jsonKey]["crc32patched"] = crcAfter;
-                },
-                *diffJSON, *diffJSONMutex);
+        if (diffWriter != nullptr) {
+            diffWriter->add(utf16toUTF8(nifFile.wstring()), job.crcBefore, crcAfter);
         }
     }
 
     // Save any duplicate NIFs
-    for (auto& [dupNIFFile, dupNIF] : dupNIFs) {
+    for (const auto& [dupNIFFile, dupNIFBytes] : job.dupOutputs) {
         const auto dupNIFPath = m_outputDir / dupNIFFile;
-        filesystem::create_directories(dupNIFPath.parent_path());
         // TODO do we need to add info about this to diff json?
         Logger::debug(L"Saving duplicate NIF to output: {}", dupNIFPath.wstring());
-        if (dupNIF.Save(dupNIFPath, m_nifSaveOptions) != 0) {
+        if (dupNIFBytes.empty()
+            || m_pgd->getOutputStore().write(dupNIFFile, dupNIFBytes) == PGOutputStore::WriteResult::FAILED) {
             Logger::error(L"Unable to save duplicate NIF file {}", dupNIFFile.wstring());
-            result = ParallaxGenTask::PGResult::FAILURE;
-            return result;
+            job.result = ParallaxGenTask::PGResult::FAILURE;
+            return false;
         }
     }
 
-    return result;
+    return true;
 }
 
 auto ParallaxGen::processNIF(const std::filesystem::path& nifFile, const vector<std::byte>& nifBytes, bool& nifModified,
     const vector<NIFUtil::ShapeShader>* forceShaders, vector<pair<filesystem::path, nifly::NifFile>>* dupNIFs,
-    const bool& patchPlugin, PatcherUtil::ConflictModResults* conflictMods) -> nifly::NifFile
+    const bool& patchPlugin, PatcherUtil::ConflictModResults* conflictMods, PGNIFSplicer* splicer) -> nifly::NifFile
 {
     if (patchPlugin && dupNIFs == nullptr) {
         // duplicating nifs is required for plugin patching
@@ -346,32 +442,15 @@ auto ParallaxGen::processNIF(const std::filesystem::path& nifFile, const vector<
         return {};
     }
 
+    if (splicer != nullptr && conflictMods == nullptr) {
+        splicer->capture(nif, nifBytes);
+    }
+
     nifModified = false;
 
-    // Create patcher objects
-    auto patcherObjects = PatcherUtil::PatcherMeshObjectSet();
-    for (const auto& factory : m_meshPatchers.prePatchers) {
-        auto patcher = factory(nifFile, &nif);
-        patcherObjects.prePatchers.emplace_back(std::move(patcher));
-    }
-    for (const auto& [shader, factory] : m_meshPatchers.shaderPatchers) {
-        auto patcher = factory(nifFile, &nif);
-        patcherObjects.shaderPatchers.emplace(shader, std::move(patcher));
-    }
-    for (const auto& [shader, factory] : m_meshPatchers.shaderTransformPatchers) {
-        for (const auto& [transformShader, transformFactory] : factory) {
-            auto transform = transformFactory(nifFile, &nif);
-            patcherObjects.shaderTransformPatchers[shader].emplace(transformShader, std::move(transform));
-        }
-    }
-    for (const auto& factory : m_meshPatchers.postPatchers) {
-        auto patcher = factory(nifFile, &nif);
-        patcherObjects.postPatchers.emplace_back(std::move(patcher));
-    }
-    for (const auto& factory : m_meshPatchers.globalPatchers) {
-        auto patcher = factory(nifFile, &nif);
-        patcherObjects.globalPatchers.emplace_back(std::move(patcher));
-    }
+    // Get patcher objects, reused from earlier NIFs on this thread
+    const auto patcherLease = m_meshPatchers.acquire(nifFile, &nif);
+    auto& patcherObjects = *patcherLease;
 
     // Get shapes
     auto shapes = nif.GetShapes();
@@ -392,11 +471,15 @@ auto ParallaxGen::processNIF(const std::filesystem::path& nifFile, const vector<
     // it in plugins
     vector<tuple<NiShape*, int, int, string>> shapeTracker;
 
+    // Texture references for the reverse index, read before patchers change the slots
+    auto& textureIndex = m_pgd->getTextureIndex();
+    PGTextureIndex::MeshRefs textureRefs;
+
     // Loop through each shape in NIF
     for (NiShape* nifShape : shapes) {
         if (nifShape == nullptr) {
             // Null nif shape (this shouldn't happen unless there is a corruption)
-            spdlog::error(L"NIF {} has a null shape (skipping)", nifFile.wstring());
+            Logger::error(L"NIF {} has a null shape (skipping)", nifFile.wstring());
             nifModified = false;
             return {};
         }
@@ -415,10 +498,15 @@ auto ParallaxGen::processNIF(const std::filesystem::path& nifFile, const vector<
 
             if (!containsOnlyAscii(texture)) {
                 // NIFs cannot have non-ascii chars in their texture slots
-                spdlog::error(L"NIF {} has texture slot(s) with invalid non-ASCII chars (skipping)", nifFile.wstring());
+                Logger::error(L"NIF {} has texture slot(s) with invalid non-ASCII chars (skipping)", nifFile.wstring());
                 nifModified = false;
                 return {};
             }
+
+            if (textureIndex.isEnabled() && !texture.empty()) {
+                textureRefs.emplace_back(
+                    asciitoUTF16(texture), oldShapeIndex, static_cast<NIFUtil::TextureSlots>(slot));
+            }
         }
 
         // Define forced shader if needed
@@ -465,6 +553,10 @@ auto ParallaxGen::processNIF(const std::filesystem::path& nifFile, const vector<
         oldShapeIndex++;
     }
 
+    if (!textureRefs.empty()) {
+        textureIndex.setMeshRefs(nifFile.wstring(), textureRefs);
+    }
+
     if (conflictMods != nullptr) {
         // no need to continue if just getting mod conflicts
         nifModified = false;
@@ -551,11 +643,20 @@ auto ParallaxGen::processNIF(const std::filesystem::path& nifFile, const vector<
         return {};
     }
 
-    // Delete unreferenced blocks
-    nif.DeleteUnreferencedBlocks();
+    if (splicer != nullptr && splicer->canSplice(nif)) {
+        // Blocks stay where they are in the original file, block IDs below are the original ones
+        Logger::trace(L"Splicing patched blocks into original NIF");
+    } else {
+        if (splicer != nullptr) {
+            splicer->reset();
+        }
+
+        // Delete unreferenced blocks
+        nif.DeleteUnreferencedBlocks();
 
-    // Sort blocks and set plugin indices
-    nif.PrettySortBlocks();
+        // Sort blocks and set plugin indices
+        nif.PrettySortBlocks();
+    }
 
     if (patchPlugin && forceShaders == nullptr) {
         for (auto& shape : shapeTracker) {
@@ -634,10 +735,8 @@ auto ParallaxGen::processShape(const filesystem::path& nifPath, NifFile& nif, Ni
         const PGDiag::Prefix diagPrePatcherPrefix("prePatchers", nlohmann::json::value_t::object);
         for (const auto& prePatcher : patchers.prePatchers) {
             const Logger::Prefix prefixPatches(prePatcher->getPatcherName());
+            // prepatchers record their own diag keys, the rules prepatcher one per applied rule
             const bool prePatcherChanged = prePatcher->applyPatch(*nifShape);
-
-            PGDiag::insert(prePatcher->getPatcherName(), prePatcherChanged);
-
             changed |= prePatcherChanged && prePatcher->triggerSave();
         }
     }
@@ -715,20 +814,36 @@ auto ParallaxGen::processShape(const filesystem::path& nifPath, NifFile& nif, Ni
         }
     }
 
+    // Record candidates for texture index queries, the winner is filled in below
+    auto& textureIndex = m_pgd->getTextureIndex();
+    PGTextureIndex::ShapeResult indexResult;
+    if (textureIndex.isEnabled()) {
+        for (const auto& match : matches) {
+            indexResult.candidates.push_back(
+                { .shader = match.shader, .mod = match.mod, .matchedPath = match.match.matchedPath });
+        }
+    }
+
     // Populate conflict mods if set
     if (conflictMods != nullptr && !matches.empty()) {
+        if (textureIndex.isEnabled()) {
+            const auto winningShaderMatch = PatcherUtil::getWinningMatch(matches, m_modPriority);
+            indexResult.winner = { .shader = winningShaderMatch.shader,
+                .mod = winningShaderMatch.mod,
+                .matchedPath = winningShaderMatch.match.matchedPath };
+            textureIndex.setShapeResult(nifPath.wstring(), shapeIndex, std::move(indexResult));
+        }
+
         if (modSet.size() > 1) {
             const lock_guard<mutex> lock(conflictMods->mutex);
 
-            // add mods to conflict set
+            // add mods to conflict graph
+            vector<pair<wstring, NIFUtil::ShapeShader>> conflictMatches;
+            conflictMatches.reserve(matches.size());
             for (const auto& match : matches) {
-                if (conflictMods->mods.find(match.mod) == conflictMods->mods.end()) {
-                    conflictMods->mods.insert({ match.mod, { set<NIFUtil::ShapeShader>(), unordered_set<wstring>() } });
-                }
-
-                get<0>(conflictMods->mods[match.mod]).insert(match.shader);
-                get<1>(conflictMods->mods[match.mod]).insert(modSet.begin(), modSet.end());
+                conflictMatches.emplace_back(match.mod, match.shader);
             }
+            conflictMods->graph.addConflict(conflictMatches);
         }
 
         return false;
@@ -774,6 +889,14 @@ auto ParallaxGen::processShape(const filesystem::path& nifPath, NifFile& nif, Ni
         }
 
         shaderApplied = winningShaderMatch.shader;
+
+        if (textureIndex.isEnabled()) {
+            indexResult.winner = { .shader = winningShaderMatch.shader,
+                .mod = winningShaderMatch.mod,
+                .matchedPath = winningShaderMatch.match.matchedPath };
+            textureIndex.setShapeResult(nifPath.wstring(), shapeIndex, std::move(indexResult));
+        }
+
         if (shaderApplied != NIFUtil::ShapeShader::UNKNOWN) {
             // loop through patchers
             NIFUtil::TextureSet newSlots;
@@ -824,11 +947,14 @@ auto ParallaxGen::processDDS(const filesystem::path& ddsFile) -> ParallaxGenTask
     }
 
     DirectX::ScratchImage ddsImage;
-    if (!m_pgd3D->getDDS(ddsFile, ddsImage)) {
+    if (!m_pgd->getDDS(ddsFile, ddsImage)) {
         Logger::error(L"Unable to load DDS file: {}", ddsFile.wstring());
         return ParallaxGenTask::PGResult::FAILURE;
     }
 
+    // Account for the scratch image while it is alive
+    const PGMemoryBudget::Reservation ddsReservation(ddsImage.GetPixelsSize());
+
     bool ddsModified = false;
 
     for (const auto& factory : m_texPatchers.globalPatchers) {
@@ -839,13 +965,20 @@ auto ParallaxGen::processDDS(const filesystem::path& ddsFile) -> ParallaxGenTask
     if (ddsModified) {
         // save to output
         const filesystem::path outputFile = m_outputDir / ddsFile;
-        filesystem::create_directories(outputFile.parent_path());
 
-        const HRESULT hr = DirectX::SaveToDDSFile(ddsImage.GetImages(), ddsImage.GetImageCount(),
-            ddsImage.GetMetadata(), DirectX::DDS_FLAGS_NONE, outputFile.c_str());
+        DirectX::Blob ddsBlob;
+        const HRESULT hr = DirectX::SaveToDDSMemory(ddsImage.GetImages(), ddsImage.GetImageCount(),
+            ddsImage.GetMetadata(), DirectX::DDS_FLAGS_NONE, ddsBlob);
         if (FAILED(hr)) {
             Logger::error(L"Unable to save DDS {}: {}", outputFile.wstring(),
-                ParallaxGenUtil::utf8toUTF16(ParallaxGenD3D::getHRESULTErrorMessage(hr)));
+                ParallaxGenUtil::utf8toUTF16(PGPlatform::getHRESULTMessage(hr)));
+            return ParallaxGenTask::PGResult::FAILURE;
+        }
+
+        const span<const std::byte> ddsBytes(static_cast<const std::byte*>(ddsBlob.GetBufferPointer()),
+            ddsBlob.GetBufferSize());
+        if (m_pgd->getOutputStore().write(ddsFile, ddsBytes) == PGOutputStore::WriteResult::FAILED) {
+            Logger::error(L"Unable to save DDS {}", outputFile.wstring());
             return ParallaxGenTask::PGResult::FAILURE;
         }
 
@@ -856,13 +989,6 @@ auto ParallaxGen::processDDS(const filesystem::path& ddsFile) -> ParallaxGenTask
     return result;
 }
 
-void ParallaxGen::threadSafeJSONUpdate(
-    const std::function<void(nlohmann::json&)>& operation, nlohmann::json& j, mutex& mutex)
-{
-    const std::lock_guard<std::mutex> lock(mutex);
-    operation(j);
-}
-
 void ParallaxGen::addFileToZip(
     mz_zip_archive& zip, const filesystem::path& filePath, const filesystem::path& zipPath) const
 {
@@ -879,7 +1005,7 @@ void ParallaxGen::addFileToZip(
     // add file to Zip
     if (mz_zip_writer_add_mem(&zip, relativeFilePathAscii.c_str(), buffer.data(), buffer.size(), MZ_NO_COMPRESSION)
         == 0) {
-        spdlog::error(L"Error adding file to zip: {}", filePath.wstring());
+        Logger::error(L"Error adding file to zip: {}", filePath.wstring());
         exit(1);
     }
 }
@@ -893,15 +1019,14 @@ void ParallaxGen::zipDirectory(const filesystem::path& dirPath, const filesystem
 
     // Check if file already exists and delete
     if (filesystem::exists(zipPath)) {
-        spdlog::info(L"Deleting existing output Zip file: {}", zipPath.wstring());
+        Logger::info(L"Deleting existing output Zip file: {}", zipPath.wstring());
         filesystem::remove(zipPath);
     }
 
     // initialize file
     const string zipPathString = utf16toUTF8(zipPath);
     if (mz_zip_writer_init_file(&zip, zipPathString.c_str(), 0) == 0) {
-        spdlog::critical(L"Error creating Zip file: {}", zipPath.wstring());
-        exit(1);
+        Logger::critical(L"Error creating Zip file: {}", zipPath.wstring());
     }
 
     // add each file in directory to Zip
@@ -913,11 +1038,10 @@ void ParallaxGen::zipDirectory(const filesystem::path& dirPath, const filesystem
 
     // finalize Zip
     if (mz_zip_writer_finalize_archive(&zip) == 0) {
-        spdlog::critical(L"Error finalizing Zip archive: {}", zipPath.wstring());
-        exit(1);
+        Logger::critical(L"Error finalizing Zip archive: {}", zipPath.wstring());
     }
 
     mz_zip_writer_end(&zip);
 
-    spdlog::info(L"Please import this file into your mod manager: {}", zipPath.wstring());
+    Logger::info(L"Please import this file into your mod manager: {}", zipPath.wstring());
 }
@@ -4,7 +4,6 @@
 #include "ParallaxGenUtil.hpp"
 
 #include <dxgiformat.h>
-#include <spdlog/spdlog.h>
 
 #include <DirectXMath.h>
 #include <DirectXTex.h>
@@ -26,7 +25,9 @@
 #include <dxcapi.h>
 
 #include <algorithm>
+#include <array>
 #include <filesystem>
+#include <memory>
 #include <mutex>
 #include <string>
 
@@ -35,6 +36,8 @@
 #include <winnt.h>
 
 #include "Logger.hpp"
+#include "PGPlatform.hpp"
+#include "PGTextureBatcher.hpp"
 
 using namespace std;
 using namespace ParallaxGenUtil;
@@ -113,7 +116,7 @@ auto ParallaxGenD3D::checkIfCM(
 {
     // get metadata (should only pull headers, which is much faster)
     DirectX::TexMetadata ddsImageMeta {};
-    if (!getDDSMetadata(ddsPath, ddsImageMeta)) {
+    if (!m_pgd->getDDSMetadata(ddsPath, ddsImageMeta)) {
         result = false;
         return false;
     }
@@ -168,7 +171,7 @@ auto ParallaxGenD3D::checkIfCM(
 
     // Read image
     DirectX::ScratchImage image;
-    if (!getDDS(ddsPath, image)) {
+    if (!m_pgd->getDDS(ddsPath, image)) {
         Logger::debug(L"Failed to load DDS file (Skipping): {}", ddsPath.wstring());
         return false;
     }
@@ -276,28 +279,6 @@ auto ParallaxGenD3D::countPixelValues(const DirectX::ScratchImage& image, array<
     return true;
 }
 
-auto ParallaxGenD3D::checkIfAspectRatioMatches(
-    const std::filesystem::path& ddsPath1, const std::filesystem::path& ddsPath2) -> bool
-{
-    // get metadata (should only pull headers, which is much faster)
-    DirectX::TexMetadata ddsImageMeta1 {};
-    if (!getDDSMetadata(ddsPath1, ddsImageMeta1)) {
-        return false;
-    }
-
-    DirectX::TexMetadata ddsImageMeta2 {};
-    if (!getDDSMetadata(ddsPath2, ddsImageMeta2)) {
-        return false;
-    }
-
-    // calculate aspect ratios
-    const float aspectRatio1 = static_cast<float>(ddsImageMeta1.width) / static_cast<float>(ddsImageMeta1.height);
-    const float aspectRatio2 = static_cast<float>(ddsImageMeta2.width) / static_cast<float>(ddsImageMeta2.height);
-
-    // check if aspect ratios don't match
-    return aspectRatio1 == aspectRatio2;
-}
-
 //
 // GPU Code
 //
@@ -324,7 +305,14 @@ auto ParallaxGenD3D::initGPU() -> bool
         &m_ptrContext // Sets the instance device immediate context
     );
 
-    return !FAILED(hr);
+    if (FAILED(hr)) {
+        return false;
+    }
+
+    m_batchBackend = make_unique<BatchBackend>(this);
+    m_textureBatcher = make_unique<PGTextureBatcher>(m_batchBackend.get());
+
+    return true;
 }
 
 auto ParallaxGenD3D::initShaders() -> bool
@@ -359,11 +347,11 @@ auto ParallaxGenD3D::initShader(const std::filesystem::path& filename, ComPtr<ID
         shaderBlob.ReleaseAndGetAddressOf(), ptrErrorBlob.ReleaseAndGetAddressOf());
     if (FAILED(hr)) {
         if (ptrErrorBlob != nullptr) {
-            Logger::debug(L"Failed to compile shader: {}, {}", asciitoUTF16(getHRESULTErrorMessage(hr)),
+            Logger::debug(L"Failed to compile shader: {}, {}", asciitoUTF16(PGPlatform::getHRESULTMessage(hr)),
                 static_cast<wchar_t*>(ptrErrorBlob->GetBufferPointer()));
             ptrErrorBlob.Reset();
         } else {
-            Logger::debug(L"Failed to compile shader: {}", asciitoUTF16(getHRESULTErrorMessage(hr)));
+            Logger::debug(L"Failed to compile shader: {}", asciitoUTF16(PGPlatform::getHRESULTMessage(hr)));
         }
 
         return false;
@@ -373,7 +361,7 @@ auto ParallaxGenD3D::initShader(const std::filesystem::path& filename, ComPtr<ID
     hr = m_ptrDevice->CreateComputeShader(
         shaderBlob->GetBufferPointer(), shaderBlob->GetBufferSize(), nullptr, outShader.ReleaseAndGetAddressOf());
     if (FAILED(hr)) {
-        Logger::debug("Failed to create compute shader: {}", getHRESULTErrorMessage(hr));
+        Logger::debug("Failed to create compute shader: {}", PGPlatform::getHRESULTMessage(hr));
         return false;
     }
 
@@ -409,7 +397,7 @@ auto ParallaxGenD3D::createTexture2D(const DirectX::ScratchImage& texture, ComPt
 
     if (FAILED(hr)) {
         // Log on failure
-        spdlog::debug("Failed to create ID3D11Texture2D on GPU: {}", getHRESULTErrorMessage(hr));
+        Logger::debug("Failed to create ID3D11Texture2D on GPU: {}", PGPlatform::getHRESULTMessage(hr));
         return false;
     }
 
@@ -438,7 +426,7 @@ auto ParallaxGenD3D::createTexture2D(ComPtr<ID3D11Texture2D>& existingTexture, C
     hr = m_ptrDevice->CreateTexture2D(&textureOutDesc, nullptr, dest.ReleaseAndGetAddressOf());
     if (FAILED(hr)) {
         // Log on failure
-        spdlog::debug("Failed to create ID3D11Texture2D on GPU: {}", getHRESULTErrorMessage(hr));
+        Logger::debug("Failed to create ID3D11Texture2D on GPU: {}", PGPlatform::getHRESULTMessage(hr));
         return false;
     }
 
@@ -459,7 +447,7 @@ auto ParallaxGenD3D::createTexture2D(D3D11_TEXTURE2D_DESC& desc, ComPtr<ID3D11Te
     hr = m_ptrDevice->CreateTexture2D(&desc, nullptr, dest.ReleaseAndGetAddressOf());
     if (FAILED(hr)) {
         // Log on failure
-        spdlog::debug("Failed to create ID3D11Texture2D on GPU: {}", getHRESULTErrorMessage(hr));
+        Logger::debug("Failed to create ID3D11Texture2D on GPU: {}", PGPlatform::getHRESULTMessage(hr));
         return false;
     }
 
@@ -485,7 +473,7 @@ auto ParallaxGenD3D::createShaderResourceView(
     hr = m_ptrDevice->CreateShaderResourceView(texture.Get(), &shaderDesc, dest.ReleaseAndGetAddressOf());
     if (FAILED(hr)) {
         // Log on failure
-        spdlog::debug("Failed to create ID3D11ShaderResourceView on GPU: {}", getHRESULTErrorMessage(hr));
+        Logger::debug("Failed to create ID3D11ShaderResourceView on GPU: {}", PGPlatform::getHRESULTMessage(hr));
         return false;
     }
 
@@ -511,7 +499,7 @@ auto ParallaxGenD3D::createUnorderedAccessView(
     hr = m_ptrDevice->CreateUnorderedAccessView(texture.Get(), &uavDesc, dest.ReleaseAndGetAddressOf());
     if (FAILED(hr)) {
         // Log on failure
-        spdlog::debug("Failed to create ID3D11UnorderedAccessView on GPU: {}", getHRESULTErrorMessage(hr));
+        Logger::debug("Failed to create ID3D11UnorderedAccessView on GPU: {}", PGPlatform::getHRESULTMessage(hr));
         return false;
     }
 
@@ -529,7 +517,7 @@ auto ParallaxGenD3D::createUnorderedAccessView(const ComPtr<ID3D11Resource>& gpu
 
     hr = m_ptrDevice->CreateUnorderedAccessView(gpuResource.Get(), &desc, &dest);
     if (FAILED(hr)) {
-        spdlog::debug("Failed to create ID3D11UnorderedAccessView on GPU: {}", getHRESULTErrorMessage(hr));
+        Logger::debug("Failed to create ID3D11UnorderedAccessView on GPU: {}", PGPlatform::getHRESULTMessage(hr));
         return false;
     }
 
@@ -547,7 +535,7 @@ auto ParallaxGenD3D::createBuffer(const void* data, D3D11_BUFFER_DESC& desc, Com
 
     const HRESULT hr = m_ptrDevice->CreateBuffer(&desc, &initData, dest.ReleaseAndGetAddressOf());
     if (FAILED(hr)) {
-        spdlog::debug("Failed to create ID3D11Buffer on GPU: {}", getHRESULTErrorMessage(hr));
+        Logger::debug("Failed to create ID3D11Buffer on GPU: {}", PGPlatform::getHRESULTMessage(hr));
         return false;
     }
 
@@ -582,7 +570,7 @@ auto ParallaxGenD3D::createConstantBuffer(const void* data, const UINT& size, Co
     hr = m_ptrDevice->CreateBuffer(&cbDesc, &cbInitData, dest.ReleaseAndGetAddressOf());
     if (FAILED(hr)) {
         // Log on failure
-        spdlog::debug("Failed to create ID3D11Buffer on GPU: {}", getHRESULTErrorMessage(hr));
+        Logger::debug("Failed to create ID3D11Buffer on GPU: {}", PGPlatform::getHRESULTMessage(hr));
         return false;
     }
 
@@ -655,7 +643,7 @@ auto ParallaxGenD3D::blockingDispatch(const Microsoft::WRL::ComPtr<ID3D11Compute
     queryDesc.Query = D3D11_QUERY_EVENT;
     hr = m_ptrDevice->CreateQuery(&queryDesc, ptrQuery.ReleaseAndGetAddressOf());
     if (FAILED(hr)) {
-        spdlog::debug("Failed to create query: {}", getHRESULTErrorMessage(hr));
+        Logger::debug("Failed to create query: {}", PGPlatform::getHRESULTMessage(hr));
         return false;
     }
 
@@ -672,7 +660,7 @@ auto ParallaxGenD3D::blockingDispatch(const Microsoft::WRL::ComPtr<ID3D11Compute
     hr = m_ptrContext->GetData(ptrQuery.Get(), &queryData, sizeof(queryData),
         D3D11_ASYNC_GETDATA_DONOTFLUSH); // block until complete
     if (FAILED(hr)) {
-        spdlog::debug("Failed to get query data: {}", getHRESULTErrorMessage(hr));
+        Logger::debug("Failed to get query data: {}", PGPlatform::getHRESULTMessage(hr));
         return false;
     }
     ptrQuery.Reset();
@@ -811,7 +799,7 @@ auto ParallaxGenD3D::readBack(const ComPtr<ID3D11Texture2D>& gpuResource, Direct
     // Create staging texture
     ComPtr<ID3D11Texture2D> stagingTex2D;
     if (!createTexture2D(stagingTex2DDesc, stagingTex2D)) {
-        spdlog::debug("Failed to create staging texture: {}", getHRESULTErrorMessage(hr));
+        Logger::debug("Failed to create staging texture: {}", PGPlatform::getHRESULTMessage(hr));
         return false;
     }
 
@@ -834,8 +822,8 @@ auto ParallaxGenD3D::readBack(const ComPtr<ID3D11Texture2D>& gpuResource, Direct
             hr = m_ptrContext->Map(stagingTex2D.Get(), mipLevel, D3D11_MAP_READ, 0, &mappedResource);
 
             if (FAILED(hr)) {
-                spdlog::debug("Failed to map resource to CPU during read back at mip level {}: {}", mipLevel,
-                    getHRESULTErrorMessage(hr));
+                Logger::debug("Failed to map resource to CPU during read back at mip level {}: {}", mipLevel,
+                    PGPlatform::getHRESULTMessage(hr));
                 return false;
             }
 
@@ -888,7 +876,7 @@ template <typename T> auto ParallaxGenD3D::readBack(const ComPtr<ID3D11Buffer>&
 
     hr = m_ptrDevice->CreateBuffer(&bufferDesc, nullptr, stagingBuffer.ReleaseAndGetAddressOf());
     if (FAILED(hr)) {
-        spdlog::debug("Failed to create staging buffer: {}", getHRESULTErrorMessage(hr));
+        Logger::debug("Failed to create staging buffer: {}", PGPlatform::getHRESULTMessage(hr));
         return false;
     }
 
@@ -902,7 +890,7 @@ template <typename T> auto ParallaxGenD3D::readBack(const ComPtr<ID3D11Buffer>&
         D3D11_MAPPED_SUBRESOURCE mappedResource;
         hr = m_ptrContext->Map(stagingBuffer.Get(), 0, D3D11_MAP_READ, 0, &mappedResource);
         if (FAILED(hr)) {
-            spdlog::debug("Failed to map resource to CPU during read back: {}", getHRESULTErrorMessage(hr));
+            Logger::debug("Failed to map resource to CPU during read back: {}", PGPlatform::getHRESULTMessage(hr));
             return false;
         }
 
@@ -921,181 +909,210 @@ template <typename T> auto ParallaxGenD3D::readBack(const ComPtr<ID3D11Buffer>&
     return true;
 }
 
-//
-// Texture Helpers
-//
-
-auto ParallaxGenD3D::getDDS(const filesystem::path& ddsPath, DirectX::ScratchImage& dds) const -> bool
+auto ParallaxGenD3D::applyShaderToTexture(const DirectX::ScratchImage& inTexture, DirectX::ScratchImage& outTexture,
+    const Microsoft::WRL::ComPtr<ID3D11ComputeShader>& shader, const DXGI_FORMAT& outFormat, const void* shaderParams,
+    const UINT& shaderParamsSize) -> bool
 {
-    HRESULT hr {};
+    if (shader == nullptr) {
+        throw runtime_error("Shader was not initialized");
+    }
 
-    if (m_pgd->isLooseFile(ddsPath)) {
-        spdlog::trace(L"Reading DDS loose file {}", ddsPath.wstring());
-        const filesystem::path fullPath = m_pgd->getLooseFileFullPath(ddsPath);
+    if (m_textureBatcher == nullptr) {
+        throw runtime_error("GPU not initialized");
+    }
 
-        // Load DDS file
-        hr = DirectX::LoadFromDDSFile(fullPath.c_str(), DirectX::DDS_FLAGS_NONE, nullptr, dds);
-    } else if (m_pgd->isBSAFile(ddsPath)) {
-        spdlog::trace(L"Reading DDS BSA file {}", ddsPath.wstring());
-        vector<std::byte> ddsBytes = m_pgd->getFile(ddsPath);
+    if (inTexture.GetImageCount() < 1) {
+        return false;
+    }
 
-        // Load DDS file
-        hr = DirectX::LoadFromDDSMemory(ddsBytes.data(), ddsBytes.size(), DirectX::DDS_FLAGS_NONE, nullptr, dds);
-    } else {
+    const DirectX::TexMetadata& inputMeta = inTexture.GetMetadata();
+    if (!isPowerOfTwo(static_cast<unsigned int>(inputMeta.width))
+        || !isPowerOfTwo(static_cast<unsigned int>(inputMeta.height))) {
+        Logger::debug(
+            "Cannot create GPU Texture: Dimensions must be a power of 2: {}x{}", inputMeta.width, inputMeta.height);
         return false;
     }
 
-    if (FAILED(hr)) {
-        spdlog::debug(
-            L"Failed to load DDS file from {}: {}", ddsPath.wstring(), asciitoUTF16(getHRESULTErrorMessage(hr)));
+    if (inputMeta.dimension != DirectX::TEX_DIMENSION_TEXTURE2D || inputMeta.arraySize != 1) {
+        Logger::debug("Cannot apply shader to texture arrays or cubemaps");
         return false;
     }
 
-    return true;
+    return m_textureBatcher->process(inTexture, outTexture, shader.Get(), outFormat, shaderParams, shaderParamsSize);
 }
 
-auto ParallaxGenD3D::getDDSMetadata(const filesystem::path& ddsPath, DirectX::TexMetadata& ddsMeta) -> bool
+//
+// Batch Backend
+//
+
+ParallaxGenD3D::BatchBackend::BatchBackend(ParallaxGenD3D* pgd3d)
+    : m_pgd3d(pgd3d)
 {
-    // Use lock_guard to make this method thread-safe
-    const lock_guard<mutex> lock(m_ddsMetaDataMutex);
+}
 
-    // Check if in cache
-    // TODO set cache to something on failure
-    if (m_ddsMetaDataCache.find(ddsPath) != m_ddsMetaDataCache.end()) {
-        ddsMeta = m_ddsMetaDataCache[ddsPath];
-        return true;
+auto ParallaxGenD3D::BatchBackend::createSlot(const PGTextureBatcher::BatchKey& key) -> unique_ptr<Slot>
+{
+    auto slot = make_unique<D3DSlot>();
+
+    // input texture, filled by upload
+    D3D11_TEXTURE2D_DESC desc = {};
+    desc.Width = static_cast<UINT>(key.width);
+    desc.Height = static_cast<UINT>(key.height);
+    desc.MipLevels = static_cast<UINT>(key.mipLevels);
+    desc.ArraySize = 1;
+    desc.Format = key.inFormat;
+    desc.SampleDesc.Count = 1;
+    desc.Usage = D3D11_USAGE_DEFAULT;
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    if (!m_pgd3d->createTexture2D(desc, slot->input) || !m_pgd3d->createShaderResourceView(slot->input, slot->inputSRV)) {
+        return nullptr;
+    }
+
+    if (key.paramsSize > 0) {
+        const vector<std::byte> zeroParams(key.paramsSize + GPU_BUFFER_SIZE_MULTIPLE);
+        if (!m_pgd3d->createConstantBuffer(zeroParams.data(), static_cast<UINT>(key.paramsSize), slot->params)) {
+            return nullptr;
+        }
     }
 
-    HRESULT hr {};
-
-    if (m_pgd->isLooseFile(ddsPath)) {
-        spdlog::trace(L"Reading DDS loose file metadata {}", ddsPath.wstring());
-        const filesystem::path fullPath = m_pgd->getLooseFileFullPath(ddsPath);
-
-        // Load DDS file
-        hr = DirectX::GetMetadataFromDDSFile(fullPath.c_str(), DirectX::DDS_FLAGS_NONE, ddsMeta);
-    } else if (m_pgd->isBSAFile(ddsPath)) {
-        spdlog::trace(L"Reading DDS BSA file metadata {}", ddsPath.wstring());
-        vector<std::byte> ddsBytes = m_pgd->getFile(ddsPath);
-
-        // Load DDS file
-        hr = DirectX::GetMetadataFromDDSMemory(ddsBytes.data(), ddsBytes.size(), DirectX::DDS_FLAGS_NONE, ddsMeta);
-    } else {
-        return false;
+    // shader output
+    desc.Format = key.outFormat;
+    desc.BindFlags = D3D11_BIND_UNORDERED_ACCESS | D3D11_BIND_SHADER_RESOURCE;
+    if (!m_pgd3d->createTexture2D(desc, slot->output)
+        || !m_pgd3d->createUnorderedAccessView(slot->output, slot->outputUAV)) {
+        return nullptr;
     }
 
-    if (FAILED(hr)) {
-        spdlog::debug(L"Failed to load DDS file metadata from {}: {}", ddsPath.wstring(),
-            asciitoUTF16(getHRESULTErrorMessage(hr)));
-        return false;
+    // mip generation
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
+    desc.MiscFlags = D3D11_RESOURCE_MISC_GENERATE_MIPS;
+    if (!m_pgd3d->createTexture2D(desc, slot->mips) || !m_pgd3d->createShaderResourceView(slot->mips, slot->mipsSRV)) {
+        return nullptr;
     }
 
-    // update cache
-    m_ddsMetaDataCache[ddsPath] = ddsMeta;
+    // CPU read back
+    desc.Usage = D3D11_USAGE_STAGING;
+    desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+    desc.BindFlags = 0;
+    desc.MiscFlags = 0;
+    if (!m_pgd3d->createTexture2D(desc, slot->staging)) {
+        return nullptr;
+    }
 
-    return true;
+    return slot;
 }
 
-auto ParallaxGenD3D::applyShaderToTexture(const DirectX::ScratchImage& inTexture, DirectX::ScratchImage& outTexture,
-    const Microsoft::WRL::ComPtr<ID3D11ComputeShader>& shader, const DXGI_FORMAT& outFormat, const void* shaderParams,
-    const UINT& shaderParamsSize) -> bool
+auto ParallaxGenD3D::BatchBackend::upload(Slot& slot, const PGTextureBatcher::Job& job) -> bool
 {
-    if (shader == nullptr) {
-        throw runtime_error("Shader was not initialized");
-    }
+    auto& d3dSlot = static_cast<D3DSlot&>(slot); // NOLINT(cppcoreguidelines-pro-type-static-cast-downcast)
+    const auto mipLevels = static_cast<UINT>(job.key.mipLevels);
 
-    if (inTexture.GetImageCount() < 1) {
-        return false;
-    }
+    const lock_guard<mutex> lock(m_pgd3d->m_gpuOperationMutex);
 
-    const DirectX::TexMetadata inputMeta = inTexture.GetMetadata();
+    for (UINT mipLevel = 0; mipLevel < mipLevels; ++mipLevel) {
+        const auto* image = job.input->GetImage(mipLevel, 0, 0);
+        if (image == nullptr) {
+            return false;
+        }
 
-    // Load texture on GPU
-    ComPtr<ID3D11Texture2D> inputDDSGPU;
-    if (!createTexture2D(inTexture, inputDDSGPU)) {
-        return false;
+        m_pgd3d->m_ptrContext->UpdateSubresource(d3dSlot.input.Get(), D3D11CalcSubresource(mipLevel, 0, mipLevels),
+            nullptr, image->pixels, static_cast<UINT>(image->rowPitch), static_cast<UINT>(image->slicePitch));
     }
 
-    // Create shader resource view
-    ComPtr<ID3D11ShaderResourceView> inputDDSSRV;
-    if (!createShaderResourceView(inputDDSGPU, inputDDSSRV)) {
-        return false;
-    }
+    if (d3dSlot.params != nullptr) {
+        D3D11_MAPPED_SUBRESOURCE mappedParams;
+        const HRESULT hr = m_pgd3d->m_ptrContext->Map(d3dSlot.params.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedParams);
+        if (FAILED(hr)) {
+            Logger::debug("Failed to map shader parameters: {}", PGPlatform::getHRESULTMessage(hr));
+            return false;
+        }
 
-    // Create constant parameter buffer
-    ComPtr<ID3D11Buffer> constantBuffer;
-    if (shaderParams != nullptr && !createConstantBuffer(shaderParams, shaderParamsSize, constantBuffer)) {
-        return false;
+        memcpy(mappedParams.pData, job.params.data(), job.params.size());
+        m_pgd3d->m_ptrContext->Unmap(d3dSlot.params.Get(), 0);
     }
 
-    // Create output texture
-    D3D11_TEXTURE2D_DESC outputDDSDesc = {};
-    inputDDSGPU->GetDesc(&outputDDSDesc);
-    outputDDSDesc.Format = outFormat;
-    outputDDSDesc.BindFlags = D3D11_BIND_UNORDERED_ACCESS | D3D11_BIND_SHADER_RESOURCE;
-
-    ComPtr<ID3D11Texture2D> outputDDSGPU;
-    if (!createTexture2D(outputDDSDesc, outputDDSGPU)) {
-        return false;
-    }
+    return true;
+}
 
-    ComPtr<ID3D11UnorderedAccessView> outputDDSUAV;
-    if (!createUnorderedAccessView(outputDDSGPU, outputDDSUAV)) {
-        return false;
-    }
+auto ParallaxGenD3D::BatchBackend::dispatch(Slot& slot, const PGTextureBatcher::Job& job) -> bool
+{
+    auto& d3dSlot = static_cast<D3DSlot&>(slot); // NOLINT(cppcoreguidelines-pro-type-static-cast-downcast)
+    auto* shader = static_cast<ID3D11ComputeShader*>(const_cast<void*>(job.key.shader)); // NOLINT
 
-    // Dispatch shader
-    vector<ComPtr<ID3D11Buffer>> constantBuffers;
-    if (shaderParams != nullptr) {
-        constantBuffers.push_back(constantBuffer);
-    }
+    const lock_guard<mutex> lock(m_pgd3d->m_gpuOperationMutex);
+    auto* context = m_pgd3d->m_ptrContext.Get();
 
-    if (!blockingDispatch(shader, { inputDDSSRV }, { outputDDSUAV }, constantBuffers,
-            static_cast<UINT>(inputMeta.width), static_cast<UINT>(inputMeta.height), 1)) {
-        return false;
+    context->CSSetShader(shader, nullptr, 0);
+    context->CSSetShaderResources(0, 1, d3dSlot.inputSRV.GetAddressOf());
+    context->CSSetUnorderedAccessViews(0, 1, d3dSlot.outputUAV.GetAddressOf(), nullptr);
+    if (d3dSlot.params != nullptr) {
+        context->CSSetConstantBuffers(0, 1, d3dSlot.params.GetAddressOf());
     }
 
-    // Release some objects
-    inputDDSGPU.Reset();
-    inputDDSSRV.Reset();
-    constantBuffer.Reset();
+    context->Dispatch((static_cast<UINT>(job.key.width) + NUM_GPU_THREADS - 1) / NUM_GPU_THREADS,
+        (static_cast<UINT>(job.key.height) + NUM_GPU_THREADS - 1) / NUM_GPU_THREADS, 1);
 
-    // Generate mips
-    D3D11_TEXTURE2D_DESC outputDDSMipsDesc = {};
-    outputDDSGPU->GetDesc(&outputDDSMipsDesc);
-    outputDDSMipsDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
-    outputDDSMipsDesc.MiscFlags = D3D11_RESOURCE_MISC_GENERATE_MIPS;
-    ComPtr<ID3D11Texture2D> outputDDSMipsGPU;
-    if (!createTexture2D(outputDDSMipsDesc, outputDDSMipsGPU)) {
-        return false;
+    // unbind so the output can be copied
+    static const array<ID3D11ShaderResourceView*, 1> nullSRV = { nullptr };
+    static const array<ID3D11UnorderedAccessView*, 1> nullUAV = { nullptr };
+    static const array<ID3D11Buffer*, 1> nullBuffer = { nullptr };
+    context->CSSetShader(nullptr, nullptr, 0);
+    context->CSSetShaderResources(0, 1, nullSRV.data());
+    context->CSSetUnorderedAccessViews(0, 1, nullUAV.data(), nullptr);
+    if (d3dSlot.params != nullptr) {
+        context->CSSetConstantBuffers(0, 1, nullBuffer.data());
     }
 
-    ComPtr<ID3D11ShaderResourceView> outputMipsSRV;
-    if (!createShaderResourceView(outputDDSMipsGPU, outputMipsSRV)) {
-        return false;
-    }
+    // regenerate mips from the top level and queue the copy for read back
+    context->CopyResource(d3dSlot.mips.Get(), d3dSlot.output.Get());
+    context->GenerateMips(d3dSlot.mipsSRV.Get());
+    context->CopyResource(d3dSlot.staging.Get(), d3dSlot.mips.Get());
+
+    return true;
+}
 
-    // Copy texture
-    copyResource(outputDDSGPU.Get(), outputDDSMipsGPU.Get());
-    generateMips(outputMipsSRV.Get());
-    copyResource(outputDDSMipsGPU.Get(), outputDDSGPU.Get());
+void ParallaxGenD3D::BatchBackend::flush()
+{
+    const lock_guard<mutex> lock(m_pgd3d->m_gpuOperationMutex);
+    m_pgd3d->m_ptrContext->Flush();
+}
 
-    // cleanup
-    outputDDSMipsGPU.Reset();
-    outputMipsSRV.Reset();
+auto ParallaxGenD3D::BatchBackend::readBack(Slot& slot, const PGTextureBatcher::Job& job) -> bool
+{
+    auto& d3dSlot = static_cast<D3DSlot&>(slot); // NOLINT(cppcoreguidelines-pro-type-static-cast-downcast)
+    const auto mipLevels = static_cast<UINT>(job.key.mipLevels);
 
-    // Read back texture
-    if (!readBack(outputDDSGPU, outTexture)) {
+    DirectX::ScratchImage outImage;
+    HRESULT hr = outImage.Initialize2D(job.key.outFormat, job.key.width, job.key.height, 1, job.key.mipLevels);
+    if (FAILED(hr)) {
+        Logger::debug("Failed to initialize ScratchImage: {}", PGPlatform::getHRESULTMessage(hr));
         return false;
     }
 
-    // More cleaning
-    outputDDSGPU.Reset();
-    outputDDSUAV.Reset();
+    const lock_guard<mutex> lock(m_pgd3d->m_gpuOperationMutex);
 
-    // Flush GPU to avoid leaks
-    flushGPU();
+    for (UINT mipLevel = 0; mipLevel < mipLevels; ++mipLevel) {
+        // blocks until the work queued for this slot is done
+        D3D11_MAPPED_SUBRESOURCE mappedResource;
+        hr = m_pgd3d->m_ptrContext->Map(d3dSlot.staging.Get(), mipLevel, D3D11_MAP_READ, 0, &mappedResource);
+        if (FAILED(hr)) {
+            Logger::debug("Failed to map resource to CPU during read back at mip level {}: {}", mipLevel,
+                PGPlatform::getHRESULTMessage(hr));
+            return false;
+        }
 
+        const auto* image = outImage.GetImage(mipLevel, 0, 0);
+        const size_t numRows = image->slicePitch / image->rowPitch;
+        const size_t rowBytes = min<size_t>(image->rowPitch, mappedResource.RowPitch);
+        const auto* srcData = reinterpret_cast<const unsigned char*>(mappedResource.pData);
+        for (size_t row = 0; row < numRows; ++row) {
+            memcpy(image->pixels + (row * image->rowPitch), srcData + (row * mappedResource.RowPitch), rowBytes);
+        }
+
+        m_pgd3d->m_ptrContext->Unmap(d3dSlot.staging.Get(), mipLevel);
+    }
+
+    *job.output = std::move(outImage);
     return true;
 }
 
@@ -1107,14 +1124,14 @@ auto ParallaxGenD3D::loadRawPixelsToScratchImage(const vector<unsigned char>& ra
     const HRESULT hr = image.Initialize2D(format, width, height, 1,
         mips); // 1 array slice, 1 mipmap level
     if (FAILED(hr)) {
-        spdlog::debug("Failed to initialize ScratchImage: {}", getHRESULTErrorMessage(hr));
+        Logger::debug("Failed to initialize ScratchImage: {}", PGPlatform::getHRESULTMessage(hr));
         return {};
     }
 
     // Get the image data
     const DirectX::Image* img = image.GetImage(0, 0, 0);
     if (img == nullptr) {
-        spdlog::debug("Failed to get image data from ScratchImage");
+        Logger::debug("Failed to get image data from ScratchImage");
         return {};
     }
 
@@ -1124,13 +1141,6 @@ auto ParallaxGenD3D::loadRawPixelsToScratchImage(const vector<unsigned char>& ra
     return image;
 }
 
-auto ParallaxGenD3D::getHRESULTErrorMessage(HRESULT hr) -> string
-{
-    // Get error message
-    const _com_error err(hr);
-    return err.ErrorMessage();
-}
-
 auto ParallaxGenD3D::getDXGIFormatFromString(const string& format) -> DXGI_FORMAT
 {
     if (format == "rgba16f") {
@@ -10,17 +10,19 @@
 #include <boost/thread.hpp>
 #include <filesystem>
 #include <mutex>
-#include <shlwapi.h>
-#include <spdlog/spdlog.h>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
-#include <winnt.h>
 
 #include "BethesdaDirectory.hpp"
+#include "Logger.hpp"
 #include "ModManagerDirectory.hpp"
 #include "NIFUtil.hpp"
 #include "PGDiag.hpp"
+#include "PGFileCache.hpp"
+#include "PGMemoryBudget.hpp"
+#include "PGOutputStore.hpp"
+#include "PGPlatform.hpp"
 #include "ParallaxGenRunner.hpp"
 #include "ParallaxGenTask.hpp"
 #include "ParallaxGenUtil.hpp"
@@ -30,12 +32,14 @@ using namespace ParallaxGenUtil;
 
 ParallaxGenDirectory::ParallaxGenDirectory(BethesdaGame* bg, filesystem::path outputPath, ModManagerDirectory* mmd)
     : BethesdaDirectory(bg, std::move(outputPath), mmd, true)
+    , m_outputStore(getGeneratedPath())
 {
 }
 
 ParallaxGenDirectory::ParallaxGenDirectory(
     filesystem::path dataPath, filesystem::path outputPath, ModManagerDirectory* mmd)
     : BethesdaDirectory(std::move(dataPath), std::move(outputPath), mmd, true)
+    , m_outputStore(getGeneratedPath())
 {
 }
 
@@ -46,7 +50,7 @@ auto ParallaxGenDirectory::findFiles() -> void
     m_unconfirmedMeshes.clear();
 
     // Populate unconfirmed maps
-    spdlog::info("Finding Relevant Files");
+    Logger::info("Finding Relevant Files");
     const auto& fileMap = getFileMap();
 
     if (fileMap.empty()) {
@@ -58,13 +62,13 @@ auto ParallaxGenDirectory::findFiles() -> void
         if (boost::iequals(firstPath, "textures") && boost::iequals(path.extension().wstring(), L".dds")) {
             if (!isPathAscii(path)) {
                 // Skip non-ascii paths
-                spdlog::warn(
+                Logger::warn(
                     L"Texture {} contains non-ascii characters which are not allowed - skipping", path.wstring());
                 continue;
             }
 
             // Found a DDS
-            spdlog::trace(L"Finding Files | Found DDS | {}", path.wstring());
+            Logger::trace(L"Finding Files | Found DDS | {}", path.wstring());
             m_unconfirmedTextures[path] = {};
 
             {
@@ -74,18 +78,18 @@ auto ParallaxGenDirectory::findFiles() -> void
             }
         } else if (boost::iequals(firstPath, "meshes") && boost::iequals(path.extension().wstring(), L".nif")) {
             // Found a NIF
-            spdlog::trace(L"Finding Files | Found NIF | {}", path.wstring());
+            Logger::trace(L"Finding Files | Found NIF | {}", path.wstring());
             m_unconfirmedMeshes.insert(path);
         } else if (boost::iequals(path.extension().wstring(), L".json")) {
             // Found a JSON file
             if (boost::iequals(firstPath, L"pbrnifpatcher")) {
                 // Found PBR JSON config
-                spdlog::trace(L"Finding Files | Found PBR JSON | {}", path.wstring());
+                Logger::trace(L"Finding Files | Found PBR JSON | {}", path.wstring());
                 m_pbrJSONs.push_back(path);
             }
         }
     }
-    spdlog::info("Finding files done");
+    Logger::info("Finding files done");
 }
 
 auto ParallaxGenDirectory::mapFiles(const vector<wstring>& nifBlocklist, const vector<wstring>& nifAllowlist,
@@ -98,7 +102,7 @@ auto ParallaxGenDirectory::mapFiles(const vector<wstring>& nifBlocklist, const v
     const unordered_map<wstring, NIFUtil::TextureType> manualTextureMapsMap(
         manualTextureMaps.begin(), manualTextureMaps.end());
 
-    spdlog::info("Starting building texture map");
+    Logger::info("Starting building texture map");
 
     // Create task tracker
     ParallaxGenTask taskTracker("Loading NIFs", m_unconfirmedMeshes.size(), MAPTEXTURE_PROGRESS_MODULO);
@@ -110,14 +114,14 @@ auto ParallaxGenDirectory::mapFiles(const vector<wstring>& nifBlocklist, const v
     for (const auto& mesh : m_unconfirmedMeshes) {
         if (!nifAllowlist.empty() && !checkGlobMatchInVector(mesh.wstring(), nifAllowlist)) {
             // Skip mesh because it is not on allowlist
-            spdlog::trace(L"Loading NIFs | Skipping Mesh due to Allowlist | Mesh: {}", mesh.wstring());
+            Logger::trace(L"Loading NIFs | Skipping Mesh due to Allowlist | Mesh: {}", mesh.wstring());
             taskTracker.completeJob(ParallaxGenTask::PGResult::SUCCESS);
             continue;
         }
 
         if (!nifBlocklist.empty() && checkGlobMatchInVector(mesh.wstring(), nifBlocklist)) {
             // Skip mesh because it is on blocklist
-            spdlog::trace(L"Loading NIFs | Skipping Mesh due to Blocklist | Mesh: {}", mesh.wstring());
+            Logger::trace(L"Loading NIFs | Skipping Mesh due to Blocklist | Mesh: {}", mesh.wstring());
             taskTracker.completeJob(ParallaxGenTask::PGResult::SUCCESS);
             continue;
         }
@@ -178,12 +182,12 @@ auto ParallaxGenDirectory::mapFiles(const vector<wstring>& nifBlocklist, const v
         }
 
         if ((winningSlot == NIFUtil::TextureSlots::PARALLAX) && isFileInBSA(texture, parallaxBSAExcludes)) {
-            spdlog::trace(L"Mapping Textures | Ignored vanilla parallax texture | Texture: {}", texture.wstring());
+            Logger::trace(L"Mapping Textures | Ignored vanilla parallax texture | Texture: {}", texture.wstring());
             continue;
         }
 
         // Log result
-        spdlog::trace(L"Mapping Textures | Mapping Result | Texture: {} | Slot: {} | Type: {}", texture.wstring(),
+        Logger::trace(L"Mapping Textures | Mapping Result | Texture: {} | Slot: {} | Type: {}", texture.wstring(),
             static_cast<size_t>(winningSlot), utf8toUTF16(NIFUtil::getStrFromTexType(winningType)));
 
         // Add to texture map
@@ -201,16 +205,13 @@ auto ParallaxGenDirectory::mapFiles(const vector<wstring>& nifBlocklist, const v
     m_unconfirmedTextures.clear();
     m_unconfirmedMeshes.clear();
 
-    spdlog::info("Mapping textures done");
+    Logger::info("Mapping textures done");
 }
 
 auto ParallaxGenDirectory::checkGlobMatchInVector(const wstring& check, const vector<std::wstring>& list) -> bool
 {
-    // convert wstring to LPCWSTR
-    LPCWSTR checkCstr = check.c_str();
-
     // check if string matches any glob
-    return std::ranges::any_of(list, [&](const wstring& glob) { return PathMatchSpecW(checkCstr, glob.c_str()); });
+    return std::ranges::any_of(list, [&](const wstring& glob) { return PGPlatform::globMatch(check, glob); });
 }
 
 auto ParallaxGenDirectory::mapTexturesFromNIF(const filesystem::path& nifPath, const bool& cacheNIFs)
@@ -219,21 +220,24 @@ auto ParallaxGenDirectory::mapTexturesFromNIF(const filesystem::path& nifPath, c
     auto result = ParallaxGenTask::PGResult::SUCCESS;
 
     // Load NIF
-    vector<std::byte> nifBytes;
+    PGFileCache::Buffer nifBytes;
     try {
-        nifBytes = getFile(nifPath, cacheNIFs);
+        nifBytes = getFileShared(nifPath, cacheNIFs);
     } catch (const exception& e) {
-        spdlog::error(L"Error reading NIF File \"{}\" (skipping): {}", nifPath.wstring(), asciitoUTF16(e.what()));
+        Logger::error(L"Error reading NIF File \"{}\" (skipping): {}", nifPath.wstring(), asciitoUTF16(e.what()));
         return ParallaxGenTask::PGResult::FAILURE;
     }
 
+    // Account for the NIF bytes while they are alive, unless the file cache already charges them
+    const PGMemoryBudget::Reservation nifReservation(getUnchargedBytes(nifPath, nifBytes));
+
     NifFile nif;
     try {
         // Attempt to load NIF file
-        nif = NIFUtil::loadNIFFromBytes(nifBytes);
+        nif = NIFUtil::loadNIFFromBytes(*nifBytes);
     } catch (const exception& e) {
         // Unable to read NIF, delete from Meshes set
-        spdlog::error(L"Error reading NIF File \"{}\" (skipping): {}", nifPath.wstring(), asciitoUTF16(e.what()));
+        Logger::error(L"Error reading NIF File \"{}\" (skipping): {}", nifPath.wstring(), asciitoUTF16(e.what()));
         return ParallaxGenTask::PGResult::FAILURE;
     }
 
@@ -266,7 +270,7 @@ auto ParallaxGenDirectory::mapTexturesFromNIF(const filesystem::path& nifPath, c
             nif.GetTextureSlot(shape, texture, slot);
 
             if (!containsOnlyAscii(texture)) {
-                spdlog::error(L"NIF {} has texture slot(s) with invalid non-ASCII chars (skipping)", nifPath.wstring());
+                Logger::error(L"NIF {} has texture slot(s) with invalid non-ASCII chars (skipping)", nifPath.wstring());
                 return ParallaxGenTask::PGResult::FAILURE;
             }
 
@@ -399,7 +403,7 @@ auto ParallaxGenDirectory::mapTexturesFromNIF(const filesystem::path& nifPath, c
             }
 
             // Log finding
-            spdlog::trace(L"Mapping Textures | Slot Found | NIF: {} | Texture: {} | Slot: {} | Type: {}",
+            Logger::trace(L"Mapping Textures | Slot Found | NIF: {} | Texture: {} | Slot: {} | Type: {}",
                 nifPath.wstring(), asciitoUTF16(texture), slot, utf8toUTF16(NIFUtil::getStrFromTexType(textureType)));
 
             // Update unconfirmed textures map
@@ -477,6 +481,10 @@ auto ParallaxGenDirectory::getTextures() const -> const unordered_set<filesystem
 
 auto ParallaxGenDirectory::getPBRJSONs() const -> const vector<filesystem::path>& { return m_pbrJSONs; }
 
+auto ParallaxGenDirectory::getTextureIndex() -> PGTextureIndex& { return m_textureIndex; }
+
+auto ParallaxGenDirectory::getOutputStore() -> PGOutputStore& { return m_outputStore; }
+
 auto ParallaxGenDirectory::addTextureAttribute(const filesystem::path& path, const NIFUtil::TextureAttribute& attribute)
     -> bool
 {
@@ -556,3 +564,96 @@ auto ParallaxGenDirectory::getTextureType(const filesystem::path& path) -> NIFUt
 
     return NIFUtil::TextureType::UNKNOWN;
 }
+
+auto ParallaxGenDirectory::getDDS(const filesystem::path& ddsPath, DirectX::ScratchImage& dds) -> bool
+{
+    HRESULT hr {};
+
+    if (isLooseFile(ddsPath)) {
+        Logger::trace(L"Reading DDS loose file {}", ddsPath.wstring());
+        const filesystem::path fullPath = getLooseFileFullPath(ddsPath);
+
+        // Load DDS file
+        hr = DirectX::LoadFromDDSFile(fullPath.wstring().c_str(), DirectX::DDS_FLAGS_NONE, nullptr, dds);
+    } else if (isBSAFile(ddsPath)) {
+        Logger::trace(L"Reading DDS BSA file {}", ddsPath.wstring());
+        vector<std::byte> ddsBytes = getFile(ddsPath);
+
+        // Load DDS file
+        hr = DirectX::LoadFromDDSMemory(ddsBytes.data(), ddsBytes.size(), DirectX::DDS_FLAGS_NONE, nullptr, dds);
+    } else {
+        return false;
+    }
+
+    if (FAILED(hr)) {
+        Logger::debug(
+            L"Failed to load DDS file from {}: {}", ddsPath.wstring(), asciitoUTF16(PGPlatform::getHRESULTMessage(hr)));
+        return false;
+    }
+
+    return true;
+}
+
+auto ParallaxGenDirectory::getDDSMetadata(const filesystem::path& ddsPath, DirectX::TexMetadata& ddsMeta) -> bool
+{
+    // Use lock_guard to make this method thread-safe
+    const lock_guard<mutex> lock(m_ddsMetaDataMutex);
+
+    // Check if in cache
+    // TODO set cache to something on failure
+    if (m_ddsMetaDataCache.find(ddsPath) != m_ddsMetaDataCache.end()) {
+        ddsMeta = m_ddsMetaDataCache[ddsPath];
+        return true;
+    }
+
+    HRESULT hr {};
+
+    if (isLooseFile(ddsPath)) {
+        Logger::trace(L"Reading DDS loose file metadata {}", ddsPath.wstring());
+        const filesystem::path fullPath = getLooseFileFullPath(ddsPath);
+
+        // Load DDS file
+        hr = DirectX::GetMetadataFromDDSFile(fullPath.wstring().c_str(), DirectX::DDS_FLAGS_NONE, ddsMeta);
+    } else if (isBSAFile(ddsPath)) {
+        Logger::trace(L"Reading DDS BSA file metadata {}", ddsPath.wstring());
+        vector<std::byte> ddsBytes = getFile(ddsPath);
+
+        // Load DDS file
+        hr = DirectX::GetMetadataFromDDSMemory(ddsBytes.data(), ddsBytes.size(), DirectX::DDS_FLAGS_NONE, ddsMeta);
+    } else {
+        return false;
+    }
+
+    if (FAILED(hr)) {
+        Logger::debug(L"Failed to load DDS file metadata from {}: {}", ddsPath.wstring(),
+            asciitoUTF16(PGPlatform::getHRESULTMessage(hr)));
+        return false;
+    }
+
+    // update cache
+    m_ddsMetaDataCache[ddsPath] = ddsMeta;
+
+    return true;
+}
+
+auto ParallaxGenDirectory::checkIfAspectRatioMatches(
+    const filesystem::path& ddsPath1, const filesystem::path& ddsPath2) -> bool
+{
+    // get metadata (should only pull headers, which is much faster)
+    DirectX::TexMetadata ddsImageMeta1 {};
+    if (!getDDSMetadata(ddsPath1, ddsImageMeta1)) {
+        return false;
+    }
+
+    DirectX::TexMetadata ddsImageMeta2 {};
+    if (!getDDSMetadata(ddsPath2, ddsImageMeta2)) {
+        return false;
+    }
+
+    // calculate aspect ratios
+    const float aspectRatio1 = static_cast<float>(ddsImageMeta1.width) / static_cast<float>(ddsImageMeta1.height);
+    const float aspectRatio2 = static_cast<float>(ddsImageMeta2.width) / static_cast<float>(ddsImageMeta2.height);
+
+    // check if aspect ratios don't match
+    return aspectRatio1 == aspectRatio2;
+}
@@ -2,12 +2,15 @@
 
 #include <mutex>
 #include <spdlog/spdlog.h>
+#include <system_error>
 #include <unordered_map>
-#include <winbase.h>
 
 #include "Logger.hpp"
 #include "NIFUtil.hpp"
 #include "PGDiag.hpp"
+#include "PGLogTransport.hpp"
+#include "PGPluginIndex.hpp"
+#include "PGPlatform.hpp"
 #include "PGMutagenNE.h"
 #include "ParallaxGenUtil.hpp"
 #include "ParallaxGenWarnings.hpp"
@@ -35,49 +38,38 @@ void dnneFailure(enum failure_type type, int errorCode)
 
 mutex ParallaxGenPlugin::s_libMutex;
 
+PGLogTransport ParallaxGenPlugin::s_logTransport([](uint16_t* buffer, const size_t& bufferSize) -> size_t {
+    int numWritten = 0;
+    GetLogMessages(buffer, static_cast<int>(bufferSize), &numWritten);
+    return static_cast<size_t>(numWritten);
+});
+
 void ParallaxGenPlugin::libLogMessageIfExists()
 {
-    static constexpr unsigned int TRACE_LOG = 0;
-    static constexpr unsigned int DEBUG_LOG = 1;
-    static constexpr unsigned int INFO_LOG = 2;
-    static constexpr unsigned int WARN_LOG = 3;
-    static constexpr unsigned int ERROR_LOG = 4;
-    static constexpr unsigned int CRITICAL_LOG = 5;
-
-    int level = 0;
-    wchar_t* message = nullptr;
-    GetLogMessage(&message, &level);
-
-    while (message != nullptr) {
-        const wstring messageOut(message);
-        LocalFree(static_cast<HGLOBAL>(message)); // Only free if memory was allocated.
-        message = nullptr;
-
-        // log the message
+    s_logTransport.drain([](const int& level, const wstring& message) {
         switch (level) {
-        case TRACE_LOG:
-            Logger::trace(messageOut);
+        case PGLogTransport::TRACE_LOG:
+            Logger::trace(message);
             break;
-        case DEBUG_LOG:
-            Logger::debug(messageOut);
+        case PGLogTransport::DEBUG_LOG:
+            Logger::debug(message);
             break;
-        case INFO_LOG:
-            Logger::info(messageOut);
+        case PGLogTransport::INFO_LOG:
+            Logger::info(message);
             break;
-        case WARN_LOG:
-            Logger::warn(messageOut);
+        case PGLogTransport::WARN_LOG:
+            Logger::warn(message);
             break;
-        case ERROR_LOG:
-            Logger::error(messageOut);
+        case PGLogTransport::ERROR_LOG:
+            Logger::error(message);
             break;
-        case CRITICAL_LOG:
-            Logger::critical(messageOut);
+        case PGLogTransport::CRITICAL_LOG:
+            Logger::critical(message);
+            break;
+        default:
             break;
         }
-
-        // Get the next message
-        GetLogMessage(&message, &level);
-    }
+    });
 }
 
 void ParallaxGenPlugin::libThrowExceptionIfExists()
@@ -90,7 +82,7 @@ void ParallaxGenPlugin::libThrowExceptionIfExists()
     }
 
     const wstring messageOut(message);
-    LocalFree(static_cast<HGLOBAL>(message)); // Only free if memory was allocated.
+    PGPlatform::freeNativeString(message); // Only free if memory was allocated.
 
     throw runtime_error("ParallaxGenMutagenWrapper.dll: " + ParallaxGenUtil::utf16toASCII(messageOut));
 }
@@ -112,6 +104,9 @@ void ParallaxGenPlugin::libInitialize(
     // Add the null terminator to the end
     loadOrderArr.push_back(nullptr);
 
+    // messages below this level are dropped before they are formatted
+    SetLogLevel(PGLogTransport::toManagedLevel(spdlog::get_level()));
+
     Initialize(gameType, exePath.c_str(), dataPath.c_str(), loadOrderArr.data());
     libLogMessageIfExists();
     libThrowExceptionIfExists();
@@ -135,37 +130,59 @@ void ParallaxGenPlugin::libFinalize(const filesystem::path& outputPath, const bo
     libThrowExceptionIfExists();
 }
 
-auto ParallaxGenPlugin::libGetMatchingTXSTObjs(const wstring& nifName, const int& index3D)
-    -> vector<tuple<int, int, wstring, string>>
+auto ParallaxGenPlugin::libGetTXSTRefs() -> PGPluginIndex
 {
     const lock_guard<mutex> lock(s_libMutex);
 
     int length = 0;
-    GetMatchingTXSTObjs(nifName.c_str(), index3D, nullptr, nullptr, nullptr, nullptr, &length);
+    GetTXSTRefs(nullptr, nullptr, nullptr, nullptr, nullptr, &length);
     libLogMessageIfExists();
     libThrowExceptionIfExists();
 
+    vector<wchar_t*> nifNameArray(length);
+    vector<int> index3DArray(length);
     vector<int> txstIdArray(length);
     vector<int> altTexIdArray(length);
-    vector<wchar_t*> matchedNIFArray(length);
     vector<char*> matchTypeArray(length);
-    GetMatchingTXSTObjs(nifName.c_str(), index3D, txstIdArray.data(), altTexIdArray.data(), matchedNIFArray.data(),
+    GetTXSTRefs(nifNameArray.data(), index3DArray.data(), txstIdArray.data(), altTexIdArray.data(),
         matchTypeArray.data(), nullptr);
     libLogMessageIfExists();
     libThrowExceptionIfExists();
 
-    vector<tuple<int, int, wstring, string>> outputArray(length);
+    PGPluginIndex pluginIndex;
     for (int i = 0; i < length; ++i) {
-        const auto* matchedNIFStr = static_cast<const wchar_t*>(matchedNIFArray.at(i));
-        LocalFree(static_cast<HGLOBAL>(matchedNIFArray.at(i)));
+        const wstring nifNameStr = nifNameArray.at(i) != nullptr ? nifNameArray.at(i) : L"";
+        PGPlatform::freeNativeString(nifNameArray.at(i));
 
-        const auto* matchTypeStr = static_cast<const char*>(matchTypeArray.at(i));
-        LocalFree(static_cast<HGLOBAL>(matchTypeArray.at(i)));
+        string matchTypeStr = matchTypeArray.at(i) != nullptr ? matchTypeArray.at(i) : "";
+        PGPlatform::freeNativeString(matchTypeArray.at(i));
 
-        outputArray[i] = { txstIdArray[i], altTexIdArray[i], matchedNIFStr, matchTypeStr };
+        pluginIndex.add(nifNameStr, index3DArray[i],
+            { .txstHandle = txstIdArray[i], .altTexHandle = altTexIdArray[i], .type = std::move(matchTypeStr) });
     }
 
-    return outputArray;
+    return pluginIndex;
+}
+
+void ParallaxGenPlugin::libSaveRecordIndex(const filesystem::path& file)
+{
+    const lock_guard<mutex> lock(s_libMutex);
+
+    SaveRecordIndex(file.wstring().c_str());
+    libLogMessageIfExists();
+    libThrowExceptionIfExists();
+}
+
+auto ParallaxGenPlugin::libLoadRecordIndex(const filesystem::path& file) -> bool
+{
+    const lock_guard<mutex> lock(s_libMutex);
+
+    int success = 0;
+    LoadRecordIndex(file.wstring().c_str(), &success);
+    libLogMessageIfExists();
+    libThrowExceptionIfExists();
+
+    return success != 0;
 }
 
 auto ParallaxGenPlugin::libGetTXSTSlots(const int& txstIndex) -> array<wstring, NUM_TEXTURE_SLOTS>
@@ -188,7 +205,7 @@ auto ParallaxGenPlugin::libGetTXSTSlots(const int& txstIndex) -> array<wstring,
             outputArray.at(i) = slotStr;
 
             // Free the unmanaged memory allocated by Marshal.StringToHGlobalAnsi
-            LocalFree(static_cast<HGLOBAL>(slotsArray.at(i)));
+            PGPlatform::freeNativeString(slotsArray.at(i));
         }
     }
 
@@ -263,7 +280,7 @@ auto ParallaxGenPlugin::libGetTXSTFormID(const int& txstIndex) -> tuple<unsigned
     wstring pluginNameString;
     if (pluginName != nullptr) {
         pluginNameString = wstring(pluginName);
-        LocalFree(static_cast<HGLOBAL>(pluginName)); // Only free if memory was allocated.
+        PGPlatform::freeNativeString(pluginName); // Only free if memory was allocated.
     } else {
         // Handle the case where PluginName is null
         pluginNameString = L"Unknown";
@@ -272,7 +289,7 @@ auto ParallaxGenPlugin::libGetTXSTFormID(const int& txstIndex) -> tuple<unsigned
     wstring winningPluginNameString;
     if (winningPluginName != nullptr) {
         winningPluginNameString = wstring(winningPluginName);
-        LocalFree(static_cast<HGLOBAL>(winningPluginName)); // Only free if memory was allocated.
+        PGPlatform::freeNativeString(winningPluginName); // Only free if memory was allocated.
     } else {
         // Handle the case where WinningPluginName is null
         winningPluginNameString = L"Unknown";
@@ -295,7 +312,7 @@ auto ParallaxGenPlugin::libGetModelRecFormID(const int& modelRecHandle) -> tuple
     wstring pluginNameString;
     if (pluginName != nullptr) {
         pluginNameString = wstring(pluginName);
-        LocalFree(static_cast<HGLOBAL>(pluginName)); // Only free if memory was allocated.
+        PGPlatform::freeNativeString(pluginName); // Only free if memory was allocated.
     } else {
         // Handle the case where PluginName is null
         pluginNameString = L"Unknown";
@@ -304,7 +321,7 @@ auto ParallaxGenPlugin::libGetModelRecFormID(const int& modelRecHandle) -> tuple
     wstring winningPluginNameString;
     if (winningPluginName != nullptr) {
         winningPluginNameString = wstring(winningPluginName);
-        LocalFree(static_cast<HGLOBAL>(winningPluginName)); // Only free if memory was allocated.
+        PGPlatform::freeNativeString(winningPluginName); // Only free if memory was allocated.
     } else {
         // Handle the case where WinningPluginName is null
         winningPluginNameString = L"Unknown";
@@ -327,7 +344,7 @@ auto ParallaxGenPlugin::libGetAltTexFormID(const int& altTexIndex) -> tuple<unsi
     wstring pluginNameString;
     if (pluginName != nullptr) {
         pluginNameString = wstring(pluginName);
-        LocalFree(static_cast<HGLOBAL>(pluginName)); // Only free if memory was allocated.
+        PGPlatform::freeNativeString(pluginName); // Only free if memory was allocated.
     } else {
         // Handle the case where PluginName is null
         pluginNameString = L"Unknown";
@@ -336,7 +353,7 @@ auto ParallaxGenPlugin::libGetAltTexFormID(const int& altTexIndex) -> tuple<unsi
     wstring winningPluginNameString;
     if (winningPluginName != nullptr) {
         winningPluginNameString = wstring(winningPluginName);
-        LocalFree(static_cast<HGLOBAL>(winningPluginName)); // Only free if memory was allocated.
+        PGPlatform::freeNativeString(winningPluginName); // Only free if memory was allocated.
     } else {
         // Handle the case where WinningPluginName is null
         winningPluginNameString = L"Unknown";
@@ -367,21 +384,12 @@ void ParallaxGenPlugin::libSetModelRecNIF(const int& modelRecHandle, const wstri
 }
 
 // Statics
-unordered_map<string, unsigned int> ParallaxGenPlugin::s_txstFormIDs;
-unordered_map<string, unsigned int> ParallaxGenPlugin::s_newTXSTFormIDs;
-unordered_set<unsigned int> ParallaxGenPlugin::s_txstResrvedFormIDs;
-unordered_set<unsigned int> ParallaxGenPlugin::s_txstUsedFormIDs;
-unsigned int ParallaxGenPlugin::s_curTXSTFormID = 0;
-
-mutex ParallaxGenPlugin::s_createdTXSTMutex;
-unordered_map<array<wstring, NUM_TEXTURE_SLOTS>, pair<int, string>, ParallaxGenPlugin::ArrayHash,
-    ParallaxGenPlugin::ArrayEqual>
-    ParallaxGenPlugin::s_createdTXSTs;
+PGTXSTIndex ParallaxGenPlugin::s_txstIndex;
+PGPluginIndex ParallaxGenPlugin::s_pluginIndex;
+nlohmann::json ParallaxGenPlugin::s_pluginFingerprint;
 
 ParallaxGenDirectory* ParallaxGenPlugin::s_pgd;
 
-mutex ParallaxGenPlugin::s_processShapeMutex;
-
 void ParallaxGenPlugin::loadStatics(ParallaxGenDirectory* pgd) { ParallaxGenPlugin::s_pgd = pgd; }
 
 unordered_map<wstring, int>* ParallaxGenPlugin::s_modPriority;
@@ -401,36 +409,41 @@ void ParallaxGenPlugin::initialize(const BethesdaGame& game, const filesystem::p
               { BethesdaGame::GameType::SKYRIM_VR, 3 }, { BethesdaGame::GameType::ENDERAL, 5 },
               { BethesdaGame::GameType::ENDERAL_SE, 6 }, { BethesdaGame::GameType::SKYRIM_GOG, 7 } };
 
-    libInitialize(
-        mutagenGameTypeMap.at(game.getGameType()), exePath, game.getGameDataPath().wstring(), game.getActivePlugins());
+    const auto activePlugins = game.getActivePlugins();
+    s_pluginFingerprint = PGPluginIndex::getFingerprint(game.getGameDataPath(), activePlugins);
+
+    libInitialize(mutagenGameTypeMap.at(game.getGameType()), exePath, game.getGameDataPath().wstring(), activePlugins);
 }
 
-void ParallaxGenPlugin::loadTXSTCache(const nlohmann::json& txstCache)
-{
-    s_newTXSTFormIDs.clear();
+void ParallaxGenPlugin::loadTXSTCache(const nlohmann::json& txstCache) { s_txstIndex.loadFormIDCache(txstCache); }
 
-    // loop through json objects
-    for (const auto& [key, value] : txstCache.items()) {
-        // convert key to array
-        s_txstFormIDs[key] = value.get<unsigned int>();
-        s_txstResrvedFormIDs.insert(value.get<unsigned int>());
-    }
-}
+auto ParallaxGenPlugin::getTXSTCache() -> nlohmann::json { return s_txstIndex.getFormIDCache(); }
 
-auto ParallaxGenPlugin::getTXSTCache() -> nlohmann::json
+void ParallaxGenPlugin::populateObjs(const filesystem::path& cacheDir)
 {
-    nlohmann::json txstCache;
+    const auto indexFile = cacheDir / "pluginIndex.json";
+    const auto recordsFile = cacheDir / "pluginRecords.json";
 
-    // loop through map
-    for (const auto& [key, value] : s_newTXSTFormIDs) {
-        txstCache[key] = value;
+    if (!cacheDir.empty() && s_pluginIndex.load(indexFile, s_pluginFingerprint) && libLoadRecordIndex(recordsFile)) {
+        Logger::info("Load order is unchanged, using cached plugin index with {} references", s_pluginIndex.size());
+        return;
     }
 
-    return txstCache;
+    libPopulateObjs();
+    s_pluginIndex = libGetTXSTRefs();
+
+    if (!cacheDir.empty()) {
+        // records first, an index without them is never valid
+        error_code ec;
+        filesystem::create_directories(cacheDir, ec);
+        filesystem::remove(indexFile, ec);
+        libSaveRecordIndex(recordsFile);
+        if (!s_pluginIndex.save(indexFile, s_pluginFingerprint)) {
+            filesystem::remove(indexFile, ec);
+        }
+    }
 }
 
-void ParallaxGenPlugin::populateObjs() { libPopulateObjs(); }
-
 auto ParallaxGenPlugin::getKeyFromFormID(const tuple<unsigned int, wstring, wstring>& formID) -> string
 {
     return ParallaxGenUtil::utf16toUTF8(get<1>(formID)) + " (" + ParallaxGenUtil::utf16toUTF8(get<2>(formID)) + ") "
@@ -441,12 +454,10 @@ void ParallaxGenPlugin::processShape(const wstring& nifPath, nifly::NiShape* nif
     PatcherUtil::PatcherMeshObjectSet& patchers, vector<TXSTResult>& results, const string& shapeKey,
     PatcherUtil::ConflictModResults* conflictMods)
 {
-    const lock_guard<mutex> lock(s_processShapeMutex);
-
     results.clear();
 
     // loop through matches
-    const auto matches = libGetMatchingTXSTObjs(nifPath, index3D);
+    const auto matches = s_pluginIndex.getMatches(nifPath, index3D);
     for (const auto& [txstIndex, altTexIndex, matchedNIF, matchType] : matches) {
         // create keys for diagnostics
         string altTexJSONKey;
@@ -542,16 +553,13 @@ void ParallaxGenPlugin::processShape(const wstring& nifPath, nifly::NiShape* nif
             if (modSet.size() > 1) {
                 const lock_guard<mutex> lock(conflictMods->mutex);
 
-                // add mods to conflict set
+                // add mods to conflict graph
+                vector<pair<wstring, NIFUtil::ShapeShader>> conflictMatches;
+                conflictMatches.reserve(matches.size());
                 for (const auto& match : matches) {
-                    if (conflictMods->mods.find(match.mod) == conflictMods->mods.end()) {
-                        conflictMods->mods.insert(
-                            { match.mod, { set<NIFUtil::ShapeShader>(), unordered_set<wstring>() } });
-                    }
-
-                    get<0>(conflictMods->mods[match.mod]).insert(match.shader);
-                    get<1>(conflictMods->mods[match.mod]).insert(modSet.begin(), modSet.end());
+                    conflictMatches.emplace_back(match.mod, match.shader);
                 }
+                conflictMods->graph.addConflict(conflictMatches);
             }
 
             continue;
@@ -610,7 +618,7 @@ void ParallaxGenPlugin::processShape(const wstring& nifPath, nifly::NiShape* nif
 
         if (!foundDiff) {
             // No need to patch
-            spdlog::trace(L"Plugin Patching | {} | {} | Not patching because nothing to change", nifPath, index3D);
+            Logger::trace(L"Plugin Patching | {} | {} | Not patching because nothing to change", nifPath, index3D);
             curResult.txstIndex = txstIndex;
             results.push_back(curResult);
             continue;
@@ -618,61 +626,34 @@ void ParallaxGenPlugin::processShape(const wstring& nifPath, nifly::NiShape* nif
 
         PGDiag::insert("newTextures", NIFUtil::textureSetToStr(newSlots));
 
-        {
-            const lock_guard<mutex> lock(s_createdTXSTMutex);
-
-            // Check if we need to make a new TXST record
-            if (s_createdTXSTs.contains(newSlots)) {
-                // Already modded
-                spdlog::trace(L"Plugin Patching | {} | {} | Already added, skipping", nifPath, index3D);
-                curResult.txstIndex = s_createdTXSTs[newSlots].first;
-                results.push_back(curResult);
+        // Creates a new TXST record, only called if these slots have not been created yet
+        const auto createTXST = [&]() -> PGTXSTIndex::Entry {
+            Logger::trace(L"Plugin Patching | {} | {} | Creating a new TXST record and patching", nifPath, index3D);
 
-                PGDiag::insert("newTXST", s_createdTXSTs[newSlots].second);
-
-                continue;
-            }
-
-            // Create a new TXST record
-            spdlog::trace(L"Plugin Patching | {} | {} | Creating a new TXST record and patching", nifPath, index3D);
-
-            // Find formID to use
-            unsigned int newFormID = 0;
-            if (s_txstFormIDs.contains(txstFormIDCacheKey)
-                && !s_txstUsedFormIDs.contains(s_txstFormIDs[txstFormIDCacheKey])) {
-                // use old formid for new record
-                newFormID = s_txstFormIDs[txstFormIDCacheKey];
-            } else {
-                // find next available formid
-                while (s_txstResrvedFormIDs.contains(++s_curTXSTFormID)) { }
-                newFormID = s_curTXSTFormID;
-            }
-
-            if (newFormID == 0) {
-                throw runtime_error("Failed to find a new form ID for TXST record");
-            }
-
-            if (s_txstUsedFormIDs.contains(newFormID)) {
-                throw runtime_error("Form ID already in use");
-            }
-
-            // Insert used FORMID
-            s_txstUsedFormIDs.insert(newFormID);
-
-            // Find EDID
-            const string newEDID = fmt::format("PGTXST{:06X}", newFormID);
+            // Find formID and EDID to use
+            const auto newFormID = s_txstIndex.allocateFormID(txstFormIDCacheKey);
+            const string newEDID = PGTXSTIndex::getEDID(newFormID);
 
             // create new TXST record with chosen form ID
-            curResult.txstIndex = libCreateNewTXSTPatch(altTexIndex, newSlots, newEDID, newFormID);
-            s_newTXSTFormIDs[txstFormIDCacheKey] = newFormID;
+            const int newTXSTIndex = libCreateNewTXSTPatch(curResult.altTexIndex, newSlots, newEDID, newFormID);
 
             patchers.shaderPatchers.at(winningShaderMatch.shader)
                 ->processNewTXSTRecord(winningShaderMatch.match, newEDID);
-            s_createdTXSTs[newSlots] = { curResult.txstIndex, newEDID };
 
-            PGDiag::insert("newTXST", newEDID);
+            return { .txstIndex = newTXSTIndex, .edid = newEDID };
+        };
+
+        const auto [txstEntry, createdTXST]
+            = s_txstIndex.getOrCreate(PGTXSTIndex::SlotKey::fromSlots(newSlots), createTXST);
+
+        if (!createdTXST) {
+            // Already modded
+            Logger::trace(L"Plugin Patching | {} | {} | Already added, skipping", nifPath, index3D);
         }
 
+        curResult.txstIndex = txstEntry.txstIndex;
+        PGDiag::insert("newTXST", txstEntry.edid);
+
         // add to result
         results.push_back(curResult);
     }
@@ -680,8 +661,6 @@ void ParallaxGenPlugin::processShape(const wstring& nifPath, nifly::NiShape* nif
 
 void ParallaxGenPlugin::assignMesh(const wstring& nifPath, const wstring& baseNIFPath, const vector<TXSTResult>& result)
 {
-    const lock_guard<mutex> lock(s_processShapeMutex);
-
     const Logger::Prefix prefix(L"assignMesh");
 
     // Loop through results
@@ -716,14 +695,12 @@ void ParallaxGenPlugin::assignMesh(const wstring& nifPath, const wstring& baseNI
 void ParallaxGenPlugin::set3DIndices(
     const wstring& nifPath, const vector<tuple<nifly::NiShape*, int, int, string>>& shapeTracker)
 {
-    const lock_guard<mutex> lock(s_processShapeMutex);
-
     const Logger::Prefix prefix(L"set3DIndices");
 
     // Loop through shape tracker
     for (const auto& [shape, oldIndex3D, newIndex3D, shapeLabel] : shapeTracker) {
         // find matches
-        const auto matches = libGetMatchingTXSTObjs(nifPath, oldIndex3D);
+        const auto matches = s_pluginIndex.getMatches(nifPath, oldIndex3D);
 
         // Set indices
         for (const auto& [txstIndex, altTexIndex, matchedNIF, matchType] : matches) {
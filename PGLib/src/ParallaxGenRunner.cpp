@@ -1,7 +1,12 @@
 #include "ParallaxGenRunner.hpp"
+#include "Logger.hpp"
+#include "PGMemoryBudget.hpp"
 
 #include <cpptrace/from_current.hpp>
 
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
 #include <mutex>
 #include <spdlog/spdlog.h>
 #include <stdexcept>
@@ -49,6 +54,12 @@ void ParallaxGenRunner::runTasks()
                     return;
                 }
 
+                // Admission control: hold off starting new work while the memory budget is nearly exhausted
+                PGMemoryBudget::waitForHeadroom([&exceptionThrown] { return exceptionThrown.load(); });
+                if (exceptionThrown.load()) {
+                    return;
+                }
+
                 CPPTRACE_TRY
                 {
                     task();
@@ -62,6 +73,9 @@ void ParallaxGenRunner::runTasks()
                         exceptionStackTrace = cpptrace::from_current_exception().to_string();
                         exceptionThrown.store(true);
                     }
+
+                    // tasks waiting for headroom would otherwise wait on memory this task may never release
+                    PGMemoryBudget::notifyHeadroom();
                 }
             });
     }
@@ -84,6 +98,79 @@ void ParallaxGenRunner::runTasks()
     }
 }
 
+auto ParallaxGenRunner::getHelperPool() -> boost::asio::thread_pool&
+{
+    static boost::asio::thread_pool s_helperPool(max(std::thread::hardware_concurrency(), 1U));
+    return s_helperPool;
+}
+
+void ParallaxGenRunner::parallelFor(const size_t& count, const function<void(size_t)>& func, const bool& multithread)
+{
+    if (count == 0) {
+        return;
+    }
+
+    const auto numHelpers = multithread ? min<size_t>(count, max(std::thread::hardware_concurrency(), 1U)) - 1 : 0;
+    if (numHelpers == 0) {
+        for (size_t i = 0; i < count; ++i) {
+            func(i);
+        }
+        return;
+    }
+
+    struct State {
+        const function<void(size_t)>* func = nullptr;
+        size_t count = 0;
+        std::atomic<size_t> next = 0;
+        std::atomic<size_t> finished = 0;
+        std::mutex mutex;
+        std::condition_variable finishedCV;
+        std::exception_ptr error;
+    };
+
+    // helpers may start after this call returned, so they only ever touch func after claiming an index
+    auto state = make_shared<State>();
+    state->func = &func;
+    state->count = count;
+
+    const auto runIndices = [](State& state) {
+        while (true) {
+            const auto index = state.next.fetch_add(1);
+            if (index >= state.count) {
+                return;
+            }
+
+            try {
+                (*state.func)(index);
+            } catch (...) {
+                const lock_guard<mutex> lock(state.mutex);
+                if (!state.error) {
+                    state.error = current_exception();
+                }
+            }
+
+            if (state.finished.fetch_add(1) + 1 == state.count) {
+                const lock_guard<mutex> lock(state.mutex);
+                state.finishedCV.notify_all();
+            }
+        }
+    };
+
+    auto& pool = getHelperPool();
+    for (size_t i = 0; i < numHelpers; ++i) {
+        boost::asio::post(pool, [state, runIndices] { runIndices(*state); });
+    }
+
+    runIndices(*state);
+
+    unique_lock<mutex> lock(state->mutex);
+    state->finishedCV.wait(lock, [&state] { return state->finished.load() >= state->count; });
+
+    if (state->error) {
+        rethrow_exception(state->error);
+    }
+}
+
 void ParallaxGenRunner::processException(const exception& e, const string& stacktrace)
 {
     processException(e, stacktrace, true);
@@ -97,6 +184,9 @@ void ParallaxGenRunner::processException(
         return;
     }
 
+    // Make sure everything logged before the exception is written first
+    Logger::flush();
+
     spdlog::critical("An unhandled exception occured. Please provide your full log in the bug report.");
     spdlog::critical(R"(Exception type: "{}" / Message: "{}")", typeid(e).name(), e.what());
     spdlog::critical(stacktrace);
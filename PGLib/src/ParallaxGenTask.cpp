@@ -1,87 +1,130 @@
 #include "ParallaxGenTask.hpp"
 
-#include <spdlog/spdlog.h>
+#include "Logger.hpp"
+
+#include <cmath>
 
 using namespace std;
 
-ParallaxGenTask::ParallaxGenTask(string taskName, const size_t& totalJobs, const int& progressPrintModulo)
-    : m_progressPrintModulo(progressPrintModulo)
-    , m_taskName(std::move(taskName))
-    , m_totalJobs(totalJobs)
+namespace {
+constexpr int64_t SECONDS_PER_MINUTE = 60;
+constexpr int64_t SECONDS_PER_HOUR = 3600;
+
+auto formatDuration(const chrono::seconds& duration) -> string
 {
-    initJobStatus();
+    const auto seconds = duration.count();
+    return fmt::format("{}:{:02}:{:02}", seconds / SECONDS_PER_HOUR, (seconds % SECONDS_PER_HOUR) / SECONDS_PER_MINUTE,
+        seconds % SECONDS_PER_MINUTE);
 }
+} // namespace
 
-void ParallaxGenTask::completeJob(const PGResult& result)
+ParallaxGenTask::RateWindow::RateWindow(const chrono::milliseconds& window)
+    : m_window(window)
 {
-    // Use lock_guard to make this method thread-safe
-    const lock_guard<mutex> lock(m_numJobsCompletedMutex);
+}
 
-    m_numJobsCompleted[result]++;
-    printJobStatus();
+void ParallaxGenTask::RateWindow::addSample(const Clock::time_point& time, const size_t& completedJobs)
+{
+    m_samples.emplace_back(time, completedJobs);
+
+    // keep the newest sample that is at least a window old, so the rate always spans the full window once it can
+    while (m_samples.size() > 2 && time - m_samples[1].first >= m_window) {
+        m_samples.pop_front();
+    }
 }
 
-void ParallaxGenTask::initJobStatus()
+auto ParallaxGenTask::RateWindow::getRate() const -> double
 {
-    m_lastPerc = 0;
+    if (m_samples.size() < 2) {
+        return 0.0;
+    }
 
-    // Initialize all known PGResult values
-    m_numJobsCompleted[PGResult::FAILURE] = 0;
-    m_numJobsCompleted[PGResult::SUCCESS] = 0;
-    m_numJobsCompleted[PGResult::SUCCESS_WITH_WARNINGS] = 0;
+    const auto& [firstTime, firstJobs] = m_samples.front();
+    const auto& [lastTime, lastJobs] = m_samples.back();
+    const auto elapsed = chrono::duration<double>(lastTime - firstTime).count();
+    if (elapsed < chrono::duration<double>(chrono::milliseconds(1)).count()) {
+        return 0.0;
+    }
 
-    spdlog::info("{} Starting...", m_taskName);
+    return static_cast<double>(lastJobs - firstJobs) / elapsed;
 }
 
-void ParallaxGenTask::printJobStatus(bool force)
+auto ParallaxGenTask::RateWindow::getETA(const size_t& remainingJobs) const -> optional<chrono::seconds>
 {
-    size_t combinedJobs = getCompletedJobs();
-    size_t perc = combinedJobs * FULL_PERCENTAGE / m_totalJobs;
-    if (force || perc != m_lastPerc) {
-        m_lastPerc = perc;
-
-        if (perc % m_progressPrintModulo == 0) {
-            spdlog::info("{} Progress: {}/{} [{}%]", m_taskName, combinedJobs, m_totalJobs, perc);
-        }
+    const auto rate = getRate();
+    if (rate <= 0.0) {
+        return nullopt;
     }
 
-    if (perc == FULL_PERCENTAGE) {
-        printJobSummary();
+    return chrono::seconds(static_cast<int64_t>(ceil(static_cast<double>(remainingJobs) / rate)));
+}
+
+ParallaxGenTask::ParallaxGenTask(string taskName, const size_t& totalJobs, const int& progressPrintModulo)
+    : m_progressPrintModulo(progressPrintModulo)
+    , m_taskName(std::move(taskName))
+    , m_totalJobs(totalJobs)
+    , m_rateWindow(RATE_WINDOW)
+{
+    Logger::info("{} Starting...", m_taskName);
+
+    m_rateWindow.addSample(RateWindow::Clock::now(), 0);
+
+    if (m_totalJobs > 0) {
+        m_observer = thread(&ParallaxGenTask::observerMain, this);
     }
 }
 
-void ParallaxGenTask::printJobSummary()
+ParallaxGenTask::~ParallaxGenTask()
 {
-    // Print each job status Result
-    string outputLog = m_taskName + " Summary: ";
-    for (const auto& pair : m_numJobsCompleted) {
-        if (pair.second > 0) {
-            const string stateStr = m_pgResultStr[pair.first];
-            outputLog += "[ " + stateStr + " : " + to_string(pair.second) + " ] ";
-        }
+    {
+        const lock_guard<mutex> lock(m_reportMutex);
+        m_stopObserver = true;
+    }
+    m_reportCV.notify_one();
+
+    if (m_observer.joinable()) {
+        m_observer.join();
     }
-    outputLog += "See log to see error messages, if any.";
-    spdlog::info(outputLog);
 }
 
-auto ParallaxGenTask::getCompletedJobs() -> size_t
+void ParallaxGenTask::completeJob(const PGResult& result)
 {
-    // Initialize the Sum variable
-    size_t sum = 0;
+    m_numJobsCompleted.at(static_cast<size_t>(result)).fetch_add(1, memory_order_relaxed);
 
-    // Iterate through the unordered_map and sum the values
-    for (const auto& pair : m_numJobsCompleted) {
-        sum += pair.second;
+    // acq_rel so the worker of the last job sees every per-result increment
+    if (m_numJobsCompletedTotal.fetch_add(1, memory_order_acq_rel) + 1 != m_totalJobs) {
+        return;
     }
 
-    return sum;
+    // notified under the lock, the task may be destroyed as soon as this job returns
+    const lock_guard<mutex> lock(m_reportMutex);
+    report(true);
+    m_stopObserver = true;
+    m_reportCV.notify_one();
 }
 
 auto ParallaxGenTask::isCompleted() -> bool
 {
-    const lock_guard<mutex> lock(m_numJobsCompletedMutex);
+    return m_numJobsCompletedTotal.load(memory_order_acquire) == m_totalJobs;
+}
+
+auto ParallaxGenTask::getProgress() const -> Progress
+{
+    Progress progress = { .taskName = m_taskName, .totalJobs = m_totalJobs };
+
+    // the total is read first, the per-result counts are incremented before it and add up to at least that much
+    progress.completedJobs = m_numJobsCompletedTotal.load(memory_order_acquire);
+    for (size_t i = 0; i < NUM_RESULTS; ++i) {
+        progress.completedByResult.at(i) = m_numJobsCompleted.at(i).load(memory_order_relaxed);
+    }
 
-    return getCompletedJobs() == m_totalJobs;
+    return progress;
+}
+
+void ParallaxGenTask::setProgressCallback(ProgressCallback callback)
+{
+    const lock_guard<mutex> lock(s_progressCallbackMutex);
+    s_progressCallback = std::move(callback);
 }
 
 void ParallaxGenTask::updatePGResult(PGResult& result, const PGResult& currentResult, const PGResult& threshold)
@@ -94,3 +137,64 @@ void ParallaxGenTask::updatePGResult(PGResult& result, const PGResult& currentRe
         }
     }
 }
+
+void ParallaxGenTask::observerMain()
+{
+    unique_lock<mutex> lock(m_reportMutex);
+    while (!m_reportCV.wait_for(lock, REPORT_INTERVAL, [this] { return m_stopObserver; })) {
+        report(false);
+    }
+}
+
+void ParallaxGenTask::report(const bool& finished)
+{
+    if (m_finished) {
+        return;
+    }
+
+    auto progress = getProgress();
+    progress.finished = finished;
+
+    m_rateWindow.addSample(RateWindow::Clock::now(), progress.completedJobs);
+    progress.jobsPerSecond = m_rateWindow.getRate();
+    progress.eta = m_rateWindow.getETA(m_totalJobs - progress.completedJobs);
+
+    const size_t perc = progress.completedJobs * FULL_PERCENTAGE / m_totalJobs;
+    const size_t printStep = perc / static_cast<size_t>(m_progressPrintModulo);
+    if (printStep > m_lastPrintStep || (finished && perc != m_lastPrintStep * m_progressPrintModulo)) {
+        m_lastPrintStep = printStep;
+
+        if (finished) {
+            Logger::info("{} Progress: {}/{} [{}%]", m_taskName, progress.completedJobs, m_totalJobs, perc);
+        } else if (progress.eta.has_value()) {
+            Logger::info("{} Progress: {}/{} [{}%] {:.1f}/s, ETA {}", m_taskName, progress.completedJobs,
+                m_totalJobs, perc, progress.jobsPerSecond, formatDuration(*progress.eta));
+        } else {
+            Logger::info("{} Progress: {}/{} [{}%]", m_taskName, progress.completedJobs, m_totalJobs, perc);
+        }
+    }
+
+    if (finished) {
+        m_finished = true;
+        printJobSummary(progress);
+    }
+
+    const lock_guard<mutex> callbackLock(s_progressCallbackMutex);
+    if (s_progressCallback) {
+        s_progressCallback(progress);
+    }
+}
+
+void ParallaxGenTask::printJobSummary(const Progress& progress) const
+{
+    // Print each job status Result
+    string outputLog = m_taskName + " Summary: ";
+    for (size_t i = 0; i < NUM_RESULTS; ++i) {
+        const auto numJobs = progress.completedByResult.at(i);
+        if (numJobs > 0) {
+            outputLog += "[ " + string(PG_RESULT_STR.at(i)) + " : " + to_string(numJobs) + " ] ";
+        }
+    }
+    outputLog += "See log to see error messages, if any.";
+    Logger::info(outputLog);
+}
@@ -5,10 +5,13 @@
 
 #include <boost/algorithm/string.hpp>
 #include <boost/locale.hpp>
-#include <fstream>
 #include <iostream>
-#include <wingdi.h>
-#include <winnt.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#include "PGPlatform.hpp"
 
 using namespace std;
 namespace ParallaxGenUtil {
@@ -101,7 +104,17 @@ auto utf16VectorToASCII(const vector<wstring>& vec) -> vector<string>
     return out;
 }
 
-auto toLowerASCII(const std::wstring& str) -> std::wstring { return boost::to_lower_copy(str, std::locale::classic()); }
+auto toLowerASCII(const std::wstring& str) -> std::wstring
+{
+    // A-Z only, independent of locale and CRT, PGMutagen lowercases NIF names the same way
+    wstring out = str;
+    for (auto& c : out) {
+        if (c >= L'A' && c <= L'Z') {
+            c = static_cast<wchar_t>(c - L'A' + L'a');
+        }
+    }
+    return out;
+}
 
 auto utf8toUTF16(const string& str) -> wstring
 {
@@ -110,12 +123,17 @@ auto utf8toUTF16(const string& str) -> wstring
         return {};
     }
 
+#ifdef _WIN32
     // Convert string > wstring
     const int sizeNeeded = MultiByteToWideChar(CP_UTF8, 0, str.c_str(), (int)str.length(), nullptr, 0);
     std::wstring wStr(sizeNeeded, 0);
     MultiByteToWideChar(CP_UTF8, 0, str.data(), (int)str.length(), wStr.data(), sizeNeeded);
 
     return wStr;
+#else
+    // wchar_t is UTF-32 here
+    return boost::locale::conv::utf_to_utf<wchar_t>(str);
+#endif
 }
 
 auto utf16toUTF8(const wstring& wStr) -> string
@@ -125,12 +143,16 @@ auto utf16toUTF8(const wstring& wStr) -> string
         return {};
     }
 
+#ifdef _WIN32
     // Convert wstring > string
     const int sizeNeeded = WideCharToMultiByte(CP_UTF8, 0, wStr.data(), (int)wStr.size(), nullptr, 0, nullptr, nullptr);
     string str(sizeNeeded, 0);
     WideCharToMultiByte(CP_UTF8, 0, wStr.data(), (int)wStr.size(), str.data(), sizeNeeded, nullptr, nullptr);
 
     return str;
+#else
+    return boost::locale::conv::utf_to_utf<char>(wStr);
+#endif
 }
 
 auto containsOnlyAscii(const std::string& str) -> bool
@@ -145,29 +167,15 @@ auto containsOnlyAscii(const std::wstring& str) -> bool
 
 auto getFileBytes(const filesystem::path& filePath) -> vector<std::byte>
 {
-    ifstream inputFile(filePath, ios::binary | ios::ate);
-    if (!inputFile.is_open()) {
+    // mapping avoids the stream buffer and lets the OS read ahead
+    const PGPlatform::MappedFile inputFile(filePath);
+    if (!inputFile.isOpen()) {
         // Unable to open file
         return {};
     }
 
-    auto length = inputFile.tellg();
-    if (length == -1) {
-        // Unable to find length
-        inputFile.close();
-        return {};
-    }
-
-    inputFile.seekg(0, ios::beg);
-
-    // Make a buffer of the exact size of the file and read the data into it.
-    vector<std::byte> buffer(length);
-    inputFile.read(
-        reinterpret_cast<char*>(buffer.data()), length); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
-
-    inputFile.close();
-
-    return buffer;
+    const auto data = inputFile.getData();
+    return { data.begin(), data.end() };
 }
 
 auto getThreadID() -> string
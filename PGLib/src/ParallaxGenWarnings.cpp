@@ -1,7 +1,6 @@
 #include "ParallaxGenWarnings.hpp"
 
-#include <mutex>
-#include <spdlog/spdlog.h>
+#include "Logger.hpp"
 
 using namespace std;
 
@@ -9,138 +8,99 @@ using namespace std;
 ParallaxGenDirectory* ParallaxGenWarnings::s_pgd = nullptr;
 const std::unordered_map<std::wstring, int>* ParallaxGenWarnings::s_modPriority = nullptr;
 
-unordered_map<wstring, unordered_set<wstring>> ParallaxGenWarnings::s_mismatchWarnTracker;
-mutex ParallaxGenWarnings::s_mismatchWarnTrackerMutex;
-
-unordered_map<std::wstring, unordered_set<pair<wstring, wstring>, ParallaxGenWarnings::PairHash>>
-    ParallaxGenWarnings::s_mismatchWarnDebugTracker;
-mutex ParallaxGenWarnings::s_mismatchWarnDebugTrackerMutex;
-
-unordered_set<pair<wstring, wstring>, ParallaxGenWarnings::PairHash> ParallaxGenWarnings::s_meshWarnTracker;
-mutex ParallaxGenWarnings::s_meshWarnTrackerMutex;
-unordered_set<pair<wstring, wstring>, ParallaxGenWarnings::PairHash> ParallaxGenWarnings::s_meshWarnDebugTracker;
-mutex ParallaxGenWarnings::s_meshWarnDebugTrackerMutex;
+PGWarningAggregator ParallaxGenWarnings::s_aggregator;
 
 void ParallaxGenWarnings::init(ParallaxGenDirectory* pgd, const unordered_map<wstring, int>* modPriority)
 {
     ParallaxGenWarnings::s_pgd = pgd;
     ParallaxGenWarnings::s_modPriority = modPriority;
 
-    s_mismatchWarnTracker.clear();
-    s_mismatchWarnDebugTracker.clear();
-    s_meshWarnTracker.clear();
-    s_meshWarnDebugTracker.clear();
+    s_aggregator.clear();
 }
 
 void ParallaxGenWarnings::mismatchWarn(const wstring& matchedPath, const wstring& baseTex)
 {
-    // construct key
-    auto matchedPathMod = s_pgd->getMod(matchedPath);
-    auto baseTexMod = s_pgd->getMod(baseTex);
-
-    if (baseTexMod.empty()) {
-        baseTexMod = L"Vanilla Game";
-    }
-
-    if (matchedPathMod.empty() || baseTexMod.empty()) {
-        return;
-    }
-
-    if (matchedPathMod == baseTexMod) {
-        return;
-    }
-
-    {
-        const lock_guard<mutex> lock(s_mismatchWarnDebugTrackerMutex);
-        s_mismatchWarnDebugTracker[matchedPathMod].insert(std::make_pair(matchedPath, baseTex));
-    }
+    // mods are resolved once per path when warnings are printed
+    s_aggregator.add(PGWarningAggregator::Kind::TEXTURE_MISMATCH, matchedPath, baseTex);
+}
 
-    {
-        const lock_guard<mutex> lock2(s_mismatchWarnTrackerMutex);
-        s_mismatchWarnTracker[matchedPathMod].insert(baseTexMod);
-    }
+void ParallaxGenWarnings::meshWarn(const wstring& matchedPath, const wstring& nifPath)
+{
+    // mods are resolved once per path when warnings are printed
+    s_aggregator.add(PGWarningAggregator::Kind::MESH_MISMATCH, matchedPath, nifPath);
 }
 
 void ParallaxGenWarnings::printWarnings()
 {
-    if (!s_mismatchWarnTracker.empty()) {
-        spdlog::warn(
-            "Potential Texture mismatches were found, there may be visual issues, Please verify for each warning if "
-            "this is intended, address them and re-run ParallaxGen if needed.");
-        spdlog::warn("See https://github.com/hakasapl/ParallaxGen/wiki/FAQ for further information");
-        spdlog::warn("************************************************************");
-    }
-    for (const auto& matchedMod : s_mismatchWarnTracker) {
-        spdlog::warn(L"\"{}\" assets are used with:", matchedMod.first);
-        for (auto baseMod : matchedMod.second) {
-            spdlog::warn(L"  - diffuse/normal textures from \"{}\"", baseMod);
+    const auto getMod = [](const wstring& path) -> wstring { return s_pgd->getMod(path); };
+    const auto getModOrVanilla = [](const wstring& path) -> wstring {
+        auto mod = s_pgd->getMod(path);
+        if (mod.empty()) {
+            mod = L"Vanilla Game";
         }
-        spdlog::warn("");
-    }
-    if (!s_mismatchWarnTracker.empty()) {
-        spdlog::warn("************************************************************");
-    }
+        return mod;
+    };
 
-    if (!s_mismatchWarnDebugTracker.empty()) {
-        spdlog::debug("Potential texture mismatches:");
-    }
-    for (auto& matchedMod : s_mismatchWarnDebugTracker) {
-        spdlog::debug(L"Mod \"{}\":", matchedMod.first);
+    const auto mismatchGroups
+        = s_aggregator.merge(PGWarningAggregator::Kind::TEXTURE_MISMATCH, getMod, getModOrVanilla);
 
-        for (auto texturePair : matchedMod.second) {
-            auto baseTexMod = s_pgd->getMod(texturePair.second);
-            spdlog::debug(L"  - {} used with {} from \"{}\"", texturePair.first, texturePair.second, baseTexMod);
+    if (!mismatchGroups.empty()) {
+        Logger::warn(
+            "Potential Texture mismatches were found, there may be visual issues, Please verify for each warning if "
+            "this is intended, address them and re-run ParallaxGen if needed.");
+        Logger::warn("See https://github.com/hakasapl/ParallaxGen/wiki/FAQ for further information");
+        Logger::warn("************************************************************");
+
+        // groups are sorted by matched mod, so each matched mod is a contiguous run
+        for (size_t i = 0; i < mismatchGroups.size(); ++i) {
+            const auto& group = mismatchGroups[i];
+            if (i == 0 || mismatchGroups[i - 1].sourceMod != group.sourceMod) {
+                Logger::warn(L"\"{}\" assets are used with:", group.sourceMod);
+            }
+
+            Logger::warn(
+                L"  - diffuse/normal textures from \"{}\" ({} textures)", group.targetMod, group.paths.size());
+
+            if (i + 1 == mismatchGroups.size() || mismatchGroups[i + 1].sourceMod != group.sourceMod) {
+                Logger::warn("");
+            }
         }
-    }
-}
 
-void ParallaxGenWarnings::meshWarn(const wstring& matchedPath, const wstring& nifPath)
-{
-    // construct key
-    auto matchedPathMod = s_pgd->getMod(matchedPath);
-    auto nifPathMod = s_pgd->getMod(nifPath);
+        Logger::warn("************************************************************");
 
-    if (matchedPathMod.empty() || nifPathMod.empty()) {
-        return;
+        Logger::debug("Potential texture mismatches:");
+        for (const auto& group : mismatchGroups) {
+            Logger::debug(L"Mod \"{}\" with \"{}\":", group.sourceMod, group.targetMod);
+            for (const auto& [matchedPath, baseTex] : group.paths) {
+                Logger::debug(L"  - {} used with {}", matchedPath, baseTex);
+            }
+        }
     }
 
-    if (matchedPathMod == nifPathMod) {
-        return;
-    }
+    const auto meshGroups = s_aggregator.merge(PGWarningAggregator::Kind::MESH_MISMATCH, getMod, getMod);
+    for (const auto& group : meshGroups) {
+        if (getModPriority(group.targetMod) < 0) {
+            continue;
+        }
 
-    int priority = 0;
-    if (s_modPriority != nullptr && s_modPriority->find(nifPathMod) != s_modPriority->end()) {
-        priority = s_modPriority->at(nifPathMod);
+        Logger::debug(L"[Potential Mesh Mismatch] Assets from mod \"{}\" were used on {} meshes from mod \"{}\":",
+            group.sourceMod, group.paths.size(), group.targetMod);
+        for (const auto& [matchedPath, nifPath] : group.paths) {
+            Logger::debug(L"  - {} used on {}", matchedPath, nifPath);
+        }
     }
+}
 
-    if (priority < 0) {
-        return;
+auto ParallaxGenWarnings::getModPriority(const wstring& mod) -> int
+{
+    if (s_modPriority == nullptr) {
+        return 0;
     }
 
-    auto key = make_pair(matchedPathMod, nifPathMod);
-
-    // Issue debug log
-    {
-        auto keyDebug = make_pair(matchedPath, nifPath);
-        const lock_guard<mutex> lock(s_meshWarnDebugTrackerMutex);
-        if (s_meshWarnDebugTracker.find(keyDebug) != s_meshWarnDebugTracker.end()) {
-            return;
-        }
-
-        s_meshWarnDebugTracker.insert(keyDebug);
-
-        spdlog::debug(L"[Potential Mesh Mismatch] Matched path {} from mod {} were used on mesh {} from mod {}",
-            matchedPath, matchedPathMod, nifPath, nifPathMod);
+    const auto it = s_modPriority->find(mod);
+    if (it == s_modPriority->end()) {
+        return 0;
     }
 
-    // check if warning was already issued
-    {
-        const lock_guard<mutex> lock(s_meshWarnTrackerMutex);
-        if (s_meshWarnTracker.find(key) != s_meshWarnTracker.end()) {
-            return;
-        }
-
-        // add to tracker if not
-        s_meshWarnTracker.insert(key);
-    }
+    return it->second;
 }
@@ -20,8 +20,7 @@
 using namespace std;
 
 // statics
-nlohmann::json PatcherMeshGlobalParticleLightsToLP::s_lpJsonData;
-mutex PatcherMeshGlobalParticleLightsToLP::s_lpJsonDataMutex;
+PGLightPlacerCollector PatcherMeshGlobalParticleLightsToLP::s_lpCollector;
 
 PatcherMeshGlobalParticleLightsToLP::PatcherMeshGlobalParticleLightsToLP(
     std::filesystem::path nifPath, nifly::NifFile* nif)
@@ -38,17 +37,12 @@ auto PatcherMeshGlobalParticleLightsToLP::getFactory() -> PatcherMeshGlobal::Pat
 
 auto PatcherMeshGlobalParticleLightsToLP::applyPatch() -> bool
 {
-    // Loop through all blocks to find alpha properties
-    // Determine if NIF has attached havok animations
-    vector<NiObject*> nifBlockTree;
-    getNIF()->GetTree(nifBlockTree);
+    // Copied because patched nodes are deleted while looping
+    const auto billboardNodes = getNIFAnalysis().getBlocks(typeid(nifly::NiBillboardNode));
 
     bool appliedPatch = false;
 
-    for (NiObject* nifBlock : nifBlockTree) {
-        if (!boost::iequals(nifBlock->GetBlockName(), "NiBillboardNode")) {
-            continue;
-        }
+    for (NiObject* nifBlock : billboardNodes) {
         auto* const billboardNode = dynamic_cast<nifly::NiBillboardNode*>(nifBlock);
 
         // Get children
@@ -137,24 +131,18 @@ auto PatcherMeshGlobalParticleLightsToLP::applyPatch() -> bool
         }
     }
 
+    if (appliedPatch) {
+        getNIFAnalysis().invalidateBlocks();
+    }
+
     return appliedPatch;
 }
 
 auto PatcherMeshGlobalParticleLightsToLP::applySinglePatch(
     nifly::NiBillboardNode* node, nifly::NiShape* shape, nifly::BSEffectShaderProperty* effectShader) -> bool
 {
-    // Start generating LP JSON
-    nlohmann::json lpJson;
-
-    // Set model path
-    lpJson["models"] = nlohmann::json::array();
-
     // Remove "meshes\\" from start of path
     const auto nifPath = boost::ireplace_first_copy(getNIFPath().string(), "meshes\\", "");
-    lpJson["models"].push_back(nifPath);
-
-    // Create lights array
-    lpJson["lights"] = nlohmann::json::array();
 
     // LightEntry will hold all JSON data for light
     nlohmann::json lightEntry;
@@ -164,10 +152,8 @@ auto PatcherMeshGlobalParticleLightsToLP::applySinglePatch(
     MatTransform globalPosition;
     getNIF()->GetNodeTransformToGlobal(node->name.get(), globalPosition);
 
-    // Setup points array
-    lightEntry["points"] = nlohmann::json::array();
-    lightEntry["points"].push_back(nlohmann::json::array({ round(globalPosition.translation.x * 100.0) / 100.0,
-        round(globalPosition.translation.y * 100.0) / 100.0, round(globalPosition.translation.z * 100.0) / 100.0 }));
+    const PGLightPlacerCollector::Point point = { round(globalPosition.translation.x * 100.0) / 100.0,
+        round(globalPosition.translation.y * 100.0) / 100.0, round(globalPosition.translation.z * 100.0) / 100.0 };
 
     // Set Light
     lightEntry["data"]["light"] = "MagicLightWhite01"; // Placeholder light that will be overridden
@@ -241,13 +227,8 @@ auto PatcherMeshGlobalParticleLightsToLP::applySinglePatch(
         controllerRef = controller->nextControllerRef;
     }
 
-    lpJson["lights"].push_back(lightEntry);
-
-    // Save JSON
-    {
-        const lock_guard<mutex> lock(s_lpJsonDataMutex);
-        PatcherMeshGlobalParticleLightsToLP::s_lpJsonData.push_back(lpJson);
-    }
+    // Save light to this thread's buffer
+    s_lpCollector.add(nifPath, lightEntry["data"], point);
 
     return true;
 }
@@ -378,65 +359,13 @@ auto PatcherMeshGlobalParticleLightsToLP::getControllerJSON(nifly::NiTimeControl
 
 void PatcherMeshGlobalParticleLightsToLP::finalize()
 {
-    const lock_guard<mutex> lock(s_lpJsonDataMutex);
-
     // Check if output JSON is empty
-    if (s_lpJsonData.empty()) {
+    if (s_lpCollector.size() == 0) {
         return;
     }
 
-    // Key type for grouping: the stringified "models" array.
-    std::unordered_map<std::string, std::unordered_map<std::string, std::vector<nlohmann::json>>> modelsToDataPoints;
-
-    // Merge all lights into a single JSON object
-    for (auto& obj : s_lpJsonData) {
-        const std::string modelsKey = obj["models"].dump();
-
-        auto& dataGroup = modelsToDataPoints[modelsKey];
-
-        for (auto& light : obj["lights"]) {
-            const std::string dataKey = light["data"].dump();
-            for (auto& p : light["points"]) {
-                dataGroup[dataKey].push_back(p);
-            }
-        }
-    }
-
-    nlohmann::json mergedOutput = nlohmann::json::array();
-
-    for (auto& kv : modelsToDataPoints) {
-        const auto& modelsKey = kv.first;
-        const auto& dataGroup = kv.second;
-
-        const nlohmann::json modelsJson = nlohmann::json::parse(modelsKey);
-
-        nlohmann::json lightsArray = nlohmann::json::array();
-
-        for (const auto& dataKv : dataGroup) {
-            const std::string dataKey = dataKv.first;
-            const nlohmann::json dataObj = nlohmann::json::parse(dataKey);
-
-            const auto& allPoints = dataKv.second; // vector<json>
-
-            nlohmann::json lightEntry;
-            lightEntry["data"] = dataObj;
-            lightEntry["points"] = nlohmann::json::array();
-
-            for (const auto& pt : allPoints) {
-                lightEntry["points"].push_back(pt);
-            }
-
-            lightsArray.push_back(lightEntry);
-        }
-
-        // Now assemble the final group object
-        nlohmann::json groupObj;
-        groupObj["models"] = modelsJson;
-        groupObj["lights"] = lightsArray;
-
-        // Add to the final merged output
-        mergedOutput.push_back(groupObj);
-    }
+    // Merge all lights with the same model and data into one entry
+    const auto mergedOutput = s_lpCollector.merge();
 
     const auto outputJSON = getPGD()->getGeneratedPath() / "LightPlacer/parallaxgen.json";
 
@@ -0,0 +1,374 @@
+#include "patchers/PatcherMeshPreRules.hpp"
+
+#include "Logger.hpp"
+#include "PGDiag.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+
+using namespace std;
+
+vector<PatcherMeshPreRules::Rule> PatcherMeshPreRules::s_rules;
+vector<PatcherMeshPreRules::Action> PatcherMeshPreRules::s_actions;
+
+namespace {
+// Rules that replace the former FixMeshLighting and FixTextureSlotCount prepatchers
+constexpr auto BUILTIN_RULES = R"([
+    {
+        "name": "FixMeshLighting",
+        "actions": [ { "field": "softlighting", "max": 0.6 } ]
+    },
+    {
+        "name": "FixTextureSlotCount",
+        "save": false,
+        "actions": [ { "field": "texture_slot_count", "min": 9 } ]
+    }
+])";
+
+constexpr size_t NUM_SHADER_TYPES = 32; // width of Rule::shaderTypeMask
+
+auto normalizePathChar(const char& c) -> char
+{
+    // backslash and forward slash are the same separator in NIF paths
+    if (c == '/') {
+        return '\\';
+    }
+    return static_cast<char>(tolower(static_cast<unsigned char>(c)));
+}
+} // namespace
+
+auto PatcherMeshPreRules::getFactory() -> PatcherMeshPre::PatcherMeshPreFactory
+{
+    return [](const filesystem::path& nifPath, nifly::NifFile* nif) -> unique_ptr<PatcherMeshPre> {
+        return make_unique<PatcherMeshPreRules>(nifPath, nif);
+    };
+}
+
+void PatcherMeshPreRules::loadStatics(const nlohmann::json& rules)
+{
+    s_rules.clear();
+    s_actions.clear();
+
+    if (!rules.is_array()) {
+        Logger::error("Mesh rules must be a JSON array, no rules loaded");
+        return;
+    }
+
+    for (const auto& rule : rules) {
+        Rule compiled;
+        vector<Action> actions;
+        if (!compileRule(rule, compiled, actions)) {
+            continue;
+        }
+
+        compiled.firstAction = s_actions.size();
+        compiled.numActions = actions.size();
+        s_actions.insert(s_actions.end(), actions.begin(), actions.end());
+        s_rules.push_back(std::move(compiled));
+    }
+
+    Logger::debug("Loaded {} mesh rules", s_rules.size());
+}
+
+auto PatcherMeshPreRules::getNumRules() -> size_t { return s_rules.size(); }
+
+auto PatcherMeshPreRules::getBuiltinRule(const string& name) -> nlohmann::json
+{
+    static const auto builtinRules = nlohmann::json::parse(BUILTIN_RULES);
+
+    for (const auto& rule : builtinRules) {
+        if (rule["name"] == name) {
+            return rule;
+        }
+    }
+
+    return nullptr;
+}
+
+PatcherMeshPreRules::PatcherMeshPreRules(std::filesystem::path nifPath, nifly::NifFile* nif)
+    : PatcherMeshPre(std::move(nifPath), nif, "MeshRules")
+{
+}
+
+auto PatcherMeshPreRules::applyPatch(nifly::NiShape& nifShape) -> bool
+{
+    bool changed = false;
+
+    auto* nifShader = getNIF()->GetShader(&nifShape);
+    auto* const nifShaderBSLSP = dynamic_cast<nifly::BSLightingShaderProperty*>(nifShader);
+    if (nifShaderBSLSP == nullptr) {
+        return false;
+    }
+
+    auto* txstRec = getNIF()->GetHeader().GetBlock(nifShaderBSLSP->TextureSetRef());
+
+    for (const auto& rule : s_rules) {
+        if (!matchesRule(rule, *nifShaderBSLSP, txstRec)) {
+            continue;
+        }
+
+        bool ruleApplied = false;
+        for (size_t i = rule.firstAction; i < rule.firstAction + rule.numActions; ++i) {
+            const auto& action = s_actions[i];
+            if (!applyAction(action, *nifShaderBSLSP, txstRec)) {
+                continue;
+            }
+
+            Logger::trace("Rule {} changed {}", rule.name, getFieldStr(action.field));
+            ruleApplied = true;
+        }
+
+        if (ruleApplied) {
+            // one key per rule, like the prepatchers the built-in rules replace
+            PGDiag::insert(rule.name, true);
+            changed |= rule.triggerSave;
+        }
+    }
+
+    return changed;
+}
+
+auto PatcherMeshPreRules::compileRule(const nlohmann::json& rule, Rule& compiled, vector<Action>& actions) -> bool
+{
+    if (!rule.is_object() || !rule.contains("name") || !rule["name"].is_string()) {
+        Logger::error("Mesh rule without a name, ignoring: {}", rule.dump());
+        return false;
+    }
+    compiled.name = rule["name"].get<string>();
+
+    try {
+        compiled.triggerSave = rule.value("save", true);
+
+        if (rule.contains("match")) {
+            const auto& match = rule["match"];
+            for (const auto& shaderType : match.value("shader_types", nlohmann::json::array())) {
+                const auto type = shaderType.get<unsigned>();
+                if (type >= NUM_SHADER_TYPES) {
+                    Logger::error("Mesh rule {} has invalid shader type {}, ignoring", compiled.name, type);
+                    return false;
+                }
+                compiled.shaderTypeMask |= 1U << type;
+            }
+
+            compiled.flags1Set = match.value("flags1_set", 0U);
+            compiled.flags1Unset = match.value("flags1_unset", 0U);
+            compiled.flags2Set = match.value("flags2_set", 0U);
+            compiled.flags2Unset = match.value("flags2_unset", 0U);
+
+            const auto slots = match.value("slots", nlohmann::json::object());
+            for (const auto& [slotStr, pattern] : slots.items()) {
+                const auto slot = stoul(slotStr);
+                if (slot >= NUM_TEXTURE_SLOTS) {
+                    Logger::error("Mesh rule {} has invalid texture slot {}, ignoring", compiled.name, slotStr);
+                    return false;
+                }
+
+                auto& compiledPattern = compiled.slotPatterns.at(slot);
+                compiledPattern = pattern.get<string>();
+                ranges::transform(compiledPattern, compiledPattern.begin(), normalizePathChar);
+                compiled.slotMask |= static_cast<uint16_t>(1U << slot);
+            }
+        }
+
+        if (!rule.contains("actions") || !rule["actions"].is_array() || rule["actions"].empty()) {
+            Logger::error("Mesh rule {} has no actions, ignoring", compiled.name);
+            return false;
+        }
+
+        for (const auto& action : rule["actions"]) {
+            Action compiledAction;
+            const auto fieldStr = action.at("field").get<string>();
+            if (!getFieldFromStr(fieldStr, compiledAction.field)) {
+                Logger::error("Mesh rule {} has unknown field {}, ignoring", compiled.name, fieldStr);
+                return false;
+            }
+
+            if (action.contains("set")) {
+                compiledAction.hasSet = true;
+                compiledAction.setValue = action["set"].get<float>();
+            }
+            compiledAction.minValue = action.value("min", compiledAction.minValue);
+            compiledAction.maxValue = action.value("max", compiledAction.maxValue);
+
+            if (!compiledAction.hasSet && !action.contains("min") && !action.contains("max")) {
+                Logger::error("Mesh rule {} has an action without set, min or max, ignoring", compiled.name);
+                return false;
+            }
+            if (compiledAction.minValue > compiledAction.maxValue) {
+                Logger::error("Mesh rule {} has min above max for {}, ignoring", compiled.name, fieldStr);
+                return false;
+            }
+            // texture sets never hold more than the known slots, larger counts would only allocate empty slots
+            static constexpr auto MAX_SLOT_COUNT = static_cast<float>(NUM_TEXTURE_SLOTS);
+            if (compiledAction.field == Field::TEXTURE_SLOT_COUNT
+                && (compiledAction.setValue < 0.0F || compiledAction.maxValue < 0.0F
+                    || compiledAction.setValue > MAX_SLOT_COUNT || compiledAction.minValue > MAX_SLOT_COUNT)) {
+                Logger::error("Mesh rule {} has an invalid texture slot count, ignoring", compiled.name);
+                return false;
+            }
+
+            actions.push_back(compiledAction);
+        }
+    } catch (const exception& e) {
+        Logger::error("Mesh rule {} is invalid, ignoring: {}", compiled.name, e.what());
+        return false;
+    }
+
+    return true;
+}
+
+auto PatcherMeshPreRules::getFieldFromStr(const string& field, Field& out) -> bool
+{
+    static const array<pair<string, Field>, 7> fieldMap = { { { "softlighting", Field::SOFTLIGHTING },
+        { "rimlight_power", Field::RIMLIGHT_POWER }, { "glossiness", Field::GLOSSINESS },
+        { "specular_strength", Field::SPECULAR_STRENGTH }, { "env_map_scale", Field::ENV_MAP_SCALE },
+        { "alpha", Field::ALPHA }, { "texture_slot_count", Field::TEXTURE_SLOT_COUNT } } };
+
+    for (const auto& [name, value] : fieldMap) {
+        if (name == field) {
+            out = value;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+auto PatcherMeshPreRules::getFieldStr(const Field& field) -> string
+{
+    switch (field) {
+    case Field::SOFTLIGHTING:
+        return "softlighting";
+    case Field::RIMLIGHT_POWER:
+        return "rimlight_power";
+    case Field::GLOSSINESS:
+        return "glossiness";
+    case Field::SPECULAR_STRENGTH:
+        return "specular_strength";
+    case Field::ENV_MAP_SCALE:
+        return "env_map_scale";
+    case Field::ALPHA:
+        return "alpha";
+    case Field::TEXTURE_SLOT_COUNT:
+        return "texture_slot_count";
+    }
+
+    return "unknown";
+}
+
+auto PatcherMeshPreRules::matchesRule(
+    const Rule& rule, nifly::BSLightingShaderProperty& nifShader, const nifly::BSShaderTextureSet* txstRec) -> bool
+{
+    if (rule.shaderTypeMask != 0) {
+        const auto shaderType = nifShader.GetShaderType();
+        if (shaderType >= NUM_SHADER_TYPES || (rule.shaderTypeMask & (1U << shaderType)) == 0) {
+            return false;
+        }
+    }
+
+    if ((nifShader.shaderFlags1 & rule.flags1Set) != rule.flags1Set || (nifShader.shaderFlags1 & rule.flags1Unset) != 0
+        || (nifShader.shaderFlags2 & rule.flags2Set) != rule.flags2Set
+        || (nifShader.shaderFlags2 & rule.flags2Unset) != 0) {
+        return false;
+    }
+
+    if (rule.slotMask == 0) {
+        return true;
+    }
+
+    static const string emptySlot;
+    for (size_t slot = 0; slot < NUM_TEXTURE_SLOTS; ++slot) {
+        if ((rule.slotMask & (1U << slot)) == 0) {
+            continue;
+        }
+
+        const auto& texture
+            = txstRec != nullptr && slot < txstRec->textures.size() ? txstRec->textures[slot].get() : emptySlot;
+        if (!matchesWildcard(rule.slotPatterns.at(slot), texture)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+auto PatcherMeshPreRules::matchesWildcard(const string& pattern, const string& str) -> bool
+{
+    // greedy matching that backtracks to the last *, compares without building lowercase copies
+    size_t p = 0;
+    size_t s = 0;
+    size_t starP = string::npos;
+    size_t starS = 0;
+
+    while (s < str.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == normalizePathChar(str[s]))) {
+            ++p;
+            ++s;
+        } else if (p < pattern.size() && pattern[p] == '*') {
+            starP = p++;
+            starS = s;
+        } else if (starP != string::npos) {
+            p = starP + 1;
+            s = ++starS;
+        } else {
+            return false;
+        }
+    }
+
+    while (p < pattern.size() && pattern[p] == '*') {
+        ++p;
+    }
+
+    return p == pattern.size();
+}
+
+auto PatcherMeshPreRules::applyAction(
+    const Action& action, nifly::BSLightingShaderProperty& nifShader, nifly::BSShaderTextureSet* txstRec) -> bool
+{
+    if (action.field == Field::TEXTURE_SLOT_COUNT) {
+        if (txstRec == nullptr) {
+            return false;
+        }
+
+        auto numSlots = action.hasSet ? action.setValue : static_cast<float>(txstRec->textures.size());
+        numSlots = clamp(numSlots, action.minValue, action.maxValue);
+
+        const auto newSize = static_cast<size_t>(numSlots);
+        if (newSize == txstRec->textures.size()) {
+            return false;
+        }
+
+        txstRec->textures.resize(newSize);
+        return true;
+    }
+
+    float* value = nullptr;
+    switch (action.field) {
+    case Field::SOFTLIGHTING:
+        value = &nifShader.softlighting;
+        break;
+    case Field::RIMLIGHT_POWER:
+        value = &nifShader.rimlightPower;
+        break;
+    case Field::GLOSSINESS:
+        value = &nifShader.glossiness;
+        break;
+    case Field::SPECULAR_STRENGTH:
+        value = &nifShader.specularStrength;
+        break;
+    case Field::ENV_MAP_SCALE:
+        value = &nifShader.environmentMapScale;
+        break;
+    case Field::ALPHA:
+        value = &nifShader.alpha;
+        break;
+    default:
+        return false;
+    }
+
+    auto newValue = action.hasSet ? action.setValue : *value;
+    newValue = clamp(newValue, action.minValue, action.maxValue);
+
+    return NIFUtil::setShaderFloat(*value, newValue);
+}
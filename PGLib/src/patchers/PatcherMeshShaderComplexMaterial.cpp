@@ -110,7 +110,7 @@ auto PatcherMeshShaderComplexMaterial::shouldApply(
 
     PatcherMatch lastMatch; // Variable to store the match that equals OldSlots[Slot], if found
     for (const auto& match : foundMatches) {
-        if (getPGD3D()->checkIfAspectRatioMatches(baseMap, match.path)) {
+        if (getPGD()->checkIfAspectRatioMatches(baseMap, match.path)) {
             PatcherMatch curMatch;
             curMatch.matchedPath = match.path;
             curMatch.matchedFrom.insert(matchedFromSlot);
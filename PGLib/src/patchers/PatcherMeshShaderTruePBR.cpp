@@ -18,6 +18,7 @@
 
 #include "Logger.hpp"
 #include "NIFUtil.hpp"
+#include "PGGeometry.hpp"
 #include "ParallaxGenUtil.hpp"
 
 using namespace std;
@@ -697,11 +698,14 @@ auto PatcherMeshShaderTruePBR::applyOnePatch(NiShape* nifShape, nlohmann::json&
 
     // "auto_uv" attribute
     if (truePBRData.contains("auto_uv")) {
-        vector<Triangle> tris;
-        nifShape->GetTriangles(tris);
-        auto newUVScale = autoUVScale(getNIF()->GetUvsForShape(nifShape), getNIF()->GetVertsForShape(nifShape), tris)
-            / truePBRData["auto_uv"];
-        changed |= NIFUtil::setShaderVec2(nifShaderBSLSP->uvScale, newUVScale);
+        // cached by geometry, variants of a mesh share the result
+        const auto autoUVScale = PGGeometry::getShapeAutoUVScale(*getNIF(), nifShape);
+        if (autoUVScale.has_value()) {
+            const auto newUVScale = *autoUVScale / truePBRData["auto_uv"].get<float>();
+            changed |= NIFUtil::setShaderVec2(nifShaderBSLSP->uvScale, newUVScale);
+        } else {
+            Logger::trace(L"Skipping auto_uv: Shape has no UVs or triangles");
+        }
     }
 
     // "vertex_colors" attribute
@@ -1138,34 +1142,6 @@ auto PatcherMeshShaderTruePBR::enableTruePBROnShape(NiShape* nifShape, NiShader*
 // Helpers
 //
 
-auto PatcherMeshShaderTruePBR::abs2(Vector2 v) -> Vector2 { return { abs(v.u), abs(v.v) }; }
-
-// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
-auto PatcherMeshShaderTruePBR::autoUVScale(
-    const vector<Vector2>* uvs, const vector<Vector3>* verts, vector<Triangle>& tris) -> Vector2
-{
-    Vector2 scale;
-    for (const Triangle& t : tris) {
-        auto v1 = (*verts)[t.p1];
-        auto v2 = (*verts)[t.p2];
-        auto v3 = (*verts)[t.p3];
-        auto uv1 = (*uvs)[t.p1];
-        auto uv2 = (*uvs)[t.p2];
-        auto uv3 = (*uvs)[t.p3];
-
-        auto s = (abs2(uv2 - uv1) + abs2(uv3 - uv1)) / ((v2 - v1).length() + (v3 - v1).length());
-        scale += Vector2(1.0F / s.u, 1.0F / s.v);
-    }
-
-    scale *= 10.0 / 4.0;
-    scale /= static_cast<float>(tris.size());
-    scale.u = min(scale.u, scale.v);
-    scale.v = min(scale.u, scale.v);
-
-    return scale;
-}
-// NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
-
 auto PatcherMeshShaderTruePBR::flag(const nlohmann::json& json, const char* key) -> bool
 {
     return json.contains(key) && json[key];
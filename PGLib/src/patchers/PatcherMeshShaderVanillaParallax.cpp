@@ -1,7 +1,6 @@
 #include "patchers/PatcherMeshShaderVanillaParallax.hpp"
 
 #include <Geometry.hpp>
-#include <boost/algorithm/string.hpp>
 
 #include "Logger.hpp"
 #include "NIFUtil.hpp"
@@ -23,15 +22,6 @@ auto PatcherMeshShaderVanillaParallax::getShaderType() -> NIFUtil::ShapeShader
 PatcherMeshShaderVanillaParallax::PatcherMeshShaderVanillaParallax(filesystem::path nifPath, nifly::NifFile* nif)
     : PatcherMeshShader(std::move(nifPath), nif, "VanillaParallax")
 {
-    // Determine if NIF has attached havok animations
-    vector<NiObject*> nifBlockTree;
-    nif->GetTree(nifBlockTree);
-
-    for (NiObject* nifBlock : nifBlockTree) {
-        if (boost::iequals(nifBlock->GetBlockName(), "BSBehaviorGraphExtraData")) {
-            m_hasAttachedHavok = true;
-        }
-    }
 }
 
 auto PatcherMeshShaderVanillaParallax::canApply(NiShape& nifShape) -> bool
@@ -39,8 +29,8 @@ auto PatcherMeshShaderVanillaParallax::canApply(NiShape& nifShape) -> bool
     auto* nifShader = getNIF()->GetShader(&nifShape);
     auto* const nifShaderBSLSP = dynamic_cast<BSLightingShaderProperty*>(nifShader);
 
-    // Check if nif has attached havok (Results in crashes for vanilla Parallax)
-    if (m_hasAttachedHavok) {
+    // Check if nif has attached havok (Results in crashes for vanilla Parallax), scanned once per NIF
+    if (getNIFAnalysis().hasAttachedHavok()) {
         Logger::trace(L"Cannot Apply: Attached havok animations");
         return false;
     }
@@ -116,7 +106,7 @@ auto PatcherMeshShaderVanillaParallax::shouldApply(
     // Check aspect ratio matches
     PatcherMatch lastMatch; // Variable to store the match that equals OldSlots[Slot], if found
     for (const auto& match : foundMatches) {
-        if (getPGD3D()->checkIfAspectRatioMatches(baseMap, match.path)) {
+        if (getPGD()->checkIfAspectRatioMatches(baseMap, match.path)) {
             PatcherMatch curMatch;
             curMatch.matchedPath = match.path;
             curMatch.matchedFrom.insert(matchedFromSlot);
@@ -1,4 +1,5 @@
 #include "patchers/PatcherTextureGlobalConvertToHDR.hpp"
+#include "PGMipGenerator.hpp"
 #include "ParallaxGenD3D.hpp"
 
 #include <DirectXTex.h>
@@ -48,6 +49,8 @@ void PatcherTextureGlobalConvertToHDR::applyPatch(bool& ddsModified)
         return;
     }
 
+    PGMipGenerator::ensureMipChain(newDDS, {});
+
     *getDDS() = std::move(newDDS);
     ddsModified = true;
 }
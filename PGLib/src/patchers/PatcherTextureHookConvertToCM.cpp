@@ -1,7 +1,11 @@
 #include "patchers/PatcherTextureHookConvertToCM.hpp"
+#include "PGBlockCompressor.hpp"
+#include "PGMipGenerator.hpp"
+#include "PGOutputStore.hpp"
 
 #include <DirectXTex.h>
 #include <mutex>
+#include <span>
 
 using namespace std;
 using namespace Microsoft::WRL;
@@ -43,27 +47,37 @@ auto PatcherTextureHookConvertToCM::applyPatch(filesystem::path& newPath) -> boo
         return false;
     }
 
-    const lock_guard<mutex> lock(s_generatedFileTrackerMutex);
+    PGMipGenerator::ensureMipChain(newDDS, {});
+
     if (getPGD()->isGenerated(newPath)) {
-        // already generated
+        // another thread finished the same map while the shader ran, skip the compression
         return true;
     }
 
-    const auto outPath = getPGD()->getGeneratedPath() / newPath;
-    filesystem::create_directories(outPath.parent_path());
-
+    // compress outside of the tracker lock so other patchers are not serialized behind it
     DirectX::ScratchImage compressedImage;
-    HRESULT hr = DirectX::Compress(newDDS.GetImages(), newDDS.GetImageCount(), newDDS.GetMetadata(),
-        DXGI_FORMAT_BC3_UNORM, DirectX::TEX_COMPRESS_DEFAULT, 1.0F, compressedImage);
-
-    if (FAILED(hr)) {
+    PGBlockCompressor::Options compressOptions;
+    compressOptions.format = DXGI_FORMAT_BC3_UNORM;
+    compressOptions.alphaThreshold = 1.0F;
+    if (!PGBlockCompressor::compress(newDDS, compressOptions, compressedImage)) {
         return false;
     }
 
-    hr = DirectX::SaveToDDSFile(compressedImage.GetImages(), compressedImage.GetImageCount(),
-        compressedImage.GetMetadata(), DirectX::DDS_FLAGS_NONE, outPath.c_str());
+    const lock_guard<mutex> lock(s_generatedFileTrackerMutex);
+    if (getPGD()->isGenerated(newPath)) {
+        // already generated
+        return true;
+    }
+
+    DirectX::Blob ddsBlob;
+    if (FAILED(DirectX::SaveToDDSMemory(compressedImage.GetImages(), compressedImage.GetImageCount(),
+            compressedImage.GetMetadata(), DirectX::DDS_FLAGS_NONE, ddsBlob))) {
+        return false;
+    }
 
-    if (FAILED(hr)) {
+    const span<const std::byte> ddsBytes(
+        static_cast<const std::byte*>(ddsBlob.GetBufferPointer()), ddsBlob.GetBufferSize());
+    if (getPGD()->getOutputStore().write(newPath, ddsBytes) == PGOutputStore::WriteResult::FAILED) {
         return false;
     }
 
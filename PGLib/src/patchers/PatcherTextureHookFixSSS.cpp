@@ -1,6 +1,9 @@
 #include "patchers/PatcherTextureHookFixSSS.hpp"
+#include "PGMipGenerator.hpp"
+#include "PGOutputStore.hpp"
 #include <DirectXTex.h>
 #include <dxgiformat.h>
+#include <span>
 
 using namespace std;
 using namespace Microsoft::WRL;
@@ -44,19 +47,23 @@ auto PatcherTextureHookFixSSS::applyPatch(filesystem::path& newPath) -> bool
         return false;
     }
 
+    PGMipGenerator::ensureMipChain(newDDS, {});
+
     const lock_guard<mutex> lock(s_generatedFileTrackerMutex);
     if (getPGD()->isGenerated(newPath)) {
         // already generated
         return true;
     }
 
-    const auto outPath = getPGD()->getGeneratedPath() / newPath;
-    filesystem::create_directories(outPath.parent_path());
-
-    const HRESULT hr = DirectX::SaveToDDSFile(
-        newDDS.GetImages(), newDDS.GetImageCount(), newDDS.GetMetadata(), DirectX::DDS_FLAGS_NONE, outPath.c_str());
+    DirectX::Blob ddsBlob;
+    if (FAILED(DirectX::SaveToDDSMemory(newDDS.GetImages(), newDDS.GetImageCount(), newDDS.GetMetadata(),
+            DirectX::DDS_FLAGS_NONE, ddsBlob))) {
+        return false;
+    }
 
-    if (FAILED(hr)) {
+    const span<const std::byte> ddsBytes(
+        static_cast<const std::byte*>(ddsBlob.GetBufferPointer()), ddsBlob.GetBufferSize());
+    if (getPGD()->getOutputStore().write(newPath, ddsBytes) == PGOutputStore::WriteResult::FAILED) {
         return false;
     }
 
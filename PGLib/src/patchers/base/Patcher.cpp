@@ -5,10 +5,10 @@ using namespace std;
 ParallaxGenDirectory* Patcher::s_pgd = nullptr;
 ParallaxGenD3D* Patcher::s_pgd3d = nullptr;
 
-auto Patcher::loadStatics(ParallaxGenDirectory& pgd, ParallaxGenD3D& pgd3d) -> void
+auto Patcher::loadStatics(ParallaxGenDirectory& pgd, ParallaxGenD3D* pgd3d) -> void
 {
     Patcher::s_pgd = &pgd;
-    Patcher::s_pgd3d = &pgd3d;
+    Patcher::s_pgd3d = pgd3d;
 }
 
 Patcher::Patcher(string patcherName, const bool& triggerSave)
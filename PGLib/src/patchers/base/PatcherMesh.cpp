@@ -1,7 +1,41 @@
 #include "patchers/base/PatcherMesh.hpp"
 
+#include <ExtraData.hpp>
+
+#include <vector>
+
 using namespace std;
 
+PatcherMesh::NIFAnalysis::NIFAnalysis(nifly::NifFile* nif)
+    : m_nif(nif)
+{
+}
+
+auto PatcherMesh::NIFAnalysis::hasAttachedHavok() -> bool
+{
+    return !getBlocks(typeid(nifly::BSBehaviorGraphExtraData)).empty();
+}
+
+auto PatcherMesh::NIFAnalysis::getBlocks(const type_index& type) -> const vector<nifly::NiObject*>&
+{
+    static const vector<nifly::NiObject*> s_noBlocks;
+
+    if (!m_blocksByType.has_value()) {
+        vector<nifly::NiObject*> nifBlockTree;
+        m_nif->GetTree(nifBlockTree);
+
+        auto& blocksByType = m_blocksByType.emplace();
+        for (auto* const nifBlock : nifBlockTree) {
+            blocksByType[typeid(*nifBlock)].push_back(nifBlock);
+        }
+    }
+
+    const auto it = m_blocksByType->find(type);
+    return it != m_blocksByType->end() ? it->second : s_noBlocks;
+}
+
+void PatcherMesh::NIFAnalysis::invalidateBlocks() { m_blocksByType.reset(); }
+
 PatcherMesh::PatcherMesh(filesystem::path nifPath, nifly::NifFile* nif, string patcherName, const bool& triggerSave)
     : Patcher(std::move(patcherName), triggerSave)
     , m_nifPath(std::move(nifPath))
@@ -9,5 +43,22 @@ PatcherMesh::PatcherMesh(filesystem::path nifPath, nifly::NifFile* nif, string p
 {
 }
 
+void PatcherMesh::rebind(const filesystem::path& nifPath, nifly::NifFile* nif, shared_ptr<NIFAnalysis> nifAnalysis)
+{
+    // assignment reuses the path buffer of the previous NIF
+    m_nifPath = nifPath;
+    m_nif = nif;
+    m_nifAnalysis = std::move(nifAnalysis);
+}
+
 auto PatcherMesh::getNIFPath() const -> filesystem::path { return m_nifPath; }
 auto PatcherMesh::getNIF() const -> nifly::NifFile* { return m_nif; }
+
+auto PatcherMesh::getNIFAnalysis() -> NIFAnalysis&
+{
+    if (m_nifAnalysis == nullptr) {
+        m_nifAnalysis = make_shared<NIFAnalysis>(m_nif);
+    }
+
+    return *m_nifAnalysis;
+}
@@ -0,0 +1,99 @@
+#include "patchers/base/PatcherMeshPool.hpp"
+
+using namespace std;
+
+PatcherMeshPool::Lease::Lease(const PatcherMeshPool* pool, ObjectSetPtr objects)
+    : m_pool(pool)
+    , m_idleSetsID(pool->m_idleSets.getID())
+    , m_objects(std::move(objects))
+{
+}
+
+PatcherMeshPool::Lease::~Lease()
+{
+    if (m_objects == nullptr) {
+        // moved from
+        return;
+    }
+
+    // drop the NIF so nothing dangles while the set is idle
+    rebind(*m_objects, {}, nullptr);
+
+    if (m_pool->m_idleSets.getID() == m_idleSetsID) {
+        m_pool->m_idleSets.local().push_back(std::move(m_objects));
+    }
+}
+
+auto PatcherMeshPool::Lease::operator*() const -> PatcherUtil::PatcherMeshObjectSet& { return *m_objects; }
+auto PatcherMeshPool::Lease::operator->() const -> PatcherUtil::PatcherMeshObjectSet* { return m_objects.get(); }
+
+void PatcherMeshPool::setFactories(const PatcherUtil::PatcherMeshSet& factories)
+{
+    m_factories = factories;
+    m_idleSets.reset();
+}
+
+auto PatcherMeshPool::acquire(const filesystem::path& nifPath, nifly::NifFile* nif) const -> Lease
+{
+    auto& idleSets = m_idleSets.local();
+    if (idleSets.empty()) {
+        return { this, make_unique<PatcherUtil::PatcherMeshObjectSet>(create(m_factories, nifPath, nif)) };
+    }
+
+    auto objects = std::move(idleSets.back());
+    idleSets.pop_back();
+    rebind(*objects, nifPath, nif);
+    return { this, std::move(objects) };
+}
+
+auto PatcherMeshPool::create(const PatcherUtil::PatcherMeshSet& factories, const filesystem::path& nifPath,
+    nifly::NifFile* nif) -> PatcherUtil::PatcherMeshObjectSet
+{
+    auto objects = PatcherUtil::PatcherMeshObjectSet();
+    for (const auto& factory : factories.prePatchers) {
+        objects.prePatchers.emplace_back(factory(nifPath, nif));
+    }
+    for (const auto& [shader, factory] : factories.shaderPatchers) {
+        objects.shaderPatchers.emplace(shader, factory(nifPath, nif));
+    }
+    for (const auto& [shader, factory] : factories.shaderTransformPatchers) {
+        for (const auto& [transformShader, transformFactory] : factory) {
+            objects.shaderTransformPatchers[shader].emplace(transformShader, transformFactory(nifPath, nif));
+        }
+    }
+    for (const auto& factory : factories.postPatchers) {
+        objects.postPatchers.emplace_back(factory(nifPath, nif));
+    }
+    for (const auto& factory : factories.globalPatchers) {
+        objects.globalPatchers.emplace_back(factory(nifPath, nif));
+    }
+
+    // share one analysis between the new patchers
+    rebind(objects, nifPath, nif);
+
+    return objects;
+}
+
+void PatcherMeshPool::rebind(
+    PatcherUtil::PatcherMeshObjectSet& objects, const filesystem::path& nifPath, nifly::NifFile* nif)
+{
+    const auto nifAnalysis = nif != nullptr ? make_shared<PatcherMesh::NIFAnalysis>(nif) : nullptr;
+
+    for (const auto& patcher : objects.prePatchers) {
+        patcher->rebind(nifPath, nif, nifAnalysis);
+    }
+    for (const auto& [shader, patcher] : objects.shaderPatchers) {
+        patcher->rebind(nifPath, nif, nifAnalysis);
+    }
+    for (const auto& [shader, transforms] : objects.shaderTransformPatchers) {
+        for (const auto& [transformShader, transform] : transforms) {
+            transform->rebind(nifPath, nif, nifAnalysis);
+        }
+    }
+    for (const auto& patcher : objects.postPatchers) {
+        patcher->rebind(nifPath, nif, nifAnalysis);
+    }
+    for (const auto& patcher : objects.globalPatchers) {
+        patcher->rebind(nifPath, nif, nifAnalysis);
+    }
+}
@@ -78,6 +78,7 @@ auto PatcherMeshShader::setTextureSet(nifly::NiShape& nifShape, const array<wstr
 
             // Set shader reference
             newBlockID = getNIF()->GetHeader().AddBlock(std::move(newTextureSet));
+            getNIFAnalysis().invalidateBlocks();
         }
 
         auto* const nifShaderBSLSP = dynamic_cast<nifly::BSLightingShaderProperty*>(nifShader);
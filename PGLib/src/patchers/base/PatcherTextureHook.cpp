@@ -14,7 +14,7 @@ PatcherTextureHook::PatcherTextureHook(std::filesystem::path texPath, std::strin
         throw runtime_error("File is not a DDS file");
     }
 
-    if (!getPGD3D()->getDDS(getDDSPath(), m_ddsImage)) {
+    if (!getPGD()->getDDS(getDDSPath(), m_ddsImage)) {
         Logger::debug(L"Unable to find/load DDS file: {}", getDDSPath().wstring());
     }
 }
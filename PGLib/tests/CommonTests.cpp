@@ -1,18 +1,22 @@
 #include "CommonTests.hpp"
-#include <array>
+#include "PGPlatform.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
 
 using namespace std;
 
 auto PGTesting::getExecutableDir() -> filesystem::path
 {
-    array<wchar_t, MAX_PATH> buffer = {};
-    if (GetModuleFileNameW(nullptr, buffer.data(), MAX_PATH) == 0) {
-        cerr << "Error getting executable path: " << GetLastError() << "\n";
+    const filesystem::path outPath = PGPlatform::getExecutablePath();
+    if (outPath.empty()) {
+        cerr << "Error getting executable path\n";
         exit(1);
     }
 
-    const filesystem::path outPath = filesystem::path(buffer.data());
-
     if (filesystem::exists(outPath)) {
         return outPath.parent_path();
     }
@@ -22,3 +26,30 @@ auto PGTesting::getExecutableDir() -> filesystem::path
 
     return {};
 }
+
+void PGTesting::MappedGameTest::SetUp()
+{
+    const auto& params = GetParam();
+
+    m_bg = make_unique<BethesdaGame>(params.GameType, false, params.GamePath, params.AppDataPath,
+        params.DocumentPath); // no logging
+    m_pgd = make_unique<ParallaxGenDirectory>(m_bg.get(), "", nullptr); // no logging
+
+    m_pgd->populateFileMap(true);
+    m_pgd->mapFiles({}, {}, {}, {});
+}
+
+void PGTesting::TempDirTest::SetUp()
+{
+    const auto* const testInfo = ::testing::UnitTest::GetInstance()->current_test_info();
+
+    // parameterized suites and tests contain '/'
+    auto dirName = string(testInfo->test_suite_name()) + "_" + testInfo->name();
+    ranges::replace(dirName, '/', '_');
+
+    m_tempDir = filesystem::temp_directory_path() / dirName;
+    filesystem::remove_all(m_tempDir);
+    filesystem::create_directories(m_tempDir);
+}
+
+void PGTesting::TempDirTest::TearDown() { filesystem::remove_all(m_tempDir); }
@@ -1,6 +1,8 @@
 #include "BethesdaGame.hpp"
+#include "ParallaxGenDirectory.hpp"
 
 #include <filesystem>
+#include <memory>
 
 #include <gtest/gtest.h>
 
@@ -13,6 +15,33 @@ struct TestEnvGameParams {
     std::filesystem::path AppDataPath;
     std::filesystem::path DocumentPath;
 };
+
+// NOLINTBEGIN(misc-non-private-member-variables-in-classes,cppcoreguidelines-non-private-member-variables-in-classes)
+/**
+ * @class MappedGameTest
+ * @brief Fixture with the game of a test environment loaded and all its files, BSAs included, mapped
+ */
+class MappedGameTest : public ::testing::TestWithParam<TestEnvGameParams> {
+protected:
+    void SetUp() override;
+
+    std::unique_ptr<BethesdaGame> m_bg;
+    std::unique_ptr<ParallaxGenDirectory> m_pgd;
+};
+
+/**
+ * @class TempDirTest
+ * @brief Fixture with an empty directory under the system temp directory, named after the test so tests run in
+ * parallel never share it. Removed after the test.
+ */
+class TempDirTest : public ::testing::Test {
+protected:
+    void SetUp() override;
+    void TearDown() override;
+
+    std::filesystem::path m_tempDir;
+};
+// NOLINTEND(misc-non-private-member-variables-in-classes,cppcoreguidelines-non-private-member-variables-in-classes)
 } // namespace PGTesting
 
 namespace PGTestEnvs {
@@ -20,7 +49,7 @@ const std::filesystem::path s_exePath = PGTesting::getExecutableDir();
 
 // Define test environments
 const PGTesting::TestEnvGameParams s_testENVSkyrimSE = { .GameType = BethesdaGame::GameType::SKYRIM_SE,
-    .GamePath = s_exePath / "env\\skyrimse\\game",
-    .AppDataPath = s_exePath / "env\\skyrimse\\appdata",
-    .DocumentPath = s_exePath / "env\\skyrimse\\documents" };
+    .GamePath = s_exePath / "env" / "skyrimse" / "game",
+    .AppDataPath = s_exePath / "env" / "skyrimse" / "appdata",
+    .DocumentPath = s_exePath / "env" / "skyrimse" / "documents" };
 } // namespace PGTestEnvs
@@ -0,0 +1,204 @@
+#include "Logger.hpp"
+
+#include <gtest/gtest.h>
+
+#include <spdlog/sinks/ringbuffer_sink.h>
+#include <spdlog/spdlog.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+std::atomic<int> s_numFormatted = 0;
+
+// Argument type that counts how often it is formatted
+struct CountingArg { };
+} // namespace
+
+template <> struct fmt::formatter<CountingArg> : fmt::formatter<std::string> {
+    auto format(const CountingArg& /*arg*/, format_context& ctx) const -> decltype(ctx.out())
+    {
+        s_numFormatted.fetch_add(1);
+        return fmt::formatter<std::string>::format("counted", ctx);
+    }
+};
+
+// NOLINTBEGIN(misc-non-private-member-variables-in-classes,cppcoreguidelines-non-private-member-variables-in-classes,cppcoreguidelines-avoid-magic-numbers)
+class LoggerTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        m_prevLogger = spdlog::default_logger();
+        m_sink = std::make_shared<spdlog::sinks::ringbuffer_sink_mt>(MAX_MESSAGES);
+        auto logger = std::make_shared<spdlog::logger>("LoggerTest", m_sink);
+        spdlog::set_default_logger(logger);
+        s_numFormatted.store(0);
+    }
+
+    void TearDown() override
+    {
+        Logger::stopAsync();
+        spdlog::set_default_logger(m_prevLogger);
+    }
+
+    [[nodiscard]] auto getMessages() const -> std::vector<std::string>
+    {
+        std::vector<std::string> messages;
+        for (const auto& msg : m_sink->last_raw()) {
+            messages.emplace_back(msg.payload.data(), msg.payload.size());
+        }
+        return messages;
+    }
+
+    static constexpr size_t MAX_MESSAGES = 10000;
+
+    std::shared_ptr<spdlog::logger> m_prevLogger;
+    std::shared_ptr<spdlog::sinks::ringbuffer_sink_mt> m_sink;
+};
+
+TEST_F(LoggerTest, DisabledLevelDoesNotFormat)
+{
+    spdlog::set_level(spdlog::level::info);
+
+    const Logger::Prefix prefix("prefix");
+    Logger::trace("trace {}", CountingArg {});
+    Logger::debug("debug {}", CountingArg {});
+    EXPECT_EQ(s_numFormatted.load(), 0);
+
+    spdlog::set_level(spdlog::level::off);
+    Logger::error("error {}", CountingArg {});
+    Logger::warn("warn {}", CountingArg {});
+    Logger::info("info {}", CountingArg {});
+    EXPECT_EQ(s_numFormatted.load(), 0);
+
+    spdlog::set_level(spdlog::level::trace);
+    Logger::trace("trace {}", CountingArg {});
+    EXPECT_EQ(s_numFormatted.load(), 1);
+    Logger::flush();
+
+    const auto messages = getMessages();
+    ASSERT_EQ(messages.size(), 1);
+    EXPECT_EQ(messages.at(0), "[prefix] trace counted");
+}
+
+TEST_F(LoggerTest, DeduplicatesErrorsAndWarnings)
+{
+    spdlog::set_level(spdlog::level::info);
+    Logger::startAsync();
+
+    Logger::warn("LoggerTest duplicate {}", 1);
+    Logger::warn(L"LoggerTest duplicate {}", 1);
+    Logger::warn("LoggerTest duplicate {}", 2);
+    Logger::info("LoggerTest info");
+    Logger::info("LoggerTest info");
+    Logger::flush();
+
+    const auto messages = getMessages();
+    ASSERT_EQ(messages.size(), 4);
+    EXPECT_EQ(messages.at(0), "LoggerTest duplicate 1");
+    EXPECT_EQ(messages.at(1), "LoggerTest duplicate 2");
+}
+
+TEST_F(LoggerTest, PerThreadOrderPreserved)
+{
+    static constexpr int NUM_THREADS = 8;
+    static constexpr int NUM_MESSAGES = 1000;
+
+    spdlog::set_level(spdlog::level::info);
+    Logger::startAsync();
+
+    std::vector<std::thread> threads;
+    threads.reserve(NUM_THREADS);
+    for (int t = 0; t < NUM_THREADS; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < NUM_MESSAGES; ++i) {
+                Logger::info("{} {}", t, i);
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    Logger::stopAsync();
+
+    const auto messages = getMessages();
+    ASSERT_EQ(messages.size(), NUM_THREADS * NUM_MESSAGES);
+
+    std::unordered_map<int, int> lastSeen;
+    for (const auto& message : messages) {
+        const auto space = message.find(' ');
+        const int thread = std::stoi(message.substr(0, space));
+        const int index = std::stoi(message.substr(space + 1));
+
+        const auto it = lastSeen.find(thread);
+        const int expected = it == lastSeen.end() ? 0 : it->second + 1;
+        ASSERT_EQ(index, expected);
+        lastSeen[thread] = index;
+    }
+}
+TEST_F(LoggerTest, StopWhileLogging)
+{
+    static constexpr int NUM_THREADS = 4;
+    static constexpr int NUM_MESSAGES = 2000;
+
+    spdlog::set_level(spdlog::level::info);
+    Logger::startAsync();
+
+    std::atomic<int> numStarted = 0;
+    std::vector<std::thread> threads;
+    threads.reserve(NUM_THREADS);
+    for (int t = 0; t < NUM_THREADS; ++t) {
+        threads.emplace_back([t, &numStarted] {
+            numStarted++;
+            for (int i = 0; i < NUM_MESSAGES; ++i) {
+                Logger::info("{} {}", t, i);
+            }
+        });
+    }
+
+    // stop while the producers are still running, late messages are written synchronously
+    while (numStarted < NUM_THREADS) {
+        std::this_thread::yield();
+    }
+    Logger::stopAsync();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const auto messages = getMessages();
+    ASSERT_EQ(messages.size(), NUM_THREADS * NUM_MESSAGES);
+
+    std::unordered_map<int, int> lastSeen;
+    for (const auto& message : messages) {
+        const auto space = message.find(' ');
+        const int thread = std::stoi(message.substr(0, space));
+        const int index = std::stoi(message.substr(space + 1));
+
+        const auto it = lastSeen.find(thread);
+        const int expected = it == lastSeen.end() ? 0 : it->second + 1;
+        ASSERT_EQ(index, expected);
+        lastSeen[thread] = index;
+    }
+}
+
+TEST_F(LoggerTest, MessageWithoutArgumentsIsLiteral)
+{
+    spdlog::set_level(spdlog::level::info);
+
+    Logger::info("LoggerTest {literal}");
+    Logger::error(L"LoggerTest {literal}");
+    Logger::flush();
+
+    const auto messages = getMessages();
+    ASSERT_EQ(messages.size(), 2);
+    EXPECT_EQ(messages.at(0), "LoggerTest {literal}");
+    EXPECT_EQ(messages.at(1), "LoggerTest {literal}");
+}
+// NOLINTEND(misc-non-private-member-variables-in-classes,cppcoreguidelines-non-private-member-variables-in-classes,cppcoreguidelines-avoid-magic-numbers)
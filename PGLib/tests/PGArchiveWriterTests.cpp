@@ -0,0 +1,146 @@
+#include "BethesdaDirectory.hpp"
+#include "CommonTests.hpp"
+#include "PGArchiveWriter.hpp"
+
+#include <gtest/gtest.h>
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+// NOLINTBEGIN(misc-non-private-member-variables-in-classes,cppcoreguidelines-non-private-member-variables-in-classes,cppcoreguidelines-avoid-magic-numbers)
+class PGArchiveWriterTest : public PGTesting::TempDirTest {
+protected:
+    void writeFile(const std::filesystem::path& relPath, const size_t& size, const unsigned& seed)
+    {
+        std::vector<std::byte> bytes(size);
+        for (size_t i = 0; i < size; ++i) {
+            // compressible but not constant
+            bytes[i] = static_cast<std::byte>((i / 7 + seed) & 0xFFU);
+        }
+
+        const auto path = m_tempDir / relPath;
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+        m_expected[relPath] = std::move(bytes);
+    }
+
+    static auto readBytes(const std::filesystem::path& path) -> std::vector<std::byte>
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::vector<std::byte> bytes(std::filesystem::file_size(path));
+        file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        return bytes;
+    }
+
+    static auto readLE32(const std::vector<std::byte>& bytes, const size_t& offset) -> uint32_t
+    {
+        uint32_t value = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            value |= std::to_integer<uint32_t>(bytes.at(offset + i)) << (8U * i);
+        }
+        return value;
+    }
+
+    std::map<std::filesystem::path, std::vector<std::byte>> m_expected;
+};
+
+TEST_F(PGArchiveWriterTest, Naming)
+{
+    const std::wstring base = L"PGTest";
+    EXPECT_EQ(PGArchiveWriter::getPluginName(base, 0), L"PGTest.esp");
+    EXPECT_EQ(PGArchiveWriter::getPluginName(base, 1), L"PGTest2.esp");
+    EXPECT_EQ(PGArchiveWriter::getArchiveName(base, 0, PGArchiveWriter::ArchiveContent::MESHES), L"PGTest.bsa");
+    EXPECT_EQ(
+        PGArchiveWriter::getArchiveName(base, 1, PGArchiveWriter::ArchiveContent::TEXTURES), L"PGTest2 - Textures.bsa");
+}
+
+TEST_F(PGArchiveWriterTest, RoundTripThroughBethesdaDirectory)
+{
+    writeFile("meshes/pg/a.nif", 3000, 1);
+    writeFile("meshes/pg/sub/b.nif", 3000, 2);
+    writeFile("meshes/pg/c.nif", 3000, 3);
+    writeFile("textures/pg/a_n.dds", 5000, 4);
+    writeFile("textures/pg/a_p.dds", 100, 5);
+    writeFile("LightPlacer/parallaxgen.json", 10, 6);
+
+    // limit forces one mesh per archive and splits the textures
+    PGArchiveWriter writer(m_tempDir, BethesdaGame::GameType::SKYRIM_SE, L"PGTest", 4000);
+    const auto archives = writer.writeArchives(false);
+
+    ASSERT_EQ(archives.size(), 5);
+    EXPECT_TRUE(std::filesystem::exists(m_tempDir / "PGTest.bsa"));
+    EXPECT_TRUE(std::filesystem::exists(m_tempDir / "PGTest3.bsa"));
+    EXPECT_TRUE(std::filesystem::exists(m_tempDir / "PGTest2 - Textures.bsa"));
+    for (const auto& plugin : { "PGTest.esp", "PGTest2.esp", "PGTest3.esp" }) {
+        EXPECT_TRUE(std::filesystem::exists(m_tempDir / plugin));
+    }
+    EXPECT_FALSE(std::filesystem::exists(m_tempDir / "PGTest4.esp"));
+
+    // packed loose files are gone, everything else is left alone
+    EXPECT_FALSE(std::filesystem::exists(m_tempDir / "meshes"));
+    EXPECT_FALSE(std::filesystem::exists(m_tempDir / "textures"));
+    EXPECT_TRUE(std::filesystem::exists(m_tempDir / "LightPlacer/parallaxgen.json"));
+
+    BethesdaDirectory bd(m_tempDir);
+    for (const auto& archive : archives) {
+        bd.addBSAToFileMap(archive.bsaPath.filename().wstring());
+    }
+
+    for (const auto& [relPath, bytes] : m_expected) {
+        if (relPath.begin()->wstring() == L"LightPlacer") {
+            continue;
+        }
+
+        ASSERT_TRUE(bd.isBSAFile(relPath)) << relPath;
+        EXPECT_EQ(bd.getFile(relPath), bytes) << relPath;
+    }
+}
+
+TEST_F(PGArchiveWriterTest, DummyPluginHeader)
+{
+    struct Expected {
+        BethesdaGame::GameType gameType;
+        uint32_t flags;
+        float hedrVersion;
+    };
+
+    for (const auto& [gameType, flags, hedrVersion] :
+        { Expected { .gameType = BethesdaGame::GameType::SKYRIM_SE, .flags = 0x200, .hedrVersion = 1.7F },
+            Expected { .gameType = BethesdaGame::GameType::SKYRIM_VR, .flags = 0, .hedrVersion = 1.7F },
+            Expected { .gameType = BethesdaGame::GameType::SKYRIM, .flags = 0, .hedrVersion = 0.94F },
+            Expected { .gameType = BethesdaGame::GameType::ENDERAL, .flags = 0, .hedrVersion = 0.94F } }) {
+        const auto pluginPath = m_tempDir / "Dummy.esp";
+        PGArchiveWriter::writeDummyPlugin(pluginPath, gameType);
+
+        const auto bytes = readBytes(pluginPath);
+        ASSERT_EQ(bytes.size(), 24 + 18 + 18); // 24 byte record header followed by HEDR and CNAM
+        EXPECT_EQ(std::string(reinterpret_cast<const char*>(bytes.data()), 4), "TES4");
+        EXPECT_EQ(readLE32(bytes, 8), flags) << BethesdaGame::getStrFromGameType(gameType);
+        EXPECT_EQ(std::bit_cast<float>(readLE32(bytes, 24 + 6)), hedrVersion)
+            << BethesdaGame::getStrFromGameType(gameType);
+    }
+}
+
+TEST_F(PGArchiveWriterTest, LegacyArchiveVersion)
+{
+    writeFile("meshes/pg/a.nif", 3000, 1);
+
+    PGArchiveWriter writer(m_tempDir, BethesdaGame::GameType::SKYRIM, L"PGTest");
+    const auto archives = writer.writeArchives(false);
+    ASSERT_EQ(archives.size(), 1);
+
+    // "BSA\0" followed by the version, 104 for Skyrim LE and 105 for SE
+    const auto bytes = readBytes(archives.front().bsaPath);
+    ASSERT_GE(bytes.size(), 8);
+    EXPECT_EQ(readLE32(bytes, 4), 104);
+    EXPECT_EQ(readLE32(readBytes(archives.front().pluginPath), 8), 0);
+}
+// NOLINTEND(misc-non-private-member-variables-in-classes,cppcoreguidelines-non-private-member-variables-in-classes,cppcoreguidelines-avoid-magic-numbers)
@@ -0,0 +1,173 @@
+#include "PGBlockCompressor.hpp"
+
+#include <gtest/gtest.h>
+
+#include <DirectXTex.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-pro-bounds-pointer-arithmetic)
+namespace {
+/// @brief RGBA8 texture with smooth gradients on every mip, height is not a multiple of the tile size
+auto makeTexture(const size_t& width, const size_t& height, const size_t& mips) -> DirectX::ScratchImage
+{
+    DirectX::ScratchImage image;
+    EXPECT_TRUE(SUCCEEDED(image.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM, width, height, 1, mips)));
+    for (size_t i = 0; i < image.GetImageCount(); ++i) {
+        const auto& level = image.GetImages()[i];
+        for (size_t y = 0; y < level.height; ++y) {
+            for (size_t x = 0; x < level.width; ++x) {
+                auto* px = level.pixels + (y * level.rowPitch) + (x * 4);
+                px[0] = static_cast<uint8_t>(x * 255 / max<size_t>(level.width - 1, 1));
+                px[1] = static_cast<uint8_t>(y * 255 / max<size_t>(level.height - 1, 1));
+                px[2] = static_cast<uint8_t>(128 + ((x + y) % 16));
+                px[3] = static_cast<uint8_t>(255 - (y * 255 / max<size_t>(level.height - 1, 1)));
+            }
+        }
+    }
+    return image;
+}
+
+auto isSame(const DirectX::ScratchImage& a, const DirectX::ScratchImage& b) -> bool
+{
+    return a.GetPixelsSize() == b.GetPixelsSize() && memcmp(a.GetPixels(), b.GetPixels(), a.GetPixelsSize()) == 0;
+}
+
+/// @brief PSNR of the first channels of the decompressed top mip against the source
+auto getPSNR(const DirectX::ScratchImage& source, const DirectX::ScratchImage& compressed, const size_t& channels)
+    -> double
+{
+    DirectX::ScratchImage decompressed;
+    EXPECT_TRUE(SUCCEEDED(
+        DirectX::Decompress(*compressed.GetImage(0, 0, 0), DXGI_FORMAT_R8G8B8A8_UNORM, decompressed)));
+
+    const auto* src = source.GetImage(0, 0, 0);
+    const auto* dec = decompressed.GetImage(0, 0, 0);
+    double sumSquared = 0.0;
+    for (size_t y = 0; y < src->height; ++y) {
+        for (size_t x = 0; x < src->width; ++x) {
+            for (size_t c = 0; c < channels; ++c) {
+                const auto diff = static_cast<double>(src->pixels[(y * src->rowPitch) + (x * 4) + c])
+                    - static_cast<double>(dec->pixels[(y * dec->rowPitch) + (x * 4) + c]);
+                sumSquared += diff * diff;
+            }
+        }
+    }
+
+    const auto mse = sumSquared / static_cast<double>(src->width * src->height * channels);
+    return mse == 0.0 ? INFINITY : 10.0 * log10((255.0 * 255.0) / mse);
+}
+} // namespace
+
+TEST(PGBlockCompressorTest, MatchesSingleCall)
+{
+    const auto input = makeTexture(256, 200, 4);
+
+    for (const auto& format : { DXGI_FORMAT_BC1_UNORM, DXGI_FORMAT_BC3_UNORM, DXGI_FORMAT_BC5_UNORM,
+             DXGI_FORMAT_BC7_UNORM }) {
+        PGBlockCompressor::Options options;
+        options.format = format;
+        options.quality = PGBlockCompressor::Quality::FAST;
+
+        DirectX::ScratchImage tiled;
+        ASSERT_TRUE(PGBlockCompressor::compress(input, options, tiled));
+        EXPECT_EQ(tiled.GetMetadata().mipLevels, 4);
+        EXPECT_EQ(tiled.GetMetadata().format, format);
+
+        DirectX::ScratchImage reference;
+        ASSERT_TRUE(SUCCEEDED(DirectX::Compress(input.GetImages(), input.GetImageCount(), input.GetMetadata(), format,
+            PGBlockCompressor::getCompressFlags(format, options.quality), options.alphaThreshold, reference)));
+        EXPECT_TRUE(isSame(tiled, reference)) << "format " << format;
+    }
+}
+
+TEST(PGBlockCompressorTest, Deterministic)
+{
+    const auto input = makeTexture(128, 300, 1);
+
+    PGBlockCompressor::Options options;
+    options.format = DXGI_FORMAT_BC3_UNORM;
+    options.quality = PGBlockCompressor::Quality::HIGH;
+
+    DirectX::ScratchImage first;
+    DirectX::ScratchImage second;
+    DirectX::ScratchImage singleThreaded;
+    ASSERT_TRUE(PGBlockCompressor::compress(input, options, first));
+    ASSERT_TRUE(PGBlockCompressor::compress(input, options, second));
+    options.multiThread = false;
+    ASSERT_TRUE(PGBlockCompressor::compress(input, options, singleThreaded));
+
+    EXPECT_TRUE(isSame(first, second));
+    EXPECT_TRUE(isSame(first, singleThreaded));
+}
+
+TEST(PGBlockCompressorTest, Quality)
+{
+    const auto input = makeTexture(256, 256, 1);
+
+    const auto check = [&input](const DXGI_FORMAT& format, const size_t& channels, const double& minPSNR) {
+        PGBlockCompressor::Options options;
+        options.format = format;
+
+        DirectX::ScratchImage output;
+        ASSERT_TRUE(PGBlockCompressor::compress(input, options, output));
+        EXPECT_GE(getPSNR(input, output, channels), minPSNR) << "format " << format;
+    };
+
+    check(DXGI_FORMAT_BC1_UNORM, 3, 32.0);
+    check(DXGI_FORMAT_BC3_UNORM, 4, 32.0);
+    check(DXGI_FORMAT_BC5_UNORM, 2, 38.0);
+    check(DXGI_FORMAT_BC7_UNORM, 4, 40.0);
+}
+
+TEST(PGBlockCompressorTest, Failures)
+{
+    const auto input = makeTexture(16, 16, 1);
+    DirectX::ScratchImage output;
+
+    PGBlockCompressor::Options options;
+    options.format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    EXPECT_FALSE(PGBlockCompressor::compress(input, options, output));
+
+    options.format = DXGI_FORMAT_BC1_UNORM;
+    ASSERT_TRUE(PGBlockCompressor::compress(input, options, output));
+
+    // already compressed
+    DirectX::ScratchImage twice;
+    EXPECT_FALSE(PGBlockCompressor::compress(output, options, twice));
+    EXPECT_EQ(twice.GetImageCount(), 0);
+}
+
+// run with --gtest_also_run_disabled_tests
+TEST(PGBlockCompressorTest, DISABLED_BenchmarkAgainstSingleCall)
+{
+    const auto input = makeTexture(2048, 2048, 12);
+
+    for (const auto& format : { DXGI_FORMAT_BC1_UNORM, DXGI_FORMAT_BC3_UNORM, DXGI_FORMAT_BC7_UNORM }) {
+        PGBlockCompressor::Options options;
+        options.format = format;
+        options.quality = PGBlockCompressor::Quality::FAST;
+
+        auto start = chrono::steady_clock::now();
+        DirectX::ScratchImage reference;
+        ASSERT_TRUE(SUCCEEDED(DirectX::Compress(input.GetImages(), input.GetImageCount(), input.GetMetadata(), format,
+            PGBlockCompressor::getCompressFlags(format, options.quality), options.alphaThreshold, reference)));
+        const auto singleCall = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+
+        start = chrono::steady_clock::now();
+        DirectX::ScratchImage tiled;
+        ASSERT_TRUE(PGBlockCompressor::compress(input, options, tiled));
+        const auto tiledTime = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+
+        cout << "format " << format << ": single call " << singleCall.count() << " ms, tiled " << tiledTime.count()
+             << " ms\n";
+    }
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-pro-bounds-pointer-arithmetic)
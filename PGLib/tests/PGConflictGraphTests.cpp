@@ -0,0 +1,138 @@
+#include "PGConflictGraph.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+namespace {
+using NIFUtil::ShapeShader;
+
+/// @brief Names of the mods in rows, to compare orders
+auto getOrderNames(const PGConflictGraph& graph) -> vector<wstring>
+{
+    vector<wstring> names;
+    for (const auto& id : graph.getOrder()) {
+        names.push_back(graph.getName(id));
+    }
+    return names;
+}
+} // namespace
+
+TEST(PGConflictGraphTest, Construction)
+{
+    PGConflictGraph graph;
+    EXPECT_TRUE(graph.empty());
+
+    graph.addConflict({ { L"ModA", ShapeShader::VANILLAPARALLAX }, { L"ModB", ShapeShader::COMPLEXMATERIAL },
+        { L"ModA", ShapeShader::TRUEPBR } });
+    graph.addConflict({ { L"ModA", ShapeShader::VANILLAPARALLAX }, { L"ModB", ShapeShader::VANILLAPARALLAX } });
+    graph.addConflict({ { L"ModC", ShapeShader::TRUEPBR }, { L"", ShapeShader::NONE } });
+
+    ASSERT_EQ(graph.size(), 4);
+    const auto modA = graph.getID(L"ModA");
+    const auto modB = graph.getID(L"ModB");
+    const auto modC = graph.getID(L"ModC");
+    const auto unmanaged = graph.getID(L"");
+    EXPECT_EQ(graph.getID(L"ModD"), PGConflictGraph::NPOS);
+    EXPECT_EQ(graph.getName(modC), L"ModC");
+
+    EXPECT_EQ(graph.getShaders(modA), (vector { ShapeShader::VANILLAPARALLAX, ShapeShader::TRUEPBR }));
+    EXPECT_EQ(graph.getHighestShader(modB), ShapeShader::COMPLEXMATERIAL);
+
+    // edges are symmetric and a mod never conflicts with itself
+    EXPECT_TRUE(graph.hasConflict(modA, modB));
+    EXPECT_TRUE(graph.hasConflict(modB, modA));
+    EXPECT_TRUE(graph.hasConflict(modC, unmanaged));
+    EXPECT_FALSE(graph.hasConflict(modA, modC));
+    EXPECT_FALSE(graph.hasConflict(modA, modA));
+    EXPECT_EQ(graph.getConflicts(modA), vector<size_t> { modB });
+    EXPECT_EQ(graph.getConflicts(unmanaged), vector<size_t> { modC });
+
+    const auto* edge = graph.getEdge(modB, modA);
+    ASSERT_NE(edge, nullptr);
+    EXPECT_EQ(edge->numShapes, 2);
+    EXPECT_EQ(edge->shaderMask,
+        (1U << static_cast<unsigned>(ShapeShader::VANILLAPARALLAX))
+            | (1U << static_cast<unsigned>(ShapeShader::COMPLEXMATERIAL))
+            | (1U << static_cast<unsigned>(ShapeShader::TRUEPBR)));
+    EXPECT_EQ(graph.getEdge(modA, modC), nullptr);
+}
+
+TEST(PGConflictGraphTest, ManyMods)
+{
+    // more mods than fit in one adjacency word, every mod conflicts with its neighbors in a ring
+    static constexpr size_t NUM_MODS = 200;
+    PGConflictGraph graph;
+    for (size_t i = 0; i < NUM_MODS; ++i) {
+        graph.addConflict({ { L"Mod" + to_wstring(i), ShapeShader::VANILLAPARALLAX },
+            { L"Mod" + to_wstring((i + 1) % NUM_MODS), ShapeShader::VANILLAPARALLAX } });
+    }
+
+    ASSERT_EQ(graph.size(), NUM_MODS);
+    for (size_t i = 0; i < NUM_MODS; ++i) {
+        const auto id = graph.getID(L"Mod" + to_wstring(i));
+        const auto next = graph.getID(L"Mod" + to_wstring((i + 1) % NUM_MODS));
+        const auto far = graph.getID(L"Mod" + to_wstring((i + NUM_MODS / 2) % NUM_MODS));
+        EXPECT_TRUE(graph.hasConflict(id, next));
+        EXPECT_FALSE(graph.hasConflict(id, far));
+        EXPECT_EQ(graph.getConflicts(id).size(), 2);
+    }
+}
+
+TEST(PGConflictGraphTest, SuggestOrder)
+{
+    PGConflictGraph graph;
+    graph.addConflict({ { L"PBR", ShapeShader::TRUEPBR }, { L"Parallax", ShapeShader::VANILLAPARALLAX },
+        { L"Saved2", ShapeShader::COMPLEXMATERIAL }, { L"", ShapeShader::NONE } });
+    graph.addConflict({ { L"CM", ShapeShader::COMPLEXMATERIAL }, { L"Saved1", ShapeShader::VANILLAPARALLAX },
+        { L"AlsoParallax", ShapeShader::VANILLAPARALLAX } });
+
+    // new mods by best shader then name, then saved mods in saved order, mods without conflicts are left out
+    EXPECT_EQ(graph.suggestOrder({ L"Saved1", L"Gone", L"Saved2" }),
+        (vector<wstring> { L"AlsoParallax", L"Parallax", L"CM", L"PBR", L"Saved1", L"Saved2" }));
+    EXPECT_EQ(graph.suggestOrder({}), (vector<wstring> { L"AlsoParallax", L"Parallax", L"Saved1", L"CM", L"Saved2",
+                                          L"PBR" }));
+}
+
+TEST(PGConflictGraphTest, RowTracking)
+{
+    PGConflictGraph graph;
+    graph.addConflict({ { L"A", ShapeShader::VANILLAPARALLAX }, { L"D", ShapeShader::VANILLAPARALLAX } });
+    graph.addConflict({ { L"B", ShapeShader::VANILLAPARALLAX }, { L"E", ShapeShader::VANILLAPARALLAX } });
+    graph.addConflict({ { L"C", ShapeShader::TRUEPBR }, { L"", ShapeShader::NONE } });
+    graph.setOrder({ L"A", L"B", L"C", L"D", L"E" });
+
+    EXPECT_EQ(graph.getConflictRows(0), vector<size_t> { 3 });
+    // the unmanaged mod is not shown
+    EXPECT_TRUE(graph.getConflictRows(2).empty());
+    EXPECT_EQ(graph.getRow(graph.getID(L"")), PGConflictGraph::NPOS);
+
+    // drag A and C below D, E is untouched
+    EXPECT_EQ(graph.moveRows({ 2, 0 }, 4), (pair<size_t, size_t> { 0, 4 }));
+    EXPECT_EQ(getOrderNames(graph), (vector<wstring> { L"B", L"D", L"A", L"C", L"E" }));
+    EXPECT_EQ(graph.getConflictRows(2), vector<size_t> { 1 });
+    EXPECT_EQ(graph.getConflictRows(0), vector<size_t> { 4 });
+
+    // drag E to the top
+    EXPECT_EQ(graph.moveRows({ 4 }, 0), (pair<size_t, size_t> { 0, 5 }));
+    EXPECT_EQ(getOrderNames(graph), (vector<wstring> { L"E", L"B", L"D", L"A", L"C" }));
+
+    // drag to the end, rows past the end are ignored
+    EXPECT_EQ(graph.moveRows({ 1, 9 }, 5), (pair<size_t, size_t> { 1, 5 }));
+    EXPECT_EQ(getOrderNames(graph), (vector<wstring> { L"E", L"D", L"A", L"C", L"B" }));
+    EXPECT_EQ(graph.moveRows({ 9 }, 0), (pair<size_t, size_t> { 0, 0 }));
+
+    graph.reverseOrder();
+    EXPECT_EQ(getOrderNames(graph), (vector<wstring> { L"B", L"C", L"A", L"D", L"E" }));
+    for (size_t row = 0; row < graph.getOrder().size(); ++row) {
+        EXPECT_EQ(graph.getRow(graph.getOrder()[row]), row);
+    }
+    EXPECT_EQ(graph.getConflictRows(0), vector<size_t> { 4 });
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
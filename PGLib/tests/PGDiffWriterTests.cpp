@@ -0,0 +1,153 @@
+#include "CommonTests.hpp"
+#include "PGDiffWriter.hpp"
+
+#include <gtest/gtest.h>
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,misc-non-private-member-variables-in-classes,cppcoreguidelines-non-private-member-variables-in-classes)
+class PGDiffWriterTest : public PGTesting::TempDirTest {
+protected:
+    /// @brief Diff JSON the way ParallaxGen wrote it before PGDiffWriter
+    auto writeReference(const vector<PGDiffWriter::Record>& records) const -> string
+    {
+        nlohmann::json diffJSON = nlohmann::json::object();
+        for (const auto& record : records) {
+            diffJSON[record.path]["crc32original"] = record.crcOriginal;
+            diffJSON[record.path]["crc32patched"] = record.crcPatched;
+        }
+
+        const auto path = m_tempDir / "reference.json";
+        ofstream diffJSONFile(path);
+        diffJSONFile << diffJSON << "\n";
+        diffJSONFile.close();
+        return readFile(path);
+    }
+
+    static auto readFile(const filesystem::path& path) -> string
+    {
+        ifstream f(path, ios::binary);
+        stringstream ss;
+        ss << f.rdbuf();
+        return ss.str();
+    }
+
+    /// @brief Mesh like paths, including characters that JSON has to escape
+    static auto makeRecords(const size_t& count) -> vector<PGDiffWriter::Record>
+    {
+        static const vector<string> specials
+            = { "meshes\\\"quoted\".nif", "meshes\\tab\t.nif", "meshes\\\xc3\xa9t\xc3\xa9.nif", "meshes\\ctrl\x01.nif" };
+
+        vector<PGDiffWriter::Record> records;
+        uint32_t state = 1;
+        for (size_t i = 0; i < count; ++i) {
+            state = (state * 1664525U) + 1013904223U;
+            auto path = "meshes\\architecture\\" + to_string(state % 997) + "\\mesh" + to_string(i) + ".nif";
+            if (i < specials.size()) {
+                path = specials[i];
+            }
+            records.push_back({ .path = path, .crcOriginal = state, .crcPatched = state ^ 0xFFFFFFFFU });
+        }
+        return records;
+    }
+};
+
+TEST_F(PGDiffWriterTest, MatchesJSONDump)
+{
+    const auto records = makeRecords(2000);
+
+    // small runs so most records go through spilled files
+    PGDiffWriter writer(m_tempDir / "runs", 4096);
+    for (const auto& record : records) {
+        writer.add(record.path, record.crcOriginal, record.crcPatched);
+    }
+    EXPECT_GT(writer.getNumRuns(), 1);
+    EXPECT_EQ(writer.getNumRecords(), records.size());
+
+    ASSERT_TRUE(writer.finish(m_tempDir / "diff.json"));
+    EXPECT_EQ(readFile(m_tempDir / "diff.json"), writeReference(records));
+    EXPECT_FALSE(filesystem::exists(m_tempDir / "runs"));
+}
+
+TEST_F(PGDiffWriterTest, ConcurrentThreads)
+{
+    const auto records = makeRecords(8000);
+
+    PGDiffWriter writer(m_tempDir / "runs", 8192);
+    vector<thread> threads;
+    static constexpr size_t NUM_THREADS = 8;
+    for (size_t t = 0; t < NUM_THREADS; ++t) {
+        threads.emplace_back([&writer, &records, t] {
+            for (size_t i = t; i < records.size(); i += NUM_THREADS) {
+                writer.add(records[i].path, records[i].crcOriginal, records[i].crcPatched);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_TRUE(writer.finish(m_tempDir / "diff.json"));
+    EXPECT_EQ(readFile(m_tempDir / "diff.json"), writeReference(records));
+}
+
+TEST_F(PGDiffWriterTest, EmptyAndDuplicates)
+{
+    {
+        PGDiffWriter writer(m_tempDir / "runs");
+        ASSERT_TRUE(writer.finish(m_tempDir / "empty.json"));
+        EXPECT_EQ(readFile(m_tempDir / "empty.json"), writeReference({}));
+    }
+
+    // the last entry of a path wins, also when the first one was spilled
+    const vector<PGDiffWriter::Record> records
+        = { { .path = "meshes\\b.nif", .crcOriginal = 1, .crcPatched = 2 },
+              { .path = "meshes\\a.nif", .crcOriginal = 3, .crcPatched = 4 },
+              { .path = "meshes\\b.nif", .crcOriginal = 5, .crcPatched = 6 } };
+
+    PGDiffWriter writer(m_tempDir / "runs", 1);
+    for (const auto& record : records) {
+        writer.add(record.path, record.crcOriginal, record.crcPatched);
+    }
+    EXPECT_EQ(writer.getNumRuns(), 3);
+
+    ASSERT_TRUE(writer.finish(m_tempDir / "diff.json"));
+    EXPECT_EQ(readFile(m_tempDir / "diff.json"), writeReference(records));
+}
+
+// run with --gtest_also_run_disabled_tests
+TEST_F(PGDiffWriterTest, DISABLED_BenchmarkManyMeshes)
+{
+    const auto records = makeRecords(300000);
+
+    const auto start = chrono::steady_clock::now();
+    PGDiffWriter writer(m_tempDir / "runs");
+    for (const auto& record : records) {
+        writer.add(record.path, record.crcOriginal, record.crcPatched);
+    }
+    const auto numRuns = writer.getNumRuns();
+    ASSERT_TRUE(writer.finish(m_tempDir / "diff.json"));
+    const auto writerTime = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+
+    const auto referenceStart = chrono::steady_clock::now();
+    const auto reference = writeReference(records);
+    const auto referenceTime
+        = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - referenceStart);
+
+    EXPECT_EQ(readFile(m_tempDir / "diff.json"), reference);
+    cout << "writer " << writerTime.count() << " ms in " << numRuns << " runs, nlohmann::json "
+         << referenceTime.count() << " ms\n";
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,misc-non-private-member-variables-in-classes,cppcoreguidelines-non-private-member-variables-in-classes)
@@ -0,0 +1,229 @@
+#include "CommonTests.hpp"
+#include "NIFUtil.hpp"
+#include "PGGeometry.hpp"
+
+#include <gtest/gtest.h>
+
+#include <Geometry.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <vector>
+
+using namespace std;
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,misc-non-private-member-variables-in-classes,cppcoreguidelines-non-private-member-variables-in-classes)
+namespace {
+struct Mesh {
+    vector<nifly::Vector2> uvs;
+    vector<nifly::Vector3> verts;
+    vector<nifly::Triangle> tris;
+};
+
+/// @brief Scalar auto UV scale as TruePBR computed it before PGGeometry
+auto referenceAutoUVScale(const vector<nifly::Vector2>& uvs, const vector<nifly::Vector3>& verts,
+    const vector<nifly::Triangle>& tris) -> nifly::Vector2
+{
+    const auto abs2 = [](nifly::Vector2 v) -> nifly::Vector2 { return { abs(v.u), abs(v.v) }; };
+
+    nifly::Vector2 scale;
+    for (const nifly::Triangle& t : tris) {
+        auto v1 = verts[t.p1];
+        auto v2 = verts[t.p2];
+        auto v3 = verts[t.p3];
+        auto uv1 = uvs[t.p1];
+        auto uv2 = uvs[t.p2];
+        auto uv3 = uvs[t.p3];
+
+        auto s = (abs2(uv2 - uv1) + abs2(uv3 - uv1)) / ((v2 - v1).length() + (v3 - v1).length());
+        scale += nifly::Vector2(1.0F / s.u, 1.0F / s.v);
+    }
+
+    scale *= 10.0 / 4.0;
+    scale /= static_cast<float>(tris.size());
+    scale.u = min(scale.u, scale.v);
+    scale.v = min(scale.u, scale.v);
+
+    return scale;
+}
+
+/// @brief Noisy grid with gridSize^2 quads, UVs are stretched differently in u and v
+auto makeGrid(const uint16_t& gridSize, const unsigned& seed) -> Mesh
+{
+    Mesh mesh;
+    uint32_t state = seed;
+    const auto noise = [&state]() -> float {
+        state = (state * 1664525U) + 1013904223U;
+        return static_cast<float>(state >> 8U) / static_cast<float>(1U << 24U);
+    };
+
+    for (uint16_t y = 0; y <= gridSize; ++y) {
+        for (uint16_t x = 0; x <= gridSize; ++x) {
+            mesh.verts.push_back({ .x = (static_cast<float>(x) * 8.0F) + noise(),
+                .y = (static_cast<float>(y) * 8.0F) + noise(),
+                .z = noise() * 4.0F });
+            mesh.uvs.emplace_back(static_cast<float>(x) * 0.25F, static_cast<float>(y) * 0.5F);
+        }
+    }
+
+    const auto stride = static_cast<uint16_t>(gridSize + 1);
+    for (uint16_t y = 0; y < gridSize; ++y) {
+        for (uint16_t x = 0; x < gridSize; ++x) {
+            const auto i = static_cast<uint16_t>((y * stride) + x);
+            mesh.tris.push_back({ i, static_cast<uint16_t>(i + 1), static_cast<uint16_t>(i + stride) });
+            mesh.tris.push_back({ static_cast<uint16_t>(i + 1), static_cast<uint16_t>(i + stride + 1),
+                static_cast<uint16_t>(i + stride) });
+        }
+    }
+
+    return mesh;
+}
+
+void expectNear(const optional<nifly::Vector2>& actual, const nifly::Vector2& expected)
+{
+    ASSERT_TRUE(actual.has_value());
+    EXPECT_NEAR(actual->u, expected.u, abs(expected.u) * 1e-5F);
+    EXPECT_NEAR(actual->v, expected.v, abs(expected.v) * 1e-5F);
+}
+} // namespace
+
+TEST(PGGeometryTest, MatchesScalarAutoUVScale)
+{
+    // below one lane group, exactly one batch, and many batches with a partial last one
+    for (const uint16_t& gridSize : { 1, 2, 8, 150 }) {
+        const auto mesh = makeGrid(gridSize, gridSize);
+        const auto expected = referenceAutoUVScale(mesh.uvs, mesh.verts, mesh.tris);
+        expectNear(PGGeometry::getAutoUVScale(mesh.uvs, mesh.verts, mesh.tris), expected);
+        EXPECT_EQ(PGGeometry::getAutoUVScale(mesh.uvs, mesh.verts, mesh.tris)->u,
+            PGGeometry::getAutoUVScale(mesh.uvs, mesh.verts, mesh.tris)->v);
+    }
+}
+
+TEST(PGGeometryTest, IgnoresInvalidTriangles)
+{
+    auto mesh = makeGrid(4, 1);
+    const auto expected = referenceAutoUVScale(mesh.uvs, mesh.verts, mesh.tris);
+
+    mesh.tris.push_back({ 0, 1, 60000 });
+    expectNear(PGGeometry::getAutoUVScale(mesh.uvs, mesh.verts, mesh.tris), expected);
+
+    // no triangle left to average
+    const vector<nifly::Triangle> invalidTris = { { 0, 1, 60000 }, { 60000, 1, 2 } };
+    EXPECT_FALSE(PGGeometry::getAutoUVScale(mesh.uvs, mesh.verts, invalidTris).has_value());
+    EXPECT_FALSE(PGGeometry::getAutoUVScaleCached(mesh.uvs, mesh.verts, invalidTris).has_value());
+}
+
+TEST(PGGeometryTest, Cache)
+{
+    PGGeometry::clearCache();
+    const auto meshA = makeGrid(10, 1);
+    const auto meshB = makeGrid(10, 2);
+
+    const auto scaleA = PGGeometry::getAutoUVScaleCached(meshA.uvs, meshA.verts, meshA.tris);
+    EXPECT_EQ(PGGeometry::getCacheSize(), 1);
+    EXPECT_EQ(PGGeometry::getAutoUVScaleCached(meshA.uvs, meshA.verts, meshA.tris)->u, scaleA->u);
+    EXPECT_EQ(PGGeometry::getCacheSize(), 1);
+
+    const auto scaleB = PGGeometry::getAutoUVScaleCached(meshB.uvs, meshB.verts, meshB.tris);
+    EXPECT_EQ(PGGeometry::getCacheSize(), 2);
+    EXPECT_EQ(scaleB->u, PGGeometry::getAutoUVScale(meshB.uvs, meshB.verts, meshB.tris)->u);
+
+    // same data split differently between the arrays
+    EXPECT_NE(PGGeometry::getGeometryHash(meshA.uvs, meshA.verts, meshA.tris),
+        PGGeometry::getGeometryHash(
+            meshA.uvs, span(meshA.verts).first(meshA.verts.size() - 1), span(meshA.tris).first(meshA.tris.size() - 1)));
+
+    PGGeometry::clearCache();
+    EXPECT_EQ(PGGeometry::getCacheSize(), 0);
+}
+
+TEST(PGGeometryTest, CacheIsBounded)
+{
+    PGGeometry::clearCache();
+
+    // one triangle per shape, shifted so every shape hashes differently
+    auto mesh = makeGrid(1, 1);
+    mesh.tris.resize(1);
+    const auto numShapes = PGGeometry::getMaxCacheSize() + 10;
+    for (size_t i = 0; i < numShapes; ++i) {
+        mesh.verts[0].z = static_cast<float>(i);
+        ASSERT_TRUE(PGGeometry::getAutoUVScaleCached(mesh.uvs, mesh.verts, mesh.tris).has_value());
+    }
+    EXPECT_EQ(PGGeometry::getCacheSize(), PGGeometry::getMaxCacheSize());
+
+    PGGeometry::clearCache();
+}
+
+class PGGeometryEnvTest : public PGTesting::MappedGameTest { };
+
+TEST_P(PGGeometryEnvTest, ShapesMatchScalarAutoUVScale)
+{
+    size_t numShapes = 0;
+    for (const auto& meshPath : m_pgd->getMeshes()) {
+        auto nif = NIFUtil::loadNIFFromBytes(m_pgd->getFile(meshPath));
+        for (auto* const shape : nif.GetShapes()) {
+            const auto* uvs = nif.GetUvsForShape(shape);
+            const auto* verts = nif.GetVertsForShape(shape);
+            vector<nifly::Triangle> tris;
+            shape->GetTriangles(tris);
+
+            const auto scale = PGGeometry::getShapeAutoUVScale(nif, shape);
+            if (uvs == nullptr || verts == nullptr || uvs->empty() || tris.empty()) {
+                EXPECT_FALSE(scale.has_value()) << meshPath;
+                continue;
+            }
+
+            ASSERT_TRUE(scale.has_value()) << meshPath;
+            const auto expected = referenceAutoUVScale(*uvs, *verts, tris);
+            if (isfinite(expected.u)) {
+                EXPECT_NEAR(scale->u, expected.u, abs(expected.u) * 1e-4F) << meshPath;
+            }
+            numShapes++;
+        }
+    }
+
+    EXPECT_GT(numShapes, 0);
+}
+
+INSTANTIATE_TEST_SUITE_P(GameParametersSE, PGGeometryEnvTest, ::testing::Values(PGTestEnvs::s_testENVSkyrimSE));
+
+// run with --gtest_also_run_disabled_tests
+TEST(PGGeometryTest, DISABLED_BenchmarkLargeMesh)
+{
+    // about 2.6 million triangles over 10 shapes that share the 16 bit index range
+    vector<Mesh> meshes;
+    for (unsigned i = 0; i < 10; ++i) {
+        meshes.push_back(makeGrid(254, i));
+    }
+
+    const auto time = [&meshes](const auto& func) {
+        const auto start = chrono::steady_clock::now();
+        float sink = 0.0F;
+        for (const auto& mesh : meshes) {
+            sink += func(mesh).value_or(nifly::Vector2()).u;
+        }
+        const auto elapsed = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start);
+        EXPECT_TRUE(isfinite(sink));
+        return elapsed.count();
+    };
+
+    const auto scalar = time([](const Mesh& mesh) {
+        return optional<nifly::Vector2>(referenceAutoUVScale(mesh.uvs, mesh.verts, mesh.tris));
+    });
+    const auto kernel
+        = time([](const Mesh& mesh) { return PGGeometry::getAutoUVScale(mesh.uvs, mesh.verts, mesh.tris); });
+
+    PGGeometry::clearCache();
+    const auto coldCache
+        = time([](const Mesh& mesh) { return PGGeometry::getAutoUVScaleCached(mesh.uvs, mesh.verts, mesh.tris); });
+    const auto warmCache
+        = time([](const Mesh& mesh) { return PGGeometry::getAutoUVScaleCached(mesh.uvs, mesh.verts, mesh.tris); });
+
+    cout << "scalar " << scalar << " us, kernel " << kernel << " us, cold cache " << coldCache << " us, warm cache "
+         << warmCache << " us\n";
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,misc-non-private-member-variables-in-classes,cppcoreguidelines-non-private-member-variables-in-classes)
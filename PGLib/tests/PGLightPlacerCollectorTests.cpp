@@ -0,0 +1,178 @@
+#include "PGLightPlacerCollector.hpp"
+
+#include <gtest/gtest.h>
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+namespace {
+struct Light {
+    string model;
+    nlohmann::json data;
+    PGLightPlacerCollector::Point point;
+};
+
+/// @brief lights over a few models with repeated data, like a load order with many copies of the same candles
+auto getLights(const size_t& numLights) -> vector<Light>
+{
+    vector<Light> lights;
+    lights.reserve(numLights);
+    for (size_t i = 0; i < numLights; ++i) {
+        nlohmann::json data = { { "light", "MagicLightWhite01" }, { "radius", static_cast<int>(i % 7) },
+            { "color", nlohmann::json::array({ 255, static_cast<int>(i % 3), 0 }) } };
+        lights.push_back({ .model = "clutter\\candle" + to_string(i % 50) + ".nif",
+            .data = std::move(data),
+            .point = { static_cast<double>(i % 11), static_cast<double>(i), -1.5 } });
+    }
+    return lights;
+}
+
+/// @brief add lights split over numThreads threads, thread t adds every numThreads-th light
+void addLights(PGLightPlacerCollector& collector, const vector<Light>& lights, const size_t& numThreads)
+{
+    vector<thread> threads;
+    threads.reserve(numThreads);
+    for (size_t t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&collector, &lights, t, numThreads] {
+            for (size_t i = t; i < lights.size(); i += numThreads) {
+                collector.add(lights[i].model, lights[i].data, lights[i].point);
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+} // namespace
+
+TEST(PGLightPlacerCollectorTest, MergesByModelAndData)
+{
+    PGLightPlacerCollector collector;
+
+    const nlohmann::json red = { { "light", "MagicLightWhite01" }, { "color", { 255, 0, 0 } } };
+    const nlohmann::json blue = { { "color", { 0, 0, 255 } }, { "light", "MagicLightWhite01" } };
+    const nlohmann::json redReordered = { { "color", { 255, 0, 0 } }, { "light", "MagicLightWhite01" } };
+
+    collector.add("b.nif", red, { 1.0, 2.0, 3.0 });
+    collector.add("a.nif", blue, { 0.0, 0.0, 1.0 });
+    collector.add("b.nif", redReordered, { 0.5, 2.0, 3.0 });
+    collector.add("b.nif", blue, { 0.0, 0.0, 0.0 });
+    collector.add("b.nif", red, { 1.0, 2.0, 3.0 }); // same light twice is kept
+
+    EXPECT_EQ(collector.size(), 5);
+
+    const auto output = collector.merge();
+    ASSERT_EQ(output.size(), 2);
+
+    EXPECT_EQ(output[0]["models"], nlohmann::json::array({ "a.nif" }));
+    ASSERT_EQ(output[0]["lights"].size(), 1);
+    EXPECT_EQ(output[0]["lights"][0]["data"], blue);
+
+    EXPECT_EQ(output[1]["models"], nlohmann::json::array({ "b.nif" }));
+    const auto& lights = output[1]["lights"];
+    ASSERT_EQ(lights.size(), 2);
+
+    // data sorts by serialization, blue "[0,...]" before red "[255,...]"
+    EXPECT_EQ(lights[0]["data"], blue);
+    EXPECT_EQ(lights[1]["data"], red);
+    EXPECT_EQ(lights[1]["points"], nlohmann::json::parse("[[0.5, 2.0, 3.0], [1.0, 2.0, 3.0], [1.0, 2.0, 3.0]]"));
+
+    collector.clear();
+    EXPECT_EQ(collector.size(), 0);
+    EXPECT_TRUE(collector.merge().empty());
+}
+
+TEST(PGLightPlacerCollectorTest, DeterministicOutput)
+{
+    auto lights = getLights(5000);
+
+    PGLightPlacerCollector reference;
+    addLights(reference, lights, 1);
+    const auto expected = reference.merge().dump(2);
+
+    // any thread count and any order the lights are found in writes the same file
+    mt19937 rng(42); // NOLINT(cert-msc32-c,cert-msc51-cpp)
+    for (const size_t numThreads : { 2, 3, 8 }) {
+        ranges::shuffle(lights, rng);
+
+        PGLightPlacerCollector collector;
+        addLights(collector, lights, numThreads);
+        EXPECT_EQ(collector.size(), lights.size());
+        EXPECT_EQ(collector.merge().dump(2), expected) << numThreads;
+    }
+}
+
+TEST(PGLightPlacerCollectorTest, IndependentCollectors)
+{
+    PGLightPlacerCollector first;
+    PGLightPlacerCollector second;
+
+    // the thread buffer cache must not mix up collectors used by one thread
+    first.add("a.nif", nlohmann::json::object(), { 0.0, 0.0, 0.0 });
+    second.add("b.nif", nlohmann::json::object(), { 0.0, 0.0, 0.0 });
+    first.add("a.nif", nlohmann::json::object(), { 1.0, 0.0, 0.0 });
+
+    EXPECT_EQ(first.size(), 2);
+    EXPECT_EQ(second.size(), 1);
+    EXPECT_EQ(second.merge()[0]["models"][0], "b.nif");
+}
+
+// run with --gtest_also_run_disabled_tests
+TEST(PGLightPlacerCollectorTest, DISABLED_BenchmarkContention)
+{
+    static constexpr size_t NUM_LIGHTS = 400000;
+    const auto numThreads = static_cast<size_t>(max(2U, thread::hardware_concurrency()));
+    const auto lights = getLights(NUM_LIGHTS);
+
+    const auto time = [](const auto& func) {
+        const auto start = chrono::steady_clock::now();
+        func();
+        return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+    };
+
+    // what the patcher did before, one JSON object per light pushed behind a global lock
+    nlohmann::json lockedData;
+    mutex lockedDataMutex;
+    const auto lockedTime = time([&] {
+        vector<thread> threads;
+        threads.reserve(numThreads);
+        for (size_t t = 0; t < numThreads; ++t) {
+            threads.emplace_back([&, t] {
+                for (size_t i = t; i < lights.size(); i += numThreads) {
+                    nlohmann::json lpJson;
+                    lpJson["models"] = nlohmann::json::array({ lights[i].model });
+                    lpJson["lights"] = nlohmann::json::array({ { { "data", lights[i].data },
+                        { "points", nlohmann::json::array({ lights[i].point }) } } });
+
+                    const lock_guard<mutex> lock(lockedDataMutex);
+                    lockedData.push_back(std::move(lpJson));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    });
+
+    PGLightPlacerCollector collector;
+    const auto collectorTime = time([&] { addLights(collector, lights, numThreads); });
+    const auto mergeTime = time([&] { EXPECT_FALSE(collector.merge().empty()); });
+
+    EXPECT_EQ(lockedData.size(), NUM_LIGHTS);
+    cout << numThreads << " threads: locked JSON " << lockedTime << " ms, collector " << collectorTime
+         << " ms, merge " << mergeTime << " ms\n";
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
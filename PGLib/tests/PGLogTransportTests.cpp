@@ -0,0 +1,172 @@
+#include "PGLogTransport.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-pro-bounds-pointer-arithmetic)
+namespace {
+/// @brief Stand-in for MessageHandler in PGMutagen, same level filter, ring buffer and GetLogMessages copy
+class ManagedLogProducer {
+private:
+    int m_minLevel = 0;
+    vector<uint16_t> m_buffer = vector<uint16_t>(16);
+    size_t m_start = 0;
+    size_t m_count = 0;
+
+public:
+    size_t m_numFormatted = 0;
+
+    void setLogLevel(const int& level) { m_minLevel = level; }
+
+    void log(const int& level, const wstring& message)
+    {
+        if (level < m_minLevel) {
+            return;
+        }
+        m_numFormatted++;
+
+        const size_t recordSize = PGLogTransport::HEADER_SIZE + message.size();
+        if (m_count + recordSize > m_buffer.size()) {
+            size_t newSize = m_buffer.size();
+            while (m_count + recordSize > newSize) {
+                newSize *= 2;
+            }
+            vector<uint16_t> newBuffer(newSize);
+            for (size_t i = 0; i < m_count; ++i) {
+                newBuffer[i] = peek(i);
+            }
+            m_buffer = std::move(newBuffer);
+            m_start = 0;
+        }
+
+        put(static_cast<uint16_t>(level));
+        put(static_cast<uint16_t>(message.size() & 0xFFFFU));
+        put(static_cast<uint16_t>(message.size() >> 16U));
+        for (const auto& c : message) {
+            put(static_cast<uint16_t>(c));
+        }
+    }
+
+    auto getLogMessages(uint16_t* buffer, const size_t& bufferSize) -> size_t
+    {
+        size_t written = 0;
+        while (m_count > 0) {
+            const size_t length = peek(1) | (static_cast<size_t>(peek(2)) << 16U);
+            const auto available = static_cast<ptrdiff_t>(bufferSize - written - PGLogTransport::HEADER_SIZE);
+            if (available < 0 || (static_cast<size_t>(available) < length && written > 0)) {
+                break;
+            }
+
+            const size_t copyLength = min(length, static_cast<size_t>(max<ptrdiff_t>(available, 0)));
+            buffer[written] = peek(0);
+            buffer[written + 1] = static_cast<uint16_t>(copyLength & 0xFFFFU);
+            buffer[written + 2] = static_cast<uint16_t>(copyLength >> 16U);
+            for (size_t i = 0; i < copyLength; ++i) {
+                buffer[written + PGLogTransport::HEADER_SIZE + i] = peek(PGLogTransport::HEADER_SIZE + i);
+            }
+
+            written += PGLogTransport::HEADER_SIZE + copyLength;
+            m_start = (m_start + PGLogTransport::HEADER_SIZE + length) % m_buffer.size();
+            m_count -= PGLogTransport::HEADER_SIZE + length;
+        }
+
+        return written;
+    }
+
+private:
+    [[nodiscard]] auto peek(const size_t& offset) const -> uint16_t
+    {
+        return m_buffer[(m_start + offset) % m_buffer.size()];
+    }
+
+    void put(const uint16_t& c)
+    {
+        m_buffer[(m_start + m_count) % m_buffer.size()] = c;
+        m_count++;
+    }
+};
+
+auto makeTransport(ManagedLogProducer& producer, const size_t& bufferSize) -> PGLogTransport
+{
+    return PGLogTransport(
+        [&producer](uint16_t* buffer, const size_t& size) -> size_t { return producer.getLogMessages(buffer, size); },
+        bufferSize);
+}
+} // namespace
+
+TEST(PGLogTransportTest, KeepsOrder)
+{
+    ManagedLogProducer producer;
+    // small buffer so messages are split over many calls and the producer ring wraps between drains
+    auto transport = makeTransport(producer, 40);
+
+    vector<pair<int, wstring>> expected;
+    vector<pair<int, wstring>> received;
+    const auto sink = [&received](const int& level, const wstring& message) { received.emplace_back(level, message); };
+
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < round % 7; ++i) {
+            const int level = (round + i) % 6;
+            const wstring message = L"[Round " + to_wstring(round) + L"] message " + to_wstring(i);
+            producer.log(level, message);
+            expected.emplace_back(level, message);
+        }
+        transport.drain(sink);
+    }
+    producer.log(PGLogTransport::INFO_LOG, L"");
+    expected.emplace_back(PGLogTransport::INFO_LOG, L"");
+    EXPECT_EQ(transport.drain(sink), 1);
+
+    EXPECT_EQ(received, expected);
+    EXPECT_EQ(transport.drain(sink), 0);
+}
+
+TEST(PGLogTransportTest, LevelFiltering)
+{
+    ManagedLogProducer producer;
+    producer.setLogLevel(PGLogTransport::toManagedLevel(spdlog::level::warn));
+    auto transport = makeTransport(producer, PGLogTransport::DEFAULT_BUFFER_SIZE);
+
+    for (int level = PGLogTransport::TRACE_LOG; level <= PGLogTransport::CRITICAL_LOG; ++level) {
+        producer.log(level, L"level " + to_wstring(level));
+    }
+    // dropped messages are never formatted
+    EXPECT_EQ(producer.m_numFormatted, 3);
+
+    vector<int> levels;
+    EXPECT_EQ(transport.drain([&levels](const int& level, const wstring&) { levels.push_back(level); }), 3);
+    EXPECT_EQ(levels,
+        (vector<int> { PGLogTransport::WARN_LOG, PGLogTransport::ERROR_LOG, PGLogTransport::CRITICAL_LOG }));
+
+    EXPECT_EQ(PGLogTransport::toManagedLevel(spdlog::level::trace), PGLogTransport::TRACE_LOG);
+    EXPECT_EQ(PGLogTransport::toManagedLevel(spdlog::level::off), PGLogTransport::OFF_LOG);
+}
+
+TEST(PGLogTransportTest, LongAndMalformedRecords)
+{
+    // a message longer than the buffer is cut off, the next one is unaffected
+    ManagedLogProducer producer;
+    auto transport = makeTransport(producer, 16);
+    producer.log(PGLogTransport::ERROR_LOG, wstring(100, L'x'));
+    producer.log(PGLogTransport::INFO_LOG, L"after");
+
+    vector<wstring> messages;
+    const auto sink = [&messages](const int&, const wstring& message) { messages.push_back(message); };
+    EXPECT_EQ(transport.drain(sink), 2);
+    EXPECT_EQ(messages, (vector<wstring> { wstring(16 - PGLogTransport::HEADER_SIZE, L'x'), L"after" }));
+
+    // decoding stops at a record that claims more text than the buffer has
+    messages.clear();
+    const vector<uint16_t> records = { 2, 2, 0, 'o', 'k', 2, 50, 0, 'b', 'a', 'd' };
+    EXPECT_EQ(PGLogTransport::decode(records, sink), 1);
+    EXPECT_EQ(messages, vector<wstring> { L"ok" });
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-pro-bounds-pointer-arithmetic)
@@ -0,0 +1,198 @@
+#include "PGFileCache.hpp"
+#include "PGMemoryBudget.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace {
+auto makeBuffer(const size_t& size) -> PGFileCache::Buffer
+{
+    return std::make_shared<const std::vector<std::byte>>(size, std::byte { 1 });
+}
+} // namespace
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+TEST(PGMemoryBudgetTests, LRUEviction)
+{
+    PGMemoryBudget::setBudget(100);
+
+    {
+        PGFileCache cache;
+        EXPECT_TRUE(cache.put("a", makeBuffer(20)));
+        EXPECT_TRUE(cache.put("b", makeBuffer(20)));
+        EXPECT_TRUE(cache.put("c", makeBuffer(20)));
+        EXPECT_TRUE(cache.put("d", makeBuffer(20)));
+        EXPECT_EQ(cache.getBytes(), 80);
+        EXPECT_EQ(PGMemoryBudget::getUsed(), 80);
+
+        // touch "a" so "b" becomes least recently used
+        EXPECT_NE(cache.get("a"), nullptr);
+
+        EXPECT_TRUE(cache.put("e", makeBuffer(25)));
+        EXPECT_EQ(cache.get("b"), nullptr);
+        EXPECT_NE(cache.get("a"), nullptr);
+        EXPECT_NE(cache.get("e"), nullptr);
+        EXPECT_LE(PGMemoryBudget::getUsed(), 100);
+
+        // too large to be admitted
+        EXPECT_FALSE(cache.put("f", makeBuffer(30)));
+        EXPECT_EQ(cache.get("f"), nullptr);
+
+        cache.clear();
+        EXPECT_EQ(cache.size(), 0);
+    }
+
+    EXPECT_EQ(PGMemoryBudget::getUsed(), 0);
+    PGMemoryBudget::setBudget(0);
+}
+
+TEST(PGMemoryBudgetTests, SharedBuffersSurviveEviction)
+{
+    PGMemoryBudget::setBudget(100);
+
+    {
+        PGFileCache cache;
+        const auto buffer = makeBuffer(20);
+        cache.put("a", buffer);
+
+        const auto hit = cache.get("a");
+        EXPECT_EQ(hit.get(), buffer.get());
+
+        cache.evict(100);
+        EXPECT_EQ(cache.get("a"), nullptr);
+        EXPECT_EQ(hit->size(), 20);
+    }
+
+    PGMemoryBudget::setBudget(0);
+}
+
+TEST(PGMemoryBudgetTests, ReservationsReclaimCaches)
+{
+    PGMemoryBudget::setBudget(100);
+
+    {
+        PGFileCache cache;
+        cache.put("a", makeBuffer(25));
+        cache.put("b", makeBuffer(25));
+        cache.put("c", makeBuffer(25));
+        EXPECT_FALSE(PGMemoryBudget::isNearLimit());
+
+        {
+            const PGMemoryBudget::Reservation reservation(80);
+            EXPECT_EQ(PGMemoryBudget::getInFlight(), 80);
+            EXPECT_LE(PGMemoryBudget::getUsed(), 100);
+            EXPECT_EQ(cache.get("a"), nullptr);
+
+            // nothing more can be cached while the reservation holds the budget
+            EXPECT_FALSE(cache.put("d", makeBuffer(25)));
+        }
+
+        EXPECT_EQ(PGMemoryBudget::getInFlight(), 0);
+
+        {
+            const PGMemoryBudget::Reservation reservation(95);
+            EXPECT_EQ(cache.size(), 0);
+            EXPECT_TRUE(PGMemoryBudget::isNearLimit());
+        }
+
+        // waiting with nothing in flight must return
+        cache.put("e", makeBuffer(25));
+        PGMemoryBudget::waitForHeadroom();
+        EXPECT_FALSE(PGMemoryBudget::isNearLimit());
+    }
+
+    PGMemoryBudget::setBudget(0);
+}
+
+TEST(PGMemoryBudgetTests, WaitWakesOnRelease)
+{
+    PGMemoryBudget::setBudget(100);
+
+    {
+        std::optional<PGMemoryBudget::Reservation> reservation(std::in_place, 95);
+        EXPECT_TRUE(PGMemoryBudget::isNearLimit());
+
+        std::atomic<bool> done = false;
+        std::thread waiter([&done] {
+            PGMemoryBudget::waitForHeadroom();
+            done = true;
+        });
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        EXPECT_FALSE(done);
+
+        reservation.reset();
+        waiter.join();
+        EXPECT_TRUE(done);
+    }
+
+    PGMemoryBudget::setBudget(0);
+}
+
+TEST(PGMemoryBudgetTests, WaitStopsOnRequest)
+{
+    PGMemoryBudget::setBudget(100);
+
+    {
+        // held for the whole test, only the stop condition can end the wait
+        const PGMemoryBudget::Reservation reservation(95);
+
+        std::atomic<bool> stop = false;
+        std::atomic<bool> done = false;
+        std::thread waiter([&stop, &done] {
+            PGMemoryBudget::waitForHeadroom([&stop] { return stop.load(); });
+            done = true;
+        });
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        EXPECT_FALSE(done);
+
+        stop = true;
+        PGMemoryBudget::notifyHeadroom();
+        waiter.join();
+        EXPECT_TRUE(done);
+        EXPECT_TRUE(PGMemoryBudget::isNearLimit());
+    }
+
+    PGMemoryBudget::setBudget(0);
+}
+
+TEST(PGMemoryBudgetTests, CacheHoldsBuffer)
+{
+    PGMemoryBudget::setBudget(100);
+
+    {
+        PGFileCache cache;
+        const auto buffer = makeBuffer(20);
+        cache.put("a", buffer);
+
+        // only the exact cached buffer is already charged
+        EXPECT_TRUE(cache.holds("a", buffer));
+        EXPECT_FALSE(cache.holds("a", makeBuffer(20)));
+        EXPECT_FALSE(cache.holds("b", buffer));
+
+        cache.evict(100);
+        EXPECT_FALSE(cache.holds("a", buffer));
+    }
+
+    PGMemoryBudget::setBudget(0);
+}
+
+TEST(PGMemoryBudgetTests, Unlimited)
+{
+    PGMemoryBudget::setBudget(0);
+
+    PGFileCache cache;
+    EXPECT_TRUE(cache.put("a", makeBuffer(1000)));
+    EXPECT_TRUE(PGMemoryBudget::fits(SIZE_MAX / 2));
+    EXPECT_FALSE(PGMemoryBudget::isNearLimit());
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
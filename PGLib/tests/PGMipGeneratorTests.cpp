@@ -0,0 +1,280 @@
+#include "PGMipGenerator.hpp"
+
+#include <gtest/gtest.h>
+
+#include <DirectXTex.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-pro-bounds-pointer-arithmetic,cppcoreguidelines-pro-type-reinterpret-cast)
+namespace {
+auto makeImage(const size_t& width, const size_t& height, const DXGI_FORMAT& format = DXGI_FORMAT_R8G8B8A8_UNORM)
+    -> DirectX::ScratchImage
+{
+    DirectX::ScratchImage image;
+    EXPECT_TRUE(SUCCEEDED(image.Initialize2D(format, width, height, 1, 1)));
+    return image;
+}
+
+/// @brief Smooth RGBA8 pattern so filters of any width agree closely
+void fillGradient(const DirectX::Image& image)
+{
+    for (size_t y = 0; y < image.height; ++y) {
+        for (size_t x = 0; x < image.width; ++x) {
+            auto* px = image.pixels + (y * image.rowPitch) + (x * 4);
+            px[0] = static_cast<uint8_t>(x * 255 / (image.width - 1));
+            px[1] = static_cast<uint8_t>(y * 255 / (image.height - 1));
+            px[2] = static_cast<uint8_t>((x + y) * 127 / (image.width + image.height - 2));
+            px[3] = 255;
+        }
+    }
+}
+
+/// @brief Naive 2x2 average of an RGBA8 level
+auto referenceBox(const DirectX::Image& src) -> vector<uint8_t>
+{
+    const auto width = src.width / 2;
+    const auto height = src.height / 2;
+    vector<uint8_t> out(width * height * 4);
+    for (size_t y = 0; y < height; ++y) {
+        for (size_t x = 0; x < width; ++x) {
+            for (size_t c = 0; c < 4; ++c) {
+                const auto sample = [&](const size_t& sx, const size_t& sy) {
+                    return static_cast<int>(src.pixels[(sy * src.rowPitch) + (sx * 4) + c]);
+                };
+                const auto sum = sample(2 * x, 2 * y) + sample((2 * x) + 1, 2 * y) + sample(2 * x, (2 * y) + 1)
+                    + sample((2 * x) + 1, (2 * y) + 1);
+                out[(((y * width) + x) * 4) + c] = static_cast<uint8_t>(lround(sum / 4.0));
+            }
+        }
+    }
+    return out;
+}
+
+auto maxDifference(const DirectX::Image& image, const vector<uint8_t>& reference) -> int
+{
+    int maxDiff = 0;
+    for (size_t y = 0; y < image.height; ++y) {
+        for (size_t x = 0; x < image.width * 4; ++x) {
+            const auto diff = abs(static_cast<int>(image.pixels[(y * image.rowPitch) + x])
+                - static_cast<int>(reference[(y * image.width * 4) + x]));
+            maxDiff = max(maxDiff, diff);
+        }
+    }
+    return maxDiff;
+}
+
+auto getCoverage(const DirectX::Image& image, const uint8_t& ref) -> float
+{
+    size_t covered = 0;
+    for (size_t y = 0; y < image.height; ++y) {
+        for (size_t x = 0; x < image.width; ++x) {
+            if (image.pixels[(y * image.rowPitch) + (x * 4) + 3] > ref) {
+                covered++;
+            }
+        }
+    }
+    return static_cast<float>(covered) / static_cast<float>(image.width * image.height);
+}
+} // namespace
+
+TEST(PGMipGeneratorTest, FullChain)
+{
+    EXPECT_EQ(PGMipGenerator::countMipLevels(1, 1), 1);
+    EXPECT_EQ(PGMipGenerator::countMipLevels(256, 64), 9);
+    EXPECT_EQ(PGMipGenerator::countMipLevels(5, 3), 3);
+
+    auto input = makeImage(64, 16);
+    fillGradient(*input.GetImage(0, 0, 0));
+
+    DirectX::ScratchImage output;
+    ASSERT_TRUE(PGMipGenerator::generate(*input.GetImage(0, 0, 0), {}, output));
+    ASSERT_EQ(output.GetMetadata().mipLevels, 7);
+    EXPECT_EQ(output.GetImage(6, 0, 0)->width, 1);
+    EXPECT_EQ(output.GetImage(6, 0, 0)->height, 1);
+
+    // top level is copied unchanged
+    const auto* inTop = input.GetImage(0, 0, 0);
+    const auto* outTop = output.GetImage(0, 0, 0);
+    EXPECT_EQ(memcmp(inTop->pixels, outTop->pixels, inTop->slicePitch), 0);
+
+    // requested level count is honored
+    PGMipGenerator::Options options;
+    options.mipLevels = 3;
+    ASSERT_TRUE(PGMipGenerator::generate(*inTop, options, output));
+    EXPECT_EQ(output.GetMetadata().mipLevels, 3);
+}
+
+TEST(PGMipGeneratorTest, MatchesReferenceBox)
+{
+    auto input = makeImage(64, 64);
+    fillGradient(*input.GetImage(0, 0, 0));
+    const auto reference = referenceBox(*input.GetImage(0, 0, 0));
+
+    PGMipGenerator::Options options;
+    options.filter = PGMipGenerator::Filter::BOX;
+    DirectX::ScratchImage output;
+    ASSERT_TRUE(PGMipGenerator::generate(*input.GetImage(0, 0, 0), options, output));
+    EXPECT_LE(maxDifference(*output.GetImage(1, 0, 0), reference), 1);
+
+    // kaiser sharpens, but a smooth gradient stays close to the box result away from the clamped edges
+    options.filter = PGMipGenerator::Filter::KAISER;
+    ASSERT_TRUE(PGMipGenerator::generate(*input.GetImage(0, 0, 0), options, output));
+    EXPECT_LE(maxDifference(*output.GetImage(1, 0, 0), reference), 6);
+
+    // threading does not change the result
+    DirectX::ScratchImage singleThreaded;
+    options.multiThread = false;
+    ASSERT_TRUE(PGMipGenerator::generate(*input.GetImage(0, 0, 0), options, singleThreaded));
+    EXPECT_EQ(memcmp(output.GetPixels(), singleThreaded.GetPixels(), output.GetPixelsSize()), 0);
+}
+
+TEST(PGMipGeneratorTest, ConstantStaysConstant)
+{
+    for (const auto& format : { DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB }) {
+        auto input = makeImage(32, 8, format);
+        memset(input.GetPixels(), 77, input.GetPixelsSize());
+
+        DirectX::ScratchImage output;
+        ASSERT_TRUE(PGMipGenerator::generate(*input.GetImage(0, 0, 0), {}, output));
+        for (size_t mip = 1; mip < output.GetMetadata().mipLevels; ++mip) {
+            const auto* image = output.GetImage(mip, 0, 0);
+            for (size_t i = 0; i < image->slicePitch; ++i) {
+                ASSERT_EQ(image->pixels[i], 77);
+            }
+        }
+    }
+}
+
+TEST(PGMipGeneratorTest, SRGB)
+{
+    // black and white columns average to mid gray in linear light
+    auto input = makeImage(2, 2, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB);
+    const auto* top = input.GetImage(0, 0, 0);
+    for (size_t y = 0; y < 2; ++y) {
+        memset(top->pixels + (y * top->rowPitch), 0, 4);
+        memset(top->pixels + (y * top->rowPitch) + 4, 255, 4);
+    }
+
+    PGMipGenerator::Options options;
+    options.filter = PGMipGenerator::Filter::BOX;
+    DirectX::ScratchImage output;
+    ASSERT_TRUE(PGMipGenerator::generate(*top, options, output));
+    EXPECT_NEAR(output.GetImage(1, 0, 0)->pixels[0], 188, 1);
+    // alpha is always linear
+    EXPECT_NEAR(output.GetImage(1, 0, 0)->pixels[3], 128, 1);
+
+    // the same data as plain UNORM averages the encoded values
+    auto unorm = makeImage(2, 2);
+    memcpy(unorm.GetPixels(), input.GetPixels(), input.GetPixelsSize());
+    ASSERT_TRUE(PGMipGenerator::generate(*unorm.GetImage(0, 0, 0), options, output));
+    EXPECT_NEAR(output.GetImage(1, 0, 0)->pixels[0], 128, 1);
+
+    options.forceSRGB = true;
+    ASSERT_TRUE(PGMipGenerator::generate(*unorm.GetImage(0, 0, 0), options, output));
+    EXPECT_NEAR(output.GetImage(1, 0, 0)->pixels[0], 188, 1);
+}
+
+TEST(PGMipGeneratorTest, FloatFormats)
+{
+    auto input = makeImage(4, 4, DXGI_FORMAT_R32G32B32A32_FLOAT);
+    auto* floats = reinterpret_cast<float*>(input.GetPixels());
+    for (size_t i = 0; i < 16 * 4; ++i) {
+        floats[i] = 4.0F;
+    }
+
+    PGMipGenerator::Options options;
+    options.filter = PGMipGenerator::Filter::BOX;
+    DirectX::ScratchImage output;
+    ASSERT_TRUE(PGMipGenerator::generate(*input.GetImage(0, 0, 0), options, output));
+    EXPECT_FLOAT_EQ(reinterpret_cast<const float*>(output.GetImage(2, 0, 0)->pixels)[0], 4.0F);
+
+    // 1.5 in half precision survives the round trip
+    auto half = makeImage(4, 4, DXGI_FORMAT_R16G16B16A16_FLOAT);
+    auto* halves = reinterpret_cast<uint16_t*>(half.GetPixels());
+    for (size_t i = 0; i < 16 * 4; ++i) {
+        halves[i] = 0x3E00;
+    }
+    ASSERT_TRUE(PGMipGenerator::generate(*half.GetImage(0, 0, 0), options, output));
+    EXPECT_EQ(reinterpret_cast<const uint16_t*>(output.GetImage(1, 0, 0)->pixels)[0], 0x3E00);
+}
+
+TEST(PGMipGeneratorTest, AlphaCoverage)
+{
+    // noisy alpha that is mostly below the reference, filtering averages it away
+    auto input = makeImage(64, 64);
+    const auto* top = input.GetImage(0, 0, 0);
+    uint32_t seed = 1;
+    for (size_t y = 0; y < top->height; ++y) {
+        for (size_t x = 0; x < top->width; ++x) {
+            seed = (seed * 1664525U) + 1013904223U;
+            top->pixels[(y * top->rowPitch) + (x * 4) + 3] = static_cast<uint8_t>((seed >> 24U) * 160 / 255);
+        }
+    }
+
+    constexpr uint8_t REF = 127;
+    const auto baseCoverage = getCoverage(*top, REF);
+
+    PGMipGenerator::Options options;
+    options.filter = PGMipGenerator::Filter::BOX;
+    DirectX::ScratchImage plain;
+    ASSERT_TRUE(PGMipGenerator::generate(*top, options, plain));
+    EXPECT_LT(getCoverage(*plain.GetImage(2, 0, 0), REF), baseCoverage / 2);
+
+    options.alphaCoverageRef = static_cast<float>(REF) / 255.0F;
+    DirectX::ScratchImage preserved;
+    ASSERT_TRUE(PGMipGenerator::generate(*top, options, preserved));
+    for (size_t mip = 1; mip < 4; ++mip) {
+        EXPECT_NEAR(getCoverage(*preserved.GetImage(mip, 0, 0), REF), baseCoverage, 0.05F);
+    }
+}
+
+TEST(PGMipGeneratorTest, EnsureMipChain)
+{
+    auto image = makeImage(16, 16);
+    fillGradient(*image.GetImage(0, 0, 0));
+    ASSERT_TRUE(PGMipGenerator::ensureMipChain(image, {}));
+    EXPECT_EQ(image.GetMetadata().mipLevels, 5);
+
+    // already complete, nothing changes
+    const auto* pixels = image.GetPixels();
+    ASSERT_TRUE(PGMipGenerator::ensureMipChain(image, {}));
+    EXPECT_EQ(image.GetPixels(), pixels);
+
+    auto unsupported = makeImage(16, 16, DXGI_FORMAT_UNKNOWN);
+    EXPECT_FALSE(PGMipGenerator::ensureMipChain(unsupported, {}));
+    EXPECT_EQ(unsupported.GetMetadata().mipLevels, 1);
+}
+
+// run with --gtest_also_run_disabled_tests
+TEST(PGMipGeneratorTest, DISABLED_Benchmark4K)
+{
+    auto input = makeImage(4096, 4096);
+    fillGradient(*input.GetImage(0, 0, 0));
+
+    for (const auto& filter : { PGMipGenerator::Filter::BOX, PGMipGenerator::Filter::KAISER }) {
+        for (const auto& multiThread : { false, true }) {
+            PGMipGenerator::Options options;
+            options.filter = filter;
+            options.multiThread = multiThread;
+
+            DirectX::ScratchImage output;
+            const auto start = chrono::steady_clock::now();
+            ASSERT_TRUE(PGMipGenerator::generate(*input.GetImage(0, 0, 0), options, output));
+            const auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+
+            cout << (filter == PGMipGenerator::Filter::BOX ? "box" : "kaiser")
+                 << (multiThread ? " threaded: " : " single: ") << elapsed.count() << " ms\n";
+        }
+    }
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-pro-bounds-pointer-arithmetic,cppcoreguidelines-pro-type-reinterpret-cast)
@@ -0,0 +1,234 @@
+#include "CommonTests.hpp"
+#include "NIFUtil.hpp"
+#include "PGNIFSplicer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,misc-non-private-member-variables-in-classes,cppcoreguidelines-non-private-member-variables-in-classes)
+namespace {
+/// @brief Minimal Skyrim SE NIF, blocks are opaque bytes of the given sizes
+struct SyntheticNIF {
+    vector<string> blockTypes;
+    vector<size_t> blockSizes;
+    vector<string> strings;
+    uint32_t version = PGNIFSplicer::SUPPORTED_VERSION;
+    uint32_t streamVersion = 100;
+
+    template <typename T> static void append(vector<std::byte>& out, const T& value)
+    {
+        const auto offset = out.size();
+        out.resize(offset + sizeof(T));
+        memcpy(&out[offset], &value, sizeof(T));
+    }
+
+    static void appendChars(vector<std::byte>& out, const string& str)
+    {
+        for (const auto& c : str) {
+            out.push_back(static_cast<std::byte>(c));
+        }
+    }
+
+    [[nodiscard]] auto getBytes() const -> vector<std::byte>
+    {
+        vector<std::byte> out;
+        appendChars(out, "Gamebryo File Format, Version 20.2.0.7\n");
+        append(out, version);
+        append(out, static_cast<uint8_t>(1));
+        append(out, PGNIFSplicer::SUPPORTED_USER_VERSION);
+        append(out, static_cast<uint32_t>(blockTypes.size()));
+        append(out, streamVersion);
+        for (const string exportString : { "author", "", "script" }) {
+            append(out, static_cast<uint8_t>(exportString.size()));
+            appendChars(out, exportString);
+        }
+
+        // one type entry per block keeps the builder simple
+        append(out, static_cast<uint16_t>(blockTypes.size()));
+        for (const auto& blockType : blockTypes) {
+            append(out, static_cast<uint32_t>(blockType.size()));
+            appendChars(out, blockType);
+        }
+        for (size_t i = 0; i < blockTypes.size(); ++i) {
+            append(out, static_cast<uint16_t>(i));
+        }
+        for (const auto& blockSize : blockSizes) {
+            append(out, static_cast<uint32_t>(blockSize));
+        }
+
+        append(out, static_cast<uint32_t>(strings.size()));
+        append(out, static_cast<uint32_t>(16));
+        for (const auto& str : strings) {
+            append(out, static_cast<uint32_t>(str.size()));
+            appendChars(out, str);
+        }
+
+        // no groups
+        append(out, static_cast<uint32_t>(0));
+        for (size_t i = 0; i < blockSizes.size(); ++i) {
+            out.insert(out.end(), blockSizes[i], static_cast<std::byte>(i));
+        }
+
+        // one root
+        append(out, static_cast<uint32_t>(1));
+        append(out, static_cast<uint32_t>(0));
+        return out;
+    }
+};
+} // namespace
+
+TEST(PGNIFSplicerTest, ParseLayout)
+{
+    const SyntheticNIF synthetic = { .blockTypes = { "NiNode", "BSTriShape", "BSLightingShaderProperty" },
+        .blockSizes = { 20, 300, 7 },
+        .strings = { "Scene Root", "Shape" } };
+    const auto bytes = synthetic.getBytes();
+
+    const auto layout = PGNIFSplicer::parseLayout(bytes);
+    ASSERT_TRUE(layout.has_value());
+    EXPECT_EQ(layout->blockTypes, synthetic.blockTypes);
+    EXPECT_EQ(layout->strings, synthetic.strings);
+    ASSERT_EQ(layout->blockOffsets.size(), 4);
+
+    // blocks are back to back and end at the footer
+    for (size_t i = 0; i < synthetic.blockSizes.size(); ++i) {
+        EXPECT_EQ(layout->blockOffsets[i + 1] - layout->blockOffsets[i], synthetic.blockSizes[i]);
+        EXPECT_EQ(bytes[layout->blockOffsets[i]], static_cast<std::byte>(i));
+    }
+    EXPECT_EQ(layout->blockOffsets.back(), bytes.size() - 8);
+    EXPECT_EQ(layout->stringsOffset, layout->blockSizesOffset + (3 * sizeof(uint32_t)));
+    EXPECT_EQ(layout->groupsOffset, layout->stringsOffset + 8 + (4 + 10) + (4 + 5));
+    EXPECT_EQ(layout->blockOffsets.front(), layout->groupsOffset + 4);
+}
+
+TEST(PGNIFSplicerTest, RejectsUnsupported)
+{
+    SyntheticNIF synthetic = { .blockTypes = { "NiNode" }, .blockSizes = { 20 }, .strings = { "Scene Root" } };
+    const auto bytes = synthetic.getBytes();
+    ASSERT_TRUE(PGNIFSplicer::parseLayout(bytes).has_value());
+
+    // truncated anywhere
+    for (const size_t size : { size_t { 0 }, size_t { 10 }, bytes.size() / 2, bytes.size() - 1 }) {
+        EXPECT_FALSE(PGNIFSplicer::parseLayout(span(bytes).first(size)).has_value()) << size;
+    }
+
+    // trailing bytes mean the block sizes do not describe the file
+    auto trailing = bytes;
+    trailing.push_back(std::byte { 0 });
+    EXPECT_FALSE(PGNIFSplicer::parseLayout(trailing).has_value());
+
+    // Fallout 4 header has more fields
+    synthetic.streamVersion = 130;
+    EXPECT_FALSE(PGNIFSplicer::parseLayout(synthetic.getBytes()).has_value());
+
+    synthetic.streamVersion = 83;
+    EXPECT_TRUE(PGNIFSplicer::parseLayout(synthetic.getBytes()).has_value());
+
+    synthetic.version = 0x14000005;
+    EXPECT_FALSE(PGNIFSplicer::parseLayout(synthetic.getBytes()).has_value());
+}
+
+class PGNIFSplicerEnvTest : public PGTesting::MappedGameTest { };
+
+TEST_P(PGNIFSplicerEnvTest, UnchangedNIFIsOriginal)
+{
+    size_t numSpliced = 0;
+    for (const auto& meshPath : m_pgd->getMeshes()) {
+        const auto nifBytes = m_pgd->getFile(meshPath);
+        auto nif = NIFUtil::loadNIFFromBytes(nifBytes);
+
+        PGNIFSplicer splicer;
+        splicer.capture(nif, nifBytes);
+        if (!splicer.isCaptured()) {
+            continue;
+        }
+
+        ASSERT_TRUE(splicer.canSplice(nif)) << meshPath;
+        EXPECT_EQ(splicer.save(nif), nifBytes) << meshPath;
+        numSpliced++;
+    }
+
+    EXPECT_GT(numSpliced, 0);
+}
+
+TEST_P(PGNIFSplicerEnvTest, MatchesFullSave)
+{
+    size_t numShapes = 0;
+    for (const auto& meshPath : m_pgd->getMeshes()) {
+        const auto nifBytes = m_pgd->getFile(meshPath);
+        auto nif = NIFUtil::loadNIFFromBytes(nifBytes);
+
+        PGNIFSplicer splicer;
+        splicer.capture(nif, nifBytes);
+        if (!splicer.isCaptured()) {
+            continue;
+        }
+
+        // the edits mesh patchers make: texture paths, shader type, flags, floats and names
+        for (auto* const shape : nif.GetShapes()) {
+            auto* const shader = dynamic_cast<nifly::BSLightingShaderProperty*>(nif.GetShader(shape));
+            if (shader == nullptr || !shader->HasTextureSet()) {
+                continue;
+            }
+
+            NIFUtil::setTextureSlot(
+                &nif, shape, NIFUtil::TextureSlots::PARALLAX, "textures\\pgtest\\" + to_string(numShapes) + "_p.dds");
+            NIFUtil::setShaderType(shader, nifly::BSLSP_PARALLAX);
+            NIFUtil::setShaderFlag(shader, nifly::SLSF1_SPECULAR);
+            NIFUtil::setShaderFloat(shader->glossiness, 123.0F);
+            shader->name = nifly::NiStringRef("PGTestShader" + to_string(numShapes));
+            numShapes++;
+        }
+
+        ASSERT_TRUE(splicer.canSplice(nif)) << meshPath;
+        const auto splicedBytes = splicer.save(nif);
+        ASSERT_FALSE(splicedBytes.empty()) << meshPath;
+        ASSERT_TRUE(PGNIFSplicer::parseLayout(splicedBytes).has_value()) << meshPath;
+
+        // both load in nifly and write the same NIF once nifly rebuilds the string table
+        const auto fullBytes = NIFUtil::saveNIFToBytes(nif, {});
+        auto splicedNIF = NIFUtil::loadNIFFromBytes(splicedBytes);
+        auto fullNIF = NIFUtil::loadNIFFromBytes(fullBytes);
+        ASSERT_EQ(splicedNIF.GetShapes().size(), fullNIF.GetShapes().size()) << meshPath;
+        for (size_t i = 0; i < fullNIF.GetShapes().size(); ++i) {
+            auto* const splicedShape = splicedNIF.GetShapes()[i];
+            auto* const fullShape = fullNIF.GetShapes()[i];
+            EXPECT_EQ(splicedShape->name.get(), fullShape->name.get()) << meshPath;
+            EXPECT_EQ(
+                NIFUtil::getTextureSlots(&splicedNIF, splicedShape), NIFUtil::getTextureSlots(&fullNIF, fullShape))
+                << meshPath;
+        }
+        EXPECT_EQ(NIFUtil::saveNIFToBytes(splicedNIF, {}), NIFUtil::saveNIFToBytes(fullNIF, {})) << meshPath;
+    }
+
+    EXPECT_GT(numShapes, 0);
+}
+
+TEST_P(PGNIFSplicerEnvTest, GeometryChangeNeedsFullSave)
+{
+    for (const auto& meshPath : m_pgd->getMeshes()) {
+        const auto nifBytes = m_pgd->getFile(meshPath);
+        auto nif = NIFUtil::loadNIFFromBytes(nifBytes);
+
+        PGNIFSplicer splicer;
+        splicer.capture(nif, nifBytes);
+        if (!splicer.isCaptured() || nif.GetShapes().empty()) {
+            continue;
+        }
+
+        auto* const shape = nif.GetShapes().front();
+        shape->SetVertexColors(!shape->HasVertexColors());
+        EXPECT_FALSE(splicer.canSplice(nif)) << meshPath;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(GameParametersSE, PGNIFSplicerEnvTest, ::testing::Values(PGTestEnvs::s_testENVSkyrimSE));
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,misc-non-private-member-variables-in-classes,cppcoreguidelines-non-private-member-variables-in-classes)
@@ -0,0 +1,170 @@
+#include "CommonTests.hpp"
+#include "PGOutputStore.hpp"
+
+#include <gtest/gtest.h>
+
+#include <nlohmann/json.hpp>
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+// NOLINTBEGIN(misc-non-private-member-variables-in-classes,cppcoreguidelines-non-private-member-variables-in-classes,cppcoreguidelines-avoid-magic-numbers)
+namespace {
+/// @brief Store on a filesystem that refuses every hardlink
+class PGOutputStoreNoLinks : public PGOutputStore {
+public:
+    using PGOutputStore::PGOutputStore;
+
+    int m_linkAttempts = 0;
+
+protected:
+    auto createHardLink(const std::filesystem::path& /*target*/, const std::filesystem::path& /*link*/)
+        -> bool override
+    {
+        m_linkAttempts++;
+        return false;
+    }
+};
+
+auto makeBytes(const size_t& size, const unsigned& seed) -> std::vector<std::byte>
+{
+    std::vector<std::byte> bytes(size);
+    for (size_t i = 0; i < size; ++i) {
+        bytes[i] = static_cast<std::byte>((i * 31 + seed) & 0xFFU);
+    }
+    return bytes;
+}
+
+auto readFile(const std::filesystem::path& path) -> std::vector<std::byte>
+{
+    std::ifstream file(path, std::ios::binary);
+    const std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::vector<std::byte> bytes(contents.size());
+    for (size_t i = 0; i < contents.size(); ++i) {
+        bytes[i] = static_cast<std::byte>(contents[i]);
+    }
+    return bytes;
+}
+} // namespace
+
+class PGOutputStoreTest : public PGTesting::TempDirTest { };
+
+TEST_F(PGOutputStoreTest, LinksDuplicates)
+{
+    PGOutputStore store(m_tempDir);
+    const auto data = makeBytes(4096, 1);
+
+    EXPECT_EQ(store.write("meshes/a.nif", data), PGOutputStore::WriteResult::WRITTEN);
+    EXPECT_EQ(store.write("meshes/sub/b.nif", data), PGOutputStore::WriteResult::LINKED);
+    EXPECT_EQ(store.write("meshes/c.nif", makeBytes(4096, 2)), PGOutputStore::WriteResult::WRITTEN);
+
+    EXPECT_EQ(readFile(m_tempDir / "meshes/sub/b.nif"), data);
+    EXPECT_TRUE(std::filesystem::equivalent(m_tempDir / "meshes/a.nif", m_tempDir / "meshes/sub/b.nif"));
+    EXPECT_EQ(std::filesystem::hard_link_count(m_tempDir / "meshes/a.nif"), 2);
+
+    EXPECT_EQ(store.getNumDeduplicated(), 1);
+    EXPECT_EQ(store.getBytesDeduplicated(), 4096);
+
+    // rewriting a linked path must not change the file it shares storage with
+    const auto other = makeBytes(4096, 3);
+    EXPECT_EQ(store.write("meshes/sub/b.nif", other), PGOutputStore::WriteResult::WRITTEN);
+    EXPECT_EQ(readFile(m_tempDir / "meshes/a.nif"), data);
+    EXPECT_EQ(readFile(m_tempDir / "meshes/sub/b.nif"), other);
+}
+
+TEST_F(PGOutputStoreTest, FallsBackToCopies)
+{
+    PGOutputStoreNoLinks store(m_tempDir);
+    const auto data = makeBytes(1000, 5);
+
+    EXPECT_EQ(store.write("a.dds", data), PGOutputStore::WriteResult::WRITTEN);
+    EXPECT_EQ(store.write("b.dds", data), PGOutputStore::WriteResult::COPIED);
+    EXPECT_EQ(store.write("c.dds", data), PGOutputStore::WriteResult::COPIED);
+
+    // linking is given up after the first failure
+    EXPECT_EQ(store.m_linkAttempts, 1);
+    EXPECT_EQ(readFile(m_tempDir / "b.dds"), data);
+    EXPECT_EQ(readFile(m_tempDir / "c.dds"), data);
+    EXPECT_FALSE(std::filesystem::equivalent(m_tempDir / "a.dds", m_tempDir / "c.dds"));
+    EXPECT_EQ(store.getNumDeduplicated(), 2);
+
+    // the manifest still records shared content
+    const auto manifest = store.getManifest();
+    EXPECT_EQ(manifest.at("c.dds").contentPath, "a.dds");
+
+    PGOutputStore noLinks(m_tempDir / "nolinks", false);
+    EXPECT_EQ(noLinks.write("a.dds", data), PGOutputStore::WriteResult::WRITTEN);
+    EXPECT_EQ(noLinks.write("b.dds", data), PGOutputStore::WriteResult::COPIED);
+    EXPECT_EQ(std::filesystem::hard_link_count(m_tempDir / "nolinks/a.dds"), 1);
+}
+
+TEST_F(PGOutputStoreTest, SameSizeDifferentContent)
+{
+    PGOutputStore store(m_tempDir);
+    auto data = makeBytes(512, 7);
+
+    EXPECT_EQ(store.write("a.nif", data), PGOutputStore::WriteResult::WRITTEN);
+    data[100] ^= std::byte { 1 };
+    EXPECT_EQ(store.write("b.nif", data), PGOutputStore::WriteResult::WRITTEN);
+    EXPECT_EQ(store.getNumDeduplicated(), 0);
+    EXPECT_EQ(readFile(m_tempDir / "b.nif"), data);
+}
+
+TEST_F(PGOutputStoreTest, Manifest)
+{
+    PGOutputStore store(m_tempDir);
+    const auto data = makeBytes(64, 9);
+    ASSERT_NE(store.write("b.nif", data), PGOutputStore::WriteResult::FAILED);
+    ASSERT_NE(store.write("a.nif", data), PGOutputStore::WriteResult::FAILED);
+
+    const auto manifestPath = m_tempDir / PGOutputStore::getManifestName();
+    ASSERT_TRUE(store.writeManifest(manifestPath));
+
+    std::ifstream manifestFile(manifestPath);
+    const auto json = nlohmann::json::parse(manifestFile);
+    ASSERT_EQ(json.size(), 2);
+    EXPECT_EQ(json["a.nif"]["path"], "b.nif");
+    EXPECT_EQ(json["b.nif"]["path"], "b.nif");
+    EXPECT_EQ(json["a.nif"]["content"], json["b.nif"]["content"]);
+    EXPECT_TRUE(json["a.nif"]["content"].get<std::string>().ends_with("-64"));
+
+    // hash is stable across runs
+    EXPECT_EQ(PGOutputStore::getContentHash({}), 14695981039346656037ULL);
+}
+
+TEST_F(PGOutputStoreTest, ConcurrentWrites)
+{
+    PGOutputStore store(m_tempDir);
+    constexpr size_t NUM_THREADS = 8;
+    constexpr size_t FILES_PER_THREAD = 50;
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < NUM_THREADS; ++t) {
+        threads.emplace_back([&store, t] {
+            for (size_t i = 0; i < FILES_PER_THREAD; ++i) {
+                // 5 distinct contents spread over all files
+                const auto path = "meshes/" + std::to_string(t) + "/" + std::to_string(i) + ".nif";
+                EXPECT_NE(store.write(path, makeBytes(256, static_cast<unsigned>(i % 5))),
+                    PGOutputStore::WriteResult::FAILED);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(store.getManifest().size(), NUM_THREADS * FILES_PER_THREAD);
+    EXPECT_EQ(store.getNumDeduplicated(), (NUM_THREADS * FILES_PER_THREAD) - 5);
+    for (size_t t = 0; t < NUM_THREADS; ++t) {
+        for (size_t i = 0; i < FILES_PER_THREAD; ++i) {
+            const auto path = m_tempDir / "meshes" / std::to_string(t) / (std::to_string(i) + ".nif");
+            EXPECT_EQ(readFile(path), makeBytes(256, static_cast<unsigned>(i % 5)));
+        }
+    }
+}
+// NOLINTEND(misc-non-private-member-variables-in-classes,cppcoreguidelines-non-private-member-variables-in-classes,cppcoreguidelines-avoid-magic-numbers)
@@ -0,0 +1,155 @@
+#include "PGPathFilter.hpp"
+
+#include <gtest/gtest.h>
+
+#include <boost/algorithm/string.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+namespace {
+/// @brief Synthetic lowercase file map keys like the ones BethesdaDirectory stores
+auto makePaths(const size_t& count, const wstring& prefix = L"textures") -> vector<filesystem::path>
+{
+    vector<filesystem::path> paths;
+    paths.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        paths.emplace_back(prefix + L"\\mod" + to_wstring(i % 97) + L"\\folder" + to_wstring(i % 1013) + L"\\file"
+            + to_wstring(i) + L"_n.dds");
+    }
+    return paths;
+}
+
+auto getPointers(const vector<filesystem::path>& paths) -> vector<const filesystem::path*>
+{
+    vector<const filesystem::path*> pointers;
+    pointers.reserve(paths.size());
+    for (const auto& path : paths) {
+        pointers.push_back(&path);
+    }
+    return pointers;
+}
+} // namespace
+
+TEST(PGPathFilterTest, ExactAnswers)
+{
+    const auto paths = makePaths(10000);
+    PGPathFilter filter;
+    EXPECT_EQ(filter.query(paths[0]), PGPathFilter::Result::UNKNOWN);
+
+    filter.build(getPointers(paths));
+    ASSERT_TRUE(filter.isBuilt());
+
+    for (const auto& path : paths) {
+        ASSERT_EQ(filter.query(path), PGPathFilter::Result::PRESENT);
+    }
+
+    // misses are never reported as present, the few false positives fall back to UNKNOWN
+    const auto misses = makePaths(10000, L"meshes");
+    size_t numUnknown = 0;
+    for (const auto& path : misses) {
+        const auto result = filter.query(path);
+        ASSERT_NE(result, PGPathFilter::Result::PRESENT);
+        if (result == PGPathFilter::Result::UNKNOWN) {
+            numUnknown++;
+        }
+    }
+    EXPECT_LT(numUnknown, misses.size() / 50);
+
+    filter.clear();
+    EXPECT_EQ(filter.query(paths[0]), PGPathFilter::Result::UNKNOWN);
+}
+
+TEST(PGPathFilterTest, Normalization)
+{
+    const vector<filesystem::path> paths = { filesystem::path(L"textures") / L"architecture" / L"wall_p.dds",
+        filesystem::path(L"meshes") / L"bucket.nif" };
+    PGPathFilter filter;
+    filter.build(getPointers(paths));
+
+    // case and repeated separators are ignored like in the file map
+    EXPECT_EQ(filter.query(L"Textures/Architecture/WALL_P.dds"), PGPathFilter::Result::PRESENT);
+    EXPECT_EQ(filter.query(L"meshes//bucket.nif"), PGPathFilter::Result::PRESENT);
+    EXPECT_EQ(filter.query(L"meshes/bucket.ni"), PGPathFilter::Result::ABSENT);
+    EXPECT_EQ(filter.query(L""), PGPathFilter::Result::ABSENT);
+
+    // non ASCII paths are always looked up in the map
+    EXPECT_EQ(filter.query(u8"textures/\u00C4rchitecture/wall_p.dds"), PGPathFilter::Result::UNKNOWN);
+}
+
+TEST(PGPathFilterTest, AddAfterBuild)
+{
+    const auto paths = makePaths(1000);
+    PGPathFilter filter;
+    filter.build(getPointers(paths));
+
+    // generated files are not in the frozen table, the map has to answer
+    const filesystem::path generated = L"textures\\generated\\file_m.dds";
+    EXPECT_EQ(filter.query(generated), PGPathFilter::Result::ABSENT);
+    filter.add(generated);
+    EXPECT_EQ(filter.query(generated), PGPathFilter::Result::UNKNOWN);
+    EXPECT_EQ(filter.query(L"TEXTURES\\GENERATED\\FILE_M.DDS"), PGPathFilter::Result::UNKNOWN);
+}
+
+// run with --gtest_also_run_disabled_tests
+TEST(PGPathFilterTest, DISABLED_Benchmark1MPaths)
+{
+    static constexpr size_t NUM_PATHS = 1000000;
+    const auto paths = makePaths(NUM_PATHS);
+    map<filesystem::path, size_t> fileMap;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        fileMap.emplace(paths[i], i);
+    }
+
+    vector<const filesystem::path*> keys;
+    keys.reserve(fileMap.size());
+    for (const auto& [key, value] : fileMap) {
+        keys.push_back(&key);
+    }
+    PGPathFilter filter;
+    const auto buildStart = chrono::steady_clock::now();
+    filter.build(keys);
+    const auto buildTime
+        = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - buildStart).count();
+
+    // candidate texture probes, most of them miss
+    vector<filesystem::path> queries;
+    for (size_t i = 0; i < NUM_PATHS; ++i) {
+        queries.emplace_back(
+            i % 10 == 0 ? paths[i].wstring() : boost::replace_last_copy(paths[i].wstring(), L"_n", L"_p"));
+    }
+
+    mutex fileMapMutex;
+    const auto mapLookup = [&](const filesystem::path& path) {
+        const lock_guard<mutex> lock(fileMapMutex);
+        return fileMap.contains(boost::to_lower_copy(path.wstring(), locale::classic()));
+    };
+
+    const auto time = [&queries](const auto& func) {
+        const auto start = chrono::steady_clock::now();
+        size_t numFound = 0;
+        for (const auto& query : queries) {
+            numFound += func(query) ? 1 : 0;
+        }
+        EXPECT_EQ(numFound, NUM_PATHS / 10);
+        return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+    };
+
+    const auto mapTime = time(mapLookup);
+    const auto filterTime = time([&](const filesystem::path& path) {
+        const auto result = filter.query(path);
+        return result == PGPathFilter::Result::UNKNOWN ? mapLookup(path) : result == PGPathFilter::Result::PRESENT;
+    });
+
+    cout << "build " << buildTime << " ms, locked map " << mapTime << " ms, filter " << filterTime << " ms\n";
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
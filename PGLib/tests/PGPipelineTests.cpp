@@ -0,0 +1,307 @@
+#include "PGMemoryBudget.hpp"
+#include "PGPipeline.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+namespace {
+/// @brief deterministic per item work, stands in for parsing and patching
+auto mix(uint64_t value) -> uint64_t
+{
+    for (int i = 0; i < 100; ++i) {
+        value ^= value >> 33U;
+        value *= 0xff51afd7ed558ccdULL;
+    }
+    return value;
+}
+
+void spinFor(const chrono::microseconds& duration)
+{
+    const auto end = chrono::steady_clock::now() + duration;
+    while (chrono::steady_clock::now() < end) {
+    }
+}
+} // namespace
+
+TEST(PGPipelineTest, EveryItemPassesStagesInOrder)
+{
+    static constexpr size_t NUM_ITEMS = 5000;
+
+    // bit i is set once stage i ran, a stage checks that all earlier bits are set
+    vector<atomic<uint32_t>> seen(NUM_ITEMS);
+    atomic<size_t> outOfOrder = 0;
+    const auto makeStage = [&](const uint32_t& bit, const size_t& numThreads) -> PGPipeline::Stage {
+        return { .name = "stage" + to_string(bit),
+            .numThreads = numThreads,
+            .queueCapacity = 4,
+            .func =
+                [&, bit](size_t item) {
+                    const auto previous = seen[item].fetch_or(1U << bit);
+                    if (previous != (1U << bit) - 1) {
+                        outOfOrder++;
+                    }
+                    return true;
+                } };
+    };
+
+    PGPipeline pipeline({ makeStage(0, 3), makeStage(1, 5), makeStage(2, 2) });
+    pipeline.run(NUM_ITEMS);
+
+    EXPECT_EQ(outOfOrder, 0);
+    EXPECT_TRUE(ranges::all_of(seen, [](const auto& bits) { return bits.load() == 0b111U; }));
+}
+
+TEST(PGPipelineTest, MatchesSerial)
+{
+    static constexpr size_t NUM_ITEMS = 2000;
+
+    const auto runWith = [](const bool& multithread) {
+        vector<uint64_t> read(NUM_ITEMS);
+        vector<uint64_t> patched(NUM_ITEMS);
+        vector<uint64_t> written(NUM_ITEMS);
+
+        PGPipeline pipeline({ { .name = "read",
+                                  .numThreads = 4,
+                                  .func =
+                                      [&](size_t item) {
+                                          read[item] = mix(item);
+                                          return item % 10 != 3; // some reads fail
+                                      } },
+                                { .name = "patch",
+                                    .numThreads = 3,
+                                    .queueCapacity = 8,
+                                    .func =
+                                        [&](size_t item) {
+                                            patched[item] = mix(read[item]);
+                                            return patched[item] % 2 == 0; // some are not modified
+                                        } },
+                                { .name = "write",
+                                    .numThreads = 2,
+                                    .queueCapacity = 8,
+                                    .func =
+                                        [&](size_t item) {
+                                            written[item] = patched[item] + 1;
+                                            return true;
+                                        } } },
+            multithread);
+        pipeline.run(NUM_ITEMS);
+
+        return written;
+    };
+
+    const auto serial = runWith(false);
+    EXPECT_EQ(runWith(true), serial);
+
+    // dropped items never reached the last stage
+    for (size_t item = 3; item < NUM_ITEMS; item += 10) {
+        EXPECT_EQ(serial[item], 0) << item;
+    }
+    EXPECT_GT(ranges::count_if(serial, [](const uint64_t& value) { return value != 0; }), NUM_ITEMS / 4);
+}
+
+TEST(PGPipelineTest, BackPressure)
+{
+    static constexpr size_t NUM_ITEMS = 200;
+    static constexpr size_t QUEUE_CAPACITY = 3;
+
+    // items that left the first stage and did not finish the last
+    atomic<size_t> inFlight = 0;
+    atomic<size_t> maxInFlight = 0;
+
+    PGPipeline pipeline({ { .name = "read",
+                              .numThreads = 2,
+                              .func =
+                                  [&](size_t) {
+                                      const auto current = inFlight.fetch_add(1) + 1;
+                                      auto previousMax = maxInFlight.load();
+                                      while (current > previousMax
+                                          && !maxInFlight.compare_exchange_weak(previousMax, current)) {
+                                      }
+                                      return true;
+                                  } },
+        { .name = "patch", .numThreads = 2, .queueCapacity = QUEUE_CAPACITY, .func = [](size_t) { return true; } },
+        { .name = "write",
+            .numThreads = 1,
+            .queueCapacity = QUEUE_CAPACITY,
+            .func =
+                [&](size_t) {
+                    this_thread::sleep_for(chrono::microseconds(200));
+                    inFlight--;
+                    return true;
+                } } });
+    pipeline.run(NUM_ITEMS);
+
+    // one item per worker plus what the queues hold
+    EXPECT_EQ(inFlight, 0);
+    EXPECT_LE(maxInFlight, 2 + 2 + 1 + (2 * QUEUE_CAPACITY));
+}
+
+TEST(PGPipelineTest, ExceptionStopsAllStages)
+{
+    static constexpr size_t NUM_ITEMS = 100000;
+
+    atomic<size_t> written = 0;
+    PGPipeline pipeline({ { .name = "read", .numThreads = 2, .func = [](size_t) { return true; } },
+        { .name = "patch",
+            .numThreads = 2,
+            .queueCapacity = 2,
+            .func =
+                [](size_t item) {
+                    if (item == 50) {
+                        throw runtime_error("patch failed");
+                    }
+                    return true;
+                } },
+        { .name = "write",
+            .numThreads = 1,
+            .queueCapacity = 2,
+            .func =
+                [&](size_t) {
+                    written++;
+                    return true;
+                } } });
+
+    EXPECT_THROW(pipeline.run(NUM_ITEMS), runtime_error);
+    EXPECT_LT(written, NUM_ITEMS);
+
+    PGPipeline serial({ { .name = "patch", .func = [](size_t) -> bool { throw runtime_error("patch failed"); } } },
+        false);
+    EXPECT_THROW(serial.run(1), runtime_error);
+}
+
+TEST(PGPipelineTest, ExceptionUnderBudgetPressureReturns)
+{
+    static constexpr size_t NUM_ITEMS = 1000;
+    static constexpr size_t ITEM_BYTES = 100;
+
+    // a few read items fill the budget, reading then waits for headroom that only the write stage gives back
+    PGMemoryBudget::setBudget(ITEM_BYTES * 8);
+
+    // only the thread holding an item touches its reservation
+    vector<unique_ptr<PGMemoryBudget::Reservation>> reservations(NUM_ITEMS);
+    atomic<size_t> numDropped = 0;
+    PGPipeline pipeline({ { .name = "read",
+                              .numThreads = 4,
+                              .func =
+                                  [&](size_t item) {
+                                      reservations[item] = make_unique<PGMemoryBudget::Reservation>(ITEM_BYTES);
+                                      return true;
+                                  } },
+                            { .name = "patch",
+                                .numThreads = 2,
+                                .queueCapacity = 16,
+                                .func =
+                                    [](size_t item) {
+                                        if (item == 20) {
+                                            // let the read threads block on the budget first
+                                            this_thread::sleep_for(chrono::milliseconds(20));
+                                            throw runtime_error("patch failed");
+                                        }
+                                        return true;
+                                    } },
+                            { .name = "write",
+                                .numThreads = 1,
+                                .queueCapacity = 16,
+                                .func =
+                                    [&](size_t item) {
+                                        this_thread::sleep_for(chrono::milliseconds(1));
+                                        reservations[item].reset();
+                                        return true;
+                                    } } },
+        true,
+        [&](size_t item) {
+            reservations[item].reset();
+            numDropped++;
+        });
+
+    EXPECT_THROW(pipeline.run(NUM_ITEMS), runtime_error);
+
+    // the failed item and everything queued behind it gave its reservation back
+    EXPECT_GT(numDropped, 0);
+    EXPECT_EQ(PGMemoryBudget::getInFlight(), 0);
+
+    PGMemoryBudget::setBudget(0);
+}
+
+TEST(PGPipelineTest, EmptyAndZeroSizes)
+{
+    atomic<size_t> numRun = 0;
+    PGPipeline pipeline({ { .name = "only",
+        .numThreads = 0,
+        .queueCapacity = 0,
+        .func =
+            [&](size_t) {
+                numRun++;
+                return true;
+            } } });
+
+    pipeline.run(0);
+    EXPECT_EQ(numRun, 0);
+    pipeline.run(10);
+    EXPECT_EQ(numRun, 10);
+
+    EXPECT_THROW(PGPipeline({}), invalid_argument);
+}
+
+// run with --gtest_also_run_disabled_tests
+TEST(PGPipelineTest, DISABLED_BenchmarkSlowDisk)
+{
+    static constexpr size_t NUM_ITEMS = 2000;
+    static constexpr chrono::microseconds READ_LATENCY { 2000 };
+    static constexpr chrono::microseconds PATCH_WORK { 500 };
+    static constexpr chrono::microseconds WRITE_LATENCY { 1000 };
+    const auto numCPUThreads = static_cast<size_t>(max(2U, thread::hardware_concurrency()));
+
+    const auto read = [](size_t) {
+        this_thread::sleep_for(READ_LATENCY);
+        return true;
+    };
+    const auto patch = [](size_t) {
+        spinFor(PATCH_WORK);
+        return true;
+    };
+    const auto write = [](size_t) {
+        this_thread::sleep_for(WRITE_LATENCY);
+        return true;
+    };
+
+    const auto time = [](PGPipeline& pipeline) {
+        const auto start = chrono::steady_clock::now();
+        pipeline.run(NUM_ITEMS);
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    };
+
+    // every step of a mesh inside one task, one task per core
+    PGPipeline serialPerTask({ { .name = "all",
+        .numThreads = numCPUThreads,
+        .func = [&](size_t item) { return read(item) && patch(item) && write(item); } } });
+    const auto serialTime = time(serialPerTask);
+
+    PGPipeline staged({ { .name = "read", .numThreads = numCPUThreads * 4, .func = read },
+        { .name = "patch", .numThreads = numCPUThreads, .queueCapacity = numCPUThreads * 2, .func = patch },
+        { .name = "write", .numThreads = numCPUThreads * 2, .queueCapacity = numCPUThreads * 2, .func = write } });
+    const auto stagedTime = time(staged);
+
+    // share of the patch threads' time spent patching
+    const auto patchSeconds = chrono::duration<double>(PATCH_WORK).count() * NUM_ITEMS;
+    const auto utilization = [&](const double& seconds) {
+        return 100.0 * patchSeconds / (seconds * static_cast<double>(numCPUThreads));
+    };
+
+    cout << numCPUThreads << " CPU threads: one task per mesh " << serialTime << " s (" << utilization(serialTime)
+         << "% busy), pipeline " << stagedTime << " s (" << utilization(stagedTime) << "% busy)\n";
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
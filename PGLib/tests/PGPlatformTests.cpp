@@ -0,0 +1,74 @@
+#include "PGPlatform.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+
+using namespace std;
+
+TEST(PGPlatformTest, GlobMatch)
+{
+    EXPECT_TRUE(PGPlatform::globMatch(L"textures\\texture0.dds", L"textures\\texture*.dds"));
+    EXPECT_TRUE(PGPlatform::globMatch(L"TEXTURES\\Texture0.DDS", L"textures\\texture*.dds"));
+    EXPECT_FALSE(PGPlatform::globMatch(L"textures\\texture0.png", L"textures\\texture*.dds"));
+
+    // stars cross separators
+    EXPECT_TRUE(PGPlatform::globMatch(L"meshes\\a\\b\\cameras\\c.nif", L"*\\cameras\\*"));
+    EXPECT_FALSE(PGPlatform::globMatch(L"cameras\\c.nif", L"*\\cameras\\*"));
+
+    EXPECT_TRUE(PGPlatform::globMatch(L"mesh1.nif", L"mesh?.nif"));
+    EXPECT_FALSE(PGPlatform::globMatch(L"mesh10.nif", L"mesh?.nif"));
+    EXPECT_TRUE(PGPlatform::globMatch(L"abcabcabd", L"*abd"));
+    EXPECT_TRUE(PGPlatform::globMatch(L"anything", L"*"));
+    EXPECT_TRUE(PGPlatform::globMatch(L"nodot", L"*.*"));
+}
+
+TEST(PGPlatformTest, MappedFile)
+{
+    const auto tempDir = filesystem::temp_directory_path() / "PGPlatformTest";
+    filesystem::create_directories(tempDir);
+
+    const string content = "mapped file content";
+    {
+        ofstream file(tempDir / "data.bin", ios::binary);
+        file << content;
+    }
+    {
+        const ofstream file(tempDir / "empty.bin", ios::binary);
+    }
+
+    {
+        PGPlatform::MappedFile mapped(tempDir / "data.bin");
+        ASSERT_TRUE(mapped.isOpen());
+        const auto data = mapped.getData();
+        ASSERT_EQ(data.size(), content.size());
+        EXPECT_EQ(string(reinterpret_cast<const char*>(data.data()), data.size()), // NOLINT
+            content);
+
+        // ownership moves with the object
+        const PGPlatform::MappedFile moved(std::move(mapped));
+        EXPECT_FALSE(mapped.isOpen()); // NOLINT(bugprone-use-after-move,clang-analyzer-cplusplus.Move)
+        EXPECT_EQ(moved.getData().size(), content.size());
+    }
+
+    const PGPlatform::MappedFile empty(tempDir / "empty.bin");
+    EXPECT_TRUE(empty.isOpen());
+    EXPECT_TRUE(empty.getData().empty());
+
+    EXPECT_FALSE(PGPlatform::MappedFile(tempDir / "missing.bin").isOpen());
+
+    filesystem::remove_all(tempDir);
+}
+
+TEST(PGPlatformTest, SystemInfo)
+{
+    EXPECT_GT(PGPlatform::getTotalPhysicalMemory(), 0);
+    EXPECT_TRUE(filesystem::exists(PGPlatform::getExecutablePath()));
+
+    // releasing a null native string is a no-op
+    PGPlatform::freeNativeString(nullptr);
+}
@@ -0,0 +1,153 @@
+#include "CommonTests.hpp"
+#include "PGPluginIndex.hpp"
+
+#include <gtest/gtest.h>
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace std;
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,misc-non-private-member-variables-in-classes,cppcoreguidelines-non-private-member-variables-in-classes)
+class PGPluginIndexTest : public PGTesting::TempDirTest {
+protected:
+    void SetUp() override
+    {
+        PGTesting::TempDirTest::SetUp();
+        filesystem::create_directories(m_tempDir / "Data");
+
+        for (const auto& plugin : m_plugins) {
+            writePlugin(plugin, "TES4 header of " + filesystem::path(plugin).string());
+        }
+    }
+
+    /// @brief Stand-in plugin file, only its size and modification time matter
+    void writePlugin(const wstring& plugin, const string& contents) const
+    {
+        ofstream f(m_tempDir / "Data" / plugin, ios::binary);
+        f << contents;
+    }
+
+    [[nodiscard]] auto getFingerprint() const -> nlohmann::json
+    {
+        return PGPluginIndex::getFingerprint(m_tempDir / "Data", m_plugins);
+    }
+
+    static auto makeIndex() -> PGPluginIndex
+    {
+        PGPluginIndex index;
+        index.add(L"meshes\\clutter\\bucket.nif", 0, { .txstHandle = 4, .altTexHandle = 0, .type = "MODL" });
+        index.add(L"meshes\\clutter\\bucket.nif", 0, { .txstHandle = 7, .altTexHandle = 1, .type = "MODL" });
+        index.add(L"meshes\\clutter\\bucket.nif", 2, { .txstHandle = 5, .altTexHandle = 2, .type = "MODL" });
+        index.add(L"meshes\\armor\\cuirass_0.nif", 1, { .txstHandle = 9, .altTexHandle = 3, .type = "MALE" });
+        index.add(L"meshes\\armor\\boots_1.nif", 1, { .txstHandle = 9, .altTexHandle = 4, .type = "MODL" });
+        return index;
+    }
+
+    vector<wstring> m_plugins = { L"Skyrim.esm", L"Update.esm", L"Generated.esp" };
+};
+
+TEST_F(PGPluginIndexTest, Matches)
+{
+    const auto index = makeIndex();
+    EXPECT_EQ(index.size(), 5);
+
+    using Matches = vector<tuple<int, int, wstring, string>>;
+    EXPECT_EQ(index.getMatches(L"Meshes\\Clutter\\Bucket.nif", 0),
+        (Matches { { 4, 0, L"meshes\\clutter\\bucket.nif", "MODL" },
+            { 7, 1, L"meshes\\clutter\\bucket.nif", "MODL" } }));
+    EXPECT_TRUE(index.getMatches(L"meshes\\clutter\\bucket.nif", 1).empty());
+
+    // the paired weight NIF matches, except for MODL elements
+    EXPECT_EQ(index.getMatches(L"meshes\\armor\\cuirass_1.nif", 1),
+        (Matches { { 9, 3, L"meshes\\armor\\cuirass_0.nif", "MALE" } }));
+    EXPECT_TRUE(index.getMatches(L"meshes\\armor\\boots_0.nif", 1).empty());
+}
+
+TEST_F(PGPluginIndexTest, NonASCIIPaths)
+{
+    // PGMutagen lowercases A-Z only, the same as getMatches, so non-ASCII letters keep their case on both sides
+    PGPluginIndex index;
+    index.add(L"meshes\\r\u00fcstung\\\u00c4rmel_0.nif", 0, { .txstHandle = 1, .altTexHandle = 0, .type = "MALE" });
+    index.add(L"meshes\\\u0441\u0442\u043e\u043b.nif", 2, { .txstHandle = 2, .altTexHandle = 1, .type = "MODL" });
+
+    using Matches = vector<tuple<int, int, wstring, string>>;
+    EXPECT_EQ(index.getMatches(L"Meshes\\R\u00fcstung\\\u00c4rmel_0.NIF", 0),
+        (Matches { { 1, 0, L"meshes\\r\u00fcstung\\\u00c4rmel_0.nif", "MALE" } }));
+    EXPECT_EQ(index.getMatches(L"MESHES\\R\u00fcSTUNG\\\u00c4RMEL_1.NIF", 0),
+        (Matches { { 1, 0, L"meshes\\r\u00fcstung\\\u00c4rmel_0.nif", "MALE" } }));
+    EXPECT_EQ(index.getMatches(L"meshes\\\u0441\u0442\u043e\u043b.nif", 2),
+        (Matches { { 2, 1, L"meshes\\\u0441\u0442\u043e\u043b.nif", "MODL" } }));
+
+    // no Unicode folding, a differently cased non-ASCII letter is a different path
+    EXPECT_TRUE(index.getMatches(L"meshes\\r\u00fcstung\\\u00e4rmel_0.nif", 0).empty());
+    EXPECT_TRUE(index.getMatches(L"meshes\\\u0421\u0442\u043e\u043b.nif", 2).empty());
+}
+
+TEST_F(PGPluginIndexTest, RoundTrip)
+{
+    const auto indexFile = m_tempDir / "cache" / "pluginIndex.json";
+    const auto index = makeIndex();
+    ASSERT_TRUE(index.save(indexFile, getFingerprint()));
+
+    PGPluginIndex loaded;
+    ASSERT_TRUE(loaded.load(indexFile, getFingerprint()));
+    EXPECT_EQ(loaded.size(), index.size());
+    for (const auto& [nifName, index3D] : vector<pair<wstring, int>> { { L"meshes\\clutter\\bucket.nif", 0 },
+             { L"meshes\\clutter\\bucket.nif", 2 }, { L"meshes\\armor\\cuirass_1.nif", 1 } }) {
+        EXPECT_EQ(loaded.getMatches(nifName, index3D), index.getMatches(nifName, index3D));
+    }
+}
+
+TEST_F(PGPluginIndexTest, Invalidation)
+{
+    const auto indexFile = m_tempDir / "cache" / "pluginIndex.json";
+    ASSERT_TRUE(makeIndex().save(indexFile, getFingerprint()));
+
+    PGPluginIndex loaded;
+    EXPECT_TRUE(loaded.load(indexFile, getFingerprint()));
+
+    // plugin list order
+    {
+        auto reordered = m_plugins;
+        swap(reordered[1], reordered[2]);
+        EXPECT_FALSE(loaded.load(indexFile, PGPluginIndex::getFingerprint(m_tempDir / "Data", reordered)));
+        EXPECT_EQ(loaded.size(), 0);
+    }
+
+    // plugin added to the load order
+    {
+        auto added = m_plugins;
+        added.emplace_back(L"New.esp");
+        EXPECT_FALSE(loaded.load(indexFile, PGPluginIndex::getFingerprint(m_tempDir / "Data", added)));
+    }
+
+    // same size, different timestamp
+    const auto pluginPath = m_tempDir / "Data" / "Generated.esp";
+    const auto writeTime = filesystem::last_write_time(pluginPath);
+    filesystem::last_write_time(pluginPath, writeTime + chrono::seconds(10));
+    EXPECT_FALSE(loaded.load(indexFile, getFingerprint()));
+    filesystem::last_write_time(pluginPath, writeTime);
+    EXPECT_TRUE(loaded.load(indexFile, getFingerprint()));
+
+    // different size, same timestamp
+    writePlugin(L"Generated.esp", "TES4 header with a new record");
+    filesystem::last_write_time(pluginPath, writeTime);
+    EXPECT_FALSE(loaded.load(indexFile, getFingerprint()));
+
+    // missing and corrupt cache
+    EXPECT_FALSE(loaded.load(m_tempDir / "cache" / "missing.json", getFingerprint()));
+    {
+        ofstream f(indexFile);
+        f << "{ \"fingerprint\": ";
+    }
+    EXPECT_FALSE(loaded.load(indexFile, getFingerprint()));
+    EXPECT_EQ(loaded.size(), 0);
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,misc-non-private-member-variables-in-classes,cppcoreguidelines-non-private-member-variables-in-classes)
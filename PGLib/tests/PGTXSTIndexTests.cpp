@@ -0,0 +1,136 @@
+#include "PGTXSTIndex.hpp"
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+auto makeSlots(const std::wstring& diffuse, const std::wstring& normal) -> NIFUtil::TextureSet
+{
+    NIFUtil::TextureSet slots;
+    slots.at(0) = diffuse;
+    slots.at(1) = normal;
+    return slots;
+}
+} // namespace
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+TEST(PGTXSTIndexTests, Canonicalization)
+{
+    const auto keyA = PGTXSTIndex::SlotKey::fromSlots(makeSlots(L"Textures\\Foo\\Bar.dds", L"textures/foo/bar_n.dds"));
+    const auto keyB = PGTXSTIndex::SlotKey::fromSlots(makeSlots(L"textures\\foo\\bar.dds", L"TEXTURES\\FOO\\BAR_N.DDS"));
+    EXPECT_EQ(keyA.hash, keyB.hash);
+    EXPECT_EQ(keyA, keyB);
+    EXPECT_EQ(keyA.slots.at(0), L"textures\\foo\\bar.dds");
+
+    // moving a character between slots must change the key
+    const auto keyC = PGTXSTIndex::SlotKey::fromSlots(makeSlots(L"ab", L"c"));
+    const auto keyD = PGTXSTIndex::SlotKey::fromSlots(makeSlots(L"a", L"bc"));
+    EXPECT_NE(keyC.hash, keyD.hash);
+
+    // hash is fixed across runs and builds
+    EXPECT_EQ(PGTXSTIndex::SlotKey::hashSlots({}), 0xa0d1179657899fc6ULL);
+    EXPECT_EQ(PGTXSTIndex::SlotKey::fromSlots(makeSlots(L"textures\\a.dds", L"")).hash, 0xa752cd6a50ce9b9aULL);
+    EXPECT_EQ(keyA.hash, PGTXSTIndex::SlotKey::hashSlots(keyB.slots));
+}
+
+TEST(PGTXSTIndexTests, CollisionHandling)
+{
+    PGTXSTIndex index;
+
+    // two different slot tuples forced onto the same hash
+    PGTXSTIndex::SlotKey keyA;
+    keyA.slots = makeSlots(L"textures\\a.dds", L"");
+    keyA.hash = 42;
+    PGTXSTIndex::SlotKey keyB;
+    keyB.slots = makeSlots(L"textures\\b.dds", L"");
+    keyB.hash = 42;
+
+    const auto [entryA, createdA] = index.getOrCreate(keyA, [] { return PGTXSTIndex::Entry { 1, "A" }; });
+    const auto [entryB, createdB] = index.getOrCreate(keyB, [] { return PGTXSTIndex::Entry { 2, "B" }; });
+    EXPECT_TRUE(createdA);
+    EXPECT_TRUE(createdB);
+    EXPECT_EQ(entryA.txstIndex, 1);
+    EXPECT_EQ(entryB.txstIndex, 2);
+    EXPECT_EQ(index.size(), 2);
+
+    const auto [entryA2, createdA2] = index.getOrCreate(keyA, [] { return PGTXSTIndex::Entry { 3, "C" }; });
+    EXPECT_FALSE(createdA2);
+    EXPECT_EQ(entryA2.edid, "A");
+
+    PGTXSTIndex::Entry found;
+    EXPECT_TRUE(index.find(keyB, found));
+    EXPECT_EQ(found.edid, "B");
+}
+
+TEST(PGTXSTIndexTests, ConcurrentInsertCreatesOnce)
+{
+    PGTXSTIndex index;
+    std::atomic<int> numCreated = 0;
+
+    std::vector<std::thread> threads;
+    threads.reserve(8);
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&index, &numCreated] {
+            for (int i = 0; i < 100; ++i) {
+                const auto key = PGTXSTIndex::SlotKey::fromSlots(
+                    makeSlots(L"textures\\" + std::to_wstring(i) + L".dds", L"textures\\n.dds"));
+                index.getOrCreate(key, [&numCreated, i] {
+                    numCreated.fetch_add(1);
+                    return PGTXSTIndex::Entry { i, std::to_string(i) };
+                });
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(numCreated.load(), 100);
+    EXPECT_EQ(index.size(), 100);
+}
+
+TEST(PGTXSTIndexTests, FormIDsStableAcrossRuns)
+{
+    nlohmann::json cache;
+
+    // first run
+    {
+        PGTXSTIndex index;
+        index.loadFormIDCache(nlohmann::json::object());
+        EXPECT_EQ(index.allocateFormID("Skyrim.esm/1/MODL/0"), 1);
+        EXPECT_EQ(index.allocateFormID("Skyrim.esm/2/MODL/0"), 2);
+        EXPECT_EQ(index.allocateFormID("Skyrim.esm/3/MODL/1"), 3);
+        EXPECT_EQ(PGTXSTIndex::getEDID(3), "PGTXST000003");
+        cache = index.getFormIDCache();
+    }
+
+    // second run, different processing order and one record no longer needed
+    {
+        PGTXSTIndex index;
+        index.loadFormIDCache(cache);
+        EXPECT_EQ(index.allocateFormID("Skyrim.esm/3/MODL/1"), 3);
+        EXPECT_EQ(index.allocateFormID("Skyrim.esm/1/MODL/0"), 1);
+
+        // new keys must not take form IDs reserved by the cache
+        EXPECT_EQ(index.allocateFormID("Skyrim.esm/4/MODL/0"), 4);
+
+        const auto newCache = index.getFormIDCache();
+        EXPECT_EQ(newCache.size(), 3);
+        EXPECT_FALSE(newCache.contains("Skyrim.esm/2/MODL/0"));
+    }
+
+    // a cached form ID already taken in this run falls back to a fresh one
+    {
+        PGTXSTIndex index;
+        index.loadFormIDCache(nlohmann::json { { "a", 1 }, { "b", 1 } });
+        EXPECT_EQ(index.allocateFormID("a"), 1);
+        EXPECT_EQ(index.allocateFormID("b"), 2);
+    }
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
@@ -0,0 +1,226 @@
+#include "PGTextureBatchBackendCPU.hpp"
+#include "PGTextureBatcher.hpp"
+
+#include <gtest/gtest.h>
+
+#include <DirectXTex.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-pro-bounds-pointer-arithmetic)
+namespace {
+// any unique address works as a shader handle for the CPU backend, elements of one mutable array never fold together
+array<char, 3> s_shaders {};
+const PGTextureBatcher::ShaderHandle s_invertShader = &s_shaders[0];
+const PGTextureBatcher::ShaderHandle s_throwShader = &s_shaders[1];
+const PGTextureBatcher::ShaderHandle s_unknownShader = &s_shaders[2];
+
+auto makeImage(const size_t& size, const size_t& mips, const uint8_t& value) -> DirectX::ScratchImage
+{
+    DirectX::ScratchImage image;
+    EXPECT_TRUE(SUCCEEDED(image.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM, size, size, 1, mips)));
+    memset(image.GetPixels(), value, image.GetPixelsSize());
+    return image;
+}
+
+auto invertKernel(const DirectX::ScratchImage& input, DirectX::ScratchImage& output, span<const byte> /*params*/)
+    -> bool
+{
+    const auto* in = input.GetImage(0, 0, 0);
+    const auto* out = output.GetImage(0, 0, 0);
+    for (size_t i = 0; i < in->slicePitch; ++i) {
+        out->pixels[i] = static_cast<uint8_t>(255 - in->pixels[i]);
+    }
+    return true;
+}
+} // namespace
+
+class PGTextureBatcherTests : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        m_backend.registerKernel(s_invertShader, invertKernel);
+        m_backend.registerKernel(s_throwShader,
+            [](const DirectX::ScratchImage&, DirectX::ScratchImage&, span<const byte>) -> bool {
+                throw runtime_error("kernel failed");
+            });
+    }
+
+    PGTextureBatchBackendCPU m_backend; // NOLINT(misc-non-private-member-variables-in-classes)
+};
+
+TEST_F(PGTextureBatcherTests, RunsShaderAndKeepsMipCount)
+{
+    PGTextureBatcher batcher(&m_backend);
+
+    const auto input = makeImage(16, 5, 10);
+    DirectX::ScratchImage output;
+    ASSERT_TRUE(batcher.process(input, output, s_invertShader, DXGI_FORMAT_R8G8B8A8_UNORM));
+
+    EXPECT_EQ(output.GetMetadata().mipLevels, 5);
+    EXPECT_EQ(output.GetMetadata().width, 16);
+    EXPECT_EQ(output.GetImage(0, 0, 0)->pixels[0], 245);
+    EXPECT_EQ(output.GetImage(4, 0, 0)->pixels[0], 245);
+}
+
+TEST_F(PGTextureBatcherTests, ReusesPooledSlots)
+{
+    PGTextureBatcher batcher(&m_backend);
+
+    for (uint8_t i = 0; i < 5; ++i) {
+        const auto input = makeImage(8, 1, i);
+        DirectX::ScratchImage output;
+        ASSERT_TRUE(batcher.process(input, output, s_invertShader, DXGI_FORMAT_R8G8B8A8_UNORM));
+        EXPECT_EQ(output.GetImage(0, 0, 0)->pixels[0], 255 - i);
+    }
+
+    EXPECT_EQ(batcher.getNumBatches(), 5);
+    EXPECT_EQ(batcher.getNumSlotsCreated(), 1);
+
+    // a new size needs its own slot
+    const auto input = makeImage(4, 1, 0);
+    DirectX::ScratchImage output;
+    ASSERT_TRUE(batcher.process(input, output, s_invertShader, DXGI_FORMAT_R8G8B8A8_UNORM));
+    EXPECT_EQ(batcher.getNumSlotsCreated(), 2);
+}
+
+TEST_F(PGTextureBatcherTests, BatchesConcurrentCallers)
+{
+    static constexpr size_t NUM_THREADS = 8;
+
+    atomic<bool> release = false;
+    atomic<size_t> numSubmitted = 0;
+    m_backend.registerKernel(s_invertShader,
+        [&release](const DirectX::ScratchImage& input, DirectX::ScratchImage& output, span<const byte> params) {
+            // hold the first batch until everyone queued
+            while (!release.load()) {
+                this_thread::yield();
+            }
+            return invertKernel(input, output, params);
+        });
+
+    PGTextureBatcher batcher(&m_backend);
+
+    vector<DirectX::ScratchImage> inputs;
+    vector<DirectX::ScratchImage> outputs(NUM_THREADS);
+    for (size_t i = 0; i < NUM_THREADS; ++i) {
+        inputs.push_back(makeImage(8, 1, static_cast<uint8_t>(i)));
+    }
+
+    vector<thread> threads;
+    vector<int> results(NUM_THREADS, 0);
+    for (size_t i = 0; i < NUM_THREADS; ++i) {
+        threads.emplace_back([&, i] {
+            numSubmitted++;
+            results[i]
+                = batcher.process(inputs[i], outputs[i], s_invertShader, DXGI_FORMAT_R8G8B8A8_UNORM) ? 1 : 0;
+        });
+    }
+
+    while (numSubmitted.load() < NUM_THREADS) {
+        this_thread::yield();
+    }
+    this_thread::sleep_for(chrono::milliseconds(50));
+    release = true;
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    for (size_t i = 0; i < NUM_THREADS; ++i) {
+        EXPECT_EQ(results[i], 1);
+        EXPECT_EQ(outputs[i].GetImage(0, 0, 0)->pixels[0], 255 - i);
+    }
+
+    // the first caller runs alone, everyone who queued meanwhile shares the next batch
+    EXPECT_LT(batcher.getNumBatches(), NUM_THREADS);
+}
+
+TEST_F(PGTextureBatcherTests, Failures)
+{
+    PGTextureBatcher batcher(&m_backend);
+
+    const auto input = makeImage(8, 1, 0);
+    DirectX::ScratchImage output;
+
+    // no kernel means no slot
+    EXPECT_FALSE(batcher.process(input, output, s_unknownShader, DXGI_FORMAT_R8G8B8A8_UNORM));
+
+    // exceptions reach the caller and do not wedge the batcher
+    EXPECT_THROW(
+        (void)batcher.process(input, output, s_throwShader, DXGI_FORMAT_R8G8B8A8_UNORM), runtime_error);
+    EXPECT_TRUE(batcher.process(input, output, s_invertShader, DXGI_FORMAT_R8G8B8A8_UNORM));
+}
+
+TEST_F(PGTextureBatcherTests, ExceptionOnlyFailsItsJob)
+{
+    static constexpr size_t NUM_THREADS = 6;
+    static constexpr uint8_t THROW_VALUE = 3;
+
+    atomic<bool> release = false;
+    atomic<size_t> numSubmitted = 0;
+    m_backend.registerKernel(s_invertShader,
+        [&release](const DirectX::ScratchImage& input, DirectX::ScratchImage& output, span<const byte> params) {
+            while (!release.load()) {
+                this_thread::yield();
+            }
+            if (input.GetImage(0, 0, 0)->pixels[0] == THROW_VALUE) {
+                throw runtime_error("kernel failed");
+            }
+            return invertKernel(input, output, params);
+        });
+
+    PGTextureBatcher batcher(&m_backend);
+
+    vector<DirectX::ScratchImage> inputs;
+    vector<DirectX::ScratchImage> outputs(NUM_THREADS);
+    for (size_t i = 0; i < NUM_THREADS; ++i) {
+        inputs.push_back(makeImage(8, 1, static_cast<uint8_t>(i)));
+    }
+
+    // same key, so the jobs that queue while the first one runs share a group with the throwing one
+    vector<thread> threads;
+    vector<int> results(NUM_THREADS, 0);
+    for (size_t i = 0; i < NUM_THREADS; ++i) {
+        threads.emplace_back([&, i] {
+            numSubmitted++;
+            try {
+                results[i]
+                    = batcher.process(inputs[i], outputs[i], s_invertShader, DXGI_FORMAT_R8G8B8A8_UNORM) ? 1 : 0;
+            } catch (const runtime_error&) {
+                results[i] = -1;
+            }
+        });
+    }
+
+    while (numSubmitted.load() < NUM_THREADS) {
+        this_thread::yield();
+    }
+    this_thread::sleep_for(chrono::milliseconds(50));
+    release = true;
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    for (size_t i = 0; i < NUM_THREADS; ++i) {
+        if (i == THROW_VALUE) {
+            EXPECT_EQ(results[i], -1);
+        } else {
+            EXPECT_EQ(results[i], 1) << i;
+            EXPECT_EQ(outputs[i].GetImage(0, 0, 0)->pixels[0], 255 - i);
+        }
+    }
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-pro-bounds-pointer-arithmetic)
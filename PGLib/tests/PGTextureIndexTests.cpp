@@ -0,0 +1,147 @@
+#include "NIFUtil.hpp"
+#include "PGTextureIndex.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+TEST(PGTextureIndexTest, ReverseLookup)
+{
+    PGTextureIndex index;
+    index.setEnabled(true);
+    index.setMeshRefs(L"meshes\\a.nif",
+        { { L"textures\\rock.dds", 0, NIFUtil::TextureSlots::DIFFUSE },
+            { L"textures\\rock_n.dds", 0, NIFUtil::TextureSlots::NORMAL },
+            { L"textures\\rock.dds", 2, NIFUtil::TextureSlots::DIFFUSE } });
+    index.setMeshRefs(L"Meshes/B.nif", { { L"Textures\\Rock.dds", 1, NIFUtil::TextureSlots::DIFFUSE } });
+
+    // nothing is visible before merging
+    EXPECT_EQ(index.getNumTextures(), 0);
+    index.merge();
+
+    const auto users = index.getUsers(L"textures/rock.dds");
+    ASSERT_EQ(users.size(), 3);
+    EXPECT_EQ(users[0], (PGTextureIndex::TextureRef { L"meshes\\a.nif", 0, NIFUtil::TextureSlots::DIFFUSE }));
+    EXPECT_EQ(users[1], (PGTextureIndex::TextureRef { L"meshes\\a.nif", 2, NIFUtil::TextureSlots::DIFFUSE }));
+    EXPECT_EQ(users[2], (PGTextureIndex::TextureRef { L"meshes\\b.nif", 1, NIFUtil::TextureSlots::DIFFUSE }));
+
+    // prefix may be omitted
+    EXPECT_EQ(index.getUsers(L"rock_n.dds").size(), 1);
+    EXPECT_TRUE(index.getUsers(L"missing.dds").empty());
+
+    // remapping a mesh replaces its references
+    index.setMeshRefs(L"meshes\\a.nif", { { L"textures\\wood.dds", 0, NIFUtil::TextureSlots::DIFFUSE } });
+    index.merge();
+    EXPECT_EQ(index.getUsers(L"textures\\rock.dds").size(), 1);
+    EXPECT_TRUE(index.getUsers(L"textures\\rock_n.dds").empty());
+    EXPECT_EQ(index.getNumTextures(), 2);
+}
+
+TEST(PGTextureIndexTest, ModImpactAndSaveLoad)
+{
+    PGTextureIndex index;
+    index.setEnabled(true);
+    index.setMeshRefs(L"meshes\\a.nif", { { L"textures\\rock.dds", 0, NIFUtil::TextureSlots::DIFFUSE } });
+    index.setMeshRefs(L"meshes\\b.nif", { { L"textures\\wood.dds", 0, NIFUtil::TextureSlots::DIFFUSE } });
+
+    PGTextureIndex::ShapeResult result;
+    result.winner = { .shader = NIFUtil::ShapeShader::COMPLEXMATERIAL,
+        .mod = L"CM Mod",
+        .matchedPath = L"textures\\rock_m.dds" };
+    result.candidates = { { .shader = NIFUtil::ShapeShader::VANILLAPARALLAX,
+                              .mod = L"Parallax Mod",
+                              .matchedPath = L"textures\\rock_p.dds" },
+        result.winner };
+    index.setShapeResult(L"meshes\\a.nif", 0, result);
+
+    index.resolveMods([](const wstring& path) -> wstring {
+        if (path == L"textures\\rock.dds" || path == L"meshes\\b.nif") {
+            return L"Rock Mod";
+        }
+        return {};
+    });
+
+    const auto impact = index.getModImpact(L"Rock Mod");
+    EXPECT_EQ(impact.textures, vector<wstring> { L"textures\\rock.dds" });
+    EXPECT_EQ(impact.meshes, (vector<wstring> { L"meshes\\a.nif", L"meshes\\b.nif" }));
+    EXPECT_TRUE(impact.wonShapes.empty());
+
+    EXPECT_EQ(index.getModImpact(L"CM Mod").wonShapes.size(), 1);
+
+    // round trip through a file
+    const auto indexFile = filesystem::temp_directory_path() / "PGTextureIndexTest.json";
+    index.save(indexFile);
+
+    PGTextureIndex loaded;
+    loaded.load(indexFile);
+    filesystem::remove(indexFile);
+
+    EXPECT_EQ(loaded.getUsers(L"textures\\rock.dds"), index.getUsers(L"textures\\rock.dds"));
+    EXPECT_EQ(loaded.getModImpact(L"Rock Mod").meshes, impact.meshes);
+
+    const auto loadedResult = loaded.getShapeResult(L"meshes\\a.nif", 0);
+    ASSERT_TRUE(loadedResult.has_value());
+    EXPECT_EQ(loadedResult->winner.shader, NIFUtil::ShapeShader::COMPLEXMATERIAL);
+    EXPECT_EQ(loadedResult->winner.mod, L"CM Mod");
+    ASSERT_EQ(loadedResult->candidates.size(), 2);
+    EXPECT_EQ(loadedResult->candidates[0].matchedPath, L"textures\\rock_p.dds");
+    EXPECT_FALSE(loaded.getShapeResult(L"meshes\\a.nif", 1).has_value());
+
+    auto json = index.toJSON();
+    json["version"] = PGTextureIndex::INDEX_VERSION + 1;
+    EXPECT_THROW(loaded.loadJSON(json), runtime_error);
+}
+
+TEST(PGTextureIndexTest, ThreadsMergeDeterministically)
+{
+    static constexpr int NUM_THREADS = 4;
+    static constexpr int NUM_MESHES = 500;
+
+    const auto build = [](const int& numThreads) {
+        PGTextureIndex index;
+        index.setEnabled(true);
+
+        vector<thread> threads;
+        for (int t = 0; t < numThreads; ++t) {
+            threads.emplace_back([&index, t, numThreads] {
+                for (int i = t; i < NUM_MESHES; i += numThreads) {
+                    const auto mesh = L"meshes\\m" + to_wstring(i) + L".nif";
+                    index.setMeshRefs(mesh,
+                        { { L"textures\\t" + to_wstring(i % 7) + L".dds", 0, NIFUtil::TextureSlots::DIFFUSE } });
+                    index.setShapeResult(mesh, 0, { .winner = { .shader = NIFUtil::ShapeShader::VANILLAPARALLAX } });
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        index.merge();
+        return index.toJSON();
+    };
+
+    const auto serial = build(1);
+    EXPECT_EQ(build(NUM_THREADS), serial);
+    EXPECT_EQ(serial["refs"].size(), NUM_MESHES);
+    EXPECT_EQ(serial["shapes"].size(), NUM_MESHES);
+}
+
+TEST(PGTextureIndexTest, DisabledRecordsNothing)
+{
+    PGTextureIndex index;
+    EXPECT_FALSE(index.isEnabled());
+
+    index.setMeshRefs(L"meshes\\a.nif", { { L"textures\\rock.dds", 0, NIFUtil::TextureSlots::DIFFUSE } });
+    index.setShapeResult(L"meshes\\a.nif", 0, {});
+    index.merge();
+
+    EXPECT_EQ(index.getNumTextures(), 0);
+    EXPECT_EQ(index.getNumShapeResults(), 0);
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
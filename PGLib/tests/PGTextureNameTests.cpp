@@ -0,0 +1,221 @@
+#include "NIFUtil.hpp"
+#include "PGTextureName.hpp"
+
+#include <gtest/gtest.h>
+
+#include <boost/algorithm/string/predicate.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace std;
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+namespace {
+/// @brief suffix search as it was before the trie, first match in map order
+auto referenceMatch(const filesystem::path& path) -> tuple<wstring, NIFUtil::TextureSlots, NIFUtil::TextureType>
+{
+    const auto pathWithoutExtension = path.parent_path() / path.stem();
+    const auto& pathStr = pathWithoutExtension.wstring();
+
+    for (const auto& [suffix, slot] : NIFUtil::getTexSuffixMap()) {
+        if (boost::iends_with(pathStr, suffix)) {
+            if (get<1>(slot) == NIFUtil::TextureType::HEIGHT && boost::istarts_with(pathStr, L"textures\\pbr")) {
+                return { pathStr.substr(0, pathStr.size() - suffix.size()), NIFUtil::TextureSlots::PARALLAX,
+                    NIFUtil::TextureType::HEIGHTPBR };
+            }
+
+            return { pathStr.substr(0, pathStr.size() - suffix.size()), get<0>(slot), get<1>(slot) };
+        }
+    }
+
+    return { pathStr, NIFUtil::TextureSlots::UNKNOWN, NIFUtil::TextureType::UNKNOWN };
+}
+
+void expectSameAsReference(const wstring& path)
+{
+    const auto [base, slot, type] = referenceMatch(path);
+    EXPECT_EQ(NIFUtil::getTexBase(path), base) << path;
+    EXPECT_EQ(NIFUtil::getDefaultsFromSuffix(path), make_tuple(slot, type)) << path;
+}
+
+/// @brief every upper and lower case spelling of str
+auto getCaseVariants(const wstring& str) -> vector<wstring>
+{
+    vector<wstring> variants;
+    for (size_t mask = 0; mask < (size_t { 1 } << str.size()); ++mask) {
+        auto variant = str;
+        for (size_t i = 0; i < str.size(); ++i) {
+            if ((mask & (size_t { 1 } << i)) != 0) {
+                variant[i] = static_cast<wchar_t>(towupper(variant[i]));
+            }
+        }
+        variants.push_back(variant);
+    }
+    return variants;
+}
+} // namespace
+
+TEST(PGTextureNameTest, Parse)
+{
+    auto result = PGTextureName::parse(L"textures\\architecture\\wall_n");
+    EXPECT_EQ(result.base, L"textures\\architecture\\wall");
+    EXPECT_EQ(result.slot, NIFUtil::TextureSlots::NORMAL);
+    EXPECT_EQ(result.type, NIFUtil::TextureType::NORMAL);
+
+    // longest suffix wins
+    result = PGTextureName::parse(L"textures\\wall_envmask");
+    EXPECT_EQ(result.base, L"textures\\wall");
+    EXPECT_EQ(result.type, NIFUtil::TextureType::ENVIRONMENTMASK);
+    result = PGTextureName::parse(L"textures\\wallmask");
+    EXPECT_EQ(result.base, L"textures\\wall");
+    EXPECT_EQ(result.type, NIFUtil::TextureType::DIFFUSE);
+
+    result = PGTextureName::parse(L"textures\\wall");
+    EXPECT_EQ(result.base, L"textures\\wall");
+    EXPECT_EQ(result.slot, NIFUtil::TextureSlots::UNKNOWN);
+    EXPECT_EQ(result.type, NIFUtil::TextureType::UNKNOWN);
+
+    // the whole string can be the suffix
+    result = PGTextureName::parse(L"_MSN");
+    EXPECT_TRUE(result.base.empty());
+    EXPECT_EQ(result.type, NIFUtil::TextureType::NORMAL);
+    EXPECT_EQ(PGTextureName::parse(L"").type, NIFUtil::TextureType::UNKNOWN);
+
+    // only ASCII letters fold, the Kelvin sign is not a K
+    EXPECT_EQ(PGTextureName::parse(L"wallmas\u212A").type, NIFUtil::TextureType::UNKNOWN);
+
+    EXPECT_EQ(PGTextureName::getMaxSuffixLength(), 8);
+}
+
+TEST(PGTextureNameTest, SuffixMap)
+{
+    const auto& suffixMap = NIFUtil::getTexSuffixMap();
+    ASSERT_EQ(suffixMap.size(), PGTextureName::SUFFIXES.size());
+    for (const auto& suffix : PGTextureName::SUFFIXES) {
+        ASSERT_TRUE(suffixMap.contains(wstring(suffix.suffix)));
+        EXPECT_EQ(suffixMap.at(wstring(suffix.suffix)), make_tuple(suffix.slot, suffix.type));
+    }
+
+    // no copies
+    EXPECT_EQ(&NIFUtil::getTexSuffixMap(), &suffixMap);
+}
+
+TEST(PGTextureNameTest, MatchesReferenceForAllSuffixes)
+{
+    const vector<wstring> prefixes = { L"", L"textures\\", L"textures\\wall", L"textures\\pbr\\wall", L"wall_",
+        L"textures\\wall_n", L"textures\\wallmask", L"textures\\wall1" };
+    const vector<wstring> extensions = { L"", L".dds", L".DDS", L".tar.dds", L"." };
+
+    size_t numChecked = 0;
+    for (const auto& suffix : PGTextureName::SUFFIXES) {
+        for (const auto& variant : getCaseVariants(wstring(suffix.suffix))) {
+            for (const auto& prefix : prefixes) {
+                for (const auto& extension : extensions) {
+                    expectSameAsReference(prefix + variant + extension);
+                    numChecked++;
+                }
+            }
+        }
+    }
+
+    // suffixes of suffixes and suffixes followed by other characters
+    for (const auto& first : PGTextureName::SUFFIXES) {
+        for (const auto& second : PGTextureName::SUFFIXES) {
+            expectSameAsReference(L"textures\\wall" + wstring(first.suffix) + wstring(second.suffix) + L".dds");
+            expectSameAsReference(L"textures\\wall" + wstring(first.suffix) + L"x" + wstring(second.suffix) + L".dds");
+            expectSameAsReference(L"textures\\wall" + wstring(first.suffix) + L"1.dds");
+            numChecked += 3;
+        }
+    }
+
+    EXPECT_GT(numChecked, 10000);
+}
+
+TEST(PGTextureNameTest, MatchesReferenceForNearMisses)
+{
+    // every string up to four characters over the characters the suffixes use
+    const wstring alphabet = L"_abceEfgiklmMnoprsv";
+    vector<wstring> tails = { L"" };
+    for (size_t length = 0; length < 4; ++length) {
+        const auto numTails = tails.size();
+        for (size_t i = 0; i < numTails; ++i) {
+            if (tails[i].size() != length) {
+                continue;
+            }
+            for (const auto& c : alphabet) {
+                tails.push_back(tails[i] + c);
+            }
+        }
+    }
+
+    for (const auto& tail : tails) {
+        expectSameAsReference(L"textures\\wall" + tail + L".dds");
+    }
+}
+
+TEST(PGTextureNameTest, StripExtension)
+{
+    const wstring sep(1, static_cast<wchar_t>(filesystem::path::preferred_separator));
+
+    // written the same as parent_path() / stem(), with or without the fallback
+    const vector<wstring> paths = { L"wall.dds", L"wall", L".dds", L"wall.", L"..wall", L"wall.tar.dds",
+        L"textures" + sep + L"wall_n.dds", sep + L"textures" + sep + L"wall_n.dds", L"textures" + sep + L".dds",
+        L"textures" + sep + L"wall.dir" + sep + L"wall", L"textures/mixed\\separators/wall_n.dds",
+        L"textures" + sep + sep + L"wall_n.dds", L"textures" + sep, L"textures" + sep + L"..", L".", L"..",
+        L"C:wall.dds", L"C:\\textures\\wall.dds", L"" };
+
+    for (const auto& path : paths) {
+        const filesystem::path fsPath(path);
+        const auto expected = (fsPath.parent_path() / fsPath.stem()).wstring();
+
+        const auto stripped = PGTextureName::stripExtension(path);
+        if (stripped.has_value()) {
+            EXPECT_EQ(*stripped, expected) << path;
+        }
+
+        wstring storage;
+        EXPECT_EQ(PGTextureName::stripExtension(path, storage), expected) << path;
+    }
+
+    // plain texture paths never need the fallback
+    EXPECT_TRUE(PGTextureName::stripExtension(L"textures" + sep + L"wall_n.dds").has_value());
+    EXPECT_FALSE(PGTextureName::stripExtension(L"textures" + sep + sep + L"wall_n.dds").has_value());
+}
+
+// run with --gtest_also_run_disabled_tests
+TEST(PGTextureNameTest, DISABLED_Benchmark)
+{
+    static constexpr size_t NUM_PATHS = 1000000;
+    const vector<wstring> tails = { L"_n", L"_p", L"", L"_envmask", L"_d", L"_rmaos", L"_m", L"_msn", L"wallmask" };
+    const wstring sep(1, static_cast<wchar_t>(filesystem::path::preferred_separator));
+
+    vector<filesystem::path> paths;
+    paths.reserve(NUM_PATHS);
+    for (size_t i = 0; i < NUM_PATHS; ++i) {
+        paths.emplace_back(L"textures" + sep + L"architecture" + sep + L"folder" + to_wstring(i % 1000) + sep + L"wall"
+            + to_wstring(i) + tails[i % tails.size()] + L".dds");
+    }
+
+    const auto time = [&paths](const auto& func) {
+        const auto start = chrono::steady_clock::now();
+        size_t numMatched = 0;
+        for (const auto& path : paths) {
+            numMatched += func(path) != NIFUtil::TextureType::UNKNOWN ? 1 : 0;
+        }
+        EXPECT_GT(numMatched, 0);
+        return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+    };
+
+    const auto referenceTime = time([](const filesystem::path& path) { return get<2>(referenceMatch(path)); });
+    const auto trieTime
+        = time([](const filesystem::path& path) { return get<1>(NIFUtil::getDefaultsFromSuffix(path)); });
+
+    cout << "map scan " << referenceTime << " ms, trie " << trieTime << " ms\n";
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
@@ -0,0 +1,78 @@
+#include "PGThreadBuffers.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+TEST(PGThreadBuffersTests, OneBufferPerThread)
+{
+    static constexpr size_t NUM_THREADS = 4;
+    static constexpr int NUM_ADDS = 1000;
+
+    PGThreadBuffers<std::vector<int>> buffers;
+    buffers.local().push_back(-1);
+
+    std::vector<std::thread> threads;
+    threads.reserve(NUM_THREADS);
+    for (size_t i = 0; i < NUM_THREADS; ++i) {
+        threads.emplace_back([&buffers] {
+            for (int j = 0; j < NUM_ADDS; ++j) {
+                buffers.local().push_back(j);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    size_t numBuffers = 0;
+    size_t numValues = 0;
+    buffers.forEach([&](const std::vector<int>& buffer) {
+        numBuffers++;
+        numValues += buffer.size();
+    });
+    EXPECT_EQ(numBuffers, NUM_THREADS + 1);
+    EXPECT_EQ(numValues, (NUM_THREADS * NUM_ADDS) + 1);
+}
+
+TEST(PGThreadBuffersTests, OwnersDoNotShareCache)
+{
+    PGThreadBuffers<std::vector<int>> first;
+    PGThreadBuffers<std::vector<int>> second;
+
+    // alternating owners on one thread must not hand out the other owner's buffer
+    first.local().push_back(1);
+    second.local().push_back(2);
+    first.local().push_back(3);
+
+    EXPECT_EQ(first.local(), (std::vector<int> { 1, 3 }));
+    EXPECT_EQ(second.local(), (std::vector<int> { 2 }));
+
+    // a destroyed owner's cache entry is never matched by a new one
+    auto temporary = std::make_unique<PGThreadBuffers<std::vector<int>>>();
+    temporary->local().push_back(4);
+    temporary.reset();
+    PGThreadBuffers<std::vector<int>> third;
+    EXPECT_TRUE(third.local().empty());
+}
+
+TEST(PGThreadBuffersTests, ResetDropsBuffers)
+{
+    PGThreadBuffers<std::vector<int>> buffers;
+    buffers.local().push_back(1);
+    const auto oldID = buffers.getID();
+
+    buffers.reset();
+    EXPECT_NE(buffers.getID(), oldID);
+
+    size_t numBuffers = 0;
+    buffers.forEach([&numBuffers](const std::vector<int>&) { numBuffers++; });
+    EXPECT_EQ(numBuffers, 0);
+
+    // the cached pointer of this thread is not followed after the reset
+    EXPECT_TRUE(buffers.local().empty());
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
@@ -0,0 +1,101 @@
+#include "PGWarningAggregator.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+// Mod is the first path component, e.g. "modA/textures/a.dds" -> "modA"
+auto modFromPath(const std::wstring& path) -> std::wstring { return path.substr(0, path.find(L'/')); }
+} // namespace
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+TEST(PGWarningAggregatorTests, DeduplicatesAndGroups)
+{
+    PGWarningAggregator aggregator;
+    using Kind = PGWarningAggregator::Kind;
+
+    aggregator.add(Kind::TEXTURE_MISMATCH, L"modB/b.dds", L"modA/a.dds");
+    aggregator.add(Kind::TEXTURE_MISMATCH, L"modB/b.dds", L"modA/a.dds");
+    aggregator.add(Kind::TEXTURE_MISMATCH, L"modB/b.dds", L"modA/c.dds");
+    aggregator.add(Kind::TEXTURE_MISMATCH, L"modA/a.dds", L"modC/c.dds");
+    aggregator.add(Kind::TEXTURE_MISMATCH, L"modA/a.dds", L"modA/b.dds"); // same mod
+    aggregator.add(Kind::TEXTURE_MISMATCH, L"/a.dds", L"modA/b.dds"); // unknown mod
+    aggregator.add(Kind::MESH_MISMATCH, L"modB/b.dds", L"modA/a.nif");
+
+    // duplicate is dropped in the thread buffer
+    EXPECT_EQ(aggregator.size(), 6);
+
+    const auto groups = aggregator.merge(Kind::TEXTURE_MISMATCH, modFromPath, modFromPath);
+    ASSERT_EQ(groups.size(), 2);
+
+    EXPECT_EQ(groups[0].sourceMod, L"modA");
+    EXPECT_EQ(groups[0].targetMod, L"modC");
+    ASSERT_EQ(groups[0].paths.size(), 1);
+
+    EXPECT_EQ(groups[1].sourceMod, L"modB");
+    EXPECT_EQ(groups[1].targetMod, L"modA");
+    ASSERT_EQ(groups[1].paths.size(), 2);
+    EXPECT_EQ(groups[1].paths[0].second, L"modA/a.dds");
+    EXPECT_EQ(groups[1].paths[1].second, L"modA/c.dds");
+
+    const auto meshGroups = aggregator.merge(Kind::MESH_MISMATCH, modFromPath, modFromPath);
+    ASSERT_EQ(meshGroups.size(), 1);
+    EXPECT_EQ(meshGroups[0].paths.size(), 1);
+
+    aggregator.clear();
+    EXPECT_EQ(aggregator.size(), 0);
+    EXPECT_TRUE(aggregator.merge(Kind::TEXTURE_MISMATCH, modFromPath, modFromPath).empty());
+}
+
+TEST(PGWarningAggregatorTests, ResolverCanFilter)
+{
+    PGWarningAggregator aggregator;
+    using Kind = PGWarningAggregator::Kind;
+
+    aggregator.add(Kind::MESH_MISMATCH, L"modA/a.dds", L"modB/b.nif");
+    aggregator.add(Kind::MESH_MISMATCH, L"modA/a.dds", L"modC/c.nif");
+
+    const auto groups = aggregator.merge(Kind::MESH_MISMATCH, modFromPath, [](const std::wstring& path) {
+        auto mod = modFromPath(path);
+        return mod == L"modC" ? std::wstring() : mod;
+    });
+
+    ASSERT_EQ(groups.size(), 1);
+    EXPECT_EQ(groups[0].targetMod, L"modB");
+}
+
+TEST(PGWarningAggregatorTests, ConcurrentAdd)
+{
+    static constexpr int NUM_THREADS = 8;
+    static constexpr int NUM_PATHS = 500;
+
+    PGWarningAggregator aggregator;
+    using Kind = PGWarningAggregator::Kind;
+
+    // every thread adds the same pairs, merge must collapse them
+    std::vector<std::thread> threads;
+    threads.reserve(NUM_THREADS);
+    for (int t = 0; t < NUM_THREADS; ++t) {
+        threads.emplace_back([&aggregator] {
+            for (int i = 0; i < NUM_PATHS; ++i) {
+                const auto index = std::to_wstring(i);
+                aggregator.add(Kind::TEXTURE_MISMATCH, L"modA/" + index + L".dds", L"modB/" + index + L".dds");
+                aggregator.add(Kind::TEXTURE_MISMATCH, L"modA/" + index + L".dds", L"modB/" + index + L".dds");
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(aggregator.size(), NUM_THREADS * NUM_PATHS);
+
+    const auto groups = aggregator.merge(Kind::TEXTURE_MISMATCH, modFromPath, modFromPath);
+    ASSERT_EQ(groups.size(), 1);
+    EXPECT_EQ(groups[0].paths.size(), NUM_PATHS);
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
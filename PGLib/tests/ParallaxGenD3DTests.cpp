@@ -112,16 +112,6 @@ TEST_P(ParallaxGenD3DTest, TextureTests)
                     { "textures\\dungeons\\imperial\\impwall06_m.dds", NIFUtil::TextureType::COMPLEXMATERIAL })
         != mapEntry->second.end());
 
-    // aspect ratio
-    EXPECT_FALSE(m_pgd3d->checkIfAspectRatioMatches(
-        L"textures\\clutter\\common\\rug01.dds", L"textures\\dungeons\\imperial\\impdirt01_m.dds"));
-
-    EXPECT_TRUE(m_pgd3d->checkIfAspectRatioMatches(
-        L"textures\\clutter\\common\\rug01.dds", L"textures\\clutter\\common\\rug01_p.dds"));
-
-    EXPECT_TRUE(m_pgd3d->checkIfAspectRatioMatches(
-        L"textures\\dungeons\\imperial\\impextwall01_m.dds", L"textures\\dungeons\\imperial\\impdirt01_m.dds"));
-
     // upgrade to complex material
     // auto image = m_pgd3d->upgradeToComplexMaterial("", "");
     // EXPECT_TRUE(image.GetImageCount() == 0);
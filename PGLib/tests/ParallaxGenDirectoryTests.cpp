@@ -248,4 +248,18 @@ TEST_P(ParallaxGenDirectoryTest, Meshes)
     EXPECT_TRUE(meshes.find({ L"meshes\\landscape\\roads\\road3way01.nif" }) != meshes.end());
 }
 
+TEST_P(ParallaxGenDirectoryTest, DDSAspectRatio)
+{
+    m_pgd->populateFileMap(false);
+
+    EXPECT_FALSE(m_pgd->checkIfAspectRatioMatches(
+        L"textures\\clutter\\common\\rug01.dds", L"textures\\dungeons\\imperial\\impdirt01_m.dds"));
+
+    EXPECT_TRUE(m_pgd->checkIfAspectRatioMatches(
+        L"textures\\clutter\\common\\rug01.dds", L"textures\\clutter\\common\\rug01_p.dds"));
+
+    EXPECT_TRUE(m_pgd->checkIfAspectRatioMatches(
+        L"textures\\dungeons\\imperial\\impextwall01_m.dds", L"textures\\dungeons\\imperial\\impdirt01_m.dds"));
+}
+
 INSTANTIATE_TEST_SUITE_P(GameParametersSE, ParallaxGenDirectoryTest, ::testing::Values(PGTestEnvs::s_testENVSkyrimSE));
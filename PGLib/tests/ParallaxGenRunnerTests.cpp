@@ -0,0 +1,75 @@
+#include "PGMemoryBudget.hpp"
+#include "ParallaxGenRunner.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+TEST(ParallaxGenRunnerTests, ParallelForVisitsEveryIndexOnce)
+{
+    static constexpr size_t NUM_INDICES = 10000;
+
+    vector<atomic<size_t>> visits(NUM_INDICES);
+    ParallaxGenRunner::parallelFor(NUM_INDICES, [&](size_t index) { visits[index]++; });
+
+    for (size_t i = 0; i < NUM_INDICES; ++i) {
+        EXPECT_EQ(visits[i], 1) << i;
+    }
+
+    EXPECT_THROW(ParallaxGenRunner::parallelFor(
+                     100,
+                     [](size_t index) {
+                         if (index == 42) {
+                             throw runtime_error("index failed");
+                         }
+                     }),
+        runtime_error);
+}
+
+TEST(ParallaxGenRunnerTests, ParallelForHelpersDoNotWaitForTasks)
+{
+    const auto numThreads = thread::hardware_concurrency();
+    if (numThreads < 2) {
+        GTEST_SKIP() << "needs at least two hardware threads";
+    }
+
+    PGMemoryBudget::setBudget(0);
+
+    // one task splits its work, every other worker of the runner is busy until that is done
+    atomic<bool> splitDone = false;
+    mutex threadIDsMutex;
+    set<thread::id> threadIDs;
+
+    ParallaxGenRunner runner;
+    runner.addTask([&] {
+        ParallaxGenRunner::parallelFor(static_cast<size_t>(numThreads) * 4, [&](size_t) {
+            {
+                const lock_guard<mutex> lock(threadIDsMutex);
+                threadIDs.insert(this_thread::get_id());
+            }
+            this_thread::sleep_for(chrono::milliseconds(5));
+        });
+        splitDone = true;
+    });
+    for (unsigned int i = 1; i < numThreads; ++i) {
+        runner.addTask([&splitDone] {
+            while (!splitDone.load()) {
+                this_thread::sleep_for(chrono::milliseconds(1));
+            }
+        });
+    }
+    runner.runTasks();
+
+    EXPECT_GT(threadIDs.size(), 1);
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
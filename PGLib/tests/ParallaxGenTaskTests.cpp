@@ -0,0 +1,178 @@
+#include "ParallaxGenTask.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+namespace {
+/// @brief Records every callback and removes the callback when it goes out of scope
+class CallbackRecorder {
+private:
+    mutex m_mutex;
+    vector<ParallaxGenTask::Progress> m_calls;
+
+public:
+    CallbackRecorder()
+    {
+        ParallaxGenTask::setProgressCallback([this](const ParallaxGenTask::Progress& progress) {
+            const lock_guard<mutex> lock(m_mutex);
+            m_calls.push_back(progress);
+        });
+    }
+
+    ~CallbackRecorder() { ParallaxGenTask::setProgressCallback(nullptr); }
+
+    CallbackRecorder(const CallbackRecorder& other) = delete;
+    auto operator=(const CallbackRecorder& other) -> CallbackRecorder& = delete;
+    CallbackRecorder(CallbackRecorder&& other) = delete;
+    auto operator=(CallbackRecorder&& other) -> CallbackRecorder& = delete;
+
+    auto getCalls() -> vector<ParallaxGenTask::Progress>
+    {
+        const lock_guard<mutex> lock(m_mutex);
+        return m_calls;
+    }
+};
+
+auto getResult(const size_t& job) -> ParallaxGenTask::PGResult
+{
+    // 1 in 7 failed, 2 in 7 with warnings
+    switch (job % 7) {
+    case 0:
+        return ParallaxGenTask::PGResult::FAILURE;
+    case 1:
+    case 2:
+        return ParallaxGenTask::PGResult::SUCCESS_WITH_WARNINGS;
+    default:
+        return ParallaxGenTask::PGResult::SUCCESS;
+    }
+}
+} // namespace
+
+TEST(ParallaxGenTaskTest, ConcurrentCounts)
+{
+    static constexpr size_t NUM_THREADS = 8;
+    static constexpr size_t NUM_JOBS = 200000;
+
+    CallbackRecorder recorder;
+    ParallaxGenTask task("Test Task", NUM_JOBS);
+
+    vector<thread> threads;
+    threads.reserve(NUM_THREADS);
+    for (size_t t = 0; t < NUM_THREADS; ++t) {
+        threads.emplace_back([&task, t] {
+            for (size_t i = t; i < NUM_JOBS; i += NUM_THREADS) {
+                task.completeJob(getResult(i));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_TRUE(task.isCompleted());
+
+    const auto progress = task.getProgress();
+    EXPECT_EQ(progress.completedJobs, NUM_JOBS);
+    EXPECT_EQ(progress.completedByResult[static_cast<size_t>(ParallaxGenTask::PGResult::FAILURE)], 28572);
+    EXPECT_EQ(progress.completedByResult[static_cast<size_t>(ParallaxGenTask::PGResult::SUCCESS_WITH_WARNINGS)], 57144);
+    EXPECT_EQ(progress.completedByResult[static_cast<size_t>(ParallaxGenTask::PGResult::SUCCESS)], 114284);
+
+    // the last call is the one final report, written before the last job returned
+    const auto calls = recorder.getCalls();
+    ASSERT_FALSE(calls.empty());
+    EXPECT_TRUE(calls.back().finished);
+    EXPECT_EQ(calls.back().completedJobs, NUM_JOBS);
+    EXPECT_EQ(calls.back().completedByResult, progress.completedByResult);
+    EXPECT_EQ(calls.back().taskName, "Test Task");
+
+    size_t lastCompleted = 0;
+    for (size_t i = 0; i < calls.size(); ++i) {
+        EXPECT_EQ(calls[i].finished, i + 1 == calls.size());
+        EXPECT_EQ(calls[i].totalJobs, NUM_JOBS);
+        EXPECT_GE(calls[i].completedJobs, lastCompleted);
+        lastCompleted = calls[i].completedJobs;
+
+        // per-result counts are never behind the total
+        size_t sum = 0;
+        for (const auto& count : calls[i].completedByResult) {
+            sum += count;
+        }
+        EXPECT_GE(sum, calls[i].completedJobs);
+    }
+}
+
+TEST(ParallaxGenTaskTest, ObserverReportsWhileRunning)
+{
+    static constexpr size_t NUM_JOBS = 4;
+
+    CallbackRecorder recorder;
+    {
+        ParallaxGenTask task("Slow Task", NUM_JOBS);
+        task.completeJob(ParallaxGenTask::PGResult::SUCCESS);
+        task.completeJob(ParallaxGenTask::PGResult::SUCCESS);
+
+        // a few intervals with no completions, the observer still reports
+        this_thread::sleep_for(ParallaxGenTask::REPORT_INTERVAL * 4);
+        EXPECT_FALSE(task.isCompleted());
+        const auto calls = recorder.getCalls();
+        ASSERT_FALSE(calls.empty());
+        EXPECT_FALSE(calls.back().finished);
+        EXPECT_EQ(calls.back().completedJobs, 2);
+        ASSERT_TRUE(calls.back().eta.has_value());
+        EXPECT_GT(calls.back().jobsPerSecond, 0.0);
+    }
+
+    // never finished, destroyed without a final report
+    for (const auto& call : recorder.getCalls()) {
+        EXPECT_FALSE(call.finished);
+    }
+}
+
+TEST(ParallaxGenTaskTest, NoJobs)
+{
+    CallbackRecorder recorder;
+    {
+        const ParallaxGenTask task("Empty Task", 0);
+    }
+    EXPECT_TRUE(recorder.getCalls().empty());
+}
+
+TEST(ParallaxGenTaskTest, RateWindow)
+{
+    using Clock = ParallaxGenTask::RateWindow::Clock;
+    const auto start = Clock::time_point();
+
+    ParallaxGenTask::RateWindow window(chrono::milliseconds(10000));
+    window.addSample(start, 0);
+    EXPECT_EQ(window.getRate(), 0.0);
+    EXPECT_FALSE(window.getETA(100).has_value());
+
+    // 100 jobs per second for the first 10 seconds
+    for (int i = 1; i <= 10; ++i) {
+        window.addSample(start + chrono::seconds(i), static_cast<size_t>(i) * 100);
+    }
+    EXPECT_DOUBLE_EQ(window.getRate(), 100.0);
+    EXPECT_EQ(window.getETA(1000), chrono::seconds(10));
+
+    // then 10 per second, the window forgets the fast start
+    for (int i = 11; i <= 30; ++i) {
+        window.addSample(start + chrono::seconds(i), 1000 + (static_cast<size_t>(i - 10) * 10));
+    }
+    EXPECT_DOUBLE_EQ(window.getRate(), 10.0);
+    EXPECT_EQ(window.getETA(25), chrono::seconds(3));
+
+    // stalled
+    window.addSample(start + chrono::seconds(45), 1200);
+    window.addSample(start + chrono::seconds(60), 1200);
+    EXPECT_EQ(window.getRate(), 0.0);
+    EXPECT_FALSE(window.getETA(1).has_value());
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
@@ -0,0 +1,157 @@
+#include "CommonTests.hpp"
+#include "NIFUtil.hpp"
+#include "patchers/PatcherMeshPreRules.hpp"
+#include "patchers/PatcherMeshShaderComplexMaterial.hpp"
+#include "patchers/PatcherMeshShaderDefault.hpp"
+#include "patchers/PatcherMeshShaderTruePBR.hpp"
+#include "patchers/PatcherMeshShaderVanillaParallax.hpp"
+#include "patchers/base/PatcherMeshPool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// NOLINTBEGIN(misc-non-private-member-variables-in-classes,cppcoreguidelines-non-private-member-variables-in-classes)
+class PatcherMeshPoolTest : public PGTesting::MappedGameTest {
+protected:
+    void SetUp() override
+    {
+        PGTesting::MappedGameTest::SetUp();
+
+        Patcher::loadStatics(*m_pgd, nullptr); // mesh patchers run without the GPU
+        PatcherMeshShaderComplexMaterial::loadStatics(false, {});
+        PatcherMeshShaderTruePBR::loadStatics(m_pgd->getPBRJSONs());
+
+        PatcherMeshPreRules::loadStatics(nlohmann::json::array({ PatcherMeshPreRules::getBuiltinRule("FixMeshLighting"),
+            PatcherMeshPreRules::getBuiltinRule("FixTextureSlotCount") }));
+
+        m_factories.prePatchers.emplace_back(PatcherMeshPreRules::getFactory());
+        m_factories.shaderPatchers.emplace(
+            PatcherMeshShaderDefault::getShaderType(), PatcherMeshShaderDefault::getFactory());
+        m_factories.shaderPatchers.emplace(
+            PatcherMeshShaderVanillaParallax::getShaderType(), PatcherMeshShaderVanillaParallax::getFactory());
+        m_factories.shaderPatchers.emplace(
+            PatcherMeshShaderComplexMaterial::getShaderType(), PatcherMeshShaderComplexMaterial::getFactory());
+        m_factories.shaderPatchers.emplace(
+            PatcherMeshShaderTruePBR::getShaderType(), PatcherMeshShaderTruePBR::getFactory());
+    }
+
+    /// @brief Objects built straight from the factories, the way every NIF used to get them
+    auto createFresh(const filesystem::path& nifPath, nifly::NifFile* nif) const -> PatcherUtil::PatcherMeshObjectSet
+    {
+        PatcherUtil::PatcherMeshObjectSet objects;
+        for (const auto& factory : m_factories.prePatchers) {
+            objects.prePatchers.emplace_back(factory(nifPath, nif));
+        }
+        for (const auto& [shader, factory] : m_factories.shaderPatchers) {
+            objects.shaderPatchers.emplace(shader, factory(nifPath, nif));
+        }
+        return objects;
+    }
+
+    /// @brief Run pre patchers and the first applicable shader patcher on every shape, return a log of the results
+    static auto patchNIF(nifly::NifFile& nif, PatcherUtil::PatcherMeshObjectSet& objects) -> vector<wstring>
+    {
+        vector<wstring> log;
+        for (auto* const shape : nif.GetShapes()) {
+            for (const auto& prePatcher : objects.prePatchers) {
+                log.push_back(to_wstring(static_cast<int>(prePatcher->applyPatch(*shape))));
+            }
+
+            for (const auto& shader : { NIFUtil::ShapeShader::TRUEPBR, NIFUtil::ShapeShader::COMPLEXMATERIAL,
+                     NIFUtil::ShapeShader::VANILLAPARALLAX, NIFUtil::ShapeShader::NONE }) {
+                auto& patcher = objects.shaderPatchers.at(shader);
+                if (!patcher->canApply(*shape)) {
+                    log.emplace_back(L"-");
+                    continue;
+                }
+
+                vector<PatcherMeshShader::PatcherMatch> matches;
+                if (!patcher->shouldApply(*shape, matches) || matches.empty()) {
+                    log.emplace_back(L"0");
+                    continue;
+                }
+
+                log.push_back(matches[0].matchedPath);
+                NIFUtil::TextureSet newSlots;
+                log.push_back(to_wstring(static_cast<int>(patcher->applyPatch(*shape, matches[0], newSlots))));
+                for (const auto& slot : newSlots) {
+                    log.push_back(slot);
+                }
+                break;
+            }
+        }
+
+        return log;
+    }
+
+    PatcherUtil::PatcherMeshSet m_factories;
+};
+// NOLINTEND(misc-non-private-member-variables-in-classes,cppcoreguidelines-non-private-member-variables-in-classes)
+
+TEST_P(PatcherMeshPoolTest, MatchesFreshConstruction)
+{
+    PatcherMeshPool pool;
+    pool.setFactories(m_factories);
+
+    const auto& meshes = m_pgd->getMeshes();
+    ASSERT_FALSE(meshes.empty());
+
+    // every mesh goes through the same pooled objects, rebound each time
+    for (const auto& meshPath : meshes) {
+        const auto nifBytes = m_pgd->getFile(meshPath);
+
+        auto freshNIF = NIFUtil::loadNIFFromBytes(nifBytes);
+        auto freshObjects = createFresh(meshPath, &freshNIF);
+        const auto freshLog = patchNIF(freshNIF, freshObjects);
+
+        auto pooledNIF = NIFUtil::loadNIFFromBytes(nifBytes);
+        const auto pooledObjects = pool.acquire(meshPath, &pooledNIF);
+        const auto pooledLog = patchNIF(pooledNIF, *pooledObjects);
+
+        EXPECT_EQ(freshLog, pooledLog) << meshPath;
+        EXPECT_EQ(NIFUtil::saveNIFToBytes(freshNIF, {}), NIFUtil::saveNIFToBytes(pooledNIF, {})) << meshPath;
+    }
+}
+
+TEST_P(PatcherMeshPoolTest, ReusesObjects)
+{
+    PatcherMeshPool pool;
+    pool.setFactories(m_factories);
+
+    nifly::NifFile nifA;
+    nifly::NifFile nifB;
+
+    const PatcherMeshShader* firstPatcher = nullptr;
+    {
+        const auto lease = pool.acquire("meshes\\a.nif", &nifA);
+        firstPatcher = lease->shaderPatchers.at(NIFUtil::ShapeShader::NONE).get();
+
+        // nested NIFs on the same thread get their own objects
+        const auto nested = pool.acquire("meshes\\b.nif", &nifB);
+        EXPECT_NE(nested->shaderPatchers.at(NIFUtil::ShapeShader::NONE).get(), firstPatcher);
+    }
+
+    {
+        const auto lease = pool.acquire("meshes\\c.nif", &nifA);
+        // the outer set was released last and is reused first
+        EXPECT_EQ(lease->shaderPatchers.at(NIFUtil::ShapeShader::NONE).get(), firstPatcher);
+        EXPECT_EQ(lease->prePatchers.size(), m_factories.prePatchers.size());
+    }
+
+    // replacing the factories drops sets built from the old ones
+    PatcherUtil::PatcherMeshSet defaultOnly;
+    defaultOnly.shaderPatchers.emplace(
+        PatcherMeshShaderDefault::getShaderType(), PatcherMeshShaderDefault::getFactory());
+    pool.setFactories(defaultOnly);
+
+    const auto lease = pool.acquire("meshes\\a.nif", &nifA);
+    EXPECT_EQ(lease->shaderPatchers.size(), 1);
+    EXPECT_TRUE(lease->prePatchers.empty());
+}
+
+INSTANTIATE_TEST_SUITE_P(GameParametersSE, PatcherMeshPoolTest, ::testing::Values(PGTestEnvs::s_testENVSkyrimSE));
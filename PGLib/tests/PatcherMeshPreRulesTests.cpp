@@ -0,0 +1,211 @@
+#include "CommonTests.hpp"
+#include "NIFUtil.hpp"
+#include "PGDiag.hpp"
+#include "patchers/PatcherMeshPreRules.hpp"
+
+#include <gtest/gtest.h>
+
+#include <boost/algorithm/string/case_conv.hpp>
+#include <nlohmann/json.hpp>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,misc-non-private-member-variables-in-classes,cppcoreguidelines-non-private-member-variables-in-classes)
+namespace {
+/// @brief FixMeshLighting prepatcher as it was before the rules engine
+auto referenceFixMeshLighting(nifly::NifFile& nif, nifly::NiShape& nifShape) -> bool
+{
+    auto* const nifShaderBSLSP = dynamic_cast<nifly::BSLightingShaderProperty*>(nif.GetShader(&nifShape));
+    if (nifShaderBSLSP->softlighting > 0.6F) {
+        return NIFUtil::setShaderFloat(nifShaderBSLSP->softlighting, 0.6F);
+    }
+    return false;
+}
+
+/// @brief FixTextureSlotCount prepatcher as it was before the rules engine
+auto referenceFixTextureSlotCount(nifly::NifFile& nif, nifly::NiShape& nifShape) -> bool
+{
+    auto* txstRec = nif.GetHeader().GetBlock(nif.GetShader(&nifShape)->TextureSetRef());
+    if (txstRec->textures.size() < 9) {
+        txstRec->textures.resize(9);
+        return true;
+    }
+    return false;
+}
+
+/// @brief Shapes that ParallaxGen runs prepatchers on
+auto getPatchableShapes(nifly::NifFile& nif) -> vector<nifly::NiShape*>
+{
+    vector<nifly::NiShape*> shapes;
+    for (auto* const shape : nif.GetShapes()) {
+        auto* const shader = nif.GetShader(shape);
+        if (shader != nullptr && shader->GetBlockName() == string("BSLightingShaderProperty")
+            && shader->HasTextureSet()) {
+            shapes.push_back(shape);
+        }
+    }
+    return shapes;
+}
+} // namespace
+
+class PatcherMeshPreRulesEnvTest : public PGTesting::MappedGameTest { };
+
+TEST_P(PatcherMeshPreRulesEnvTest, MatchesPrePatchers)
+{
+    PatcherMeshPreRules::loadStatics(nlohmann::json::array({ PatcherMeshPreRules::getBuiltinRule("FixMeshLighting"),
+        PatcherMeshPreRules::getBuiltinRule("FixTextureSlotCount") }));
+    ASSERT_EQ(PatcherMeshPreRules::getNumRules(), 2);
+
+    size_t numShapes = 0;
+    for (const auto& meshPath : m_pgd->getMeshes()) {
+        const auto nifBytes = m_pgd->getFile(meshPath);
+
+        auto referenceNIF = NIFUtil::loadNIFFromBytes(nifBytes);
+        vector<bool> referenceResults;
+        for (auto* const shape : getPatchableShapes(referenceNIF)) {
+            // only the lighting fix triggers a save
+            const bool changed = referenceFixMeshLighting(referenceNIF, *shape);
+            referenceFixTextureSlotCount(referenceNIF, *shape);
+            referenceResults.push_back(changed);
+        }
+
+        auto rulesNIF = NIFUtil::loadNIFFromBytes(nifBytes);
+        PatcherMeshPreRules patcher(meshPath, &rulesNIF);
+        vector<bool> rulesResults;
+        for (auto* const shape : getPatchableShapes(rulesNIF)) {
+            rulesResults.push_back(patcher.applyPatch(*shape));
+            numShapes++;
+        }
+
+        EXPECT_EQ(referenceResults, rulesResults) << meshPath;
+        EXPECT_EQ(NIFUtil::saveNIFToBytes(referenceNIF, {}), NIFUtil::saveNIFToBytes(rulesNIF, {})) << meshPath;
+    }
+
+    EXPECT_GT(numShapes, 0);
+}
+
+TEST_P(PatcherMeshPreRulesEnvTest, MatchConditions)
+{
+    size_t numShapes = 0;
+    for (const auto& meshPath : m_pgd->getMeshes()) {
+        auto nif = NIFUtil::loadNIFFromBytes(m_pgd->getFile(meshPath));
+        PatcherMeshPreRules patcher(meshPath, &nif);
+
+        for (auto* const shape : getPatchableShapes(nif)) {
+            auto* const shader = dynamic_cast<nifly::BSLightingShaderProperty*>(nif.GetShader(shape));
+            const auto diffuse = NIFUtil::getTextureSlot(&nif, shape, NIFUtil::TextureSlots::DIFFUSE);
+
+            // every condition holds, diffuse is matched with different case and a wildcard
+            auto diffusePattern = boost::to_upper_copy(diffuse);
+            if (!diffusePattern.empty()) {
+                diffusePattern.back() = '?';
+            }
+            nlohmann::json rule = { { "name", "Matching" },
+                { "match",
+                    { { "shader_types", nlohmann::json::array({ shader->GetShaderType() }) },
+                        { "flags1_set", shader->shaderFlags1 }, { "flags2_set", shader->shaderFlags2 },
+                        { "slots", { { "0", diffusePattern + "*" } } } } },
+                { "actions", nlohmann::json::array({ { { "field", "specular_strength" }, { "set", 123.0F } } }) } };
+            PatcherMeshPreRules::loadStatics(nlohmann::json::array({ rule }));
+            ASSERT_EQ(PatcherMeshPreRules::getNumRules(), 1);
+
+            EXPECT_TRUE(patcher.applyPatch(*shape)) << meshPath;
+            EXPECT_EQ(shader->specularStrength, 123.0F) << meshPath;
+            EXPECT_FALSE(patcher.applyPatch(*shape)) << meshPath;
+
+            // any failing condition skips the rule
+            rule["actions"][0]["set"] = 1.0F;
+            const vector<pair<string, nlohmann::json>> failingConditions
+                = { { "shader_types", nlohmann::json::array({ (shader->GetShaderType() + 1) % 32 }) },
+                      shader->shaderFlags1 != 0 ? pair<string, nlohmann::json> { "flags1_unset", shader->shaderFlags1 }
+                                                : pair<string, nlohmann::json> { "flags1_set", 1U },
+                      { "slots", { { "0", "textures\\nomatch\\*.dds" } } } };
+            for (const auto& [key, value] : failingConditions) {
+                auto failingRule = rule;
+                failingRule["match"][key] = value;
+                PatcherMeshPreRules::loadStatics(nlohmann::json::array({ failingRule }));
+                ASSERT_EQ(PatcherMeshPreRules::getNumRules(), 1);
+
+                EXPECT_FALSE(patcher.applyPatch(*shape)) << meshPath << " " << key;
+                EXPECT_EQ(shader->specularStrength, 123.0F) << meshPath << " " << key;
+            }
+
+            numShapes++;
+        }
+    }
+
+    EXPECT_GT(numShapes, 0);
+}
+
+TEST_P(PatcherMeshPreRulesEnvTest, DiagKeyPerAppliedRule)
+{
+    PatcherMeshPreRules::loadStatics(nlohmann::json::array({ PatcherMeshPreRules::getBuiltinRule("FixMeshLighting"),
+        PatcherMeshPreRules::getBuiltinRule("FixTextureSlotCount") }));
+    PGDiag::init();
+
+    size_t numShapes = 0;
+    for (const auto& meshPath : m_pgd->getMeshes()) {
+        const auto nifBytes = m_pgd->getFile(meshPath);
+        auto referenceNIF = NIFUtil::loadNIFFromBytes(nifBytes);
+        auto rulesNIF = NIFUtil::loadNIFFromBytes(nifBytes);
+        PatcherMeshPreRules patcher(meshPath, &rulesNIF);
+
+        const auto referenceShapes = getPatchableShapes(referenceNIF);
+        const auto rulesShapes = getPatchableShapes(rulesNIF);
+        ASSERT_EQ(referenceShapes.size(), rulesShapes.size());
+        for (size_t i = 0; i < rulesShapes.size(); ++i) {
+            const auto prefix = meshPath.string() + "/" + to_string(i);
+            {
+                const PGDiag::Prefix shapePrefix(prefix, nlohmann::json::value_t::object);
+                (void)patcher.applyPatch(*rulesShapes[i]);
+            }
+
+            // save:false rules are recorded too, rules that changed nothing are not
+            nlohmann::json expected = nlohmann::json::object();
+            if (referenceFixMeshLighting(referenceNIF, *referenceShapes[i])) {
+                expected["FixMeshLighting"] = true;
+            }
+            if (referenceFixTextureSlotCount(referenceNIF, *referenceShapes[i])) {
+                expected["FixTextureSlotCount"] = true;
+            }
+            EXPECT_EQ(PGDiag::getJSON()[prefix], expected) << prefix;
+            numShapes++;
+        }
+    }
+
+    EXPECT_GT(numShapes, 0);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    GameParametersSE, PatcherMeshPreRulesEnvTest, ::testing::Values(PGTestEnvs::s_testENVSkyrimSE));
+
+TEST(PatcherMeshPreRulesTest, SkipsInvalidRules)
+{
+    PatcherMeshPreRules::loadStatics(nlohmann::json::parse(R"([
+        { "actions": [ { "field": "alpha", "set": 1.0 } ] },
+        { "name": "NoActions" },
+        { "name": "UnknownField", "actions": [ { "field": "nothing", "set": 1.0 } ] },
+        { "name": "NoOperation", "actions": [ { "field": "alpha" } ] },
+        { "name": "MinAboveMax", "actions": [ { "field": "alpha", "min": 2.0, "max": 1.0 } ] },
+        { "name": "BadSlot", "match": { "slots": { "9": "*" } }, "actions": [ { "field": "alpha", "set": 1.0 } ] },
+        { "name": "BadShaderType", "match": { "shader_types": [ 32 ] },
+          "actions": [ { "field": "alpha", "set": 1.0 } ] },
+        { "name": "BadType", "match": { "flags1_set": "x" }, "actions": [ { "field": "alpha", "set": 1.0 } ] },
+        { "name": "NegativeSlotCount", "actions": [ { "field": "texture_slot_count", "set": -1 } ] },
+        { "name": "HugeSlotCount", "actions": [ { "field": "texture_slot_count", "set": 1000000000 } ] },
+        { "name": "HugeMinSlotCount", "actions": [ { "field": "texture_slot_count", "min": 1000000000 } ] },
+        { "name": "Valid", "actions": [ { "field": "glossiness", "min": 1.0, "max": 80.0 } ] }
+    ])"));
+
+    EXPECT_EQ(PatcherMeshPreRules::getNumRules(), 1);
+
+    PatcherMeshPreRules::loadStatics(nlohmann::json::object());
+    EXPECT_EQ(PatcherMeshPreRules::getNumRules(), 0);
+
+    EXPECT_TRUE(PatcherMeshPreRules::getBuiltinRule("Missing").is_null());
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,misc-non-private-member-variables-in-classes,cppcoreguidelines-non-private-member-variables-in-classes)
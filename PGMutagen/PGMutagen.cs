@@ -4,6 +4,8 @@
 using System;
 using System.Runtime.InteropServices;
 using System.Runtime.CompilerServices;
+using System.Text.Json;
+using System.Text.Json.Serialization;
 
 // Mutagen
 using Mutagen.Bethesda;
@@ -48,45 +50,212 @@ public static class ExceptionHandler
 
 public static class MessageHandler
 {
-    private static Queue<Tuple<string, int>> LogQueue = [];
+    // Level values
+    // 0: Trace
+    // 1: Debug
+    // 2: Info
+    // 3: Warning
+    // 4: Error
+    // 5: Critical
+    private static int MinLevel = 0;
+
+    // Pending messages as UTF-16 records of [level, length low, length high, text...]. Wraps around and doubles when
+    // full, the native side drains whole records in bulk with GetLogMessages.
+    private const int RecordHeaderSize = 3;
+    private static char[] LogBuffer = new char[1 << 16];
+    private static int LogStart = 0;
+    private static int LogCount = 0;
+
+    public static bool IsEnabled(int level)
+    {
+        return level >= MinLevel;
+    }
 
     public static void Log(string message, int level = 0)
     {
-        // Level values
-        // 0: Trace
-        // 1: Debug
-        // 2: Info
-        // 3: Warning
-        // 4: Error
-        // 5: Critical
-        LogQueue.Enqueue(new Tuple<string, int>(message, level));
+        if (!IsEnabled(level))
+        {
+            return;
+        }
+
+        Enqueue(message, level);
     }
 
-    [UnmanagedCallersOnly(EntryPoint = "GetLogMessage", CallConvs = [typeof(CallConvCdecl)])]
-    public static unsafe void GetLogMessage([DNNE.C99Type("wchar_t**")] IntPtr* messagePtr, [DNNE.C99Type("int*")] int* level)
+    // Interpolated messages are only formatted if the level is enabled
+    public static void Log(int level, [InterpolatedStringHandlerArgument("level")] ref LogInterpolatedStringHandler message)
     {
-        if (LogQueue.Count == 0)
+        if (!message.Enabled)
         {
             return;
         }
 
-        var logMessage = LogQueue.Dequeue();
-        string message = logMessage.Item1;
-        *messagePtr = Marshal.StringToHGlobalUni(logMessage.Item1);
-        *level = logMessage.Item2;
+        Enqueue(message.ToStringAndClear(), level);
+    }
+
+    [UnmanagedCallersOnly(EntryPoint = "SetLogLevel", CallConvs = [typeof(CallConvCdecl)])]
+    public static void SetLogLevel([DNNE.C99Type("const int")] int level)
+    {
+        MinLevel = level;
+    }
+
+    [UnmanagedCallersOnly(EntryPoint = "GetLogMessages", CallConvs = [typeof(CallConvCdecl)])]
+    public static unsafe void GetLogMessages([DNNE.C99Type("unsigned short*")] ushort* buffer, [DNNE.C99Type("const int")] int bufferSize, [DNNE.C99Type("int*")] int* numWritten)
+    {
+        int written = 0;
+        while (LogCount > 0)
+        {
+            int length = Peek(RecordHeaderSize - 2) | (Peek(RecordHeaderSize - 1) << 16);
+            int available = bufferSize - written - RecordHeaderSize;
+            if (available < 0 || (available < length && written > 0))
+            {
+                // next record goes into the next call
+                break;
+            }
+
+            // a message longer than the whole buffer is cut off
+            int copyLength = Math.Min(length, Math.Max(available, 0));
+            buffer[written] = Peek(0);
+            buffer[written + 1] = (ushort)(copyLength & 0xFFFF);
+            buffer[written + 2] = (ushort)(copyLength >> 16);
+            for (int i = 0; i < copyLength; i++)
+            {
+                buffer[written + RecordHeaderSize + i] = Peek(RecordHeaderSize + i);
+            }
+
+            written += RecordHeaderSize + copyLength;
+            LogStart = (LogStart + RecordHeaderSize + length) % LogBuffer.Length;
+            LogCount -= RecordHeaderSize + length;
+        }
+
+        *numWritten = written;
+    }
+
+    private static ushort Peek(int offset)
+    {
+        return LogBuffer[(LogStart + offset) % LogBuffer.Length];
+    }
+
+    private static void Enqueue(string message, int level)
+    {
+        int recordSize = RecordHeaderSize + message.Length;
+        if (LogCount + recordSize > LogBuffer.Length)
+        {
+            // unwrap into a buffer with enough room
+            int newSize = LogBuffer.Length;
+            while (LogCount + recordSize > newSize)
+            {
+                newSize *= 2;
+            }
+
+            var newBuffer = new char[newSize];
+            for (int i = 0; i < LogCount; i++)
+            {
+                newBuffer[i] = LogBuffer[(LogStart + i) % LogBuffer.Length];
+            }
+            LogBuffer = newBuffer;
+            LogStart = 0;
+        }
+
+        Put((char)level);
+        Put((char)(message.Length & 0xFFFF));
+        Put((char)(message.Length >> 16));
+        foreach (var c in message)
+        {
+            Put(c);
+        }
+    }
+
+    private static void Put(char c)
+    {
+        LogBuffer[(LogStart + LogCount) % LogBuffer.Length] = c;
+        LogCount++;
     }
 }
 
+[InterpolatedStringHandler]
+public ref struct LogInterpolatedStringHandler
+{
+    private DefaultInterpolatedStringHandler Inner;
+
+    public bool Enabled { get; }
+
+    public LogInterpolatedStringHandler(int literalLength, int formattedCount, int level, out bool shouldAppend)
+    {
+        Enabled = MessageHandler.IsEnabled(level);
+        shouldAppend = Enabled;
+        Inner = Enabled ? new DefaultInterpolatedStringHandler(literalLength, formattedCount) : default;
+    }
+
+    public void AppendLiteral(string value)
+    {
+        Inner.AppendLiteral(value);
+    }
+
+    public void AppendFormatted<T>(T value)
+    {
+        Inner.AppendFormatted(value);
+    }
+
+    public string ToStringAndClear()
+    {
+        return Inner.ToStringAndClear();
+    }
+}
+
+// Records by handle. Records loaded from the record index only have their FormKey until they are first used.
+public class RecordList<T>(Func<FormKey, T> resolve) where T : class, IMajorRecordGetter
+{
+    private readonly List<T?> Records = [];
+    private readonly List<FormKey> Keys = [];
+
+    public int Count => Records.Count;
+
+    public T this[int index] => Records[index] ??= resolve(Keys[index]);
+
+    public int Add(FormKey key, T? record = null)
+    {
+        Records.Add(record);
+        Keys.Add(key);
+        return Records.Count - 1;
+    }
+
+    public FormKey GetFormKey(int index)
+    {
+        return Keys[index];
+    }
+}
+
+// An alternate texture of a model record, AltTex is resolved from the model record when loaded from the record index
+public class AltTexRef
+{
+    [JsonIgnore]
+    public IAlternateTextureGetter? AltTex { get; set; }
+    public int ModelRecId { get; set; }
+    public int ModelRecCounter { get; set; }
+    public string Type { get; set; } = string.Empty;
+    public int ModelElemIdx { get; set; }
+    public int AltTexIdx { get; set; }
+}
+
+// Handles of a populated load order, saved to cache/pluginRecords.json
+public class RecordIndex
+{
+    public List<string> TextureSets { get; set; } = [];
+    public List<string> ModelRecords { get; set; } = [];
+    public List<AltTexRef> AlternateTextures { get; set; } = [];
+}
+
 public class PGMutagen
 {
     // "Class vars" actually static because p/invoke doesn't support instance methods
     private static SkyrimMod? OutMod;
     private static IGameEnvironment<ISkyrimMod, ISkyrimModGetter>? Env;
-    private static List<ITextureSetGetter> TXSTObjs = [];
-    private static List<Tuple<IAlternateTextureGetter, int, int, string>> AltTexRefs = [];
-    private static List<IMajorRecordGetter> ModelOriginals = [];
-    private static List<IMajorRecord> ModelCopies = [];
-    private static List<IMajorRecord> ModelCopiesEditable = [];
+    private static RecordList<ITextureSetGetter> TXSTObjs = new(ResolveRecord<ITextureSetGetter>);
+    private static Dictionary<FormKey, int> TXSTIndex = [];
+    private static List<AltTexRef> AltTexRefs = [];
+    private static RecordList<IMajorRecordGetter> ModelOriginals = new(ResolveRecord<IMajorRecordGetter>);
+    // editable copies are only made when a record is first written to, most records are never modified
+    private static Dictionary<int, IMajorRecord> ModelCopiesEditable = [];
     private static Dictionary<Tuple<string, int>, List<Tuple<int, int>>>? TXSTRefs;
     private static HashSet<int> ModifiedModeledRecords = [];
     private static SkyrimRelease GameType;
@@ -191,7 +360,7 @@ public class PGMutagen
 
             // Main method
             string dataPath = Marshal.PtrToStringUni(dataPathPtr) ?? string.Empty;
-            MessageHandler.Log("[Initialize] Data Path: " + dataPath, 0);
+            MessageHandler.Log(0, $"[Initialize] Data Path: {dataPath}");
 
             GameType = (SkyrimRelease)gameType;
             OutMod = new SkyrimMod(ModKey.FromFileName("ParallaxGen.esp"), GameType);
@@ -341,14 +510,19 @@ public class PGMutagen
                 throw new Exception("Initialize must be called before PopulateObjs");
             }
 
-            TXSTObjs = [];
+            TXSTObjs = new(ResolveRecord<ITextureSetGetter>);
+            TXSTIndex = [];
             foreach (var textureSet in Env.LoadOrder.PriorityOrder.TextureSet().WinningOverrides())
             {
-                MessageHandler.Log("[PopulateObjs] Adding TXST record as index " + TXSTObjs.Count + ": " + GetRecordDesc(textureSet), 0);
-                TXSTObjs.Add(textureSet);
+                MessageHandler.Log(0, $"[PopulateObjs] Adding TXST record as index {TXSTObjs.Count}: {GetRecordDesc(textureSet)}");
+                AddTXSTObj(textureSet);
             }
 
             TXSTRefs = [];
+            AltTexRefs = [];
+            ModelOriginals = new(ResolveRecord<IMajorRecordGetter>);
+            ModelCopiesEditable = [];
+            ModifiedModeledRecords = [];
             int ModelRecCounter = 0;
             var DCIdx = -1;
             foreach (var txstRefObj in EnumerateModelRecordsSafe())
@@ -359,38 +533,26 @@ public class PGMutagen
                 if (ModelRecs.Count == 0)
                 {
                     // Skip if there is nothing to search
-                    MessageHandler.Log("[PopulateObjs] No models found for record: " + GetRecordDesc(txstRefObj), 0);
+                    MessageHandler.Log(0, $"[PopulateObjs] No models found for record: {GetRecordDesc(txstRefObj)}");
                     continue;
                 }
 
-                bool CopiedRecord = false;
-                foreach (var modelRec in ModelRecs)
+                bool AddedRecord = false;
+                for (int ModelElemIdx = 0; ModelElemIdx < ModelRecs.Count; ModelElemIdx++)
                 {
+                    var modelRec = ModelRecs[ModelElemIdx];
                     if (modelRec.Item1.AlternateTextures is null)
                     {
                         // no alternate textures
-                        MessageHandler.Log("[PopulateObjs] No alternate textures found for a model record: " + GetRecordDesc(txstRefObj), 0);
+                        MessageHandler.Log(0, $"[PopulateObjs] No alternate textures found for a model record: {GetRecordDesc(txstRefObj)}");
                         continue;
                     }
 
-                    if (!CopiedRecord)
+                    if (!AddedRecord)
                     {
-                        // Deep copy major record
-                        try
-                        {
-                            ModelOriginals.Add(txstRefObj);
-                            var DeepCopy = txstRefObj.DeepCopy();
-                            ModelCopies.Add(DeepCopy);
-                            var DeepCopyEditable = txstRefObj.DeepCopy();
-                            ModelCopiesEditable.Add(DeepCopyEditable);
-                            DCIdx = ModelCopies.Count - 1;
-                            CopiedRecord = true;
-                        }
-                        catch (Exception)
-                        {
-                            MessageHandler.Log("Failed to copy record: " + GetRecordDesc(txstRefObj), 3);
-                            break;
-                        }
+                        // Copied by GetEditableModelRecord once something writes to it
+                        DCIdx = ModelOriginals.Add(txstRefObj.FormKey, txstRefObj);
+                        AddedRecord = true;
                     }
 
                     // find lowercase nifname
@@ -399,16 +561,25 @@ public class PGMutagen
                     // Otherwise this causes issues with deepcopy
                     nifName = RemovePrefixIfExists("\\", nifName);
 
-                    nifName = nifName.ToLower();
+                    nifName = ToLowerASCII(nifName);
                     nifName = AddPrefixIfNotExists("meshes\\", nifName);
 
-                    MessageHandler.Log("[PopulateObjs] NIF Name '" + nifName + "' found in model record in record " + GetRecordDesc(txstRefObj), 0);
+                    MessageHandler.Log(0, $"[PopulateObjs] NIF Name '{nifName}' found in model record in record {GetRecordDesc(txstRefObj)}");
 
-                    foreach (var alternateTexture in modelRec.Item1.AlternateTextures)
+                    for (int AltTexIdx = 0; AltTexIdx < modelRec.Item1.AlternateTextures.Count; AltTexIdx++)
                     {
+                        var alternateTexture = modelRec.Item1.AlternateTextures[AltTexIdx];
+
                         // Add to global
-                        var AltTexEntry = new Tuple<IAlternateTextureGetter, int, int, string>(alternateTexture, DCIdx, ModelRecCounter, modelRec.Item2);
-                        AltTexRefs.Add(AltTexEntry);
+                        AltTexRefs.Add(new AltTexRef
+                        {
+                            AltTex = alternateTexture,
+                            ModelRecId = DCIdx,
+                            ModelRecCounter = ModelRecCounter,
+                            Type = modelRec.Item2,
+                            ModelElemIdx = ModelElemIdx,
+                            AltTexIdx = AltTexIdx
+                        });
                         var AltTexId = AltTexRefs.Count - 1;
 
                         int index3D = alternateTexture.Index;
@@ -416,30 +587,27 @@ public class PGMutagen
 
                         var key = new Tuple<string, int>(nifName, index3D);
 
-                        MessageHandler.Log("[PopulateObjs] Adding to AltTexRefs as index " + AltTexId + ": " + key.ToString(), 0);
+                        MessageHandler.Log(0, $"[PopulateObjs] Adding to AltTexRefs as index {AltTexId}: {key.ToString()}");
 
-                        int newTXSTIndex = TXSTObjs.FindIndex(x => x.FormKey == newTXST.FormKey);
-                        if (newTXSTIndex < 0)
+                        if (!TXSTIndex.TryGetValue(newTXST.FormKey, out int newTXSTIndex))
                         {
                             var CurHashCode = newTXST.GetHashCode();
                             if (TXSTErrorTracker.Add(CurHashCode))
                             {
-                                MessageHandler.Log("Referenced TXST record in " + GetRecordDesc(txstRefObj) + " / " + key.ToString() + " does not exist", 3);
+                                MessageHandler.Log(3, $"Referenced TXST record in {GetRecordDesc(txstRefObj)} / {key.ToString()} does not exist");
                             }
                             continue;
                         }
 
                         var newTXSTObj = TXSTObjs[newTXSTIndex];
 
-                        if (newTXSTIndex >= 0)
+                        if (!TXSTRefs.TryGetValue(key, out var keyRefs))
                         {
-                            if (!TXSTRefs.ContainsKey(key))
-                            {
-                                TXSTRefs[key] = [];
-                            }
-                            TXSTRefs[key].Add(new Tuple<int, int>(newTXSTIndex, AltTexId));
-                            MessageHandler.Log("[PopulateObjs] Adding Alt Tex Reference: " + key.ToString() + " -> " + GetRecordDesc(newTXSTObj), 0);
+                            keyRefs = [];
+                            TXSTRefs[key] = keyRefs;
                         }
+                        keyRefs.Add(new Tuple<int, int>(newTXSTIndex, AltTexId));
+                        MessageHandler.Log(0, $"[PopulateObjs] Adding Alt Tex Reference: {key.ToString()} -> {GetRecordDesc(newTXSTObj)}");
                     }
 
                     ModelRecCounter++;
@@ -452,6 +620,134 @@ public class PGMutagen
         }
     }
 
+    [UnmanagedCallersOnly(EntryPoint = "GetTXSTRefs", CallConvs = [typeof(CallConvCdecl)])]
+    public static unsafe void GetTXSTRefs(
+      [DNNE.C99Type("wchar_t**")] IntPtr* NIFNames,
+      [DNNE.C99Type("int*")] int* Index3Ds,
+      [DNNE.C99Type("int*")] int* TXSTHandles,
+      [DNNE.C99Type("int*")] int* AltTexHandles,
+      [DNNE.C99Type("char**")] IntPtr* MatchedTypes,
+      [DNNE.C99Type("int*")] int* length)
+    {
+        try
+        {
+            if (TXSTRefs is null)
+            {
+                throw new Exception("PopulateObjs must be called before GetTXSTRefs");
+            }
+
+            if (length is not null)
+            {
+                *length = TXSTRefs.Values.Sum(refs => refs.Count);
+            }
+
+            if (NIFNames is null || Index3Ds is null || TXSTHandles is null || AltTexHandles is null || MatchedTypes is null)
+            {
+                return;
+            }
+
+            int i = 0;
+            foreach (var (key, refs) in TXSTRefs)
+            {
+                foreach (var txst in refs)
+                {
+                    NIFNames[i] = Marshal.StringToHGlobalUni(key.Item1);
+                    Index3Ds[i] = key.Item2;
+                    TXSTHandles[i] = txst.Item1;
+                    AltTexHandles[i] = txst.Item2;
+                    MatchedTypes[i] = Marshal.StringToHGlobalAnsi(AltTexRefs[txst.Item2].Type);
+                    i++;
+                }
+            }
+        }
+        catch (Exception ex)
+        {
+            ExceptionHandler.SetLastException(ex);
+            if (length is not null)
+            {
+                *length = 0;
+            }
+        }
+    }
+
+    [UnmanagedCallersOnly(EntryPoint = "SaveRecordIndex", CallConvs = [typeof(CallConvCdecl)])]
+    public static void SaveRecordIndex([DNNE.C99Type("const wchar_t*")] IntPtr filePathPtr)
+    {
+        try
+        {
+            string filePath = Marshal.PtrToStringUni(filePathPtr) ?? throw new Exception("File path is null");
+
+            var recordIndex = new RecordIndex { AlternateTextures = AltTexRefs };
+            for (int i = 0; i < TXSTObjs.Count; i++)
+            {
+                recordIndex.TextureSets.Add(TXSTObjs.GetFormKey(i).ToString());
+            }
+            for (int i = 0; i < ModelOriginals.Count; i++)
+            {
+                recordIndex.ModelRecords.Add(ModelOriginals.GetFormKey(i).ToString());
+            }
+
+            File.WriteAllText(filePath, JsonSerializer.Serialize(recordIndex));
+        }
+        catch (Exception ex)
+        {
+            ExceptionHandler.SetLastException(ex);
+        }
+    }
+
+    // Restores the handles PopulateObjs assigned in an earlier run with the same load order, without reading any
+    // record. Records are resolved from their FormKey when they are first used.
+    [UnmanagedCallersOnly(EntryPoint = "LoadRecordIndex", CallConvs = [typeof(CallConvCdecl)])]
+    public static unsafe void LoadRecordIndex([DNNE.C99Type("const wchar_t*")] IntPtr filePathPtr, [DNNE.C99Type("int*")] int* success)
+    {
+        *success = 0;
+        try
+        {
+            if (Env is null)
+            {
+                throw new Exception("Initialize must be called before LoadRecordIndex");
+            }
+
+            string filePath = Marshal.PtrToStringUni(filePathPtr) ?? throw new Exception("File path is null");
+            if (!File.Exists(filePath))
+            {
+                return;
+            }
+
+            var recordIndex = JsonSerializer.Deserialize<RecordIndex>(File.ReadAllText(filePath));
+            if (recordIndex is null)
+            {
+                return;
+            }
+
+            TXSTObjs = new(ResolveRecord<ITextureSetGetter>);
+            TXSTIndex = [];
+            foreach (var txstKey in recordIndex.TextureSets)
+            {
+                var formKey = FormKey.Factory(txstKey);
+                TXSTIndex.TryAdd(formKey, TXSTObjs.Add(formKey));
+            }
+
+            ModelOriginals = new(ResolveRecord<IMajorRecordGetter>);
+            foreach (var modelKey in recordIndex.ModelRecords)
+            {
+                ModelOriginals.Add(FormKey.Factory(modelKey));
+            }
+
+            AltTexRefs = recordIndex.AlternateTextures;
+            ModelCopiesEditable = [];
+            ModifiedModeledRecords = [];
+            *success = 1;
+            MessageHandler.Log(0, $"[LoadRecordIndex] Loaded {TXSTObjs.Count} TXST records, {ModelOriginals.Count} model records and {AltTexRefs.Count} alternate textures");
+        }
+        catch (Exception ex)
+        {
+            // a broken index only means PopulateObjs has to run
+            MessageHandler.Log("Failed to load record index, rebuilding it: " + ex.Message, 3);
+            *success = 0;
+        }
+    }
+
     [UnmanagedCallersOnly(EntryPoint = "Finalize", CallConvs = [typeof(CallConvCdecl)])]
     public static void Finalize([DNNE.C99Type("const wchar_t*")] IntPtr outputPathPtr, [DNNE.C99Type("const int")] int esmify)
     {
@@ -492,184 +788,187 @@ public class PGMutagen
             // Add all modified model records to the output mod
             foreach (var recId in ModifiedModeledRecords)
             {
-                var ModifiedRecord = ModelCopiesEditable[recId];
+                if (!ModelCopiesEditable.TryGetValue(recId, out var ModifiedRecord))
+                {
+                    continue;
+                }
 
                 var outputMod = getModToAdd(ModifiedRecord);
 
                 if (ModifiedRecord is Mutagen.Bethesda.Skyrim.Activator activator)
                 {
                     outputMod.Activators.Add(activator);
-                    MessageHandler.Log("[Finalize] Adding Activator: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Activator: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is Ammunition ammunition)
                 {
                     outputMod.Ammunitions.Add(ammunition);
-                    MessageHandler.Log("[Finalize] Adding Ammunition: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Ammunition: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is AnimatedObject @object)
                 {
                     outputMod.AnimatedObjects.Add(@object);
-                    MessageHandler.Log("[Finalize] Adding Animated Object: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Animated Object: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is Armor armor)
                 {
                     outputMod.Armors.Add(armor);
-                    MessageHandler.Log("[Finalize] Adding Armor: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Armor: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is ArmorAddon addon)
                 {
                     outputMod.ArmorAddons.Add(addon);
-                    MessageHandler.Log("[Finalize] Adding Armor Addon: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Armor Addon: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is ArtObject object1)
                 {
                     outputMod.ArtObjects.Add(object1);
-                    MessageHandler.Log("[Finalize] Adding Art Object: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Art Object: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is BodyPartData data)
                 {
                     outputMod.BodyParts.Add(data);
-                    MessageHandler.Log("[Finalize] Adding Body Part Data: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Body Part Data: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is Book book)
                 {
                     outputMod.Books.Add(book);
-                    MessageHandler.Log("[Finalize] Adding Book: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Book: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is CameraShot shot)
                 {
                     outputMod.CameraShots.Add(shot);
-                    MessageHandler.Log("[Finalize] Adding Camera Shot: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Camera Shot: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is Climate climate)
                 {
                     outputMod.Climates.Add(climate);
-                    MessageHandler.Log("[Finalize] Adding Climate: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Climate: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is Container container)
                 {
                     outputMod.Containers.Add(container);
-                    MessageHandler.Log("[Finalize] Adding Container: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Container: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is Door door)
                 {
                     outputMod.Doors.Add(door);
-                    MessageHandler.Log("[Finalize] Adding Door: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Door: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is Explosion explosion)
                 {
                     outputMod.Explosions.Add(explosion);
-                    MessageHandler.Log("[Finalize] Adding Explosion: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Explosion: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is Flora flora)
                 {
                     outputMod.Florae.Add(flora);
-                    MessageHandler.Log("[Finalize] Adding Flora: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Flora: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is Furniture furniture)
                 {
                     outputMod.Furniture.Add(furniture);
-                    MessageHandler.Log("[Finalize] Adding Furniture: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Furniture: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is Grass grass)
                 {
                     outputMod.Grasses.Add(grass);
-                    MessageHandler.Log("[Finalize] Adding Grass: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Grass: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is Hazard hazard)
                 {
                     outputMod.Hazards.Add(hazard);
-                    MessageHandler.Log("[Finalize] Adding Hazard: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Hazard: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is HeadPart part)
                 {
                     outputMod.HeadParts.Add(part);
-                    MessageHandler.Log("[Finalize] Adding Head Part: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Head Part: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is IdleMarker marker)
                 {
                     outputMod.IdleMarkers.Add(marker);
-                    MessageHandler.Log("[Finalize] Adding Idle Marker: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Idle Marker: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is Impact impact)
                 {
                     outputMod.Impacts.Add(impact);
-                    MessageHandler.Log("[Finalize] Adding Impact: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Impact: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is Ingestible ingestible)
                 {
                     outputMod.Ingestibles.Add(ingestible);
-                    MessageHandler.Log("[Finalize] Adding Ingestible: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Ingestible: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is Ingredient ingredient)
                 {
                     outputMod.Ingredients.Add(ingredient);
-                    MessageHandler.Log("[Finalize] Adding Ingredient: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Ingredient: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is Key key)
                 {
                     outputMod.Keys.Add(key);
-                    MessageHandler.Log("[Finalize] Adding Key: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Key: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is LeveledNpc npc)
                 {
                     outputMod.LeveledNpcs.Add(npc);
-                    MessageHandler.Log("[Finalize] Adding Leveled NPC: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Leveled NPC: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is Light light)
                 {
                     outputMod.Lights.Add(light);
-                    MessageHandler.Log("[Finalize] Adding Light: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Light: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is MaterialObject object2)
                 {
                     outputMod.MaterialObjects.Add(object2);
-                    MessageHandler.Log("[Finalize] Adding Material Object: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Material Object: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is MiscItem item)
                 {
                     outputMod.MiscItems.Add(item);
-                    MessageHandler.Log("[Finalize] Adding Misc Item: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Misc Item: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is MoveableStatic @static)
                 {
                     outputMod.MoveableStatics.Add(@static);
-                    MessageHandler.Log("[Finalize] Adding Moveable Static: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Moveable Static: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is Projectile projectile)
                 {
                     outputMod.Projectiles.Add(projectile);
-                    MessageHandler.Log("[Finalize] Adding Projectile: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Projectile: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is Scroll scroll)
                 {
                     outputMod.Scrolls.Add(scroll);
-                    MessageHandler.Log("[Finalize] Adding Scroll: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Scroll: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is SoulGem gem)
                 {
                     outputMod.SoulGems.Add(gem);
-                    MessageHandler.Log("[Finalize] Adding Soul Gem: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Soul Gem: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is Static static1)
                 {
                     outputMod.Statics.Add(static1);
-                    MessageHandler.Log("[Finalize] Adding Static: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Static: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is TalkingActivator activator1)
                 {
                     outputMod.TalkingActivators.Add(activator1);
-                    MessageHandler.Log("[Finalize] Adding Talking Activator: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Talking Activator: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is Tree tree)
                 {
                     outputMod.Trees.Add(tree);
-                    MessageHandler.Log("[Finalize] Adding Tree: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Tree: {GetRecordDesc(ModifiedRecord)}");
                 }
                 else if (ModifiedRecord is Weapon weapon)
                 {
                     outputMod.Weapons.Add(weapon);
-                    MessageHandler.Log("[Finalize] Adding Weapon: " + GetRecordDesc(ModifiedRecord), 0);
+                    MessageHandler.Log(0, $"[Finalize] Adding Weapon: {GetRecordDesc(ModifiedRecord)}");
                 }
             }
 
@@ -775,19 +1074,19 @@ public class PGMutagen
             }
 
             string nifName = Marshal.PtrToStringUni(nifNamePtr) ?? string.Empty;
-            nifName = nifName.ToLower();
+            nifName = ToLowerASCII(nifName);
 
             var key = new Tuple<string, int>(nifName, index3D);
 
             // Log input params
-            MessageHandler.Log("[GetMatchingTXSTObjs] Getting Matching TXST Objects for: " + key.ToString(), 0);
+            MessageHandler.Log(0, $"[GetMatchingTXSTObjs] Getting Matching TXST Objects for: {key.ToString()}");
 
             List<Tuple<int, int, string, string>> txstList = [];
             if (TXSTRefs.TryGetValue(key, out List<Tuple<int, int>>? value))
             {
                 foreach (var txst in value)
                 {
-                    txstList.Add(new Tuple<int, int, string, string>(txst.Item1, txst.Item2, nifName, AltTexRefs[txst.Item2].Item4));
+                    txstList.Add(new Tuple<int, int, string, string>(txst.Item1, txst.Item2, nifName, AltTexRefs[txst.Item2].Type));
                 }
             }
 
@@ -812,20 +1111,20 @@ public class PGMutagen
                 foreach (var txst in valueAlt)
                 {
                     var altTexRef = AltTexRefs[txst.Item2];
-                    if (altTexRef.Item4 == "MODL")
+                    if (altTexRef.Type == "MODL")
                     {
                         // Skip if not _1 _0 type of MODL
                         continue;
                     }
 
-                    txstList.Add(new Tuple<int, int, string, string>(txst.Item1, txst.Item2, altNifName, altTexRef.Item4));
+                    txstList.Add(new Tuple<int, int, string, string>(txst.Item1, txst.Item2, altNifName, altTexRef.Type));
                 }
             }
 
             if (length is not null)
             {
                 *length = txstList.Count;
-                MessageHandler.Log("[GetMatchingTXSTObjs] Found " + txstList.Count + " Matching TXST Objects", 0);
+                MessageHandler.Log(0, $"[GetMatchingTXSTObjs] Found {txstList.Count} Matching TXST Objects");
             }
 
             if (TXSTHandles is null || AltTexHandles is null || MatchedNIF is null || MatchedType is null)
@@ -841,7 +1140,7 @@ public class PGMutagen
                 MatchedNIF[i] = txstList[i].Item3.IsNullOrEmpty() ? IntPtr.Zero : Marshal.StringToHGlobalUni(txstList[i].Item3);
                 MatchedType[i] = txstList[i].Item4.IsNullOrEmpty() ? IntPtr.Zero : Marshal.StringToHGlobalAnsi(txstList[i].Item4);
 
-                MessageHandler.Log("[GetMatchingTXSTObjs] Found Matching TXST: " + key.ToString() + " -> " + GetRecordDesc(TXSTObjs[txstList[i].Item1]), 0);
+                MessageHandler.Log(0, $"[GetMatchingTXSTObjs] Found Matching TXST: {key.ToString()} -> {GetRecordDesc(TXSTObjs[txstList[i].Item1])}");
             }
         }
         catch (Exception ex)
@@ -867,7 +1166,7 @@ public class PGMutagen
             }
 
             // print txst Index
-            MessageHandler.Log("[GetTXSTSlots] [TXST Index: " + txstIndex + "]", 0);
+            MessageHandler.Log(0, $"[GetTXSTSlots] [TXST Index: {txstIndex}]");
 
             var txstObj = TXSTObjs[txstIndex];
 
@@ -877,49 +1176,49 @@ public class PGMutagen
                 if (!txstObj.Diffuse.IsNullOrEmpty())
                 {
                     var Diffuse = AddPrefixIfNotExists("textures\\", txstObj.Diffuse).ToLower();
-                    MessageHandler.Log("[GetTXSTSlots] [TXST Index: " + txstIndex + "] Diffuse: " + Diffuse, 0);
+                    MessageHandler.Log(0, $"[GetTXSTSlots] [TXST Index: {txstIndex}] Diffuse: {Diffuse}");
                     slotsArray[0] = Marshal.StringToHGlobalUni(Diffuse);
                 }
                 if (!txstObj.NormalOrGloss.IsNullOrEmpty())
                 {
                     var NormalOrGloss = AddPrefixIfNotExists("textures\\", txstObj.NormalOrGloss).ToLower();
-                    MessageHandler.Log("[GetTXSTSlots] [TXST Index: " + txstIndex + "] NormalOrGloss: " + NormalOrGloss, 0);
+                    MessageHandler.Log(0, $"[GetTXSTSlots] [TXST Index: {txstIndex}] NormalOrGloss: {NormalOrGloss}");
                     slotsArray[1] = Marshal.StringToHGlobalUni(NormalOrGloss);
                 }
                 if (!txstObj.GlowOrDetailMap.IsNullOrEmpty())
                 {
                     var GlowOrDetailMap = AddPrefixIfNotExists("textures\\", txstObj.GlowOrDetailMap).ToLower();
-                    MessageHandler.Log("[GetTXSTSlots] [TXST Index: " + txstIndex + "] GlowOrDetailMap: " + GlowOrDetailMap, 0);
+                    MessageHandler.Log(0, $"[GetTXSTSlots] [TXST Index: {txstIndex}] GlowOrDetailMap: {GlowOrDetailMap}");
                     slotsArray[2] = Marshal.StringToHGlobalUni(GlowOrDetailMap);
                 }
                 if (!txstObj.Height.IsNullOrEmpty())
                 {
                     var Height = AddPrefixIfNotExists("textures\\", txstObj.Height).ToLower();
-                    MessageHandler.Log("[GetTXSTSlots] [TXST Index: " + txstIndex + "] Height: " + Height, 0);
+                    MessageHandler.Log(0, $"[GetTXSTSlots] [TXST Index: {txstIndex}] Height: {Height}");
                     slotsArray[3] = Marshal.StringToHGlobalUni(Height);
                 }
                 if (!txstObj.Environment.IsNullOrEmpty())
                 {
                     var Environment = AddPrefixIfNotExists("textures\\", txstObj.Environment).ToLower();
-                    MessageHandler.Log("[GetTXSTSlots] [TXST Index: " + txstIndex + "] Environment: " + Environment, 0);
+                    MessageHandler.Log(0, $"[GetTXSTSlots] [TXST Index: {txstIndex}] Environment: {Environment}");
                     slotsArray[4] = Marshal.StringToHGlobalUni(Environment);
                 }
                 if (!txstObj.EnvironmentMaskOrSubsurfaceTint.IsNullOrEmpty())
                 {
                     var EnvironmentMaskOrSubsurfaceTint = AddPrefixIfNotExists("textures\\", txstObj.EnvironmentMaskOrSubsurfaceTint).ToLower();
-                    MessageHandler.Log("[GetTXSTSlots] [TXST Index: " + txstIndex + "] EnvironmentMaskOrSubsurfaceTint: " + EnvironmentMaskOrSubsurfaceTint, 0);
+                    MessageHandler.Log(0, $"[GetTXSTSlots] [TXST Index: {txstIndex}] EnvironmentMaskOrSubsurfaceTint: {EnvironmentMaskOrSubsurfaceTint}");
                     slotsArray[5] = Marshal.StringToHGlobalUni(EnvironmentMaskOrSubsurfaceTint);
                 }
                 if (!txstObj.Multilayer.IsNullOrEmpty())
                 {
                     var Multilayer = AddPrefixIfNotExists("textures\\", txstObj.Multilayer).ToLower();
-                    MessageHandler.Log("[GetTXSTSlots] [TXST Index: " + txstIndex + "] Multilayer: " + Multilayer, 0);
+                    MessageHandler.Log(0, $"[GetTXSTSlots] [TXST Index: {txstIndex}] Multilayer: {Multilayer}");
                     slotsArray[6] = Marshal.StringToHGlobalUni(Multilayer);
                 }
                 if (!txstObj.BacklightMaskOrSpecular.IsNullOrEmpty())
                 {
                     var BacklightMaskOrSpecular = AddPrefixIfNotExists("textures\\", txstObj.BacklightMaskOrSpecular).ToLower();
-                    MessageHandler.Log("[GetTXSTSlots] [TXST Index: " + txstIndex + "] BacklightMaskOrSpecular: " + BacklightMaskOrSpecular, 0);
+                    MessageHandler.Log(0, $"[GetTXSTSlots] [TXST Index: {txstIndex}] BacklightMaskOrSpecular: {BacklightMaskOrSpecular}");
                     slotsArray[7] = Marshal.StringToHGlobalUni(BacklightMaskOrSpecular);
                 }
                 slotsArray[8] = IntPtr.Zero;
@@ -958,7 +1257,7 @@ public class PGMutagen
             }
 
             // print txstIndex
-            MessageHandler.Log("[CreateTXSTPatch] [TXST Index: " + txstIndex + "]", 0);
+            MessageHandler.Log(0, $"[CreateTXSTPatch] [TXST Index: {txstIndex}]");
 
             var origTXSTObj = TXSTObjs[txstIndex];
 
@@ -971,56 +1270,56 @@ public class PGMutagen
             if (NewDiffuse is not null)
             {
                 var Diffuse = RemovePrefixIfExists("textures\\", NewDiffuse);
-                MessageHandler.Log("[CreateTXSTPatch] [TXST Index: " + txstIndex + "] Diffuse: " + Diffuse, 0);
+                MessageHandler.Log(0, $"[CreateTXSTPatch] [TXST Index: {txstIndex}] Diffuse: {Diffuse}");
                 newTXSTObj.Diffuse = Diffuse;
             }
             string? NewNormalOrGloss = Marshal.PtrToStringUni(slots[1]);
             if (NewNormalOrGloss is not null)
             {
                 var NormalOrGloss = RemovePrefixIfExists("textures\\", NewNormalOrGloss);
-                MessageHandler.Log("[CreateTXSTPatch] [TXST Index: " + txstIndex + "] NormalOrGloss: " + NormalOrGloss, 0);
+                MessageHandler.Log(0, $"[CreateTXSTPatch] [TXST Index: {txstIndex}] NormalOrGloss: {NormalOrGloss}");
                 newTXSTObj.NormalOrGloss = NormalOrGloss;
             }
             string? NewGlowOrDetailMap = Marshal.PtrToStringUni(slots[2]);
             if (NewGlowOrDetailMap is not null)
             {
                 var GlowOrDetailMap = RemovePrefixIfExists("textures\\", NewGlowOrDetailMap);
-                MessageHandler.Log("[CreateTXSTPatch] [TXST Index: " + txstIndex + "] GlowOrDetailMap: " + GlowOrDetailMap, 0);
+                MessageHandler.Log(0, $"[CreateTXSTPatch] [TXST Index: {txstIndex}] GlowOrDetailMap: {GlowOrDetailMap}");
                 newTXSTObj.GlowOrDetailMap = GlowOrDetailMap;
             }
             string? NewHeight = Marshal.PtrToStringUni(slots[3]);
             if (NewHeight is not null)
             {
                 var Height = RemovePrefixIfExists("textures\\", NewHeight);
-                MessageHandler.Log("[CreateTXSTPatch] [TXST Index: " + txstIndex + "] Height: " + Height, 0);
+                MessageHandler.Log(0, $"[CreateTXSTPatch] [TXST Index: {txstIndex}] Height: {Height}");
                 newTXSTObj.Height = Height;
             }
             string? NewEnvironment = Marshal.PtrToStringUni(slots[4]);
             if (NewEnvironment is not null)
             {
                 var Environment = RemovePrefixIfExists("textures\\", NewEnvironment);
-                MessageHandler.Log("[CreateTXSTPatch] [TXST Index: " + txstIndex + "] Environment: " + Environment, 0);
+                MessageHandler.Log(0, $"[CreateTXSTPatch] [TXST Index: {txstIndex}] Environment: {Environment}");
                 newTXSTObj.Environment = Environment;
             }
             string? NewEnvironmentMaskOrSubsurfaceTint = Marshal.PtrToStringUni(slots[5]);
             if (NewEnvironmentMaskOrSubsurfaceTint is not null)
             {
                 var EnvironmentMaskOrSubsurfaceTint = RemovePrefixIfExists("textures\\", NewEnvironmentMaskOrSubsurfaceTint);
-                MessageHandler.Log("[CreateTXSTPatch] [TXST Index: " + txstIndex + "] EnvironmentMaskOrSubsurfaceTint: " + EnvironmentMaskOrSubsurfaceTint, 0);
+                MessageHandler.Log(0, $"[CreateTXSTPatch] [TXST Index: {txstIndex}] EnvironmentMaskOrSubsurfaceTint: {EnvironmentMaskOrSubsurfaceTint}");
                 newTXSTObj.EnvironmentMaskOrSubsurfaceTint = EnvironmentMaskOrSubsurfaceTint;
             }
             string? NewMultilayer = Marshal.PtrToStringUni(slots[6]);
             if (NewMultilayer is not null)
             {
                 var Multilayer = RemovePrefixIfExists("textures\\", NewMultilayer);
-                MessageHandler.Log("[CreateTXSTPatch] [TXST Index: " + txstIndex + "] Multilayer: " + Multilayer, 0);
+                MessageHandler.Log(0, $"[CreateTXSTPatch] [TXST Index: {txstIndex}] Multilayer: {Multilayer}");
                 newTXSTObj.Multilayer = Multilayer;
             }
             string? NewBacklightMaskOrSpecular = Marshal.PtrToStringUni(slots[7]);
             if (NewBacklightMaskOrSpecular is not null)
             {
                 var BacklightMaskOrSpecular = RemovePrefixIfExists("textures\\", NewBacklightMaskOrSpecular);
-                MessageHandler.Log("[CreateTXSTPatch] [TXST Index: " + txstIndex + "] BacklightMaskOrSpecular: " + BacklightMaskOrSpecular, 0);
+                MessageHandler.Log(0, $"[CreateTXSTPatch] [TXST Index: {txstIndex}] BacklightMaskOrSpecular: {BacklightMaskOrSpecular}");
                 newTXSTObj.BacklightMaskOrSpecular = BacklightMaskOrSpecular;
             }
         }
@@ -1048,69 +1347,68 @@ public class PGMutagen
             var newTXSTObj = OutMod.TextureSets.AddNew(newFormKey);
 
             newTXSTObj.EditorID = NewEDIDStr;
-            MessageHandler.Log("[CreateNewTXSTPatch] [Alt Tex Index: " + AltTexHandle + "]", 0);
+            MessageHandler.Log(0, $"[CreateNewTXSTPatch] [Alt Tex Index: {AltTexHandle}]");
 
             // Define slot actions for assigning texture set slots
             string? NewDiffuse = Marshal.PtrToStringUni(slots[0]);
             if (!NewDiffuse.IsNullOrEmpty())
             {
                 var Diffuse = RemovePrefixIfExists("textures\\", NewDiffuse);
-                MessageHandler.Log("[CreateNewTXSTPatch] [Alt Tex Index: " + AltTexHandle + "] Diffuse: " + Diffuse, 0);
+                MessageHandler.Log(0, $"[CreateNewTXSTPatch] [Alt Tex Index: {AltTexHandle}] Diffuse: {Diffuse}");
                 newTXSTObj.Diffuse = Diffuse;
             }
             string? NewNormalOrGloss = Marshal.PtrToStringUni(slots[1]);
             if (!NewNormalOrGloss.IsNullOrEmpty())
             {
                 var NormalOrGloss = RemovePrefixIfExists("textures\\", NewNormalOrGloss);
-                MessageHandler.Log("[CreateNewTXSTPatch] [Alt Tex Index: " + AltTexHandle + "] NormalOrGloss: " + NormalOrGloss, 0);
+                MessageHandler.Log(0, $"[CreateNewTXSTPatch] [Alt Tex Index: {AltTexHandle}] NormalOrGloss: {NormalOrGloss}");
                 newTXSTObj.NormalOrGloss = NormalOrGloss;
             }
             string? NewGlowOrDetailMap = Marshal.PtrToStringUni(slots[2]);
             if (!NewGlowOrDetailMap.IsNullOrEmpty())
             {
                 var GlowOrDetailMap = RemovePrefixIfExists("textures\\", NewGlowOrDetailMap);
-                MessageHandler.Log("[CreateNewTXSTPatch] [Alt Tex Index: " + AltTexHandle + "] GlowOrDetailMap: " + GlowOrDetailMap, 0);
+                MessageHandler.Log(0, $"[CreateNewTXSTPatch] [Alt Tex Index: {AltTexHandle}] GlowOrDetailMap: {GlowOrDetailMap}");
                 newTXSTObj.GlowOrDetailMap = GlowOrDetailMap;
             }
             string? NewHeight = Marshal.PtrToStringUni(slots[3]);
             if (!NewHeight.IsNullOrEmpty())
             {
                 var Height = RemovePrefixIfExists("textures\\", NewHeight);
-                MessageHandler.Log("[CreateNewTXSTPatch] [Alt Tex Index: " + AltTexHandle + "] Height: " + Height, 0);
+                MessageHandler.Log(0, $"[CreateNewTXSTPatch] [Alt Tex Index: {AltTexHandle}] Height: {Height}");
                 newTXSTObj.Height = Height;
             }
             string? NewEnvironment = Marshal.PtrToStringUni(slots[4]);
             if (!NewEnvironment.IsNullOrEmpty())
             {
                 var Environment = RemovePrefixIfExists("textures\\", NewEnvironment);
-                MessageHandler.Log("[CreateNewTXSTPatch] [Alt Tex Index: " + AltTexHandle + "] Environment: " + Environment, 0);
+                MessageHandler.Log(0, $"[CreateNewTXSTPatch] [Alt Tex Index: {AltTexHandle}] Environment: {Environment}");
                 newTXSTObj.Environment = Environment;
             }
             string? NewEnvironmentMaskOrSubsurfaceTint = Marshal.PtrToStringUni(slots[5]);
             if (!NewEnvironmentMaskOrSubsurfaceTint.IsNullOrEmpty())
             {
                 var EnvironmentMaskOrSubsurfaceTint = RemovePrefixIfExists("textures\\", NewEnvironmentMaskOrSubsurfaceTint);
-                MessageHandler.Log("[CreateNewTXSTPatch] [Alt Tex Index: " + AltTexHandle + "] EnvironmentMaskOrSubsurfaceTint: " + EnvironmentMaskOrSubsurfaceTint, 0);
+                MessageHandler.Log(0, $"[CreateNewTXSTPatch] [Alt Tex Index: {AltTexHandle}] EnvironmentMaskOrSubsurfaceTint: {EnvironmentMaskOrSubsurfaceTint}");
                 newTXSTObj.EnvironmentMaskOrSubsurfaceTint = EnvironmentMaskOrSubsurfaceTint;
             }
             string? NewMultilayer = Marshal.PtrToStringUni(slots[6]);
             if (!NewMultilayer.IsNullOrEmpty())
             {
                 var Multilayer = RemovePrefixIfExists("textures\\", NewMultilayer);
-                MessageHandler.Log("[CreateNewTXSTPatch] [Alt Tex Index: " + AltTexHandle + "] Multilayer: " + Multilayer, 0);
+                MessageHandler.Log(0, $"[CreateNewTXSTPatch] [Alt Tex Index: {AltTexHandle}] Multilayer: {Multilayer}");
                 newTXSTObj.Multilayer = Multilayer;
             }
             string? NewBacklightMaskOrSpecular = Marshal.PtrToStringUni(slots[7]);
             if (!NewBacklightMaskOrSpecular.IsNullOrEmpty())
             {
                 var BacklightMaskOrSpecular = RemovePrefixIfExists("textures\\", NewBacklightMaskOrSpecular);
-                MessageHandler.Log("[CreateNewTXSTPatch] [Alt Tex Index: " + AltTexHandle + "] BacklightMaskOrSpecular: " + BacklightMaskOrSpecular, 0);
+                MessageHandler.Log(0, $"[CreateNewTXSTPatch] [Alt Tex Index: {AltTexHandle}] BacklightMaskOrSpecular: {BacklightMaskOrSpecular}");
                 newTXSTObj.BacklightMaskOrSpecular = BacklightMaskOrSpecular;
             }
 
-            TXSTObjs.Add(newTXSTObj);
-            *ResultTXSTId = TXSTObjs.Count - 1;
-            MessageHandler.Log("[CreateNewTXSTPatch] [Alt Tex Index: " + AltTexHandle + "] Created TXST with ID: " + *ResultTXSTId, 0);
+            *ResultTXSTId = AddTXSTObj(newTXSTObj);
+            MessageHandler.Log(0, $"[CreateNewTXSTPatch] [Alt Tex Index: {AltTexHandle}] Created TXST with ID: {*ResultTXSTId}");
 
             //SetModelAltTexManage(AltTexHandle, *ResultTXSTId);
         }
@@ -1124,7 +1422,7 @@ public class PGMutagen
     {
         try
         {
-            MessageHandler.Log("[SetModelAltTexManage] [Alt Tex Index: " + AltTexHandle + "] [TXST Index: " + TXSTHandle + "]", 0);
+            MessageHandler.Log(0, $"[SetModelAltTexManage] [Alt Tex Index: {AltTexHandle}] [TXST Index: {TXSTHandle}]");
 
             var AltTexObj = GetAltTexFromHandle(AltTexHandle);
 
@@ -1136,7 +1434,7 @@ public class PGMutagen
 
             if (AltTexObj.Item1.NewTexture.FormKey == TXSTObjs[TXSTHandle].FormKey)
             {
-                MessageHandler.Log("[SetModelAltTexManage] [Alt Tex Index: " + AltTexHandle + "] [TXST Index: " + TXSTHandle + "] TXST is the same as the current one", 0);
+                MessageHandler.Log(0, $"[SetModelAltTexManage] [Alt Tex Index: {AltTexHandle}] [TXST Index: {TXSTHandle}] TXST is the same as the current one");
                 return;
             }
 
@@ -1152,7 +1450,7 @@ public class PGMutagen
     [UnmanagedCallersOnly(EntryPoint = "SetModelAltTex", CallConvs = [typeof(CallConvCdecl)])]
     public static void SetModelAltTex([DNNE.C99Type("const int")] int AltTexHandle, [DNNE.C99Type("const int")] int TXSTHandle)
     {
-        MessageHandler.Log("[SetModelAltTex] [Alt Tex Index: " + AltTexHandle + "] [TXST Index: " + TXSTHandle + "]", 0);
+        MessageHandler.Log(0, $"[SetModelAltTex] [Alt Tex Index: {AltTexHandle}] [TXST Index: {TXSTHandle}]");
         SetModelAltTexManage(AltTexHandle, TXSTHandle);
     }
 
@@ -1161,7 +1459,7 @@ public class PGMutagen
     {
         try
         {
-            MessageHandler.Log("[Set3DIndex] [Alt Tex Index: " + AltTexHandle + "] [New Index: " + NewIndex + "]", 0);
+            MessageHandler.Log(0, $"[Set3DIndex] [Alt Tex Index: {AltTexHandle}] [New Index: {NewIndex}]");
 
             var AltTexObj = GetAltTexFromHandle(AltTexHandle);
 
@@ -1268,8 +1566,8 @@ public class PGMutagen
                 throw new Exception("Initialize must be called before GetAltTexFormID");
             }
 
-            var altTexObj = GetAltTexFromHandle(AltTexHandle);
-            var modelRecObj = ModelOriginals[altTexObj.Item3];
+            // read only, so this does not need the editable copy GetAltTexFromHandle would make
+            var modelRecObj = ModelOriginals[AltTexRefs[AltTexHandle].ModelRecId];
             var PluginNameStr = modelRecObj.FormKey.ModKey.FileName;
 
             try
@@ -1303,7 +1601,7 @@ public class PGMutagen
     {
         try
         {
-            *ModelRecHandle = AltTexRefs[AltTexHandle].Item3;
+            *ModelRecHandle = AltTexRefs[AltTexHandle].ModelRecCounter;
         }
         catch (Exception ex)
         {
@@ -1336,13 +1634,13 @@ public class PGMutagen
             // Check if NIFPath is different from ModelRec ignore case
             if (NIFPath.Equals(ModelRec.File, StringComparison.OrdinalIgnoreCase))
             {
-                MessageHandler.Log("[SetModelRecNIF] [Alt Tex Index: " + AltTexHandle + "] [NIF Path: " + NIFPath + "] NIF Path is the same as the current one", 0);
+                MessageHandler.Log(0, $"[SetModelRecNIF] [Alt Tex Index: {AltTexHandle}] [NIF Path: {NIFPath}] NIF Path is the same as the current one");
                 return;
             }
 
             ModelRec.File = NIFPath;
             ModifiedModeledRecords.Add(AltTexObj.Item3);
-            MessageHandler.Log("[SetModelRecNIF] [Alt Tex Index: " + AltTexHandle + "] [NIF Path: " + NIFPath + "]", 0);
+            MessageHandler.Log(0, $"[SetModelRecNIF] [Alt Tex Index: {AltTexHandle}] [NIF Path: {NIFPath}]");
         }
         catch (Exception ex)
         {
@@ -1354,11 +1652,12 @@ public class PGMutagen
 
     private static (AlternateTexture?, IModel?, int) GetAltTexFromHandle(int AltTexHandle)
     {
-        var oldAltTex = AltTexRefs[AltTexHandle].Item1;
-        var oldType = AltTexRefs[AltTexHandle].Item4;
-        var ModeledRecordId = AltTexRefs[AltTexHandle].Item2;
+        var oldAltTex = GetAltTex(AltTexRefs[AltTexHandle]);
+        var oldType = AltTexRefs[AltTexHandle].Type;
+        var ModeledRecordId = AltTexRefs[AltTexHandle].ModelRecId;
 
-        var ModeledRecord = ModelCopies[ModeledRecordId];
+        // the original is never modified, so positions found in it are valid in the editable copy
+        var ModeledRecord = ModelOriginals[ModeledRecordId];
 
         // loop through alternate textures to find the one to replace
         var modelElems = GetModelElems(ModeledRecord);
@@ -1384,7 +1683,13 @@ public class PGMutagen
                     alternateTexture.NewTexture.FormKey.ID.ToString() == oldAltTex.NewTexture.FormKey.ID.ToString())
                 {
                     // Found the one to update
-                    var EditableModelObj = GetModelElems(ModelCopiesEditable[ModeledRecordId])[i];
+                    var EditableRecord = GetEditableModelRecord(ModeledRecordId);
+                    if (EditableRecord is null)
+                    {
+                        return (null, null, ModeledRecordId);
+                    }
+
+                    var EditableModelObj = GetModelElems(EditableRecord)[i];
                     var EditableAltTexObj = EditableModelObj.Item1.AlternateTextures?[j];
                     return (EditableAltTexObj, EditableModelObj.Item1, ModeledRecordId);
                 }
@@ -1394,6 +1699,59 @@ public class PGMutagen
         return (null, null, ModeledRecordId);
     }
 
+    private static IMajorRecord? GetEditableModelRecord(int ModeledRecordId)
+    {
+        if (ModelCopiesEditable.TryGetValue(ModeledRecordId, out var EditableRecord))
+        {
+            return EditableRecord;
+        }
+
+        var OriginalRecord = ModelOriginals[ModeledRecordId];
+        try
+        {
+            EditableRecord = OriginalRecord.DeepCopy();
+        }
+        catch (Exception)
+        {
+            MessageHandler.Log(3, $"Failed to copy record: {GetRecordDesc(OriginalRecord)}");
+            return null;
+        }
+
+        ModelCopiesEditable[ModeledRecordId] = EditableRecord;
+        return EditableRecord;
+    }
+
+    private static int AddTXSTObj(ITextureSetGetter txstObj)
+    {
+        var txstId = TXSTObjs.Add(txstObj.FormKey, txstObj);
+
+        // first index wins, like the linear search this replaces
+        TXSTIndex.TryAdd(txstObj.FormKey, txstId);
+        return txstId;
+    }
+
+    private static IAlternateTextureGetter GetAltTex(AltTexRef altTexRef)
+    {
+        if (altTexRef.AltTex is null)
+        {
+            var modelElem = GetModelElems(ModelOriginals[altTexRef.ModelRecId])[altTexRef.ModelElemIdx];
+            altTexRef.AltTex = modelElem.Item1.AlternateTextures?[altTexRef.AltTexIdx]
+                ?? throw new Exception("Alternate texture of record index entry does not exist: " + GetRecordDesc(ModelOriginals[altTexRef.ModelRecId]));
+        }
+
+        return altTexRef.AltTex;
+    }
+
+    private static T ResolveRecord<T>(FormKey formKey) where T : class, IMajorRecordGetter
+    {
+        if (Env is null)
+        {
+            throw new Exception("Initialize must be called before records are resolved");
+        }
+
+        return Env.LinkCache.Resolve<T>(formKey);
+    }
+
     private static string GetRecordDesc(IMajorRecordGetter rec)
     {
         return rec.FormKey.ModKey.FileName + " / " + rec.FormKey.ID.ToString("X6");
@@ -1416,6 +1774,18 @@ public class PGMutagen
         }
         return str;
     }
+
+    // Lowercases A-Z only, like ParallaxGenUtil::toLowerASCII, so NIF names key the same on both sides of the bridge
+    private static string ToLowerASCII(string str)
+    {
+        return string.Create(str.Length, str, (chars, source) =>
+        {
+            for (int i = 0; i < source.Length; i++)
+            {
+                chars[i] = source[i] is >= 'A' and <= 'Z' ? (char)(source[i] + ('a' - 'A')) : source[i];
+            }
+        });
+    }
 }
 
 
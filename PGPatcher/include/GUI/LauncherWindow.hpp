@@ -84,6 +84,7 @@ private:
     void onOutputLocationChange(wxCommandEvent& event);
 
     wxCheckBox* m_outputZipCheckbox;
+    wxCheckBox* m_outputArchiveCheckbox;
     void onOutputZipChange(wxCommandEvent& event);
 
     // Advanced
@@ -11,9 +11,11 @@
 #include <wx/wx.h>
 
 #include <string>
-#include <unordered_set>
+#include <unordered_map>
 #include <vector>
 
+#include "PGConflictGraph.hpp"
+
 /**
  * @brief wxDialog that allows the user to sort the mods in the order they want
  */
@@ -26,8 +28,8 @@ private:
     //
     // Item Highlighting
     //
-    std::unordered_map<std::wstring, std::unordered_set<std::wstring>>
-        m_conflictsMap; /** Stores the conflicts for each mod for highlighting */
+    PGConflictGraph m_conflicts; /** Stores the conflicts for each mod and the row of each mod for highlighting */
+    std::vector<size_t> m_highlightedMods; /** Stores the IDs of the mods that are highlighted in yellow */
     std::unordered_map<std::wstring, wxColour>
         m_originalBackgroundColors; /** Stores the original highlight of elements to be able to restore it later */
 
@@ -54,11 +56,10 @@ public:
      * @param mods vector of mod strings
      * @param shaders vector of shader strings
      * @param isNew vector of bools indicating whether each mod is new or not (for highlighting)
-     * @param conflicts map that stores mod conflicts for highlighting
+     * @param conflicts graph that stores mod conflicts for highlighting
      */
     ModSortDialog(const std::vector<std::wstring>& mods, const std::vector<std::wstring>& shaders,
-        const std::vector<bool>& isNew,
-        const std::unordered_map<std::wstring, std::unordered_set<std::wstring>>& conflicts);
+        const std::vector<bool>& isNew, PGConflictGraph conflicts);
 
     /**
      * @brief Get the list of sorted mods (meant to be called after the user presses okay)
@@ -140,11 +141,11 @@ private:
     auto calculateColumnWidth(int colIndex) -> int;
 
     /**
-     * @brief Highlights the conflicting items for a selected mod
+     * @brief Highlights the conflicting items for a selected row
      *
-     * @param selectedMod Mod that is selected
+     * @param selectedRow Row that is selected
      */
-    void highlightConflictingItems(const std::wstring& selectedMod);
+    void highlightConflictingItems(const long& selectedRow);
 
     /**
      * @brief Clear all yellow highlights from the list
@@ -160,8 +161,11 @@ private:
 
     /**
      * @brief Resets indices for the list after drag or sort
+     *
+     * @param first First row to reset
+     * @param last One past the last row to reset, -1 for the end of the list
      */
-    void resetIndices();
+    void resetIndices(const long& first = 0, const long& last = -1);
 
     /**
      * @brief Reverses the order of the list
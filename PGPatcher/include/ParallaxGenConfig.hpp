@@ -47,8 +47,12 @@ public:
         struct Output {
             std::filesystem::path dir;
             bool zip = true;
+            bool archive = false;
 
-            auto operator==(const Output& other) const -> bool { return dir == other.dir && zip == other.zip; }
+            auto operator==(const Output& other) const -> bool
+            {
+                return dir == other.dir && zip == other.zip && archive == other.archive;
+            }
         } Output;
 
         // Advanced
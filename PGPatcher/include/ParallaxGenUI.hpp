@@ -15,7 +15,7 @@
 
 #include "ParallaxGenConfig.hpp"
 
-#include "NIFUtil.hpp"
+#include "PGConflictGraph.hpp"
 
 class ParallaxGenUI {
 public:
@@ -35,12 +35,10 @@ public:
     /**
      * @brief Shows the mod selection dialog to the user (Hangs thread until user presses okay)
      *
-     * @param Conflicts Mod conflict map
+     * @param Conflicts Mod conflict graph
      * @param ExistingMods Mods that already exist in the order
      * @return std::vector<std::wstring> Vector of mods sorted by the user
      */
-    static auto selectModOrder(
-        const std::unordered_map<std::wstring,
-            std::tuple<std::set<NIFUtil::ShapeShader>, std::unordered_set<std::wstring>>>& conflicts,
-        const std::vector<std::wstring>& existingMods) -> std::vector<std::wstring>;
+    static auto selectModOrder(const PGConflictGraph& conflicts, const std::vector<std::wstring>& existingMods)
+        -> std::vector<std::wstring>;
 };
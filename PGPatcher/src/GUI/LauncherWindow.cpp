@@ -159,6 +159,12 @@ LauncherWindow::LauncherWindow(ParallaxGenConfig& pgc)
     m_outputZipCheckbox->SetToolTip("Zip the output folder after processing");
 
     outputSizer->Add(m_outputZipCheckbox, 0, wxALL, BORDER_SIZE);
+
+    m_outputArchiveCheckbox = new wxCheckBox(this, wxID_ANY, "Pack Output into BSAs");
+    m_outputArchiveCheckbox->SetToolTip(
+        "Pack output meshes and textures into BSA archives loaded by an empty ParallaxGen_Archive.esp plugin");
+
+    outputSizer->Add(m_outputArchiveCheckbox, 0, wxALL, BORDER_SIZE);
     leftSizer->Add(outputSizer, 0, wxEXPAND | wxALL, BORDER_SIZE);
 
     //
@@ -525,6 +531,7 @@ void LauncherWindow::loadConfig()
     // Output
     m_outputLocationTextbox->SetValue(initParams.Output.dir.wstring());
     m_outputZipCheckbox->SetValue(initParams.Output.zip);
+    m_outputArchiveCheckbox->SetValue(initParams.Output.archive);
 
     // Advanced
     m_advancedOptionsCheckbox->SetValue(initParams.advanced);
@@ -893,6 +900,7 @@ auto LauncherWindow::getParams() -> ParallaxGenConfig::PGParams
     // Output
     params.Output.dir = m_outputLocationTextbox->GetValue().ToStdWstring();
     params.Output.zip = m_outputZipCheckbox->GetValue();
+    params.Output.archive = m_outputArchiveCheckbox->GetValue();
 
     // Advanced
     params.advanced = m_advancedOptionsCheckbox->GetValue();
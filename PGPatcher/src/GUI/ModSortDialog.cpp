@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <utility>
 
 #include "GUI/ModSortDialog.hpp"
 #include "ParallaxGenHandlers.hpp"
@@ -11,11 +12,11 @@ using namespace std;
 
 // class ModSortDialog
 ModSortDialog::ModSortDialog(const std::vector<std::wstring>& mods, const std::vector<std::wstring>& shaders,
-    const std::vector<bool>& isNew, const std::unordered_map<std::wstring, std::unordered_set<std::wstring>>& conflicts)
+    const std::vector<bool>& isNew, PGConflictGraph conflicts)
     : wxDialog(nullptr, wxID_ANY, "Set Mod Priority", wxDefaultPosition, wxSize(DEFAULT_WIDTH, DEFAULT_HEIGHT),
           wxDEFAULT_DIALOG_STYLE | wxSTAY_ON_TOP | wxRESIZE_BORDER)
     , m_scrollTimer(this)
-    , m_conflictsMap(conflicts)
+    , m_conflicts(std::move(conflicts))
     , m_sortAscending(true)
 {
     Bind(wxEVT_TIMER, &ModSortDialog::onTimer, this, m_scrollTimer.GetId());
@@ -47,6 +48,7 @@ ModSortDialog::ModSortDialog(const std::vector<std::wstring>& mods, const std::v
             m_originalBackgroundColors[mods[i]] = *wxWHITE; // Store the original color using the mod name
         }
     }
+    m_conflicts.setOrder(mods);
 
     // Calculate minimum width for each column
     const int col1Width = calculateColumnWidth(0);
@@ -98,12 +100,11 @@ ModSortDialog::ModSortDialog(const std::vector<std::wstring>& mods, const std::v
 void ModSortDialog::onItemSelected(wxListEvent& event)
 {
     const long index = event.GetIndex();
-    const std::wstring selectedMod = m_listCtrl->GetItemText(index).ToStdWstring();
 
     if (index == -1) {
         clearAllHighlights(); // Clear all highlights when no item is selected
     } else {
-        highlightConflictingItems(selectedMod); // Highlight conflicts for the selected mod
+        highlightConflictingItems(index); // Highlight conflicts for the selected mod
     }
 }
 
@@ -127,39 +128,38 @@ void ModSortDialog::onItemDeselected(wxListEvent& event)
 
 void ModSortDialog::clearAllHighlights()
 {
-    for (long i = 0; i < m_listCtrl->GetItemCount(); ++i) {
-        const std::wstring itemText = m_listCtrl->GetItemText(i).ToStdWstring();
-        auto it = m_originalBackgroundColors.find(itemText);
+    // Only the highlighted rows need to be restored
+    for (const auto& id : m_highlightedMods) {
+        const auto row = static_cast<long>(m_conflicts.getRow(id));
+        auto it = m_originalBackgroundColors.find(m_conflicts.getName(id));
         if (it != m_originalBackgroundColors.end()) {
-            m_listCtrl->SetItemBackgroundColour(i, it->second); // Restore original color
+            m_listCtrl->SetItemBackgroundColour(row, it->second); // Restore original color
         } else {
-            m_listCtrl->SetItemBackgroundColour(i, *wxWHITE); // Fallback to white
+            m_listCtrl->SetItemBackgroundColour(row, *wxWHITE); // Fallback to white
         }
     }
+
+    m_highlightedMods.clear();
 }
 
-void ModSortDialog::highlightConflictingItems(const std::wstring& selectedMod)
+void ModSortDialog::highlightConflictingItems(const long& selectedRow)
 {
     // Clear previous highlights and restore original colors
-    for (long i = 0; i < m_listCtrl->GetItemCount(); ++i) {
-        const std::wstring itemText = m_listCtrl->GetItemText(i).ToStdWstring();
-        auto it = m_originalBackgroundColors.find(itemText);
-        if (it != m_originalBackgroundColors.end()) {
-            m_listCtrl->SetItemBackgroundColour(i, it->second); // Restore original color
-        } else {
-            m_listCtrl->SetItemBackgroundColour(i, *wxWHITE); // Fallback to white if not found
-        }
+    clearAllHighlights();
+
+    if (selectedRow < 0 || selectedRow >= m_listCtrl->GetItemCount()) {
+        return;
     }
 
-    // Highlight selected item and its conflicts
-    auto conflictSet = m_conflictsMap.find(selectedMod);
-    if (conflictSet != m_conflictsMap.end()) {
-        for (long i = 0; i < m_listCtrl->GetItemCount(); ++i) {
-            const std::wstring itemText = m_listCtrl->GetItemText(i).ToStdWstring();
-            if (itemText == selectedMod || conflictSet->second.contains(itemText)) {
-                m_listCtrl->SetItemBackgroundColour(i, *wxYELLOW); // Highlight color
-            }
-        }
+    // Highlight selected item and its conflicts, this only visits the rows of the conflicting mods
+    const auto row = static_cast<size_t>(selectedRow);
+    m_highlightedMods.push_back(m_conflicts.getOrder()[row]);
+    for (const auto& conflictRow : m_conflicts.getConflictRows(row)) {
+        m_highlightedMods.push_back(m_conflicts.getOrder()[conflictRow]);
+    }
+
+    for (const auto& id : m_highlightedMods) {
+        m_listCtrl->SetItemBackgroundColour(static_cast<long>(m_conflicts.getRow(id)), *wxYELLOW); // Highlight color
     }
 }
 
@@ -193,6 +193,11 @@ void ModSortDialog::onMouseLeftUp(wxMouseEvent& event)
         // Sort indices to maintain the order during removal
         std::ranges::sort(m_draggedIndices);
 
+        // Move the rows in the conflict graph, only rows between the dragged items and the target change
+        const auto [firstChanged, lastChanged]
+            = m_conflicts.moveRows(std::vector<size_t>(m_draggedIndices.begin(), m_draggedIndices.end()),
+                static_cast<size_t>(m_targetLineIndex));
+
         // Capture item data for all selected items
         std::vector<std::pair<wxString, wxString>> itemData;
         std::vector<wxColour> backgroundColors;
@@ -221,7 +226,7 @@ void ModSortDialog::onMouseLeftUp(wxMouseEvent& event)
         }
 
         // reset priority values
-        resetIndices();
+        resetIndices(static_cast<long>(firstChanged), static_cast<long>(lastChanged));
 
         // Reset indices to prepare for the next drag
         m_draggedIndices.clear();
@@ -336,10 +341,11 @@ void ModSortDialog::drawDropIndicator(int targetIndex)
     }
 }
 
-void ModSortDialog::resetIndices()
+void ModSortDialog::resetIndices(const long& first, const long& last)
 {
-    // loop through each item in list and set col 3
-    for (long i = 0; i < m_listCtrl->GetItemCount(); ++i) {
+    // loop through each item in range and set col 3
+    const long end = last < 0 ? m_listCtrl->GetItemCount() : std::min(last, m_listCtrl->GetItemCount());
+    for (long i = first; i < end; ++i) {
         if (m_sortAscending) {
             m_listCtrl->SetItem(i, 2, std::to_string(i));
         } else {
@@ -388,8 +394,10 @@ void ModSortDialog::reverseListOrder()
         }
     }
 
-    // Clear the m_listCtrl
+    // Clear the m_listCtrl, highlights are not restored
     m_listCtrl->DeleteAllItems();
+    m_highlightedMods.clear();
+    m_conflicts.reverseOrder();
 
     // Insert items back in reverse order and set background colors
     for (size_t i = 0; i < items.size(); ++i) {
@@ -11,7 +11,6 @@
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/algorithm/string/split.hpp>
 #include <mutex>
-#include <spdlog/spdlog.h>
 
 #include <nlohmann/json.hpp>
 #include <nlohmann/json_fwd.hpp>
@@ -147,6 +146,9 @@ auto ParallaxGenConfig::addConfigJSON(const nlohmann::json& j) -> void
         if (paramJ.contains("output") && paramJ["output"].contains("zip")) {
             paramJ["output"]["zip"].get_to<bool>(m_params.Output.zip);
         }
+        if (paramJ.contains("output") && paramJ["output"].contains("archive")) {
+            paramJ["output"]["archive"].get_to<bool>(m_params.Output.archive);
+        }
 
         // "advanced"
         if (paramJ.contains("advanced")) {
@@ -457,6 +459,7 @@ auto ParallaxGenConfig::getUserConfigJSON() const -> nlohmann::json
     // "output"
     j["params"]["output"]["dir"] = utf16toUTF8(m_params.Output.dir.wstring());
     j["params"]["output"]["zip"] = m_params.Output.zip;
+    j["params"]["output"]["archive"] = m_params.Output.archive;
 
     // "advanced"
     j["params"]["advanced"] = m_params.advanced;
@@ -518,7 +521,7 @@ void ParallaxGenConfig::saveUserConfig()
         outFile << j.dump(2) << "\n";
         outFile.close();
     } catch (const exception& e) {
-        spdlog::error("Failed to save user config: {}", e.what());
+        Logger::error("Failed to save user config: {}", e.what());
     }
 }
 
@@ -532,6 +535,7 @@ auto ParallaxGenConfig::PGParams::getString() const -> wstring
     outStr += L"MO2Profile: " + ModManager.mo2Profile + L"\n";
     outStr += L"OutputDir: " + Output.dir.wstring() + L"\n";
     outStr += L"ZipOutput: " + to_wstring(static_cast<int>(Output.zip)) + L"\n";
+    outStr += L"ArchiveOutput: " + to_wstring(static_cast<int>(Output.archive)) + L"\n";
     outStr += L"Multithread: " + to_wstring(static_cast<int>(Processing.multithread)) + L"\n";
     outStr += L"HighMem: " + to_wstring(static_cast<int>(Processing.highMem)) + L"\n";
     outStr += L"BSA: " + to_wstring(static_cast<int>(Processing.bsa)) + L"\n";
@@ -1,7 +1,9 @@
 #include "BethesdaGame.hpp"
 #include "Logger.hpp"
 #include "ModManagerDirectory.hpp"
+#include "PGArchiveWriter.hpp"
 #include "PGDiag.hpp"
+#include "PGMemoryBudget.hpp"
 #include "ParallaxGen.hpp"
 #include "ParallaxGenConfig.hpp"
 #include "ParallaxGenD3D.hpp"
@@ -13,8 +15,7 @@
 #include "ParallaxGenUtil.hpp"
 #include "ParallaxGenWarnings.hpp"
 #include "patchers/PatcherMeshPostFixSSS.hpp"
-#include "patchers/PatcherMeshPreFixMeshLighting.hpp"
-#include "patchers/PatcherMeshPreFixTextureSlotCount.hpp"
+#include "patchers/PatcherMeshPreRules.hpp"
 #include "patchers/PatcherMeshShaderComplexMaterial.hpp"
 #include "patchers/PatcherMeshShaderDefault.hpp"
 #include "patchers/PatcherMeshShaderTransformParallaxToCM.hpp"
@@ -54,6 +55,7 @@ using namespace std;
 struct ParallaxGenCLIArgs {
     int verbosity = 0;
     bool autostart = false;
+    bool textureIndex = false;
 };
 
 namespace {
@@ -141,9 +143,9 @@ void mainRunner(ParallaxGenCLIArgs& args, const filesystem::path& exePath)
     auto mmd = ModManagerDirectory(params.ModManager.type);
     auto pgd = ParallaxGenDirectory(&bg, params.Output.dir, &mmd);
     auto pgd3d = ParallaxGenD3D(&pgd, exePath / "shaders");
-    auto pg = ParallaxGen(params.Output.dir, &pgd, &pgd3d, params.PostPatcher.optimizeMeshes);
+    auto pg = ParallaxGen(params.Output.dir, &pgd, params.PostPatcher.optimizeMeshes);
 
-    Patcher::loadStatics(pgd, pgd3d);
+    Patcher::loadStatics(pgd, &pgd3d);
 
     // Check if GPU needs to be initialized
     Logger::info("Initializing GPU");
@@ -200,7 +202,7 @@ void mainRunner(ParallaxGenCLIArgs& args, const filesystem::path& exePath)
         Logger::info("Initializing plugin patching");
         ParallaxGenPlugin::loadStatics(&pgd);
         ParallaxGenPlugin::initialize(bg, exePath);
-        ParallaxGenPlugin::populateObjs();
+        ParallaxGenPlugin::populateObjs(exePath / "cache");
 
         if (filesystem::exists(txstFormIDCacheFile)) {
             ifstream f(txstFormIDCacheFile);
@@ -234,8 +236,13 @@ void mainRunner(ParallaxGenCLIArgs& args, const filesystem::path& exePath)
                          "re-running.");
     }
 
+    // Bound caches and in-flight buffers by available memory
+    PGMemoryBudget::setBudget(PGMemoryBudget::getDefaultBudget());
+    Logger::debug("Memory budget: {} MB", PGMemoryBudget::getBudget() / (1024 * 1024));
+
     // Init file map
     pgd.populateFileMap(params.Processing.bsa);
+    pgd.getTextureIndex().setEnabled(args.textureIndex);
 
     // Map files
     pgd.mapFiles(params.MeshRules.blockList, params.MeshRules.allowList, params.TextureRules.textureMaps,
@@ -249,13 +256,18 @@ void mainRunner(ParallaxGenCLIArgs& args, const filesystem::path& exePath)
 
     // Create patcher factory
     PatcherUtil::PatcherMeshSet meshPatchers;
+    auto meshRules = nlohmann::json::array();
     if (params.PrePatcher.fixMeshLighting) {
-        Logger::debug("Adding Mesh Lighting Fix pre-patcher");
-        meshPatchers.prePatchers.emplace_back(PatcherMeshPreFixMeshLighting::getFactory());
+        Logger::debug("Adding Mesh Lighting Fix rule");
+        meshRules.push_back(PatcherMeshPreRules::getBuiltinRule("FixMeshLighting"));
     }
     if (params.ShaderPatcher.parallax || params.ShaderPatcher.complexMaterial || params.ShaderPatcher.truePBR) {
         // fix slots only needed for shader patchers
-        meshPatchers.prePatchers.emplace_back(PatcherMeshPreFixTextureSlotCount::getFactory());
+        meshRules.push_back(PatcherMeshPreRules::getBuiltinRule("FixTextureSlotCount"));
+    }
+    if (!meshRules.empty()) {
+        PatcherMeshPreRules::loadStatics(meshRules);
+        meshPatchers.prePatchers.emplace_back(PatcherMeshPreRules::getFactory());
     }
 
     meshPatchers.shaderPatchers.emplace(
@@ -351,7 +363,7 @@ void mainRunner(ParallaxGenCLIArgs& args, const filesystem::path& exePath)
 
     // Save diag JSON
     if (params.Processing.diagnostics) {
-        spdlog::info("Saving diag JSON file...");
+        Logger::info("Saving diag JSON file...");
         const filesystem::path diffJSONPath = params.Output.dir / "ParallaxGen_DIAG.json";
         ofstream diagJSONFile(diffJSONPath);
         diagJSONFile << PGDiag::getJSON().dump(2, ' ', false, nlohmann::detail::error_handler_t::replace) << "\n";
@@ -360,6 +372,14 @@ void mainRunner(ParallaxGenCLIArgs& args, const filesystem::path& exePath)
 
     deployAssets(params.Output.dir, exePath);
 
+    // pack meshes and textures into BSAs
+    if (params.Output.archive) {
+        Logger::info("Packing output into BSA archives...");
+        PGArchiveWriter archiveWriter(params.Output.dir, bg.getGameType());
+        const auto archives = archiveWriter.writeArchives(params.Processing.multithread);
+        Logger::info("Wrote {} BSA archives", archives.size());
+    }
+
     // archive
     if (params.Output.zip) {
         pg.zipMeshes();
@@ -372,6 +392,13 @@ void mainRunner(ParallaxGenCLIArgs& args, const filesystem::path& exePath)
     f << ParallaxGenPlugin::getTXSTCache().dump(2, ' ', false, nlohmann::detail::error_handler_t::replace) << "\n";
     f.close();
 
+    // Texture index, queried with "PGTools query"
+    if (args.textureIndex) {
+        Logger::info("Saving texture index...");
+        pgd.getTextureIndex().resolveMods([&pgd](const wstring& path) { return pgd.getMod(path); });
+        pgd.getTextureIndex().save(exePath / "cache" / "textureIndex.json");
+    }
+
     const auto endTime = chrono::high_resolution_clock::now();
     timeTaken += chrono::duration_cast<chrono::seconds>(endTime - startTime).count();
 
@@ -385,6 +412,8 @@ void addArguments(CLI::App& app, ParallaxGenCLIArgs& args)
         "Verbosity level -v for DEBUG data or -vv for TRACE data "
         "(warning: TRACE data is very verbose)");
     app.add_flag("--autostart", args.autostart, "Start generation without user input");
+    app.add_flag("--texture-index", args.textureIndex,
+        "Write a texture index to cache/textureIndex.json for use with the PGTools query command");
 }
 
 void initLogger(const filesystem::path& logpath, const ParallaxGenCLIArgs& args)
@@ -411,14 +440,14 @@ void initLogger(const filesystem::path& logpath, const ParallaxGenCLIArgs& args)
     if (args.verbosity >= 1) {
         spdlog::set_level(spdlog::level::debug);
         spdlog::flush_on(spdlog::level::debug);
-        spdlog::debug("DEBUG logging enabled");
+        Logger::debug("DEBUG logging enabled");
     }
 
     if (args.verbosity >= 2) {
         spdlog::set_level(spdlog::level::trace);
         consoleSink->set_level(spdlog::level::debug);
         spdlog::flush_on(spdlog::level::trace);
-        spdlog::trace("TRACE logging enabled");
+        Logger::trace("TRACE logging enabled");
     }
 }
 }
@@ -473,6 +502,11 @@ auto main(int ArgC, char** ArgV) -> int
     const filesystem::path logPath = logDir / "ParallaxGen.log";
     initLogger(logPath, args);
 
+    // Write log messages from a background thread, pending messages are written on exit. Registered after
+    // exitBlocking so it runs first.
+    Logger::startAsync();
+    atexit(Logger::stopAsync);
+
     // Main Runner (Catches all exceptions)
     CPPTRACE_TRY { mainRunner(args, exePath); }
     CPPTRACE_CATCH(const exception& e)
@@ -2,46 +2,55 @@
 
 #include <spdlog/spdlog.h>
 
+#ifdef _WIN32
 #include <windows.h>
+#endif
 
 #include <cpptrace/from_current.hpp>
 
+#include <stdexcept>
 #include <string>
 #include <unordered_set>
 
+#include "Logger.hpp"
+#include "PGMemoryBudget.hpp"
+#include "PGPlatform.hpp"
+#include "PGTextureIndex.hpp"
 #include "ParallaxGen.hpp"
-#include "ParallaxGenD3D.hpp"
 #include "ParallaxGenDirectory.hpp"
 #include "ParallaxGenRunner.hpp"
+#include "ParallaxGenUtil.hpp"
 #include "ParallaxGenWarnings.hpp"
 
 #include "patchers/PatcherMeshGlobalParticleLightsToLP.hpp"
-#include "patchers/PatcherMeshPostFixSSS.hpp"
-#include "patchers/PatcherMeshPreFixMeshLighting.hpp"
-#include "patchers/PatcherMeshPreFixTextureSlotCount.hpp"
+#include "patchers/PatcherMeshPreRules.hpp"
 #include "patchers/PatcherMeshShaderComplexMaterial.hpp"
-#include "patchers/PatcherMeshShaderTransformParallaxToCM.hpp"
 #include "patchers/PatcherMeshShaderTruePBR.hpp"
 #include "patchers/PatcherMeshShaderVanillaParallax.hpp"
+#include "patchers/base/Patcher.hpp"
+#include "patchers/base/PatcherUtil.hpp"
+
+// GPU patchers, built on Windows only
+#ifdef _WIN32
+#include "ParallaxGenD3D.hpp"
+#include "patchers/PatcherMeshPostFixSSS.hpp"
+#include "patchers/PatcherMeshShaderTransformParallaxToCM.hpp"
 #include "patchers/PatcherTextureGlobalConvertToHDR.hpp"
 #include "patchers/PatcherTextureHookConvertToCM.hpp"
 #include "patchers/PatcherTextureHookFixSSS.hpp"
-#include "patchers/base/Patcher.hpp"
-#include "patchers/base/PatcherUtil.hpp"
+#endif
 
 using namespace std;
 
 namespace {
 auto getExecutablePath() -> filesystem::path
 {
-    array<wchar_t, MAX_PATH> buffer {};
-    if (GetModuleFileNameW(nullptr, buffer.data(), MAX_PATH) == 0) {
-        cerr << "Error getting executable path: " << GetLastError() << "\n";
+    filesystem::path outPath = PGPlatform::getExecutablePath();
+    if (outPath.empty()) {
+        cerr << "Error getting executable path\n";
         exit(1);
     }
 
-    filesystem::path outPath = filesystem::path(buffer.data());
-
     if (filesystem::exists(outPath)) {
         return outPath;
     }
@@ -63,23 +72,106 @@ struct PGToolsCLIArgs {
         filesystem::path output = "ParallaxGen_Output";
         bool mapTexturesFromMeshes = false;
         bool highMem = false;
+        filesystem::path index;
+        ParallaxGen::MeshPipelineSizes meshPipeline;
     } Patch;
+
+    struct Query {
+        CLI::App* subCommand = nullptr;
+        filesystem::path index;
+        string texture;
+        string mod;
+        string shape;
+    } Query;
 };
 
+void runQuery(const PGToolsCLIArgs& args)
+{
+    PGTextureIndex index;
+    index.load(args.Query.index);
+
+    if (!args.Query.texture.empty()) {
+        // who uses a texture
+        const auto users = index.getUsers(ParallaxGenUtil::utf8toUTF16(args.Query.texture));
+        Logger::info("{} shape slots use {}", users.size(), args.Query.texture);
+        for (const auto& user : users) {
+            Logger::info(L"  - {} | shape {} | slot {}", user.mesh, user.shapeIndex, static_cast<int>(user.slot));
+        }
+    }
+
+    if (!args.Query.mod.empty()) {
+        // what a mod affects
+        const auto impact = index.getModImpact(ParallaxGenUtil::utf8toUTF16(args.Query.mod));
+        Logger::info("Mod \"{}\" provides {} used textures, affects {} meshes and wins {} shapes", args.Query.mod,
+            impact.textures.size(), impact.meshes.size(), impact.wonShapes.size());
+        for (const auto& texture : impact.textures) {
+            Logger::info(L"  texture: {}", texture);
+        }
+        for (const auto& mesh : impact.meshes) {
+            Logger::info(L"  mesh: {}", mesh);
+        }
+        for (const auto& [mesh, shapeIndex] : impact.wonShapes) {
+            Logger::info(L"  shape: {} | {}", mesh, shapeIndex);
+        }
+    }
+
+    if (!args.Query.shape.empty()) {
+        // why a shape got its shader, shape is given as <mesh>:<shape index>
+        const auto sep = args.Query.shape.rfind(':');
+        if (sep == string::npos) {
+            Logger::error("Shape must be given as <mesh>:<shape index>");
+            return;
+        }
+
+        const auto mesh = ParallaxGenUtil::utf8toUTF16(args.Query.shape.substr(0, sep));
+        int shapeIndex = -1;
+        try {
+            shapeIndex = stoi(args.Query.shape.substr(sep + 1));
+        } catch (const invalid_argument&) {
+            Logger::error("Shape index must be a number, shape must be given as <mesh>:<shape index>");
+            return;
+        } catch (const out_of_range&) {
+            Logger::error("Shape index is out of range, shape must be given as <mesh>:<shape index>");
+            return;
+        }
+        const auto result = index.getShapeResult(mesh, shapeIndex);
+        if (!result.has_value()) {
+            Logger::info("No shader patcher matched {}", args.Query.shape);
+            return;
+        }
+
+        Logger::info(L"Winner: {} from mod \"{}\" (matched {})",
+            ParallaxGenUtil::utf8toUTF16(NIFUtil::getStrFromShader(result->winner.shader)), result->winner.mod,
+            result->winner.matchedPath);
+        Logger::info("Candidates:");
+        for (const auto& candidate : result->candidates) {
+            Logger::info(L"  - {} from mod \"{}\" (matched {})",
+                ParallaxGenUtil::utf8toUTF16(NIFUtil::getStrFromShader(candidate.shader)), candidate.mod,
+                candidate.matchedPath);
+        }
+    }
+}
+
 void mainRunner(PGToolsCLIArgs& args)
 {
     // Welcome Message
-    spdlog::info("Welcome to PGTools version {}!", PG_VERSION);
+    Logger::info("Welcome to PGTools version {}!", PG_VERSION);
 
     // Get EXE path
     const auto exePath = getExecutablePath().parent_path();
 
     // Test message if required
     if (PG_TEST_VERSION > 0) {
-        spdlog::warn(
+        Logger::warn(
             "This is an EXPERIMENTAL development build of ParallaxGen: {} Test Build {}", PG_VERSION, PG_TEST_VERSION);
     }
 
+    // Check if query subcommand was used
+    if (args.Query.subCommand->parsed()) {
+        runQuery(args);
+        return;
+    }
+
     // Check if patch subcommand was used
     if (args.Patch.subCommand->parsed()) {
         // Get current time to compare later
@@ -90,41 +182,55 @@ void mainRunner(PGToolsCLIArgs& args)
         args.Patch.output = filesystem::absolute(args.Patch.output);
 
         auto pgd = ParallaxGenDirectory(args.Patch.source, args.Patch.output, nullptr);
-        auto pgd3D = ParallaxGenD3D(&pgd, exePath / "shaders");
-        auto pg = ParallaxGen(args.Patch.output, &pgd, &pgd3D, args.Patch.patchers.contains("optimize"));
+        auto pg = ParallaxGen(args.Patch.output, &pgd, args.Patch.patchers.contains("optimize"));
+        pg.setMeshPipelineSizes(args.Patch.meshPipeline);
+
+        // The D3D11 backend only exists on Windows, headless machines run without the GPU patchers
+        ParallaxGenD3D* pgd3D = nullptr;
+#ifdef _WIN32
+        auto pgd3DBackend = ParallaxGenD3D(&pgd, exePath / "shaders");
+        if (PGPlatform::isGPUAvailable()) {
+            if (!pgd3DBackend.initGPU()) {
+                Logger::critical("Failed to initialize GPU. Exiting.");
+            }
 
-        Patcher::loadStatics(pgd, pgd3D);
-        ParallaxGenWarnings::init(&pgd, {});
+            if (!pgd3DBackend.initShaders()) {
+                Logger::critical("Failed to initialize internal shaders. Exiting.");
+            }
 
-        // Check if GPU needs to be initialized
-        if (!pgd3D.initGPU()) {
-            spdlog::critical("Failed to initialize GPU. Exiting.");
+            pgd3D = &pgd3DBackend;
         }
-
-        if (!pgd3D.initShaders()) {
-            spdlog::critical("Failed to initialize internal shaders. Exiting.");
+#endif
+        if (pgd3D == nullptr) {
+            Logger::warn("No GPU available, patchers that need the GPU are skipped");
         }
 
+        Patcher::loadStatics(pgd, pgd3D);
+        ParallaxGenWarnings::init(&pgd, {});
+
         // Create output directory
         try {
             filesystem::create_directories(args.Patch.output);
         } catch (const filesystem::filesystem_error& e) {
-            spdlog::error("Failed to create output directory: {}", e.what());
+            Logger::error("Failed to create output directory: {}", e.what());
             exit(1);
         }
 
         // If output dir is the same as data dir meshes might get overwritten
         if (filesystem::equivalent(args.Patch.output, pgd.getDataPath())) {
-            spdlog::critical("Output directory cannot be the same directory as your data folder. "
+            Logger::critical("Output directory cannot be the same directory as your data folder. "
                              "Exiting.");
-            exit(1);
         }
 
         // delete existing output
         pg.deleteOutputDir();
 
+        // Bound caches and in-flight buffers by available memory
+        PGMemoryBudget::setBudget(PGMemoryBudget::getDefaultBudget());
+
         // Init file map
         pgd.populateFileMap(false);
+        pgd.getTextureIndex().setEnabled(!args.Patch.index.empty());
 
         // Map files
         pgd.mapFiles({}, {}, {}, {}, args.Patch.mapTexturesFromMeshes, args.multithreading, args.Patch.highMem);
@@ -160,15 +266,24 @@ void mainRunner(PGToolsCLIArgs& args)
         }
 
         // extended classifications
-        pgd3D.extendedTexClassify({});
+#ifdef _WIN32
+        if (pgd3D != nullptr) {
+            pgd3D->extendedTexClassify({});
+        }
+#endif
 
         // Create patcher factory
         PatcherUtil::PatcherMeshSet meshPatchers;
+        auto meshRules = nlohmann::json::array();
         if (patcherDefs.contains("fixmeshlighting")) {
-            meshPatchers.prePatchers.emplace_back(PatcherMeshPreFixMeshLighting::getFactory());
+            meshRules.push_back(PatcherMeshPreRules::getBuiltinRule("FixMeshLighting"));
         }
         if (patcherDefs.contains("fixtextureslotcount")) {
-            meshPatchers.prePatchers.emplace_back(PatcherMeshPreFixTextureSlotCount::getFactory());
+            meshRules.push_back(PatcherMeshPreRules::getBuiltinRule("FixTextureSlotCount"));
+        }
+        if (!meshRules.empty()) {
+            PatcherMeshPreRules::loadStatics(meshRules);
+            meshPatchers.prePatchers.emplace_back(PatcherMeshPreRules::getFactory());
         }
         if (patcherDefs.contains("parallax")) {
             meshPatchers.shaderPatchers.emplace(
@@ -185,28 +300,33 @@ void mainRunner(PGToolsCLIArgs& args)
             PatcherMeshShaderTruePBR::loadStatics(pgd.getPBRJSONs());
             PatcherMeshShaderTruePBR::loadOptions(patcherDefs["truepbr"]);
         }
-        if (patcherDefs.contains("parallaxtocm")) {
-            meshPatchers.shaderTransformPatchers[PatcherMeshShaderTransformParallaxToCM::getFromShader()].emplace(
-                PatcherMeshShaderTransformParallaxToCM::getToShader(),
-                PatcherMeshShaderTransformParallaxToCM::getFactory());
-
-            PatcherTextureHookConvertToCM::initShader();
-        }
         if (patcherDefs.contains("particlelightstolp")) {
             meshPatchers.globalPatchers.emplace_back(PatcherMeshGlobalParticleLightsToLP::getFactory());
         }
 
-        if (patcherDefs.contains("fixsss")) {
-            meshPatchers.postPatchers.emplace_back(PatcherMeshPostFixSSS::getFactory());
+        PatcherUtil::PatcherTextureSet texPatchers;
+#ifdef _WIN32
+        if (pgd3D != nullptr) {
+            if (patcherDefs.contains("parallaxtocm")) {
+                meshPatchers.shaderTransformPatchers[PatcherMeshShaderTransformParallaxToCM::getFromShader()].emplace(
+                    PatcherMeshShaderTransformParallaxToCM::getToShader(),
+                    PatcherMeshShaderTransformParallaxToCM::getFactory());
+
+                PatcherTextureHookConvertToCM::initShader();
+            }
 
-            PatcherTextureHookFixSSS::initShader();
-        }
+            if (patcherDefs.contains("fixsss")) {
+                meshPatchers.postPatchers.emplace_back(PatcherMeshPostFixSSS::getFactory());
 
-        PatcherUtil::PatcherTextureSet texPatchers;
-        if (patcherDefs.contains("converttohdr")) {
-            texPatchers.globalPatchers.emplace_back(PatcherTextureGlobalConvertToHDR::getFactory());
-            PatcherTextureGlobalConvertToHDR::loadOptions(patcherDefs["converttohdr"]);
+                PatcherTextureHookFixSSS::initShader();
+            }
+
+            if (patcherDefs.contains("converttohdr")) {
+                texPatchers.globalPatchers.emplace_back(PatcherTextureGlobalConvertToHDR::getFactory());
+                PatcherTextureGlobalConvertToHDR::loadOptions(patcherDefs["converttohdr"]);
+            }
         }
+#endif
 
         pg.loadPatchers(meshPatchers, texPatchers);
         pg.patch(args.multithreading, false);
@@ -219,12 +339,19 @@ void mainRunner(PGToolsCLIArgs& args)
         // Release cached files, if any
         pgd.clearCache();
 
+        // Save texture index for later queries
+        if (!args.Patch.index.empty()) {
+            Logger::info("Saving texture index...");
+            pgd.getTextureIndex().resolveMods([&pgd](const wstring& path) { return pgd.getMod(path); });
+            pgd.getTextureIndex().save(filesystem::absolute(args.Patch.index));
+        }
+
         // Check if dynamic cubemap file is needed
         if (args.Patch.patchers.contains("complexmaterial")) {
             // Install default cubemap file if needed
             static const filesystem::path dynCubeMapPath = "textures/cubemaps/dynamic1pxcubemap_black.dds";
 
-            spdlog::info("Installing default dynamic cubemap file");
+            Logger::info("Installing default dynamic cubemap file");
 
             // Create Directory
             const filesystem::path outputCubemapPath = args.Patch.output / dynCubeMapPath.parent_path();
@@ -240,7 +367,7 @@ void mainRunner(PGToolsCLIArgs& args)
         const auto endTime = chrono::high_resolution_clock::now();
         timeTaken += chrono::duration_cast<chrono::seconds>(endTime - startTime).count();
 
-        spdlog::info("ParallaxGen took {} seconds to complete", timeTaken);
+        Logger::info("ParallaxGen took {} seconds to complete", timeTaken);
     }
 }
 
@@ -262,6 +389,25 @@ void addArguments(CLI::App& app, PGToolsCLIArgs& args)
     args.Patch.subCommand->add_flag(
         "--map-textures-from-meshes", args.Patch.mapTexturesFromMeshes, "Map textures from meshes (default: false)");
     args.Patch.subCommand->add_flag("--high-mem", args.Patch.highMem, "High memory usage mode (default: false)");
+    args.Patch.subCommand->add_option(
+        "--index", args.Patch.index, "Write a texture index to this file for use with the query command");
+    args.Patch.subCommand->add_option(
+        "--read-threads", args.Patch.meshPipeline.readThreads, "Threads reading meshes (default: 4)");
+    args.Patch.subCommand->add_option(
+        "--patch-threads", args.Patch.meshPipeline.patchThreads, "Threads patching meshes (default: CPU threads)");
+    args.Patch.subCommand->add_option(
+        "--write-threads", args.Patch.meshPipeline.writeThreads, "Threads writing meshes (default: 2)");
+    args.Patch.subCommand->add_option("--mesh-queue-size", args.Patch.meshPipeline.queueCapacity,
+        "Meshes that may wait in front of the patch and write threads (default: 2 per patch thread)");
+
+    args.Query.subCommand = app.add_subcommand("query", "Query a texture index written by patch --index");
+    args.Query.subCommand->add_option("index", args.Query.index, "Texture index file")
+        ->required()
+        ->check(CLI::ExistingFile);
+    args.Query.subCommand->add_option("--texture", args.Query.texture, "List mesh shapes that use a texture");
+    args.Query.subCommand->add_option("--mod", args.Query.mod, "List textures, meshes and shapes a mod affects");
+    args.Query.subCommand->add_option(
+        "--shape", args.Query.shape, "Explain the shader chosen for a shape, given as <mesh>:<shape index>");
 }
 }
 
@@ -273,7 +419,9 @@ auto main(int argC, char** argV) -> int
     cin.get();
 #endif
 
+#ifdef _WIN32
     SetConsoleOutputCP(CP_UTF8);
+#endif
 
     // CLI Arguments
     PGToolsCLIArgs args;
@@ -289,14 +437,18 @@ auto main(int argC, char** argV) -> int
     // Set logging mode
     if (args.verbosity >= 1) {
         spdlog::set_level(spdlog::level::debug);
-        spdlog::debug("DEBUG logging enabled");
+        Logger::debug("DEBUG logging enabled");
     }
 
     if (args.verbosity >= 2) {
         spdlog::set_level(spdlog::level::trace);
-        spdlog::trace("TRACE logging enabled");
+        Logger::trace("TRACE logging enabled");
     }
 
+    // Write log messages from a background thread, pending messages are written on exit
+    Logger::startAsync();
+    atexit(Logger::stopAsync);
+
     // Main Runner (Catches all exceptions)
     CPPTRACE_TRY { mainRunner(args); }
     CPPTRACE_CATCH(const exception& e)